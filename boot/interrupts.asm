@@ -183,3 +183,34 @@ isr128:
     push dword 0            ; Dummy error code
     push dword 128          ; Interrupt number (0x80)
     jmp isr_common_stub
+
+; ============================================================================
+; SYSENTER fast system call entry
+; Convention: EAX = syscall number, EBX/ESI/EDI = args 1-3,
+;             ECX = user ESP, EDX = user return EIP.
+; SYSEXIT reloads user CS/SS from IA32_SYSENTER_CS + 16/24 and returns
+; to EDX with stack ECX, so both are parked on the kernel stack while
+; the C dispatcher runs. Only the hot <= 3 argument calls come here.
+; ============================================================================
+global sysenter_entry
+extern syscall_fast_dispatch
+sysenter_entry:
+    push edx                ; User return EIP
+    push ecx                ; User ESP
+    push ds
+    push es
+    mov cx, 0x10            ; Kernel data segment for the dispatcher
+    mov ds, cx
+    mov es, cx
+    push edi                ; Arg 3
+    push esi                ; Arg 2
+    push ebx                ; Arg 1
+    push eax                ; Syscall number
+    call syscall_fast_dispatch
+    add esp, 16
+    pop es
+    pop ds
+    pop ecx                 ; User ESP
+    pop edx                 ; User return EIP
+    sti                     ; SYSENTER cleared IF; shadow covers sysexit
+    sysexit
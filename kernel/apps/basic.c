@@ -56,6 +56,7 @@ static bool running = false;
 static int current_line_idx = 0;
 static char input_buffer[BASIC_MAX_LINE_LEN];
 static char filename[64] = {0};
+static uint32_t rnd_seed = 12345;
 
 /* Forward declarations */
 static void basic_execute_line(const char* line);
@@ -194,9 +195,8 @@ static double basic_parse_factor(const char** p) {
             if (**p == ')') (*p)++;
         }
         /* Simple pseudo-random using timer */
-        static uint32_t seed = 12345;
-        seed = seed * 1103515245 + 12345;
-        return (double)(seed % 32768) / 32768.0;
+        rnd_seed = rnd_seed * 1103515245 + 12345;
+        return (double)(rnd_seed % 32768) / 32768.0;
     }
     
     if (strncmp(*p, "ABS", 3) == 0) {
@@ -501,6 +501,816 @@ static void basic_load(const char* fname) {
     vga_puts("OK\n");
 }
 
+/* ========================================================================
+ * Bytecode compiler and dispatch loop
+ *
+ * RUN compiles the stored program once into a flat instruction stream
+ * and executes it with a small stack machine. Numeric constants are
+ * parsed, variable names resolved to slots, and GOTO/GOSUB/THEN targets
+ * fixed up to instruction indices at compile time, so a tight FOR/NEXT
+ * loop no longer re-tokenizes its source text or scans the line table
+ * on every iteration. Immediate-mode statements (and programs too large
+ * for the code pools) still go through the text interpreter below.
+ * ======================================================================== */
+
+#define BC_MAX_CODE     4096    /* Instructions per compiled program */
+#define BC_STR_POOL     8192    /* Bytes of interned string literals */
+#define BC_MAX_FIXUPS   512     /* Pending line-number jump targets */
+#define BC_STACK_DEPTH  64      /* Expression value stack */
+
+/* Opcodes */
+enum {
+    BC_NOP = 0,
+    BC_PUSH_NUM,    /* Push constant operand */
+    BC_PUSH_VAR,    /* Push variables[arg] */
+    BC_POP,         /* Discard top (consumed RND argument) */
+    BC_ADD, BC_SUB, BC_MUL, BC_DIV,
+    BC_CMP_EQ, BC_CMP_NE, BC_CMP_LT, BC_CMP_GT, BC_CMP_LE, BC_CMP_GE,
+    BC_RND, BC_ABS, BC_INT,
+    BC_PRINT_STR,   /* Print pool string at arg */
+    BC_PRINT_VAL,   /* Pop and print a number */
+    BC_PRINT_TAB,
+    BC_PRINT_NL,
+    BC_INPUT_NUM,   /* Read a line into variables[arg] */
+    BC_INPUT_STR,   /* Read a line into strings[arg] (arg < 0: discard) */
+    BC_STORE,       /* Pop into variables[arg] */
+    BC_STORE_STR,   /* strings[arg] = pool string at (int)num */
+    BC_JMP,         /* ip = arg */
+    BC_JZ,          /* Pop; if zero, ip = arg */
+    BC_JMP_DYN,     /* Pop; resolve line number at runtime */
+    BC_GOSUB,       /* Push return ip; ip = arg */
+    BC_GOSUB_DYN,   /* Pop; gosub to runtime-resolved line number */
+    BC_RETURN,
+    BC_FOR,         /* Pop step, limit, start; open loop on variables[arg] */
+    BC_NEXT,
+    BC_CLS,
+    BC_END,
+    BC_UNDEF        /* Jump target never resolved: ?UNDEFINED LINE */
+};
+
+typedef struct {
+    uint8_t op;
+    int16_t arg;        /* Variable slot, pool offset or instruction index */
+    double num;         /* Constant operand */
+} bc_inst_t;
+
+static bc_inst_t* bc_code = NULL;   /* Pools allocated on first RUN */
+static char* bc_strpool = NULL;
+static int bc_count = 0;
+static int bc_str_len = 0;
+static int16_t bc_line_start[BASIC_MAX_LINES];
+static struct {
+    int16_t inst;       /* Instruction whose arg holds a line number */
+    int16_t line;       /* That line number */
+    int8_t soft;        /* Unresolved: 1 = fall through (IF), 0 = error */
+} bc_fixups[BC_MAX_FIXUPS];
+static int bc_nfixups = 0;
+static bool bc_overflow = false;
+
+static void bc_compile_expr(const char** p);
+static void bc_compile_statement(const char* stmt);
+
+static bc_inst_t* bc_emit(uint8_t op, int arg, double num) {
+    if (bc_count >= BC_MAX_CODE) {
+        bc_overflow = true;
+        return &bc_code[BC_MAX_CODE - 1];
+    }
+    bc_inst_t* in = &bc_code[bc_count++];
+    in->op = op;
+    in->arg = (int16_t)arg;
+    in->num = num;
+    return in;
+}
+
+/*
+ * Intern a string literal, returning its pool offset
+ */
+static int bc_add_string(const char* s, int len) {
+    if (bc_str_len + len + 1 > BC_STR_POOL) {
+        bc_overflow = true;
+        return 0;
+    }
+    int off = bc_str_len;
+    memcpy(&bc_strpool[off], s, len);
+    bc_strpool[off + len] = '\0';
+    bc_str_len += len + 1;
+    return off;
+}
+
+/*
+ * Record a jump whose line-number target resolves after all lines compile
+ */
+static void bc_add_fixup(int inst, int line, int soft) {
+    if (bc_nfixups >= BC_MAX_FIXUPS) {
+        bc_overflow = true;
+        return;
+    }
+    bc_fixups[bc_nfixups].inst = (int16_t)inst;
+    bc_fixups[bc_nfixups].line = (int16_t)line;
+    bc_fixups[bc_nfixups].soft = (int8_t)soft;
+    bc_nfixups++;
+}
+
+/*
+ * Compile a factor; mirrors basic_parse_factor token for token
+ */
+static void bc_compile_factor(const char** p) {
+    basic_skip_spaces(p);
+
+    if (**p == '(') {
+        (*p)++;
+        bc_compile_expr(p);
+        basic_skip_spaces(p);
+        if (**p == ')') (*p)++;
+        return;
+    }
+
+    /* Variable */
+    if ((**p >= 'A' && **p <= 'Z') || (**p >= 'a' && **p <= 'z')) {
+        char c = **p;
+        (*p)++;
+        if (**p == '$') {
+            (*p)++;
+            bc_emit(BC_PUSH_NUM, 0, 0);  /* String vars are 0 numerically */
+            return;
+        }
+        int idx = basic_get_var_index(c);
+        if (idx >= 0) {
+            bc_emit(BC_PUSH_VAR, idx, 0);
+        } else {
+            bc_emit(BC_PUSH_NUM, 0, 0);
+        }
+        return;
+    }
+
+    /* Number */
+    if ((**p >= '0' && **p <= '9') || **p == '.' || **p == '-') {
+        bc_emit(BC_PUSH_NUM, 0, basic_parse_number(p));
+        return;
+    }
+
+    /* Built-in functions */
+    if (strncmp(*p, "RND", 3) == 0) {
+        (*p) += 3;
+        basic_skip_spaces(p);
+        if (**p == '(') {
+            (*p)++;
+            bc_compile_expr(p);
+            if (**p == ')') (*p)++;
+            bc_emit(BC_POP, 0, 0);  /* Argument evaluated but unused */
+        }
+        bc_emit(BC_RND, 0, 0);
+        return;
+    }
+
+    if (strncmp(*p, "ABS", 3) == 0) {
+        (*p) += 3;
+        basic_skip_spaces(p);
+        if (**p == '(') {
+            (*p)++;
+            bc_compile_expr(p);
+            if (**p == ')') (*p)++;
+            bc_emit(BC_ABS, 0, 0);
+            return;
+        }
+    }
+
+    if (strncmp(*p, "INT", 3) == 0) {
+        (*p) += 3;
+        basic_skip_spaces(p);
+        if (**p == '(') {
+            (*p)++;
+            bc_compile_expr(p);
+            if (**p == ')') (*p)++;
+            bc_emit(BC_INT, 0, 0);
+            return;
+        }
+    }
+
+    bc_emit(BC_PUSH_NUM, 0, 0);
+}
+
+/*
+ * Compile a term (* and /)
+ */
+static void bc_compile_term(const char** p) {
+    bc_compile_factor(p);
+
+    while (1) {
+        basic_skip_spaces(p);
+        if (**p == '*') {
+            (*p)++;
+            bc_compile_factor(p);
+            bc_emit(BC_MUL, 0, 0);
+        } else if (**p == '/') {
+            (*p)++;
+            bc_compile_factor(p);
+            bc_emit(BC_DIV, 0, 0);
+        } else {
+            break;
+        }
+    }
+}
+
+/*
+ * Compile an expression (+ and -)
+ */
+static void bc_compile_expr(const char** p) {
+    basic_skip_spaces(p);
+    bc_compile_term(p);
+
+    while (1) {
+        basic_skip_spaces(p);
+        if (**p == '+') {
+            (*p)++;
+            bc_compile_term(p);
+            bc_emit(BC_ADD, 0, 0);
+        } else if (**p == '-') {
+            (*p)++;
+            bc_compile_term(p);
+            bc_emit(BC_SUB, 0, 0);
+        } else {
+            break;
+        }
+    }
+}
+
+/*
+ * Compile a comparison, leaving 0/1 on the stack
+ */
+static void bc_compile_comparison(const char** p) {
+    bc_compile_expr(p);
+    basic_skip_spaces(p);
+
+    char op1 = **p;
+    char op2 = 0;
+    (*p)++;
+    if (**p == '=' || **p == '>') {
+        op2 = **p;
+        (*p)++;
+    }
+
+    bc_compile_expr(p);
+
+    if (op1 == '=' && op2 == 0) bc_emit(BC_CMP_EQ, 0, 0);
+    else if (op1 == '<' && op2 == 0) bc_emit(BC_CMP_LT, 0, 0);
+    else if (op1 == '>' && op2 == 0) bc_emit(BC_CMP_GT, 0, 0);
+    else if (op1 == '<' && op2 == '=') bc_emit(BC_CMP_LE, 0, 0);
+    else if (op1 == '>' && op2 == '=') bc_emit(BC_CMP_GE, 0, 0);
+    else if (op1 == '<' && op2 == '>') bc_emit(BC_CMP_NE, 0, 0);
+    else if (op1 == '!' && op2 == '=') bc_emit(BC_CMP_NE, 0, 0);
+    else {
+        /* Unknown operator compares false, as the interpreter does */
+        bc_emit(BC_POP, 0, 0);
+        bc_emit(BC_POP, 0, 0);
+        bc_emit(BC_PUSH_NUM, 0, 0);
+    }
+}
+
+/*
+ * Compile "var = expr" / "var$ = "..."" (shared by LET and implicit form)
+ */
+static void bc_compile_assign(const char** pp) {
+    const char* p = *pp;
+    char var = *p++;
+    bool is_string = (*p == '$');
+    if (is_string) p++;
+
+    basic_skip_spaces(&p);
+    if (*p == '=') {
+        p++;
+        basic_skip_spaces(&p);
+
+        if (is_string) {
+            int idx = basic_get_var_index(var);
+            if (idx >= 0 && idx < BASIC_MAX_STRINGS && *p == '"') {
+                p++;
+                int len = 0;
+                while (p[len] && p[len] != '"' && len < BASIC_STRING_LEN - 1) {
+                    len++;
+                }
+                bc_emit(BC_STORE_STR, idx, (double)bc_add_string(p, len));
+            }
+        } else {
+            int idx = basic_get_var_index(var);
+            if (idx >= 0) {
+                bc_compile_expr(&p);
+                bc_emit(BC_STORE, idx, 0);
+            }
+        }
+    }
+    *pp = p;
+}
+
+/*
+ * Try to read a bare constant line number ("GOTO 100"); returns -1 if
+ * the operand is a computed expression needing runtime resolution
+ */
+static int bc_const_line(const char* p) {
+    basic_skip_spaces(&p);
+    if (*p < '0' || *p > '9') return -1;
+    double v = basic_parse_number(&p);
+    basic_skip_spaces(&p);
+    if (*p != '\0') return -1;
+    return (int)v;
+}
+
+/*
+ * Compile a single statement; dispatch mirrors basic_execute_statement
+ */
+static void bc_compile_statement(const char* stmt) {
+    const char* p = stmt;
+    basic_skip_spaces(&p);
+
+    /* REM - comment */
+    if (strncmp(p, "REM", 3) == 0) {
+        return;
+    }
+
+    /* PRINT */
+    if (strncmp(p, "PRINT", 5) == 0) {
+        p += 5;
+        basic_skip_spaces(&p);
+
+        while (*p && *p != ':') {
+            const char* before = p;
+            if (*p == '"') {
+                p++;
+                int len = 0;
+                while (p[len] && p[len] != '"') len++;
+                bc_emit(BC_PRINT_STR, bc_add_string(p, len), 0);
+                p += len;
+                if (*p == '"') p++;
+            } else if (*p == ';') {
+                p++;
+            } else if (*p == ',') {
+                bc_emit(BC_PRINT_TAB, 0, 0);
+                p++;
+            } else {
+                bc_compile_expr(&p);
+                bc_emit(BC_PRINT_VAL, 0, 0);
+            }
+            basic_skip_spaces(&p);
+            if (p == before) p++;   /* Never stall on stray characters */
+        }
+
+        /* Trailing semicolon suppresses the newline */
+        const char* end = stmt + strlen(stmt) - 1;
+        while (end > stmt && (*end == ' ' || *end == '\t')) end--;
+        if (*end != ';') {
+            bc_emit(BC_PRINT_NL, 0, 0);
+        }
+        return;
+    }
+
+    /* INPUT */
+    if (strncmp(p, "INPUT", 5) == 0) {
+        p += 5;
+        basic_skip_spaces(&p);
+
+        /* Optional prompt */
+        if (*p == '"') {
+            p++;
+            int len = 0;
+            while (p[len] && p[len] != '"') len++;
+            bc_emit(BC_PRINT_STR, bc_add_string(p, len), 0);
+            p += len;
+            if (*p == '"') p++;
+            basic_skip_spaces(&p);
+            if (*p == ';' || *p == ',') p++;
+            basic_skip_spaces(&p);
+        } else {
+            bc_emit(BC_PRINT_STR, bc_add_string("? ", 2), 0);
+        }
+
+        if ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z')) {
+            char var = *p++;
+            bool is_string = (*p == '$');
+            int idx = basic_get_var_index(var);
+
+            if (is_string) {
+                bc_emit(BC_INPUT_STR,
+                        (idx >= 0 && idx < BASIC_MAX_STRINGS) ? idx : -1, 0);
+            } else {
+                bc_emit(BC_INPUT_NUM, idx, 0);
+            }
+        }
+        return;
+    }
+
+    /* LET (optional keyword) - explicit assignment */
+    if (strncmp(p, "LET", 3) == 0) {
+        p += 3;
+        basic_skip_spaces(&p);
+        if ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z')) {
+            bc_compile_assign(&p);
+        }
+        return;
+    }
+
+    /* GOTO */
+    if (strncmp(p, "GOTO", 4) == 0) {
+        p += 4;
+        int line = bc_const_line(p);
+        if (line >= 0) {
+            bc_add_fixup(bc_count, line, 0);
+            bc_emit(BC_JMP, 0, 0);
+        } else {
+            bc_compile_expr(&p);
+            bc_emit(BC_JMP_DYN, 0, 0);
+        }
+        return;
+    }
+
+    /* GOSUB */
+    if (strncmp(p, "GOSUB", 5) == 0) {
+        p += 5;
+        int line = bc_const_line(p);
+        if (line >= 0) {
+            bc_add_fixup(bc_count, line, 0);
+            bc_emit(BC_GOSUB, 0, 0);
+        } else {
+            bc_compile_expr(&p);
+            bc_emit(BC_GOSUB_DYN, 0, 0);
+        }
+        return;
+    }
+
+    /* RETURN */
+    if (strncmp(p, "RETURN", 6) == 0) {
+        bc_emit(BC_RETURN, 0, 0);
+        return;
+    }
+
+    /* IF/THEN */
+    if (strncmp(p, "IF", 2) == 0) {
+        p += 2;
+        basic_skip_spaces(&p);
+
+        bc_compile_comparison(&p);
+
+        basic_skip_spaces(&p);
+        if (strncmp(p, "THEN", 4) == 0) {
+            p += 4;
+            basic_skip_spaces(&p);
+        }
+
+        int jz = bc_count;
+        bc_emit(BC_JZ, 0, 0);
+
+        if (*p >= '0' && *p <= '9') {
+            /* A missing target line falls through, as the interpreter does */
+            bc_add_fixup(bc_count, atoi(p), 1);
+            bc_emit(BC_JMP, 0, 0);
+        } else {
+            bc_compile_statement(p);
+        }
+
+        if (jz < BC_MAX_CODE) {
+            bc_code[jz].arg = (int16_t)bc_count;
+        }
+        return;
+    }
+
+    /* FOR */
+    if (strncmp(p, "FOR", 3) == 0) {
+        p += 3;
+        basic_skip_spaces(&p);
+
+        char var = *p++;
+        basic_skip_spaces(&p);
+        if (*p == '=') p++;
+
+        bc_compile_expr(&p);            /* Start */
+
+        basic_skip_spaces(&p);
+        if (strncmp(p, "TO", 2) == 0) p += 2;
+
+        bc_compile_expr(&p);            /* Limit */
+
+        basic_skip_spaces(&p);
+        if (strncmp(p, "STEP", 4) == 0) {
+            p += 4;
+            bc_compile_expr(&p);        /* Step */
+        } else {
+            bc_emit(BC_PUSH_NUM, 0, 1);
+        }
+
+        bc_emit(BC_FOR, basic_get_var_index(var), 0);
+        return;
+    }
+
+    /* NEXT (the variable name after it is ignored, as in the interpreter) */
+    if (strncmp(p, "NEXT", 4) == 0) {
+        bc_emit(BC_NEXT, 0, 0);
+        return;
+    }
+
+    /* END */
+    if (strncmp(p, "END", 3) == 0) {
+        bc_emit(BC_END, 0, 0);
+        return;
+    }
+
+    /* CLS */
+    if (strncmp(p, "CLS", 3) == 0) {
+        bc_emit(BC_CLS, 0, 0);
+        return;
+    }
+
+    /* Implicit variable assignment (no LET keyword) - must be last */
+    if ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z')) {
+        bc_compile_assign(&p);
+    }
+}
+
+/*
+ * Compile the whole program. Returns false if the code or string pool
+ * overflowed (the caller then falls back to the text interpreter).
+ */
+static bool basic_compile(void) {
+    if (bc_code == NULL) {
+        bc_code = (bc_inst_t*)kmalloc(BC_MAX_CODE * sizeof(bc_inst_t));
+        bc_strpool = (char*)kmalloc(BC_STR_POOL);
+        if (bc_code == NULL || bc_strpool == NULL) return false;
+    }
+
+    bc_count = 0;
+    bc_str_len = 0;
+    bc_nfixups = 0;
+    bc_overflow = false;
+
+    char stmt[BASIC_MAX_LINE_LEN];
+    for (int i = 0; i < num_lines; i++) {
+        bc_line_start[i] = (int16_t)bc_count;
+
+        /* Split on : outside strings, like basic_execute_line */
+        const char* p = program[i].text;
+        while (*p) {
+            int n = 0;
+            bool in_string = false;
+            while (*p && (in_string || *p != ':') && n < BASIC_MAX_LINE_LEN - 1) {
+                if (*p == '"') in_string = !in_string;
+                stmt[n++] = *p++;
+            }
+            stmt[n] = '\0';
+            if (*p == ':') p++;
+
+            bc_compile_statement(stmt);
+        }
+    }
+    bc_emit(BC_END, 0, 0);
+
+    /* Resolve line-number jumps to instruction indices */
+    for (int i = 0; i < bc_nfixups; i++) {
+        bc_inst_t* in = &bc_code[bc_fixups[i].inst];
+        int idx = basic_find_line_ge(bc_fixups[i].line);
+        if (idx >= 0) {
+            in->arg = bc_line_start[idx];
+        } else if (bc_fixups[i].soft) {
+            in->op = BC_NOP;
+        } else {
+            in->op = BC_UNDEF;
+        }
+    }
+
+    return !bc_overflow;
+}
+
+/*
+ * The dispatch loop
+ */
+static void basic_exec_bytecode(void) {
+    double stack[BC_STACK_DEPTH];
+    int sp = 0;
+    int16_t ret_stack[BASIC_STACK_SIZE];
+    int ret_sp = 0;
+    struct {
+        int16_t slot;
+        int16_t loop_ip;
+        int target;
+        int step;
+    } loops[BASIC_STACK_SIZE];
+    int loop_sp = 0;
+    int ip = 0;
+
+    running = true;
+    while (running && ip < bc_count) {
+        bc_inst_t* in = &bc_code[ip++];
+
+        switch (in->op) {
+        case BC_NOP:
+            break;
+
+        case BC_PUSH_NUM:
+        case BC_PUSH_VAR:
+            if (sp >= BC_STACK_DEPTH) {
+                vga_puts("?EXPRESSION TOO COMPLEX\n");
+                running = false;
+                break;
+            }
+            stack[sp++] = (in->op == BC_PUSH_NUM) ? in->num
+                                                  : variables[in->arg];
+            break;
+
+        case BC_POP:
+            sp--;
+            break;
+
+        case BC_ADD: sp--; stack[sp - 1] += stack[sp]; break;
+        case BC_SUB: sp--; stack[sp - 1] -= stack[sp]; break;
+        case BC_MUL: sp--; stack[sp - 1] *= stack[sp]; break;
+        case BC_DIV:
+            sp--;
+            if (stack[sp] != 0) stack[sp - 1] /= stack[sp];
+            break;
+
+        case BC_CMP_EQ: sp--; stack[sp - 1] = (stack[sp - 1] == stack[sp]); break;
+        case BC_CMP_NE: sp--; stack[sp - 1] = (stack[sp - 1] != stack[sp]); break;
+        case BC_CMP_LT: sp--; stack[sp - 1] = (stack[sp - 1] < stack[sp]); break;
+        case BC_CMP_GT: sp--; stack[sp - 1] = (stack[sp - 1] > stack[sp]); break;
+        case BC_CMP_LE: sp--; stack[sp - 1] = (stack[sp - 1] <= stack[sp]); break;
+        case BC_CMP_GE: sp--; stack[sp - 1] = (stack[sp - 1] >= stack[sp]); break;
+
+        case BC_RND:
+            if (sp >= BC_STACK_DEPTH) {
+                vga_puts("?EXPRESSION TOO COMPLEX\n");
+                running = false;
+                break;
+            }
+            rnd_seed = rnd_seed * 1103515245 + 12345;
+            stack[sp++] = (double)(rnd_seed % 32768) / 32768.0;
+            break;
+
+        case BC_ABS:
+            if (stack[sp - 1] < 0) stack[sp - 1] = -stack[sp - 1];
+            break;
+
+        case BC_INT:
+            stack[sp - 1] = (int)stack[sp - 1];
+            break;
+
+        case BC_PRINT_STR:
+            vga_puts(&bc_strpool[in->arg]);
+            break;
+
+        case BC_PRINT_VAL: {
+            double val = stack[--sp];
+            char buf[32];
+            int ival = (int)val;
+            if (val == ival) {
+                snprintf(buf, sizeof(buf), "%d", ival);
+            } else {
+                snprintf(buf, sizeof(buf), "%d.%02d", ival,
+                         (int)((val - ival) * 100));
+            }
+            vga_puts(buf);
+            break;
+        }
+
+        case BC_PRINT_TAB:
+            vga_puts("\t");
+            break;
+
+        case BC_PRINT_NL:
+            vga_putchar('\n');
+            break;
+
+        case BC_INPUT_NUM:
+        case BC_INPUT_STR: {
+            char input[64];
+            basic_getline(input, sizeof(input));
+            if (in->arg >= 0) {
+                if (in->op == BC_INPUT_NUM) {
+                    variables[in->arg] = atoi(input);
+                } else {
+                    strncpy(strings[in->arg], input, BASIC_STRING_LEN - 1);
+                }
+            }
+            break;
+        }
+
+        case BC_STORE:
+            variables[in->arg] = stack[--sp];
+            break;
+
+        case BC_STORE_STR:
+            strncpy(strings[in->arg], &bc_strpool[(int)in->num],
+                    BASIC_STRING_LEN - 1);
+            strings[in->arg][BASIC_STRING_LEN - 1] = '\0';
+            break;
+
+        case BC_JMP:
+            ip = in->arg;
+            break;
+
+        case BC_JZ:
+            if (stack[--sp] == 0) ip = in->arg;
+            break;
+
+        case BC_JMP_DYN:
+        case BC_GOSUB_DYN: {
+            int idx = basic_find_line_ge((int)stack[--sp]);
+            if (idx < 0) {
+                vga_puts("?UNDEFINED LINE\n");
+                running = false;
+                break;
+            }
+            if (in->op == BC_GOSUB_DYN) {
+                if (ret_sp >= BASIC_STACK_SIZE) {
+                    vga_puts("?STACK OVERFLOW\n");
+                    running = false;
+                    break;
+                }
+                ret_stack[ret_sp++] = (int16_t)ip;
+            }
+            ip = bc_line_start[idx];
+            break;
+        }
+
+        case BC_GOSUB:
+            if (ret_sp >= BASIC_STACK_SIZE) {
+                vga_puts("?STACK OVERFLOW\n");
+                running = false;
+                break;
+            }
+            ret_stack[ret_sp++] = (int16_t)ip;
+            ip = in->arg;
+            break;
+
+        case BC_RETURN:
+            if (ret_sp <= 0) {
+                vga_puts("?RETURN WITHOUT GOSUB\n");
+                running = false;
+                break;
+            }
+            ip = ret_stack[--ret_sp];
+            break;
+
+        case BC_FOR: {
+            double step = stack[--sp];
+            double limit = stack[--sp];
+            double start = stack[--sp];
+            if (loop_sp >= BASIC_STACK_SIZE) {
+                vga_puts("?STACK OVERFLOW\n");
+                running = false;
+                break;
+            }
+            if (in->arg >= 0) {
+                variables[in->arg] = start;
+            }
+            loops[loop_sp].slot = in->arg;
+            loops[loop_sp].loop_ip = (int16_t)ip;
+            loops[loop_sp].target = (int)limit;
+            loops[loop_sp].step = (int)step;
+            loop_sp++;
+            break;
+        }
+
+        case BC_NEXT: {
+            if (loop_sp <= 0) {
+                vga_puts("?NEXT WITHOUT FOR\n");
+                running = false;
+                break;
+            }
+            int slot = loops[loop_sp - 1].slot;
+            if (slot >= 0) {
+                variables[slot] += loops[loop_sp - 1].step;
+
+                bool done = (loops[loop_sp - 1].step > 0) ?
+                            (variables[slot] > loops[loop_sp - 1].target) :
+                            (variables[slot] < loops[loop_sp - 1].target);
+
+                if (!done) {
+                    ip = loops[loop_sp - 1].loop_ip;
+                } else {
+                    loop_sp--;
+                }
+            }
+            break;
+        }
+
+        case BC_CLS:
+            vga_clear();
+            break;
+
+        case BC_END:
+            running = false;
+            break;
+
+        case BC_UNDEF:
+            vga_puts("?UNDEFINED LINE\n");
+            running = false;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    running = false;
+}
+
 /*
  * Execute a single BASIC statement
  */
@@ -869,6 +1679,13 @@ static void basic_run_program(void) {
         return;
     }
     
+    /* Compile once and dispatch; the line-at-a-time text interpreter
+     * below remains as the fallback for programs too large to compile */
+    if (basic_compile()) {
+        basic_exec_bytecode();
+        return;
+    }
+    
     running = true;
     current_line_idx = 0;
     gosub_sp = 0;
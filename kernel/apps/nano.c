@@ -22,12 +22,13 @@
 #include "../include/ramfs.h"
 #include "../include/ext2.h"
 #include "../include/shell.h"
+#include "../include/strsearch.h"
+#include "../include/undolog.h"
 
 /* Editor configuration */
 #define NANO_MAX_LINES      1000
 #define NANO_MAX_LINE_LEN   256
 #define NANO_TAB_SIZE       4
-#define NANO_UNDO_LEVELS    50
 
 /* Screen layout */
 #define NANO_TITLE_ROW      0
@@ -57,25 +58,6 @@ typedef struct {
     int length;
 } line_t;
 
-/* Undo action types */
-typedef enum {
-    UNDO_INSERT_CHAR,
-    UNDO_DELETE_CHAR,
-    UNDO_INSERT_LINE,
-    UNDO_DELETE_LINE,
-    UNDO_JOIN_LINES,
-    UNDO_SPLIT_LINE
-} undo_type_t;
-
-/* Undo record */
-typedef struct {
-    undo_type_t type;
-    int line;
-    int col;
-    char ch;
-    char line_content[NANO_MAX_LINE_LEN];
-} undo_record_t;
-
 /* Editor state */
 static line_t* lines = NULL;
 static int num_lines = 0;
@@ -100,10 +82,90 @@ static char replace_term[128] = "";
 static int search_wrap = 1;
 static int search_case_sensitive = 0;
 
-/* Undo buffer */
-static undo_record_t undo_buffer[NANO_UNDO_LEVELS];
-static int undo_pos = 0;
-static int undo_count = 0;
+/* Undo journal (shared operation log, see include/undolog.h) */
+static undolog_t nano_undo_log;
+
+/*
+ * Line storage is a gap buffer over lines[]: logical lines [0, gap_start)
+ * sit at the front of the array and the rest at [gap_end, NANO_MAX_LINES).
+ * Inserting or deleting a line just moves the gap to the edit point, so
+ * repeated edits near the cursor are O(1) amortized instead of shifting
+ * every line below the cursor on each Enter or line join.
+ */
+static int gap_start = 0;
+static int gap_end = 0;
+
+static line_t* nano_line(int idx) {
+    return &lines[idx < gap_start ? idx : idx + (gap_end - gap_start)];
+}
+
+/*
+ * Move the gap so it starts at logical line idx
+ */
+static void nano_gap_move(int idx) {
+    while (gap_start < idx) {
+        lines[gap_start++] = lines[gap_end++];
+    }
+    while (gap_start > idx) {
+        lines[--gap_end] = lines[--gap_start];
+    }
+}
+
+/*
+ * Open a fresh empty line at logical index idx (caller checks capacity).
+ * The returned pointer is valid until the gap moves again.
+ */
+static line_t* nano_open_line(int idx) {
+    nano_gap_move(idx);
+    line_t* line = &lines[gap_start++];
+    line->text[0] = '\0';
+    line->length = 0;
+    num_lines++;
+    return line;
+}
+
+/*
+ * Remove the line at logical index idx
+ */
+static void nano_close_line(int idx) {
+    nano_gap_move(idx);
+    gap_end++;
+    num_lines--;
+}
+
+/*
+ * Damage tracking: edits mark only the screen rows they touch and the
+ * redraw repaints just those, unless the view scrolled or something
+ * (help screen, file load) invalidated the whole text area.
+ */
+static uint8_t row_dirty[NANO_EDIT_ROWS];
+static int text_all_dirty = 1;
+static int last_view_line = -1;
+static int last_view_col = -1;
+static int last_cursor_line = 0;
+static int last_cursor_col = 0;
+
+/*
+ * Mark the screen row showing file_line dirty (no-op when off screen)
+ */
+static void nano_dirty_row(int file_line) {
+    int row = file_line - view_line;
+    if (row >= 0 && row < NANO_EDIT_ROWS) {
+        row_dirty[row] = 1;
+    }
+}
+
+/*
+ * Mark file_line and every row below it dirty (line insert/delete
+ * shifts the rest of the screen)
+ */
+static void nano_dirty_from(int file_line) {
+    int row = file_line - view_line;
+    if (row < 0) row = 0;
+    for (; row < NANO_EDIT_ROWS; row++) {
+        row_dirty[row] = 1;
+    }
+}
 
 /* Forward declarations */
 static void nano_draw_screen(void);
@@ -127,7 +189,7 @@ static void nano_cut_line(void);
 static void nano_copy_line(void);
 static void nano_paste(void);
 static void nano_undo(void);
-static void nano_push_undo(undo_type_t type, int line, int col, char ch, const char* content);
+static void nano_ensure_cursor_visible(void);
 static int nano_prompt(const char* prompt, char* buffer, int bufsize);
 static void nano_clear_line(int row, uint8_t color);
 static int nano_get_display_col(int line, int col);
@@ -148,8 +210,8 @@ static void nano_clear_line(int row, uint8_t color) {
 static int nano_get_display_col(int line, int col) {
     if (line < 0 || line >= num_lines) return col;
     int display_col = 0;
-    for (int i = 0; i < col && i < lines[line].length; i++) {
-        if (lines[line].text[i] == '\t') {
+    for (int i = 0; i < col && i < nano_line(line)->length; i++) {
+        if (nano_line(line)->text[i] == '\t') {
             display_col = (display_col + NANO_TAB_SIZE) & ~(NANO_TAB_SIZE - 1);
         } else {
             display_col++;
@@ -170,6 +232,9 @@ void nano_init(void) {
     /* Clear all lines */
     memset(lines, 0, sizeof(line_t) * NANO_MAX_LINES);
     num_lines = 1;  /* Start with one empty line */
+    gap_start = 1;
+    gap_end = NANO_MAX_LINES;
+    text_all_dirty = 1;
 
     /* Reset cursor and view */
     cursor_line = 0;
@@ -182,9 +247,8 @@ void nano_init(void) {
     modified = 0;
     select_active = 0;
 
-    /* Clear undo buffer */
-    undo_pos = 0;
-    undo_count = 0;
+    /* Clear undo journal */
+    undolog_clear(&nano_undo_log);
 
     /* Clear cut buffer */
     if (cut_buffer) {
@@ -199,88 +263,106 @@ void nano_init(void) {
 }
 
 /*
- * Push an undo record
- */
-static void nano_push_undo(undo_type_t type, int line, int col, char ch, const char* content) {
-    undo_record_t* rec = &undo_buffer[undo_pos];
-    rec->type = type;
-    rec->line = line;
-    rec->col = col;
-    rec->ch = ch;
-    if (content) {
-        strncpy(rec->line_content, content, NANO_MAX_LINE_LEN - 1);
-        rec->line_content[NANO_MAX_LINE_LEN - 1] = '\0';
-    } else {
-        rec->line_content[0] = '\0';
-    }
-
-    undo_pos = (undo_pos + 1) % NANO_UNDO_LEVELS;
-    if (undo_count < NANO_UNDO_LEVELS) {
-        undo_count++;
-    }
-}
-
-/*
- * Undo last action
+ * Undo the newest journal operation by applying its inverse edit
+ * directly to the line buffer (nothing here re-logs)
  */
 static void nano_undo(void) {
-    if (undo_count == 0) {
+    undolog_op_t* op = undolog_peek(&nano_undo_log);
+    if (!op) {
         nano_draw_status("Nothing to undo");
         return;
     }
 
-    undo_pos = (undo_pos - 1 + NANO_UNDO_LEVELS) % NANO_UNDO_LEVELS;
-    undo_count--;
-
-    undo_record_t* rec = &undo_buffer[undo_pos];
-
-    switch (rec->type) {
-        case UNDO_INSERT_CHAR:
-            /* Undo insert = delete the char */
-            cursor_line = rec->line;
-            cursor_col = rec->col;
-            nano_delete_char();
-            undo_count--;  /* Don't count the delete as new undo */
+    switch (op->type) {
+        case UNDOLOG_INSERT: {
+            /* Remove the inserted run */
+            line_t* line = nano_line(op->line);
+            int end = op->col + op->len;
+            if (end > line->length) end = line->length;
+            if (op->col < end) {
+                memmove(&line->text[op->col], &line->text[end],
+                        line->length - end + 1);
+                line->length -= end - op->col;
+            }
+            cursor_line = op->line;
+            cursor_col = op->col;
+            nano_dirty_row(op->line);
             break;
+        }
 
-        case UNDO_DELETE_CHAR:
-            /* Undo delete = insert the char */
-            cursor_line = rec->line;
-            cursor_col = rec->col;
-            nano_insert_char(rec->ch);
-            undo_count--;
+        case UNDOLOG_DELETE: {
+            /* Re-insert the deleted run */
+            line_t* line = nano_line(op->line);
+            int len = op->len;
+            if (line->length + len >= NANO_MAX_LINE_LEN) {
+                len = NANO_MAX_LINE_LEN - 1 - line->length;
+            }
+            if (len > 0) {
+                memmove(&line->text[op->col + len], &line->text[op->col],
+                        line->length - op->col + 1);
+                memcpy(&line->text[op->col], op->text, len);
+                line->length += len;
+            }
+            cursor_line = op->line;
+            cursor_col = op->col + (len > 0 ? len : 0);
+            nano_dirty_row(op->line);
             break;
+        }
 
-        case UNDO_INSERT_LINE:
-            /* Undo insert line = delete it */
-            if (rec->line < num_lines) {
-                for (int i = rec->line; i < num_lines - 1; i++) {
-                    lines[i] = lines[i + 1];
+        case UNDOLOG_SPLIT:
+            /* Join the two halves back together */
+            if (op->line < num_lines - 1) {
+                line_t* line = nano_line(op->line);
+                line_t* next = nano_line(op->line + 1);
+                if (line->length + next->length < NANO_MAX_LINE_LEN) {
+                    strcat(line->text, next->text);
+                    line->length += next->length;
+                    nano_close_line(op->line + 1);
                 }
-                num_lines--;
-                cursor_line = rec->line > 0 ? rec->line - 1 : 0;
-                cursor_col = lines[cursor_line].length;
             }
+            cursor_line = op->line;
+            cursor_col = op->col;
+            nano_dirty_from(op->line);
             break;
 
-        case UNDO_DELETE_LINE:
-            /* Undo delete line = restore it */
+        case UNDOLOG_JOIN:
+            /* Re-split at the join point */
             if (num_lines < NANO_MAX_LINES) {
-                for (int i = num_lines; i > rec->line; i--) {
-                    lines[i] = lines[i - 1];
+                line_t* new_line = nano_open_line(op->line + 1);
+                line_t* line = nano_line(op->line);
+                if (op->col <= line->length) {
+                    strcpy(new_line->text, &line->text[op->col]);
+                    new_line->length = line->length - op->col;
+                    line->text[op->col] = '\0';
+                    line->length = op->col;
                 }
-                strcpy(lines[rec->line].text, rec->line_content);
-                lines[rec->line].length = strlen(rec->line_content);
-                num_lines++;
-                cursor_line = rec->line;
-                cursor_col = 0;
             }
+            cursor_line = op->line;
+            cursor_col = op->col;
+            nano_dirty_from(op->line);
             break;
 
-        default:
+        case UNDOLOG_KILL_LINE:
+            /* Restore the deleted line */
+            if (num_lines < NANO_MAX_LINES) {
+                line_t* line = nano_open_line(op->line);
+                strncpy(line->text, op->text, NANO_MAX_LINE_LEN - 1);
+                line->text[NANO_MAX_LINE_LEN - 1] = '\0';
+                line->length = strlen(line->text);
+                nano_dirty_from(op->line);
+                cursor_line = op->line;
+                cursor_col = 0;
+            }
             break;
     }
+    undolog_drop(&nano_undo_log);
 
+    if (cursor_line >= num_lines) cursor_line = num_lines - 1;
+    if (cursor_col > nano_line(cursor_line)->length) {
+        cursor_col = nano_line(cursor_line)->length;
+    }
+    modified = 1;
+    nano_ensure_cursor_visible();
     nano_draw_screen();
     nano_draw_status("Undone");
 }
@@ -369,13 +451,13 @@ static void nano_draw_help(void) {
 }
 
 /*
- * Draw the text area
+ * Draw one row of the text area
  */
-static void nano_draw_text(void) {
+static void nano_draw_text_row(int screen_row) {
     int line_num_width = show_line_numbers ? 5 : 0;
     int text_width = 80 - line_num_width;
 
-    for (int screen_row = 0; screen_row < NANO_EDIT_ROWS; screen_row++) {
+    {
         int file_line = view_line + screen_row;
         int screen_y = NANO_EDIT_START + screen_row;
 
@@ -387,7 +469,7 @@ static void nano_draw_text(void) {
             if (show_line_numbers) {
                 vga_write_at("    ~", COLOR_LINENUM, 0, screen_y);
             }
-            continue;
+            return;
         }
 
         /* Draw line number */
@@ -398,7 +480,7 @@ static void nano_draw_text(void) {
         }
 
         /* Draw text content */
-        line_t* line = &lines[file_line];
+        line_t* line = nano_line(file_line);
         int display_col = 0;
 
         for (int i = 0; i < line->length && display_col < text_width + view_col; i++) {
@@ -453,6 +535,37 @@ static void nano_draw_text(void) {
     }
 }
 
+/*
+ * Draw the text area: repaint only rows marked dirty since the last
+ * draw, falling back to the full area when the view scrolled
+ */
+static void nano_draw_text(void) {
+    /* A cursor move dirties both its old and its new row */
+    if (cursor_line != last_cursor_line || cursor_col != last_cursor_col) {
+        nano_dirty_row(last_cursor_line);
+        nano_dirty_row(cursor_line);
+    }
+
+    if (text_all_dirty || view_line != last_view_line || view_col != last_view_col) {
+        for (int row = 0; row < NANO_EDIT_ROWS; row++) {
+            row_dirty[row] = 1;
+        }
+        text_all_dirty = 0;
+    }
+
+    for (int row = 0; row < NANO_EDIT_ROWS; row++) {
+        if (row_dirty[row]) {
+            nano_draw_text_row(row);
+            row_dirty[row] = 0;
+        }
+    }
+
+    last_view_line = view_line;
+    last_view_col = view_col;
+    last_cursor_line = cursor_line;
+    last_cursor_col = cursor_col;
+}
+
 /*
  * Draw entire screen
  */
@@ -503,17 +616,17 @@ static void nano_move_cursor(int dline, int dcol) {
         /* Move to end of previous line */
         if (cursor_line > 0) {
             cursor_line--;
-            cursor_col = lines[cursor_line].length;
+            cursor_col = nano_line(cursor_line)->length;
         } else {
             cursor_col = 0;
         }
-    } else if (cursor_col > lines[cursor_line].length) {
+    } else if (cursor_col > nano_line(cursor_line)->length) {
         /* Move to start of next line */
         if (cursor_line < num_lines - 1 && dcol > 0) {
             cursor_line++;
             cursor_col = 0;
         } else {
-            cursor_col = lines[cursor_line].length;
+            cursor_col = nano_line(cursor_line)->length;
         }
     }
 
@@ -524,15 +637,15 @@ static void nano_move_cursor(int dline, int dcol) {
  * Insert a character at cursor
  */
 static void nano_insert_char(char c) {
-    line_t* line = &lines[cursor_line];
+    line_t* line = nano_line(cursor_line);
 
     if (line->length >= NANO_MAX_LINE_LEN - 1) {
         nano_draw_status("Line too long");
         return;
     }
 
-    /* Push undo */
-    nano_push_undo(UNDO_INSERT_CHAR, cursor_line, cursor_col, c, NULL);
+    /* Journal the insert (coalesces into the current typing run) */
+    undolog_record_insert(&nano_undo_log, cursor_line, cursor_col);
 
     /* Shift characters right */
     for (int i = line->length; i > cursor_col; i--) {
@@ -544,6 +657,7 @@ static void nano_insert_char(char c) {
     line->text[line->length] = '\0';
     cursor_col++;
 
+    nano_dirty_row(cursor_line);
     modified = 1;
     nano_ensure_cursor_visible();
 }
@@ -552,33 +666,31 @@ static void nano_insert_char(char c) {
  * Delete character at cursor (Delete key)
  */
 static void nano_delete_char(void) {
-    line_t* line = &lines[cursor_line];
+    line_t* line = nano_line(cursor_line);
 
     if (cursor_col < line->length) {
         /* Delete character at cursor */
         char deleted = line->text[cursor_col];
-        nano_push_undo(UNDO_DELETE_CHAR, cursor_line, cursor_col, deleted, NULL);
+        undolog_record_delete(&nano_undo_log, cursor_line, cursor_col, deleted);
 
         for (int i = cursor_col; i < line->length; i++) {
             line->text[i] = line->text[i + 1];
         }
         line->length--;
+        nano_dirty_row(cursor_line);
         modified = 1;
     } else if (cursor_line < num_lines - 1) {
         /* Join with next line */
-        line_t* next = &lines[cursor_line + 1];
+        line_t* next = nano_line(cursor_line + 1);
 
         if (line->length + next->length < NANO_MAX_LINE_LEN) {
-            nano_push_undo(UNDO_DELETE_LINE, cursor_line + 1, 0, 0, next->text);
+            undolog_record_join(&nano_undo_log, cursor_line, line->length);
 
             strcat(line->text, next->text);
             line->length += next->length;
 
-            /* Shift lines up */
-            for (int i = cursor_line + 1; i < num_lines - 1; i++) {
-                lines[i] = lines[i + 1];
-            }
-            num_lines--;
+            nano_close_line(cursor_line + 1);
+            nano_dirty_from(cursor_line);
             modified = 1;
         }
     }
@@ -594,7 +706,7 @@ static void nano_backspace(void) {
     } else if (cursor_line > 0) {
         /* Join with previous line */
         cursor_line--;
-        cursor_col = lines[cursor_line].length;
+        cursor_col = nano_line(cursor_line)->length;
         nano_delete_char();
     }
 }
@@ -608,25 +720,20 @@ static void nano_insert_line(void) {
         return;
     }
 
-    line_t* line = &lines[cursor_line];
+    /* Journal the split so undo can join the halves back */
+    undolog_record_split(&nano_undo_log, cursor_line, cursor_col);
 
-    /* Push undo for the new line */
-    nano_push_undo(UNDO_INSERT_LINE, cursor_line + 1, 0, 0, NULL);
-
-    /* Shift lines down */
-    for (int i = num_lines; i > cursor_line + 1; i--) {
-        lines[i] = lines[i - 1];
-    }
-    num_lines++;
-
-    /* Split current line */
-    line_t* new_line = &lines[cursor_line + 1];
+    /* Split current line into a freshly opened one below it */
+    line_t* new_line = nano_open_line(cursor_line + 1);
+    line_t* line = nano_line(cursor_line);
     strcpy(new_line->text, &line->text[cursor_col]);
     new_line->length = line->length - cursor_col;
 
     line->text[cursor_col] = '\0';
     line->length = cursor_col;
 
+    nano_dirty_from(cursor_line);
+
     /* Move cursor to new line */
     cursor_line++;
     cursor_col = 0;
@@ -641,21 +748,19 @@ static void nano_insert_line(void) {
 static void nano_delete_line(void) {
     if (num_lines <= 1) {
         /* Can't delete last line, just clear it */
-        nano_push_undo(UNDO_DELETE_LINE, cursor_line, 0, 0, lines[cursor_line].text);
-        lines[cursor_line].text[0] = '\0';
-        lines[cursor_line].length = 0;
+        undolog_record_kill_line(&nano_undo_log, cursor_line, nano_line(cursor_line)->text);
+        nano_line(cursor_line)->text[0] = '\0';
+        nano_line(cursor_line)->length = 0;
+        nano_dirty_row(cursor_line);
         cursor_col = 0;
         modified = 1;
         return;
     }
 
-    nano_push_undo(UNDO_DELETE_LINE, cursor_line, 0, 0, lines[cursor_line].text);
+    undolog_record_kill_line(&nano_undo_log, cursor_line, nano_line(cursor_line)->text);
 
-    /* Shift lines up */
-    for (int i = cursor_line; i < num_lines - 1; i++) {
-        lines[i] = lines[i + 1];
-    }
-    num_lines--;
+    nano_close_line(cursor_line);
+    nano_dirty_from(cursor_line);
 
     /* Adjust cursor */
     if (cursor_line >= num_lines) {
@@ -732,7 +837,7 @@ static int nano_save_file(void) {
     /* Calculate total size */
     int total_size = 0;
     for (int i = 0; i < num_lines; i++) {
-        total_size += lines[i].length + 1;  /* +1 for newline */
+        total_size += nano_line(i)->length + 1;  /* +1 for newline */
     }
 
     /* Allocate buffer */
@@ -745,8 +850,9 @@ static int nano_save_file(void) {
     /* Build content */
     int pos = 0;
     for (int i = 0; i < num_lines; i++) {
-        memcpy(&content[pos], lines[i].text, lines[i].length);
-        pos += lines[i].length;
+        line_t* line = nano_line(i);
+        memcpy(&content[pos], line->text, line->length);
+        pos += line->length;
         content[pos++] = '\n';
     }
     content[pos] = '\0';
@@ -809,8 +915,10 @@ static int nano_load_file(const char* name) {
     nano_init();
     strcpy(filename, name);
 
-    /* Parse lines */
+    /* Parse lines, appending at the gap (always at the end here) */
     num_lines = 0;
+    gap_start = 0;
+    gap_end = NANO_MAX_LINES;
     int line_start = 0;
 
     for (uint32_t i = 0; i <= file->length; i++) {
@@ -820,17 +928,17 @@ static int nano_load_file(const char* name) {
                 if (line_len > NANO_MAX_LINE_LEN - 1) {
                     line_len = NANO_MAX_LINE_LEN - 1;
                 }
-                memcpy(lines[num_lines].text, &content[line_start], line_len);
-                lines[num_lines].text[line_len] = '\0';
-                lines[num_lines].length = line_len;
-                num_lines++;
+                line_t* line = nano_open_line(num_lines);
+                memcpy(line->text, &content[line_start], line_len);
+                line->text[line_len] = '\0';
+                line->length = line_len;
             }
             line_start = i + 1;
         }
     }
 
     if (num_lines == 0) {
-        num_lines = 1;
+        nano_open_line(0);
     }
 
     kfree(content);
@@ -869,57 +977,47 @@ static void nano_search_next(void) {
     int start_line = cursor_line;
     int start_col = cursor_col + 1;  /* Start after current position */
 
+    /* One skip table serves every line scanned */
+    strsearch_t search;
+    strsearch_init(&search, search_term, !search_case_sensitive);
+
     /* Search from current position to end */
     for (int line = start_line; line < num_lines; line++) {
         int col_start = (line == start_line) ? start_col : 0;
+        line_t* l = nano_line(line);
 
-        for (int col = col_start; col <= lines[line].length - search_len; col++) {
-            int match = 1;
-            for (int i = 0; i < search_len && match; i++) {
-                char c1 = lines[line].text[col + i];
-                char c2 = search_term[i];
-                if (!search_case_sensitive) {
-                    if (c1 >= 'A' && c1 <= 'Z') c1 += 32;
-                    if (c2 >= 'A' && c2 <= 'Z') c2 += 32;
-                }
-                if (c1 != c2) match = 0;
-            }
+        if (col_start > l->length - search_len) continue;
 
-            if (match) {
-                cursor_line = line;
-                cursor_col = col;
-                nano_ensure_cursor_visible();
-                nano_draw_screen();
-                return;
-            }
+        const char* hit = strsearch_find(&search, l->text + col_start,
+                                         (uint32_t)(l->length - col_start));
+        if (hit != NULL) {
+            cursor_line = line;
+            cursor_col = (int)(hit - l->text);
+            nano_ensure_cursor_visible();
+            nano_draw_screen();
+            return;
         }
     }
 
     /* Wrap around if enabled */
     if (search_wrap) {
         for (int line = 0; line <= start_line; line++) {
-            int col_end = (line == start_line) ? start_col : lines[line].length;
-
-            for (int col = 0; col <= col_end - search_len; col++) {
-                int match = 1;
-                for (int i = 0; i < search_len && match; i++) {
-                    char c1 = lines[line].text[col + i];
-                    char c2 = search_term[i];
-                    if (!search_case_sensitive) {
-                        if (c1 >= 'A' && c1 <= 'Z') c1 += 32;
-                        if (c2 >= 'A' && c2 <= 'Z') c2 += 32;
-                    }
-                    if (c1 != c2) match = 0;
-                }
+            line_t* l = nano_line(line);
+            int col_end = (line == start_line) ? start_col : l->length;
 
-                if (match) {
-                    cursor_line = line;
-                    cursor_col = col;
-                    nano_ensure_cursor_visible();
-                    nano_draw_screen();
-                    nano_draw_status("Search wrapped");
-                    return;
-                }
+            if (col_end < search_len) continue;
+
+            const char* hit = strsearch_find(&search, l->text,
+                                             (uint32_t)(col_end - 1 + search_len <= l->length
+                                                            ? col_end - 1 + search_len
+                                                            : l->length));
+            if (hit != NULL) {
+                cursor_line = line;
+                cursor_col = (int)(hit - l->text);
+                nano_ensure_cursor_visible();
+                nano_draw_screen();
+                nano_draw_status("Search wrapped");
+                return;
             }
         }
     }
@@ -953,27 +1051,28 @@ static void nano_replace(void) {
 
     /* Replace all occurrences */
     for (int line = 0; line < num_lines; line++) {
-        for (int col = 0; col <= lines[line].length - search_len; col++) {
+        line_t* cur = nano_line(line);
+        for (int col = 0; col <= cur->length - search_len; col++) {
             int match = 1;
             for (int i = 0; i < search_len && match; i++) {
-                if (lines[line].text[col + i] != search_term[i]) match = 0;
+                if (cur->text[col + i] != search_term[i]) match = 0;
             }
 
             if (match) {
                 /* Check if replacement fits */
-                int new_len = lines[line].length - search_len + replace_len;
+                int new_len = cur->length - search_len + replace_len;
                 if (new_len >= NANO_MAX_LINE_LEN) continue;
 
                 /* Shift text */
                 if (replace_len != search_len) {
-                    memmove(&lines[line].text[col + replace_len],
-                            &lines[line].text[col + search_len],
-                            lines[line].length - col - search_len + 1);
+                    memmove(&cur->text[col + replace_len],
+                            &cur->text[col + search_len],
+                            cur->length - col - search_len + 1);
                 }
 
                 /* Insert replacement */
-                memcpy(&lines[line].text[col], replace_term, replace_len);
-                lines[line].length = new_len;
+                memcpy(&cur->text[col], replace_term, replace_len);
+                cur->length = new_len;
 
                 col += replace_len - 1;  /* Skip past replacement */
                 replaced++;
@@ -982,6 +1081,7 @@ static void nano_replace(void) {
         }
     }
 
+    text_all_dirty = 1;
     nano_draw_screen();
     char msg[80];
     snprintf(msg, sizeof(msg), "Replaced %d occurrences", replaced);
@@ -1026,10 +1126,10 @@ static void nano_cut_line(void) {
     }
 
     /* Copy line to buffer */
-    cut_buffer_size = lines[cursor_line].length + 2;
+    cut_buffer_size = nano_line(cursor_line)->length + 2;
     cut_buffer = (char*)kmalloc(cut_buffer_size);
     if (cut_buffer) {
-        strcpy(cut_buffer, lines[cursor_line].text);
+        strcpy(cut_buffer, nano_line(cursor_line)->text);
         strcat(cut_buffer, "\n");
     }
 
@@ -1049,10 +1149,10 @@ static void nano_copy_line(void) {
     }
 
     /* Copy line to buffer */
-    cut_buffer_size = lines[cursor_line].length + 2;
+    cut_buffer_size = nano_line(cursor_line)->length + 2;
     cut_buffer = (char*)kmalloc(cut_buffer_size);
     if (cut_buffer) {
-        strcpy(cut_buffer, lines[cursor_line].text);
+        strcpy(cut_buffer, nano_line(cursor_line)->text);
         strcat(cut_buffer, "\n");
     }
 
@@ -1074,21 +1174,22 @@ static void nano_paste(void) {
         return;
     }
 
-    /* Shift lines down */
-    for (int i = num_lines; i > cursor_line; i--) {
-        lines[i] = lines[i - 1];
-    }
-    num_lines++;
+    /* Un-journaled block edit: drop history so undo never replays
+     * against a buffer it no longer matches */
+    undolog_clear(&nano_undo_log);
+
+    line_t* line = nano_open_line(cursor_line);
 
     /* Copy content (without trailing newline) */
     int len = strlen(cut_buffer);
     if (len > 0 && cut_buffer[len - 1] == '\n') len--;
     if (len > NANO_MAX_LINE_LEN - 1) len = NANO_MAX_LINE_LEN - 1;
 
-    memcpy(lines[cursor_line].text, cut_buffer, len);
-    lines[cursor_line].text[len] = '\0';
-    lines[cursor_line].length = len;
+    memcpy(line->text, cut_buffer, len);
+    line->text[len] = '\0';
+    line->length = len;
 
+    nano_dirty_from(cursor_line);
     modified = 1;
     nano_draw_screen();
     nano_draw_status("Pasted 1 line");
@@ -1131,6 +1232,7 @@ static void nano_show_help(void) {
     vga_write_at("Press any key to continue...", COLOR_STATUS, 2, row + 1);
 
     keyboard_getchar();
+    text_all_dirty = 1;
     nano_draw_screen();
 }
 
@@ -1163,25 +1265,20 @@ static void nano_read_file(void) {
     vfs_read(file, 0, file->length, (uint8_t*)content);
     content[file->length] = '\0';
 
-    /* Insert lines at cursor */
+    /* Insert lines at cursor (un-journaled block edit) */
+    undolog_clear(&nano_undo_log);
     int inserted = 0;
     int line_start = 0;
 
     for (uint32_t i = 0; i <= file->length && num_lines < NANO_MAX_LINES; i++) {
         if (content[i] == '\n' || content[i] == '\0') {
-            /* Shift lines down */
-            for (int j = num_lines; j > cursor_line + inserted; j--) {
-                lines[j] = lines[j - 1];
-            }
-            num_lines++;
-
             int line_len = i - line_start;
             if (line_len > NANO_MAX_LINE_LEN - 1) line_len = NANO_MAX_LINE_LEN - 1;
 
-            int insert_pos = cursor_line + inserted;
-            memcpy(lines[insert_pos].text, &content[line_start], line_len);
-            lines[insert_pos].text[line_len] = '\0';
-            lines[insert_pos].length = line_len;
+            line_t* line = nano_open_line(cursor_line + inserted);
+            memcpy(line->text, &content[line_start], line_len);
+            line->text[line_len] = '\0';
+            line->length = line_len;
 
             inserted++;
             line_start = i + 1;
@@ -1190,6 +1287,7 @@ static void nano_read_file(void) {
 
     kfree(content);
     modified = 1;
+    nano_dirty_from(cursor_line);
 
     nano_draw_screen();
     char msg[80];
@@ -1294,9 +1392,9 @@ static void nano_main_loop(void) {
                         char msg[80];
                         snprintf(msg, sizeof(msg), "Line %d/%d, Col %d/%d, Char %d",
                                  cursor_line + 1, num_lines,
-                                 cursor_col + 1, lines[cursor_line].length,
-                                 cursor_col < lines[cursor_line].length ?
-                                     (unsigned char)lines[cursor_line].text[cursor_col] : 0);
+                                 cursor_col + 1, nano_line(cursor_line)->length,
+                                 cursor_col < nano_line(cursor_line)->length ?
+                                     (unsigned char)nano_line(cursor_line)->text[cursor_col] : 0);
                         nano_draw_status(msg);
                     }
                     break;
@@ -1306,6 +1404,7 @@ static void nano_main_loop(void) {
                     break;
 
                 case 'L' - '@':  /* Ctrl+L - Refresh */
+                    text_all_dirty = 1;
                     nano_draw_screen();
                     break;
 
@@ -1327,7 +1426,7 @@ static void nano_main_loop(void) {
                     break;
 
                 case 'E' - '@':  /* Ctrl+E - End */
-                    cursor_col = lines[cursor_line].length;
+                    cursor_col = nano_line(cursor_line)->length;
                     nano_draw_screen();
                     break;
             }
@@ -1352,7 +1451,7 @@ static void nano_main_loop(void) {
             nano_ensure_cursor_visible();
             nano_draw_screen();
         } else if (uc == KEY_END) {
-            cursor_col = lines[cursor_line].length;
+            cursor_col = nano_line(cursor_line)->length;
             nano_ensure_cursor_visible();
             nano_draw_screen();
         } else if (uc == KEY_PAGEUP) {
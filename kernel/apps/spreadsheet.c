@@ -84,12 +84,16 @@ static void ss_format_cell(int row, int col);
 static int ss_save_file(const char* name);
 static int ss_load_file(const char* name);
 static void ss_clear_all(void);
+static void ss_deps_reset(void);
+static void ss_track_cell(int row, int col);
+static void ss_recalc(int row, int col);
 
 /*
  * Initialize spreadsheet
  */
 void spreadsheet_init(void) {
     memset(cells, 0, sizeof(cells));
+    ss_deps_reset();
     cursor_row = 0;
     cursor_col = 0;
     view_row = 0;
@@ -449,10 +453,9 @@ static void ss_end_edit(int save) {
             }
         }
 
-        /* Evaluate if formula */
-        if (cell->type == CELL_FORMULA) {
-            ss_evaluate_cell(cursor_row, cursor_col);
-        }
+        /* Update the dependency graph and recalc downstream cells */
+        ss_track_cell(cursor_row, cursor_col);
+        ss_recalc(cursor_row, cursor_col);
 
         ss_format_cell(cursor_row, cursor_col);
         modified = 1;
@@ -462,6 +465,8 @@ static void ss_end_edit(int save) {
         cell->type = CELL_EMPTY;
         cell->content[0] = '\0';
         cell->value = 0;
+        ss_track_cell(cursor_row, cursor_col);
+        ss_recalc(cursor_row, cursor_col);
         ss_format_cell(cursor_row, cursor_col);
         modified = 1;
     }
@@ -894,12 +899,267 @@ static void ss_evaluate_cell(int row, int col) {
 }
 
 /*
- * Evaluate all cells (for recalculation)
+ * Formula dependency graph. Each formula cell registers the ranges it
+ * reads, so an edit re-evaluates only the cells transitively downstream
+ * of it, in dependency order, instead of sweeping the whole sheet.
+ * Edges are kept as ranges: a SUM over a column is one entry, not a
+ * hundred.
+ */
+#define SS_MAX_FORMULAS 512
+#define SS_MAX_DEPS     8
+
+typedef struct {
+    uint8_t r1, c1;             /* Top-left of referenced range */
+    uint8_t r2, c2;             /* Bottom-right (inclusive) */
+} ss_dep_t;
+
+typedef struct {
+    uint8_t in_use;
+    uint8_t row, col;           /* Where the formula lives */
+    uint8_t ndeps;
+    ss_dep_t deps[SS_MAX_DEPS];
+} ss_formula_t;
+
+static ss_formula_t ss_formulas[SS_MAX_FORMULAS];
+static int16_t ss_formula_idx[SS_MAX_ROWS][SS_MAX_COLS];
+static uint8_t ss_dirty[SS_MAX_ROWS][SS_MAX_COLS];
+static uint16_t ss_recalc_queue[SS_MAX_FORMULAS + 1];
+
+static void ss_deps_reset(void) {
+    memset(ss_formulas, 0, sizeof(ss_formulas));
+    memset(ss_dirty, 0, sizeof(ss_dirty));
+    for (int r = 0; r < SS_MAX_ROWS; r++) {
+        for (int c = 0; c < SS_MAX_COLS; c++) {
+            ss_formula_idx[r][c] = -1;
+        }
+    }
+}
+
+static void ss_deps_add(ss_formula_t* fo, int r1, int c1, int r2, int c2) {
+    if (r1 > r2) { int t = r1; r1 = r2; r2 = t; }
+    if (c1 > c2) { int t = c1; c1 = c2; c2 = t; }
+    if (fo->ndeps >= SS_MAX_DEPS) {
+        /* Out of slots: conservatively depend on the whole sheet */
+        fo->deps[0].r1 = 0;
+        fo->deps[0].c1 = 0;
+        fo->deps[0].r2 = SS_MAX_ROWS - 1;
+        fo->deps[0].c2 = SS_MAX_COLS - 1;
+        return;
+    }
+    ss_dep_t* d = &fo->deps[fo->ndeps++];
+    d->r1 = r1;
+    d->c1 = c1;
+    d->r2 = r2;
+    d->c2 = c2;
+}
+
+/*
+ * Pull the cell references and ranges out of a formula string. Function
+ * names (letters followed by letters or '(') are skipped; a reference
+ * is a single column letter followed by digits, optionally ":ref" for
+ * a range.
+ */
+static void ss_extract_deps(const char* p, ss_formula_t* fo) {
+    fo->ndeps = 0;
+
+    while (*p) {
+        char c = *p;
+        if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
+            char n = p[1];
+            if ((n >= 'A' && n <= 'Z') || (n >= 'a' && n <= 'z') || n == '(') {
+                /* Function name - skip the word */
+                while ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z')) p++;
+                continue;
+            }
+
+            char ref[8];
+            int i = 0;
+            ref[i++] = *p++;
+            while (*p >= '0' && *p <= '9' && i < 7) ref[i++] = *p++;
+            ref[i] = '\0';
+
+            int r1, c1;
+            if (ss_parse_ref(ref, &r1, &c1) < 0) continue;
+            int r2 = r1, c2 = c1;
+
+            if (*p == ':') {
+                const char* q = p + 1;
+                if ((*q >= 'A' && *q <= 'Z') || (*q >= 'a' && *q <= 'z')) {
+                    char ref2[8];
+                    int j = 0;
+                    ref2[j++] = *q++;
+                    while (*q >= '0' && *q <= '9' && j < 7) ref2[j++] = *q++;
+                    ref2[j] = '\0';
+                    if (ss_parse_ref(ref2, &r2, &c2) == 0) {
+                        p = q;
+                    } else {
+                        r2 = r1;
+                        c2 = c1;
+                    }
+                }
+            }
+
+            ss_deps_add(fo, r1, c1, r2, c2);
+        } else {
+            p++;
+        }
+    }
+}
+
+/*
+ * Keep the dependency registry in sync after a cell changes
+ */
+static void ss_track_cell(int row, int col) {
+    int idx = ss_formula_idx[row][col];
+
+    if (cells[row][col].type != CELL_FORMULA) {
+        if (idx >= 0) {
+            ss_formulas[idx].in_use = 0;
+            ss_formula_idx[row][col] = -1;
+        }
+        return;
+    }
+
+    if (idx < 0) {
+        for (int i = 0; i < SS_MAX_FORMULAS; i++) {
+            if (!ss_formulas[i].in_use) {
+                idx = i;
+                break;
+            }
+        }
+        if (idx < 0) return;    /* Registry full: cell recalcs only when edited */
+        ss_formulas[idx].in_use = 1;
+        ss_formulas[idx].row = row;
+        ss_formulas[idx].col = col;
+        ss_formula_idx[row][col] = (int16_t)idx;
+    }
+
+    ss_extract_deps(cells[row][col].content, &ss_formulas[idx]);
+}
+
+/*
+ * Does this formula read the given cell?
+ */
+static int ss_dep_hits(ss_formula_t* fo, int row, int col) {
+    for (int i = 0; i < fo->ndeps; i++) {
+        ss_dep_t* d = &fo->deps[i];
+        if (row >= d->r1 && row <= d->r2 && col >= d->c1 && col <= d->c2) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Does this formula still read a cell waiting to be recalculated?
+ */
+static int ss_deps_dirty(ss_formula_t* fo) {
+    for (int i = 0; i < fo->ndeps; i++) {
+        ss_dep_t* d = &fo->deps[i];
+        for (int r = d->r1; r <= d->r2; r++) {
+            for (int c = d->c1; c <= d->c2; c++) {
+                if (ss_dirty[r][c]) return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/*
+ * Evaluate every dirty formula in dependency order: a formula runs only
+ * once nothing it reads is still waiting. If a round makes no progress
+ * the remaining cells form a reference cycle; they are zeroed and shown
+ * as #CYCLE instead of looping forever.
+ */
+static void ss_recalc_run(void) {
+    int progress = 1;
+    int remaining = 0;
+
+    do {
+        progress = 0;
+        remaining = 0;
+        for (int i = 0; i < SS_MAX_FORMULAS; i++) {
+            ss_formula_t* fo = &ss_formulas[i];
+            if (!fo->in_use || !ss_dirty[fo->row][fo->col]) continue;
+            if (ss_deps_dirty(fo)) {
+                remaining = 1;
+                continue;
+            }
+            ss_evaluate_cell(fo->row, fo->col);
+            ss_format_cell(fo->row, fo->col);
+            ss_dirty[fo->row][fo->col] = 0;
+            progress = 1;
+        }
+    } while (progress && remaining);
+
+    if (remaining) {
+        for (int i = 0; i < SS_MAX_FORMULAS; i++) {
+            ss_formula_t* fo = &ss_formulas[i];
+            if (!fo->in_use || !ss_dirty[fo->row][fo->col]) continue;
+            cell_t* cell = &cells[fo->row][fo->col];
+            cell->value = 0;
+            memset(cell->display, ' ', SS_CELL_WIDTH);
+            memcpy(cell->display + SS_CELL_WIDTH - 6, "#CYCLE", 6);
+            cell->display[SS_CELL_WIDTH] = '\0';
+            ss_dirty[fo->row][fo->col] = 0;
+        }
+    }
+}
+
+/*
+ * Re-evaluate only the cells transitively downstream of an edit
+ */
+static void ss_recalc(int row, int col) {
+    int head = 0, tail = 0;
+
+    ss_dirty[row][col] = 1;
+    ss_recalc_queue[tail++] = (uint16_t)(row * SS_MAX_COLS + col);
+
+    /* Closure: pull in every formula reading a cell already queued */
+    while (head < tail) {
+        int id = ss_recalc_queue[head++];
+        int r = id / SS_MAX_COLS;
+        int c = id % SS_MAX_COLS;
+
+        for (int i = 0; i < SS_MAX_FORMULAS; i++) {
+            ss_formula_t* fo = &ss_formulas[i];
+            if (!fo->in_use || ss_dirty[fo->row][fo->col]) continue;
+            if (ss_dep_hits(fo, r, c) && tail <= SS_MAX_FORMULAS) {
+                ss_dirty[fo->row][fo->col] = 1;
+                ss_recalc_queue[tail++] = (uint16_t)(fo->row * SS_MAX_COLS + fo->col);
+            }
+        }
+    }
+
+    /* The edited cell's own value is already final unless it is a
+     * formula; untracked formulas (registry full) evaluate in place */
+    if (cells[row][col].type != CELL_FORMULA) {
+        ss_dirty[row][col] = 0;
+    } else if (ss_formula_idx[row][col] < 0) {
+        ss_evaluate_cell(row, col);
+        ss_format_cell(row, col);
+        ss_dirty[row][col] = 0;
+    }
+
+    ss_recalc_run();
+}
+
+/*
+ * Evaluate all cells (for recalculation after load): mark every tracked
+ * formula dirty and let the dependency-ordered runner sequence them
  */
 static void ss_evaluate_all(void) {
+    for (int i = 0; i < SS_MAX_FORMULAS; i++) {
+        if (ss_formulas[i].in_use) {
+            ss_dirty[ss_formulas[i].row][ss_formulas[i].col] = 1;
+        }
+    }
+    ss_recalc_run();
+
+    /* Formulas that did not fit the registry still get a single pass */
     for (int r = 0; r < SS_MAX_ROWS; r++) {
         for (int c = 0; c < SS_MAX_COLS; c++) {
-            if (cells[r][c].type == CELL_FORMULA) {
+            if (cells[r][c].type == CELL_FORMULA && ss_formula_idx[r][c] < 0) {
                 ss_evaluate_cell(r, c);
                 ss_format_cell(r, c);
             }
@@ -912,6 +1172,7 @@ static void ss_evaluate_all(void) {
  */
 static void ss_clear_all(void) {
     memset(cells, 0, sizeof(cells));
+    ss_deps_reset();
     for (int r = 0; r < SS_MAX_ROWS; r++) {
         for (int c = 0; c < SS_MAX_COLS; c++) {
             ss_format_cell(r, c);
@@ -1031,7 +1292,7 @@ static int ss_load_file(const char* name) {
                 /* Determine type */
                 if (cell_buf[0] == '=') {
                     cell->type = CELL_FORMULA;
-                    ss_evaluate_cell(row, col);
+                    ss_track_cell(row, col);
                 } else {
                     /* Check if number */
                     int is_num = 1;
@@ -1145,7 +1406,6 @@ void spreadsheet_run(void) {
             /* Handle editing input */
             if (c == '\n') {
                 ss_end_edit(1);  /* Save */
-                ss_evaluate_all();
                 ss_draw_grid();
             } else if (c == KEY_ESCAPE) {
                 ss_end_edit(0);  /* Cancel */
@@ -1270,7 +1530,6 @@ void spreadsheet_run_file(const char* file) {
         if (editing) {
             if (c == '\n') {
                 ss_end_edit(1);
-                ss_evaluate_all();
                 ss_draw_grid();
             } else if (c == KEY_ESCAPE) {
                 ss_end_edit(0);
@@ -12,6 +12,7 @@
 
 #include "../include/gdt.h"
 #include "../include/string.h"
+#include "../include/syscall.h"
 
 /* GDT entries */
 static gdt_entry_t gdt_entries[6];
@@ -104,5 +105,6 @@ void gdt_init(void) {
  */
 void tss_set_kernel_stack(uint32_t stack) {
     tss_entry.esp0 = stack;
+    syscall_sysenter_stack(stack);
 }
 
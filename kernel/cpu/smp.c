@@ -0,0 +1,325 @@
+/*
+ * MiniOS SMP Topology Detection
+ *
+ * Finds the other processors the firmware knows about. Two table
+ * formats cover everything we run on: the ACPI MADT (QEMU, anything
+ * from this century) and the Intel MP 1.4 floating pointer structure
+ * (Bochs, very old boards). Both live in low physical memory, which
+ * paging_init identity-maps, so this is plain pointer chasing.
+ *
+ * Only detection lives here. Starting an AP takes a real-mode
+ * trampoline, a per-CPU GDT/TSS and an SMP-safe kernel; until then
+ * the count is what the scheduler and shell get to see.
+ */
+
+#include "../include/smp.h"
+#include "../include/string.h"
+#include "../include/stdio.h"
+
+/* ACPI RSDP signature and search window */
+#define RSDP_SIG        "RSD PTR "
+#define BIOS_AREA_START 0x000E0000
+#define BIOS_AREA_END   0x00100000
+#define EBDA_PTR_ADDR   0x0000040E
+
+/* MADT interrupt controller entry types we care about */
+#define MADT_TYPE_LAPIC 0
+
+/* MP floating pointer signature */
+#define MPFP_SIG 0x5F504D5F  /* "_MP_" */
+
+/* ACPI system description table header */
+typedef struct {
+    char signature[4];
+    uint32_t length;
+    uint8_t revision;
+    uint8_t checksum;
+    char oem_id[6];
+    char oem_table_id[8];
+    uint32_t oem_revision;
+    uint32_t creator_id;
+    uint32_t creator_revision;
+} __attribute__((packed)) acpi_sdt_header_t;
+
+/* Root system description pointer (ACPI 1.0 part) */
+typedef struct {
+    char signature[8];
+    uint8_t checksum;
+    char oem_id[6];
+    uint8_t revision;
+    uint32_t rsdt_addr;
+} __attribute__((packed)) acpi_rsdp_t;
+
+/* MADT: header, LAPIC base, then variable-length entries */
+typedef struct {
+    acpi_sdt_header_t header;
+    uint32_t lapic_addr;
+    uint32_t flags;
+} __attribute__((packed)) acpi_madt_t;
+
+/* One MADT processor local APIC entry */
+typedef struct {
+    uint8_t type;
+    uint8_t length;
+    uint8_t acpi_cpu_id;
+    uint8_t apic_id;
+    uint32_t flags;
+} __attribute__((packed)) madt_lapic_t;
+
+/* MP floating pointer structure (Intel MP spec 1.4) */
+typedef struct {
+    uint32_t signature;
+    uint32_t config_addr;
+    uint8_t length;
+    uint8_t revision;
+    uint8_t checksum;
+    uint8_t features[5];
+} __attribute__((packed)) mp_float_t;
+
+/* MP configuration table header */
+typedef struct {
+    uint32_t signature;  /* "PCMP" */
+    uint16_t length;
+    uint8_t revision;
+    uint8_t checksum;
+    char oem_id[8];
+    char product_id[12];
+    uint32_t oem_table_addr;
+    uint16_t oem_table_size;
+    uint16_t entry_count;
+    uint32_t lapic_addr;
+    uint16_t ext_length;
+    uint8_t ext_checksum;
+    uint8_t reserved;
+} __attribute__((packed)) mp_config_t;
+
+/* MP config processor entry */
+typedef struct {
+    uint8_t type;        /* 0 = processor */
+    uint8_t apic_id;
+    uint8_t apic_version;
+    uint8_t flags;       /* Bit 0: enabled, bit 1: BSP */
+    uint32_t cpuid_signature;
+    uint32_t features;
+    uint32_t reserved[2];
+} __attribute__((packed)) mp_processor_t;
+
+static smp_cpu_t cpus[SMP_MAX_CPUS];
+static uint32_t cpu_count = 0;
+static uint32_t lapic_base = 0;
+static const char* source = "none";
+
+/*
+ * Byte checksum over a table (valid tables sum to zero)
+ */
+static bool checksum_ok(const void* data, uint32_t length) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint8_t sum = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        sum += bytes[i];
+    }
+    return sum == 0;
+}
+
+/*
+ * Record one detected processor
+ */
+static void smp_add_cpu(uint8_t apic_id, bool enabled, bool bsp) {
+    if (cpu_count >= SMP_MAX_CPUS) {
+        return;
+    }
+    cpus[cpu_count].apic_id = apic_id;
+    cpus[cpu_count].enabled = enabled;
+    cpus[cpu_count].bsp = bsp;
+    cpu_count++;
+}
+
+/*
+ * Find the RSDP in the EBDA or the BIOS read-only area
+ */
+static acpi_rsdp_t* find_rsdp(void) {
+    /* First KB of the EBDA (segment pointer at 0x40E) */
+    uint32_t ebda = ((uint32_t)*(uint16_t*)EBDA_PTR_ADDR) << 4;
+    if (ebda >= 0x80000 && ebda < 0xA0000) {
+        for (uint32_t addr = ebda; addr < ebda + 1024; addr += 16) {
+            if (memcmp((void*)addr, RSDP_SIG, 8) == 0 &&
+                checksum_ok((void*)addr, 20)) {
+                return (acpi_rsdp_t*)addr;
+            }
+        }
+    }
+
+    /* BIOS area 0xE0000-0xFFFFF, 16-byte aligned */
+    for (uint32_t addr = BIOS_AREA_START; addr < BIOS_AREA_END; addr += 16) {
+        if (memcmp((void*)addr, RSDP_SIG, 8) == 0 &&
+            checksum_ok((void*)addr, 20)) {
+            return (acpi_rsdp_t*)addr;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Walk the RSDT for the MADT ("APIC") and pull the processor entries
+ */
+static bool scan_acpi(void) {
+    acpi_rsdp_t* rsdp = find_rsdp();
+    if (rsdp == NULL || rsdp->rsdt_addr == 0) {
+        return false;
+    }
+
+    acpi_sdt_header_t* rsdt = (acpi_sdt_header_t*)rsdp->rsdt_addr;
+    if (memcmp(rsdt->signature, "RSDT", 4) != 0 ||
+        !checksum_ok(rsdt, rsdt->length)) {
+        return false;
+    }
+
+    uint32_t entries = (rsdt->length - sizeof(acpi_sdt_header_t)) / 4;
+    uint32_t* tables = (uint32_t*)((uint8_t*)rsdt + sizeof(acpi_sdt_header_t));
+
+    for (uint32_t i = 0; i < entries; i++) {
+        acpi_madt_t* madt = (acpi_madt_t*)tables[i];
+        if (madt == NULL ||
+            memcmp(madt->header.signature, "APIC", 4) != 0 ||
+            !checksum_ok(madt, madt->header.length)) {
+            continue;
+        }
+
+        lapic_base = madt->lapic_addr;
+
+        uint8_t* entry = (uint8_t*)madt + sizeof(acpi_madt_t);
+        uint8_t* end = (uint8_t*)madt + madt->header.length;
+        bool first = true;
+        while (entry + 2 <= end && entry[1] >= 2) {
+            if (entry[0] == MADT_TYPE_LAPIC &&
+                entry[1] >= sizeof(madt_lapic_t)) {
+                madt_lapic_t* lapic = (madt_lapic_t*)entry;
+                /* Flags bit 0: processor enabled */
+                smp_add_cpu(lapic->apic_id, (lapic->flags & 1) != 0, first);
+                first = false;
+            }
+            entry += entry[1];
+        }
+
+        source = "acpi";
+        return cpu_count > 0;
+    }
+    return false;
+}
+
+/*
+ * Legacy fallback: MP floating pointer in the EBDA or BIOS area
+ */
+static bool scan_mp(void) {
+    mp_float_t* fp = NULL;
+
+    uint32_t ebda = ((uint32_t)*(uint16_t*)EBDA_PTR_ADDR) << 4;
+    if (ebda >= 0x80000 && ebda < 0xA0000) {
+        for (uint32_t addr = ebda; addr < ebda + 1024; addr += 16) {
+            if (*(uint32_t*)addr == MPFP_SIG && checksum_ok((void*)addr, 16)) {
+                fp = (mp_float_t*)addr;
+                break;
+            }
+        }
+    }
+    if (fp == NULL) {
+        for (uint32_t addr = BIOS_AREA_START; addr < BIOS_AREA_END; addr += 16) {
+            if (*(uint32_t*)addr == MPFP_SIG && checksum_ok((void*)addr, 16)) {
+                fp = (mp_float_t*)addr;
+                break;
+            }
+        }
+    }
+    if (fp == NULL || fp->config_addr == 0) {
+        return false;
+    }
+
+    mp_config_t* config = (mp_config_t*)fp->config_addr;
+    if (config->signature != 0x504D4350 ||  /* "PCMP" */
+        !checksum_ok(config, config->length)) {
+        return false;
+    }
+
+    lapic_base = config->lapic_addr;
+
+    uint8_t* entry = (uint8_t*)config + sizeof(mp_config_t);
+    for (uint16_t i = 0; i < config->entry_count; i++) {
+        if (entry[0] == 0) {
+            mp_processor_t* proc = (mp_processor_t*)entry;
+            smp_add_cpu(proc->apic_id,
+                        (proc->flags & 0x01) != 0,
+                        (proc->flags & 0x02) != 0);
+            entry += sizeof(mp_processor_t);
+        } else {
+            /* Bus/IOAPIC/interrupt entries are all 8 bytes */
+            entry += 8;
+        }
+    }
+
+    source = "mp";
+    return cpu_count > 0;
+}
+
+/*
+ * Scan the firmware tables for the CPU topology
+ */
+void smp_init(void) {
+    cpu_count = 0;
+    lapic_base = 0;
+
+    if (!scan_acpi() && !scan_mp()) {
+        /* No tables: assume the processor we are running on */
+        smp_add_cpu(0, true, true);
+        source = "none";
+    }
+
+    uint32_t usable = 0;
+    for (uint32_t i = 0; i < cpu_count; i++) {
+        if (cpus[i].enabled) {
+            usable++;
+        }
+    }
+
+    printk("SMP: %u CPU(s) (%u usable, source: %s)",
+           cpu_count, usable, source);
+    if (lapic_base != 0) {
+        printk(", LAPIC at 0x%08x", lapic_base);
+    }
+    printk("\n");
+    if (usable > 1) {
+        printk("SMP: secondary CPUs detected but not started (no AP bringup yet)\n");
+    }
+}
+
+uint32_t smp_cpu_count(void) {
+    return cpu_count > 0 ? cpu_count : 1;
+}
+
+const smp_cpu_t* smp_cpu_get(uint32_t index) {
+    if (index >= cpu_count) {
+        return NULL;
+    }
+    return &cpus[index];
+}
+
+uint32_t smp_lapic_base(void) {
+    return lapic_base;
+}
+
+/*
+ * Print the detected topology
+ */
+void smp_report(void) {
+    printk("cpus: %u detected (source: %s)\n", smp_cpu_count(), source);
+    for (uint32_t i = 0; i < cpu_count; i++) {
+        printk("  cpu%u: apic id %u%s%s\n", i, cpus[i].apic_id,
+               cpus[i].bsp ? " (bsp)" : "",
+               cpus[i].enabled ? "" : " (disabled)");
+    }
+    if (lapic_base != 0) {
+        printk("  lapic: 0x%08x\n", lapic_base);
+    }
+    if (cpu_count > 1) {
+        printk("  secondary CPUs are idle: AP bringup is not implemented\n");
+    }
+}
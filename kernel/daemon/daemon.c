@@ -12,17 +12,15 @@
 #include "../include/stdio.h"
 #include "../include/vga.h"
 #include "../include/heap.h"
+#include "../include/bcache.h"
+#include "../include/blockdev.h"
+#include "../include/swap.h"
+#include "../include/klog.h"
 
 /* Daemon registry */
 daemon_t daemons[MAX_DAEMONS];
 int num_daemons = 0;
 
-/* Kernel log buffer */
-#define KLOG_BUFFER_SIZE 4096
-static char klog_buffer[KLOG_BUFFER_SIZE];
-static uint32_t klog_write_pos = 0;
-static uint32_t klog_read_pos = 0;
-
 /*
  * Initialize daemon subsystem
  */
@@ -35,6 +33,8 @@ void daemon_init(void) {
     daemon_register("klogd", "Kernel log daemon", klogd_daemon);
     daemon_register("crond", "Task scheduler daemon", crond_daemon);
     daemon_register("kswapd", "Memory management daemon", kswapd_daemon);
+    daemon_register("bflushd", "Dirty buffer flusher daemon", bflushd_daemon);
+    daemon_register("kiod", "Async block I/O daemon", kiod_daemon);
     
     printk("Daemon: Subsystem initialized (%d daemons registered)\n", num_daemons);
 }
@@ -108,7 +108,9 @@ int daemon_start(const char* name) {
     d->pid = pid;
     d->state = DAEMON_RUNNING;
     d->start_time = timer_get_ticks();
-    
+
+    klog(KLOG_INFO, KLOG_SUB_DAEMON, "%s started (pid %d)", d->name, pid);
+
     return 0;
 }
 
@@ -131,7 +133,9 @@ int daemon_stop(const char* name) {
     
     d->pid = -1;
     d->state = DAEMON_STOPPED;
-    
+
+    klog(KLOG_INFO, KLOG_SUB_DAEMON, "%s stopped", d->name);
+
     return 0;
 }
 
@@ -195,27 +199,6 @@ void daemon_print_status(void) {
     }
 }
 
-/*
- * Add message to kernel log
- */
-void klog_write(const char* msg) {
-    while (*msg && klog_write_pos < KLOG_BUFFER_SIZE - 1) {
-        klog_buffer[klog_write_pos++] = *msg++;
-    }
-}
-
-/*
- * Read from kernel log
- */
-int klog_read(char* buf, int size) {
-    int count = 0;
-    while (klog_read_pos < klog_write_pos && count < size - 1) {
-        buf[count++] = klog_buffer[klog_read_pos++];
-    }
-    buf[count] = '\0';
-    return count;
-}
-
 /* ============================================
  * Daemon Entry Points
  * ============================================ */
@@ -232,7 +215,7 @@ void init_daemon(void) {
             process_t* proc = &process_table[i];
             if (proc->state == PROCESS_STATE_ZOMBIE && proc->ppid == 1) {
                 /* Reap orphaned zombie */
-                proc->state = PROCESS_STATE_UNUSED;
+                process_slot_free(proc);
             }
         }
 
@@ -249,8 +232,8 @@ void klogd_daemon(void) {
     /* Log daemon main loop */
     while (1) {
         /* In a real OS, this would write logs to disk */
-        /* For now, just yield and let other processes run */
-        yield();
+        /* For now, sleep and let other processes run */
+        timer_sleep_ms(1000);
     }
 }
 
@@ -271,22 +254,74 @@ void crond_daemon(void) {
             /* In a real OS, check crontab and run scheduled tasks */
         }
 
-        yield();
+        /* Sleep until the next check instead of spinning on yield */
+        timer_sleep_ms(1000);
+    }
+}
+
+/*
+ * bflushd daemon - Dirty buffer flusher
+ * Periodically writes dirty buffer-cache sectors back to disk so
+ * file saves return as soon as the cache is updated. Flushes early
+ * when many sectors are dirty.
+ */
+void bflushd_daemon(void) {
+    /* Flush every ~2 seconds (200 ticks at 100Hz) */
+    #define BFLUSH_INTERVAL_TICKS 200
+    /* ...or as soon as this many sectors are dirty */
+    #define BFLUSH_DIRTY_THRESHOLD 64
+
+    uint32_t last_flush = timer_get_ticks();
+
+    while (1) {
+        uint32_t now = timer_get_ticks();
+
+        if (now - last_flush >= BFLUSH_INTERVAL_TICKS ||
+            bcache_dirty_count() >= BFLUSH_DIRTY_THRESHOLD) {
+            bcache_sync(NULL);
+            last_flush = now;
+        }
+
+        /* Short sleep keeps the dirty threshold responsive without
+         * burning CPU in a yield loop */
+        timer_sleep_ticks(25);
     }
 }
 
 /*
  * kswapd daemon - Memory management daemon
- * Handles memory pressure and page swapping (placeholder)
+ * Evicts cold user pages to the swap partition when free frames drop
+ * below the low watermark (see swap.c), so allocations keep working
+ * under overcommit instead of failing outright.
  */
 void kswapd_daemon(void) {
+    /* Pages evicted per pass; small batches keep disk and CPU shared
+     * fairly with foreground work */
+    #define KSWAPD_BATCH 32
+
     while (1) {
-        /* In a real OS, this would:
-         * - Monitor memory pressure
-         * - Swap out pages when memory is low
-         * - Manage page cache
-         */
-        yield();
+        if (swap_available() && swap_pressure()) {
+            uint32_t n = swap_shrink(KSWAPD_BATCH);
+            /* Back off when nothing was cold enough to evict; the
+             * aging scan needs time between rounds anyway */
+            timer_sleep_ticks(n > 0 ? 10 : 100);
+        } else {
+            timer_sleep_ms(1000);
+        }
+    }
+}
+
+/*
+ * kiod daemon - Async block I/O daemon
+ * Drains the blockdev request queue in elevator order so readahead
+ * and other background transfers run concurrently with foreground
+ * processes, then parks until the next submit.
+ */
+void kiod_daemon(void) {
+    while (1) {
+        if (!blockdev_queue_service()) {
+            blockdev_queue_park();
+        }
     }
 }
 
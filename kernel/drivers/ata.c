@@ -10,11 +10,267 @@
 #include "../include/string.h"
 #include "../include/stdio.h"
 #include "../include/blockdev.h"
+#include "../include/isr.h"
+#include "../include/pic.h"
+#include "../include/process.h"
+#include "../include/scheduler.h"
+#include "../include/pmm.h"
+#include "../include/workqueue.h"
+
+/* IRQ lines for the two IDE channels */
+#define ATA_IRQ_PRIMARY     14
+#define ATA_IRQ_SECONDARY   15
+
+/* PCI configuration space access */
+#define PCI_CONFIG_ADDRESS  0xCF8
+#define PCI_CONFIG_DATA     0xCFC
+
+/* Bus master IDE register offsets (per channel) */
+#define BM_REG_COMMAND      0x00
+#define BM_REG_STATUS       0x02
+#define BM_REG_PRDT         0x04
+
+#define BM_CMD_START        0x01
+#define BM_CMD_READ         0x08    /* Direction: device -> memory */
+
+#define BM_STATUS_ACTIVE    0x01
+#define BM_STATUS_ERROR     0x02
+#define BM_STATUS_IRQ       0x04
+
+/* DMA bounce buffer: 64KB, PRD entries split at 64KB boundaries */
+#define ATA_DMA_BUF_FRAMES  16
+#define ATA_DMA_BUF_SIZE    (ATA_DMA_BUF_FRAMES * PAGE_SIZE)
+#define ATA_DMA_MAX_PRDS    4
+
+/* One physical region descriptor */
+typedef struct {
+    uint32_t phys;              /* Physical base address */
+    uint16_t byte_count;        /* 0 means 64KB */
+    uint16_t flags;             /* Bit 15 set on the last entry */
+} __attribute__((packed)) ata_prd_t;
 
 /* Detected drives */
 static ata_drive_t drives[ATA_MAX_DRIVES];
 static uint8_t drive_count = 0;
 
+/*
+ * Per-channel interrupt state. A command handshake parks the calling
+ * process here; the IRQ14/15 handler counts completions and wakes it,
+ * so the CPU is free for other processes while the disk seeks.
+ */
+typedef struct {
+    volatile uint32_t irq_pending;  /* Interrupts seen, not yet consumed */
+    process_t* waiter;              /* Process sleeping on this channel */
+    uint16_t bm_base;               /* Bus master registers (0 = no DMA) */
+    ata_prd_t* prdt;                /* PRD table (physically contiguous) */
+    uint8_t* dma_buf;               /* Bounce buffer (identity mapped) */
+} ata_channel_t;
+
+static ata_channel_t channels[2];
+
+static bool ata_wait_drq(uint16_t port);
+
+/*
+ * IRQ handler shared by both channels. Reading the status register
+ * acknowledges the interrupt on the drive side.
+ */
+static void ata_irq_primary(registers_t* regs) {
+    (void)regs;
+    inb(ATA_PRIMARY_DATA + 7);
+    channels[0].irq_pending++;
+    if (channels[0].waiter) {
+        process_t* proc = channels[0].waiter;
+        channels[0].waiter = NULL;
+        process_unblock(proc);
+    }
+}
+
+static void ata_irq_secondary(registers_t* regs) {
+    (void)regs;
+    inb(ATA_SECONDARY_DATA + 7);
+    channels[1].irq_pending++;
+    if (channels[1].waiter) {
+        process_t* proc = channels[1].waiter;
+        channels[1].waiter = NULL;
+        process_unblock(proc);
+    }
+}
+
+/*
+ * Sleep until the channel's next interrupt. Falls back to polling
+ * before the scheduler is running (boot-time probing and mounts).
+ * Returns true once an interrupt has been consumed.
+ */
+static bool ata_wait_irq(uint8_t bus, uint16_t port) {
+    ata_channel_t* ch = &channels[bus];
+
+    if (!scheduler_running() || current_process == NULL) {
+        /* Early boot: no one to yield to, poll instead */
+        if (!ata_wait_drq(port)) return false;
+        ch->irq_pending = 0;
+        return true;
+    }
+
+    /* Interrupts off while deciding to sleep, so the IRQ cannot
+     * slip in between the check and the block */
+    __asm__ volatile ("cli");
+    while (ch->irq_pending == 0) {
+        ch->waiter = current_process;
+        process_block(PROCESS_STATE_BLOCKED);
+        __asm__ volatile ("cli");
+    }
+    ch->irq_pending--;
+    __asm__ volatile ("sti");
+    return true;
+}
+
+/*
+ * Read a 32-bit PCI configuration register
+ */
+static uint32_t pci_config_read(uint8_t bus, uint8_t slot, uint8_t func, uint8_t offset) {
+    uint32_t address = 0x80000000 |
+                       ((uint32_t)bus << 16) |
+                       ((uint32_t)slot << 11) |
+                       ((uint32_t)func << 8) |
+                       (offset & 0xFC);
+    outl(PCI_CONFIG_ADDRESS, address);
+    return inl(PCI_CONFIG_DATA);
+}
+
+static void pci_config_write(uint8_t bus, uint8_t slot, uint8_t func, uint8_t offset, uint32_t value) {
+    uint32_t address = 0x80000000 |
+                       ((uint32_t)bus << 16) |
+                       ((uint32_t)slot << 11) |
+                       ((uint32_t)func << 8) |
+                       (offset & 0xFC);
+    outl(PCI_CONFIG_ADDRESS, address);
+    outl(PCI_CONFIG_DATA, value);
+}
+
+/*
+ * Find the PCI IDE controller and set up bus master DMA for both
+ * channels: BAR4 holds the bus master register block, 8 bytes per
+ * channel. Each channel gets a PRD table and a bounce buffer from
+ * the PMM (identity mapped, physically contiguous).
+ */
+static void ata_dma_init(void) {
+    uint16_t bm_base = 0;
+
+    for (uint8_t slot = 0; slot < 32 && bm_base == 0; slot++) {
+        uint32_t id = pci_config_read(0, slot, 0, 0x00);
+        if (id == 0xFFFFFFFF) continue;
+
+        uint32_t class_reg = pci_config_read(0, slot, 0, 0x08);
+        uint8_t class_code = (class_reg >> 24) & 0xFF;
+        uint8_t subclass = (class_reg >> 16) & 0xFF;
+
+        if (class_code == 0x01 && subclass == 0x01) {
+            uint32_t bar4 = pci_config_read(0, slot, 0, 0x20);
+            if (bar4 & 1) {
+                bm_base = (uint16_t)(bar4 & 0xFFFC);
+
+                /* Enable bus mastering in the PCI command register */
+                uint32_t cmd = pci_config_read(0, slot, 0, 0x04);
+                pci_config_write(0, slot, 0, 0x04, cmd | 0x04);
+            }
+        }
+    }
+
+    if (bm_base == 0) {
+        printk("ATA: No bus master IDE controller, using PIO\n");
+        return;
+    }
+
+    for (int c = 0; c < 2; c++) {
+        uint32_t prdt_phys = pmm_alloc_frame();
+        uint32_t buf_phys = pmm_alloc_frames(ATA_DMA_BUF_FRAMES);
+        if (prdt_phys == 0 || buf_phys == 0) {
+            printk("ATA: DMA buffer allocation failed, using PIO\n");
+            return;
+        }
+
+        channels[c].bm_base = bm_base + c * 8;
+        channels[c].prdt = (ata_prd_t*)prdt_phys;
+        channels[c].dma_buf = (uint8_t*)buf_phys;
+    }
+
+    printk("ATA: Bus master DMA at 0x%04X (%u KB bounce per channel)\n",
+           bm_base, ATA_DMA_BUF_SIZE / 1024);
+}
+
+/*
+ * Build the PRD table for a transfer from the channel's bounce
+ * buffer, splitting entries at 64KB physical boundaries.
+ */
+static bool ata_dma_setup_prdt(ata_channel_t* ch, uint32_t bytes) {
+    uint32_t phys = (uint32_t)ch->dma_buf;
+    int n = 0;
+
+    while (bytes > 0) {
+        if (n >= ATA_DMA_MAX_PRDS) return false;
+
+        uint32_t boundary = (phys + 0x10000) & ~0xFFFFu;
+        uint32_t chunk = boundary - phys;
+        if (chunk > bytes) chunk = bytes;
+
+        ch->prdt[n].phys = phys;
+        ch->prdt[n].byte_count = (uint16_t)(chunk & 0xFFFF);  /* 0x10000 -> 0 */
+        ch->prdt[n].flags = 0;
+
+        phys += chunk;
+        bytes -= chunk;
+        n++;
+    }
+
+    ch->prdt[n - 1].flags = 0x8000;  /* End of table */
+    outl(ch->bm_base + BM_REG_PRDT, (uint32_t)ch->prdt);
+    return true;
+}
+
+/*
+ * Run one DMA transfer of up to ATA_DMA_BUF_SIZE bytes. The caller
+ * has already selected the drive and written the LBA/count registers.
+ * Returns false if the controller reports an error (caller falls
+ * back to PIO).
+ */
+static bool ata_dma_transfer(ata_drive_t* drive, ata_channel_t* ch,
+                             uint32_t bytes, bool is_write, uint8_t cmd) {
+    uint16_t port = drive->base_port;
+
+    if (!ata_dma_setup_prdt(ch, bytes)) {
+        return false;
+    }
+
+    /* Clear error/interrupt status (write 1 to clear) */
+    outb(ch->bm_base + BM_REG_STATUS,
+         inb(ch->bm_base + BM_REG_STATUS) | BM_STATUS_ERROR | BM_STATUS_IRQ);
+
+    /* Direction, then start after the drive command is issued */
+    outb(ch->bm_base + BM_REG_COMMAND, is_write ? 0 : BM_CMD_READ);
+
+    ch->irq_pending = 0;
+    outb(port + 7, cmd);
+    outb(ch->bm_base + BM_REG_COMMAND,
+         (is_write ? 0 : BM_CMD_READ) | BM_CMD_START);
+
+    if (!ata_wait_irq(drive->bus, port)) {
+        outb(ch->bm_base + BM_REG_COMMAND, 0);
+        return false;
+    }
+
+    /* Stop the engine and check for errors */
+    outb(ch->bm_base + BM_REG_COMMAND, 0);
+    uint8_t bm_status = inb(ch->bm_base + BM_REG_STATUS);
+    outb(ch->bm_base + BM_REG_STATUS, bm_status | BM_STATUS_ERROR | BM_STATUS_IRQ);
+
+    if (bm_status & BM_STATUS_ERROR) {
+        return false;
+    }
+
+    uint8_t status = inb(port + 7);
+    return !(status & ATA_STATUS_ERR);
+}
+
 /*
  * Wait for drive to be ready (not busy)
  */
@@ -105,13 +361,19 @@ static bool ata_identify(uint16_t port, uint16_t ctrl_port, uint8_t drive, ata_d
     
     /* Send IDENTIFY command */
     outb(port + 7, ATA_CMD_IDENTIFY);
-    
-    /* Check if drive exists */
+
+    /* Bounded first poll: an absent drive reads 0 (no device) or
+     * 0xFF (floating bus) and will never clear BSY, so fail it here
+     * in microseconds instead of riding out the full ready timeout */
     uint8_t status = inb(port + 7);
-    if (status == 0) {
+    int spin = 4096;
+    while (spin-- > 0 && (status & ATA_STATUS_BSY) && status != 0xFF) {
+        status = inb(port + 7);
+    }
+    if (status == 0 || status == 0xFF) {
         return false;  /* No drive */
     }
-    
+
     /* Wait for BSY to clear */
     if (!ata_wait_ready(port)) {
         return false;
@@ -175,69 +437,85 @@ static bool ata_identify(uint16_t port, uint16_t ctrl_port, uint8_t drive, ata_d
     return true;
 }
 
+/*
+ * Probe both drives of one channel. A floating bus (status 0xFF with
+ * no controller driving it) means the whole channel is empty and is
+ * skipped without issuing a single command.
+ */
+static void ata_probe_channel(int bus) {
+    uint16_t port = (bus == 0) ? ATA_PRIMARY_DATA : ATA_SECONDARY_DATA;
+    uint16_t ctrl = (bus == 0) ? ATA_PRIMARY_CONTROL : ATA_SECONDARY_CONTROL;
+    const char* bus_name = (bus == 0) ? "primary" : "secondary";
+
+    if (inb(port + 7) == 0xFF) {
+        printk("ATA: %s bus floating, skipped\n", bus_name);
+        return;
+    }
+
+    ata_soft_reset(ctrl);
+
+    for (int d = 0; d < 2; d++) {
+        int i = bus * 2 + d;
+        if (ata_identify(port, ctrl, d == 0 ? ATA_MASTER : ATA_SLAVE, &drives[i])) {
+            drives[i].bus = bus;
+            drives[i].drive = d;
+            drive_count++;
+            printk("ATA: Found %s on %s %s: %s (%u MB)\n",
+                   drives[i].type == ATA_TYPE_ATA ? "HDD" : "CDROM",
+                   bus_name, d == 0 ? "master" : "slave",
+                   drives[i].model, drives[i].size_mb);
+        }
+    }
+}
+
+/*
+ * Deferred probe of the non-boot channel (workqueue context). The
+ * boot path only waits for the primary channel; secondary devices
+ * appear shortly after, registered the same way.
+ */
+static void ata_probe_secondary_work(void* data) {
+    (void)data;
+    ata_probe_channel(1);
+    ata_register_blockdevs();
+    printk("ATA: %u drive(s) detected\n", drive_count);
+}
+
+static work_t ata_secondary_work = {
+    .func = ata_probe_secondary_work
+};
+
 /*
  * Initialize ATA driver and detect drives
  */
 void ata_init(void) {
     drive_count = 0;
     memset(drives, 0, sizeof(drives));
-    
+    memset(channels, 0, sizeof(channels));
+
+    /* Wire up channel interrupts before any command is issued */
+    irq_register_handler(ATA_IRQ_PRIMARY, ata_irq_primary);
+    irq_register_handler(ATA_IRQ_SECONDARY, ata_irq_secondary);
+    pic_enable_irq(ATA_IRQ_PRIMARY);
+    pic_enable_irq(ATA_IRQ_SECONDARY);
+
+    /* Probe the PCI IDE controller for bus master DMA */
+    ata_dma_init();
+
     printk("ATA: Detecting drives...\n");
-    
-    /* Probe primary bus */
-    ata_soft_reset(ATA_PRIMARY_CONTROL);
-    
-    /* Primary master */
-    if (ata_identify(ATA_PRIMARY_DATA, ATA_PRIMARY_CONTROL, ATA_MASTER, &drives[0])) {
-        drives[0].bus = 0;
-        drives[0].drive = 0;
-        drive_count++;
-        printk("ATA: Found %s on primary master: %s (%u MB)\n",
-               drives[0].type == ATA_TYPE_ATA ? "HDD" : "CDROM",
-               drives[0].model, drives[0].size_mb);
-    }
-    
-    /* Primary slave */
-    if (ata_identify(ATA_PRIMARY_DATA, ATA_PRIMARY_CONTROL, ATA_SLAVE, &drives[1])) {
-        drives[1].bus = 0;
-        drives[1].drive = 1;
-        drive_count++;
-        printk("ATA: Found %s on primary slave: %s (%u MB)\n",
-               drives[1].type == ATA_TYPE_ATA ? "HDD" : "CDROM",
-               drives[1].model, drives[1].size_mb);
-    }
-    
-    /* Probe secondary bus */
-    ata_soft_reset(ATA_SECONDARY_CONTROL);
-    
-    /* Secondary master */
-    if (ata_identify(ATA_SECONDARY_DATA, ATA_SECONDARY_CONTROL, ATA_MASTER, &drives[2])) {
-        drives[2].bus = 1;
-        drives[2].drive = 0;
-        drive_count++;
-        printk("ATA: Found %s on secondary master: %s (%u MB)\n",
-               drives[2].type == ATA_TYPE_ATA ? "HDD" : "CDROM",
-               drives[2].model, drives[2].size_mb);
-    }
-    
-    /* Secondary slave */
-    if (ata_identify(ATA_SECONDARY_DATA, ATA_SECONDARY_CONTROL, ATA_SLAVE, &drives[3])) {
-        drives[3].bus = 1;
-        drives[3].drive = 1;
-        drive_count++;
-        printk("ATA: Found %s on secondary slave: %s (%u MB)\n",
-               drives[3].type == ATA_TYPE_ATA ? "HDD" : "CDROM",
-               drives[3].model, drives[3].size_mb);
-    }
-    
+
+    /* Only the boot (primary) channel is probed here; the secondary
+     * channel goes to a worker so its identify timeouts never hold
+     * up the boot path */
+    ata_probe_channel(0);
+
     if (drive_count == 0) {
-        printk("ATA: No drives detected\n");
-    } else {
-        printk("ATA: %u drive(s) detected\n", drive_count);
+        printk("ATA: No drives on primary bus\n");
     }
-    
+
     /* Register block devices for detected drives */
     ata_register_blockdevs();
+
+    schedule_work(&ata_secondary_work);
 }
 
 /*
@@ -247,10 +525,10 @@ static bool ata_blockdev_read(blockdev_t* dev, uint32_t lba, uint32_t count, voi
     if (dev == NULL) return false;
     uint8_t drive_id = dev->driver_id;
     
-    /* Read in chunks of 255 sectors (max for 28-bit LBA command) */
+    /* Read in chunks of 256 sectors (max for one 28-bit LBA command) */
     uint8_t* buf = (uint8_t*)buffer;
     while (count > 0) {
-        uint8_t chunk = (count > 255) ? 255 : (uint8_t)count;
+        uint16_t chunk = (count > 256) ? 256 : (uint16_t)count;
         if (!ata_read_sectors(drive_id, lba, chunk, buf)) {
             return false;
         }
@@ -267,7 +545,7 @@ static bool ata_blockdev_write(blockdev_t* dev, uint32_t lba, uint32_t count, co
     
     const uint8_t* buf = (const uint8_t*)buffer;
     while (count > 0) {
-        uint8_t chunk = (count > 255) ? 255 : (uint8_t)count;
+        uint16_t chunk = (count > 256) ? 256 : (uint16_t)count;
         if (!ata_write_sectors(drive_id, lba, chunk, buf)) {
             return false;
         }
@@ -293,9 +571,14 @@ static const blockdev_ops_t ata_blockdev_ops = {
  * Register block devices for all detected ATA drives
  */
 void ata_register_blockdevs(void) {
+    /* Idempotent: the deferred secondary probe calls this again */
+    static bool registered[ATA_MAX_DRIVES];
+
     for (int i = 0; i < ATA_MAX_DRIVES; i++) {
         if (!drives[i].present) continue;
         if (drives[i].type != ATA_TYPE_ATA) continue;  /* Skip ATAPI for now */
+        if (registered[i]) continue;
+        registered[i] = true;
         
         char name[8];
         snprintf(name, sizeof(name), "hd%d", i);
@@ -331,39 +614,107 @@ uint8_t ata_get_drive_count(void) {
     return drive_count;
 }
 
+/*
+ * Program drive select, sector count and LBA for a 28-bit command
+ */
+static void ata_setup_lba28(ata_drive_t* drive, uint32_t lba, uint16_t count) {
+    uint16_t port = drive->base_port;
+    outb(port + 6, 0xE0 | (drive->drive << 4) | ((lba >> 24) & 0x0F));
+    outb(port + 2, (uint8_t)(count & 0xFF));
+    outb(port + 3, (uint8_t)(lba & 0xFF));
+    outb(port + 4, (uint8_t)((lba >> 8) & 0xFF));
+    outb(port + 5, (uint8_t)((lba >> 16) & 0xFF));
+}
+
+/*
+ * DMA read/write through the channel bounce buffer. Transfers are
+ * split at the bounce buffer size (128 sectors). Returns false on
+ * any controller error so the caller can retry with PIO.
+ */
+static bool ata_dma_rw(ata_drive_t* drive, uint32_t lba, uint16_t count,
+                       void* buffer, bool is_write) {
+    ata_channel_t* ch = &channels[drive->bus];
+    uint8_t* buf = (uint8_t*)buffer;
+
+    while (count > 0) {
+        uint16_t chunk = count;
+        if (chunk > ATA_DMA_BUF_SIZE / ATA_SECTOR_SIZE) {
+            chunk = ATA_DMA_BUF_SIZE / ATA_SECTOR_SIZE;
+        }
+        uint32_t bytes = (uint32_t)chunk * ATA_SECTOR_SIZE;
+
+        if (!ata_wait_ready(drive->base_port)) {
+            return false;
+        }
+
+        if (is_write) {
+            memcpy(ch->dma_buf, buf, bytes);
+        }
+
+        ata_setup_lba28(drive, lba, chunk);
+
+        if (!ata_dma_transfer(drive, ch, bytes, is_write,
+                              is_write ? ATA_CMD_WRITE_DMA : ATA_CMD_READ_DMA)) {
+            return false;
+        }
+
+        if (!is_write) {
+            memcpy(buf, ch->dma_buf, bytes);
+        }
+
+        buf += bytes;
+        lba += chunk;
+        count -= chunk;
+    }
+
+    return true;
+}
+
 /*
  * Read sectors from drive (28-bit LBA, PIO mode)
+ * One command transfers up to 256 sectors (count 256 is encoded as 0).
  */
-bool ata_read_sectors(uint8_t drive_num, uint32_t lba, uint8_t count, void* buffer) {
+bool ata_read_sectors(uint8_t drive_num, uint32_t lba, uint16_t count, void* buffer) {
     if (drive_num >= ATA_MAX_DRIVES || !drives[drive_num].present) {
         return false;
     }
+    if (count == 0 || count > 256) {
+        return false;
+    }
     
     ata_drive_t* drive = &drives[drive_num];
     uint16_t port = drive->base_port;
     uint16_t* buf = (uint16_t*)buffer;
+
+    /* Prefer DMA; on any controller error retry with PIO below */
+    if (channels[drive->bus].bm_base != 0 &&
+        ata_dma_rw(drive, lba, count, buffer, false)) {
+        return true;
+    }
     
     /* Wait for drive ready */
     if (!ata_wait_ready(port)) {
         return false;
     }
     
-    /* Select drive and set LBA mode */
-    outb(port + 6, 0xE0 | (drive->drive << 4) | ((lba >> 24) & 0x0F));
-    
-    /* Set sector count and LBA */
-    outb(port + 2, count);
-    outb(port + 3, (uint8_t)(lba & 0xFF));
-    outb(port + 4, (uint8_t)((lba >> 8) & 0xFF));
-    outb(port + 5, (uint8_t)((lba >> 16) & 0xFF));
+    /* Select drive and set LBA mode, sector count and LBA */
+    ata_setup_lba28(drive, lba, count);
     
     /* Send read command */
+    channels[drive->bus].irq_pending = 0;
     outb(port + 7, ATA_CMD_READ_PIO);
     
-    /* Read sectors */
+    /* Read sectors; each DRQ-full sector raises one interrupt */
     for (int s = 0; s < count; s++) {
-        /* Wait for DRQ */
-        if (!ata_wait_drq(port)) {
+        if (!ata_wait_irq(drive->bus, port)) {
+            return false;
+        }
+
+        uint8_t status = inb(port + 7);
+        if (status & ATA_STATUS_ERR) {
+            return false;
+        }
+        if (!(status & ATA_STATUS_DRQ) && !ata_wait_drq(port)) {
             return false;
         }
         
@@ -378,38 +729,56 @@ bool ata_read_sectors(uint8_t drive_num, uint32_t lba, uint8_t count, void* buff
 
 /*
  * Write sectors to drive (28-bit LBA, PIO mode)
+ * One command transfers up to 256 sectors (count 256 is encoded as 0).
  */
-bool ata_write_sectors(uint8_t drive_num, uint32_t lba, uint8_t count, const void* buffer) {
+bool ata_write_sectors(uint8_t drive_num, uint32_t lba, uint16_t count, const void* buffer) {
     if (drive_num >= ATA_MAX_DRIVES || !drives[drive_num].present) {
         return false;
     }
+    if (count == 0 || count > 256) {
+        return false;
+    }
     
     ata_drive_t* drive = &drives[drive_num];
     uint16_t port = drive->base_port;
     const uint16_t* buf = (const uint16_t*)buffer;
+
+    /* Prefer DMA; on any controller error retry with PIO below */
+    if (channels[drive->bus].bm_base != 0 &&
+        ata_dma_rw(drive, lba, count, (void*)buffer, true)) {
+        return true;
+    }
     
     /* Wait for drive ready */
     if (!ata_wait_ready(port)) {
         return false;
     }
     
-    /* Select drive and set LBA mode */
-    outb(port + 6, 0xE0 | (drive->drive << 4) | ((lba >> 24) & 0x0F));
+    /* Select drive and set LBA mode, sector count and LBA */
+    ata_setup_lba28(drive, lba, count);
     
-    /* Set sector count and LBA */
-    outb(port + 2, count);
-    outb(port + 3, (uint8_t)(lba & 0xFF));
-    outb(port + 4, (uint8_t)((lba >> 8) & 0xFF));
-    outb(port + 5, (uint8_t)((lba >> 16) & 0xFF));
-    
-    /* Send write command */
+    /* Send write command; the drive asserts DRQ for the first sector
+     * without raising an interrupt */
+    channels[drive->bus].irq_pending = 0;
     outb(port + 7, ATA_CMD_WRITE_PIO);
     
-    /* Write sectors */
+    /* Write sectors; the interrupt comes after each sector is taken */
     for (int s = 0; s < count; s++) {
-        /* Wait for DRQ */
-        if (!ata_wait_drq(port)) {
-            return false;
+        if (s == 0) {
+            if (!ata_wait_drq(port)) {
+                return false;
+            }
+        } else {
+            if (!ata_wait_irq(drive->bus, port)) {
+                return false;
+            }
+            uint8_t status = inb(port + 7);
+            if (status & ATA_STATUS_ERR) {
+                return false;
+            }
+            if (!(status & ATA_STATUS_DRQ) && !ata_wait_drq(port)) {
+                return false;
+            }
         }
         
         /* Write 256 words (512 bytes) */
@@ -418,7 +787,10 @@ bool ata_write_sectors(uint8_t drive_num, uint32_t lba, uint8_t count, const voi
         }
     }
     
-    /* Wait for drive to finish processing */
+    /* Final interrupt signals command completion */
+    if (!ata_wait_irq(drive->bus, port)) {
+        return false;
+    }
     if (!ata_wait_ready(port)) {
         return false;
     }
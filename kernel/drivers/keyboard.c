@@ -14,14 +14,31 @@
 #include "../include/vga.h"
 #include "../include/signal.h"
 #include "../include/process.h"
+#include "../include/scheduler.h"
 #include "../include/stdio.h"
 
-/* Keyboard buffer */
-#define KEYBOARD_BUFFER_SIZE 256
-static char keyboard_buffer[KEYBOARD_BUFFER_SIZE];
-static uint16_t keyboard_mods_buffer[KEYBOARD_BUFFER_SIZE];  /* Modifier state at time of keypress */
-static volatile size_t buffer_head = 0;
-static volatile size_t buffer_tail = 0;
+/*
+ * Key event ring: single producer (IRQ1 handler) / single consumer.
+ * head and tail are free-running counters masked on access; only the
+ * producer writes head and only the consumer writes tail, so neither
+ * side needs cli/sti. A typed record keeps the character and its
+ * modifier snapshot together instead of in parallel arrays.
+ */
+#define KEYBOARD_BUFFER_SIZE 256    /* Must be a power of two */
+#define KEYBOARD_BUFFER_MASK (KEYBOARD_BUFFER_SIZE - 1)
+
+typedef struct {
+    char ch;            /* Translated character */
+    uint16_t mods;      /* Modifier state at time of keypress */
+} key_event_t;
+
+static key_event_t keyboard_buffer[KEYBOARD_BUFFER_SIZE];
+static volatile uint32_t buffer_head = 0;   /* Written by IRQ only */
+static volatile uint32_t buffer_tail = 0;   /* Written by readers only */
+
+/* IRQ statistics for the interrupts builtin */
+static uint32_t keyboard_irqs = 0;
+static uint32_t keyboard_overruns = 0;      /* Keys dropped, ring full */
 
 /* Modifier key state */
 static uint16_t modifier_state = 0;
@@ -32,6 +49,9 @@ static uint16_t last_key_modifiers = 0;
 /* Callback function */
 static keyboard_callback_t key_callback = NULL;
 
+/* Processes blocked waiting for a key */
+static wait_queue_t keyboard_wait;
+
 /* US keyboard scancode to ASCII (lowercase) */
 static const char scancode_to_ascii[128] = {
     0, 27, '1', '2', '3', '4', '5', '6', '7', '8', '9', '0', '-', '=', '\b',
@@ -101,12 +121,21 @@ static bool extended_scancode = false;
  * Add character to keyboard buffer with current modifier state
  */
 static void buffer_put(char c) {
-    size_t next = (buffer_head + 1) % KEYBOARD_BUFFER_SIZE;
-    if (next != buffer_tail) {
-        keyboard_buffer[buffer_head] = c;
-        keyboard_mods_buffer[buffer_head] = modifier_state;  /* Capture modifier state */
-        buffer_head = next;
+    if (buffer_head - buffer_tail >= KEYBOARD_BUFFER_SIZE) {
+        keyboard_overruns++;
+        return;  /* Ring full: drop and count */
     }
+
+    key_event_t* ev = &keyboard_buffer[buffer_head & KEYBOARD_BUFFER_MASK];
+    ev->ch = c;
+    ev->mods = modifier_state;  /* Capture modifier state */
+
+    /* Publish the slot only after the record is complete */
+    __asm__ volatile("" ::: "memory");
+    buffer_head++;
+
+    /* Wake processes blocked in keyboard_getchar() */
+    wake_up(&keyboard_wait);
 }
 
 /*
@@ -115,6 +144,7 @@ static void buffer_put(char c) {
 static void keyboard_handler(registers_t* regs) {
     (void)regs;  /* Unused */
 
+    keyboard_irqs++;
     uint8_t scancode = inb(KEYBOARD_DATA_PORT);
 
     /* Handle extended scancode prefix */
@@ -271,6 +301,7 @@ void keyboard_init(void) {
     modifier_state = 0;
     extended_scancode = false;
     key_callback = NULL;
+    wait_queue_init(&keyboard_wait);
 
     /* Register IRQ1 handler */
     irq_register_handler(1, keyboard_handler);
@@ -285,9 +316,13 @@ bool keyboard_has_key(void) {
 
 char keyboard_getchar_nonblock(void) {
     if (buffer_head == buffer_tail) return 0;
-    char c = keyboard_buffer[buffer_tail];
-    last_key_modifiers = keyboard_mods_buffer[buffer_tail];  /* Capture modifiers from when key was pressed */
-    buffer_tail = (buffer_tail + 1) % KEYBOARD_BUFFER_SIZE;
+    key_event_t* ev = &keyboard_buffer[buffer_tail & KEYBOARD_BUFFER_MASK];
+    char c = ev->ch;
+    last_key_modifiers = ev->mods;  /* Capture modifiers from when key was pressed */
+
+    /* Release the slot only after the record has been read */
+    __asm__ volatile("" ::: "memory");
+    buffer_tail++;
     return c;
 }
 
@@ -296,8 +331,13 @@ char keyboard_getchar(void) {
     __asm__ volatile("sti");
 
     while (!keyboard_has_key()) {
-        /* Busy wait - less efficient but more reliable for debugging */
-        __asm__ volatile("pause");  /* CPU hint for spin-wait loops */
+        if (scheduler_running() && current_process != NULL) {
+            /* Sleep until the IRQ handler buffers a key */
+            sleep_on(&keyboard_wait);
+        } else {
+            /* Pre-scheduler fallback: spin */
+            __asm__ volatile("pause");  /* CPU hint for spin-wait loops */
+        }
     }
     return keyboard_getchar_nonblock();
 }
@@ -310,3 +350,11 @@ uint16_t keyboard_get_modifiers(void) {
     return last_key_modifiers;  /* Return modifiers from when last key was pressed */
 }
 
+uint32_t keyboard_irq_count(void) {
+    return keyboard_irqs;
+}
+
+uint32_t keyboard_overrun_count(void) {
+    return keyboard_overruns;
+}
+
@@ -9,8 +9,11 @@
 #include "../include/io.h"
 #include "../include/isr.h"
 #include "../include/pic.h"
+#include "../include/process.h"
+#include "../include/scheduler.h"
 #include "../include/stdio.h"
 #include "../include/serial.h"
+#include "../include/softirq.h"
 
 /* PS/2 controller ports */
 #define PS2_DATA_PORT       0x60
@@ -55,6 +58,9 @@ static int screen_max_y = 600;
 static uint8_t mouse_packet[3];
 static int packet_index = 0;
 
+/* Processes blocked waiting for a mouse event */
+static wait_queue_t mouse_wait;
+
 /*
  * Wait for PS/2 controller input buffer to be empty
  */
@@ -174,43 +180,75 @@ static void mouse_process_packet(void) {
         mouse_state.moved = true;
     }
     
-    /* Call callback if registered */
-    if (mouse_callback && (mouse_state.moved || mouse_state.button_changed)) {
-        mouse_callback(&mouse_state);
+    if (mouse_state.moved || mouse_state.button_changed) {
+        /* Call callback if registered */
+        if (mouse_callback) {
+            mouse_callback(&mouse_state);
+        }
+        /* Wake processes blocked in mouse_wait_event() */
+        wake_up(&mouse_wait);
     }
 }
 
 /* Debug counter for IRQ12 */
 static volatile uint32_t irq12_count = 0;
 
+/* Raw bytes captured by the top half, drained by the bottom half.
+ * Single producer (IRQ12), single consumer (softirq) - no locking. */
+#define MOUSE_RING_SIZE 32
+static volatile uint8_t mouse_ring[MOUSE_RING_SIZE];
+static volatile uint8_t ring_head = 0;
+static volatile uint8_t ring_tail = 0;
+
 /*
- * Mouse interrupt handler (IRQ12)
+ * Mouse interrupt handler (IRQ12) - top half. Just pulls the byte off
+ * the controller and stashes it; packet assembly, callbacks, and
+ * wakeups run in the bottom half with interrupts enabled.
  */
 static void mouse_handler(registers_t* regs) {
     (void)regs;
-    
+
     irq12_count++;
-    
+
     uint8_t status = inb(PS2_STATUS_PORT);
-    
+
     /* Check if this is mouse data */
     if (!(status & PS2_STATUS_OUTPUT_FULL)) {
         return;
     }
-    
+
     uint8_t data = inb(PS2_DATA_PORT);
-    
-    /* Synchronization: first byte always has bit 3 set */
-    if (packet_index == 0 && !(data & 0x08)) {
-        /* Out of sync - discard and wait for valid first byte */
-        return;
+
+    uint8_t next = (uint8_t)((ring_head + 1) & (MOUSE_RING_SIZE - 1));
+    if (next != ring_tail) {
+        mouse_ring[ring_head] = data;
+        ring_head = next;
     }
-    
-    mouse_packet[packet_index++] = data;
-    
-    if (packet_index >= 3) {
-        mouse_process_packet();
-        packet_index = 0;
+    /* Ring full: drop the byte; resync logic recovers the stream */
+
+    softirq_raise(SOFTIRQ_MOUSE);
+}
+
+/*
+ * Bottom half: assemble packets from the captured bytes
+ */
+static void mouse_softirq(void) {
+    while (ring_tail != ring_head) {
+        uint8_t data = mouse_ring[ring_tail];
+        ring_tail = (uint8_t)((ring_tail + 1) & (MOUSE_RING_SIZE - 1));
+
+        /* Synchronization: first byte always has bit 3 set */
+        if (packet_index == 0 && !(data & 0x08)) {
+            /* Out of sync - discard and wait for valid first byte */
+            continue;
+        }
+
+        mouse_packet[packet_index++] = data;
+
+        if (packet_index >= 3) {
+            mouse_process_packet();
+            packet_index = 0;
+        }
     }
 }
 
@@ -232,12 +270,13 @@ int mouse_init(void) {
     mouse_state.dy = 0;
     mouse_state.moved = false;
     mouse_state.button_changed = false;
-    
+
     packet_index = 0;
+    wait_queue_init(&mouse_wait);
     
     /* Disable interrupts during PS/2 controller configuration to prevent
      * the keyboard ISR from reading the config byte off port 0x60 */
-    __asm__ volatile("cli");
+    uint32_t eflags = irq_save();
 
     /* Drain any stale data from the PS/2 output buffer */
     while (inb(PS2_STATUS_PORT) & PS2_STATUS_OUTPUT_FULL) {
@@ -261,7 +300,7 @@ int mouse_init(void) {
     ps2_wait_write();
     outb(PS2_DATA_PORT, config);
 
-    __asm__ volatile("sti");
+    irq_restore(eflags);
     
     /* Reset the mouse */
     if (!mouse_command(MOUSE_CMD_RESET)) {
@@ -291,7 +330,9 @@ int mouse_init(void) {
         return -1;
     }
     
-    /* Register IRQ12 handler (IRQ 12, not interrupt 44) */
+    /* Register IRQ12 handler (IRQ 12, not interrupt 44) and the
+     * bottom half that does the actual packet assembly */
+    softirq_register(SOFTIRQ_MOUSE, mouse_softirq);
     irq_register_handler(12, mouse_handler);
     
     /* Enable IRQ12 in PIC */
@@ -325,6 +366,21 @@ mouse_state_t* mouse_get_state(void) {
     return &mouse_state;
 }
 
+/*
+ * Block until the next mouse movement or button change. Consumers
+ * that would otherwise poll mouse_get_state() in a loop can sleep
+ * here instead; returns immediately before the scheduler runs.
+ */
+void mouse_wait_event(void) {
+    if (!mouse_initialized || !scheduler_running() || current_process == NULL) {
+        return;
+    }
+    if (mouse_state.moved || mouse_state.button_changed) {
+        return;  /* Event already pending */
+    }
+    sleep_on(&mouse_wait);
+}
+
 /*
  * Get current mouse position
  */
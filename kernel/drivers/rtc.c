@@ -9,6 +9,7 @@
 #include "../include/io.h"
 #include "../include/serial.h"
 #include "../include/stdio.h"
+#include "../include/timer.h"
 
 /* CMOS I/O ports */
 #define CMOS_ADDR  0x70
@@ -47,22 +48,46 @@ static uint8_t bcd_to_bin(uint8_t bcd) {
     return ((bcd >> 4) * 10) + (bcd & 0x0F);
 }
 
+/* Days in each month (non-leap) */
+static const uint8_t days_in_month[] = {
+    0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
+};
+
+static bool is_leap_year(int y) {
+    return (y % 4 == 0 && y % 100 != 0) || (y % 400 == 0);
+}
+
+static uint8_t month_days(int month, int year) {
+    if (month == 2 && is_leap_year(year)) return 29;
+    if (month >= 1 && month <= 12) return days_in_month[month];
+    return 30;
+}
+
 /*
- * Initialize the RTC driver
+ * 64-by-32 divide via shift-subtract; the kernel links without
+ * libgcc and must not emit __udivdi3 (same helper as timer.c).
  */
-void rtc_init(void) {
-    rtc_time_t t;
-    rtc_read_time(&t);
-    printk("RTC: %04d-%02d-%02d %02d:%02d:%02d\n",
-           t.year, t.month, t.day, t.hours, t.minutes, t.seconds);
+static uint32_t udiv64_32(uint64_t dividend, uint32_t divisor) {
+    uint64_t rem = 0;
+    uint32_t quot = 0;
+    for (int bit = 63; bit >= 0; bit--) {
+        rem = (rem << 1) | ((dividend >> bit) & 1);
+        if (rem >= divisor) {
+            rem -= divisor;
+            if (bit < 32) {
+                quot |= 1u << bit;
+            }
+        }
+    }
+    return quot;
 }
 
 /*
- * Read the current time from the CMOS RTC.
+ * Read the current time from the CMOS hardware.
  * Reads twice and compares to avoid getting inconsistent data
  * during an RTC update cycle.
  */
-void rtc_read_time(rtc_time_t* time) {
+static void rtc_read_hw(rtc_time_t* time) {
     uint8_t sec, min, hr, day, mon, yr;
     uint8_t sec2, min2, hr2, day2, mon2, yr2;
     uint8_t status_b;
@@ -120,6 +145,86 @@ void rtc_read_time(rtc_time_t* time) {
     time->year    = 2000 + yr;  /* CMOS year is 0-99, assume 2000s */
 }
 
+/*
+ * Cached time base. The CMOS is read once at boot (and on resync);
+ * every rtc_read_time() after that derives the current time from the
+ * monotonic timer, so timestamp generation is arithmetic instead of
+ * a dozen ISA port accesses. The base is re-read from hardware once
+ * an hour to keep tick drift bounded.
+ */
+#define RTC_RESYNC_SECONDS 3600
+
+static rtc_time_t rtc_base;
+static uint64_t rtc_base_us = 0;
+static bool rtc_base_valid = false;
+
+/*
+ * Advance a time by a number of seconds (handles day/month rollover)
+ */
+static void rtc_advance(rtc_time_t* t, uint32_t secs) {
+    uint32_t day_secs = (uint32_t)t->hours * 3600 +
+                        (uint32_t)t->minutes * 60 + t->seconds + secs;
+    uint32_t days = day_secs / 86400;
+    day_secs %= 86400;
+
+    t->hours   = (uint8_t)(day_secs / 3600);
+    t->minutes = (uint8_t)((day_secs % 3600) / 60);
+    t->seconds = (uint8_t)(day_secs % 60);
+
+    int d = t->day;
+    int m = t->month;
+    int y = t->year;
+    d += (int)days;
+    while (d > month_days(m, y)) {
+        d -= month_days(m, y);
+        m++;
+        if (m > 12) { m = 1; y++; }
+    }
+    t->day   = (uint8_t)d;
+    t->month = (uint8_t)m;
+    t->year  = (uint16_t)y;
+}
+
+/*
+ * Re-read the hardware clock and reset the cached base
+ */
+void rtc_resync(void) {
+    rtc_read_hw(&rtc_base);
+    rtc_base_us = timer_us();
+    rtc_base_valid = true;
+}
+
+/*
+ * Current time: cached base plus elapsed timer seconds
+ */
+void rtc_read_time(rtc_time_t* time) {
+    if (!rtc_base_valid) {
+        rtc_resync();
+    }
+
+    uint32_t elapsed = udiv64_32(timer_us() - rtc_base_us, 1000000);
+    if (elapsed >= RTC_RESYNC_SECONDS) {
+        rtc_resync();
+        elapsed = 0;
+    }
+
+    *time = rtc_base;
+    if (elapsed > 0) {
+        rtc_advance(time, elapsed);
+    }
+}
+
+/*
+ * Initialize the RTC driver
+ */
+void rtc_init(void) {
+    rtc_time_t t;
+    rtc_resync();
+    rtc_read_time(&t);
+    printk("RTC: %04d-%02d-%02d %02d:%02d:%02d\n",
+           t.year, t.month, t.day, t.hours, t.minutes, t.seconds);
+}
+
 /* Timezone offset in minutes from UTC (default 0 = UTC) */
 static int tz_offset_minutes = 0;
 
@@ -142,21 +247,6 @@ int rtc_get_manual_offset(void) {
     return manual_offset_seconds;
 }
 
-/* Days in each month (non-leap) */
-static const uint8_t days_in_month[] = {
-    0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
-};
-
-static bool is_leap_year(int y) {
-    return (y % 4 == 0 && y % 100 != 0) || (y % 400 == 0);
-}
-
-static uint8_t month_days(int month, int year) {
-    if (month == 2 && is_leap_year(year)) return 29;
-    if (month >= 1 && month <= 12) return days_in_month[month];
-    return 30;
-}
-
 /*
  * Read the adjusted time (RTC + timezone + manual offset)
  */
@@ -0,0 +1,303 @@
+/*
+ * MiniOS RTL8139 Network Driver
+ *
+ * DMA-driven driver for the Realtek RTL8139. Transmit is zero-copy:
+ * the four hardware transmit slots are pointed straight at the pbuf
+ * the protocol stack built (kernel heap is identity mapped, so the
+ * buffer address is its DMA address), and the pbuf reference is held
+ * until the card reports the slot done. Receive uses the chip's
+ * single ring buffer, which the hardware fills by bus-master DMA;
+ * frames are copied out of the ring into fresh pbufs in the IRQ
+ * handler — the one copy this NIC design forces — and handed to
+ * net_rx(), after which no further copies happen up the stack.
+ *
+ * PCI configuration access is the same two-port mechanism ata.c uses
+ * for its bus master setup.
+ */
+
+#include "../include/rtl8139.h"
+#include "../include/net.h"
+#include "../include/pbuf.h"
+#include "../include/io.h"
+#include "../include/isr.h"
+#include "../include/pmm.h"
+#include "../include/string.h"
+#include "../include/stdio.h"
+#include "../include/spinlock.h"
+
+/* PCI configuration space access */
+#define PCI_CONFIG_ADDRESS  0xCF8
+#define PCI_CONFIG_DATA     0xCFC
+
+#define RTL_VENDOR_ID       0x10EC
+#define RTL_DEVICE_ID       0x8139
+
+/* Register offsets from the I/O base (BAR0) */
+#define RTL_REG_IDR0        0x00    /* MAC address (6 bytes) */
+#define RTL_REG_TSD0        0x10    /* Transmit status, 4 slots */
+#define RTL_REG_TSAD0       0x20    /* Transmit buffer address, 4 slots */
+#define RTL_REG_RBSTART     0x30    /* Receive ring physical base */
+#define RTL_REG_CMD         0x37
+#define RTL_REG_CAPR        0x38    /* Current address of packet read */
+#define RTL_REG_IMR         0x3C
+#define RTL_REG_ISR         0x3E
+#define RTL_REG_TCR         0x40
+#define RTL_REG_RCR         0x44
+#define RTL_REG_CONFIG1     0x52
+
+/* CMD bits */
+#define RTL_CMD_BUFE        0x01    /* Receive buffer empty */
+#define RTL_CMD_TX_ENABLE   0x04
+#define RTL_CMD_RX_ENABLE   0x08
+#define RTL_CMD_RESET       0x10
+
+/* ISR/IMR bits */
+#define RTL_INT_ROK         0x0001  /* Receive OK */
+#define RTL_INT_RER         0x0002  /* Receive error */
+#define RTL_INT_TOK         0x0004  /* Transmit OK */
+#define RTL_INT_TER         0x0008  /* Transmit error */
+#define RTL_INT_RXOVW       0x0010  /* Ring overflow */
+
+/* TSD bits (per transmit slot) */
+#define RTL_TSD_OWN         0x2000  /* DMA to the FIFO complete */
+#define RTL_TSD_TOK         0x8000  /* Frame left the wire */
+
+/* RCR: accept broadcast/multicast/physical-match/all-phys, WRAP so
+ * frames at the end of the ring continue linearly past it */
+#define RTL_RCR_CONFIG      (0x0F | (1 << 7))
+
+/*
+ * Ring size: 8192 bytes (RBLEN=00) + 16 bytes of header slack. WRAP
+ * mode can overrun the end by up to one full frame, so allocate an
+ * extra 1500 bytes; three PMM frames cover all of it.
+ */
+#define RTL_RX_RING_SIZE    8192
+#define RTL_RX_ALLOC_FRAMES 3
+
+#define RTL_TX_SLOTS        4
+
+/* Minimum ethernet frame the chip will not pad for us */
+#define RTL_TX_MIN_LEN      60
+
+/* Driver state */
+static struct {
+    uint16_t io_base;
+    uint8_t irq;
+    uint8_t* rx_ring;               /* Identity mapped = physical */
+    uint32_t rx_offset;             /* Read cursor into the ring */
+    pbuf_t* tx_pbuf[RTL_TX_SLOTS];  /* Buffer owned by each slot */
+    uint32_t tx_next;               /* Next slot to use */
+    netdev_t dev;
+} rtl;
+
+/*
+ * Read a 32-bit PCI configuration register
+ */
+static uint32_t pci_config_read(uint8_t bus, uint8_t slot, uint8_t func, uint8_t offset) {
+    uint32_t address = 0x80000000 |
+                       ((uint32_t)bus << 16) |
+                       ((uint32_t)slot << 11) |
+                       ((uint32_t)func << 8) |
+                       (offset & 0xFC);
+    outl(PCI_CONFIG_ADDRESS, address);
+    return inl(PCI_CONFIG_DATA);
+}
+
+static void pci_config_write(uint8_t bus, uint8_t slot, uint8_t func, uint8_t offset, uint32_t value) {
+    uint32_t address = 0x80000000 |
+                       ((uint32_t)bus << 16) |
+                       ((uint32_t)slot << 11) |
+                       ((uint32_t)func << 8) |
+                       (offset & 0xFC);
+    outl(PCI_CONFIG_ADDRESS, address);
+    outl(PCI_CONFIG_DATA, value);
+}
+
+/*
+ * Release pbufs whose transmit DMA has completed. Called with
+ * interrupts disabled (IRQ handler or the cli section in transmit).
+ */
+static void rtl_tx_reap(void) {
+    for (int i = 0; i < RTL_TX_SLOTS; i++) {
+        if (rtl.tx_pbuf[i] == NULL) {
+            continue;
+        }
+        uint32_t tsd = inl(rtl.io_base + RTL_REG_TSD0 + i * 4);
+        if (tsd & (RTL_TSD_TOK | RTL_TSD_OWN)) {
+            pbuf_free(rtl.tx_pbuf[i]);
+            rtl.tx_pbuf[i] = NULL;
+        }
+    }
+}
+
+/*
+ * Transmit one frame. Takes ownership of the caller's pbuf reference;
+ * the buffer itself becomes the DMA source, no staging copy. Returns
+ * false (caller keeps/frees the pbuf) when all four slots are busy.
+ */
+static bool rtl_transmit(netdev_t* dev, pbuf_t* p) {
+    (void)dev;
+
+    if (p->len > PBUF_MAX_DATA) {
+        return false;
+    }
+
+    /* Short frames must be padded to the ethernet minimum; the pbuf
+     * payload area always has room for 60 bytes */
+    uint32_t len = p->len;
+    if (len < RTL_TX_MIN_LEN) {
+        memset(p->data + len, 0, RTL_TX_MIN_LEN - len);
+        len = RTL_TX_MIN_LEN;
+    }
+
+    uint32_t flags = irq_save();
+    rtl_tx_reap();
+
+    uint32_t slot = rtl.tx_next;
+    if (rtl.tx_pbuf[slot] != NULL) {
+        /* All descriptors in flight */
+        irq_restore(flags);
+        return false;
+    }
+
+    rtl.tx_pbuf[slot] = p;
+    rtl.tx_next = (slot + 1) % RTL_TX_SLOTS;
+
+    /* Point the slot at the pbuf and start the DMA (writing the
+     * length with OWN clear kicks the transfer) */
+    outl(rtl.io_base + RTL_REG_TSAD0 + slot * 4, (uint32_t)p->data);
+    outl(rtl.io_base + RTL_REG_TSD0 + slot * 4, len);
+
+    irq_restore(flags);
+    return true;
+}
+
+/*
+ * Drain the receive ring. Each packet is prefixed by a 4-byte header
+ * the chip writes: status word, then length including the CRC.
+ */
+static void rtl_rx_drain(void) {
+    while (!(inb(rtl.io_base + RTL_REG_CMD) & RTL_CMD_BUFE)) {
+        uint8_t* slot = rtl.rx_ring + rtl.rx_offset;
+        uint16_t status = (uint16_t)(slot[0] | (slot[1] << 8));
+        uint16_t total = (uint16_t)(slot[2] | (slot[3] << 8));
+
+        if (!(status & 0x01) || total < 8 || total > PBUF_MAX_DATA + 4) {
+            /* Bad packet or corrupt header: reset the ring pointers */
+            outb(rtl.io_base + RTL_REG_CMD, RTL_CMD_TX_ENABLE);
+            outb(rtl.io_base + RTL_REG_CMD,
+                 RTL_CMD_TX_ENABLE | RTL_CMD_RX_ENABLE);
+            rtl.rx_offset = 0;
+            outw(rtl.io_base + RTL_REG_CAPR, (uint16_t)-16);
+            return;
+        }
+
+        uint16_t frame_len = total - 4;     /* Strip trailing CRC */
+        pbuf_t* p = pbuf_alloc(frame_len);
+        if (p != NULL) {
+            /* The ring copy: WRAP mode keeps frames linear, so one
+             * memcpy lifts the frame out of DMA memory */
+            memcpy(p->data, slot + 4, frame_len);
+            net_rx(&rtl.dev, p);
+        }
+        /* Out of pbufs: the frame is dropped, the ring still advances */
+
+        /* Packets are dword aligned in the ring; CAPR trails the read
+         * pointer by 16 bytes per the datasheet */
+        rtl.rx_offset = (rtl.rx_offset + total + 4 + 3) & ~3u;
+        rtl.rx_offset %= RTL_RX_RING_SIZE;
+        outw(rtl.io_base + RTL_REG_CAPR, (uint16_t)(rtl.rx_offset - 16));
+    }
+}
+
+/*
+ * Interrupt handler: acknowledge, reap finished transmits, drain
+ * received frames into the stack.
+ */
+static void rtl_irq_handler(registers_t* regs) {
+    (void)regs;
+
+    uint16_t isr = inw(rtl.io_base + RTL_REG_ISR);
+    if (isr == 0) {
+        return;
+    }
+    /* Writing the bits back clears them */
+    outw(rtl.io_base + RTL_REG_ISR, isr);
+
+    if (isr & (RTL_INT_TOK | RTL_INT_TER)) {
+        rtl_tx_reap();
+    }
+    if (isr & (RTL_INT_ROK | RTL_INT_RER | RTL_INT_RXOVW)) {
+        rtl_rx_drain();
+    }
+}
+
+void rtl8139_init(void) {
+    /* Find the card on bus 0 */
+    int found_slot = -1;
+    for (uint8_t slot = 0; slot < 32; slot++) {
+        uint32_t id = pci_config_read(0, slot, 0, 0x00);
+        if ((id & 0xFFFF) == RTL_VENDOR_ID &&
+            (id >> 16) == RTL_DEVICE_ID) {
+            found_slot = slot;
+            break;
+        }
+    }
+    if (found_slot < 0) {
+        return;
+    }
+
+    uint32_t bar0 = pci_config_read(0, (uint8_t)found_slot, 0, 0x10);
+    if (!(bar0 & 1)) {
+        printk("RTL8139: BAR0 is not I/O space, skipping\n");
+        return;
+    }
+    rtl.io_base = (uint16_t)(bar0 & 0xFFFC);
+    rtl.irq = (uint8_t)(pci_config_read(0, (uint8_t)found_slot, 0, 0x3C) & 0xFF);
+
+    /* Enable I/O decode and bus mastering */
+    uint32_t cmd = pci_config_read(0, (uint8_t)found_slot, 0, 0x04);
+    pci_config_write(0, (uint8_t)found_slot, 0, 0x04, cmd | 0x05);
+
+    /* Power on (LWAKE + LWPTN low), then soft reset */
+    outb(rtl.io_base + RTL_REG_CONFIG1, 0x00);
+    outb(rtl.io_base + RTL_REG_CMD, RTL_CMD_RESET);
+    for (int i = 0; i < 100000; i++) {
+        if (!(inb(rtl.io_base + RTL_REG_CMD) & RTL_CMD_RESET)) {
+            break;
+        }
+    }
+
+    /* Receive ring: physically contiguous PMM frames, identity mapped */
+    uint32_t ring_phys = pmm_alloc_frames(RTL_RX_ALLOC_FRAMES);
+    if (ring_phys == 0) {
+        printk("RTL8139: receive ring allocation failed\n");
+        return;
+    }
+    rtl.rx_ring = (uint8_t*)ring_phys;
+    rtl.rx_offset = 0;
+    outl(rtl.io_base + RTL_REG_RBSTART, ring_phys);
+
+    /* Interrupt on receive/transmit completion and errors */
+    outw(rtl.io_base + RTL_REG_IMR,
+         RTL_INT_ROK | RTL_INT_RER | RTL_INT_TOK | RTL_INT_TER |
+         RTL_INT_RXOVW);
+
+    outl(rtl.io_base + RTL_REG_RCR, RTL_RCR_CONFIG);
+    outb(rtl.io_base + RTL_REG_CMD, RTL_CMD_TX_ENABLE | RTL_CMD_RX_ENABLE);
+
+    /* Read the burned-in MAC and register with the stack */
+    for (int i = 0; i < ETH_ALEN; i++) {
+        rtl.dev.mac[i] = inb(rtl.io_base + RTL_REG_IDR0 + i);
+    }
+    rtl.dev.name = "rtl8139";
+    rtl.dev.impl = &rtl;
+    rtl.dev.transmit = rtl_transmit;
+
+    irq_register_handler(rtl.irq, rtl_irq_handler);
+    netdev_register(&rtl.dev);
+
+    printk("RTL8139: I/O 0x%04X IRQ %u, ring %u KB at 0x%08X\n",
+           rtl.io_base, rtl.irq,
+           (RTL_RX_ALLOC_FRAMES * 4096) / 1024, ring_phys);
+}
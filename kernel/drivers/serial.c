@@ -1,31 +1,157 @@
 #include "../include/serial.h"
 #include "../include/io.h"
+#include "../include/isr.h"
+#include "../include/pic.h"
 
 #define COM1_PORT 0x3F8
 
+/* UART registers (offsets from COM1_PORT) */
+#define UART_DATA   0   /* RX/TX data (DLAB=0) */
+#define UART_IER    1   /* Interrupt enable */
+#define UART_IIR    2   /* Interrupt identification (read) / FIFO ctl (write) */
+#define UART_LCR    3   /* Line control */
+#define UART_MCR    4   /* Modem control */
+#define UART_LSR    5   /* Line status */
+
+/* Interrupt enable bits */
+#define UART_IER_RDA    0x01    /* Received data available */
+#define UART_IER_THRE   0x02    /* Transmit holding register empty */
+
+/* Line status bits */
+#define UART_LSR_DR     0x01    /* Data ready */
+#define UART_LSR_THRE   0x20    /* Transmit holding register empty */
+
+/* 16550 TX FIFO depth: bytes we may write per THRE interrupt */
+#define UART_FIFO_DEPTH 16
+
+/*
+ * Transmit ring: printk paths enqueue here and return immediately;
+ * the IRQ4 handler drains a FIFO's worth per THRE interrupt. Sized
+ * for a burst of log lines without forcing the writer to spin.
+ */
+#define SERIAL_TX_BUFFER_SIZE 1024
+#define SERIAL_RX_BUFFER_SIZE 256
+
+static char tx_buffer[SERIAL_TX_BUFFER_SIZE];
+static volatile size_t tx_head = 0;     /* Next free slot (writer) */
+static volatile size_t tx_tail = 0;     /* Next byte to send (IRQ) */
+
+static char rx_buffer[SERIAL_RX_BUFFER_SIZE];
+static volatile size_t rx_head = 0;
+static volatile size_t rx_tail = 0;
+
+/* Set once IRQ4 is wired up; before that every write spins */
+static bool irq_mode = false;
+
 static int serial_transmit_empty(void) {
-    return (inb(COM1_PORT + 5) & 0x20) != 0;
+    return (inb(COM1_PORT + UART_LSR) & UART_LSR_THRE) != 0;
+}
+
+/* Spin-transmit one byte (pre-IRQ boot path and overflow fallback) */
+static void serial_putc_sync(char c) {
+    while (!serial_transmit_empty()) {
+        /* spin */
+    }
+    outb(COM1_PORT, (uint8_t)c);
+}
+
+/* Feed the UART FIFO from the TX ring; call with the THR empty */
+static void tx_fill_fifo(void) {
+    for (int i = 0; i < UART_FIFO_DEPTH && tx_tail != tx_head; i++) {
+        outb(COM1_PORT, (uint8_t)tx_buffer[tx_tail]);
+        tx_tail = (tx_tail + 1) % SERIAL_TX_BUFFER_SIZE;
+    }
+}
+
+/*
+ * IRQ4 handler: refill the TX FIFO on THRE, buffer incoming bytes
+ * on RDA. Reading IIR/LSR acknowledges the UART side; the PIC EOI
+ * is sent by the common IRQ dispatcher.
+ */
+static void serial_handler(registers_t* regs) {
+    (void)regs;  /* Unused */
+
+    uint8_t lsr = inb(COM1_PORT + UART_LSR);
+
+    /* Drain received bytes into the RX ring */
+    while (lsr & UART_LSR_DR) {
+        char c = (char)inb(COM1_PORT);
+        size_t next = (rx_head + 1) % SERIAL_RX_BUFFER_SIZE;
+        if (next != rx_tail) {
+            rx_buffer[rx_head] = c;
+            rx_head = next;
+        }
+        lsr = inb(COM1_PORT + UART_LSR);
+    }
+
+    /* Transmitter idle: push the next FIFO's worth */
+    if (lsr & UART_LSR_THRE) {
+        tx_fill_fifo();
+    }
 }
 
 void serial_init(void) {
     /* Disable interrupts */
-    outb(COM1_PORT + 1, 0x00);
+    outb(COM1_PORT + UART_IER, 0x00);
 
     /* Enable DLAB */
-    outb(COM1_PORT + 3, 0x80);
+    outb(COM1_PORT + UART_LCR, 0x80);
 
     /* Set divisor to 1 (115200 baud) */
     outb(COM1_PORT + 0, 0x01);
-    outb(COM1_PORT + 1, 0x00);
+    outb(COM1_PORT + UART_IER, 0x00);
 
     /* 8 bits, no parity, one stop bit */
-    outb(COM1_PORT + 3, 0x03);
+    outb(COM1_PORT + UART_LCR, 0x03);
 
     /* Enable FIFO, clear them, 14-byte threshold */
-    outb(COM1_PORT + 2, 0xC7);
+    outb(COM1_PORT + UART_IIR, 0xC7);
 
-    /* IRQs enabled, RTS/DSR set */
-    outb(COM1_PORT + 4, 0x0B);
+    /* IRQs enabled, RTS/DSR set (OUT2 gates the IRQ line) */
+    outb(COM1_PORT + UART_MCR, 0x0B);
+}
+
+/*
+ * Switch to interrupt-driven transmit/receive. Called once the IDT
+ * and PIC are up; before this, writes spin synchronously.
+ */
+void serial_enable_irq(void) {
+    irq_register_handler(4, serial_handler);
+    pic_enable_irq(4);
+
+    /* Interrupt on received data and on transmitter empty */
+    outb(COM1_PORT + UART_IER, UART_IER_RDA | UART_IER_THRE);
+    irq_mode = true;
+}
+
+/* Enqueue one raw byte, kicking the transmitter if it is idle */
+static void serial_putc_buffered(char c) {
+    uint32_t eflags;
+    __asm__ volatile("pushf\n\tpop %0\n\tcli" : "=r"(eflags));
+
+    size_t next = (tx_head + 1) % SERIAL_TX_BUFFER_SIZE;
+    if (next == tx_tail) {
+        /* Ring full: drain a FIFO's worth synchronously rather than
+         * drop kernel log bytes */
+        while (!serial_transmit_empty()) {
+            /* spin */
+        }
+        tx_fill_fifo();
+        next = (tx_head + 1) % SERIAL_TX_BUFFER_SIZE;
+    }
+
+    tx_buffer[tx_head] = c;
+    tx_head = next;
+
+    /* Idle transmitter raises no THRE interrupt for queued data, so
+     * start it by hand */
+    if (serial_transmit_empty()) {
+        tx_fill_fifo();
+    }
+
+    if (eflags & 0x200) {
+        __asm__ volatile("sti");
+    }
 }
 
 void serial_write_char(char c) {
@@ -33,11 +159,11 @@ void serial_write_char(char c) {
         serial_write_char('\r');
     }
 
-    while (!serial_transmit_empty()) {
-        /* spin */
+    if (irq_mode) {
+        serial_putc_buffered(c);
+    } else {
+        serial_putc_sync(c);
     }
-
-    outb(COM1_PORT, (uint8_t)c);
 }
 
 void serial_write_string(const char* s) {
@@ -63,3 +189,16 @@ void serial_write_hex(uint32_t v) {
 
     serial_write_string(buf);
 }
+
+/*
+ * Pop one byte from the RX ring
+ * Returns: the byte, or -1 if nothing has been received
+ */
+int serial_read_char(void) {
+    if (rx_tail == rx_head) {
+        return -1;
+    }
+    char c = rx_buffer[rx_tail];
+    rx_tail = (rx_tail + 1) % SERIAL_RX_BUFFER_SIZE;
+    return (unsigned char)c;
+}
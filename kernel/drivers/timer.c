@@ -9,8 +9,10 @@
 #include "../include/isr.h"
 #include "../include/pic.h"
 #include "../include/scheduler.h"
+#include "../include/process.h"
 #include "../include/vga.h"
 #include "../include/serial.h"
+#include "../include/profile.h"
 
 /* Current tick count */
 static volatile uint32_t tick_count = 0;
@@ -21,16 +23,144 @@ static uint32_t timer_frequency = 0;
 /* Timer callback */
 static timer_callback_t timer_callback = NULL;
 
+/*
+ * Tickless idle. When only the idle process is runnable the periodic
+ * tick is stretched: the PIT is reprogrammed for the next timer-wheel
+ * deadline (clamped to its 16-bit reload span, ~54ms) and the skipped
+ * ticks are credited back when the CPU wakes, either by the stretched
+ * IRQ0 itself or by timer_exit_idle() after some other interrupt.
+ */
+static bool idle_stretch = false;
+static uint32_t counts_per_tick = 0;    /* PIT counts per normal tick */
+static uint32_t stretch_ticks = 0;      /* Ticks covered by the stretch */
+
+/* Latch and read channel 0's current count */
+static uint32_t pit_read_count(void) {
+    outb(PIT_COMMAND, 0x00);
+    uint32_t lo = inb(PIT_CHANNEL0);
+    uint32_t hi = inb(PIT_CHANNEL0);
+    return (hi << 8) | lo;
+}
+
+/* Program channel 0 as rate generator with the given reload value */
+static void pit_program(uint32_t counts) {
+    outb(PIT_COMMAND, 0x36);
+    outb(PIT_CHANNEL0, (uint8_t)(counts & 0xFF));
+    outb(PIT_CHANNEL0, (uint8_t)((counts >> 8) & 0xFF));
+}
+
+/*
+ * TSC-based high-resolution clock. Calibrated against the PIT once at
+ * boot, then timer_ns()/timer_us() convert cycles with a mult/shift
+ * pair (ns = cycles * mult >> shift) so the hot path has no division.
+ * Falls back to tick granularity on CPUs without a TSC.
+ */
+#define TSC_SHIFT 22
+
+static bool tsc_available = false;
+static uint64_t tsc_base = 0;           /* TSC value at calibration */
+static uint32_t tsc_khz = 0;
+static uint32_t tsc_ns_mult = 0;        /* (1e9 << TSC_SHIFT) / tsc_hz */
+static uint32_t tsc_us_mult = 0;        /* (1e6 << TSC_SHIFT) / tsc_hz */
+
+static inline uint64_t rdtsc(void) {
+    uint32_t lo, hi;
+    __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+/*
+ * 64-by-32 divide via shift-subtract. Only runs at calibration, so
+ * the bit loop is fine; the kernel links without libgcc and must not
+ * emit __udivdi3.
+ */
+static uint32_t udiv64_32(uint64_t dividend, uint32_t divisor) {
+    uint64_t rem = 0;
+    uint32_t quot = 0;
+    for (int bit = 63; bit >= 0; bit--) {
+        rem = (rem << 1) | ((dividend >> bit) & 1);
+        if (rem >= divisor) {
+            rem -= divisor;
+            if (bit < 32) {
+                quot |= 1u << bit;
+            }
+        }
+    }
+    return quot;
+}
+
+/* Scale a cycle delta by mult >> TSC_SHIFT without overflowing: the
+ * halves are converted separately so the product stays in 64 bits */
+static uint64_t tsc_scale(uint64_t cycles, uint32_t mult) {
+    uint64_t lo = (uint32_t)cycles;
+    uint64_t hi = cycles >> 32;
+    return ((lo * mult) >> TSC_SHIFT) +
+           ((hi * mult) << (32 - TSC_SHIFT));
+}
+
+/*
+ * Timer wheel for sleeping processes. Sleepers hash into the bucket
+ * their deadline falls in (deadline mod TIMER_WHEEL_SIZE), so each
+ * tick only inspects the one bucket the cursor passes; entries whose
+ * deadline lies a full wheel revolution ahead simply stay in place
+ * until their tick comes around. One node per process is enough since
+ * a process sleeps on at most one deadline at a time.
+ */
+#define TIMER_WHEEL_SIZE 256    /* Power of two, covers 2.56s per turn at 100Hz */
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SIZE - 1)
+
+typedef struct timer_sleeper {
+    process_t* proc;            /* Sleeping process (NULL = node free) */
+    uint32_t deadline;          /* Absolute tick to wake at */
+    struct timer_sleeper* next;
+} timer_sleeper_t;
+
+static timer_sleeper_t sleeper_pool[MAX_PROCESSES];
+static timer_sleeper_t* wheel[TIMER_WHEEL_SIZE];
+
+/*
+ * Wake every sleeper in the current tick's bucket whose deadline has
+ * arrived. Runs from the IRQ0 handler; later deadlines that merely
+ * hash here stay queued for a future revolution.
+ */
+static void timer_wheel_tick(void) {
+    timer_sleeper_t** link = &wheel[tick_count & TIMER_WHEEL_MASK];
+
+    while (*link != NULL) {
+        timer_sleeper_t* node = *link;
+        if ((int32_t)(tick_count - node->deadline) >= 0) {
+            *link = node->next;
+            process_t* proc = node->proc;
+            node->proc = NULL;
+            node->next = NULL;
+            process_unblock(proc);
+        } else {
+            link = &node->next;
+        }
+    }
+}
+
 /*
  * Timer interrupt handler
  */
 static void timer_handler(registers_t* regs) {
-    (void)regs;  /* Unused */
-
+    if (idle_stretch) {
+        /* Stretched interval elapsed: credit the skipped ticks (the
+         * increment below supplies the last one) and go periodic */
+        tick_count += stretch_ticks - 1;
+        pit_program(counts_per_tick);
+        idle_stretch = false;
+    }
     tick_count++;
 
+    /* Feed the sampling profiler the interrupted EIP */
+    profile_sample(regs->eip);
+
     vga_cursor_blink_tick(tick_count);
 
+    /* Wake sleepers whose deadline bucket expires this tick */
+    timer_wheel_tick();
+
     /* Call scheduler tick for preemption */
     scheduler_tick();
 
@@ -47,6 +177,14 @@ void timer_init(uint32_t frequency) {
     timer_frequency = frequency;
     tick_count = 0;
     timer_callback = NULL;
+
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        sleeper_pool[i].proc = NULL;
+        sleeper_pool[i].next = NULL;
+    }
+    for (int i = 0; i < TIMER_WHEEL_SIZE; i++) {
+        wheel[i] = NULL;
+    }
     
     /* Calculate divisor for PIT */
     uint32_t divisor = PIT_FREQUENCY / frequency;
@@ -55,12 +193,11 @@ void timer_init(uint32_t frequency) {
     if (divisor > 65535) divisor = 65535;
     if (divisor < 1) divisor = 1;
     
-    /* Send command byte: channel 0, lobyte/hibyte, rate generator */
-    outb(PIT_COMMAND, 0x36);
-    
-    /* Send divisor */
-    outb(PIT_CHANNEL0, (uint8_t)(divisor & 0xFF));         /* Low byte */
-    outb(PIT_CHANNEL0, (uint8_t)((divisor >> 8) & 0xFF));  /* High byte */
+    counts_per_tick = divisor;
+    idle_stretch = false;
+
+    /* Channel 0, lobyte/hibyte, rate generator */
+    pit_program(divisor);
     
     /* Register IRQ0 handler */
     irq_register_handler(0, timer_handler);
@@ -69,6 +206,134 @@ void timer_init(uint32_t frequency) {
     pic_enable_irq(0);
 }
 
+/*
+ * Stretch the tick across the next timer-wheel deadline. Idle calls
+ * this with interrupts disabled just before sti/hlt; anything due
+ * within a tick (or a wheel deadline too far to matter) leaves the
+ * periodic rate alone.
+ */
+void timer_enter_idle(void) {
+    if (idle_stretch || counts_per_tick == 0) {
+        return;
+    }
+
+    /* Nearest sleeper deadline, in ticks from now */
+    uint32_t max_stretch = 0xFFFF / counts_per_tick;
+    uint32_t ticks = max_stretch;
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        if (sleeper_pool[i].proc != NULL) {
+            int32_t delta = (int32_t)(sleeper_pool[i].deadline - tick_count);
+            if (delta <= 1) {
+                return;  /* Due now: keep the periodic tick */
+            }
+            if ((uint32_t)delta < ticks) {
+                ticks = (uint32_t)delta;
+            }
+        }
+    }
+    if (ticks <= 1) {
+        return;
+    }
+
+    stretch_ticks = ticks;
+    idle_stretch = true;
+    pit_program(ticks * counts_per_tick);
+}
+
+/*
+ * Undo the stretch after a non-timer wakeup: credit the ticks that
+ * elapsed inside the stretched interval (read back from the PIT) and
+ * restore the periodic rate. Call with interrupts disabled; a no-op
+ * when the stretched IRQ0 already cleaned up.
+ */
+void timer_exit_idle(void) {
+    if (!idle_stretch) {
+        return;
+    }
+
+    uint32_t total = stretch_ticks * counts_per_tick;
+    uint32_t remaining = pit_read_count();
+    uint32_t elapsed = total - remaining;
+
+    tick_count += elapsed / counts_per_tick;
+    pit_program(counts_per_tick);
+    idle_stretch = false;
+}
+
+/*
+ * Calibrate the TSC against the PIT. Call once after timer_init()
+ * with interrupts enabled: measures cycles across 5 ticks (50ms at
+ * 100Hz), which bounds the rate error well under 1%.
+ */
+void timer_calibrate_tsc(void) {
+    /* CPUID.1 EDX bit 4: TSC present */
+    uint32_t eax, edx;
+    __asm__ volatile("cpuid" : "=a"(eax), "=d"(edx) : "a"(1) : "ebx", "ecx");
+    if ((edx & (1 << 4)) == 0) {
+        return;
+    }
+
+    /* Align to a tick edge so the window is a whole number of ticks */
+    uint32_t start = tick_count;
+    while (tick_count == start) {
+        __asm__ volatile("hlt");
+    }
+
+    uint64_t tsc_start = rdtsc();
+    uint32_t target = tick_count + 5;
+    while ((int32_t)(tick_count - target) < 0) {
+        __asm__ volatile("hlt");
+    }
+    uint64_t cycles = rdtsc() - tsc_start;
+
+    /* Cycles per second, measured over 5 ticks at timer_frequency Hz */
+    uint64_t tsc_hz = (uint64_t)udiv64_32(cycles, 5) * timer_frequency;
+
+    /* udiv64_32 needs a 32-bit divisor; on >4.3GHz parts halve both
+     * sides of the division until the rate fits */
+    int shift = TSC_SHIFT;
+    while (tsc_hz > 0xFFFFFFFFull) {
+        tsc_hz >>= 1;
+        shift--;
+    }
+
+    tsc_ns_mult = udiv64_32((uint64_t)1000000000u << shift, (uint32_t)tsc_hz)
+                  << (TSC_SHIFT - shift);
+    tsc_us_mult = udiv64_32((uint64_t)1000000u << shift, (uint32_t)tsc_hz)
+                  << (TSC_SHIFT - shift);
+    tsc_khz = udiv64_32(tsc_hz << (TSC_SHIFT - shift), 1000);
+    tsc_base = tsc_start;
+    tsc_available = true;
+}
+
+/*
+ * Monotonic nanoseconds since calibration
+ */
+uint64_t timer_ns(void) {
+    if (!tsc_available) {
+        /* Tick fallback: 10ms granularity at 100Hz */
+        return (uint64_t)tick_count * (1000000000u / 100);
+    }
+    return tsc_scale(rdtsc() - tsc_base, tsc_ns_mult);
+}
+
+/*
+ * Monotonic microseconds since calibration
+ */
+uint64_t timer_us(void) {
+    if (!tsc_available) {
+        return (uint64_t)tick_count * (1000000u / 100);
+    }
+    return tsc_scale(rdtsc() - tsc_base, tsc_us_mult);
+}
+
+/*
+ * Calibrated TSC rate in kHz (0 if no TSC)
+ */
+uint32_t timer_tsc_khz(void) {
+    return tsc_khz;
+}
+
 /*
  * Get current tick count
  */
@@ -86,15 +351,78 @@ void timer_wait(uint32_t ticks) {
     }
 }
 
+/*
+ * Sleep the current process for the given number of ticks by parking
+ * it on the timer wheel; the IRQ0 handler wakes it at its deadline.
+ * Before the scheduler runs (or with no free node) this degrades to
+ * the busy-wait of timer_wait().
+ */
+void timer_sleep_ticks(uint32_t ticks) {
+    if (ticks == 0) return;
+
+    if (!scheduler_running() || current_process == NULL) {
+        timer_wait(ticks);
+        return;
+    }
+
+    uint32_t deadline = tick_count + ticks;
+
+    __asm__ volatile("cli");
+
+    /* Grab a free sleeper node */
+    timer_sleeper_t* node = NULL;
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        if (sleeper_pool[i].proc == NULL) {
+            node = &sleeper_pool[i];
+            break;
+        }
+    }
+
+    if (node == NULL) {
+        __asm__ volatile("sti");
+        timer_wait(ticks);
+        return;
+    }
+
+    node->proc = current_process;
+    node->deadline = deadline;
+
+    uint32_t bucket = deadline & TIMER_WHEEL_MASK;
+    node->next = wheel[bucket];
+    wheel[bucket] = node;
+
+    /* Re-block on early wakeups (e.g. signals) until the deadline */
+    while (node->proc == current_process &&
+           (int32_t)(deadline - tick_count) > 0) {
+        process_block(PROCESS_STATE_BLOCKED);
+        __asm__ volatile("cli");
+    }
+
+    /* Woken before the wheel dequeued us: unlink the node ourselves */
+    if (node->proc == current_process) {
+        timer_sleeper_t** link = &wheel[bucket];
+        while (*link != NULL && *link != node) {
+            link = &(*link)->next;
+        }
+        if (*link == node) {
+            *link = node->next;
+        }
+        node->proc = NULL;
+        node->next = NULL;
+    }
+
+    __asm__ volatile("sti");
+}
+
 /*
  * Sleep for specified number of milliseconds
  */
 void timer_sleep_ms(uint32_t ms) {
     if (timer_frequency == 0) return;
-    
+
     uint32_t ticks = (ms * timer_frequency) / 1000;
     if (ticks == 0) ticks = 1;
-    timer_wait(ticks);
+    timer_sleep_ticks(ticks);
 }
 
 /*
@@ -0,0 +1,145 @@
+/*
+ * MiniOS TTY Line Discipline
+ *
+ * Canonical-mode buffering for console input. In canonical mode the
+ * kernel does the line editing (backspace, Ctrl-U) and the echo, and
+ * readers receive whole lines, so an interactive userland program pays
+ * one read() syscall per line instead of one per keystroke. Raw mode
+ * hands every key (including special key codes) straight through with
+ * no echo, for full-screen programs like editors.
+ */
+
+#include "../include/tty.h"
+#include "../include/keyboard.h"
+#include "../include/vga.h"
+#include "../include/string.h"
+
+/* Line being edited / delivered (canonical mode) */
+static char tty_line[TTY_LINE_SIZE];
+static uint32_t tty_edit_len = 0;   /* Characters typed so far */
+static uint32_t tty_line_len = 0;   /* Completed line length, incl '\n' */
+static uint32_t tty_line_pos = 0;   /* Delivery offset into completed line */
+static bool tty_line_ready = false;
+
+/* Current input mode */
+static bool tty_raw = false;
+
+void tty_init(void) {
+    tty_edit_len = 0;
+    tty_line_len = 0;
+    tty_line_pos = 0;
+    tty_line_ready = false;
+    tty_raw = false;
+}
+
+void tty_set_raw(bool raw) {
+    tty_raw = raw;
+
+    /* A mode switch discards any half-edited line */
+    tty_edit_len = 0;
+    tty_line_len = 0;
+    tty_line_pos = 0;
+    tty_line_ready = false;
+}
+
+bool tty_is_raw(void) {
+    return tty_raw;
+}
+
+/*
+ * Erase the last n echoed characters in one batched write.
+ * vga_putchar('\b') both steps the cursor back and blanks the cell.
+ */
+static void tty_echo_erase(uint32_t n) {
+    char echo[TTY_LINE_SIZE + 1];
+
+    if (n == 0) {
+        return;
+    }
+    if (n > TTY_LINE_SIZE) {
+        n = TTY_LINE_SIZE;
+    }
+    memset(echo, '\b', n);
+    echo[n] = '\0';
+    vga_puts(echo);
+}
+
+/*
+ * Block until a full line has been edited, echoing as keys arrive.
+ * Scrollback keys are serviced here so they keep working while a
+ * userland program owns stdin, mirroring the kernel shell.
+ */
+static void tty_fill_line(void) {
+    while (!tty_line_ready) {
+        char c = keyboard_getchar();
+        unsigned char uc = (unsigned char)c;
+
+        if (c == '\n' || c == '\r') {
+            tty_line[tty_edit_len++] = '\n';
+            vga_putchar('\n');
+            tty_line_len = tty_edit_len;
+            tty_line_pos = 0;
+            tty_line_ready = true;
+        } else if (c == '\b' || uc == 127) {
+            if (tty_edit_len > 0) {
+                tty_edit_len--;
+                tty_echo_erase(1);
+            }
+        } else if (c == 21) {
+            /* Ctrl-U: kill the whole line */
+            tty_echo_erase(tty_edit_len);
+            tty_edit_len = 0;
+        } else if (uc == KEY_PAGEUP) {
+            vga_scroll_up(VGA_HEIGHT - 1);
+        } else if (uc == KEY_PAGEDOWN) {
+            vga_scroll_down(VGA_HEIGHT - 1);
+        } else if (uc == KEY_END) {
+            vga_scroll_to_bottom();
+        } else if (uc >= 0x80 || c == 0) {
+            /* Other special keys have no place in a canonical line */
+            continue;
+        } else if (tty_edit_len < TTY_LINE_SIZE - 1) {
+            tty_line[tty_edit_len++] = c;
+            vga_putchar(c);
+        }
+    }
+}
+
+/*
+ * Read from the console in the current mode
+ */
+int32_t tty_read(char* buf, uint32_t count) {
+    if (count == 0) {
+        return 0;
+    }
+
+    if (tty_raw) {
+        /* First key blocks; then drain whatever else is already
+         * buffered so a burst of keys costs one syscall */
+        uint32_t n = 0;
+        buf[n++] = keyboard_getchar();
+        while (n < count && keyboard_has_key()) {
+            buf[n++] = keyboard_getchar_nonblock();
+        }
+        return (int32_t)n;
+    }
+
+    if (!tty_line_ready) {
+        tty_fill_line();
+    }
+
+    /* Deliver as much of the completed line as fits; a short buffer
+     * picks up the remainder on the next call */
+    uint32_t avail = tty_line_len - tty_line_pos;
+    uint32_t n = (count < avail) ? count : avail;
+    memcpy(buf, tty_line + tty_line_pos, n);
+    tty_line_pos += n;
+
+    if (tty_line_pos == tty_line_len) {
+        tty_edit_len = 0;
+        tty_line_len = 0;
+        tty_line_pos = 0;
+        tty_line_ready = false;
+    }
+    return (int32_t)n;
+}
@@ -36,6 +36,28 @@ static uint16_t bga_read(uint16_t reg) {
     return inw(VBE_DISPI_IOPORT_DATA);
 }
 
+/*
+ * Identity map a span of the linear framebuffer. 4MB-aligned spans
+ * use PSE large pages so the flush path stops thrashing the TLB on
+ * multi-megabyte framebuffers; edges and non-PSE CPUs fall back to
+ * 4KB pages.
+ */
+static void vesa_map_range(uint32_t phys_start, uint32_t phys_end) {
+    uint32_t addr = phys_start & ~0xFFFu;
+    uint32_t cache = paging_fb_cache_flags();
+
+    while (addr < phys_end) {
+        if (paging_pse_available() && (addr & 0x3FFFFF) == 0 &&
+            addr + 0x400000 <= phys_end) {
+            paging_map_4mb(addr, addr, PAGE_KERNEL | cache);
+            addr += 0x400000;
+        } else {
+            paging_map_page(addr, addr, PAGE_KERNEL | cache);
+            addr += 4096;
+        }
+    }
+}
+
 /* Global framebuffer state */
 static vesa_info_t vesa_info = {
     .framebuffer = NULL,
@@ -148,15 +170,7 @@ void vesa_init(multiboot_info_t* mboot) {
 
         /* Map framebuffer into kernel address space */
         uint32_t fb_phys = (uint32_t)fb_addr;
-        for (uint32_t offset = 0; offset < fb_size; offset += 4096) {
-            paging_map_page(fb_phys + offset, fb_phys + offset,
-                           PAGE_KERNEL | PAGE_NOCACHE);
-            if ((offset & 0xFFFFF) == 0) {
-                serial_write_string("VESA: mapped offset=");
-                serial_write_hex(offset);
-                serial_write_string("\n");
-            }
-        }
+        vesa_map_range(fb_phys, fb_phys + fb_size);
 
         serial_write_string("VESA: framebuffer mapping done\n");
 
@@ -246,10 +260,7 @@ void vesa_init(multiboot_info_t* mboot) {
         serial_write_string("\n");
 
         /* Map framebuffer */
-        for (uint32_t offset = 0; offset < fb_size; offset += 4096) {
-            paging_map_page(fb_phys + offset, fb_phys + offset,
-                           PAGE_KERNEL | PAGE_NOCACHE);
-        }
+        vesa_map_range(fb_phys, fb_phys + fb_size);
 
         /* Store info */
         vesa_info.framebuffer = (uint8_t*)fb_phys;
@@ -494,10 +505,7 @@ int vesa_set_mode(int width, int height, int bpp) {
     uint32_t fb_phys = (uint32_t)vesa_info.framebuffer;
 
     if (new_size > vesa_info.size) {
-        for (uint32_t offset = vesa_info.size; offset < new_size; offset += 4096) {
-            paging_map_page(fb_phys + offset, fb_phys + offset,
-                           PAGE_KERNEL | PAGE_NOCACHE);
-        }
+        vesa_map_range(fb_phys + vesa_info.size, fb_phys + new_size);
     }
 
     /* Update internal state */
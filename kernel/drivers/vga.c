@@ -54,8 +54,18 @@ static uint8_t vga_color;
 static void copy_line_to_vga(size_t scrollback_line, size_t vga_line) {
     size_t sb_index = (scrollback_line % VGA_SCROLLBACK_LINES) * VGA_WIDTH;
     size_t vga_index = vga_line * VGA_WIDTH;
+    memcpy(&vga_buffer[vga_index], &scrollback[sb_index],
+           VGA_WIDTH * sizeof(uint16_t));
+}
+
+/*
+ * Blank one line of the VGA buffer with the current color
+ */
+static void vga_clear_line(size_t vga_line) {
+    uint16_t blank = vga_entry(' ', vga_color);
+    uint16_t* dst = &vga_buffer[vga_line * VGA_WIDTH];
     for (size_t x = 0; x < VGA_WIDTH; x++) {
-        vga_buffer[vga_index + x] = scrollback[sb_index + x];
+        dst[x] = blank;
     }
 }
 
@@ -95,14 +105,19 @@ static void vga_scroll(void) {
     scrollback_total_lines++;
 
     /* Clear the new line in scrollback */
-    size_t sb_index = scrollback_write_line * VGA_WIDTH;
+    uint16_t blank = vga_entry(' ', vga_color);
+    uint16_t* line = &scrollback[scrollback_write_line * VGA_WIDTH];
     for (size_t x = 0; x < VGA_WIDTH; x++) {
-        scrollback[sb_index + x] = vga_entry(' ', vga_color);
+        line[x] = blank;
     }
 
-    /* If viewing current output, refresh display */
+    /* If viewing current output, only the bottom line is new: shift the
+     * visible cells up one row in place and blank the last row, instead
+     * of repainting all 25 lines from scrollback on every newline. */
     if (view_offset == 0) {
-        vga_refresh_display();
+        memmove(vga_buffer, vga_buffer + VGA_WIDTH,
+                (VGA_HEIGHT - 1) * VGA_WIDTH * sizeof(uint16_t));
+        vga_clear_line(VGA_HEIGHT - 1);
     }
 }
 
@@ -264,15 +279,12 @@ static void vga_cursor_blink_restore(void) {
 }
 
 /*
- * Write a single character at current cursor position
+ * Write a single character at current cursor position, without touching
+ * the hardware cursor. Bulk writers (vga_puts) loop over this and move
+ * the cursor once at the end; the four port I/Os per character were the
+ * dominant cost of streaming text to the console.
  */
-void vga_putchar(char c) {
-    /* If output is being redirected, send there instead */
-    if (output_redirect) {
-        output_redirect(c);
-        return;
-    }
-
+static void vga_putchar_raw(char c) {
     /* Restore cursor cell before writing */
     vga_cursor_blink_restore();
 
@@ -322,7 +334,20 @@ void vga_putchar(char c) {
         vga_scroll();
         vga_row = VGA_HEIGHT - 1;
     }
-    
+}
+
+/*
+ * Write a single character at current cursor position
+ */
+void vga_putchar(char c) {
+    /* If output is being redirected, send there instead */
+    if (output_redirect) {
+        output_redirect(c);
+        return;
+    }
+
+    vga_putchar_raw(c);
+
     /* Update hardware cursor */
     vga_update_cursor();
 }
@@ -331,10 +356,21 @@ void vga_putchar(char c) {
  * Write a null-terminated string
  */
 void vga_puts(const char* str) {
+    if (output_redirect) {
+        while (*str) {
+            output_redirect(*str);
+            str++;
+        }
+        return;
+    }
+
     while (*str) {
-        vga_putchar(*str);
+        vga_putchar_raw(*str);
         str++;
     }
+
+    /* One cursor update for the whole string */
+    vga_update_cursor();
 }
 
 /*
@@ -0,0 +1,283 @@
+/*
+ * MiniOS Buffer Cache Implementation
+ *
+ * Fixed pool of sector buffers indexed by a small hash table on
+ * (device, lba). Lookups are O(1); on a miss the least recently used
+ * buffer is evicted (written out first if dirty). Writes only dirty
+ * the cached sector; the bflushd daemon (or blockdev_flush) writes
+ * dirty sectors back in LBA-sorted batches.
+ */
+
+#include "../include/bcache.h"
+#include "../include/heap.h"
+#include "../include/string.h"
+#include "../include/stdio.h"
+
+static bcache_buf_t* buffers = NULL;
+static bcache_buf_t* hash_table[BCACHE_HASH_SIZE];
+
+/* Monotonic use counter for LRU */
+static uint32_t use_stamp = 0;
+
+static bcache_stats_t stats;
+
+static inline uint32_t bcache_hash(blockdev_t* dev, uint32_t lba) {
+    return (lba ^ ((uint32_t)dev >> 4)) % BCACHE_HASH_SIZE;
+}
+
+void bcache_init(void) {
+    buffers = (bcache_buf_t*)kzalloc(BCACHE_NUM_BUFFERS * sizeof(bcache_buf_t));
+    if (buffers == NULL) {
+        printk("bcache: failed to allocate buffer pool\n");
+        return;
+    }
+
+    for (int i = 0; i < BCACHE_HASH_SIZE; i++) {
+        hash_table[i] = NULL;
+    }
+
+    memset(&stats, 0, sizeof(stats));
+    printk("bcache: %u sector buffers (%u KB)\n",
+           BCACHE_NUM_BUFFERS,
+           (BCACHE_NUM_BUFFERS * BLOCKDEV_SECTOR_SIZE) / 1024);
+}
+
+/*
+ * Look up a cached sector
+ */
+static bcache_buf_t* bcache_lookup(blockdev_t* dev, uint32_t lba) {
+    uint32_t h = bcache_hash(dev, lba);
+    for (bcache_buf_t* buf = hash_table[h]; buf; buf = buf->hash_next) {
+        if (buf->valid && buf->dev == dev && buf->lba == lba) {
+            return buf;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Unlink a buffer from its hash chain
+ */
+static void bcache_unhash(bcache_buf_t* buf) {
+    uint32_t h = bcache_hash(buf->dev, buf->lba);
+    bcache_buf_t* prev = NULL;
+
+    for (bcache_buf_t* cur = hash_table[h]; cur; cur = cur->hash_next) {
+        if (cur == buf) {
+            if (prev) prev->hash_next = buf->hash_next;
+            else hash_table[h] = buf->hash_next;
+            buf->hash_next = NULL;
+            return;
+        }
+        prev = cur;
+    }
+}
+
+/*
+ * Write a dirty buffer out to its device
+ */
+static bool bcache_writeback(bcache_buf_t* buf) {
+    if (!buf->dirty) return true;
+
+    if (buf->dev->ops == NULL || buf->dev->ops->write == NULL ||
+        !buf->dev->ops->write(buf->dev, buf->lba, 1, buf->data)) {
+        printk("bcache: writeback failed (%s lba %u)\n",
+               buf->dev->name, buf->lba);
+        return false;
+    }
+
+    buf->dirty = false;
+    stats.writebacks++;
+    return true;
+}
+
+/*
+ * Claim a buffer for (dev, lba): reuse an invalid one or evict the
+ * least recently used (flushing it first if dirty).
+ */
+static bcache_buf_t* bcache_victim(blockdev_t* dev, uint32_t lba) {
+    bcache_buf_t* victim = NULL;
+
+    for (int i = 0; i < BCACHE_NUM_BUFFERS; i++) {
+        bcache_buf_t* buf = &buffers[i];
+        if (!buf->valid) {
+            victim = buf;
+            break;
+        }
+        if (victim == NULL || buf->stamp < victim->stamp) {
+            victim = buf;
+        }
+    }
+
+    if (victim->valid) {
+        if (!bcache_writeback(victim)) return NULL;
+        bcache_unhash(victim);
+        victim->valid = false;
+    }
+
+    victim->dev = dev;
+    victim->lba = lba;
+    victim->dirty = false;
+
+    uint32_t h = bcache_hash(dev, lba);
+    victim->hash_next = hash_table[h];
+    hash_table[h] = victim;
+    victim->valid = true;
+
+    return victim;
+}
+
+bool bcache_read(blockdev_t* dev, uint32_t lba, void* buffer) {
+    if (buffers == NULL) {
+        return dev->ops->read(dev, lba, 1, buffer);
+    }
+
+    bcache_buf_t* buf = bcache_lookup(dev, lba);
+    if (buf) {
+        stats.hits++;
+        buf->stamp = ++use_stamp;
+        memcpy(buffer, buf->data, BLOCKDEV_SECTOR_SIZE);
+        return true;
+    }
+
+    stats.misses++;
+    buf = bcache_victim(dev, lba);
+    if (buf == NULL) {
+        return dev->ops->read(dev, lba, 1, buffer);
+    }
+
+    if (!dev->ops->read(dev, lba, 1, buf->data)) {
+        bcache_unhash(buf);
+        buf->valid = false;
+        return false;
+    }
+
+    buf->stamp = ++use_stamp;
+    memcpy(buffer, buf->data, BLOCKDEV_SECTOR_SIZE);
+    return true;
+}
+
+/*
+ * Read a small run of sectors. If none of them are cached, the whole
+ * run is fetched with a single driver command and then inserted into
+ * the cache; mixed hit/miss runs fall back to per-sector reads.
+ */
+bool bcache_read_multi(blockdev_t* dev, uint32_t lba, uint32_t count, void* buffer) {
+    if (buffers == NULL) {
+        return dev->ops->read(dev, lba, count, buffer);
+    }
+
+    bool any_cached = false;
+    for (uint32_t i = 0; i < count; i++) {
+        if (bcache_lookup(dev, lba + i)) {
+            any_cached = true;
+            break;
+        }
+    }
+
+    if (any_cached) {
+        uint8_t* dst = (uint8_t*)buffer;
+        for (uint32_t i = 0; i < count; i++) {
+            if (!bcache_read(dev, lba + i, dst + i * BLOCKDEV_SECTOR_SIZE)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /* Cold run: one multi-sector command, then populate the cache */
+    if (!dev->ops->read(dev, lba, count, buffer)) {
+        return false;
+    }
+    stats.misses += count;
+
+    const uint8_t* src = (const uint8_t*)buffer;
+    for (uint32_t i = 0; i < count; i++) {
+        bcache_buf_t* buf = bcache_victim(dev, lba + i);
+        if (buf == NULL) break;
+        memcpy(buf->data, src + i * BLOCKDEV_SECTOR_SIZE, BLOCKDEV_SECTOR_SIZE);
+        buf->stamp = ++use_stamp;
+    }
+    return true;
+}
+
+bool bcache_write(blockdev_t* dev, uint32_t lba, const void* buffer) {
+    if (buffers == NULL) {
+        return dev->ops->write(dev, lba, 1, buffer);
+    }
+
+    bcache_buf_t* buf = bcache_lookup(dev, lba);
+    if (buf == NULL) {
+        buf = bcache_victim(dev, lba);
+    }
+
+    if (buf == NULL) {
+        /* Cache unusable: fall back to a synchronous write */
+        return dev->ops->write(dev, lba, 1, buffer);
+    }
+
+    /* Write-back: dirty the cached sector, disk catches up later */
+    memcpy(buf->data, buffer, BLOCKDEV_SECTOR_SIZE);
+    buf->stamp = ++use_stamp;
+    buf->dirty = true;
+    return true;
+}
+
+bool bcache_sync(blockdev_t* dev) {
+    if (buffers == NULL) return true;
+
+    /* Collect dirty buffers */
+    bcache_buf_t* dirty[BCACHE_NUM_BUFFERS];
+    int n = 0;
+    for (int i = 0; i < BCACHE_NUM_BUFFERS; i++) {
+        bcache_buf_t* buf = &buffers[i];
+        if (buf->valid && buf->dirty && (dev == NULL || buf->dev == dev)) {
+            dirty[n++] = buf;
+        }
+    }
+
+    /* Sort by device then LBA so the disk sees a sequential sweep */
+    for (int i = 1; i < n; i++) {
+        bcache_buf_t* key = dirty[i];
+        int j = i - 1;
+        while (j >= 0 && (dirty[j]->dev > key->dev ||
+                          (dirty[j]->dev == key->dev && dirty[j]->lba > key->lba))) {
+            dirty[j + 1] = dirty[j];
+            j--;
+        }
+        dirty[j + 1] = key;
+    }
+
+    bool ok = true;
+    for (int i = 0; i < n; i++) {
+        if (!bcache_writeback(dirty[i])) ok = false;
+    }
+    return ok;
+}
+
+uint32_t bcache_dirty_count(void) {
+    if (buffers == NULL) return 0;
+
+    uint32_t n = 0;
+    for (int i = 0; i < BCACHE_NUM_BUFFERS; i++) {
+        if (buffers[i].valid && buffers[i].dirty) n++;
+    }
+    return n;
+}
+
+void bcache_invalidate(blockdev_t* dev) {
+    if (buffers == NULL) return;
+
+    for (int i = 0; i < BCACHE_NUM_BUFFERS; i++) {
+        bcache_buf_t* buf = &buffers[i];
+        if (buf->valid && buf->dev == dev) {
+            bcache_writeback(buf);
+            bcache_unhash(buf);
+            buf->valid = false;
+        }
+    }
+}
+
+void bcache_get_stats(bcache_stats_t* out) {
+    *out = stats;
+}
@@ -5,14 +5,36 @@
  */
 
 #include "../include/blockdev.h"
+#include "../include/bcache.h"
 #include "../include/string.h"
 #include "../include/stdio.h"
 #include "../include/heap.h"
+#include "../include/process.h"
+#include "../include/scheduler.h"
+#include "../include/timer.h"
+#include "../include/klog.h"
+#include "../include/trace.h"
+#include "../include/spinlock.h"
 
 /* Registered block devices */
 static blockdev_t* devices[BLOCKDEV_MAX_DEVICES];
 static uint8_t device_count = 0;
 
+/*
+ * Asynchronous request queue, kept sorted by absolute LBA. The kiod
+ * daemon drains it in elevator (LOOK) order: it sweeps upward from
+ * the last serviced sector and wraps to the lowest pending request,
+ * which keeps head movement monotonic under mixed load.
+ */
+static blockdev_request_t* io_queue = NULL;
+
+/* Protects the sorted request queue and its depth statistics */
+static spinlock_t io_queue_lock = SPINLOCK_INIT("io_queue");
+static uint32_t io_last_lba = 0;       /* Sweep position */
+static wait_queue_t io_idle_wq;        /* kiod parks here when idle */
+static wait_queue_t io_done_wq;        /* Waiters for completed requests */
+static bool io_wq_ready = false;
+
 /* MBR partition entry structure (16 bytes) */
 typedef struct {
     uint8_t  status;            /* 0x80 = bootable, 0x00 = not */
@@ -38,6 +60,13 @@ void blockdev_init(void) {
     for (int i = 0; i < BLOCKDEV_MAX_DEVICES; i++) {
         devices[i] = NULL;
     }
+    bcache_init();
+    io_queue = NULL;
+    spinlock_register(&io_queue_lock);
+    io_last_lba = 0;
+    wait_queue_init(&io_idle_wq);
+    wait_queue_init(&io_done_wq);
+    io_wq_ready = true;
     printk("BlockDev: Initialized\n");
 }
 
@@ -78,6 +107,7 @@ blockdev_t* blockdev_register(const char* name, blockdev_type_t type,
             devices[i] = dev;
             device_count++;
             printk("BlockDev: Registered '%s' (%u MB)\n", name, dev->size_mb);
+            klog(KLOG_INFO, KLOG_SUB_BLK, "registered %s (%u MB)", name, dev->size_mb);
             return dev;
         }
     }
@@ -137,6 +167,18 @@ uint8_t blockdev_count(void) {
     return device_count;
 }
 
+/*
+ * Record one operation in a log2-microsecond latency histogram
+ */
+static void blockdev_lat_record(uint32_t* hist, uint64_t us) {
+    int bucket = 0;
+    while (us > 1 && bucket < BLOCKDEV_LAT_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    hist[bucket]++;
+}
+
 /*
  * Read sectors from block device
  */
@@ -144,13 +186,33 @@ bool blockdev_read(blockdev_t* dev, uint32_t lba, uint32_t count, void* buffer)
     if (dev == NULL || dev->ops == NULL || dev->ops->read == NULL) {
         return false;
     }
-    
-    /* For partitions, adjust LBA relative to parent */
+
+    uint64_t start = timer_us();
+    bool ok;
+
     if (dev->type == BLOCKDEV_TYPE_PARTITION && dev->parent != NULL) {
-        return blockdev_read(dev->parent, dev->start_lba + lba, count, buffer);
+        /* For partitions, adjust LBA relative to parent */
+        ok = blockdev_read(dev->parent, dev->start_lba + lba, count, buffer);
+    } else {
+        /* Traced at the disk level so the record carries the
+         * absolute LBA */
+        TRACE(TRACE_CAT_BLOCK, TRACE_EV_BLK_READ, lba, count);
+        if (count > BCACHE_BYPASS_COUNT) {
+            /* Large sequential reads go straight to the driver */
+            ok = dev->ops->read(dev, lba, count, buffer);
+        } else {
+            /* Everything else is served from the cache; cold runs
+             * are fetched with a single multi-sector command */
+            ok = bcache_read_multi(dev, lba, count, buffer);
+        }
     }
-    
-    return dev->ops->read(dev, lba, count, buffer);
+
+    if (ok) {
+        dev->stats.reads++;
+        dev->stats.read_sectors += count;
+        blockdev_lat_record(dev->stats.read_lat, timer_us() - start);
+    }
+    return ok;
 }
 
 /*
@@ -160,13 +222,37 @@ bool blockdev_write(blockdev_t* dev, uint32_t lba, uint32_t count, const void* b
     if (dev == NULL || dev->ops == NULL || dev->ops->write == NULL) {
         return false;
     }
-    
-    /* For partitions, adjust LBA relative to parent */
+
+    uint64_t start = timer_us();
+    bool ok = true;
+
     if (dev->type == BLOCKDEV_TYPE_PARTITION && dev->parent != NULL) {
-        return blockdev_write(dev->parent, dev->start_lba + lba, count, buffer);
+        /* For partitions, adjust LBA relative to parent */
+        ok = blockdev_write(dev->parent, dev->start_lba + lba, count, buffer);
+    } else {
+        TRACE(TRACE_CAT_BLOCK, TRACE_EV_BLK_WRITE, lba, count);
+        if (count > BCACHE_BYPASS_COUNT) {
+            /* Large writes bypass the cache but must not leave stale
+             * sectors */
+            bcache_invalidate(dev);
+            ok = dev->ops->write(dev, lba, count, buffer);
+        } else {
+            const uint8_t* src = (const uint8_t*)buffer;
+            for (uint32_t i = 0; i < count; i++) {
+                if (!bcache_write(dev, lba + i, src + i * dev->sector_size)) {
+                    ok = false;
+                    break;
+                }
+            }
+        }
     }
-    
-    return dev->ops->write(dev, lba, count, buffer);
+
+    if (ok) {
+        dev->stats.writes++;
+        dev->stats.write_sectors += count;
+        blockdev_lat_record(dev->stats.write_lat, timer_us() - start);
+    }
+    return ok;
 }
 
 /*
@@ -181,8 +267,146 @@ bool blockdev_flush(blockdev_t* dev) {
     if (dev->type == BLOCKDEV_TYPE_PARTITION && dev->parent != NULL) {
         return blockdev_flush(dev->parent);
     }
-    
-    return dev->ops->flush(dev);
+
+    bool ok = bcache_sync(dev);
+    return dev->ops->flush(dev) && ok;
+}
+
+/*
+ * Absolute LBA of a (possibly partition-relative) sector, used as the
+ * elevator sort key so requests on different partitions of the same
+ * disk still order by physical position
+ */
+static uint32_t blockdev_abs_lba(blockdev_t* dev, uint32_t lba) {
+    while (dev->type == BLOCKDEV_TYPE_PARTITION && dev->parent != NULL) {
+        lba += dev->start_lba;
+        dev = dev->parent;
+    }
+    return lba;
+}
+
+/*
+ * Carry out one request synchronously and complete it. Callback
+ * requests are owned by their callback once it runs; waited-on
+ * requests are owned by the waiter once done is set, so neither is
+ * touched after handoff.
+ */
+static void blockdev_request_run(blockdev_request_t* req) {
+    bool ok;
+    if (req->write) {
+        ok = blockdev_write(req->dev, req->lba, req->count, req->buffer);
+    } else {
+        ok = blockdev_read(req->dev, req->lba, req->count, req->buffer);
+    }
+    req->ok = ok;
+
+    if (req->callback != NULL) {
+        req->done = true;
+        req->callback(req);
+    } else {
+        req->done = true;
+        wake_up(&io_done_wq);
+    }
+}
+
+/*
+ * Queue an asynchronous request. Before the scheduler is running
+ * there is no daemon to service the queue, so the request completes
+ * in place.
+ */
+void blockdev_submit(blockdev_request_t* req) {
+    if (req == NULL || req->dev == NULL) return;
+
+    req->done = false;
+    req->ok = false;
+    req->next = NULL;
+
+    if (!scheduler_running() || !io_wq_ready) {
+        blockdev_request_run(req);
+        return;
+    }
+
+    req->sort_lba = blockdev_abs_lba(req->dev, req->lba);
+
+    uint32_t eflags = spin_lock_irqsave(&io_queue_lock);
+    blockdev_request_t** link = &io_queue;
+    while (*link != NULL && (*link)->sort_lba <= req->sort_lba) {
+        link = &(*link)->next;
+    }
+    req->next = *link;
+    *link = req;
+    req->dev->stats.queue_depth++;
+    if (req->dev->stats.queue_depth > req->dev->stats.queue_max) {
+        req->dev->stats.queue_max = req->dev->stats.queue_depth;
+    }
+    spin_unlock_irqrestore(&io_queue_lock, eflags);
+
+    wake_up_one(&io_idle_wq);
+}
+
+/*
+ * Block until a waited-on request completes
+ */
+bool blockdev_request_wait(blockdev_request_t* req) {
+    if (req == NULL) return false;
+
+    /* Check and sleep under cli so a completion between the test and
+     * the enqueue cannot slip the wakeup */
+    while (1) {
+        __asm__ volatile ("cli");
+        if (req->done) {
+            __asm__ volatile ("sti");
+            break;
+        }
+        sleep_on(&io_done_wq);
+        __asm__ volatile ("sti");
+    }
+    return req->ok;
+}
+
+/*
+ * Pick and service the next request in sweep order. Called by kiod.
+ */
+bool blockdev_queue_service(void) {
+    uint32_t eflags = spin_lock_irqsave(&io_queue_lock);
+
+    /* First request at or above the sweep position, else wrap to
+     * the lowest pending one (the queue is sorted, so that is the
+     * head) */
+    blockdev_request_t** link = &io_queue;
+    while (*link != NULL && (*link)->sort_lba < io_last_lba) {
+        link = &(*link)->next;
+    }
+    if (*link == NULL) {
+        link = &io_queue;
+    }
+
+    blockdev_request_t* req = *link;
+    if (req != NULL) {
+        *link = req->next;
+        io_last_lba = req->sort_lba;
+        req->dev->stats.queue_depth--;
+    }
+    spin_unlock_irqrestore(&io_queue_lock, eflags);
+
+    if (req == NULL) {
+        return false;
+    }
+
+    blockdev_request_run(req);
+    return true;
+}
+
+/*
+ * Park the I/O daemon until work arrives. Re-checks under cli so a
+ * submit between the queue test and the sleep is not missed.
+ */
+void blockdev_queue_park(void) {
+    __asm__ volatile ("cli");
+    if (io_queue == NULL) {
+        sleep_on(&io_idle_wq);
+    }
+    __asm__ volatile ("sti");
 }
 
 /*
@@ -13,6 +13,75 @@
 #include "../include/stdio.h"
 #include "../include/serial.h"
 
+/*
+ * Parsed-section cache. Subsystems ask for the same sections over and
+ * over ("gui" per theme query, "appearance" at xgui start, "sched" at
+ * boot); keeping the parsed form in memory turns repeat conf_load()
+ * calls into a struct copy instead of a VFS read and re-parse. The VFS
+ * carries no mtimes, and the only in-kernel writer is conf_save(),
+ * which refreshes the cache itself — so entries stay valid until
+ * conf_invalidate() is called for out-of-band edits. Slots are reused
+ * LRU by stamp.
+ */
+typedef struct {
+    bool valid;
+    uint32_t stamp;             /* Last-use counter for LRU reuse */
+    conf_section_t section;
+} conf_cache_slot_t;
+
+static conf_cache_slot_t conf_cache[CONF_CACHE_SLOTS];
+static uint32_t conf_cache_stamp = 0;
+
+/* Change subscribers, notified after conf_save()/conf_invalidate() */
+typedef struct {
+    char name[32];
+    conf_notify_fn_t fn;
+} conf_subscriber_t;
+
+static conf_subscriber_t conf_subs[CONF_MAX_SUBSCRIBERS];
+static int conf_sub_count = 0;
+
+/*
+ * Find a cached section by name, or NULL.
+ */
+static conf_cache_slot_t* cache_find(const char* name) {
+    for (int i = 0; i < CONF_CACHE_SLOTS; i++) {
+        if (conf_cache[i].valid && strcmp(conf_cache[i].section.name, name) == 0) {
+            return &conf_cache[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Store (or refresh) a section in the cache, reusing the LRU slot.
+ */
+static void cache_store(const conf_section_t* section) {
+    conf_cache_slot_t* slot = cache_find(section->name);
+    if (!slot) {
+        slot = &conf_cache[0];
+        for (int i = 1; i < CONF_CACHE_SLOTS; i++) {
+            if (!conf_cache[i].valid) { slot = &conf_cache[i]; break; }
+            if (conf_cache[i].stamp < slot->stamp) slot = &conf_cache[i];
+        }
+    }
+    slot->section = *section;
+    slot->section.dirty = false;
+    slot->valid = true;
+    slot->stamp = ++conf_cache_stamp;
+}
+
+/*
+ * Call every subscriber registered for this section.
+ */
+static void notify_subscribers(const char* name) {
+    for (int i = 0; i < conf_sub_count; i++) {
+        if (strcmp(conf_subs[i].name, name) == 0) {
+            conf_subs[i].fn(name);
+        }
+    }
+}
+
 /*
  * Initialize the config system — ensure /mnt/conf/ exists.
  */
@@ -84,6 +153,14 @@ static bool parse_line(const char* line, conf_entry_t* entry) {
 int conf_load(conf_section_t* section, const char* name) {
     if (!section || !name) return -1;
 
+    /* Cache hit: hand back the parsed copy, no disk touch */
+    conf_cache_slot_t* slot = cache_find(name);
+    if (slot) {
+        *section = slot->section;
+        slot->stamp = ++conf_cache_stamp;
+        return 0;
+    }
+
     memset(section, 0, sizeof(*section));
     strncpy(section->name, name, sizeof(section->name) - 1);
 
@@ -92,12 +169,17 @@ int conf_load(conf_section_t* section, const char* name) {
 
     vfs_node_t* node = vfs_lookup(path);
     if (!node) {
-        /* File doesn't exist yet — not an error, just empty config */
+        /* File doesn't exist yet — not an error, just empty config.
+         * Cache the emptiness too so repeat lookups skip the VFS. */
+        cache_store(section);
         return 0;
     }
 
     uint32_t fsize = node->length;
-    if (fsize == 0) return 0;
+    if (fsize == 0) {
+        cache_store(section);
+        return 0;
+    }
     if (fsize > 4096) fsize = 4096; /* sanity limit */
 
     uint8_t* buf = (uint8_t*)kmalloc(fsize + 1);
@@ -128,6 +210,7 @@ int conf_load(conf_section_t* section, const char* name) {
 
     kfree(buf);
     section->dirty = false;
+    cache_store(section);
 
     serial_write_string("CONF: loaded ");
     serial_write_string(path);
@@ -207,6 +290,8 @@ int conf_save(conf_section_t* section) {
     if (written < 0) return -1;
 
     section->dirty = false;
+    cache_store(section);
+    notify_subscribers(section->name);
 
     serial_write_string("CONF: saved ");
     serial_write_string(path);
@@ -215,6 +300,31 @@ int conf_save(conf_section_t* section) {
     return 0;
 }
 
+/*
+ * Subscribe to changes of a section.
+ */
+int conf_subscribe(const char* name, conf_notify_fn_t fn) {
+    if (!name || !fn || conf_sub_count >= CONF_MAX_SUBSCRIBERS) return -1;
+    strncpy(conf_subs[conf_sub_count].name, name, sizeof(conf_subs[conf_sub_count].name) - 1);
+    conf_subs[conf_sub_count].name[sizeof(conf_subs[conf_sub_count].name) - 1] = '\0';
+    conf_subs[conf_sub_count].fn = fn;
+    conf_sub_count++;
+    return 0;
+}
+
+/*
+ * Drop cached sections (one by name, or all for NULL) and notify
+ * subscribers so they can re-load.
+ */
+void conf_invalidate(const char* name) {
+    for (int i = 0; i < CONF_CACHE_SLOTS; i++) {
+        if (!conf_cache[i].valid) continue;
+        if (name && strcmp(conf_cache[i].section.name, name) != 0) continue;
+        conf_cache[i].valid = false;
+        notify_subscribers(conf_cache[i].section.name);
+    }
+}
+
 /*
  * Get a string value. Returns default_val if not found.
  */
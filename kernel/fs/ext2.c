@@ -1,5 +1,6 @@
 #include "../include/ext2.h"
 #include "../include/heap.h"
+#include "../include/slab.h"
 #include "../include/string.h"
 #include "../include/stdio.h"
 #include "../include/timer.h"
@@ -10,10 +11,24 @@
 
 #define EXT2_S_IFDIR  0x4000
 #define EXT2_S_IFREG  0x8000
+#define EXT2_S_IFLNK  0xA000
+#define EXT2_S_IFMT   0xF000
+
+/* Fast symlinks keep the target inside the inode's block pointers */
+#define EXT2_FAST_SYMLINK_MAX 60
+
+/* Blocks prefetched ahead of a detected sequential reader */
+#define EXT2_READAHEAD_BLOCKS 8
 
 #define EXT2_FT_UNKNOWN 0
 #define EXT2_FT_REG_FILE 1
 #define EXT2_FT_DIR 2
+#define EXT2_FT_SYMLINK 7
+
+/* Metadata journal geometry: header block, data blocks, commit block */
+#define EXT2_JNL_MAGIC      0x4C4E4A4D  /* "MJNL" */
+#define EXT2_JNL_MAX_BLOCKS 32
+#define EXT2_JNL_AREA_BLOCKS (EXT2_JNL_MAX_BLOCKS + 2)
 
 typedef struct {
     uint32_t s_inodes_count;
@@ -51,6 +66,13 @@ typedef struct {
     char     s_volume_name[16];
     char     s_last_mounted[64];
     uint32_t s_algo_bitmap;
+
+    /* MiniOS metadata journal, stored in the reserved tail of the
+       1 KB on-disk superblock. All-zero means no journal area has
+       been reserved yet. */
+    uint32_t s_jnl_magic;
+    uint32_t s_jnl_start;       /* First block of the journal area */
+    uint32_t s_jnl_blocks;      /* Blocks in the journal area */
 } __attribute__((packed)) ext2_superblock_t;
 
 typedef struct {
@@ -99,6 +121,21 @@ typedef struct {
     ext2_group_desc_t* groups;
     uint32_t block_size;
     uint32_t groups_count;
+
+    /* Block allocator state: last allocation (used as the search hint
+       when a caller has no goal) and the preallocation window claimed
+       ahead of a streaming writer */
+    uint32_t alloc_hint;
+    uint32_t prealloc_next;
+    uint32_t prealloc_count;
+    bool alloc_dirty;           /* Free counts changed since last sync */
+
+    /* Metadata journal state (see the "Metadata journal" section) */
+    bool jnl_enabled;           /* A journal area exists on disk */
+    uint32_t jnl_seq;           /* Sequence number of the last commit */
+    uint32_t jnl_count;         /* Blocks captured in the open transaction */
+    uint32_t jnl_targets[EXT2_JNL_MAX_BLOCKS];
+    uint8_t* jnl_data;          /* EXT2_JNL_MAX_BLOCKS block copies */
 } ext2_fs_t;
 
 static bool ext2_read_bytes(ext2_fs_t* fs, uint64_t offset, uint32_t size, void* out) {
@@ -125,8 +162,20 @@ static bool ext2_read_bytes(ext2_fs_t* fs, uint64_t offset, uint32_t size, void*
 }
 
 static bool ext2_read_block(ext2_fs_t* fs, uint32_t block, void* out) {
-    uint64_t offset = (uint64_t)block * fs->block_size;
-    return ext2_read_bytes(fs, offset, fs->block_size, out);
+    /* A copy captured in the open journal transaction is newer than
+       the on-disk block */
+    for (uint32_t i = 0; i < fs->jnl_count; i++) {
+        if (fs->jnl_targets[i] == block) {
+            memcpy(out, fs->jnl_data + i * fs->block_size, fs->block_size);
+            return true;
+        }
+    }
+
+    /* Whole blocks are sector-aligned: lend the caller's buffer to
+       the block device directly instead of bouncing per sector
+       through ext2_read_bytes() */
+    uint32_t spb = fs->block_size / 512;
+    return blockdev_read(fs->bdev, block * spb, spb, out);
 }
 
 static bool ext2_write_bytes(ext2_fs_t* fs, uint64_t offset, uint32_t size, const void* data) {
@@ -161,15 +210,151 @@ static bool ext2_write_bytes(ext2_fs_t* fs, uint64_t offset, uint32_t size, cons
 }
 
 static bool ext2_write_block(ext2_fs_t* fs, uint32_t block, const void* data) {
-    uint64_t offset = (uint64_t)block * fs->block_size;
-    if (!ext2_write_bytes(fs, offset, fs->block_size, data))
+    /* Same fast path as ext2_read_block(): no read-modify-write is
+       needed for a full block, so hand the buffer straight down */
+    uint32_t spb = fs->block_size / 512;
+    if (!blockdev_write(fs->bdev, block * spb, spb, data))
         return false;
     blockdev_flush(fs->bdev);
     return true;
 }
 
+/*
+ * Metadata journal
+ *
+ * Metadata updates (inode table, bitmaps, group descriptors,
+ * superblock, directory and indirect blocks) are captured into an
+ * in-memory transaction instead of being written home with a flush
+ * apiece. ext2_jnl_commit() — reached from ext2_sync_allocator() at
+ * the end of each top-level operation — writes the whole batch
+ * sequentially into a reserved journal area, flushes, writes a commit
+ * record, flushes, then checkpoints the blocks to their home
+ * locations behind one final flush: three barriers per burst instead
+ * of one per block. A crash before the commit record leaves the old
+ * metadata intact; a crash after it is repaired by ext2_jnl_replay()
+ * at mount, which re-applies the committed batch (replay is
+ * idempotent — the records are whole physical blocks). The journal
+ * area is a contiguous run reserved on first mount and remembered in
+ * the superblock's reserved tail.
+ */
+
+/* Journal header and commit record (first and last area blocks) */
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;
+    uint32_t count;
+    uint32_t targets[EXT2_JNL_MAX_BLOCKS];
+} __attribute__((packed)) ext2_jnl_record_t;
+
+/*
+ * Commit the open transaction: journal it (when an area exists),
+ * then checkpoint every captured block to its home location.
+ */
+static void ext2_jnl_commit(ext2_fs_t* fs) {
+    if (fs->jnl_count == 0) return;
+    uint32_t spb = fs->block_size / 512;
+
+    if (fs->jnl_enabled) {
+        ext2_jnl_record_t rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.magic = EXT2_JNL_MAGIC;
+        rec.seq = ++fs->jnl_seq;
+        rec.count = fs->jnl_count;
+        memcpy(rec.targets, fs->jnl_targets, fs->jnl_count * sizeof(uint32_t));
+
+        /* Header and block copies, then one barrier */
+        uint64_t area = (uint64_t)fs->sb.s_jnl_start * fs->block_size;
+        ext2_write_bytes(fs, area, sizeof(rec), &rec);
+        for (uint32_t i = 0; i < fs->jnl_count; i++) {
+            blockdev_write(fs->bdev, (fs->sb.s_jnl_start + 1 + i) * spb,
+                           spb, fs->jnl_data + i * fs->block_size);
+        }
+        blockdev_flush(fs->bdev);
+
+        /* The commit record makes the transaction durable; it fits in
+           one sector, so the write itself is atomic */
+        ext2_write_bytes(fs, area + (uint64_t)(1 + EXT2_JNL_MAX_BLOCKS) * fs->block_size,
+                         sizeof(rec), &rec);
+        blockdev_flush(fs->bdev);
+    }
+
+    /* Checkpoint: write every block home behind a single barrier */
+    for (uint32_t i = 0; i < fs->jnl_count; i++) {
+        blockdev_write(fs->bdev, fs->jnl_targets[i] * spb, spb,
+                       fs->jnl_data + i * fs->block_size);
+    }
+    blockdev_flush(fs->bdev);
+    fs->jnl_count = 0;
+}
+
+/*
+ * The transaction's in-memory copy of a metadata block, capturing a
+ * fresh slot on first touch (loaded from disk when load is set).
+ * Returns NULL when the journal buffer is unavailable; the caller
+ * then writes directly.
+ */
+static uint8_t* ext2_jnl_block(ext2_fs_t* fs, uint32_t block, bool load) {
+    if (!fs->jnl_data) return NULL;
+
+    for (uint32_t i = 0; i < fs->jnl_count; i++) {
+        if (fs->jnl_targets[i] == block)
+            return fs->jnl_data + i * fs->block_size;
+    }
+
+    /* Transaction full: commit it and batch on in a fresh one */
+    if (fs->jnl_count == EXT2_JNL_MAX_BLOCKS) {
+        ext2_jnl_commit(fs);
+    }
+
+    uint32_t slot = fs->jnl_count;
+    uint8_t* copy = fs->jnl_data + slot * fs->block_size;
+    if (load && !ext2_read_block(fs, block, copy)) return NULL;
+    fs->jnl_targets[slot] = block;
+    fs->jnl_count = slot + 1;
+    return copy;
+}
+
+/*
+ * Journaled replacement for ext2_write_block() on metadata blocks.
+ */
+static bool ext2_meta_write_block(ext2_fs_t* fs, uint32_t block, const void* data) {
+    uint8_t* copy = ext2_jnl_block(fs, block, false);
+    if (copy) {
+        memcpy(copy, data, fs->block_size);
+        return true;
+    }
+    return ext2_write_block(fs, block, data);
+}
+
+/*
+ * Journaled replacement for ext2_write_bytes() on metadata (inode
+ * table entries, group descriptors, superblock).
+ */
+static bool ext2_meta_write_bytes(ext2_fs_t* fs, uint64_t offset, uint32_t size, const void* data) {
+    if (!fs->jnl_data) return ext2_write_bytes(fs, offset, size, data);
+
+    const uint8_t* src = (const uint8_t*)data;
+    while (size > 0) {
+        uint32_t block = (uint32_t)(offset / fs->block_size);
+        uint32_t off = (uint32_t)(offset % fs->block_size);
+        uint32_t chunk = fs->block_size - off;
+        if (chunk > size) chunk = size;
+
+        uint8_t* copy = ext2_jnl_block(fs, block, true);
+        if (!copy) return ext2_write_bytes(fs, offset, size, src);
+        memcpy(copy + off, src, chunk);
+
+        src += chunk;
+        offset += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
 /* Forward declarations for functions used before definition */
 static uint32_t ext2_alloc_block(ext2_fs_t* fs);
+static uint32_t ext2_alloc_block_goal(ext2_fs_t* fs, uint32_t goal);
+static bool ext2_free_block(ext2_fs_t* fs, uint32_t block_num);
 
 /*
  * Get the number of block pointers per block.
@@ -227,7 +412,7 @@ static uint32_t ext2_get_block_number(ext2_fs_t* fs, ext2_inode_t* ino,
                 return 0;
             }
             memset(zero_buf, 0, fs->block_size);
-            ext2_write_block(fs, ino->i_block[12], zero_buf);
+            ext2_meta_write_block(fs, ino->i_block[12], zero_buf);
             kfree(zero_buf);
         }
 
@@ -263,7 +448,7 @@ static uint32_t ext2_get_block_number(ext2_fs_t* fs, ext2_inode_t* ino,
                 return 0;
             }
             memset(zero_buf, 0, fs->block_size);
-            ext2_write_block(fs, ino->i_block[13], zero_buf);
+            ext2_meta_write_block(fs, ino->i_block[13], zero_buf);
             kfree(zero_buf);
         }
 
@@ -296,13 +481,13 @@ static uint32_t ext2_get_block_number(ext2_fs_t* fs, ext2_inode_t* ino,
 
             /* Update double indirect block */
             double_indirect_block[indirect_index] = indirect_block_num;
-            ext2_write_block(fs, ino->i_block[13], double_indirect_block);
+            ext2_meta_write_block(fs, ino->i_block[13], double_indirect_block);
 
             /* Zero the new indirect block */
             uint8_t* zero_buf = (uint8_t*)kmalloc(fs->block_size);
             if (zero_buf) {
                 memset(zero_buf, 0, fs->block_size);
-                ext2_write_block(fs, indirect_block_num, zero_buf);
+                ext2_meta_write_block(fs, indirect_block_num, zero_buf);
                 kfree(zero_buf);
             }
         }
@@ -361,7 +546,7 @@ static bool ext2_set_block_number(ext2_fs_t* fs, ext2_inode_t* ino,
                 return false;
             }
             memset(zero_buf, 0, fs->block_size);
-            ext2_write_block(fs, ino->i_block[12], zero_buf);
+            ext2_meta_write_block(fs, ino->i_block[12], zero_buf);
             kfree(zero_buf);
         }
 
@@ -376,7 +561,7 @@ static bool ext2_set_block_number(ext2_fs_t* fs, ext2_inode_t* ino,
 
         /* Set block number */
         indirect_block[block_index] = block_num;
-        bool success = ext2_write_block(fs, ino->i_block[12], indirect_block);
+        bool success = ext2_meta_write_block(fs, ino->i_block[12], indirect_block);
         kfree(indirect_block);
         return success;
     }
@@ -397,7 +582,7 @@ static bool ext2_set_block_number(ext2_fs_t* fs, ext2_inode_t* ino,
                 return false;
             }
             memset(zero_buf, 0, fs->block_size);
-            ext2_write_block(fs, ino->i_block[13], zero_buf);
+            ext2_meta_write_block(fs, ino->i_block[13], zero_buf);
             kfree(zero_buf);
         }
 
@@ -425,13 +610,13 @@ static bool ext2_set_block_number(ext2_fs_t* fs, ext2_inode_t* ino,
 
             /* Update double indirect block */
             double_indirect_block[indirect_index] = indirect_block_num;
-            ext2_write_block(fs, ino->i_block[13], double_indirect_block);
+            ext2_meta_write_block(fs, ino->i_block[13], double_indirect_block);
 
             /* Zero the new indirect block */
             uint8_t* zero_buf = (uint8_t*)kmalloc(fs->block_size);
             if (zero_buf) {
                 memset(zero_buf, 0, fs->block_size);
-                ext2_write_block(fs, indirect_block_num, zero_buf);
+                ext2_meta_write_block(fs, indirect_block_num, zero_buf);
                 kfree(zero_buf);
             }
         }
@@ -451,7 +636,7 @@ static bool ext2_set_block_number(ext2_fs_t* fs, ext2_inode_t* ino,
 
         /* Set block number */
         indirect_block[block_offset] = block_num;
-        bool success = ext2_write_block(fs, indirect_block_num, indirect_block);
+        bool success = ext2_meta_write_block(fs, indirect_block_num, indirect_block);
 
         kfree(indirect_block);
         kfree(double_indirect_block);
@@ -462,7 +647,272 @@ static bool ext2_set_block_number(ext2_fs_t* fs, ext2_inode_t* ino,
     return false;
 }
 
-static bool ext2_write_inode(ext2_fs_t* fs, uint32_t inode_num, const ext2_inode_t* ino) {
+/*
+ * In-memory inode cache. Path lookups hit the same handful of inodes
+ * (cwd, /etc files, open editor buffers) over and over; caching them
+ * avoids a disk read per path component. Entries pinned while a file
+ * is open are never evicted.
+ */
+#define EXT2_ICACHE_SIZE 64
+
+typedef struct {
+    ext2_fs_t* fs;
+    uint32_t inode_num;
+    ext2_inode_t ino;
+    bool valid;
+    uint32_t refcount;          /* Open-file pins */
+    uint32_t stamp;             /* LRU */
+} ext2_icache_entry_t;
+
+static ext2_icache_entry_t icache[EXT2_ICACHE_SIZE];
+static uint32_t icache_stamp = 0;
+
+static ext2_icache_entry_t* ext2_icache_lookup(ext2_fs_t* fs, uint32_t inode_num) {
+    for (int i = 0; i < EXT2_ICACHE_SIZE; i++) {
+        if (icache[i].valid && icache[i].fs == fs &&
+            icache[i].inode_num == inode_num) {
+            return &icache[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Find a slot for a new entry: free first, else oldest unpinned
+ */
+static ext2_icache_entry_t* ext2_icache_slot(void) {
+    ext2_icache_entry_t* victim = NULL;
+    for (int i = 0; i < EXT2_ICACHE_SIZE; i++) {
+        if (!icache[i].valid) return &icache[i];
+        if (icache[i].refcount == 0 &&
+            (victim == NULL || icache[i].stamp < victim->stamp)) {
+            victim = &icache[i];
+        }
+    }
+    return victim;  /* NULL if everything is pinned */
+}
+
+/*
+ * Inode-table block cache: inodes are decoded by overlaying the packed
+ * ext2_inode_t directly on a cached copy of their inode-table block
+ * instead of bouncing per-sector fragments through ext2_read_bytes().
+ * One block holds block_size/inode_size inodes (32 with 4KB blocks),
+ * so a readdir+stat sweep over a large directory decodes from a
+ * handful of cached blocks rather than one disk round trip per inode.
+ */
+#define EXT2_ITCACHE_SIZE 4
+
+typedef struct {
+    ext2_fs_t* fs;
+    uint32_t block;             /* On-disk inode-table block number */
+    uint8_t* data;              /* One block, kmalloc'd on first use */
+    uint32_t size;              /* Allocated size (fs block size) */
+    bool valid;
+    uint32_t stamp;             /* LRU */
+} ext2_itcache_entry_t;
+
+static ext2_itcache_entry_t itcache[EXT2_ITCACHE_SIZE];
+static uint32_t itcache_stamp = 0;
+
+static uint8_t* ext2_itable_lookup(ext2_fs_t* fs, uint32_t block) {
+    for (int i = 0; i < EXT2_ITCACHE_SIZE; i++) {
+        if (itcache[i].valid && itcache[i].fs == fs &&
+            itcache[i].block == block) {
+            itcache[i].stamp = ++itcache_stamp;
+            return itcache[i].data;
+        }
+    }
+    return NULL;
+}
+
+static uint8_t* ext2_itable_block(ext2_fs_t* fs, uint32_t block) {
+    uint8_t* hit = ext2_itable_lookup(fs, block);
+    if (hit) {
+        return hit;
+    }
+
+    /* Miss: evict a free slot, else the oldest */
+    ext2_itcache_entry_t* e = NULL;
+    for (int i = 0; i < EXT2_ITCACHE_SIZE; i++) {
+        if (!itcache[i].valid) {
+            e = &itcache[i];
+            break;
+        }
+        if (e == NULL || itcache[i].stamp < e->stamp) {
+            e = &itcache[i];
+        }
+    }
+
+    if (e->data == NULL || e->size != fs->block_size) {
+        if (e->data != NULL) {
+            kfree(e->data);
+        }
+        e->data = (uint8_t*)kmalloc(fs->block_size);
+        if (e->data == NULL) {
+            e->valid = false;
+            return NULL;
+        }
+        e->size = fs->block_size;
+    }
+
+    if (!ext2_read_block(fs, block, e->data)) {
+        e->valid = false;
+        return NULL;
+    }
+    e->fs = fs;
+    e->block = block;
+    e->valid = true;
+    e->stamp = ++itcache_stamp;
+    return e->data;
+}
+
+/*
+ * Locate an inode inside its (cached) inode-table block. Returns a
+ * pointer to the packed on-disk inode, valid until the next eviction.
+ * With fill false, only already-cached blocks are consulted.
+ */
+static ext2_inode_t* ext2_itable_inode(ext2_fs_t* fs, uint32_t inode_num, bool fill) {
+    if (inode_num == 0) return NULL;
+
+    uint32_t idx = inode_num - 1;
+    uint32_t group = idx / fs->sb.s_inodes_per_group;
+    uint32_t index_in_group = idx % fs->sb.s_inodes_per_group;
+
+    if (group >= fs->groups_count) return NULL;
+
+    uint32_t inode_size = fs->sb.s_inode_size ? fs->sb.s_inode_size : 128;
+    uint32_t per_block = fs->block_size / inode_size;
+    uint32_t block = fs->groups[group].bg_inode_table +
+                     index_in_group / per_block;
+
+    uint8_t* blk = fill ? ext2_itable_block(fs, block)
+                        : ext2_itable_lookup(fs, block);
+    if (blk == NULL) return NULL;
+
+    return (ext2_inode_t*)(blk + (index_in_group % per_block) * inode_size);
+}
+
+/*
+ * Per-inode logical->physical block map cache, kept as extent runs.
+ * ext2_get_block_number() re-walks the indirect chain — with disk
+ * reads — for every block, so sequential I/O on a large file pays the
+ * walk thousands of times. Mappings discovered during traversal are
+ * recorded here as (logical start, physical start, count) runs and
+ * served without touching the indirect blocks. Entries are dropped
+ * when an inode's blocks are freed.
+ */
+#define EXT2_BMAP_CACHE_SIZE 16
+#define EXT2_BMAP_EXTENTS    16
+
+typedef struct {
+    uint32_t lstart;            /* First logical block of the run */
+    uint32_t pstart;            /* First physical block of the run */
+    uint32_t count;             /* Blocks in the run */
+} ext2_extent_t;
+
+typedef struct {
+    ext2_fs_t* fs;
+    uint32_t inode_num;
+    bool valid;
+    uint32_t stamp;             /* LRU */
+    int extent_count;
+    ext2_extent_t extents[EXT2_BMAP_EXTENTS];
+} ext2_bmap_entry_t;
+
+static ext2_bmap_entry_t bmap_cache[EXT2_BMAP_CACHE_SIZE];
+static uint32_t bmap_stamp = 0;
+
+static ext2_bmap_entry_t* ext2_bmap_entry(ext2_fs_t* fs, uint32_t inode_num) {
+    for (int i = 0; i < EXT2_BMAP_CACHE_SIZE; i++) {
+        if (bmap_cache[i].valid && bmap_cache[i].fs == fs &&
+            bmap_cache[i].inode_num == inode_num) {
+            return &bmap_cache[i];
+        }
+    }
+    return NULL;
+}
+
+static bool ext2_bmap_lookup(ext2_fs_t* fs, uint32_t inode_num,
+                             uint32_t lblock, uint32_t* pblock) {
+    ext2_bmap_entry_t* e = ext2_bmap_entry(fs, inode_num);
+    if (!e) return false;
+
+    for (int i = 0; i < e->extent_count; i++) {
+        ext2_extent_t* ex = &e->extents[i];
+        if (lblock >= ex->lstart && lblock < ex->lstart + ex->count) {
+            *pblock = ex->pstart + (lblock - ex->lstart);
+            e->stamp = ++bmap_stamp;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void ext2_bmap_add(ext2_fs_t* fs, uint32_t inode_num,
+                          uint32_t lblock, uint32_t pblock) {
+    ext2_bmap_entry_t* e = ext2_bmap_entry(fs, inode_num);
+
+    if (!e) {
+        /* Evict the oldest entry */
+        ext2_bmap_entry_t* victim = &bmap_cache[0];
+        for (int i = 0; i < EXT2_BMAP_CACHE_SIZE; i++) {
+            if (!bmap_cache[i].valid) { victim = &bmap_cache[i]; break; }
+            if (bmap_cache[i].stamp < victim->stamp) victim = &bmap_cache[i];
+        }
+        victim->fs = fs;
+        victim->inode_num = inode_num;
+        victim->valid = true;
+        victim->extent_count = 0;
+        e = victim;
+    }
+    e->stamp = ++bmap_stamp;
+
+    /* Extend the run this block continues, if any */
+    for (int i = 0; i < e->extent_count; i++) {
+        ext2_extent_t* ex = &e->extents[i];
+        if (lblock == ex->lstart + ex->count &&
+            pblock == ex->pstart + ex->count) {
+            ex->count++;
+            return;
+        }
+        if (lblock >= ex->lstart && lblock < ex->lstart + ex->count) {
+            return;  /* Already mapped */
+        }
+    }
+
+    if (e->extent_count == EXT2_BMAP_EXTENTS) {
+        /* Badly fragmented file: start over with the current run */
+        e->extent_count = 0;
+    }
+    ext2_extent_t* ex = &e->extents[e->extent_count++];
+    ex->lstart = lblock;
+    ex->pstart = pblock;
+    ex->count = 1;
+}
+
+static void ext2_bmap_invalidate(ext2_fs_t* fs, uint32_t inode_num) {
+    ext2_bmap_entry_t* e = ext2_bmap_entry(fs, inode_num);
+    if (e) e->valid = false;
+}
+
+/*
+ * Resolve a logical block through the map cache, falling back to the
+ * indirect-chain walk and recording the result.
+ */
+static uint32_t ext2_bmap_block(ext2_fs_t* fs, uint32_t inode_num,
+                                ext2_inode_t* ino, uint32_t block_index) {
+    uint32_t blk;
+    if (ext2_bmap_lookup(fs, inode_num, block_index, &blk)) {
+        return blk;
+    }
+    blk = ext2_get_block_number(fs, ino, block_index, false);
+    if (blk != 0) {
+        ext2_bmap_add(fs, inode_num, block_index, blk);
+    }
+    return blk;
+}
+
+static bool ext2_write_inode_disk(ext2_fs_t* fs, uint32_t inode_num, const ext2_inode_t* ino) {
     if (inode_num == 0) return false;
 
     uint32_t idx = inode_num - 1;
@@ -477,67 +927,375 @@ static bool ext2_write_inode(ext2_fs_t* fs, uint32_t inode_num, const ext2_inode
     uint64_t inode_table_offset = (uint64_t)inode_table_block * fs->block_size;
     uint64_t inode_offset = inode_table_offset + (uint64_t)index_in_group * inode_size;
 
-    return ext2_write_bytes(fs, inode_offset, sizeof(ext2_inode_t), ino);
+    /* Keep an already-cached inode-table block coherent (no read-to-
+     * update: a missing block just stays missing) */
+    ext2_inode_t* cached = ext2_itable_inode(fs, inode_num, false);
+    if (cached != NULL) {
+        memcpy(cached, ino, sizeof(*cached));
+    }
+
+    return ext2_meta_write_bytes(fs, inode_offset, sizeof(ext2_inode_t), ino);
 }
 
-static uint32_t ext2_alloc_block(ext2_fs_t* fs) {
-    uint8_t* bitmap = (uint8_t*)kmalloc(fs->block_size);
-    if (!bitmap) return 0;
+/*
+ * Write an inode, keeping the cached copy current. The on-disk copy
+ * goes through the (write-back) block cache, so this does not stall
+ * on the disk.
+ */
+static bool ext2_write_inode(ext2_fs_t* fs, uint32_t inode_num, const ext2_inode_t* ino) {
+    ext2_icache_entry_t* e = ext2_icache_lookup(fs, inode_num);
+    if (e) {
+        memcpy(&e->ino, ino, sizeof(e->ino));
+        e->stamp = ++icache_stamp;
+    }
+    return ext2_write_inode_disk(fs, inode_num, ino);
+}
 
-    for (uint32_t g = 0; g < fs->groups_count; g++) {
-        if (fs->groups[g].bg_free_blocks_count == 0) continue;
+/* Blocks claimed ahead of a streaming writer */
+/*
+ * Bitmap cache: block and inode bitmaps stay pinned in memory, so an
+ * allocation or free is a pure memory operation instead of a bitmap
+ * read-modify-write per block. The in-memory group descriptors and
+ * superblock already carry the free counts; ext2_sync_allocator()
+ * writes dirty bitmaps and the counts back at the end of each
+ * top-level operation (write, create, unlink, close).
+ */
+#define EXT2_BITMAP_CACHE_SIZE 16
 
-        if (!ext2_read_block(fs, fs->groups[g].bg_block_bitmap, bitmap)) {
-            kfree(bitmap);
-            return 0;
+typedef struct {
+    ext2_fs_t* fs;
+    uint32_t block;             /* On-disk bitmap block number */
+    uint8_t* data;
+    bool valid;
+    bool dirty;
+    uint32_t stamp;             /* LRU */
+} ext2_bitmap_cent_t;
+
+static ext2_bitmap_cent_t bitmap_cache[EXT2_BITMAP_CACHE_SIZE];
+static uint32_t bitmap_stamp = 0;
+
+static uint8_t* ext2_bitmap_get(ext2_fs_t* fs, uint32_t block) {
+    ext2_bitmap_cent_t* victim = NULL;
+
+    for (int i = 0; i < EXT2_BITMAP_CACHE_SIZE; i++) {
+        ext2_bitmap_cent_t* e = &bitmap_cache[i];
+        if (e->valid && e->fs == fs && e->block == block) {
+            e->stamp = ++bitmap_stamp;
+            return e->data;
+        }
+        if (!e->valid) {
+            if (victim == NULL || victim->valid) victim = e;
+        } else if (victim == NULL ||
+                   (victim->valid && e->stamp < victim->stamp)) {
+            victim = e;
+        }
+    }
+
+    /* Miss: write back and reuse the oldest slot */
+    if (victim->valid && victim->dirty) {
+        ext2_meta_write_block(victim->fs, victim->block, victim->data);
+    }
+    if (victim->data && victim->fs != fs) {
+        /* Buffer may be sized for a different block size */
+        kfree(victim->data);
+        victim->data = NULL;
+    }
+    if (!victim->data) {
+        victim->data = (uint8_t*)kmalloc(fs->block_size);
+        if (!victim->data) {
+            victim->valid = false;
+            return NULL;
         }
+    }
+
+    if (!ext2_read_block(fs, block, victim->data)) {
+        victim->valid = false;
+        return NULL;
+    }
+    victim->fs = fs;
+    victim->block = block;
+    victim->valid = true;
+    victim->dirty = false;
+    victim->stamp = ++bitmap_stamp;
+    return victim->data;
+}
+
+static void ext2_bitmap_mark_dirty(ext2_fs_t* fs, uint32_t block) {
+    for (int i = 0; i < EXT2_BITMAP_CACHE_SIZE; i++) {
+        ext2_bitmap_cent_t* e = &bitmap_cache[i];
+        if (e->valid && e->fs == fs && e->block == block) {
+            e->dirty = true;
+            return;
+        }
+    }
+}
+
+/*
+ * Write dirty bitmaps, group descriptors and the superblock, then
+ * commit the whole metadata transaction the operation built up.
+ */
+static void ext2_sync_allocator(ext2_fs_t* fs) {
+    for (int i = 0; i < EXT2_BITMAP_CACHE_SIZE; i++) {
+        ext2_bitmap_cent_t* e = &bitmap_cache[i];
+        if (e->valid && e->fs == fs && e->dirty) {
+            ext2_meta_write_block(fs, e->block, e->data);
+            e->dirty = false;
+        }
+    }
+
+    if (fs->alloc_dirty) {
+        uint32_t gdt_block = (fs->block_size == 1024) ? 2 : 1;
+        ext2_meta_write_bytes(fs, (uint64_t)gdt_block * fs->block_size,
+                              fs->groups_count * sizeof(ext2_group_desc_t), fs->groups);
+        ext2_meta_write_bytes(fs, EXT2_SUPERBLOCK_OFFSET, sizeof(ext2_superblock_t), &fs->sb);
+        fs->alloc_dirty = false;
+    }
+
+    ext2_jnl_commit(fs);
+}
+
+/*
+ * Re-apply a committed-but-unfinished transaction at mount. Header
+ * and commit record must agree on sequence and count; anything else
+ * means the crash happened before the commit record, and the on-disk
+ * metadata is the consistent pre-transaction state.
+ */
+static void ext2_jnl_replay(ext2_fs_t* fs) {
+    if (fs->sb.s_jnl_magic != EXT2_JNL_MAGIC || fs->sb.s_jnl_start == 0) return;
+
+    ext2_jnl_record_t hdr, cmt;
+    uint64_t area = (uint64_t)fs->sb.s_jnl_start * fs->block_size;
+    uint64_t cmt_off = area + (uint64_t)(1 + EXT2_JNL_MAX_BLOCKS) * fs->block_size;
+    if (!ext2_read_bytes(fs, area, sizeof(hdr), &hdr)) return;
+    if (!ext2_read_bytes(fs, cmt_off, sizeof(cmt), &cmt)) return;
+
+    if (hdr.magic != EXT2_JNL_MAGIC) return;
+    fs->jnl_seq = hdr.seq;
+    if (cmt.magic != EXT2_JNL_MAGIC) return;
+    if (hdr.seq != cmt.seq || hdr.count != cmt.count) return;
+    if (hdr.count == 0 || hdr.count > EXT2_JNL_MAX_BLOCKS) return;
+
+    uint8_t* buf = (uint8_t*)kmalloc(fs->block_size);
+    if (!buf) return;
+
+    uint32_t applied = 0;
+    for (uint32_t i = 0; i < hdr.count; i++) {
+        if (hdr.targets[i] >= fs->sb.s_blocks_count) continue;
+        if (!ext2_read_block(fs, fs->sb.s_jnl_start + 1 + i, buf)) break;
+        if (ext2_write_block(fs, hdr.targets[i], buf)) applied++;
+    }
+    kfree(buf);
+
+    /* Retire the record so clean mounts skip the replay */
+    cmt.magic = 0;
+    ext2_write_bytes(fs, cmt_off, sizeof(cmt), &cmt);
+    blockdev_flush(fs->bdev);
+    printk("ext2: journal replayed %u metadata blocks\n", applied);
+}
+
+/*
+ * Arm the journal at mount: allocate the transaction buffer, and on
+ * the very first mount reserve a contiguous journal area (inside one
+ * block group) recorded in the superblock. Without an area the
+ * transaction buffer still batches metadata writes — there is just
+ * no crash protection.
+ */
+static void ext2_jnl_setup(ext2_fs_t* fs) {
+    fs->jnl_data = (uint8_t*)kmalloc(EXT2_JNL_MAX_BLOCKS * fs->block_size);
+    if (!fs->jnl_data) return;
+    fs->jnl_count = 0;
+
+    if (fs->sb.s_jnl_magic == EXT2_JNL_MAGIC && fs->sb.s_jnl_start != 0) {
+        fs->jnl_enabled = true;
+        return;
+    }
 
-        uint32_t blocks_in_group = fs->sb.s_blocks_per_group;
+    uint32_t blocks_in_group = fs->sb.s_blocks_per_group;
+    for (uint32_t g = 0; g < fs->groups_count; g++) {
+        if (fs->groups[g].bg_free_blocks_count < EXT2_JNL_AREA_BLOCKS) continue;
+
+        uint8_t* bitmap = ext2_bitmap_get(fs, fs->groups[g].bg_block_bitmap);
+        if (!bitmap) continue;
+
+        uint32_t run = 0;
         for (uint32_t i = 0; i < blocks_in_group; i++) {
+            uint32_t abs = g * blocks_in_group + i + fs->sb.s_first_data_block;
+            if (abs >= fs->sb.s_blocks_count ||
+                (bitmap[i / 8] & (1 << (i % 8)))) {
+                run = 0;
+                continue;
+            }
+            if (++run < EXT2_JNL_AREA_BLOCKS) continue;
+
+            uint32_t first = i + 1 - run;
+            for (uint32_t r = 0; r < run; r++) {
+                bitmap[(first + r) / 8] |= (1 << ((first + r) % 8));
+            }
+            ext2_bitmap_mark_dirty(fs, fs->groups[g].bg_block_bitmap);
+            fs->groups[g].bg_free_blocks_count -= EXT2_JNL_AREA_BLOCKS;
+            fs->sb.s_free_blocks_count -= EXT2_JNL_AREA_BLOCKS;
+            fs->sb.s_jnl_magic = EXT2_JNL_MAGIC;
+            fs->sb.s_jnl_start = g * blocks_in_group + first + fs->sb.s_first_data_block;
+            fs->sb.s_jnl_blocks = EXT2_JNL_AREA_BLOCKS;
+            fs->alloc_dirty = true;
+            ext2_sync_allocator(fs);
+            fs->jnl_enabled = true;
+            printk("ext2: journal area at block %u (%u blocks)\n",
+                   fs->sb.s_jnl_start, EXT2_JNL_AREA_BLOCKS);
+            return;
+        }
+    }
+
+    printk("ext2: no room for a journal area, running unjournaled\n");
+}
+
+#define EXT2_PREALLOC_BLOCKS 8
+
+/*
+ * Return unused preallocated blocks to the bitmap.
+ * Called when the write pattern breaks or the file is closed.
+ */
+static void ext2_discard_prealloc(ext2_fs_t* fs) {
+    while (fs->prealloc_count > 0) {
+        ext2_free_block(fs, fs->prealloc_next);
+        fs->prealloc_next++;
+        fs->prealloc_count--;
+    }
+    fs->prealloc_next = 0;
+}
+
+/*
+ * Goal-based run allocation. The search starts just past the goal
+ * block (typically the file's previous block), so sequential writes
+ * land contiguously instead of wherever the first free bit happens to
+ * be. When a free block is found, up to `want` blocks of the run that
+ * follows are claimed in the same bitmap pass; the extras form a
+ * preallocation window consumed by subsequent allocations that
+ * continue the run. Returns the first claimed block.
+ */
+static uint32_t ext2_alloc_run(ext2_fs_t* fs, uint32_t goal, uint32_t want) {
+    if (goal == 0) goal = fs->alloc_hint;
+    if (want == 0) want = 1;
+
+    /* Streaming write continuing where the last one ended: serve it
+       straight from the preallocation window */
+    if (fs->prealloc_count > 0) {
+        if (goal != 0 && goal + 1 == fs->prealloc_next) {
+            uint32_t blk = fs->prealloc_next++;
+            fs->prealloc_count--;
+            if (fs->prealloc_count == 0) fs->prealloc_next = 0;
+            fs->alloc_hint = blk;
+            return blk;
+        }
+        ext2_discard_prealloc(fs);
+    }
+
+    uint32_t start_group = 0;
+    uint32_t start_index = 0;
+    if (goal >= fs->sb.s_first_data_block && goal < fs->sb.s_blocks_count) {
+        uint32_t rel = goal - fs->sb.s_first_data_block;
+        start_group = rel / fs->sb.s_blocks_per_group;
+        start_index = rel % fs->sb.s_blocks_per_group + 1;
+    }
+
+    uint32_t blocks_in_group = fs->sb.s_blocks_per_group;
+
+    /* One extra pass so the start group's blocks before the goal are
+       still considered after wrapping through every other group */
+    for (uint32_t gi = 0; gi <= fs->groups_count; gi++) {
+        uint32_t g, first;
+        if (gi == 0) {
+            g = start_group;
+            first = start_index;
+        } else if (gi < fs->groups_count) {
+            g = (start_group + gi) % fs->groups_count;
+            first = 0;
+        } else {
+            if (start_index == 0) break;
+            g = start_group;
+            first = 0;
+        }
+
+        if (fs->groups[g].bg_free_blocks_count == 0) continue;
+        if (first >= blocks_in_group) continue;
+
+        uint8_t* bitmap = ext2_bitmap_get(fs, fs->groups[g].bg_block_bitmap);
+        if (!bitmap) return 0;
+
+        for (uint32_t i = first; i < blocks_in_group; i++) {
             uint32_t byte = i / 8;
             uint32_t bit = i % 8;
 
             if (!(bitmap[byte] & (1 << bit))) {
-                /* Found free block */
-                bitmap[byte] |= (1 << bit);
-
-                if (!ext2_write_block(fs, fs->groups[g].bg_block_bitmap, bitmap)) {
-                    kfree(bitmap);
-                    return 0;
+                /* Found a free block: claim the run that follows it
+                   as the preallocation window */
+                uint32_t run = 1;
+                while (run < want &&
+                       i + run < blocks_in_group &&
+                       run < (uint32_t)fs->groups[g].bg_free_blocks_count) {
+                    uint32_t b2 = (i + run) / 8;
+                    uint32_t bit2 = (i + run) % 8;
+                    if (bitmap[b2] & (1 << bit2)) break;
+                    run++;
                 }
 
-                /* Update group descriptor */
-                fs->groups[g].bg_free_blocks_count--;
-                uint32_t gdt_block = (fs->block_size == 1024) ? 2 : 1;
-                ext2_write_bytes(fs, (uint64_t)gdt_block * fs->block_size + g * sizeof(ext2_group_desc_t),
-                                 sizeof(ext2_group_desc_t), &fs->groups[g]);
+                for (uint32_t r = 0; r < run; r++) {
+                    bitmap[(i + r) / 8] |= (1 << ((i + r) % 8));
+                }
+                ext2_bitmap_mark_dirty(fs, fs->groups[g].bg_block_bitmap);
 
-                /* Update superblock */
-                fs->sb.s_free_blocks_count--;
-                ext2_write_bytes(fs, EXT2_SUPERBLOCK_OFFSET, sizeof(ext2_superblock_t), &fs->sb);
+                /* Free counts are flushed by ext2_sync_allocator() */
+                fs->groups[g].bg_free_blocks_count -= (uint16_t)run;
+                fs->sb.s_free_blocks_count -= run;
+                fs->alloc_dirty = true;
 
-                kfree(bitmap);
                 uint32_t block_num = g * fs->sb.s_blocks_per_group + i + fs->sb.s_first_data_block;
+                if (run > 1) {
+                    fs->prealloc_next = block_num + 1;
+                    fs->prealloc_count = run - 1;
+                }
+                fs->alloc_hint = block_num;
                 return block_num;
             }
         }
     }
 
-    kfree(bitmap);
     return 0;
 }
 
-static uint32_t ext2_alloc_inode(ext2_fs_t* fs) {
-    uint8_t* bitmap = (uint8_t*)kmalloc(fs->block_size);
-    if (!bitmap) return 0;
+static uint32_t ext2_alloc_block_goal(ext2_fs_t* fs, uint32_t goal) {
+    return ext2_alloc_run(fs, goal, EXT2_PREALLOC_BLOCKS);
+}
 
+static uint32_t ext2_alloc_block(ext2_fs_t* fs) {
+    return ext2_alloc_block_goal(fs, 0);
+}
+
+/*
+ * Claim up to `count` blocks near goal in one bitmap pass. The first
+ * block is returned; the rest sit in the preallocation window, so a
+ * writer extending a file by N blocks pays one bitmap scan and one
+ * free-count update for the whole run instead of one per block.
+ */
+static uint32_t ext2_alloc_blocks(ext2_fs_t* fs, uint32_t goal, uint32_t count) {
+    return ext2_alloc_run(fs, goal, count);
+}
+
+/*
+ * Preferred starting point for an inode's first block: the beginning
+ * of the block group the inode lives in.
+ */
+static uint32_t ext2_inode_goal(ext2_fs_t* fs, uint32_t inode_num) {
+    uint32_t g = (inode_num - 1) / fs->sb.s_inodes_per_group;
+    return g * fs->sb.s_blocks_per_group + fs->sb.s_first_data_block;
+}
+
+static uint32_t ext2_alloc_inode(ext2_fs_t* fs) {
     for (uint32_t g = 0; g < fs->groups_count; g++) {
         if (fs->groups[g].bg_free_inodes_count == 0) continue;
 
-        if (!ext2_read_block(fs, fs->groups[g].bg_inode_bitmap, bitmap)) {
-            kfree(bitmap);
-            return 0;
-        }
+        uint8_t* bitmap = ext2_bitmap_get(fs, fs->groups[g].bg_inode_bitmap);
+        if (!bitmap) return 0;
 
         uint32_t inodes_in_group = fs->sb.s_inodes_per_group;
         for (uint32_t i = 0; i < inodes_in_group; i++) {
@@ -547,30 +1305,19 @@ static uint32_t ext2_alloc_inode(ext2_fs_t* fs) {
             if (!(bitmap[byte] & (1 << bit))) {
                 /* Found free inode */
                 bitmap[byte] |= (1 << bit);
+                ext2_bitmap_mark_dirty(fs, fs->groups[g].bg_inode_bitmap);
 
-                if (!ext2_write_block(fs, fs->groups[g].bg_inode_bitmap, bitmap)) {
-                    kfree(bitmap);
-                    return 0;
-                }
-
-                /* Update group descriptor */
+                /* Free counts are flushed by ext2_sync_allocator() */
                 fs->groups[g].bg_free_inodes_count--;
-                uint32_t gdt_block = (fs->block_size == 1024) ? 2 : 1;
-                ext2_write_bytes(fs, (uint64_t)gdt_block * fs->block_size + g * sizeof(ext2_group_desc_t),
-                                 sizeof(ext2_group_desc_t), &fs->groups[g]);
-
-                /* Update superblock */
                 fs->sb.s_free_inodes_count--;
-                ext2_write_bytes(fs, EXT2_SUPERBLOCK_OFFSET, sizeof(ext2_superblock_t), &fs->sb);
+                fs->alloc_dirty = true;
 
-                kfree(bitmap);
                 uint32_t inode_num = g * fs->sb.s_inodes_per_group + i + 1;
                 return inode_num;
             }
         }
     }
 
-    kfree(bitmap);
     return 0;
 }
 
@@ -590,43 +1337,26 @@ static bool ext2_free_block(ext2_fs_t* fs, uint32_t block_num) {
 
     if (group >= fs->groups_count) return false;
 
-    uint8_t* bitmap = (uint8_t*)kmalloc(fs->block_size);
+    uint8_t* bitmap = ext2_bitmap_get(fs, fs->groups[group].bg_block_bitmap);
     if (!bitmap) return false;
 
-    if (!ext2_read_block(fs, fs->groups[group].bg_block_bitmap, bitmap)) {
-        kfree(bitmap);
-        return false;
-    }
-
     uint32_t byte = index_in_group / 8;
     uint32_t bit = index_in_group % 8;
 
     /* Check if block is actually allocated before freeing */
     if (!(bitmap[byte] & (1 << bit))) {
         printk("ext2: warning - freeing already-free block %u\n", block_num);
-        kfree(bitmap);
         return false;
     }
 
     /* Clear the bit */
     bitmap[byte] &= ~(1 << bit);
+    ext2_bitmap_mark_dirty(fs, fs->groups[group].bg_block_bitmap);
 
-    if (!ext2_write_block(fs, fs->groups[group].bg_block_bitmap, bitmap)) {
-        kfree(bitmap);
-        return false;
-    }
-
-    /* Update group descriptor */
+    /* Free counts are flushed by ext2_sync_allocator() */
     fs->groups[group].bg_free_blocks_count++;
-    uint32_t gdt_block = (fs->block_size == 1024) ? 2 : 1;
-    ext2_write_bytes(fs, (uint64_t)gdt_block * fs->block_size + group * sizeof(ext2_group_desc_t),
-                     sizeof(ext2_group_desc_t), &fs->groups[group]);
-
-    /* Update superblock */
     fs->sb.s_free_blocks_count++;
-    ext2_write_bytes(fs, EXT2_SUPERBLOCK_OFFSET, sizeof(ext2_superblock_t), &fs->sb);
-
-    kfree(bitmap);
+    fs->alloc_dirty = true;
     return true;
 }
 
@@ -643,43 +1373,26 @@ static bool ext2_free_inode(ext2_fs_t* fs, uint32_t inode_num) {
 
     if (group >= fs->groups_count) return false;
 
-    uint8_t* bitmap = (uint8_t*)kmalloc(fs->block_size);
+    uint8_t* bitmap = ext2_bitmap_get(fs, fs->groups[group].bg_inode_bitmap);
     if (!bitmap) return false;
 
-    if (!ext2_read_block(fs, fs->groups[group].bg_inode_bitmap, bitmap)) {
-        kfree(bitmap);
-        return false;
-    }
-
     uint32_t byte = index_in_group / 8;
     uint32_t bit = index_in_group % 8;
 
     /* Check if inode is actually allocated before freeing */
     if (!(bitmap[byte] & (1 << bit))) {
         printk("ext2: warning - freeing already-free inode %u\n", inode_num);
-        kfree(bitmap);
         return false;
     }
 
     /* Clear the bit */
     bitmap[byte] &= ~(1 << bit);
+    ext2_bitmap_mark_dirty(fs, fs->groups[group].bg_inode_bitmap);
 
-    if (!ext2_write_block(fs, fs->groups[group].bg_inode_bitmap, bitmap)) {
-        kfree(bitmap);
-        return false;
-    }
-
-    /* Update group descriptor */
+    /* Free counts are flushed by ext2_sync_allocator() */
     fs->groups[group].bg_free_inodes_count++;
-    uint32_t gdt_block = (fs->block_size == 1024) ? 2 : 1;
-    ext2_write_bytes(fs, (uint64_t)gdt_block * fs->block_size + group * sizeof(ext2_group_desc_t),
-                     sizeof(ext2_group_desc_t), &fs->groups[group]);
-
-    /* Update superblock */
     fs->sb.s_free_inodes_count++;
-    ext2_write_bytes(fs, EXT2_SUPERBLOCK_OFFSET, sizeof(ext2_superblock_t), &fs->sb);
-
-    kfree(bitmap);
+    fs->alloc_dirty = true;
     return true;
 }
 
@@ -695,83 +1408,290 @@ static bool ext2_free_inode_blocks(ext2_fs_t* fs, ext2_inode_t* ino) {
             ext2_free_block(fs, ino->i_block[i]);
             ino->i_block[i] = 0;
         }
-    }
+    }
+
+    /* Free single indirect */
+    if (ino->i_block[12] != 0) {
+        uint32_t* indirect = (uint32_t*)kmalloc(fs->block_size);
+        if (indirect) {
+            if (ext2_read_block(fs, ino->i_block[12], indirect)) {
+                for (uint32_t i = 0; i < ptrs_per_block; i++) {
+                    if (indirect[i] != 0) {
+                        ext2_free_block(fs, indirect[i]);
+                    }
+                }
+            }
+            kfree(indirect);
+        }
+        ext2_free_block(fs, ino->i_block[12]);
+        ino->i_block[12] = 0;
+    }
+
+    /* Free double indirect */
+    if (ino->i_block[13] != 0) {
+        uint32_t* double_indirect = (uint32_t*)kmalloc(fs->block_size);
+        uint32_t* indirect = (uint32_t*)kmalloc(fs->block_size);
+
+        if (double_indirect && indirect) {
+            if (ext2_read_block(fs, ino->i_block[13], double_indirect)) {
+                for (uint32_t i = 0; i < ptrs_per_block; i++) {
+                    if (double_indirect[i] != 0) {
+                        if (ext2_read_block(fs, double_indirect[i], indirect)) {
+                            for (uint32_t j = 0; j < ptrs_per_block; j++) {
+                                if (indirect[j] != 0) {
+                                    ext2_free_block(fs, indirect[j]);
+                                }
+                            }
+                        }
+                        ext2_free_block(fs, double_indirect[i]);
+                    }
+                }
+            }
+        }
+
+        if (double_indirect) kfree(double_indirect);
+        if (indirect) kfree(indirect);
+        ext2_free_block(fs, ino->i_block[13]);
+        ino->i_block[13] = 0;
+    }
+
+    /* Free triple indirect - if we ever implement it */
+    if (ino->i_block[14] != 0) {
+        /* For now, just free the triple indirect block itself */
+        ext2_free_block(fs, ino->i_block[14]);
+        ino->i_block[14] = 0;
+    }
+
+    return true;
+}
+
+static bool ext2_read_inode_disk(ext2_fs_t* fs, uint32_t inode_num, ext2_inode_t* out) {
+    /* Decode straight off the cached inode-table block: one block read
+     * serves every inode that shares the block */
+    ext2_inode_t* src = ext2_itable_inode(fs, inode_num, true);
+    if (src == NULL) return false;
+
+    memcpy(out, src, sizeof(*out));
+    return true;
+}
+
+/*
+ * Read an inode, serving repeat requests from the cache
+ */
+static bool ext2_read_inode(ext2_fs_t* fs, uint32_t inode_num, ext2_inode_t* out) {
+    ext2_icache_entry_t* e = ext2_icache_lookup(fs, inode_num);
+    if (e) {
+        e->stamp = ++icache_stamp;
+        memcpy(out, &e->ino, sizeof(*out));
+        return true;
+    }
+
+    if (!ext2_read_inode_disk(fs, inode_num, out)) {
+        return false;
+    }
+
+    e = ext2_icache_slot();
+    if (e) {
+        e->fs = fs;
+        e->inode_num = inode_num;
+        memcpy(&e->ino, out, sizeof(e->ino));
+        e->valid = true;
+        e->refcount = 0;
+        e->stamp = ++icache_stamp;
+    }
+    return true;
+}
+
+/*
+ * Directory entry index: a per-directory hash table mapping entry name
+ * to inode number, built lazily the first time a directory is searched
+ * and kept in sync by ext2_add_dir_entry/ext2_remove_dir_entry. Large
+ * directories then cost one block scan total instead of one per lookup.
+ */
+#define EXT2_DX_CACHE_SIZE 8    /* Directories indexed at once */
+#define EXT2_DX_HASH_SIZE  64   /* Name hash buckets per directory */
+
+typedef struct ext2_dx_entry {
+    char name[VFS_MAX_NAME];
+    uint32_t inode;
+    struct ext2_dx_entry* next;
+} ext2_dx_entry_t;
+
+typedef struct {
+    ext2_fs_t* fs;
+    uint32_t dir_inode;
+    bool valid;
+    uint32_t stamp;             /* Last-use counter for LRU eviction */
+    ext2_dx_entry_t* buckets[EXT2_DX_HASH_SIZE];
+} ext2_dx_index_t;
+
+static ext2_dx_index_t dx_cache[EXT2_DX_CACHE_SIZE];
+static uint32_t dx_stamp = 0;
+
+static uint32_t ext2_dx_hash(const char* name) {
+    uint32_t h = 5381;
+    while (*name) {
+        h = h * 33 + (uint8_t)*name++;
+    }
+    return h % EXT2_DX_HASH_SIZE;
+}
+
+static void ext2_dx_drop(ext2_dx_index_t* idx) {
+    for (int i = 0; i < EXT2_DX_HASH_SIZE; i++) {
+        ext2_dx_entry_t* e = idx->buckets[i];
+        while (e) {
+            ext2_dx_entry_t* next = e->next;
+            kfree(e);
+            e = next;
+        }
+        idx->buckets[i] = NULL;
+    }
+    idx->valid = false;
+}
+
+static ext2_dx_index_t* ext2_dx_lookup(ext2_fs_t* fs, uint32_t dir_inode) {
+    for (int i = 0; i < EXT2_DX_CACHE_SIZE; i++) {
+        ext2_dx_index_t* idx = &dx_cache[i];
+        if (idx->valid && idx->fs == fs && idx->dir_inode == dir_inode) {
+            idx->stamp = ++dx_stamp;
+            return idx;
+        }
+    }
+    return NULL;
+}
+
+static bool ext2_dx_add_entry(ext2_dx_index_t* idx, const char* name, uint32_t inode) {
+    ext2_dx_entry_t* e = (ext2_dx_entry_t*)kmalloc(sizeof(ext2_dx_entry_t));
+    if (!e) return false;
+
+    strncpy(e->name, name, VFS_MAX_NAME - 1);
+    e->name[VFS_MAX_NAME - 1] = '\0';
+    e->inode = inode;
+
+    uint32_t h = ext2_dx_hash(e->name);
+    e->next = idx->buckets[h];
+    idx->buckets[h] = e;
+    return true;
+}
+
+/*
+ * Build the index for a directory by scanning its direct blocks once.
+ * Evicts the least recently used index if all slots are taken.
+ * Returns NULL on failure (caller falls back to a linear scan).
+ */
+static ext2_dx_index_t* ext2_dx_build(ext2_fs_t* fs, uint32_t dir_inode,
+                                      const ext2_inode_t* dir_ino) {
+    ext2_dx_index_t* idx = NULL;
+
+    for (int i = 0; i < EXT2_DX_CACHE_SIZE; i++) {
+        if (!dx_cache[i].valid) {
+            idx = &dx_cache[i];
+            break;
+        }
+        if (idx == NULL || dx_cache[i].stamp < idx->stamp) {
+            idx = &dx_cache[i];
+        }
+    }
+
+    if (idx->valid) {
+        ext2_dx_drop(idx);
+    }
+
+    uint8_t* block_buf = (uint8_t*)kmalloc(fs->block_size);
+    if (!block_buf) return NULL;
+
+    idx->fs = fs;
+    idx->dir_inode = dir_inode;
+    idx->valid = true;
+    idx->stamp = ++dx_stamp;
+
+    for (uint32_t bi = 0; bi < 12; bi++) {
+        uint32_t blk = dir_ino->i_block[bi];
+        if (blk == 0) continue;
+
+        if (!ext2_read_block(fs, blk, block_buf)) {
+            ext2_dx_drop(idx);
+            kfree(block_buf);
+            return NULL;
+        }
 
-    /* Free single indirect */
-    if (ino->i_block[12] != 0) {
-        uint32_t* indirect = (uint32_t*)kmalloc(fs->block_size);
-        if (indirect) {
-            if (ext2_read_block(fs, ino->i_block[12], indirect)) {
-                for (uint32_t i = 0; i < ptrs_per_block; i++) {
-                    if (indirect[i] != 0) {
-                        ext2_free_block(fs, indirect[i]);
-                    }
+        uint32_t off = 0;
+        while (off + sizeof(ext2_dirent_t) <= fs->block_size) {
+            ext2_dirent_t* de = (ext2_dirent_t*)(block_buf + off);
+            if (de->rec_len == 0) break;
+
+            if (de->inode != 0 && de->name_len != 0) {
+                char tmp[VFS_MAX_NAME];
+                uint32_t n = de->name_len;
+                if (n >= VFS_MAX_NAME) n = VFS_MAX_NAME - 1;
+                memcpy(tmp, de->name, n);
+                tmp[n] = '\0';
+
+                if (!ext2_dx_add_entry(idx, tmp, de->inode)) {
+                    ext2_dx_drop(idx);
+                    kfree(block_buf);
+                    return NULL;
                 }
             }
-            kfree(indirect);
+
+            off += de->rec_len;
         }
-        ext2_free_block(fs, ino->i_block[12]);
-        ino->i_block[12] = 0;
     }
 
-    /* Free double indirect */
-    if (ino->i_block[13] != 0) {
-        uint32_t* double_indirect = (uint32_t*)kmalloc(fs->block_size);
-        uint32_t* indirect = (uint32_t*)kmalloc(fs->block_size);
+    kfree(block_buf);
+    return idx;
+}
 
-        if (double_indirect && indirect) {
-            if (ext2_read_block(fs, ino->i_block[13], double_indirect)) {
-                for (uint32_t i = 0; i < ptrs_per_block; i++) {
-                    if (double_indirect[i] != 0) {
-                        if (ext2_read_block(fs, double_indirect[i], indirect)) {
-                            for (uint32_t j = 0; j < ptrs_per_block; j++) {
-                                if (indirect[j] != 0) {
-                                    ext2_free_block(fs, indirect[j]);
-                                }
-                            }
-                        }
-                        ext2_free_block(fs, double_indirect[i]);
-                    }
-                }
-            }
+/*
+ * O(1) name lookup in an indexed directory; returns the inode number
+ * or 0 if the entry does not exist
+ */
+static uint32_t ext2_dx_find(ext2_dx_index_t* idx, const char* name) {
+    for (ext2_dx_entry_t* e = idx->buckets[ext2_dx_hash(name)]; e; e = e->next) {
+        if (strcmp(e->name, name) == 0) {
+            return e->inode;
         }
-
-        if (double_indirect) kfree(double_indirect);
-        if (indirect) kfree(indirect);
-        ext2_free_block(fs, ino->i_block[13]);
-        ino->i_block[13] = 0;
     }
+    return 0;
+}
 
-    /* Free triple indirect - if we ever implement it */
-    if (ino->i_block[14] != 0) {
-        /* For now, just free the triple indirect block itself */
-        ext2_free_block(fs, ino->i_block[14]);
-        ino->i_block[14] = 0;
+/*
+ * Keep an existing index in sync after a directory entry is added
+ */
+static void ext2_dx_insert(ext2_fs_t* fs, uint32_t dir_inode,
+                           const char* name, uint32_t inode) {
+    ext2_dx_index_t* idx = ext2_dx_lookup(fs, dir_inode);
+    if (idx == NULL) return;
+
+    if (!ext2_dx_add_entry(idx, name, inode)) {
+        /* Can't extend the index: drop it rather than serve stale data */
+        ext2_dx_drop(idx);
     }
-
-    return true;
 }
 
-static bool ext2_read_inode(ext2_fs_t* fs, uint32_t inode_num, ext2_inode_t* out) {
-    if (inode_num == 0) return false;
-
-    uint32_t idx = inode_num - 1;
-    uint32_t group = idx / fs->sb.s_inodes_per_group;
-    uint32_t index_in_group = idx % fs->sb.s_inodes_per_group;
-
-    if (group >= fs->groups_count) return false;
-
-    uint32_t inode_table_block = fs->groups[group].bg_inode_table;
-    uint32_t inode_size = fs->sb.s_inode_size ? fs->sb.s_inode_size : 128;
-
-    uint64_t inode_table_offset = (uint64_t)inode_table_block * fs->block_size;
-    uint64_t inode_offset = inode_table_offset + (uint64_t)index_in_group * inode_size;
-
-    memset(out, 0, sizeof(*out));
-    return ext2_read_bytes(fs, inode_offset, sizeof(ext2_inode_t), out);
+/*
+ * Keep an existing index in sync after a directory entry is removed
+ */
+static void ext2_dx_remove(ext2_fs_t* fs, uint32_t dir_inode, const char* name) {
+    ext2_dx_index_t* idx = ext2_dx_lookup(fs, dir_inode);
+    if (idx == NULL) return;
+
+    uint32_t h = ext2_dx_hash(name);
+    ext2_dx_entry_t* prev = NULL;
+
+    for (ext2_dx_entry_t* e = idx->buckets[h]; e; e = e->next) {
+        if (strcmp(e->name, name) == 0) {
+            if (prev) prev->next = e->next;
+            else idx->buckets[h] = e->next;
+            kfree(e);
+            return;
+        }
+        prev = e;
+    }
 }
 
 static uint32_t ext2_inode_type_to_vfs_flags(uint16_t mode) {
+    if ((mode & EXT2_S_IFMT) == EXT2_S_IFLNK) return VFS_SYMLINK;
     if (mode & EXT2_S_IFDIR) return VFS_DIRECTORY;
     if (mode & EXT2_S_IFREG) return VFS_FILE;
     return VFS_FILE;
@@ -779,9 +1699,15 @@ static uint32_t ext2_inode_type_to_vfs_flags(uint16_t mode) {
 
 /* Forward declarations for VFS ops */
 dirent_t* ext2_vfs_readdir(vfs_node_t* node, uint32_t index);
+dirent_t* ext2_vfs_readdir_next(vfs_node_t* node, vfs_dir_cursor_t* cur);
 static vfs_node_t* ext2_vfs_finddir(vfs_node_t* node, const char* name);
 static int32_t ext2_vfs_read(vfs_node_t* node, uint32_t offset, uint32_t size, uint8_t* buffer);
 static int32_t ext2_vfs_write(vfs_node_t* node, uint32_t offset, uint32_t size, uint8_t* buffer);
+static int32_t ext2_vfs_open(vfs_node_t* node, uint32_t flags);
+static int32_t ext2_vfs_close(vfs_node_t* node);
+static int32_t ext2_vfs_readlink(vfs_node_t* node, char* buf, uint32_t size);
+static vfs_node_t* ext2_make_child_node(ext2_fs_t* fs, vfs_node_t* parent,
+                                        const char* name, uint32_t inode_num);
 
 static bool ext2_add_dir_entry(ext2_fs_t* fs, uint32_t dir_inode, uint32_t child_inode, 
                                 const char* name, uint8_t file_type) {
@@ -801,8 +1727,10 @@ static bool ext2_add_dir_entry(ext2_fs_t* fs, uint32_t dir_inode, uint32_t child
     for (uint32_t bi = 0; bi < 12; bi++) {
         uint32_t blk = dir_ino.i_block[bi];
         if (blk == 0) {
-            /* Allocate new block for directory */
-            blk = ext2_alloc_block(fs);
+            /* Allocate new block for directory, near its last block */
+            uint32_t goal = (bi > 0) ? dir_ino.i_block[bi - 1]
+                                     : ext2_inode_goal(fs, dir_inode);
+            blk = ext2_alloc_block_goal(fs, goal);
             if (blk == 0) {
                 kfree(block_buf);
                 return false;
@@ -820,7 +1748,7 @@ static bool ext2_add_dir_entry(ext2_fs_t* fs, uint32_t dir_inode, uint32_t child
             de->file_type = file_type;
             memcpy(de->name, name, name_len);
 
-            if (!ext2_write_block(fs, blk, block_buf)) {
+            if (!ext2_meta_write_block(fs, blk, block_buf)) {
                 kfree(block_buf);
                 return false;
             }
@@ -829,6 +1757,7 @@ static bool ext2_add_dir_entry(ext2_fs_t* fs, uint32_t dir_inode, uint32_t child
                 return false;
             }
             kfree(block_buf);
+            ext2_dx_insert(fs, dir_inode, name, child_inode);
             return true;
         }
 
@@ -860,11 +1789,12 @@ static bool ext2_add_dir_entry(ext2_fs_t* fs, uint32_t dir_inode, uint32_t child
                 new_de->file_type = file_type;
                 memcpy(new_de->name, name, name_len);
 
-                if (!ext2_write_block(fs, blk, block_buf)) {
+                if (!ext2_meta_write_block(fs, blk, block_buf)) {
                     kfree(block_buf);
                     return false;
                 }
                 kfree(block_buf);
+                ext2_dx_insert(fs, dir_inode, name, child_inode);
                 return true;
             }
 
@@ -921,12 +1851,13 @@ static bool ext2_remove_dir_entry(ext2_fs_t* fs, uint32_t dir_inode, const char*
                         de->inode = 0;
                     }
 
-                    if (!ext2_write_block(fs, blk, block_buf)) {
+                    if (!ext2_meta_write_block(fs, blk, block_buf)) {
                         kfree(block_buf);
                         return false;
                     }
 
                     kfree(block_buf);
+                    ext2_dx_remove(fs, dir_inode, name);
                     return true;
                 }
             }
@@ -956,13 +1887,13 @@ bool ext2_unlink(vfs_node_t* parent, const char* name) {
 
     ext2_inode_t ino;
     if (!ext2_read_inode(fs, inode_num, &ino)) {
-        kfree(node);
+        kmem_cache_free(vfs_node_cache, node);
         return false;
     }
 
     /* Don't allow unlinking directories (would need rmdir logic) */
     if (ino.i_mode & EXT2_S_IFDIR) {
-        kfree(node);
+        kmem_cache_free(vfs_node_cache, node);
         return false;
     }
 
@@ -974,8 +1905,9 @@ bool ext2_unlink(vfs_node_t* parent, const char* name) {
         /* Set deletion time */
         ino.i_dtime = ext2_get_current_time();
 
-        /* Free all data blocks */
+        /* Free all data blocks and drop their cached mappings */
         ext2_free_inode_blocks(fs, &ino);
+        ext2_bmap_invalidate(fs, inode_num);
 
         /* Free the inode itself */
         ext2_free_inode(fs, inode_num);
@@ -987,7 +1919,13 @@ bool ext2_unlink(vfs_node_t* parent, const char* name) {
     /* Remove directory entry from parent */
     ext2_remove_dir_entry(fs, parent->inode, name);
 
-    kfree(node);
+    /* Drop any cached lookup of this entry */
+    vfs_dcache_invalidate(parent, name);
+
+    /* All the freed bits go to disk in one flush */
+    ext2_sync_allocator(fs);
+
+    kmem_cache_free(vfs_node_cache, node);
     return true;
 }
 
@@ -1017,7 +1955,7 @@ static vfs_node_t* ext2_create_node(vfs_node_t* parent, const char* name, uint16
 
     if (mode & EXT2_S_IFDIR) {
         /* Directory needs . and .. entries */
-        uint32_t blk = ext2_alloc_block(fs);
+        uint32_t blk = ext2_alloc_block_goal(fs, ext2_inode_goal(fs, new_inode));
         if (blk == 0) return NULL;
 
         ino.i_block[0] = blk;
@@ -1048,7 +1986,7 @@ static vfs_node_t* ext2_create_node(vfs_node_t* parent, const char* name, uint16
         de->name[0] = '.';
         de->name[1] = '.';
 
-        if (!ext2_write_block(fs, blk, block_buf)) {
+        if (!ext2_meta_write_block(fs, blk, block_buf)) {
             kfree(block_buf);
             return NULL;
         }
@@ -1074,8 +2012,11 @@ static vfs_node_t* ext2_create_node(vfs_node_t* parent, const char* name, uint16
     /* Add directory entry to parent */
     if (!ext2_add_dir_entry(fs, parent->inode, new_inode, name, file_type)) return NULL;
 
+    /* A stale cached lookup for this name must not shadow the new entry */
+    vfs_dcache_invalidate(parent, name);
+
     /* Create VFS node */
-    vfs_node_t* node = (vfs_node_t*)kmalloc(sizeof(vfs_node_t));
+    vfs_node_t* node = (vfs_node_t*)kmem_cache_alloc(vfs_node_cache);
     if (!node) return NULL;
 
     memset(node, 0, sizeof(*node));
@@ -1092,21 +2033,105 @@ static vfs_node_t* ext2_create_node(vfs_node_t* parent, const char* name, uint16
 
     if (node->flags & VFS_DIRECTORY) {
         node->readdir = ext2_vfs_readdir;
+        node->readdir_next = ext2_vfs_readdir_next;
         node->finddir = ext2_vfs_finddir;
     } else {
         node->read = ext2_vfs_read;
         node->write = ext2_vfs_write;
     }
+    if (VFS_IS_SYMLINK(node)) {
+        node->readlink = ext2_vfs_readlink;
+    }
+    node->open = ext2_vfs_open;
+    node->close = ext2_vfs_close;
 
     return node;
 }
 
 vfs_node_t* ext2_create_file(vfs_node_t* parent, const char* name) {
-    return ext2_create_node(parent, name, EXT2_S_IFREG | 0644, EXT2_FT_REG_FILE);
+    vfs_node_t* node = ext2_create_node(parent, name, EXT2_S_IFREG | 0644, EXT2_FT_REG_FILE);
+    if (parent && parent->impl) ext2_sync_allocator((ext2_fs_t*)parent->impl);
+    return node;
 }
 
 vfs_node_t* ext2_create_dir(vfs_node_t* parent, const char* name) {
-    return ext2_create_node(parent, name, EXT2_S_IFDIR | 0755, EXT2_FT_DIR);
+    vfs_node_t* node = ext2_create_node(parent, name, EXT2_S_IFDIR | 0755, EXT2_FT_DIR);
+    if (parent && parent->impl) ext2_sync_allocator((ext2_fs_t*)parent->impl);
+    return node;
+}
+
+/*
+ * Create a fast symlink: the target string is stored in the inode's
+ * block-pointer area, so the link costs an inode and no data blocks.
+ */
+vfs_node_t* ext2_create_symlink(vfs_node_t* parent, const char* name, const char* target) {
+    if (!parent || !name || !target) return NULL;
+
+    uint32_t len = strlen(target);
+    if (len == 0 || len >= EXT2_FAST_SYMLINK_MAX) return NULL;
+
+    vfs_node_t* node = ext2_create_node(parent, name, EXT2_S_IFLNK | 0777, EXT2_FT_SYMLINK);
+    if (!node) return NULL;
+
+    ext2_fs_t* fs = (ext2_fs_t*)parent->impl;
+    ext2_inode_t ino;
+    if (ext2_read_inode(fs, node->inode, &ino)) {
+        memcpy((char*)ino.i_block, target, len);
+        ino.i_size = len;
+        ext2_write_inode(fs, node->inode, &ino);
+        node->length = len;
+    }
+    ext2_sync_allocator(fs);
+    return node;
+}
+
+/*
+ * Create a hard link: a second directory entry for an existing
+ * inode. Content, block mappings and cache entries stay shared — the
+ * alias costs one dirent. ext2_unlink() already counts links, so the
+ * inode and its blocks are freed only when the last name goes.
+ */
+vfs_node_t* ext2_create_hardlink(vfs_node_t* parent, const char* name, vfs_node_t* target) {
+    if (!parent || !name || !target) return NULL;
+
+    ext2_fs_t* fs = (ext2_fs_t*)parent->impl;
+    if (!fs || (ext2_fs_t*)target->impl != fs) return NULL;  /* Same fs only */
+
+    ext2_inode_t ino;
+    if (!ext2_read_inode(fs, target->inode, &ino)) return NULL;
+    if (ino.i_mode & EXT2_S_IFDIR) return NULL;  /* No directory links */
+
+    uint8_t ft = ((ino.i_mode & EXT2_S_IFMT) == EXT2_S_IFLNK)
+                     ? EXT2_FT_SYMLINK : EXT2_FT_REG_FILE;
+    if (!ext2_add_dir_entry(fs, parent->inode, target->inode, name, ft)) {
+        return NULL;
+    }
+
+    ino.i_links_count++;
+    ino.i_ctime = ext2_get_current_time();
+    ext2_write_inode(fs, target->inode, &ino);
+
+    vfs_dcache_invalidate(parent, name);
+    ext2_sync_allocator(fs);
+
+    return ext2_make_child_node(fs, parent, name, target->inode);
+}
+
+/*
+ * True when the buffer holds only zero bytes (word-wise scan).
+ */
+static bool ext2_buf_is_zero(const uint8_t* buf, uint32_t len) {
+    const uint32_t* w = (const uint32_t*)buf;
+    while (len >= 4) {
+        if (*w++ != 0) return false;
+        len -= 4;
+    }
+    buf = (const uint8_t*)w;
+    while (len > 0) {
+        if (*buf++ != 0) return false;
+        len--;
+    }
+    return true;
 }
 
 static int32_t ext2_vfs_write(vfs_node_t* node, uint32_t offset, uint32_t size, uint8_t* buffer) {
@@ -1118,6 +2143,7 @@ static int32_t ext2_vfs_write(vfs_node_t* node, uint32_t offset, uint32_t size,
 
     uint32_t block_size = fs->block_size;
     uint32_t bytes_written = 0;
+    uint32_t last_blk = 0;
 
     uint8_t* block_buf = (uint8_t*)kmalloc(block_size);
     if (!block_buf) { serial_write_string("EXT2W: kmalloc fail\n"); return -1; }
@@ -1128,13 +2154,36 @@ static int32_t ext2_vfs_write(vfs_node_t* node, uint32_t offset, uint32_t size,
         uint32_t block_off = cur_off % block_size;
         uint32_t to_write = block_size - block_off;
         if (to_write > (size - bytes_written)) to_write = size - bytes_written;
+        bool full_block = (block_off == 0 && to_write == block_size);
 
         /* Use abstraction to get block number (handles indirect blocks) */
-        uint32_t blk = ext2_get_block_number(fs, &ino, block_index, false);
+        uint32_t blk = ext2_bmap_block(fs, node->inode, &ino, block_index);
+
+        if (blk == 0 && ext2_buf_is_zero(buffer + bytes_written, to_write)) {
+            /* Writing zeros into a hole: leave the hole in place.
+               The rest of an unmapped block already reads as zeros,
+               so only the size update below matters */
+            bytes_written += to_write;
+            continue;
+        }
 
         if (blk == 0) {
-            /* Allocate new block */
-            blk = ext2_alloc_block(fs);
+            /* Allocate near the file's previous block so sequential
+               writes stay contiguous */
+            uint32_t goal = last_blk;
+            if (goal == 0 && block_index > 0) {
+                goal = ext2_bmap_block(fs, node->inode, &ino, block_index - 1);
+            }
+            if (goal == 0) {
+                goal = ext2_inode_goal(fs, node->inode);
+            }
+            /* Ask for every block this write still needs in one go:
+               one bitmap pass and one free-count update cover the run,
+               and the loop drains the rest from the prealloc window */
+            uint32_t blocks_left =
+                (cur_off + (size - bytes_written) + block_size - 1) / block_size
+                - block_index;
+            blk = ext2_alloc_blocks(fs, goal, blocks_left);
             if (blk == 0) {
                 serial_write_string("EXT2W: alloc_block fail at bi=");
                 serial_write_hex(block_index);
@@ -1153,8 +2202,11 @@ static int32_t ext2_vfs_write(vfs_node_t* node, uint32_t offset, uint32_t size,
             }
 
             ino.i_blocks += block_size / 512;
-            memset(block_buf, 0, block_size);
-        } else if (block_off != 0 || to_write < block_size) {
+            ext2_bmap_add(fs, node->inode, block_index, blk);
+            if (!full_block) {
+                memset(block_buf, 0, block_size);
+            }
+        } else if (!full_block) {
             /* Partial write - read existing block first */
             if (!ext2_read_block(fs, blk, block_buf)) {
                 serial_write_string("EXT2W: read_block fail\n");
@@ -1163,9 +2215,14 @@ static int32_t ext2_vfs_write(vfs_node_t* node, uint32_t offset, uint32_t size,
             }
         }
 
-        memcpy(block_buf + block_off, buffer + bytes_written, to_write);
+        /* Full aligned block: write straight from the caller's
+           buffer; anything else goes through the bounce buffer */
+        const uint8_t* src = full_block ? buffer + bytes_written : block_buf;
+        if (!full_block) {
+            memcpy(block_buf + block_off, buffer + bytes_written, to_write);
+        }
 
-        if (!ext2_write_block(fs, blk, block_buf)) {
+        if (!ext2_write_block(fs, blk, src)) {
             serial_write_string("EXT2W: write_block fail at bi=");
             serial_write_hex(block_index);
             serial_write_string("\n");
@@ -1173,6 +2230,7 @@ static int32_t ext2_vfs_write(vfs_node_t* node, uint32_t offset, uint32_t size,
             return -1;
         }
 
+        last_blk = blk;
         bytes_written += to_write;
     }
 
@@ -1195,10 +2253,49 @@ static int32_t ext2_vfs_write(vfs_node_t* node, uint32_t offset, uint32_t size,
     /* Update VFS node length */
     node->length = ino.i_size;
 
+    /* Flush allocator state touched by this write in one go */
+    ext2_sync_allocator(fs);
+
     kfree(block_buf);
     return (int32_t)bytes_written;
 }
 
+/*
+ * Completion for an async readahead request: the sectors now sit in
+ * the block cache where the next read will find them, so the bounce
+ * buffer and the request itself are simply freed.
+ */
+static void ext2_ra_done(blockdev_request_t* req) {
+    kfree(req->buffer);
+    kfree(req);
+}
+
+/*
+ * Queue one block for readahead through the async I/O daemon. The
+ * transfer stays at or below the bcache bypass threshold, so kiod's
+ * read populates the block cache as a side effect. Allocation
+ * failure just means no prefetch.
+ */
+static void ext2_ra_submit(ext2_fs_t* fs, uint32_t block) {
+    blockdev_request_t* req = (blockdev_request_t*)kmalloc(sizeof(blockdev_request_t));
+    if (!req) return;
+    uint8_t* buf = (uint8_t*)kmalloc(fs->block_size);
+    if (!buf) {
+        kfree(req);
+        return;
+    }
+
+    uint32_t spb = fs->block_size / 512;
+    req->dev = fs->bdev;
+    req->write = false;
+    req->lba = block * spb;
+    req->count = spb;
+    req->buffer = buf;
+    req->callback = ext2_ra_done;
+    req->context = NULL;
+    blockdev_submit(req);
+}
+
 static int32_t ext2_vfs_read(vfs_node_t* node, uint32_t offset, uint32_t size, uint8_t* buffer) {
     ext2_fs_t* fs = (ext2_fs_t*)node->impl;
     if (!fs) return -1;
@@ -1214,8 +2311,9 @@ static int32_t ext2_vfs_read(vfs_node_t* node, uint32_t offset, uint32_t size, u
     uint32_t bytes_read = 0;
     uint32_t block_size = fs->block_size;
 
-    uint8_t* block_buf = (uint8_t*)kmalloc(block_size);
-    if (!block_buf) return -1;
+    /* Bounce buffer for partial blocks, allocated only when one is
+       actually met: hole and full-block reads never need it */
+    uint8_t* block_buf = NULL;
 
     while (bytes_read < size) {
         uint32_t cur_off = offset + bytes_read;
@@ -1224,13 +2322,24 @@ static int32_t ext2_vfs_read(vfs_node_t* node, uint32_t offset, uint32_t size, u
         uint32_t to_copy = block_size - block_off;
         if (to_copy > (size - bytes_read)) to_copy = size - bytes_read;
 
-        /* Use abstraction to get block number (handles indirect blocks) */
-        uint32_t blk = ext2_get_block_number(fs, &ino, block_index, false);
+        /* Resolve through the block map cache (handles indirect blocks) */
+        uint32_t blk = ext2_bmap_block(fs, node->inode, &ino, block_index);
 
         if (blk == 0) {
             /* Sparse file - return zeros */
             memset(buffer + bytes_read, 0, to_copy);
+        } else if (block_off == 0 && to_copy == block_size) {
+            /* Full aligned block: read straight into the caller's
+               buffer, no intermediate copy */
+            if (!ext2_read_block(fs, blk, buffer + bytes_read)) {
+                kfree(block_buf);
+                return -1;
+            }
         } else {
+            if (!block_buf) {
+                block_buf = (uint8_t*)kmalloc(block_size);
+                if (!block_buf) return -1;
+            }
             if (!ext2_read_block(fs, blk, block_buf)) {
                 kfree(block_buf);
                 return -1;
@@ -1241,10 +2350,66 @@ static int32_t ext2_vfs_read(vfs_node_t* node, uint32_t offset, uint32_t size, u
         bytes_read += to_copy;
     }
 
+    /* Track sequential access; once a streaming pattern is clear,
+     * hand the next few blocks to the async I/O daemon so the disk
+     * latency is paid off the consumer's back */
+    if (offset == node->ra_next_offset && offset != 0) {
+        node->ra_seq_count++;
+    } else if (offset != node->ra_next_offset) {
+        node->ra_seq_count = 0;
+        node->ra_prefetched = 0;
+    }
+    node->ra_next_offset = offset + bytes_read;
+
+    if (node->ra_seq_count >= 2) {
+        uint32_t next_block = (offset + bytes_read + block_size - 1) / block_size;
+        if (next_block < node->ra_prefetched) next_block = node->ra_prefetched;
+        uint32_t end_block = next_block + EXT2_READAHEAD_BLOCKS;
+
+        for (uint32_t bi = next_block;
+             bi < end_block && (uint64_t)bi * block_size < ino.i_size; bi++) {
+            uint32_t blk = ext2_bmap_block(fs, node->inode, &ino, bi);
+            if (blk == 0) continue;  /* Hole: nothing to prefetch */
+            ext2_ra_submit(fs, blk);
+        }
+        node->ra_prefetched = end_block;
+    }
+
     kfree(block_buf);
     return (int32_t)bytes_read;
 }
 
+/*
+ * Pin/unpin the node's inode in the cache across open/close, so the
+ * inodes of open files survive eviction.
+ */
+static int32_t ext2_vfs_open(vfs_node_t* node, uint32_t flags) {
+    (void)flags;
+    ext2_fs_t* fs = (ext2_fs_t*)node->impl;
+    if (!fs) return -1;
+
+    ext2_inode_t ino;
+    if (!ext2_read_inode(fs, node->inode, &ino)) return -1;
+
+    ext2_icache_entry_t* e = ext2_icache_lookup(fs, node->inode);
+    if (e) e->refcount++;
+    return 0;
+}
+
+static int32_t ext2_vfs_close(vfs_node_t* node) {
+    ext2_fs_t* fs = (ext2_fs_t*)node->impl;
+    if (!fs) return -1;
+
+    /* The streaming write is over; hand back any window blocks and
+       flush the allocator state */
+    ext2_discard_prealloc(fs);
+    ext2_sync_allocator(fs);
+
+    ext2_icache_entry_t* e = ext2_icache_lookup(fs, node->inode);
+    if (e && e->refcount > 0) e->refcount--;
+    return 0;
+}
+
 static dirent_t ext2_dirent;
 
 dirent_t* ext2_vfs_readdir(vfs_node_t* node, uint32_t index) {
@@ -1298,6 +2463,137 @@ dirent_t* ext2_vfs_readdir(vfs_node_t* node, uint32_t index) {
     return NULL;
 }
 
+/*
+ * Cursor-based readdir: resume the scan at the block/offset where the
+ * previous entry ended, so a full listing reads each directory block
+ * once instead of rescanning from block 0 for every index.
+ */
+dirent_t* ext2_vfs_readdir_next(vfs_node_t* node, vfs_dir_cursor_t* cur) {
+    ext2_fs_t* fs = (ext2_fs_t*)node->impl;
+    if (!fs) return NULL;
+
+    ext2_inode_t ino;
+    if (!ext2_read_inode(fs, node->inode, &ino)) return NULL;
+
+    if (!(ino.i_mode & EXT2_S_IFDIR)) return NULL;
+
+    uint32_t block_size = fs->block_size;
+    uint8_t* block_buf = (uint8_t*)kmalloc(block_size);
+    if (!block_buf) return NULL;
+
+    uint32_t off = cur->fs_offset;
+    for (uint32_t bi = cur->fs_block; bi < 12; bi++, off = 0) {
+        uint32_t blk = ino.i_block[bi];
+        if (blk == 0) continue;
+
+        if (!ext2_read_block(fs, blk, block_buf)) {
+            kfree(block_buf);
+            return NULL;
+        }
+
+        while (off + sizeof(ext2_dirent_t) <= block_size) {
+            ext2_dirent_t* de = (ext2_dirent_t*)(block_buf + off);
+            if (de->rec_len == 0) break;
+
+            if (de->inode != 0 && de->name_len != 0) {
+                uint32_t n = de->name_len;
+                if (n >= VFS_MAX_NAME) n = VFS_MAX_NAME - 1;
+                memcpy(ext2_dirent.name, de->name, n);
+                ext2_dirent.name[n] = '\0';
+                ext2_dirent.inode = de->inode;
+
+                /* Resume just past this entry next call */
+                cur->fs_block = bi;
+                cur->fs_offset = off + de->rec_len;
+                cur->index++;
+                kfree(block_buf);
+                return &ext2_dirent;
+            }
+
+            off += de->rec_len;
+        }
+    }
+
+    cur->fs_block = 12;
+    cur->fs_offset = 0;
+    kfree(block_buf);
+    return NULL;
+}
+
+/*
+ * Build a VFS node for a directory child found by name lookup
+ */
+static vfs_node_t* ext2_make_child_node(ext2_fs_t* fs, vfs_node_t* parent,
+                                        const char* name, uint32_t inode_num) {
+    ext2_inode_t child_ino;
+    if (!ext2_read_inode(fs, inode_num, &child_ino)) return NULL;
+
+    vfs_node_t* child = (vfs_node_t*)kmem_cache_alloc(vfs_node_cache);
+    if (!child) return NULL;
+
+    memset(child, 0, sizeof(*child));
+    strncpy(child->name, name, VFS_MAX_NAME - 1);
+    child->name[VFS_MAX_NAME - 1] = '\0';
+    child->inode = inode_num;
+    child->length = child_ino.i_size;
+    child->flags = ext2_inode_type_to_vfs_flags(child_ino.i_mode);
+    child->mode = (uint16_t)(child_ino.i_mode & 0777);
+    child->uid = child_ino.i_uid;
+    child->gid = child_ino.i_gid;
+    child->impl = (uint32_t)fs;
+
+    if (child->flags & VFS_DIRECTORY) {
+        child->readdir = ext2_vfs_readdir;
+        child->readdir_next = ext2_vfs_readdir_next;
+        child->finddir = ext2_vfs_finddir;
+    } else {
+        child->read = ext2_vfs_read;
+        child->write = ext2_vfs_write;
+    }
+    if (VFS_IS_SYMLINK(child)) {
+        child->readlink = ext2_vfs_readlink;
+    }
+    child->open = ext2_vfs_open;
+    child->close = ext2_vfs_close;
+
+    child->parent = parent;
+    return child;
+}
+
+/*
+ * Read a symlink target. Fast symlinks (the common case; targets up
+ * to 59 bytes) keep it in the inode's block-pointer area, so no data
+ * block is touched; longer ones store it in the first data block.
+ */
+static int32_t ext2_vfs_readlink(vfs_node_t* node, char* buf, uint32_t size) {
+    ext2_fs_t* fs = (ext2_fs_t*)node->impl;
+    if (!fs || size == 0) return -1;
+
+    ext2_inode_t ino;
+    if (!ext2_read_inode(fs, node->inode, &ino)) return -1;
+    if ((ino.i_mode & EXT2_S_IFMT) != EXT2_S_IFLNK) return -1;
+
+    uint32_t len = ino.i_size;
+    if (len >= size) len = size - 1;
+
+    if (ino.i_blocks == 0) {
+        memcpy(buf, (const char*)ino.i_block, len);
+    } else {
+        if (ino.i_block[0] == 0 || len >= fs->block_size) return -1;
+        uint8_t* block_buf = (uint8_t*)kmalloc(fs->block_size);
+        if (!block_buf) return -1;
+        if (!ext2_read_block(fs, ino.i_block[0], block_buf)) {
+            kfree(block_buf);
+            return -1;
+        }
+        memcpy(buf, block_buf, len);
+        kfree(block_buf);
+    }
+
+    buf[len] = '\0';
+    return (int32_t)len;
+}
+
 static vfs_node_t* ext2_vfs_finddir(vfs_node_t* node, const char* name) {
     if (!name) return NULL;
 
@@ -1308,6 +2604,18 @@ static vfs_node_t* ext2_vfs_finddir(vfs_node_t* node, const char* name) {
     if (!ext2_read_inode(fs, node->inode, &ino)) return NULL;
     if (!(ino.i_mode & EXT2_S_IFDIR)) return NULL;
 
+    /* Indexed path: one hash probe instead of a block scan */
+    ext2_dx_index_t* idx = ext2_dx_lookup(fs, node->inode);
+    if (idx == NULL) {
+        idx = ext2_dx_build(fs, node->inode, &ino);
+    }
+    if (idx != NULL) {
+        uint32_t child_inode = ext2_dx_find(idx, name);
+        if (child_inode == 0) return NULL;
+        return ext2_make_child_node(fs, node, name, child_inode);
+    }
+
+    /* Index unavailable (allocation failure): linear scan fallback */
     uint32_t block_size = fs->block_size;
     uint8_t* block_buf = (uint8_t*)kmalloc(block_size);
     if (!block_buf) return NULL;
@@ -1334,39 +2642,7 @@ static vfs_node_t* ext2_vfs_finddir(vfs_node_t* node, const char* name) {
                 tmp[n] = '\0';
 
                 if (strcmp(tmp, name) == 0) {
-                    ext2_inode_t child_ino;
-                    if (!ext2_read_inode(fs, de->inode, &child_ino)) {
-                        kfree(block_buf);
-                        return NULL;
-                    }
-
-                    vfs_node_t* child = (vfs_node_t*)kmalloc(sizeof(vfs_node_t));
-                    if (!child) {
-                        kfree(block_buf);
-                        return NULL;
-                    }
-
-                    memset(child, 0, sizeof(*child));
-                    strncpy(child->name, tmp, VFS_MAX_NAME - 1);
-                    child->name[VFS_MAX_NAME - 1] = '\0';
-                    child->inode = de->inode;
-                    child->length = child_ino.i_size;
-                    child->flags = ext2_inode_type_to_vfs_flags(child_ino.i_mode);
-                    child->mode = (uint16_t)(child_ino.i_mode & 0777);
-                    child->uid = child_ino.i_uid;
-                    child->gid = child_ino.i_gid;
-                    child->impl = (uint32_t)fs;
-
-                    if (child->flags & VFS_DIRECTORY) {
-                        child->readdir = ext2_vfs_readdir;
-                        child->finddir = ext2_vfs_finddir;
-                    } else {
-                        child->read = ext2_vfs_read;
-                        child->write = ext2_vfs_write;
-                    }
-
-                    child->parent = node;
-
+                    vfs_node_t* child = ext2_make_child_node(fs, node, tmp, de->inode);
                     kfree(block_buf);
                     return child;
                 }
@@ -1409,6 +2685,14 @@ vfs_node_t* ext2_mount(blockdev_t* bdev) {
         return NULL;
     }
 
+    /* Repair after an unclean shutdown before any metadata is read;
+       a replay may rewrite the superblock itself, so re-read it */
+    ext2_jnl_replay(fs);
+    if (!ext2_read_bytes(fs, EXT2_SUPERBLOCK_OFFSET, sizeof(ext2_superblock_t), &fs->sb)) {
+        kfree(fs);
+        return NULL;
+    }
+
     fs->groups_count = (fs->sb.s_blocks_count + fs->sb.s_blocks_per_group - 1) / fs->sb.s_blocks_per_group;
 
     uint32_t gdt_block = (fs->block_size == 1024) ? 2 : 1;
@@ -1425,7 +2709,10 @@ vfs_node_t* ext2_mount(blockdev_t* bdev) {
         return NULL;
     }
 
-    vfs_node_t* root = (vfs_node_t*)kmalloc(sizeof(vfs_node_t));
+    /* Arm the journal (reserving its on-disk area on first mount) */
+    ext2_jnl_setup(fs);
+
+    vfs_node_t* root = (vfs_node_t*)kmem_cache_alloc(vfs_node_cache);
     if (!root) {
         kfree(fs->groups);
         kfree(fs);
@@ -1434,7 +2721,7 @@ vfs_node_t* ext2_mount(blockdev_t* bdev) {
 
     ext2_inode_t root_ino;
     if (!ext2_read_inode(fs, 2, &root_ino)) {
-        kfree(root);
+        kmem_cache_free(vfs_node_cache, root);
         kfree(fs->groups);
         kfree(fs);
         return NULL;
@@ -1450,6 +2737,7 @@ vfs_node_t* ext2_mount(blockdev_t* bdev) {
     root->gid = root_ino.i_gid;
     root->impl = (uint32_t)fs;
     root->readdir = ext2_vfs_readdir;
+    root->readdir_next = ext2_vfs_readdir_next;
     root->finddir = ext2_vfs_finddir;
 
     printk("ext2: mounted blockdev %s (block=%u, groups=%u)\n", bdev->name, fs->block_size, fs->groups_count);
@@ -0,0 +1,341 @@
+/*
+ * MiniOS /proc Pseudo-Filesystem Implementation
+ *
+ * Read-only stats surface for monitoring tools. Nothing is stored:
+ * each read re-renders the node's text into a scratch buffer, so a
+ * poller pays only for the file it reads instead of dragging the
+ * shell's formatting paths into the hot loop.
+ *
+ * Layout:
+ *   /proc/meminfo        physical and heap memory counters
+ *   /proc/uptime         seconds since boot plus raw tick count
+ *   /proc/version        kernel identification
+ *   /proc/<pid>/stat     one parse-friendly line per process
+ *
+ * Lines are "key: value" (meminfo) or space-separated fields (stat),
+ * so both shell builtins and GUI apps can consume them cheaply.
+ */
+
+#include "../include/procfs.h"
+#include "../include/vfs.h"
+#include "../include/string.h"
+#include "../include/stdio.h"
+#include "../include/process.h"
+#include "../include/pmm.h"
+#include "../include/heap.h"
+#include "../include/timer.h"
+#include "../include/user.h"
+
+/* Scratch buffer every read renders into */
+#define PROCFS_BUF_SIZE 1024
+
+/* Top-level generated files (node->impl selects the renderer) */
+#define PROCFS_FILE_MEMINFO 0
+#define PROCFS_FILE_UPTIME  1
+#define PROCFS_FILE_VERSION 2
+#define PROCFS_TOP_FILES    3
+
+static const char* procfs_top_names[PROCFS_TOP_FILES] = {
+    "meminfo", "uptime", "version"
+};
+
+/* Node storage: everything is generated, so nodes are just handles.
+   Per-process nodes are keyed by PCB slot (impl) and validated
+   against the pid recorded in node->inode on every use, so a slot
+   recycled for a new process cannot serve a stale path. */
+static vfs_node_t procfs_root;
+static vfs_node_t procfs_top_nodes[PROCFS_TOP_FILES];
+static vfs_node_t procfs_pid_dirs[MAX_PROCESSES];
+static vfs_node_t procfs_stat_nodes[MAX_PROCESSES];
+
+static dirent_t procfs_dirent;
+static char procfs_buf[PROCFS_BUF_SIZE];
+
+/* Forward declarations */
+static int32_t procfs_top_read(vfs_node_t* node, uint32_t offset, uint32_t size, uint8_t* buffer);
+static int32_t procfs_stat_read(vfs_node_t* node, uint32_t offset, uint32_t size, uint8_t* buffer);
+static dirent_t* procfs_root_readdir(vfs_node_t* node, uint32_t index);
+static vfs_node_t* procfs_root_finddir(vfs_node_t* node, const char* name);
+static dirent_t* procfs_pid_readdir(vfs_node_t* node, uint32_t index);
+static vfs_node_t* procfs_pid_finddir(vfs_node_t* node, const char* name);
+
+/*
+ * 64-by-32 divide via shift-subtract; the kernel links without
+ * libgcc and must not emit __udivdi3 (same helper as timer.c).
+ */
+static uint32_t procfs_udiv64_32(uint64_t dividend, uint32_t divisor) {
+    uint64_t rem = 0;
+    uint32_t quot = 0;
+    for (int bit = 63; bit >= 0; bit--) {
+        rem = (rem << 1) | ((dividend >> bit) & 1);
+        if (rem >= divisor) {
+            rem -= divisor;
+            if (bit < 32) {
+                quot |= 1u << bit;
+            }
+        }
+    }
+    return quot;
+}
+
+/*
+ * Single-letter process state (R = runnable/running, as in ps)
+ */
+static char procfs_state_char(process_state_t state) {
+    switch (state) {
+        case PROCESS_STATE_CREATED: return 'N';
+        case PROCESS_STATE_READY:   return 'R';
+        case PROCESS_STATE_RUNNING: return 'R';
+        case PROCESS_STATE_BLOCKED: return 'S';
+        case PROCESS_STATE_ZOMBIE:  return 'Z';
+        default:                    return '?';
+    }
+}
+
+/*
+ * Render a top-level file into procfs_buf; returns the text length
+ */
+static int procfs_render_top(uint32_t file_id) {
+    int len = 0;
+
+    switch (file_id) {
+        case PROCFS_FILE_MEMINFO: {
+            pmm_stats_t pmm;
+            heap_stats_t heap;
+            pmm_get_stats(&pmm);
+            heap_get_stats(&heap);
+            len = snprintf(procfs_buf, PROCFS_BUF_SIZE,
+                           "MemTotal:    %u kB\n"
+                           "MemFree:     %u kB\n"
+                           "MemUsed:     %u kB\n"
+                           "HeapTotal:   %u kB\n"
+                           "HeapFree:    %u kB\n"
+                           "HeapUsed:    %u kB\n"
+                           "HeapLargest: %u kB\n",
+                           pmm.total_memory / 1024,
+                           pmm.free_memory / 1024,
+                           (pmm.total_memory - pmm.free_memory) / 1024,
+                           heap.total_size / 1024,
+                           heap.free_size / 1024,
+                           heap.used_size / 1024,
+                           heap.largest_free / 1024);
+            break;
+        }
+        case PROCFS_FILE_UPTIME: {
+            uint64_t us = timer_us();
+            uint32_t secs = procfs_udiv64_32(us, 1000000);
+            uint32_t hundredths =
+                procfs_udiv64_32(us - (uint64_t)secs * 1000000, 10000);
+            len = snprintf(procfs_buf, PROCFS_BUF_SIZE,
+                           "%u.%u %u\n", secs, hundredths, timer_get_ticks());
+            break;
+        }
+        case PROCFS_FILE_VERSION:
+            len = snprintf(procfs_buf, PROCFS_BUF_SIZE,
+                           "MiniOS v0.1 i686\n");
+            break;
+        default:
+            break;
+    }
+
+    if (len < 0) {
+        len = 0;
+    }
+    return len;
+}
+
+/*
+ * Render a process stat line into procfs_buf; returns the length.
+ * Fields: pid name state ppid uid gid prio ticks dispatches
+ *         vol_switches invol_switches cpu_user_us cpu_kernel_us
+ */
+static int procfs_render_stat(process_t* proc) {
+    int len = snprintf(procfs_buf, PROCFS_BUF_SIZE,
+                       "%u %s %c %u %u %u %u %u %u %u %u %u %u\n",
+                       proc->pid, proc->name,
+                       procfs_state_char(proc->state),
+                       proc->ppid, proc->uid, proc->gid, proc->priority,
+                       (uint32_t)proc->total_ticks,
+                       proc->dispatches,
+                       proc->vol_switches, proc->invol_switches,
+                       (uint32_t)proc->cpu_user_us,
+                       (uint32_t)proc->cpu_kernel_us);
+    if (len < 0) {
+        len = 0;
+    }
+    return len;
+}
+
+/*
+ * Copy a rendered buffer range out to the reader (EOF past the end)
+ */
+static int32_t procfs_emit(int len, uint32_t offset, uint32_t size, uint8_t* buffer) {
+    if (len <= 0 || offset >= (uint32_t)len) {
+        return 0;
+    }
+    uint32_t to_read = size;
+    if (offset + size > (uint32_t)len) {
+        to_read = (uint32_t)len - offset;
+    }
+    memcpy(buffer, procfs_buf + offset, to_read);
+    return (int32_t)to_read;
+}
+
+/*
+ * Read a top-level file (impl = renderer id)
+ */
+static int32_t procfs_top_read(vfs_node_t* node, uint32_t offset, uint32_t size, uint8_t* buffer) {
+    return procfs_emit(procfs_render_top(node->impl), offset, size, buffer);
+}
+
+/*
+ * Read /proc/<pid>/stat; a pid that exited reads as empty
+ */
+static int32_t procfs_stat_read(vfs_node_t* node, uint32_t offset, uint32_t size, uint8_t* buffer) {
+    process_t* proc = &process_table[node->impl];
+    if (proc->state == PROCESS_STATE_UNUSED || proc->pid != node->inode) {
+        return 0;
+    }
+    return procfs_emit(procfs_render_stat(proc), offset, size, buffer);
+}
+
+/*
+ * Fill one of the generated node handles
+ */
+static void procfs_fill_node(vfs_node_t* node, const char* name, uint32_t flags,
+                             uint32_t inode, uint32_t impl, vfs_node_t* parent) {
+    memset(node, 0, sizeof(vfs_node_t));
+    strncpy(node->name, name, VFS_MAX_NAME - 1);
+    node->name[VFS_MAX_NAME - 1] = '\0';
+    node->flags = flags;
+    node->inode = inode;
+    node->impl = impl;
+    node->parent = parent;
+    node->uid = ROOT_UID;
+    node->gid = ROOT_GID;
+    node->mode = (flags & VFS_DIRECTORY) ? 0555 : 0444;
+}
+
+/*
+ * Build (or refresh) the directory handle for a PCB slot
+ */
+static vfs_node_t* procfs_pid_dir(uint32_t slot) {
+    process_t* proc = &process_table[slot];
+    char name[16];
+    snprintf(name, sizeof(name), "%u", proc->pid);
+
+    vfs_node_t* dir = &procfs_pid_dirs[slot];
+    procfs_fill_node(dir, name, VFS_DIRECTORY, proc->pid, slot, &procfs_root);
+    dir->readdir = procfs_pid_readdir;
+    dir->finddir = procfs_pid_finddir;
+    return dir;
+}
+
+/*
+ * Enumerate /proc: static files first, then live pids
+ */
+static dirent_t* procfs_root_readdir(vfs_node_t* node, uint32_t index) {
+    (void)node;
+
+    if (index < PROCFS_TOP_FILES) {
+        strncpy(procfs_dirent.name, procfs_top_names[index], VFS_MAX_NAME - 1);
+        procfs_dirent.name[VFS_MAX_NAME - 1] = '\0';
+        procfs_dirent.inode = index;
+        return &procfs_dirent;
+    }
+
+    uint32_t want = index - PROCFS_TOP_FILES;
+    for (uint32_t slot = 0; slot < MAX_PROCESSES; slot++) {
+        if (process_table[slot].state == PROCESS_STATE_UNUSED) {
+            continue;
+        }
+        if (want == 0) {
+            snprintf(procfs_dirent.name, VFS_MAX_NAME, "%u",
+                     process_table[slot].pid);
+            procfs_dirent.inode = process_table[slot].pid;
+            return &procfs_dirent;
+        }
+        want--;
+    }
+    return NULL;
+}
+
+/*
+ * Look up a /proc entry by name (static file or decimal pid)
+ */
+static vfs_node_t* procfs_root_finddir(vfs_node_t* node, const char* name) {
+    (void)node;
+
+    for (uint32_t i = 0; i < PROCFS_TOP_FILES; i++) {
+        if (strcmp(name, procfs_top_names[i]) == 0) {
+            return &procfs_top_nodes[i];
+        }
+    }
+
+    /* Decimal pid? */
+    uint32_t pid = 0;
+    const char* p = name;
+    if (*p == '\0') {
+        return NULL;
+    }
+    while (*p) {
+        if (*p < '0' || *p > '9') {
+            return NULL;
+        }
+        pid = pid * 10 + (uint32_t)(*p - '0');
+        p++;
+    }
+
+    for (uint32_t slot = 0; slot < MAX_PROCESSES; slot++) {
+        if (process_table[slot].state != PROCESS_STATE_UNUSED &&
+            process_table[slot].pid == pid) {
+            return procfs_pid_dir(slot);
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Enumerate a pid directory
+ */
+static dirent_t* procfs_pid_readdir(vfs_node_t* node, uint32_t index) {
+    if (index > 0) {
+        return NULL;
+    }
+    strncpy(procfs_dirent.name, "stat", VFS_MAX_NAME - 1);
+    procfs_dirent.name[VFS_MAX_NAME - 1] = '\0';
+    procfs_dirent.inode = node->inode;
+    return &procfs_dirent;
+}
+
+/*
+ * Look up a file inside a pid directory
+ */
+static vfs_node_t* procfs_pid_finddir(vfs_node_t* node, const char* name) {
+    if (strcmp(name, "stat") != 0) {
+        return NULL;
+    }
+    uint32_t slot = node->impl;
+    vfs_node_t* stat_node = &procfs_stat_nodes[slot];
+    procfs_fill_node(stat_node, "stat", VFS_FILE, node->inode, slot, node);
+    stat_node->read = procfs_stat_read;
+    return stat_node;
+}
+
+/*
+ * Initialize procfs and return its root node (for vfs_mount)
+ */
+vfs_node_t* procfs_init(void) {
+    procfs_fill_node(&procfs_root, "proc", VFS_DIRECTORY, 0, 0, NULL);
+    procfs_root.readdir = procfs_root_readdir;
+    procfs_root.finddir = procfs_root_finddir;
+
+    for (uint32_t i = 0; i < PROCFS_TOP_FILES; i++) {
+        procfs_fill_node(&procfs_top_nodes[i], procfs_top_names[i],
+                         VFS_FILE, i, i, &procfs_root);
+        procfs_top_nodes[i].read = procfs_top_read;
+    }
+
+    printk("PROCFS: Initialized\n");
+    return &procfs_root;
+}
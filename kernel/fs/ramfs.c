@@ -1,7 +1,16 @@
 /*
  * MiniOS RAM File System Implementation
- * 
- * Simple in-memory file system.
+ *
+ * In-memory file system with hash-indexed directories and chunked
+ * file storage. Directory lookups hash the name into per-directory
+ * buckets instead of scanning a child array, and file bodies are
+ * stored as fixed-size chunks so an append allocates one new chunk
+ * instead of copying the whole file into a larger buffer.
+ *
+ * Chunks are whole pmm frames, not heap blocks: bulk /tmp data never
+ * fragments the kernel heap, and unlink returns frames wholesale.
+ * Total data pages are capped (tmpfs.conf max_kb, default 16MB) so
+ * a runaway /tmp writer cannot exhaust physical memory.
  */
 
 #include "../include/ramfs.h"
@@ -10,54 +19,208 @@
 #include "../include/stdio.h"
 #include "../include/heap.h"
 #include "../include/user.h"
+#include "../include/pmm.h"
+#include "../include/conf.h"
+
+/* File bodies are split into page-sized chunks backed by pmm frames;
+   the chunk table is allocated on first write and covers the maximum
+   file size. */
+#define RAMFS_CHUNK_SIZE    PAGE_SIZE
+#define RAMFS_MAX_CHUNKS    (RAMFS_MAX_FILE_SIZE / RAMFS_CHUNK_SIZE)
+
+/* Default cap on total file data: 16MB of frames */
+#define RAMFS_DEFAULT_CAP_PAGES ((16 * 1024 * 1024) / PAGE_SIZE)
+
+/* Per-directory name hash buckets (power of two) */
+#define RAMFS_DIR_BUCKETS   16
 
 /* RAM file entry */
-typedef struct {
+typedef struct ramfs_entry {
     vfs_node_t node;
-    uint8_t* data;              /* File contents */
-    uint32_t capacity;          /* Allocated size */
-    struct ramfs_entry* children[RAMFS_MAX_FILES];  /* For directories */
+    bool used;                  /* Slot is allocated */
+
+    /* File storage: table of RAMFS_CHUNK_SIZE chunks, NULL = hole */
+    uint8_t** chunks;
+    uint32_t chunk_count;       /* Chunks currently allocated */
+
+    /* Directory contents: insertion-ordered sibling list for
+       enumeration plus name hash chains for lookup */
+    struct ramfs_entry* child_head;
+    struct ramfs_entry* child_tail;
+    struct ramfs_entry* buckets[RAMFS_DIR_BUCKETS];
     uint32_t child_count;
+
+    /* Links within the parent directory (next_sibling doubles as the
+       free-list link while the slot is unused) */
+    struct ramfs_entry* next_sibling;
+    struct ramfs_entry* hash_next;
 } ramfs_entry_t;
 
-/* File storage */
-static ramfs_entry_t ramfs_files[RAMFS_MAX_FILES];
+/* Entry pool (allocated at init) and free list of deleted slots */
+static ramfs_entry_t* ramfs_files = NULL;
 static uint32_t ramfs_file_count = 0;
+static ramfs_entry_t* ramfs_free_list = NULL;
 static vfs_node_t* ramfs_root_node = NULL;
 
+/* Data-page accounting against the configured cap */
+static uint32_t ramfs_data_pages = 0;
+static uint32_t ramfs_page_cap = RAMFS_DEFAULT_CAP_PAGES;
+static bool ramfs_conf_checked = false;
+
 /* Forward declarations */
 static int32_t ramfs_read(vfs_node_t* node, uint32_t offset, uint32_t size, uint8_t* buffer);
 static int32_t ramfs_write(vfs_node_t* node, uint32_t offset, uint32_t size, uint8_t* buffer);
 dirent_t* ramfs_readdir(vfs_node_t* node, uint32_t index);
+static dirent_t* ramfs_readdir_next(vfs_node_t* node, vfs_dir_cursor_t* cursor);
 static vfs_node_t* ramfs_finddir(vfs_node_t* node, const char* name);
 
 /* Static dirent for readdir */
 static dirent_t ramfs_dirent;
 
 /*
- * Read from a ramfs file
+ * Hash a file name into a directory bucket
+ */
+static uint32_t ramfs_name_hash(const char* name) {
+    uint32_t h = 5381;
+    while (*name) {
+        h = h * 33 + (uint8_t)*name++;
+    }
+    return h & (RAMFS_DIR_BUCKETS - 1);
+}
+
+/*
+ * Link an entry into a directory (sibling list + hash chain)
+ */
+static void ramfs_dir_add(ramfs_entry_t* dir, ramfs_entry_t* entry) {
+    entry->next_sibling = NULL;
+    if (dir->child_tail != NULL) {
+        dir->child_tail->next_sibling = entry;
+    } else {
+        dir->child_head = entry;
+    }
+    dir->child_tail = entry;
+
+    uint32_t bucket = ramfs_name_hash(entry->node.name);
+    entry->hash_next = dir->buckets[bucket];
+    dir->buckets[bucket] = entry;
+
+    dir->child_count++;
+    entry->node.parent = &dir->node;
+}
+
+/*
+ * Unlink an entry from a directory (sibling list + hash chain)
+ */
+static void ramfs_dir_remove(ramfs_entry_t* dir, ramfs_entry_t* entry) {
+    ramfs_entry_t** link = &dir->child_head;
+    ramfs_entry_t* prev = NULL;
+    while (*link != NULL && *link != entry) {
+        prev = *link;
+        link = &(*link)->next_sibling;
+    }
+    if (*link == entry) {
+        *link = entry->next_sibling;
+        if (dir->child_tail == entry) {
+            dir->child_tail = prev;
+        }
+    }
+
+    uint32_t bucket = ramfs_name_hash(entry->node.name);
+    ramfs_entry_t** hlink = &dir->buckets[bucket];
+    while (*hlink != NULL && *hlink != entry) {
+        hlink = &(*hlink)->hash_next;
+    }
+    if (*hlink == entry) {
+        *hlink = entry->hash_next;
+    }
+
+    dir->child_count--;
+}
+
+/*
+ * Re-read the data cap from tmpfs.conf. Called lazily on the first
+ * allocation (conf is not up yet when ramfs_init runs) and again via
+ * conf_subscribe whenever the section is saved. Lowering the cap
+ * below what is already in use only blocks new allocations.
+ */
+static void ramfs_reload_conf(const char* name) {
+    (void)name;
+    conf_section_t sec;
+    if (conf_load(&sec, "tmpfs") == 0) {
+        int max_kb = conf_get_int(&sec, "max_kb",
+                                  (int)(RAMFS_DEFAULT_CAP_PAGES * (PAGE_SIZE / 1024)));
+        if (max_kb < 0) {
+            max_kb = 0;
+        }
+        ramfs_page_cap = (uint32_t)max_kb / (PAGE_SIZE / 1024);
+    }
+}
+
+/*
+ * Allocate one data chunk (a zeroed pmm frame), honoring the cap
+ */
+static uint8_t* ramfs_chunk_alloc(void) {
+    if (!ramfs_conf_checked) {
+        ramfs_conf_checked = true;
+        ramfs_reload_conf("tmpfs");
+    }
+    if (ramfs_data_pages >= ramfs_page_cap) {
+        return NULL;
+    }
+    uint32_t frame = pmm_alloc_frame_zeroed();
+    if (frame == 0) {
+        return NULL;
+    }
+    ramfs_data_pages++;
+    return (uint8_t*)frame;
+}
+
+/*
+ * Return one data chunk's frame to the pmm
+ */
+static void ramfs_chunk_free(uint8_t* chunk) {
+    pmm_free_frame((uint32_t)chunk);
+    ramfs_data_pages--;
+}
+
+/*
+ * Read from a ramfs file (chunk-wise; unallocated chunks read as zeros)
  */
 static int32_t ramfs_read(vfs_node_t* node, uint32_t offset, uint32_t size, uint8_t* buffer) {
     ramfs_entry_t* entry = (ramfs_entry_t*)node;
-    
+
     if (offset >= node->length) {
         return 0;  /* EOF */
     }
-    
+
     uint32_t to_read = size;
     if (offset + size > node->length) {
         to_read = node->length - offset;
     }
-    
-    if (entry->data != NULL) {
-        memcpy(buffer, entry->data + offset, to_read);
+
+    uint32_t done = 0;
+    while (done < to_read) {
+        uint32_t pos = offset + done;
+        uint32_t ci = pos / RAMFS_CHUNK_SIZE;
+        uint32_t coff = pos % RAMFS_CHUNK_SIZE;
+        uint32_t n = RAMFS_CHUNK_SIZE - coff;
+        if (n > to_read - done) {
+            n = to_read - done;
+        }
+        if (entry->chunks != NULL && entry->chunks[ci] != NULL) {
+            memcpy(buffer + done, entry->chunks[ci] + coff, n);
+        } else {
+            memset(buffer + done, 0, n);
+        }
+        done += n;
     }
-    
+
     return (int32_t)to_read;
 }
 
 /*
- * Write to a ramfs file
+ * Write to a ramfs file. Only the chunks the write touches are
+ * allocated, so appending never copies existing data.
  */
 static int32_t ramfs_write(vfs_node_t* node, uint32_t offset, uint32_t size, uint8_t* buffer) {
     ramfs_entry_t* entry = (ramfs_entry_t*)node;
@@ -73,88 +236,142 @@ static int32_t ramfs_write(vfs_node_t* node, uint32_t offset, uint32_t size, uin
         new_size = RAMFS_MAX_FILE_SIZE;
     }
 
-    /* Expand file if needed */
-    if (new_size > entry->capacity) {
-        uint32_t new_capacity = new_size + 256;  /* Extra space */
-        if (new_capacity > RAMFS_MAX_FILE_SIZE) {
-            new_capacity = RAMFS_MAX_FILE_SIZE;
-        }
-
-        uint8_t* new_data = (uint8_t*)kmalloc(new_capacity);
-        if (new_data == NULL) {
+    /* Allocate the chunk table on first write */
+    if (entry->chunks == NULL) {
+        entry->chunks = (uint8_t**)kzalloc(RAMFS_MAX_CHUNKS * sizeof(uint8_t*));
+        if (entry->chunks == NULL) {
             return -1;
         }
+        entry->chunk_count = 0;
+    }
 
-        if (entry->data != NULL) {
-            memcpy(new_data, entry->data, entry->capacity);
-            kfree(entry->data);
+    uint32_t done = 0;
+    while (done < size) {
+        uint32_t pos = offset + done;
+        uint32_t ci = pos / RAMFS_CHUNK_SIZE;
+        uint32_t coff = pos % RAMFS_CHUNK_SIZE;
+        uint32_t n = RAMFS_CHUNK_SIZE - coff;
+        if (n > size - done) {
+            n = size - done;
         }
-
-        entry->data = new_data;
-        entry->capacity = new_capacity;
+        if (entry->chunks[ci] == NULL) {
+            uint8_t* chunk = ramfs_chunk_alloc();
+            if (chunk == NULL) {
+                break;  /* Cap reached or out of frames */
+            }
+            entry->chunks[ci] = chunk;
+            entry->chunk_count++;
+        }
+        memcpy(entry->chunks[ci] + coff, buffer + done, n);
+        done += n;
     }
 
-    /* Write data */
-    memcpy(entry->data + offset, buffer, size);
+    if (done == 0 && size > 0) {
+        return -1;
+    }
 
     /* Update length */
-    if (new_size > node->length) {
-        node->length = new_size;
+    if (offset + done > node->length) {
+        node->length = offset + done;
     }
 
-    return (int32_t)size;
+    return (int32_t)done;
 }
 
 /*
- * Read directory entry
+ * Read directory entry by index (walks the sibling list)
  */
 dirent_t* ramfs_readdir(vfs_node_t* node, uint32_t index) {
     ramfs_entry_t* entry = (ramfs_entry_t*)node;
-    
-    if (index >= entry->child_count) {
+
+    ramfs_entry_t* child = entry->child_head;
+    while (child != NULL && index > 0) {
+        child = child->next_sibling;
+        index--;
+    }
+    if (child == NULL) {
+        return NULL;
+    }
+
+    strncpy(ramfs_dirent.name, child->node.name, VFS_MAX_NAME - 1);
+    ramfs_dirent.name[VFS_MAX_NAME - 1] = '\0';
+    ramfs_dirent.inode = child->node.inode;
+
+    return &ramfs_dirent;
+}
+
+/*
+ * Cursor-based enumeration: fs_block remembers the next sibling so a
+ * full listing is one pass over the list instead of O(n^2) rescans.
+ */
+static dirent_t* ramfs_readdir_next(vfs_node_t* node, vfs_dir_cursor_t* cursor) {
+    ramfs_entry_t* entry = (ramfs_entry_t*)node;
+
+    ramfs_entry_t* child;
+    if (cursor->index == 0) {
+        child = entry->child_head;
+    } else {
+        child = (ramfs_entry_t*)cursor->fs_block;
+    }
+    if (child == NULL) {
         return NULL;
     }
-    
-    ramfs_entry_t* child = (ramfs_entry_t*)entry->children[index];
+
     strncpy(ramfs_dirent.name, child->node.name, VFS_MAX_NAME - 1);
     ramfs_dirent.name[VFS_MAX_NAME - 1] = '\0';
     ramfs_dirent.inode = child->node.inode;
-    
+
+    cursor->index++;
+    cursor->fs_block = (uint32_t)child->next_sibling;
     return &ramfs_dirent;
 }
 
 /*
- * Find entry in directory
+ * Find entry in directory via the name hash chain
  */
 static vfs_node_t* ramfs_finddir(vfs_node_t* node, const char* name) {
     ramfs_entry_t* entry = (ramfs_entry_t*)node;
-    
-    for (uint32_t i = 0; i < entry->child_count; i++) {
-        ramfs_entry_t* child = (ramfs_entry_t*)entry->children[i];
+
+    uint32_t bucket = ramfs_name_hash(name);
+    for (ramfs_entry_t* child = entry->buckets[bucket]; child != NULL; child = child->hash_next) {
         if (strcmp(child->node.name, name) == 0) {
             return &child->node;
         }
     }
-    
+
     return NULL;
 }
 
 /*
- * Allocate a new ramfs entry
+ * Allocate a ramfs entry, reusing deleted slots first
  */
 static ramfs_entry_t* ramfs_alloc_entry(void) {
-    if (ramfs_file_count >= RAMFS_MAX_FILES) {
-        return NULL;
+    ramfs_entry_t* entry;
+    if (ramfs_free_list != NULL) {
+        entry = ramfs_free_list;
+        ramfs_free_list = entry->next_sibling;
+    } else {
+        if (ramfs_file_count >= RAMFS_MAX_FILES) {
+            return NULL;
+        }
+        entry = &ramfs_files[ramfs_file_count++];
     }
-    return &ramfs_files[ramfs_file_count++];
+    memset(entry, 0, sizeof(ramfs_entry_t));
+    entry->used = true;
+    entry->node.inode = (uint32_t)(entry - ramfs_files);
+    return entry;
 }
 
 /*
  * Initialize the RAM filesystem
  */
 vfs_node_t* ramfs_init(void) {
-    memset(ramfs_files, 0, sizeof(ramfs_files));
+    ramfs_files = (ramfs_entry_t*)kzalloc(RAMFS_MAX_FILES * sizeof(ramfs_entry_t));
+    if (ramfs_files == NULL) {
+        return NULL;
+    }
     ramfs_file_count = 0;
+    ramfs_free_list = NULL;
 
     /* Create root directory */
     ramfs_entry_t* root = ramfs_alloc_entry();
@@ -164,11 +381,10 @@ vfs_node_t* ramfs_init(void) {
 
     strncpy(root->node.name, "/", VFS_MAX_NAME);
     root->node.flags = VFS_DIRECTORY;
-    root->node.inode = 0;
     root->node.length = 0;
     root->node.readdir = ramfs_readdir;
+    root->node.readdir_next = ramfs_readdir_next;
     root->node.finddir = ramfs_finddir;
-    root->child_count = 0;
 
     /* Root directory is owned by root with rwxr-xr-x (0755) permissions */
     root->node.uid = ROOT_UID;
@@ -177,7 +393,11 @@ vfs_node_t* ramfs_init(void) {
 
     ramfs_root_node = &root->node;
 
-    printk("RAMFS: Initialized\n");
+    /* Track cap changes saved to tmpfs.conf */
+    conf_subscribe("tmpfs", ramfs_reload_conf);
+
+    printk("RAMFS: Initialized (%u entries, %u-byte chunks)\n",
+           (uint32_t)RAMFS_MAX_FILES, (uint32_t)RAMFS_CHUNK_SIZE);
     return ramfs_root_node;
 }
 
@@ -189,11 +409,6 @@ vfs_node_t* ramfs_create_file_in(vfs_node_t* parent, const char* name, uint32_t
         parent = ramfs_root_node;
     }
 
-    if (parent == ramfs_root_node) {
-        ramfs_entry_t* p = (ramfs_entry_t*)parent;
-        printk("RAMFS: create_file_in(parent='/', before child_count=%u) name='%s'\n", p->child_count, name);
-    }
-
     ramfs_entry_t* entry = ramfs_alloc_entry();
     if (entry == NULL) {
         return NULL;
@@ -202,12 +417,9 @@ vfs_node_t* ramfs_create_file_in(vfs_node_t* parent, const char* name, uint32_t
     strncpy(entry->node.name, name, VFS_MAX_NAME - 1);
     entry->node.name[VFS_MAX_NAME - 1] = '\0';
     entry->node.flags = VFS_FILE | flags;
-    entry->node.inode = ramfs_file_count - 1;
     entry->node.length = 0;
     entry->node.read = ramfs_read;
     entry->node.write = ramfs_write;
-    entry->data = NULL;
-    entry->capacity = 0;
 
     /* Set ownership to current user with rw-r--r-- (0644) permissions */
     entry->node.uid = current_uid;
@@ -215,16 +427,7 @@ vfs_node_t* ramfs_create_file_in(vfs_node_t* parent, const char* name, uint32_t
     entry->node.mode = 0644;  /* rw-r--r-- */
 
     /* Add to parent directory */
-    ramfs_entry_t* parent_entry = (ramfs_entry_t*)parent;
-    if (parent_entry->child_count < RAMFS_MAX_FILES) {
-        parent_entry->children[parent_entry->child_count++] = (struct ramfs_entry*)entry;
-        entry->node.parent = parent;
-    }
-
-    if (parent == ramfs_root_node) {
-        ramfs_entry_t* p = (ramfs_entry_t*)parent;
-        printk("RAMFS: create_file_in(parent='/', after child_count=%u) new_node=%p\n", p->child_count, entry);
-    }
+    ramfs_dir_add((ramfs_entry_t*)parent, entry);
 
     return &entry->node;
 }
@@ -245,12 +448,9 @@ vfs_node_t* ramfs_create_dir_in(vfs_node_t* parent, const char* name) {
     }
 
     /* Check for existing child with same name */
-    ramfs_entry_t* parent_ent = (ramfs_entry_t*)parent;
-    for (uint32_t i = 0; i < parent_ent->child_count; i++) {
-        ramfs_entry_t* child = (ramfs_entry_t*)parent_ent->children[i];
-        if (strcmp(child->node.name, name) == 0 && (child->node.flags & VFS_DIRECTORY)) {
-            return &child->node;
-        }
+    vfs_node_t* existing = ramfs_finddir(parent, name);
+    if (existing != NULL && (existing->flags & VFS_DIRECTORY)) {
+        return existing;
     }
 
     ramfs_entry_t* entry = ramfs_alloc_entry();
@@ -261,11 +461,10 @@ vfs_node_t* ramfs_create_dir_in(vfs_node_t* parent, const char* name) {
     strncpy(entry->node.name, name, VFS_MAX_NAME - 1);
     entry->node.name[VFS_MAX_NAME - 1] = '\0';
     entry->node.flags = VFS_DIRECTORY;
-    entry->node.inode = ramfs_file_count - 1;
     entry->node.length = 0;
     entry->node.readdir = ramfs_readdir;
+    entry->node.readdir_next = ramfs_readdir_next;
     entry->node.finddir = ramfs_finddir;
-    entry->child_count = 0;
 
     /* Set ownership to current user with rwxr-xr-x (0755) permissions */
     entry->node.uid = current_uid;
@@ -273,11 +472,7 @@ vfs_node_t* ramfs_create_dir_in(vfs_node_t* parent, const char* name) {
     entry->node.mode = 0755;  /* rwxr-xr-x */
 
     /* Add to parent directory */
-    ramfs_entry_t* parent_entry2 = (ramfs_entry_t*)parent;
-    if (parent_entry2->child_count < RAMFS_MAX_FILES) {
-        parent_entry2->children[parent_entry2->child_count++] = (struct ramfs_entry*)entry;
-        entry->node.parent = parent;
-    }
+    ramfs_dir_add((ramfs_entry_t*)parent, entry);
 
     return &entry->node;
 }
@@ -290,31 +485,39 @@ int ramfs_delete(vfs_node_t* parent, const char* name) {
     if (!parent || !name) return -1;
     ramfs_entry_t* pent = (ramfs_entry_t*)parent;
 
-    for (uint32_t i = 0; i < pent->child_count; i++) {
-        ramfs_entry_t* child = (ramfs_entry_t*)pent->children[i];
-        if (strcmp(child->node.name, name) == 0) {
-            /* Don't delete non-empty directories */
-            if ((child->node.flags & VFS_DIRECTORY) && child->child_count > 0) {
-                return -1;
-            }
-            /* Free file data if any */
-            if (child->data) {
-                kfree(child->data);
-                child->data = NULL;
-            }
-            /* Clear the entry */
-            child->node.name[0] = '\0';
-            child->node.length = 0;
-            child->capacity = 0;
-            /* Remove from parent's children array by shifting */
-            for (uint32_t j = i; j < pent->child_count - 1; j++) {
-                pent->children[j] = pent->children[j + 1];
+    ramfs_entry_t* child = (ramfs_entry_t*)ramfs_finddir(parent, name);
+    if (child == NULL) {
+        return -1;
+    }
+
+    /* Don't delete non-empty directories */
+    if ((child->node.flags & VFS_DIRECTORY) && child->child_count > 0) {
+        return -1;
+    }
+
+    /* Free file data if any */
+    if (child->chunks != NULL) {
+        for (uint32_t i = 0; i < RAMFS_MAX_CHUNKS; i++) {
+            if (child->chunks[i] != NULL) {
+                ramfs_chunk_free(child->chunks[i]);
             }
-            pent->child_count--;
-            return 0;
         }
+        kfree(child->chunks);
+        child->chunks = NULL;
+        child->chunk_count = 0;
     }
-    return -1;
+
+    /* Unlink from the parent and return the slot to the free list */
+    ramfs_dir_remove(pent, child);
+    child->node.name[0] = '\0';
+    child->node.length = 0;
+    child->used = false;
+    child->next_sibling = ramfs_free_list;
+    ramfs_free_list = child;
+
+    /* Drop any cached lookup of the deleted entry */
+    vfs_dcache_invalidate(parent, name);
+    return 0;
 }
 
 /*
@@ -323,4 +526,3 @@ int ramfs_delete(vfs_node_t* parent, const char* name) {
 vfs_node_t* ramfs_create_dir(const char* name) {
     return ramfs_create_dir_in(ramfs_root_node, name);
 }
-
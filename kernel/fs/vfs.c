@@ -20,6 +20,73 @@ static struct {
 } mount_table[VFS_MAX_MOUNTS];
 static int mount_count = 0;
 
+/*
+ * Name cache (dcache): maps (parent directory, component name) to the
+ * node finddir returned, so hot paths like /bin and the shell's cwd are
+ * resolved without rescanning directory blocks. Entries are evicted LRU
+ * and invalidated when the underlying entry is unlinked or replaced.
+ */
+#define VFS_DCACHE_SIZE 64
+
+typedef struct {
+    vfs_node_t* parent;         /* Resolved directory node (key) */
+    char name[VFS_MAX_NAME];    /* Component name (key) */
+    vfs_node_t* node;           /* Cached finddir result (NULL = free) */
+    uint32_t stamp;             /* Last-use counter for LRU eviction */
+} dcache_entry_t;
+
+static dcache_entry_t dcache[VFS_DCACHE_SIZE];
+static uint32_t dcache_stamp = 0;
+
+static vfs_node_t* dcache_lookup(vfs_node_t* parent, const char* name) {
+    for (int i = 0; i < VFS_DCACHE_SIZE; i++) {
+        dcache_entry_t* e = &dcache[i];
+        if (e->node != NULL && e->parent == parent &&
+            strcmp(e->name, name) == 0) {
+            e->stamp = ++dcache_stamp;
+            return e->node;
+        }
+    }
+    return NULL;
+}
+
+static void dcache_insert(vfs_node_t* parent, const char* name, vfs_node_t* node) {
+    dcache_entry_t* victim = &dcache[0];
+
+    for (int i = 0; i < VFS_DCACHE_SIZE; i++) {
+        dcache_entry_t* e = &dcache[i];
+        if (e->node == NULL) {
+            victim = e;
+            break;
+        }
+        if (e->stamp < victim->stamp) {
+            victim = e;
+        }
+    }
+
+    victim->parent = parent;
+    strncpy(victim->name, name, VFS_MAX_NAME - 1);
+    victim->name[VFS_MAX_NAME - 1] = '\0';
+    victim->node = node;
+    victim->stamp = ++dcache_stamp;
+}
+
+/*
+ * Drop cached entries for (parent, name); a NULL parent drops every
+ * entry with that name. Filesystems call this when an entry is removed
+ * or replaced so stale nodes are never handed out.
+ */
+void vfs_dcache_invalidate(vfs_node_t* parent, const char* name) {
+    for (int i = 0; i < VFS_DCACHE_SIZE; i++) {
+        dcache_entry_t* e = &dcache[i];
+        if (e->node != NULL &&
+            (parent == NULL || e->parent == parent) &&
+            strcmp(e->name, name) == 0) {
+            e->node = NULL;
+        }
+    }
+}
+
  static vfs_node_t* vfs_resolve_mount(vfs_node_t* node) {
      if (node != NULL && (node->flags & VFS_MOUNTPOINT) && node->ptr != NULL) {
          return node->ptr;
@@ -34,6 +101,7 @@ void vfs_init(void) {
     vfs_root = NULL;
     mount_count = 0;
     memset(mount_table, 0, sizeof(mount_table));
+    memset(dcache, 0, sizeof(dcache));
     printk("VFS: Initialized\n");
 }
 
@@ -59,6 +127,100 @@ int32_t vfs_write(vfs_node_t* node, uint32_t offset, uint32_t size, uint8_t* buf
     return node->write(node, offset, size, buffer);
 }
 
+/*
+ * Read into a list of buffers at consecutive offsets. Stops early on
+ * a short or failed segment read.
+ */
+int32_t vfs_readv(vfs_node_t* node, uint32_t offset, const iovec_t* iov, uint32_t iovcnt) {
+    int32_t total = 0;
+
+    for (uint32_t i = 0; i < iovcnt; i++) {
+        if (iov[i].iov_len == 0) {
+            continue;
+        }
+        int32_t n = vfs_read(node, offset + (uint32_t)total,
+                             iov[i].iov_len, (uint8_t*)iov[i].iov_base);
+        if (n < 0) {
+            return (total > 0) ? total : n;
+        }
+        total += n;
+        if ((uint32_t)n < iov[i].iov_len) {
+            break;  /* Short read: end of file */
+        }
+    }
+
+    return total;
+}
+
+/*
+ * Write a list of buffers at consecutive offsets
+ */
+int32_t vfs_writev(vfs_node_t* node, uint32_t offset, const iovec_t* iov, uint32_t iovcnt) {
+    int32_t total = 0;
+
+    for (uint32_t i = 0; i < iovcnt; i++) {
+        if (iov[i].iov_len == 0) {
+            continue;
+        }
+        int32_t n = vfs_write(node, offset + (uint32_t)total,
+                              iov[i].iov_len, (uint8_t*)iov[i].iov_base);
+        if (n < 0) {
+            return (total > 0) ? total : n;
+        }
+        total += n;
+        if ((uint32_t)n < iov[i].iov_len) {
+            break;  /* Short write: device full */
+        }
+    }
+
+    return total;
+}
+
+/* Copy chunk size: multiple of every supported fs block size, large
+   enough that a megabyte file moves in sixteen read/write pairs */
+#define VFS_COPY_BUF_SIZE (64 * 1024)
+
+/*
+ * Streaming copy engine shared by cp, cross-filesystem moves, and the
+ * GUI file manager. One heap buffer is reused for the whole transfer;
+ * the filesystems underneath see large aligned requests they can turn
+ * into multi-block I/O.
+ */
+int32_t vfs_copy_file(vfs_node_t* src, vfs_node_t* dest, vfs_copy_progress_t progress) {
+    uint32_t buf_size = VFS_COPY_BUF_SIZE;
+    uint8_t* buf = (uint8_t*)kmalloc(buf_size);
+    if (buf == NULL) {
+        /* Degrade rather than fail outright when the heap is tight */
+        buf_size = 4096;
+        buf = (uint8_t*)kmalloc(buf_size);
+        if (buf == NULL) {
+            return -1;
+        }
+    }
+
+    uint32_t total = src != NULL ? src->length : 0;
+    uint32_t offset = 0;
+    int32_t n;
+
+    while ((n = vfs_read(src, offset, buf_size, buf)) > 0) {
+        int32_t written = vfs_write(dest, offset, (uint32_t)n, buf);
+        if (written < 0) {
+            kfree(buf);
+            return -1;
+        }
+        offset += (uint32_t)n;
+        if (progress != NULL) {
+            progress(offset, total);
+        }
+        if ((uint32_t)n < buf_size) {
+            break;  /* Short read: end of file */
+        }
+    }
+
+    kfree(buf);
+    return (n < 0) ? -1 : (int32_t)offset;
+}
+
 /*
  * Open a file
  */
@@ -98,6 +260,39 @@ dirent_t* vfs_readdir(vfs_node_t* node, uint32_t index) {
     return node->readdir(node, index);
 }
 
+/*
+ * Open a directory cursor positioned at the first entry
+ */
+int vfs_opendir(vfs_node_t* node, vfs_dir_cursor_t* cursor) {
+     node = vfs_resolve_mount(node);
+    if (node == NULL || !(node->flags & VFS_DIRECTORY)) {
+        return -1;
+    }
+    cursor->node = node;
+    cursor->index = 0;
+    cursor->fs_block = 0;
+    cursor->fs_offset = 0;
+    return 0;
+}
+
+/*
+ * Read the next directory entry at the cursor
+ */
+dirent_t* vfs_readdir_next(vfs_dir_cursor_t* cursor) {
+    vfs_node_t* node = cursor->node;
+    if (node == NULL || !(node->flags & VFS_DIRECTORY)) {
+        return NULL;
+    }
+    if (node->readdir_next != NULL) {
+        return node->readdir_next(node, cursor);
+    }
+    /* Fallback: indexed readdir (fine for in-memory filesystems) */
+    if (node->readdir == NULL) {
+        return NULL;
+    }
+    return node->readdir(node, cursor->index++);
+}
+
 /*
  * Find entry in directory
  */
@@ -106,37 +301,60 @@ vfs_node_t* vfs_finddir(vfs_node_t* node, const char* name) {
     if (node == NULL || !(node->flags & VFS_DIRECTORY) || node->finddir == NULL) {
         return NULL;
     }
-    return node->finddir(node, name);
+
+    /* Hot path: repeated lookups hit the name cache */
+    vfs_node_t* cached = dcache_lookup(node, name);
+    if (cached != NULL) {
+        return cached;
+    }
+
+    vfs_node_t* child = node->finddir(node, name);
+    if (child != NULL) {
+        dcache_insert(node, name, child);
+    }
+    return child;
 }
 
 /*
- * Lookup a path and return the VFS node
+ * Read a symlink's target into buf (NUL-terminated)
  */
-vfs_node_t* vfs_lookup(const char* path) {
-    if (path == NULL || path[0] == '\0') {
+int32_t vfs_readlink(vfs_node_t* node, char* buf, uint32_t size) {
+    if (node == NULL || buf == NULL || size == 0) return -1;
+    if (!VFS_IS_SYMLINK(node) || node->readlink == NULL) return -1;
+    return node->readlink(node, buf, size);
+}
+
+static vfs_node_t* vfs_walk(vfs_node_t* dir, const char* p, int depth);
+
+/*
+ * Resolve a symlink to its target node. Relative targets start at
+ * the link's directory, absolute ones at the root; depth bounds
+ * chained links so a cycle terminates instead of looping.
+ */
+static vfs_node_t* vfs_follow_link(vfs_node_t* dir, vfs_node_t* link, int depth) {
+    if (depth >= VFS_LINK_MAX) {
         return NULL;
     }
-    
-    /* Must start with / */
-    if (path[0] != '/') {
+
+    char target[VFS_MAX_PATH];
+    if (vfs_readlink(link, target, sizeof(target)) < 0) {
         return NULL;
     }
-    
-    /* Root path */
-    if (path[1] == '\0') {
-        return vfs_root;
-    }
-    
-    /* Start from root */
-    vfs_node_t* current = vfs_resolve_mount(vfs_root);
-    if (current == NULL) {
-        return NULL;
+
+    if (target[0] == '/') {
+        vfs_node_t* root = vfs_resolve_mount(vfs_root);
+        return root ? vfs_walk(root, target + 1, depth + 1) : NULL;
     }
-    
-    /* Parse path components */
+    return vfs_walk(dir, target, depth + 1);
+}
+
+/*
+ * Walk a relative path from dir, following symlinks as they are met
+ */
+static vfs_node_t* vfs_walk(vfs_node_t* dir, const char* p, int depth) {
+    vfs_node_t* current = dir;
     char component[VFS_MAX_NAME];
-    const char* p = path + 1;  /* Skip leading / */
-    
+
     while (*p != '\0' && current != NULL) {
         /* Extract next component */
         int i = 0;
@@ -144,25 +362,63 @@ vfs_node_t* vfs_lookup(const char* path) {
             component[i++] = *p++;
         }
         component[i] = '\0';
-        
+
         /* Skip trailing slash */
         if (*p == '/') {
             p++;
         }
-        
+
         /* Empty component (double slash) */
         if (i == 0) {
             continue;
         }
-        
+
         /* Look up component in current directory */
-        current = vfs_finddir(current, component);
+        vfs_node_t* parent = current;
+        current = vfs_finddir(parent, component);
         current = vfs_resolve_mount(current);
+
+        if (current != NULL && VFS_IS_SYMLINK(current)) {
+            current = vfs_follow_link(parent, current, depth);
+            if (current != NULL) {
+                /* Cache the resolved target under the link's name so
+                   repeat lookups skip the whole resolution */
+                vfs_dcache_invalidate(parent, component);
+                dcache_insert(parent, component, current);
+            }
+        }
     }
-    
+
     return current;
 }
 
+/*
+ * Lookup a path and return the VFS node
+ */
+vfs_node_t* vfs_lookup(const char* path) {
+    if (path == NULL || path[0] == '\0') {
+        return NULL;
+    }
+
+    /* Must start with / */
+    if (path[0] != '/') {
+        return NULL;
+    }
+
+    /* Root path */
+    if (path[1] == '\0') {
+        return vfs_root;
+    }
+
+    /* Start from root */
+    vfs_node_t* current = vfs_resolve_mount(vfs_root);
+    if (current == NULL) {
+        return NULL;
+    }
+
+    return vfs_walk(current, path + 1, 0);
+}
+
 /*
  * Alias for vfs_lookup
  */
@@ -205,31 +461,66 @@ int vfs_mount(const char* path, vfs_node_t* fs_root) {
     return 0;
 }
 
+/*
+ * Permission verdict cache. Workloads like `ls -l` and shell
+ * pipelines re-check the same node for the same credentials over and
+ * over; the full check walks group membership per call. Each node
+ * remembers its R/W/X verdicts, stamped with a global credential
+ * generation that login/logout/su bump (vfs_perm_invalidate), so a
+ * stale verdict is never honored. chmod/chown clear the node's own
+ * cache. The generation starts at 1 so freshly zeroed nodes are
+ * always treated as unknown.
+ */
+static uint32_t perm_generation = 1;
+
+void vfs_perm_invalidate(void) {
+    perm_generation++;
+}
+
+/*
+ * Cached permission check for the current user; recomputes and
+ * caches the verdict bit on a miss.
+ */
+static int check_cached(vfs_node_t* node, uint8_t access) {
+    if (node == NULL) return 0;
+
+    if (node->perm_gen != perm_generation) {
+        node->perm_known = 0;
+        node->perm_gen = perm_generation;
+    }
+
+    if (!(node->perm_known & access)) {
+        if (check_permission(node->uid, node->gid, node->mode,
+                             current_uid, current_gid, access)) {
+            node->perm_ok |= access;
+        } else {
+            node->perm_ok &= (uint8_t)~access;
+        }
+        node->perm_known |= access;
+    }
+
+    return (node->perm_ok & access) != 0;
+}
+
 /*
  * Check read permission for current user
  */
 int vfs_check_read(vfs_node_t* node) {
-    if (node == NULL) return 0;
-    return check_permission(node->uid, node->gid, node->mode,
-                           current_uid, current_gid, PERM_READ);
+    return check_cached(node, PERM_READ);
 }
 
 /*
  * Check write permission for current user
  */
 int vfs_check_write(vfs_node_t* node) {
-    if (node == NULL) return 0;
-    return check_permission(node->uid, node->gid, node->mode,
-                           current_uid, current_gid, PERM_WRITE);
+    return check_cached(node, PERM_WRITE);
 }
 
 /*
  * Check execute permission for current user
  */
 int vfs_check_exec(vfs_node_t* node) {
-    if (node == NULL) return 0;
-    return check_permission(node->uid, node->gid, node->mode,
-                           current_uid, current_gid, PERM_EXEC);
+    return check_cached(node, PERM_EXEC);
 }
 
 /*
@@ -244,6 +535,7 @@ int vfs_chmod(vfs_node_t* node, uint16_t mode) {
     }
 
     node->mode = mode & 0777;  /* Only permission bits */
+    node->perm_known = 0;      /* Cached verdicts are stale now */
     return 0;
 }
 
@@ -260,6 +552,7 @@ int vfs_chown(vfs_node_t* node, uint32_t uid, uint32_t gid) {
 
     node->uid = uid;
     node->gid = gid;
+    node->perm_known = 0;      /* Cached verdicts are stale now */
     return 0;
 }
 
@@ -48,6 +48,8 @@
 #define ATA_CMD_READ_PIO_EXT    0x24
 #define ATA_CMD_WRITE_PIO       0x30
 #define ATA_CMD_WRITE_PIO_EXT   0x34
+#define ATA_CMD_READ_DMA        0xC8
+#define ATA_CMD_WRITE_DMA       0xCA
 #define ATA_CMD_CACHE_FLUSH     0xE7
 #define ATA_CMD_CACHE_FLUSH_EXT 0xEA
 #define ATA_CMD_IDENTIFY        0xEC
@@ -100,10 +102,10 @@ ata_drive_t* ata_get_drive(uint8_t drive_num);
 uint8_t ata_get_drive_count(void);
 
 /* Read sectors from drive (28-bit LBA) */
-bool ata_read_sectors(uint8_t drive_num, uint32_t lba, uint8_t count, void* buffer);
+bool ata_read_sectors(uint8_t drive_num, uint32_t lba, uint16_t count, void* buffer);
 
 /* Write sectors to drive (28-bit LBA) */
-bool ata_write_sectors(uint8_t drive_num, uint32_t lba, uint8_t count, const void* buffer);
+bool ata_write_sectors(uint8_t drive_num, uint32_t lba, uint16_t count, const void* buffer);
 
 /* Flush drive cache */
 bool ata_flush(uint8_t drive_num);
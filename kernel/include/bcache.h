@@ -0,0 +1,84 @@
+/*
+ * MiniOS Buffer Cache Header
+ *
+ * Sector cache shared by all block devices. Sits inside the blockdev
+ * layer so every consumer (ext2, MBR probing, future filesystems)
+ * sees the same cached data instead of issuing duplicate disk I/O.
+ */
+
+#ifndef _BCACHE_H
+#define _BCACHE_H
+
+#include "types.h"
+#include "blockdev.h"
+
+/* Number of cached sectors (x 512 bytes of data each) */
+#define BCACHE_NUM_BUFFERS  256
+
+/* Hash buckets for lba lookup */
+#define BCACHE_HASH_SIZE    64
+
+/* Reads of more than this many sectors bypass the cache */
+#define BCACHE_BYPASS_COUNT 8
+
+/* One cached sector */
+typedef struct bcache_buf {
+    blockdev_t* dev;            /* Owning device (resolved, not partition) */
+    uint32_t lba;               /* Absolute sector number on dev */
+    bool valid;                 /* Holds data? */
+    bool dirty;                 /* Modified since last write-out? */
+    uint32_t stamp;             /* Last-use counter for LRU eviction */
+    struct bcache_buf* hash_next;
+    uint8_t data[BLOCKDEV_SECTOR_SIZE];
+} bcache_buf_t;
+
+/* Cache statistics */
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t writebacks;
+} bcache_stats_t;
+
+/*
+ * Initialize the buffer cache (needs the heap)
+ */
+void bcache_init(void);
+
+/*
+ * Read one sector through the cache
+ */
+bool bcache_read(blockdev_t* dev, uint32_t lba, void* buffer);
+
+/*
+ * Read a run of sectors through the cache; cold runs are fetched
+ * with one multi-sector driver command
+ */
+bool bcache_read_multi(blockdev_t* dev, uint32_t lba, uint32_t count, void* buffer);
+
+/*
+ * Write one sector through the cache
+ */
+bool bcache_write(blockdev_t* dev, uint32_t lba, const void* buffer);
+
+/*
+ * Write out dirty sectors in LBA-sorted order; dev == NULL syncs
+ * every device
+ */
+bool bcache_sync(blockdev_t* dev);
+
+/*
+ * Number of dirty sectors waiting for write-out
+ */
+uint32_t bcache_dirty_count(void);
+
+/*
+ * Drop all cached sectors for a device (e.g. after a bypass write)
+ */
+void bcache_invalidate(blockdev_t* dev);
+
+/*
+ * Get hit/miss counters
+ */
+void bcache_get_stats(bcache_stats_t* stats);
+
+#endif /* _BCACHE_H */
@@ -51,6 +51,25 @@ typedef struct {
     bool (*flush)(struct blockdev* dev);
 } blockdev_ops_t;
 
+/*
+ * Per-device I/O statistics. Latency histograms are log2-bucketed in
+ * microseconds: bucket n counts operations that took [2^n, 2^(n+1))
+ * us, with the last bucket open-ended. I/O on a partition is also
+ * counted on its parent disk, like the request itself.
+ */
+#define BLOCKDEV_LAT_BUCKETS 16
+
+typedef struct {
+    uint32_t reads;             /* Completed read calls */
+    uint32_t writes;            /* Completed write calls */
+    uint32_t read_sectors;      /* Sectors read */
+    uint32_t write_sectors;     /* Sectors written */
+    uint32_t queue_depth;       /* Async requests currently queued */
+    uint32_t queue_max;         /* High-water mark of queue_depth */
+    uint32_t read_lat[BLOCKDEV_LAT_BUCKETS];
+    uint32_t write_lat[BLOCKDEV_LAT_BUCKETS];
+} blockdev_stats_t;
+
 /* Partition information */
 typedef struct {
     bool active;                /* Bootable flag */
@@ -83,6 +102,9 @@ typedef struct blockdev {
     /* Partition table (for whole disks) */
     uint8_t partition_count;
     partition_info_t partitions[BLOCKDEV_MAX_PARTITIONS];
+
+    /* I/O accounting */
+    blockdev_stats_t stats;
 } blockdev_t;
 
 /* Initialize block device subsystem */
@@ -115,6 +137,45 @@ bool blockdev_write(blockdev_t* dev, uint32_t lba, uint32_t count, const void* b
 /* Flush block device cache */
 bool blockdev_flush(blockdev_t* dev);
 
+/*
+ * Asynchronous I/O requests. A submitted request is queued in
+ * elevator (LBA) order and serviced by the kiod daemon, so readahead
+ * and background flushes overlap with foreground work instead of
+ * serializing behind it. A request carries EITHER a completion
+ * callback (fire-and-forget: the callback owns the request and its
+ * buffer) OR a waiter that calls blockdev_request_wait() - not both.
+ */
+struct blockdev_request;
+typedef void (*blockdev_done_fn_t)(struct blockdev_request* req);
+
+typedef struct blockdev_request {
+    blockdev_t* dev;            /* Target device (may be a partition) */
+    bool write;                 /* false = read, true = write */
+    uint32_t lba;               /* First sector, relative to dev */
+    uint32_t count;             /* Sector count */
+    void* buffer;               /* Data buffer (count * sector_size) */
+    blockdev_done_fn_t callback; /* Runs in kiod when done (may be NULL) */
+    void* context;              /* Opaque pointer for the callback */
+
+    /* Filled in by the queue */
+    volatile bool done;         /* Request has completed */
+    volatile bool ok;           /* Completion status */
+    uint32_t sort_lba;          /* Absolute LBA for elevator ordering */
+    struct blockdev_request* next;
+} blockdev_request_t;
+
+/* Queue a request; completes synchronously before the scheduler runs */
+void blockdev_submit(blockdev_request_t* req);
+
+/* Block until a waited-on request completes; returns its status */
+bool blockdev_request_wait(blockdev_request_t* req);
+
+/* Service one queued request (kiod); false if the queue was empty */
+bool blockdev_queue_service(void);
+
+/* Park the calling daemon until a request is submitted */
+void blockdev_queue_park(void);
+
 /* Probe and parse partition table */
 int blockdev_probe_partitions(blockdev_t* dev);
 
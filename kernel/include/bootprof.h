@@ -0,0 +1,36 @@
+/*
+ * MiniOS Boot Profiler
+ *
+ * Records a TSC timestamp at the end of each boot stage so the cost of
+ * individual init steps (ATA identify, font setup, ...) can be measured.
+ * The table is printed by the `bootchart` shell command and published
+ * as /proc/bootchart.
+ */
+
+#ifndef _BOOTPROF_H
+#define _BOOTPROF_H
+
+#include "types.h"
+
+/* Maximum number of recorded boot stages */
+#define BOOTPROF_MAX_STAGES 32
+
+/*
+ * Record the completion of a boot stage.
+ * The name must be a string literal (it is stored by pointer).
+ */
+void bootprof_stamp(const char* name);
+
+/*
+ * Format the boot profile table into buf (null-terminated).
+ * Returns the number of characters written.
+ */
+int bootprof_format(char* buf, int size);
+
+/*
+ * Publish the boot profile as /proc/bootchart (creates /proc if needed).
+ * Safe to call more than once; later calls rewrite the file.
+ */
+void bootprof_publish(void);
+
+#endif /* _BOOTPROF_H */
@@ -17,6 +17,10 @@
 #define CONF_MAX_ENTRIES    32
 #define CONF_BASE_DIR       "/mnt/conf"
 
+/* Parsed-section cache and change-notification limits */
+#define CONF_CACHE_SLOTS        4
+#define CONF_MAX_SUBSCRIBERS    8
+
 /* A single key=value entry */
 typedef struct {
     char key[CONF_MAX_KEY];
@@ -31,6 +35,9 @@ typedef struct {
     bool dirty;
 } conf_section_t;
 
+/* Called after a section is saved (or invalidated); name is the section */
+typedef void (*conf_notify_fn_t)(const char* name);
+
 /*
  * Initialize the config system.
  * Creates /mnt/conf/ directory if it doesn't exist.
@@ -39,11 +46,27 @@ typedef struct {
 int conf_init(void);
 
 /*
- * Load a config section from disk (e.g. "gui" loads /mnt/conf/gui.conf).
+ * Load a config section (e.g. "gui" loads /mnt/conf/gui.conf).
+ * Parsed sections are cached in memory, so repeat loads of a hot
+ * section are a copy instead of a disk read and re-parse.
  * Returns 0 on success, -1 on error (file may not exist yet, which is OK).
  */
 int conf_load(conf_section_t* section, const char* name);
 
+/*
+ * Subscribe to changes of a section: fn is called with the section
+ * name after every conf_save() of it (and on conf_invalidate()).
+ * Returns 0 on success, -1 when the subscriber table is full.
+ */
+int conf_subscribe(const char* name, conf_notify_fn_t fn);
+
+/*
+ * Drop a section from the cache and notify its subscribers; pass NULL
+ * to drop everything. Needed only when a .conf file is modified
+ * behind conf_save()'s back (e.g. edited from the shell).
+ */
+void conf_invalidate(const char* name);
+
 /*
  * Save a config section to disk.
  * Returns 0 on success, -1 on error.
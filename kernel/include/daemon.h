@@ -95,6 +95,8 @@ void init_daemon(void);      /* PID 1 - init process */
 void klogd_daemon(void);     /* Kernel log daemon */
 void crond_daemon(void);     /* Cron daemon */
 void kswapd_daemon(void);    /* Memory management daemon */
+void bflushd_daemon(void);   /* Dirty buffer flusher daemon */
+void kiod_daemon(void);      /* Async block I/O daemon */
 
 #endif /* _DAEMON_H */
 
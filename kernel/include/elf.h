@@ -120,13 +120,47 @@ bool elf_validate(const elf32_ehdr_t* ehdr);
  */
 int elf_load(const void* data, size_t size, uint32_t* entry);
 
+/* Forward declaration (avoids pulling process.h into every user) */
+struct process;
+
+/*
+ * Map an ELF executable from VFS into a process's address space.
+ * Segments are recorded as VMA descriptors on proc and demand-paged
+ * from the file on first access; pass proc = NULL to force the eager
+ * whole-image load.
+ * Returns: 0 on success, -1 on error
+ */
+int elf_map_file(const char* path, struct process* proc, uint32_t* entry);
+
 /*
- * Load an ELF executable from VFS
+ * Load an ELF executable from VFS into the current process
  * path: path to executable
  * entry: output pointer to store entry point
  * Returns: 0 on success, -1 on error
  */
 int elf_load_file(const char* path, uint32_t* entry);
 
+/*
+ * Parse a binary into the program cache ahead of its first launch
+ * (boot-time preload). Returns 0 on success, -1 on error.
+ */
+int elf_preparse_file(const char* path);
+
+/*
+ * Fault in one page of a demand-paged segment of the current process
+ * Returns true if the fault was resolved and the access can be retried
+ */
+bool elf_handle_fault(uint32_t fault_addr);
+
+/*
+ * Copy VMA descriptors from src to dst (fork), pinning the backing files
+ */
+void elf_clone_vmas(struct process* dst, const struct process* src);
+
+/*
+ * Release a process's VMA descriptors and unpin their backing files
+ */
+void elf_release_vmas(struct process* proc);
+
 #endif /* _ELF_H */
 
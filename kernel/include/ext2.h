@@ -8,6 +8,8 @@
 vfs_node_t* ext2_mount(blockdev_t* bdev);
 vfs_node_t* ext2_create_file(vfs_node_t* parent, const char* name);
 vfs_node_t* ext2_create_dir(vfs_node_t* parent, const char* name);
+vfs_node_t* ext2_create_symlink(vfs_node_t* parent, const char* name, const char* target);
+vfs_node_t* ext2_create_hardlink(vfs_node_t* parent, const char* name, vfs_node_t* target);
 bool ext2_unlink(vfs_node_t* parent, const char* name);
 
 /* For filesystem type detection */
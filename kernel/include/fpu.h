@@ -0,0 +1,43 @@
+/*
+ * MiniOS Lazy FPU/SSE Context Switching
+ *
+ * The FPU is switched lazily: a context switch only sets CR0.TS, and
+ * the first FPU/SSE instruction a process then executes traps through
+ * the device-not-available exception (#NM, vector 7), where the old
+ * owner's state is saved and the new owner's restored. Processes that
+ * never touch the FPU never pay for the 512-byte FXSAVE image.
+ */
+
+#ifndef _FPU_H
+#define _FPU_H
+
+#include "types.h"
+
+struct process;
+
+/*
+ * Detect FXSR/SSE, install the #NM handler, and arm CR0.TS.
+ * Call after the IDT is set up.
+ */
+void fpu_init(void);
+
+/*
+ * Arm or disarm the #NM trap for the process about to run: cheap CR0
+ * update only, no state is moved. Called by schedule() before the
+ * context switch.
+ */
+void fpu_on_switch(struct process* next);
+
+/*
+ * Forget a dying process's FPU ownership (called when its slot is
+ * released)
+ */
+void fpu_release(struct process* proc);
+
+/*
+ * Copy the parent's current FPU state into a forked child, flushing
+ * the hardware registers first if the parent owns them
+ */
+void fpu_fork(struct process* parent, struct process* child);
+
+#endif /* _FPU_H */
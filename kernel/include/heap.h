@@ -2,7 +2,7 @@
  * MiniOS Kernel Heap Header
  * 
  * Provides dynamic memory allocation for the kernel.
- * Uses a simple first-fit free list allocator.
+ * Uses a segregated-fit allocator with power-of-two size classes.
  */
 
 #ifndef _HEAP_H
@@ -15,11 +15,19 @@
 #define HEAP_MAX_SIZE       (512 * 1024 * 1024) /* 512MB max heap */
 #define HEAP_MIN_BLOCK      32              /* Minimum block size */
 
+/*
+ * Size classes: class i covers blocks of total size HEAP_CLASS_SIZE(i).
+ * The last class is an overflow list for anything 32 << 14 and above.
+ */
+#define HEAP_NUM_CLASSES    16
+#define HEAP_CLASS_SIZE(i)  ((size_t)HEAP_MIN_BLOCK << (i))
+
 /* Heap block header */
 typedef struct heap_block {
     uint32_t size;              /* Size of block (including header) */
     uint32_t magic;             /* Magic number for validation */
     struct heap_block* next;    /* Next free block (only valid if free) */
+    uint32_t caller;            /* EIP of the allocation site (0 if free) */
     bool is_free;               /* Is this block free? */
 } __attribute__((packed)) heap_block_t;
 
@@ -74,10 +82,22 @@ typedef struct {
     uint32_t free_size;         /* Free memory */
     uint32_t block_count;       /* Total number of blocks */
     uint32_t free_block_count;  /* Number of free blocks */
+    uint32_t largest_free;      /* Largest single free block */
 } heap_stats_t;
 
 void heap_get_stats(heap_stats_t* stats);
 
+/*
+ * Dump per-size-class allocation counters (total/live) via printk
+ */
+void heap_dump_classes(void);
+
+/*
+ * Walk the heap and aggregate live allocations by caller EIP, so a
+ * leaking allocation site shows up as a growing byte count
+ */
+void heap_dump_sites(void);
+
 /*
  * Print heap statistics (for debugging)
  */
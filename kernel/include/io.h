@@ -66,5 +66,38 @@ static inline void io_wait(void) {
     __asm__ volatile("outb %%al, $0x80" : : "a"(0));
 }
 
+/* Interrupts-off watchdog hooks (kernel/lib/irqwatch.c) */
+void irqwatch_enter(uint32_t caller_eip);
+void irqwatch_leave(void);
+
+/*
+ * Disable interrupts, returning the previous EFLAGS. Use with
+ * irq_restore instead of bare cli/sti around short critical sections:
+ * nesting is safe (the inner pair sees IF already clear and does
+ * nothing), and each masked window is timestamped and charged to the
+ * call site's EIP by the irqwatch watchdog.
+ */
+static inline uint32_t irq_save(void) {
+    uint32_t eflags;
+    __asm__ volatile("pushf; pop %0; cli" : "=r"(eflags));
+    if (eflags & 0x200) {
+        uint32_t eip;
+        __asm__ volatile("call 1f; 1: pop %0" : "=r"(eip));
+        irqwatch_enter(eip);
+    }
+    return eflags;
+}
+
+/*
+ * Restore EFLAGS saved by irq_save (re-enables interrupts only if
+ * they were on before the save)
+ */
+static inline void irq_restore(uint32_t eflags) {
+    if (eflags & 0x200) {
+        irqwatch_leave();
+        __asm__ volatile("sti");
+    }
+}
+
 #endif /* _IO_H */
 
@@ -0,0 +1,33 @@
+/*
+ * MiniOS Interrupts-Off Watchdog
+ *
+ * irq_save/irq_restore (io.h) timestamp the moment interrupts go off
+ * and come back on; each masked window is charged to the EIP of the
+ * disabling call site in a small top-N table. The `irqwatch` shell
+ * command dumps the worst offenders; addresses are resolved against
+ * the linker map (build/kernel.bin.map).
+ */
+
+#ifndef _IRQWATCH_H
+#define _IRQWATCH_H
+
+#include "types.h"
+
+/* Tracked call sites (worst offenders evict the mildest entry) */
+#define IRQWATCH_SLOTS 16
+
+/* Arm the watchdog (call after timer_init; windows before that are
+ * ignored because there is no time source to measure them with) */
+void irqwatch_init(void);
+
+/* Window open/close hooks, called by irq_save/irq_restore in io.h */
+void irqwatch_enter(uint32_t caller_eip);
+void irqwatch_leave(void);
+
+/* Clear the offender table */
+void irqwatch_reset(void);
+
+/* Print the offender table via printk, worst window first */
+void irqwatch_report(void);
+
+#endif /* _IRQWATCH_H */
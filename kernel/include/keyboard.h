@@ -76,5 +76,11 @@ void keyboard_set_callback(keyboard_callback_t callback);
 /* Get current modifier state */
 uint16_t keyboard_get_modifiers(void);
 
+/* IRQ1 count since boot */
+uint32_t keyboard_irq_count(void);
+
+/* Keys dropped because the event ring was full */
+uint32_t keyboard_overrun_count(void);
+
 #endif /* _KEYBOARD_H */
 
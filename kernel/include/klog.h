@@ -0,0 +1,78 @@
+/*
+ * MiniOS Kernel Log Ring Buffer
+ *
+ * Fixed-size binary record ring for kernel messages. A record stores
+ * the timestamp, level, subsystem and the *unformatted* format string
+ * pointer plus its captured arguments; the text is only rendered when
+ * dmesg reads the log, so logging that nobody looks at costs a copy
+ * of a few words. Messages below the runtime level cost one compare.
+ */
+
+#ifndef _KLOG_H
+#define _KLOG_H
+
+#include "types.h"
+
+/* Log levels (lower = more severe) */
+#define KLOG_ERR        0
+#define KLOG_WARN       1
+#define KLOG_INFO       2
+#define KLOG_DEBUG      3
+
+/* Subsystem ids (rendered as a tag in dmesg output) */
+#define KLOG_SUB_KERN   0
+#define KLOG_SUB_MM     1
+#define KLOG_SUB_PROC   2
+#define KLOG_SUB_FS     3
+#define KLOG_SUB_BLK    4
+#define KLOG_SUB_DRV    5
+#define KLOG_SUB_GUI    6
+#define KLOG_SUB_DAEMON 7
+#define KLOG_NUM_SUBS   8
+
+/* Ring geometry */
+#define KLOG_RECORDS    256     /* Records kept (oldest overwritten) */
+#define KLOG_MAX_ARGS   6       /* Captured argument words */
+#define KLOG_STR_BYTES  24      /* Inline pool for %s argument copies */
+
+/*
+ * One binary log record. Format strings in the kernel are static, so
+ * only the pointer is stored; %s arguments are copied into strbuf at
+ * log time because the pointed-at text may not outlive the call.
+ */
+typedef struct {
+    uint64_t us;                /* timer_us() at log time */
+    const char* fmt;            /* Static format string */
+    uint32_t args[KLOG_MAX_ARGS];
+    char strbuf[KLOG_STR_BYTES];
+    uint32_t seq;               /* Monotonic sequence number */
+    uint8_t level;
+    uint8_t subsys;
+    uint8_t nargs;
+    uint8_t used;
+} klog_record_t;
+
+/*
+ * Append a record; dropped with a single compare when level is above
+ * the runtime threshold. The format string must be a static literal.
+ */
+void klog(uint8_t level, uint8_t subsys, const char* fmt, ...);
+
+/*
+ * Runtime level filter: records with level > threshold are dropped at
+ * the call site. Default is KLOG_INFO.
+ */
+void klog_set_level(uint8_t level);
+uint8_t klog_get_level(void);
+
+/*
+ * Render the ring oldest-first. Each record is formatted on demand
+ * into a line and handed to emit().
+ */
+void klog_render(void (*emit)(const char* line));
+
+/* Level/subsystem names for renderers */
+const char* klog_level_name(uint8_t level);
+const char* klog_subsys_name(uint8_t subsys);
+
+#endif /* _KLOG_H */
@@ -0,0 +1,34 @@
+/*
+ * MiniOS Embedded Kernel Symbol Table
+ *
+ * The build links the kernel twice: pass one produces the image the
+ * symbol table is harvested from (scripts/gen_ksyms.sh + nm), pass
+ * two links the generated table back in. Only .text symbols are
+ * kept, so their addresses are identical across both passes. The
+ * profiler, panic paths and the stack builtin use ksym_lookup to
+ * print function names instead of raw EIPs.
+ */
+
+#ifndef _KSYMS_H
+#define _KSYMS_H
+
+#include "types.h"
+
+/* One function symbol (sorted by address in the generated table) */
+typedef struct {
+    uint32_t addr;
+    const char* name;
+} ksym_t;
+
+/* Generated by gen_ksyms.sh; weak empty defaults live in ksyms.c so
+ * a pass-one image (or a hand-built one) still links */
+extern const ksym_t ksym_table[];
+extern const uint32_t ksym_count;
+
+/*
+ * Name of the function containing addr, or NULL if unknown.
+ * On a hit, *offset (if non-NULL) gets addr's offset into it.
+ */
+const char* ksym_lookup(uint32_t addr, uint32_t* offset);
+
+#endif /* _KSYMS_H */
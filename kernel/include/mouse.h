@@ -49,6 +49,11 @@ uint32_t mouse_get_irq_count(void);
  */
 mouse_state_t* mouse_get_state(void);
 
+/*
+ * Block until the next mouse movement or button change
+ */
+void mouse_wait_event(void);
+
 /*
  * Get current mouse position
  */
@@ -0,0 +1,135 @@
+/*
+ * MiniOS Network Stack Header
+ *
+ * Minimal UDP/IPv4 over ethernet: one registered NIC, a small ARP
+ * cache, ICMP echo replies (so ping works as a link test), and UDP
+ * demultiplexed to the socket layer. Everything above the wire moves
+ * through refcounted pbufs; the only payload copies are at the
+ * user/kernel boundary and inside the NIC's own receive ring.
+ *
+ * Addressing is static and defaults to QEMU's slirp network
+ * (10.0.2.15/24, gateway 10.0.2.2) so the usual test setup works
+ * with no configuration.
+ */
+
+#ifndef _NET_H
+#define _NET_H
+
+#include "types.h"
+#include "pbuf.h"
+
+/* ---- Byte order (network order is big-endian) ---- */
+
+static inline uint16_t htons(uint16_t v) {
+    return (uint16_t)((v << 8) | (v >> 8));
+}
+
+static inline uint16_t ntohs(uint16_t v) {
+    return htons(v);
+}
+
+static inline uint32_t htonl(uint32_t v) {
+    return ((v & 0x000000FF) << 24) |
+           ((v & 0x0000FF00) << 8)  |
+           ((v & 0x00FF0000) >> 8)  |
+           ((v & 0xFF000000) >> 24);
+}
+
+static inline uint32_t ntohl(uint32_t v) {
+    return htonl(v);
+}
+
+/* Build a host-order IPv4 address from dotted-quad components */
+#define IP_ADDR(a, b, c, d) \
+    (((uint32_t)(a) << 24) | ((uint32_t)(b) << 16) | \
+     ((uint32_t)(c) << 8)  |  (uint32_t)(d))
+
+/* ---- Wire formats ---- */
+
+#define ETH_ALEN        6
+#define ETH_HDR_LEN     14
+#define ETH_TYPE_IP     0x0800
+#define ETH_TYPE_ARP    0x0806
+
+typedef struct __attribute__((packed)) {
+    uint8_t  dst[ETH_ALEN];
+    uint8_t  src[ETH_ALEN];
+    uint16_t type;              /* Network order */
+} eth_header_t;
+
+#define IP_HDR_LEN      20
+#define IP_PROTO_ICMP   1
+#define IP_PROTO_UDP    17
+
+typedef struct __attribute__((packed)) {
+    uint8_t  ver_ihl;           /* 0x45: IPv4, 20-byte header */
+    uint8_t  tos;
+    uint16_t total_len;
+    uint16_t id;
+    uint16_t frag_off;
+    uint8_t  ttl;
+    uint8_t  protocol;
+    uint16_t checksum;
+    uint32_t src;               /* Network order */
+    uint32_t dst;
+} ip_header_t;
+
+#define UDP_HDR_LEN     8
+
+typedef struct __attribute__((packed)) {
+    uint16_t src_port;          /* Network order */
+    uint16_t dst_port;
+    uint16_t length;            /* Header + payload */
+    uint16_t checksum;          /* 0 = not computed (legal for UDP/IPv4) */
+} udp_header_t;
+
+/* Largest UDP payload we can send without IP fragmentation */
+#define UDP_MAX_PAYLOAD (PBUF_MAX_DATA - ETH_HDR_LEN - IP_HDR_LEN - UDP_HDR_LEN)
+
+/* ---- Network device ---- */
+
+/*
+ * A registered NIC. The driver fills in mac/impl/transmit and calls
+ * netdev_register() once the hardware is up; transmit takes ownership
+ * of one pbuf reference (the driver drops it when the DMA completes).
+ */
+typedef struct netdev {
+    const char* name;
+    uint8_t mac[ETH_ALEN];
+    void* impl;                             /* Driver private state */
+    bool (*transmit)(struct netdev* dev, pbuf_t* p);
+} netdev_t;
+
+/*
+ * Initialize the network stack and probe for supported NICs.
+ * Safe to call when no NIC is present; the stack just stays idle.
+ */
+void net_init(void);
+
+/* Register the (single) network device. Returns 0 on success. */
+int netdev_register(netdev_t* dev);
+
+/* The registered device, or NULL if none was found */
+netdev_t* netdev_get(void);
+
+/* Our IPv4 address (host order) */
+uint32_t net_local_ip(void);
+
+/*
+ * Receive entry point, called by the NIC driver (IRQ context) with a
+ * pbuf whose data points at the ethernet header. The stack consumes
+ * the reference.
+ */
+void net_rx(netdev_t* dev, pbuf_t* p);
+
+/*
+ * Send a UDP datagram. p->data/len must describe the payload only;
+ * this prepends the UDP, IP and ethernet headers into the pbuf's
+ * headroom and hands it to the driver (or parks it on the ARP entry
+ * until the next hop resolves). Consumes the caller's reference.
+ * Returns 0 on success, -1 on error.
+ */
+int net_udp_send(uint32_t dst_ip, uint16_t src_port, uint16_t dst_port,
+                 pbuf_t* p);
+
+#endif /* _NET_H */
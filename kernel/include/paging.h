@@ -25,6 +25,8 @@
 #define PAGE_DIRTY          0x040   /* Page has been written to */
 #define PAGE_SIZE_4MB       0x080   /* 4MB page (only in page directory) */
 #define PAGE_GLOBAL         0x100   /* Global page (not flushed on CR3 reload) */
+#define PAGE_COW            0x200   /* Copy-on-write (OS-defined, avail bit 9) */
+#define PAGE_SWAPPED        0x400   /* Non-present PTE is a swap entry (avail bit 10) */
 
 /* Common flag combinations */
 #define PAGE_KERNEL         (PAGE_PRESENT | PAGE_WRITE)
@@ -70,6 +72,23 @@ void paging_init(void);
  */
 void paging_map_page(uint32_t virtual_addr, uint32_t physical_addr, uint32_t flags);
 
+/*
+ * Map a single 4MB page (directory entry with the PS bit).
+ * Requires paging_pse_available() and 4MB-aligned addresses.
+ */
+void paging_map_4mb(uint32_t virtual_addr, uint32_t physical_addr, uint32_t flags);
+
+/*
+ * True when the CPU supports 4MB pages (CR4.PSE is set at init)
+ */
+bool paging_pse_available(void);
+
+/*
+ * PTE cache flags for framebuffer mappings (write-combining via PAT
+ * when available, PAGE_NOCACHE otherwise)
+ */
+uint32_t paging_fb_cache_flags(void);
+
 /*
  * Unmap a virtual address
  */
@@ -86,6 +105,11 @@ uint32_t paging_get_physical(uint32_t virtual_addr);
  */
 bool paging_is_mapped(uint32_t virtual_addr);
 
+/*
+ * Check if an entire virtual range is mapped (single page-table walk)
+ */
+bool paging_is_range_mapped(uint32_t start, uint32_t size);
+
 /*
  * Flush a single page from TLB
  */
@@ -112,14 +136,49 @@ void paging_switch_directory(page_directory_t* dir);
 page_directory_t* paging_create_directory(void);
 
 /*
- * Clone a page directory (for fork)
+ * Clone a page directory (for fork).
+ * User frames are shared copy-on-write instead of deep-copied; both
+ * sides are mapped read-only with PAGE_COW and the page fault handler
+ * copies a frame only when someone actually writes it.
  */
 page_directory_t* paging_clone_directory(page_directory_t* src);
 
+/*
+ * Resolve a write fault on a PAGE_COW page in the current directory.
+ * Returns true if the fault was a COW break and the instruction can
+ * be retried.
+ */
+bool paging_handle_cow_fault(uint32_t fault_addr);
+
 /*
  * Free a page directory and all its page tables
  */
 void paging_free_directory(page_directory_t* dir);
 
+/*
+ * Raw PTE access in an arbitrary directory (swap code). Returns 0 for
+ * addresses not covered by a 4KB page table.
+ */
+uint32_t paging_get_entry(page_directory_t* dir, uint32_t virtual_addr);
+
+/*
+ * Overwrite a raw PTE in an arbitrary directory. Flushes the TLB
+ * entry when dir is the active directory; a non-active directory gets
+ * its TLB refilled by the CR3 reload at the next switch.
+ */
+void paging_set_entry(page_directory_t* dir, uint32_t virtual_addr, uint32_t entry);
+
+/*
+ * Accessed-bit aging scan over a directory's private user mappings.
+ * Pages seen with the accessed bit set have it cleared (they survive
+ * this round); the first present user page whose bit is still clear
+ * from an earlier round is returned as the cold candidate. *cursor is
+ * a resume point so successive calls rotate through the address
+ * space, and *budget (PTEs examined, decremented in place) bounds the
+ * caller's total scan work across calls. Returns 0 when the budget
+ * ran out without finding a cold page.
+ */
+uint32_t paging_scan_cold(page_directory_t* dir, uint32_t* cursor, uint32_t* budget);
+
 #endif /* _PAGING_H */
 
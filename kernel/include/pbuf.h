@@ -0,0 +1,62 @@
+/*
+ * MiniOS Packet Buffer Header
+ *
+ * Refcounted network packet buffers shared by the NIC driver and the
+ * protocol/socket layers. A pbuf is allocated once per packet and the
+ * same storage is handed down (TX) or up (RX) the stack by pointer:
+ * headers are added and removed by moving the data pointer inside a
+ * fixed headroom, never by copying the payload.
+ *
+ * The storage comes from the kernel heap, which is identity mapped,
+ * so p->data is also the physical address a DMA engine needs.
+ */
+
+#ifndef _PBUF_H
+#define _PBUF_H
+
+#include "types.h"
+
+/* Space reserved in front of the payload for ethernet + IP + UDP
+ * headers (14 + 20 + 8 bytes, rounded up for alignment) */
+#define PBUF_HEADROOM   64
+
+/* Largest payload area: a full ethernet frame plus slack */
+#define PBUF_MAX_DATA   1536
+
+/*
+ * Packet buffer. data/len describe the current view of the packet;
+ * pbuf_push() grows the view downward into the headroom (prepending
+ * a header) and pbuf_pull() shrinks it upward (stripping one).
+ */
+typedef struct pbuf {
+    uint8_t* data;          /* Current packet start */
+    uint32_t len;           /* Current packet length */
+    uint32_t refcount;      /* Freed when this drops to zero */
+    uint8_t buf[PBUF_HEADROOM + PBUF_MAX_DATA];
+} pbuf_t;
+
+/*
+ * Allocate a buffer with len bytes of payload after the headroom.
+ * Returns NULL if len exceeds PBUF_MAX_DATA or the heap is exhausted.
+ */
+pbuf_t* pbuf_alloc(uint32_t len);
+
+/* Take an additional reference */
+void pbuf_ref(pbuf_t* p);
+
+/* Drop a reference, freeing the buffer on the last one */
+void pbuf_free(pbuf_t* p);
+
+/*
+ * Prepend n bytes (move data into the headroom). Returns the new
+ * data pointer, or NULL if the headroom is exhausted.
+ */
+uint8_t* pbuf_push(pbuf_t* p, uint32_t n);
+
+/*
+ * Strip n bytes from the front. Returns the new data pointer, or
+ * NULL if the packet is shorter than n.
+ */
+uint8_t* pbuf_pull(pbuf_t* p, uint32_t n);
+
+#endif /* _PBUF_H */
@@ -8,13 +8,26 @@
 #define _PIPE_H
 
 #include "types.h"
+#include "spinlock.h"
 #include "vfs.h"
+#include "process.h"
 
-#define PIPE_BUF_SIZE 4096  /* 4KB pipe buffer */
+#define PIPE_BUF_SIZE 4096   /* Initial pipe buffer (4KB) */
+#define PIPE_BUF_MAX  65536  /* Growth ceiling (64KB) */
 
-/* Pipe structure */
+/*
+ * Pipe structure. The buffer starts at PIPE_BUF_SIZE and doubles on
+ * demand up to max_capacity when a writer finds it full, so bulk
+ * producers stream kilobytes between consumer wakeups instead of
+ * blocking every 4KB. Wakeups are watermark-based: a write wakes
+ * readers on the empty->non-empty edge or once half the buffer is
+ * full, and a read wakes writers only once a quarter of the buffer
+ * is free again.
+ */
 typedef struct pipe {
-    uint8_t buffer[PIPE_BUF_SIZE];
+    uint8_t* buffer;            /* Ring storage (kmalloc'd) */
+    uint32_t capacity;          /* Current buffer size */
+    uint32_t max_capacity;      /* Growth cap (F_SETPIPE_SZ) */
     uint32_t read_pos;          /* Read position in circular buffer */
     uint32_t write_pos;         /* Write position in circular buffer */
     uint32_t data_size;         /* Amount of data in pipe */
@@ -22,6 +35,9 @@ typedef struct pipe {
     bool write_open;            /* Write end is open */
     uint32_t readers;           /* Number of readers */
     uint32_t writers;           /* Number of writers */
+    wait_queue_t read_wait;     /* Readers blocked on an empty pipe */
+    wait_queue_t write_wait;    /* Writers blocked on a full pipe */
+    spinlock_t lock;            /* Protects the ring and its positions */
 } pipe_t;
 
 /* File descriptor flags */
@@ -32,8 +48,26 @@ typedef struct pipe {
 #define O_TRUNC     0x0200
 #define O_APPEND    0x0400
 
-/* Maximum file descriptors per process */
-#define MAX_FD 32
+/* fcntl() commands (pipe descriptors only, for now) */
+#define F_GETPIPE_SZ    1   /* Return the pipe's growth cap */
+#define F_SETPIPE_SZ    2   /* Set the growth cap (clamped) */
+
+/* Maximum file descriptors per process (one table per process_t) */
+#define MAX_FD MAX_OPEN_FILES
+
+/* poll() event bits */
+#define POLLIN      0x0001  /* Data available to read */
+#define POLLOUT     0x0004  /* Writing will not block */
+#define POLLERR     0x0008  /* Read end of a written pipe closed */
+#define POLLHUP     0x0010  /* Write end closed (EOF after drain) */
+#define POLLNVAL    0x0020  /* Descriptor not open */
+
+/* poll() request/result entry */
+typedef struct {
+    int32_t fd;             /* Descriptor to watch (< 0: skip entry) */
+    int16_t events;         /* Requested events (POLLIN/POLLOUT) */
+    int16_t revents;        /* Returned events */
+} pollfd_t;
 
 /* Pipe functions */
 pipe_t* pipe_create(void);
@@ -42,12 +76,15 @@ int32_t pipe_read(pipe_t* pipe, uint8_t* buffer, uint32_t size);
 int32_t pipe_write(pipe_t* pipe, const uint8_t* buffer, uint32_t size);
 bool pipe_is_empty(pipe_t* pipe);
 bool pipe_is_full(pipe_t* pipe);
+uint32_t pipe_set_capacity(pipe_t* pipe, uint32_t bytes);
+wait_queue_t* pipe_poll_queue(void);
 
-/* File descriptor functions */
+/* File descriptor functions (operate on the current process's table) */
 void fd_init(void);
 int32_t fd_alloc(void);
 void fd_free(int32_t fd);
 file_descriptor_t* fd_get(int32_t fd);
 int32_t fd_dup2(int32_t oldfd, int32_t newfd);
+void fd_close_all(void);
 
 #endif /* _PIPE_H */
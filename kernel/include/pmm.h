@@ -25,6 +25,9 @@
 #define ADDR_TO_FRAME(addr)   ((addr) >> PAGE_SHIFT)
 #define FRAME_TO_ADDR(frame)  ((frame) << PAGE_SHIFT)
 
+/* Power-of-two orders tracked by the contiguous-region cursors */
+#define PMM_REGION_ORDERS   11      /* up to 2^10 frames (4MB) per region */
+
 /* Memory statistics */
 typedef struct {
     uint32_t total_frames;      /* Total physical frames */
@@ -53,10 +56,22 @@ uint32_t pmm_alloc_frame(void);
 uint32_t pmm_alloc_frames(uint32_t count);
 
 /*
- * Free a single physical page frame
+ * Free a single physical page frame.
+ * Shared frames (see pmm_frame_ref) just drop one reference; the
+ * frame is only returned to the allocator when the last user frees it.
  */
 void pmm_free_frame(uint32_t addr);
 
+/*
+ * Add a reference to a frame shared between address spaces (COW)
+ */
+void pmm_frame_ref(uint32_t addr);
+
+/*
+ * Number of address spaces referencing a frame (at least 1 if used)
+ */
+uint32_t pmm_frame_refcount(uint32_t addr);
+
 /*
  * Free multiple contiguous physical page frames
  */
@@ -77,6 +92,18 @@ void pmm_mark_region_used(uint32_t start, uint32_t size);
  */
 void pmm_mark_region_free(uint32_t start, uint32_t size);
 
+/*
+ * Allocate a frame that is already zeroed. Served from the pre-zeroed
+ * pool when possible; falls back to alloc + memset when it is empty.
+ */
+uint32_t pmm_alloc_frame_zeroed(void);
+
+/*
+ * Zero one frame into the pool. Called from the idle loop; returns
+ * true if it did work (pool not yet full and memory available).
+ */
+bool pmm_zero_pool_topup(void);
+
 /*
  * Check if a frame is allocated
  */
@@ -9,18 +9,27 @@
 
 #include "types.h"
 
-/* Forward declaration */
+/* Forward declarations */
 struct file_descriptor;
+struct vfs_node;
 typedef void (*signal_handler_t)(int);
 
 /* Maximum number of processes */
 #define MAX_PROCESSES       64
-#define MAX_OPEN_FILES      16  /* Max open files per process */
+
+/* Priority levels (0 = highest); idle runs at the lowest level */
+#define PROCESS_NUM_PRIORITIES   8
+#define PROCESS_PRIORITY_DEFAULT 3
+#define PROCESS_PRIORITY_IDLE    (PROCESS_NUM_PRIORITIES - 1)
+#define MAX_OPEN_FILES      32  /* Max open files per process */
 #define KERNEL_STACK_SIZE   16384   /* 16KB kernel stack per process */
 #define USER_STACK_SIZE     8192    /* 8KB user stack per process */
+#define USER_STACK_MAX_SIZE 65536   /* Growth-on-fault ceiling (64KB) */
 #define USER_STACK_BASE     0xBFFFF000  /* User stack starts near 3GB */
 #define USER_HEAP_START     0x40100000  /* User heap starts after code (1GB + 1MB) */
 #define USER_HEAP_MAX       0x80000000  /* User heap max (2GB) */
+#define USER_MMAP_BASE      0x90000000  /* File mapping window (below shm) */
+#define USER_MMAP_END       0xA0000000
 
 /* Process states */
 typedef enum {
@@ -32,6 +41,24 @@ typedef enum {
     PROCESS_STATE_ZOMBIE        /* Terminated, waiting for parent */
 } process_state_t;
 
+/* Maximum demand-paged segments per process */
+#define MAX_VMAS            8
+
+/*
+ * Virtual memory area: one lazily-loaded ELF segment. Pages inside a
+ * VMA are not mapped at exec time; the page fault handler reads them
+ * in from the backing file on first access (see elf_handle_fault).
+ */
+typedef struct vma {
+    bool used;                  /* Descriptor slot is in use */
+    uint32_t vaddr;             /* Segment start (may be unaligned) */
+    uint32_t memsz;             /* Size in memory (includes BSS) */
+    uint32_t file_offset;       /* Segment offset in the backing file */
+    uint32_t file_size;         /* Bytes backed by the file */
+    uint32_t page_flags;        /* Paging flags for faulted-in pages */
+    struct vfs_node* file;      /* Pinned backing file */
+} vma_t;
+
 /* CPU registers saved during context switch */
 typedef struct {
     /* Pushed by context switch code */
@@ -86,15 +113,41 @@ typedef struct process {
     uint32_t page_directory;    /* Physical address of page directory */
     uint32_t heap_start;        /* Start of user heap */
     uint32_t heap_break;        /* Current heap break (end of heap) */
+    vma_t vmas[MAX_VMAS];       /* Demand-paged ELF segments */
 
     /* File descriptors */
     struct file_descriptor* fd_table[MAX_OPEN_FILES];
+    int32_t fd_next_free;       /* Lowest possibly-free fd slot (alloc hint) */
 
     /* Scheduling */
     uint32_t priority;          /* Process priority (0 = highest) */
     uint32_t time_slice;        /* Remaining time slice */
     uint64_t total_ticks;       /* Total CPU ticks used */
 
+    /* Microsecond CPU accounting (maintained by scheduler.c; the
+     * user/kernel split flips at syscall entry/exit) */
+    uint64_t cpu_user_us;       /* Time executed in user mode */
+    uint64_t cpu_kernel_us;     /* Time executed in the kernel */
+    uint8_t cpu_in_kernel;      /* Current accounting bucket */
+
+    /* Scheduling instrumentation (maintained by scheduler.c) */
+    uint64_t ready_since_us;    /* When last made ready (0 = not waiting) */
+    uint64_t sched_delay_us;    /* Accumulated ready->running wait */
+    uint32_t sched_delay_max_us; /* Worst single ready->running wait */
+    uint32_t dispatches;        /* Times picked by the scheduler */
+    uint32_t vol_switches;      /* Gave the CPU up (block/yield) */
+    uint32_t invol_switches;    /* Lost the CPU to tick preemption */
+
+    /* Dynamic priority (maintained by scheduler.c) */
+    uint32_t boost_left;        /* Boosted dispatches left after a sleep */
+    uint32_t full_slices;       /* Consecutive quanta fully consumed */
+    uint32_t queued_level;      /* Ready-queue level used at enqueue */
+
+    /* Lazy FPU/SSE context (maintained by fpu.c): fpu_state holds an
+     * FXSAVE image and is only valid once fpu_used is set */
+    uint8_t fpu_state[512] __attribute__((aligned(16)));
+    uint8_t fpu_used;           /* Process has touched the FPU */
+
     /* Signals */
     uint32_t pending_signals;   /* Bitmap of pending signals */
     signal_handler_t signal_handlers[32];  /* Signal handlers (NSIG) */
@@ -108,7 +161,13 @@ typedef struct process {
 /* Process table */
 extern process_t process_table[MAX_PROCESSES];
 extern process_t* current_process;
-extern process_t* ready_queue;
+
+/*
+ * Per-priority ready queues plus a bitmap of non-empty levels, so the
+ * scheduler picks the next runnable process with one find-first-set
+ */
+extern process_t* ready_queues[PROCESS_NUM_PRIORITIES];
+extern uint32_t ready_bitmap;
 
 /*
  * Initialize the process subsystem
@@ -152,6 +211,13 @@ void process_terminate(process_t* proc, int exit_code);
  */
 process_t* process_get(uint32_t pid);
 
+/*
+ * Release a process table slot (reaping a zombie or unwinding a
+ * failed creation): returns it to the free-slot bitmap and removes
+ * it from the PID hash
+ */
+void process_slot_free(process_t* proc);
+
 /*
  * Get current running process
  */
@@ -177,6 +243,39 @@ void process_block(process_state_t reason);
  */
 void process_unblock(process_t* proc);
 
+/*
+ * Change a process's priority, requeueing it if it is ready
+ */
+void process_set_priority(process_t* proc, uint32_t priority);
+
+/*
+ * Wait queue: a FIFO of blocked processes waiting for an event.
+ * Sleepers consume no CPU until wake_up/wake_up_one readies them.
+ */
+typedef struct wait_queue {
+    process_t* head;
+    process_t* tail;
+} wait_queue_t;
+
+/*
+ * Initialize a wait queue
+ */
+void wait_queue_init(wait_queue_t* wq);
+
+/*
+ * Block the current process on a wait queue until woken.
+ * Callers must re-check their condition after waking. No-op before
+ * the scheduler is running.
+ */
+void sleep_on(wait_queue_t* wq);
+
+/*
+ * Wake the first sleeper / all sleepers on a wait queue.
+ * Safe to call from interrupt handlers.
+ */
+void wake_up_one(wait_queue_t* wq);
+void wake_up(wait_queue_t* wq);
+
 /*
  * Print process list (for debugging)
  */
@@ -203,6 +302,15 @@ int process_exec(const char* path, char* const argv[]);
  */
 int process_wait(int* status);
 
+/*
+ * Create and start a user process from an ELF file (fork+exec in one
+ * step, no intermediate address-space copy)
+ * path: path to ELF executable
+ * argv: argument vector for the new process (NULL = program name only)
+ * Returns: child PID on success, -1 on error
+ */
+int process_spawn(const char* path, char* const argv[]);
+
 /*
  * Create and start a user process from an ELF file
  * Used to launch initial userland processes from kernel
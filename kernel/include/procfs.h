@@ -0,0 +1,18 @@
+/*
+ * MiniOS /proc Pseudo-Filesystem Header
+ *
+ * Process and subsystem statistics exposed as read-only files
+ * generated on read. Mounted at /proc.
+ */
+
+#ifndef _PROCFS_H
+#define _PROCFS_H
+
+#include "vfs.h"
+
+/*
+ * Initialize procfs and return its root node (for vfs_mount).
+ */
+vfs_node_t* procfs_init(void);
+
+#endif /* _PROCFS_H */
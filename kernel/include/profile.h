@@ -0,0 +1,33 @@
+/*
+ * MiniOS Sampling Kernel Profiler
+ *
+ * On every timer tick the interrupted EIP is recorded into a histogram
+ * of fixed-size buckets spanning the kernel image. The `profile` shell
+ * command starts/stops sampling and reports the hottest buckets;
+ * addresses are resolved against the linker map (build/kernel.bin.map).
+ */
+
+#ifndef _PROFILE_H
+#define _PROFILE_H
+
+#include "types.h"
+
+/* Number of histogram buckets covering the kernel image */
+#define PROFILE_BUCKETS 1024
+
+/* Start sampling (clears the histogram) */
+void profile_start(void);
+
+/* Stop sampling */
+void profile_stop(void);
+
+/* True while sampling is active */
+bool profile_running(void);
+
+/* Record one sample; called from the timer interrupt */
+void profile_sample(uint32_t eip);
+
+/* Print the hottest buckets via printk */
+void profile_report(void);
+
+#endif /* _PROFILE_H */
@@ -9,8 +9,8 @@
 
 #include "vfs.h"
 
-/* Maximum files in ramfs */
-#define RAMFS_MAX_FILES     64
+/* Maximum files in ramfs (entry pool is heap-allocated at init) */
+#define RAMFS_MAX_FILES     1024
 #define RAMFS_MAX_FILE_SIZE 524288  /* 512KB - enough for BMP files and binaries */
 
 /*
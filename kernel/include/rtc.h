@@ -25,10 +25,16 @@ typedef struct {
 void rtc_init(void);
 
 /*
- * Read the current time from the CMOS RTC
+ * Read the current time (cached CMOS base + elapsed timer seconds)
  */
 void rtc_read_time(rtc_time_t* time);
 
+/*
+ * Re-read the hardware clock and reset the cached base. Happens
+ * automatically once an hour; call after changing the CMOS clock.
+ */
+void rtc_resync(void);
+
 /*
  * Get hours (0-23) from RTC
  */
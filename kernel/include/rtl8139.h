@@ -0,0 +1,20 @@
+/*
+ * MiniOS RTL8139 Network Driver Header
+ *
+ * Driver for the Realtek RTL8139 fast ethernet controller (QEMU's
+ * default emulated NIC alongside e1000). Probed and registered with
+ * the network core by rtl8139_init().
+ */
+
+#ifndef _RTL8139_H
+#define _RTL8139_H
+
+#include "types.h"
+
+/*
+ * Probe PCI bus 0 for an RTL8139, bring it up and register it as the
+ * system network device. Quietly does nothing if no card is present.
+ */
+void rtl8139_init(void);
+
+#endif /* _RTL8139_H */
@@ -36,6 +36,18 @@ void yield(void);
  */
 extern void switch_to(process_t* prev, process_t* next);
 
+/*
+ * Ready-queue level for a process under dynamic priority: recent
+ * sleepers are promoted one level, sustained CPU hogs demoted one
+ */
+uint32_t sched_effective_level(process_t* proc);
+
+/*
+ * Re-read the dynamic-priority tunables from the "sched" config
+ * section (call once the config filesystem is mounted)
+ */
+void scheduler_load_conf(void);
+
 /*
  * Start the scheduler (called once, doesn't return)
  */
@@ -63,10 +75,22 @@ typedef struct {
     uint64_t total_switches;    /* Total context switches */
     uint64_t idle_ticks;        /* Ticks spent in idle */
     uint32_t num_ready;         /* Number of ready processes */
+    uint64_t total_delay_us;    /* Sum of all ready->running waits */
+    uint32_t max_delay_us;      /* Worst single wait since boot */
+    uint32_t dispatches;        /* Times any process was picked */
+    uint32_t voluntary;         /* Switches where prev blocked/yielded */
+    uint32_t involuntary;       /* Tick preemptions */
 } scheduler_stats_t;
 
 void scheduler_get_stats(scheduler_stats_t* stats);
 
+/*
+ * Flip the running process's CPU accounting bucket (1 = kernel).
+ * Called at syscall entry/exit so cpu_user_us/cpu_kernel_us split
+ * with microsecond precision.
+ */
+void sched_cpu_mark(int in_kernel);
+
 /*
  * Timer tick handler (called by IRQ0)
  */
@@ -6,6 +6,9 @@
 /* Initialize COM1 (0x3F8) for debugging output */
 void serial_init(void);
 
+/* Switch COM1 to IRQ4-driven buffered I/O (requires IDT + PIC) */
+void serial_enable_irq(void);
+
 /* Write a single character to COM1 */
 void serial_write_char(char c);
 
@@ -15,4 +18,7 @@ void serial_write_string(const char* s);
 /* Write a 32-bit hex value (0xXXXXXXXX) */
 void serial_write_hex(uint32_t v);
 
+/* Read a buffered received byte, or -1 if none is pending */
+int serial_read_char(void);
+
 #endif /* _SERIAL_H */
@@ -65,5 +65,16 @@ int shell_execute_command(const char* cmdline);
  */
 const shell_command_t* shell_get_commands(int* out_count);
 
+/*
+ * Look up a command by name (O(1) hash lookup)
+ * Returns NULL if no such builtin exists
+ */
+const shell_command_t* shell_find_command(const char* name);
+
+/*
+ * Get the idx'th command in alphabetical order (NULL past the end)
+ */
+const shell_command_t* shell_command_sorted(int idx);
+
 #endif /* _SHELL_H */
 
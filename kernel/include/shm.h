@@ -0,0 +1,56 @@
+/*
+ * MiniOS Shared Memory Segments
+ *
+ * System V style shared memory for bulk zero-copy IPC. Segments are
+ * backed by pmm frames and attach at a fixed per-segment window in
+ * every address space, so producer and consumer see the same pages.
+ */
+
+#ifndef _SHM_H
+#define _SHM_H
+
+#include "types.h"
+#include "pmm.h"
+
+/* Segment limits */
+#define SHM_MAX_SEGMENTS    16
+#define SHM_MAX_PAGES       256     /* 1MB per segment */
+#define SHM_SLOT_BYTES      (SHM_MAX_PAGES * PAGE_SIZE)
+
+/* Attach window: above the user heap, below the user stack. Segment
+ * id attaches at SHM_VADDR_BASE + id * SHM_SLOT_BYTES in every
+ * process, so pointers into a segment are valid on both sides. */
+#define SHM_VADDR_BASE      0xA0000000
+#define SHM_VADDR_END       (SHM_VADDR_BASE + SHM_MAX_SEGMENTS * SHM_SLOT_BYTES)
+
+/*
+ * Initialize the segment table
+ */
+void shm_init(void);
+
+/*
+ * Find the segment with the given key, creating it (zero-filled) if
+ * none exists and size is non-zero.
+ * Returns: segment id, or -1 on error
+ */
+int32_t shm_get(int32_t key, uint32_t size);
+
+/*
+ * Map a segment's frames into the current address space.
+ * Returns: attach address, or 0 on error
+ */
+uint32_t shm_attach(int32_t id);
+
+/*
+ * Unmap a segment from the current address space.
+ * Returns: 0 on success, -1 on error
+ */
+int32_t shm_detach(int32_t id);
+
+/*
+ * Free a segment's frames. Fails while any attachment remains.
+ * Returns: 0 on success, -1 on error
+ */
+int32_t shm_remove(int32_t id);
+
+#endif /* _SHM_H */
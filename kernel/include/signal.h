@@ -34,6 +34,14 @@
 
 #define NSIG        32  /* Number of signals */
 
+/* Signals that ignore the blocked mask */
+#define SIG_UNBLOCKABLE ((1u << SIGKILL) | (1u << SIGSTOP))
+
+/* Deliverable set for a pending/blocked mask pair. The common no-signal
+ * case on the kernel exit path reduces to one AND plus a test */
+#define SIG_DELIVERABLE(pending, blocked) \
+    ((pending) & (~(blocked) | SIG_UNBLOCKABLE))
+
 /* Signal handler types */
 #define SIG_DFL     ((signal_handler_t)0)  /* Default action */
 #define SIG_IGN     ((signal_handler_t)1)  /* Ignore signal */
@@ -0,0 +1,71 @@
+/*
+ * MiniOS Slab Cache Header
+ *
+ * Object caches for hot, fixed-size kernel structures. A cache hands
+ * out pre-carved objects from slab pages obtained once from the heap,
+ * so the frequent alloc/free paths never touch the general allocator.
+ */
+
+#ifndef _SLAB_H
+#define _SLAB_H
+
+#include "types.h"
+
+/* Size of each slab carved from the heap */
+#define SLAB_SIZE           4096
+
+/* Objects are padded to this boundary to avoid cache-line sharing */
+#define SLAB_OBJ_ALIGN      32
+
+#define KMEM_CACHE_NAME_MAX 24
+
+/* One slab: a SLAB_SIZE chunk carved into objects */
+typedef struct kmem_slab {
+    struct kmem_slab* next;     /* Next slab in this cache */
+} kmem_slab_t;
+
+typedef struct kmem_cache {
+    char name[KMEM_CACHE_NAME_MAX];
+    size_t obj_size;            /* Requested object size */
+    size_t stride;              /* Padded size of each object */
+    uint32_t objs_per_slab;
+    void* free_head;            /* Free objects, linked through themselves */
+    kmem_slab_t* slabs;         /* All slabs owned by this cache */
+    uint32_t total_objs;
+    uint32_t in_use;
+    struct kmem_cache* next;    /* All caches, for stats */
+} kmem_cache_t;
+
+/*
+ * Initialize the slab subsystem and create the standard caches.
+ * Must run after heap_init().
+ */
+void slab_init(void);
+
+/*
+ * Create a cache for objects of the given size.
+ * Returns NULL if the heap cannot back it.
+ */
+kmem_cache_t* kmem_cache_create(const char* name, size_t obj_size);
+
+/*
+ * Allocate one object from a cache (grows the cache by a slab
+ * when empty). Returns zeroed memory or NULL on failure.
+ */
+void* kmem_cache_alloc(kmem_cache_t* cache);
+
+/*
+ * Return an object to its cache
+ */
+void kmem_cache_free(kmem_cache_t* cache, void* obj);
+
+/*
+ * Print per-cache usage (for the heap/mem debug commands)
+ */
+void kmem_cache_print_stats(void);
+
+/* Standard caches for hot kernel objects, created by slab_init() */
+extern kmem_cache_t* vfs_node_cache;
+extern kmem_cache_t* dirent_cache;
+
+#endif /* _SLAB_H */
@@ -0,0 +1,43 @@
+/*
+ * MiniOS SMP Topology Detection
+ *
+ * Discovers the machine's CPU topology from the ACPI MADT (falling
+ * back to the legacy MP floating pointer structure) so the kernel
+ * knows how many cores the board has and where the local APIC lives.
+ * Application processors are not started yet: bringup needs an AP
+ * trampoline and an SMP-safe core (the per-structure spinlocks are
+ * the first step), so for now the secondary cores are only counted
+ * and reported by the `cpus` shell command.
+ */
+
+#ifndef _SMP_H
+#define _SMP_H
+
+#include "types.h"
+
+/* Detected CPUs we keep track of */
+#define SMP_MAX_CPUS 8
+
+/* One detected processor */
+typedef struct {
+    uint8_t apic_id;        /* Local APIC ID */
+    bool enabled;           /* Usable per the firmware tables */
+    bool bsp;               /* The processor we booted on */
+} smp_cpu_t;
+
+/* Scan the firmware tables (call after paging_init; reads low memory) */
+void smp_init(void);
+
+/* Number of usable processors found (>= 1; 1 means no tables) */
+uint32_t smp_cpu_count(void);
+
+/* Detected processor by index, NULL if out of range */
+const smp_cpu_t* smp_cpu_get(uint32_t index);
+
+/* Physical local APIC base, 0 if none was reported */
+uint32_t smp_lapic_base(void);
+
+/* Print the detected topology via printk */
+void smp_report(void);
+
+#endif /* _SMP_H */
@@ -0,0 +1,78 @@
+/*
+ * MiniOS Socket Layer Header
+ *
+ * UDP datagram sockets backed directly by pbufs: the receive queue
+ * holds the driver's buffers themselves, so a datagram is copied
+ * exactly once on its way to a process (into the user buffer in
+ * recvfrom). Sockets live in the per-process fd table next to files
+ * and pipes; sys_close releases them through fd_free like any other
+ * descriptor.
+ */
+
+#ifndef _SOCKET_H
+#define _SOCKET_H
+
+#include "types.h"
+#include "pbuf.h"
+#include "process.h"
+
+/* System-wide socket table size */
+#define SOCK_MAX        16
+
+/* Datagrams queued per socket before the oldest is dropped */
+#define SOCK_RXQ_MAX    16
+
+/* First port handed out when sendto() is called on an unbound socket */
+#define SOCK_EPHEMERAL_BASE 49152
+
+/*
+ * A UDP socket. The receive queue is a ring of pbufs plus the source
+ * address of each datagram; readers sleep on rx_wait.
+ */
+typedef struct udp_socket {
+    bool in_use;
+    uint16_t local_port;            /* 0 = unbound */
+    pbuf_t* rxq[SOCK_RXQ_MAX];
+    uint32_t rx_src_ip[SOCK_RXQ_MAX];
+    uint16_t rx_src_port[SOCK_RXQ_MAX];
+    uint32_t rxq_head;              /* Oldest queued datagram */
+    uint32_t rxq_count;
+    wait_queue_t rx_wait;           /* Readers blocked on an empty queue */
+} udp_socket_t;
+
+/* Initialize the socket table (called from net_init) */
+void socket_init(void);
+
+/* Allocate a socket, or NULL if the table is full */
+udp_socket_t* socket_create(void);
+
+/* Release a socket, dropping any queued datagrams */
+void socket_close(udp_socket_t* sock);
+
+/* Bind to a local UDP port. Returns 0, or -1 if the port is taken. */
+int socket_bind(udp_socket_t* sock, uint16_t port);
+
+/*
+ * Send len bytes to ip:port (host order). Binds an ephemeral local
+ * port first if needed. Returns bytes sent, or -1 on error.
+ */
+int socket_sendto(udp_socket_t* sock, const void* buf, uint32_t len,
+                  uint32_t dst_ip, uint16_t dst_port);
+
+/*
+ * Receive one datagram, blocking until one arrives. Copies at most
+ * len bytes into buf (excess is discarded, datagram semantics) and
+ * reports the source when src_ip/src_port are non-NULL. Returns the
+ * number of bytes copied, or -1 on error.
+ */
+int socket_recvfrom(udp_socket_t* sock, void* buf, uint32_t len,
+                    uint32_t* src_ip, uint16_t* src_port);
+
+/*
+ * Demux entry point called by the IP layer (IRQ context) with the
+ * UDP payload pbuf. Consumes the reference.
+ */
+void socket_udp_input(uint32_t src_ip, uint16_t src_port,
+                      uint16_t dst_port, pbuf_t* p);
+
+#endif /* _SOCKET_H */
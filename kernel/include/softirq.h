@@ -0,0 +1,38 @@
+/*
+ * MiniOS Softirq (Bottom Half) Support
+ *
+ * Hard-IRQ handlers capture minimal data and raise a softirq; the
+ * pending bottom halves run on IRQ exit with interrupts enabled, so
+ * masked-interrupt windows stay short and the 100Hz tick is not held
+ * off by packet assembly or other heavy per-interrupt work.
+ */
+
+#ifndef _SOFTIRQ_H
+#define _SOFTIRQ_H
+
+#include "types.h"
+
+/* Softirq numbers (one bit each in the pending mask) */
+#define SOFTIRQ_MOUSE   0
+#define SOFTIRQ_MAX     8
+
+/* Bottom-half handler: runs with interrupts enabled on IRQ exit */
+typedef void (*softirq_handler_t)(void);
+
+/*
+ * Register the bottom half for a softirq number
+ */
+void softirq_register(int nr, softirq_handler_t handler);
+
+/*
+ * Mark a softirq pending (call from hard-IRQ context)
+ */
+void softirq_raise(int nr);
+
+/*
+ * Run all pending bottom halves. Called from the IRQ exit path;
+ * non-reentrant, nested raises are picked up before returning.
+ */
+void softirq_run(void);
+
+#endif /* _SOFTIRQ_H */
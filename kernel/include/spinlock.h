@@ -0,0 +1,81 @@
+/*
+ * MiniOS Spinlocks
+ *
+ * Per-structure locks replacing scattered cli/sti. On this
+ * uniprocessor the irqsave variants are what makes a section safe
+ * against interrupt-context lockers (the spin itself only matters
+ * once SMP arrives), but taking the lock per structure keeps the
+ * masked window as short as the structure's own critical section and
+ * gives each one an acquisition/contention counter. Long-lived locks
+ * can be registered for the `locks` shell command (spinlock.c).
+ */
+
+#ifndef _SPINLOCK_H
+#define _SPINLOCK_H
+
+#include "types.h"
+#include "io.h"
+
+typedef struct spinlock {
+    volatile uint32_t locked;   /* 0 = free, 1 = held */
+    const char* name;           /* Shown by the locks report */
+    uint32_t acquisitions;      /* Times taken */
+    uint32_t contentions;       /* Found held on the first try */
+} spinlock_t;
+
+/* Static initializer: spinlock_t lock = SPINLOCK_INIT("name"); */
+#define SPINLOCK_INIT(n) { 0, (n), 0, 0 }
+
+/*
+ * Take a lock, spinning until it is free. Callers in process context
+ * must use the irqsave variant for any lock an interrupt handler can
+ * take, or the spin deadlocks on one CPU.
+ */
+static inline void spin_lock(spinlock_t* lock) {
+    if (__sync_lock_test_and_set(&lock->locked, 1) != 0) {
+        lock->contentions++;
+        do {
+            __asm__ volatile("pause");
+        } while (__sync_lock_test_and_set(&lock->locked, 1) != 0);
+    }
+    lock->acquisitions++;
+}
+
+static inline void spin_unlock(spinlock_t* lock) {
+    __sync_lock_release(&lock->locked);
+}
+
+/*
+ * Take a lock with interrupts masked, returning the previous EFLAGS
+ * for the matching spin_unlock_irqrestore. The masked window is
+ * timestamped by irqwatch like any irq_save section.
+ */
+static inline uint32_t spin_lock_irqsave(spinlock_t* lock) {
+    uint32_t eflags = irq_save();
+    spin_lock(lock);
+    return eflags;
+}
+
+static inline void spin_unlock_irqrestore(spinlock_t* lock, uint32_t eflags) {
+    spin_unlock(lock);
+    irq_restore(eflags);
+}
+
+/*
+ * Initialize a lock at runtime (dynamic structures; static ones can
+ * use SPINLOCK_INIT)
+ */
+static inline void spinlock_init(spinlock_t* lock, const char* name) {
+    lock->locked = 0;
+    lock->name = name;
+    lock->acquisitions = 0;
+    lock->contentions = 0;
+}
+
+/* Add a long-lived lock to the `locks` report table */
+void spinlock_register(spinlock_t* lock);
+
+/* Print every registered lock's counters via printk */
+void spinlock_report(void);
+
+#endif /* _SPINLOCK_H */
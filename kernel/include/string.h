@@ -49,6 +49,15 @@ void* memmove(void* dest, const void* src, size_t count);
  */
 int memcmp(const void* ptr1, const void* ptr2, size_t count);
 
+/*
+ * Find the first occurrence of a byte in a memory region
+ * ptr: memory region to scan
+ * value: byte to look for
+ * count: number of bytes to scan
+ * Returns: pointer to the byte, or NULL if not found
+ */
+void* memchr(const void* ptr, int value, size_t count);
+
 /* String operations */
 
 /*
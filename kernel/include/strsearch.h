@@ -0,0 +1,36 @@
+/*
+ * MiniOS Substring Search Header
+ *
+ * Boyer-Moore-Horspool matcher shared by grep, strings, and nano.
+ * The bad-character skip table is built once per pattern and reused
+ * across every buffer or line scanned, so long haystacks advance up
+ * to pattern-length bytes per mismatch instead of one.
+ */
+
+#ifndef _STRSEARCH_H
+#define _STRSEARCH_H
+
+#include "types.h"
+
+typedef struct {
+    const char* pattern;        /* Borrowed; must outlive the searches */
+    uint32_t len;
+    bool nocase;                /* Case-insensitive (ASCII) matching */
+    uint8_t skip[256];          /* BMH shifts, capped at 255 */
+} strsearch_t;
+
+/*
+ * Build the skip table for a pattern. The pattern string is borrowed,
+ * not copied.
+ */
+void strsearch_init(strsearch_t* s, const char* pattern, bool nocase);
+
+/*
+ * Find the first occurrence of the pattern in haystack[0..hay_len).
+ * Returns a pointer to the match or NULL. Single-byte case-sensitive
+ * patterns go through memchr directly.
+ */
+const char* strsearch_find(const strsearch_t* s, const char* haystack,
+                           uint32_t hay_len);
+
+#endif /* _STRSEARCH_H */
@@ -0,0 +1,74 @@
+/*
+ * MiniOS Swap
+ *
+ * Page-out to a dedicated swap partition so memory pressure degrades
+ * gracefully instead of failing allocations outright. The kswapd
+ * daemon scans user address spaces for cold pages (accessed-bit
+ * aging, see paging_scan_cold), writes them to the partition and
+ * replaces their PTEs with swap entries; the page fault handler reads
+ * them back in on first touch.
+ *
+ * A swap entry is a non-present PTE carrying the slot number in the
+ * frame field plus PAGE_SWAPPED and the original USER/WRITE bits, so
+ * fault-in can restore the mapping exactly.
+ */
+
+#ifndef _SWAP_H
+#define _SWAP_H
+
+#include "types.h"
+
+/* Returned by the slot allocator when the partition is full */
+#define SWAP_SLOT_INVALID   0xFFFFFFFF
+
+/* Swap usage counters (for diagnostics) */
+typedef struct {
+    uint32_t total_slots;       /* Slots on the partition */
+    uint32_t used_slots;        /* Slots holding a page */
+    uint32_t pages_out;         /* Pages written to swap since boot */
+    uint32_t pages_in;          /* Pages faulted back in since boot */
+} swap_stats_t;
+
+/*
+ * Find a Linux-swap partition among the registered block devices and
+ * build the slot bitmap. Called after the ATA probe; without a swap
+ * partition every other entry point is a no-op.
+ */
+void swap_init(void);
+
+/*
+ * True when a swap partition was found at init
+ */
+bool swap_available(void);
+
+/*
+ * True when free physical frames have dropped below the low watermark
+ * and kswapd should start evicting
+ */
+bool swap_pressure(void);
+
+/*
+ * Evict up to max_pages cold user pages to swap. Returns the number
+ * actually evicted (0 when nothing cold or swap is full).
+ */
+uint32_t swap_shrink(uint32_t max_pages);
+
+/*
+ * Fault a swapped-out page back in for the current address space.
+ * Returns true if fault_addr was a swap entry and the instruction can
+ * be retried.
+ */
+bool swap_handle_fault(uint32_t fault_addr);
+
+/*
+ * Release one slot (used by paging_free_directory for swap entries
+ * left behind by an exiting process)
+ */
+void swap_slot_free(uint32_t slot);
+
+/*
+ * Get swap usage counters
+ */
+void swap_get_stats(swap_stats_t* stats);
+
+#endif /* _SWAP_H */
@@ -45,8 +45,69 @@
 #define SYS_DUP2        28  /* int dup2(int oldfd, int newfd) - duplicate fd */
 #define SYS_KILL        29  /* int kill(pid_t pid, int sig) - send signal to process */
 #define SYS_SIGNAL      30  /* sighandler_t signal(int signum, sighandler_t handler) - set signal handler */
+#define SYS_POLL        31  /* int poll(pollfd_t* fds, uint32_t nfds, int32_t timeout_ms) */
+#define SYS_SHMGET      32  /* int shmget(int key, size_t size) - find/create shared segment */
+#define SYS_SHMAT       33  /* void* shmat(int id) - map segment into this process */
+#define SYS_SHMDT       34  /* int shmdt(int id) - unmap segment */
+#define SYS_SHMRM       35  /* int shmrm(int id) - free a fully detached segment */
+#define SYS_READV       36  /* ssize_t readv(int fd, const iovec_t* iov, int iovcnt) */
+#define SYS_WRITEV      37  /* ssize_t writev(int fd, const iovec_t* iov, int iovcnt) */
+#define SYS_GETTIME     38  /* int gettime(uint32_t ns[2]) - monotonic ns {hi, lo} */
+#define SYS_MMAP        39  /* void* mmap(int fd, off_t offset, size_t length) - map file read-only */
+#define SYS_MUNMAP      40  /* int munmap(void* addr) - drop a file mapping */
+#define SYS_SPAWN       41  /* int spawn(const char* path, char* const argv[]) - fork+exec in one step */
+#define SYS_TTYMODE     42  /* int ttymode(int raw) - console input mode: 0=canonical, 1=raw */
+#define SYS_IORING      43  /* int ioring_enter(ioring_t* ring) - drain a submission ring */
+#define SYS_FCNTL       44  /* int fcntl(int fd, int cmd, int arg) - descriptor control */
+#define SYS_SOCKET      45  /* int socket(void) - create a UDP datagram socket */
+#define SYS_BIND        46  /* int bind(int fd, uint16_t port) - bind socket to a local port */
+#define SYS_SENDTO      47  /* int sendto(int fd, const void* buf, size_t len, uint32_t ip, uint16_t port) */
+#define SYS_RECVFROM    48  /* int recvfrom(int fd, void* buf, size_t len, uint32_t from[2]) - blocks; from = {ip, port} */
 
-#define NUM_SYSCALLS    31
+#define NUM_SYSCALLS    49
+
+/*
+ * Batched syscall ring (SYS_IORING). The whole ring lives in user
+ * memory: userland appends submission entries at sq_tail, one
+ * ioring_enter call drains everything up to it and appends a
+ * completion entry per operation at cq_tail, so dozens of file
+ * operations pay for a single kernel crossing. Indices only ever
+ * grow; slot = index & (IORING_ENTRIES - 1).
+ */
+#define IORING_ENTRIES  64  /* Ring slots (power of two) */
+
+/* Submission opcodes */
+#define IORING_OP_NOP    0  /* Complete immediately (measurement aid) */
+#define IORING_OP_READ   1  /* fd, buf, len */
+#define IORING_OP_WRITE  2  /* fd, buf, len */
+#define IORING_OP_OPEN   3  /* path in buf, open flags in len */
+#define IORING_OP_CLOSE  4  /* fd */
+
+/* One submission */
+typedef struct {
+    uint8_t opcode;         /* IORING_OP_* */
+    uint8_t pad[3];
+    int32_t fd;             /* Descriptor (READ/WRITE/CLOSE) */
+    uint32_t buf;           /* User buffer or path pointer */
+    uint32_t len;           /* Buffer length or open flags */
+    uint32_t user_data;     /* Copied into the completion untouched */
+} ioring_sqe_t;
+
+/* One completion */
+typedef struct {
+    uint32_t user_data;     /* From the matching submission */
+    int32_t result;         /* The operation's syscall return value */
+} ioring_cqe_t;
+
+/* The shared ring */
+typedef struct {
+    uint32_t sq_head;       /* Kernel consumes submissions here */
+    uint32_t sq_tail;       /* Userland appends submissions here */
+    uint32_t cq_head;       /* Userland consumes completions here */
+    uint32_t cq_tail;       /* Kernel appends completions here */
+    ioring_sqe_t sqes[IORING_ENTRIES];
+    ioring_cqe_t cqes[IORING_ENTRIES];
+} ioring_t;
 
 /* Standard file descriptors */
 #define STDIN_FILENO    0
@@ -67,6 +128,17 @@ void syscall_init(void);
  */
 void syscall_register(uint32_t num, syscall_handler_t handler);
 
+/*
+ * Dispatcher for the SYSENTER fast path (called from sysenter_entry)
+ */
+int32_t syscall_fast_dispatch(uint32_t num, uint32_t a1, uint32_t a2, uint32_t a3);
+
+/*
+ * Point IA32_SYSENTER_ESP at the current kernel stack; no-op when the
+ * CPU lacks SYSENTER. Called alongside tss_set_kernel_stack().
+ */
+void syscall_sysenter_stack(uint32_t esp0);
+
 /*
  * System call implementations (in syscalls.c)
  */
@@ -86,6 +158,17 @@ int32_t sys_pipe(uint32_t pipefd_ptr, uint32_t, uint32_t, uint32_t, uint32_t);
 int32_t sys_dup2(uint32_t oldfd, uint32_t newfd, uint32_t, uint32_t, uint32_t);
 int32_t sys_kill(uint32_t pid, uint32_t sig, uint32_t, uint32_t, uint32_t);
 int32_t sys_signal(uint32_t signum, uint32_t handler, uint32_t, uint32_t, uint32_t);
+int32_t sys_poll(uint32_t fds_ptr, uint32_t nfds, uint32_t timeout_ms, uint32_t, uint32_t);
+int32_t sys_shmget(uint32_t key, uint32_t size, uint32_t, uint32_t, uint32_t);
+int32_t sys_shmat(uint32_t id, uint32_t, uint32_t, uint32_t, uint32_t);
+int32_t sys_shmdt(uint32_t id, uint32_t, uint32_t, uint32_t, uint32_t);
+int32_t sys_shmrm(uint32_t id, uint32_t, uint32_t, uint32_t, uint32_t);
+int32_t sys_readv(uint32_t fd, uint32_t iov_ptr, uint32_t iovcnt, uint32_t, uint32_t);
+int32_t sys_writev(uint32_t fd, uint32_t iov_ptr, uint32_t iovcnt, uint32_t, uint32_t);
+int32_t sys_gettime(uint32_t ts_ptr, uint32_t, uint32_t, uint32_t, uint32_t);
+int32_t sys_mmap(uint32_t fd, uint32_t offset, uint32_t length, uint32_t, uint32_t);
+int32_t sys_munmap(uint32_t addr, uint32_t, uint32_t, uint32_t, uint32_t);
+int32_t sys_ttymode(uint32_t mode, uint32_t, uint32_t, uint32_t, uint32_t);
 
 #endif /* _SYSCALL_H */
 
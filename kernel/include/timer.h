@@ -27,14 +27,35 @@ void timer_init(uint32_t frequency);
 /* Get current tick count */
 uint32_t timer_get_ticks(void);
 
-/* Sleep for specified number of ticks */
+/* Busy-wait for specified number of ticks */
 void timer_wait(uint32_t ticks);
 
+/* Block the current process for specified number of ticks (timer wheel) */
+void timer_sleep_ticks(uint32_t ticks);
+
 /* Sleep for specified number of milliseconds */
 void timer_sleep_ms(uint32_t ms);
 
 /* Register a timer callback */
 void timer_set_callback(timer_callback_t callback);
 
+/* Stretch the tick to the next wheel deadline (idle only, IF clear) */
+void timer_enter_idle(void);
+
+/* Restore the periodic tick after idle, crediting skipped ticks */
+void timer_exit_idle(void);
+
+/* Calibrate the TSC against the PIT (call once, interrupts enabled) */
+void timer_calibrate_tsc(void);
+
+/* Monotonic nanoseconds since calibration (tick granularity w/o TSC) */
+uint64_t timer_ns(void);
+
+/* Monotonic microseconds since calibration */
+uint64_t timer_us(void);
+
+/* Calibrated TSC rate in kHz, or 0 if the CPU has no TSC */
+uint32_t timer_tsc_khz(void);
+
 #endif /* _TIMER_H */
 
@@ -0,0 +1,78 @@
+/*
+ * MiniOS Static Tracepoint Framework
+ *
+ * Compiled-in tracepoints write fixed 16-byte records into a ring
+ * (one ring on this UP kernel; one per CPU if we ever go SMP). The
+ * TRACE() macro tests a single global category mask, so disabled
+ * tracepoints cost one compare and a predicted branch.
+ */
+
+#ifndef _TRACE_H
+#define _TRACE_H
+
+#include "types.h"
+
+/* Trace categories (bitmask) */
+#define TRACE_CAT_SCHED     0x01    /* Context switches */
+#define TRACE_CAT_SYSCALL   0x02    /* Syscall dispatch */
+#define TRACE_CAT_BLOCK     0x04    /* Block device I/O */
+#define TRACE_CAT_IPC       0x08    /* Pipe read/write */
+#define TRACE_CAT_GUI       0x10    /* Display flushes */
+#define TRACE_CAT_ALL       0x1F
+
+/* Event ids */
+#define TRACE_EV_SCHED_SWITCH   0   /* arg1 = prev pid, arg2 = next pid */
+#define TRACE_EV_SYSCALL        1   /* arg1 = syscall num, arg2 = arg1 */
+#define TRACE_EV_BLK_READ       2   /* arg1 = lba, arg2 = count */
+#define TRACE_EV_BLK_WRITE      3   /* arg1 = lba, arg2 = count */
+#define TRACE_EV_PIPE_READ      4   /* arg1 = bytes requested */
+#define TRACE_EV_PIPE_WRITE     5   /* arg1 = bytes requested */
+#define TRACE_EV_GUI_FLUSH      6   /* arg1 = dirty rect count */
+#define TRACE_NUM_EVENTS        7
+
+/* Ring size (records; 16 bytes each) */
+#define TRACE_RING_RECORDS  1024
+
+/* Fixed 16-byte trace record */
+typedef struct {
+    uint32_t us;                /* Low word of timer_us() */
+    uint16_t event;             /* TRACE_EV_* */
+    uint16_t pid;               /* Current pid at emit time */
+    uint32_t arg1;
+    uint32_t arg2;
+} __attribute__((packed)) trace_record_t;
+
+/* Enabled category mask; tested inline by TRACE() */
+extern uint32_t trace_enabled_mask;
+
+/* Emit one record and bump the event counter (category already on) */
+void trace_emit(uint16_t event, uint32_t arg1, uint32_t arg2);
+
+/*
+ * Static tracepoint: compiles to a mask test around the emit call
+ */
+#define TRACE(cat, ev, a1, a2)                          \
+    do {                                                \
+        if (trace_enabled_mask & (cat)) {               \
+            trace_emit((ev), (uint32_t)(a1), (uint32_t)(a2)); \
+        }                                               \
+    } while (0)
+
+/* Enable/disable categories */
+void trace_enable(uint32_t mask);
+void trace_disable(uint32_t mask);
+
+/* Reset the ring and counters */
+void trace_clear(void);
+
+/* Per-event hit counters (since last clear) */
+uint32_t trace_event_count(uint16_t event);
+const char* trace_event_name(uint16_t event);
+
+/*
+ * Walk the ring oldest-first; cb is called for each valid record.
+ * max_records limits output (0 = whole ring).
+ */
+void trace_dump(void (*cb)(const trace_record_t* rec), uint32_t max_records);
+
+#endif /* _TRACE_H */
@@ -0,0 +1,32 @@
+/*
+ * MiniOS TTY Line Discipline Header
+ *
+ * Canonical-mode buffering for console input delivered through the
+ * read() syscall. The kernel shell keeps talking to the keyboard
+ * driver directly; this layer only serves userland readers.
+ */
+
+#ifndef _TTY_H
+#define _TTY_H
+
+#include "types.h"
+
+/* Maximum canonical line length, including the trailing newline */
+#define TTY_LINE_SIZE 256
+
+/* Initialize the line discipline (canonical mode, empty line) */
+void tty_init(void);
+
+/* Select input mode: raw delivers every key immediately with no echo */
+void tty_set_raw(bool raw);
+
+/* Check current input mode */
+bool tty_is_raw(void);
+
+/* Read from the console. Canonical mode blocks until a full line has
+ * been edited and returns up to count bytes of it (terminated by '\n');
+ * raw mode blocks for the first key and then drains whatever else is
+ * buffered. Returns the number of bytes read. */
+int32_t tty_read(char* buf, uint32_t count);
+
+#endif /* _TTY_H */
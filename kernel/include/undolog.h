@@ -0,0 +1,99 @@
+/*
+ * MiniOS Editor Undo Journal
+ *
+ * Operation-based undo log shared by the text editors (nano, GUI
+ * editor). Instead of snapshotting whole lines per keystroke, edits
+ * are recorded as compact operations, and consecutive typing or
+ * deleting at the cursor coalesces into a single run record, so a
+ * long typing session costs one record instead of hundreds. Deleted
+ * text is kept in per-record heap buffers under a fixed byte budget;
+ * the oldest records are evicted when the budget or record count is
+ * exceeded. Undoing the newest operation is O(1) lookup: the caller
+ * peeks the record, applies the inverse edit, then drops it.
+ */
+
+#ifndef UNDOLOG_H
+#define UNDOLOG_H
+
+#include "types.h"
+
+/* Bounds: record ring size and total bytes of saved deleted text */
+#define UNDOLOG_MAX_OPS     64
+#define UNDOLOG_TEXT_BUDGET 8192
+
+/* Operation types */
+typedef enum {
+    UNDOLOG_INSERT,     /* Run of chars inserted at (line, col..col+len) */
+    UNDOLOG_DELETE,     /* Run of chars deleted at (line, col); text[] holds them */
+    UNDOLOG_SPLIT,      /* Line split (Enter) at (line, col) */
+    UNDOLOG_JOIN,       /* Line joined with the next at (line, col) */
+    UNDOLOG_KILL_LINE   /* Whole line deleted at line; text[] holds it */
+} undolog_type_t;
+
+/* One recorded operation */
+typedef struct {
+    uint8_t type;       /* undolog_type_t */
+    int line;           /* Line of the edit */
+    int col;            /* Start column of the edit */
+    int len;            /* Run length (chars) */
+    char* text;         /* Deleted text (heap, owned by the log) or NULL */
+    int cap;            /* Allocated bytes in text */
+} undolog_op_t;
+
+/* The journal: a ring of operations, newest at the tail */
+typedef struct {
+    undolog_op_t ops[UNDOLOG_MAX_OPS];
+    int head;           /* Index of the oldest record */
+    int count;          /* Number of live records */
+    int text_bytes;     /* Heap bytes currently held by text buffers */
+} undolog_t;
+
+/*
+ * Initialize an empty journal
+ */
+void undolog_init(undolog_t* log);
+
+/*
+ * Discard all records and release their text buffers
+ */
+void undolog_clear(undolog_t* log);
+
+/*
+ * Record a single inserted char at (line, col); extends the current
+ * typing run when the position continues it
+ */
+void undolog_record_insert(undolog_t* log, int line, int col);
+
+/*
+ * Record a single deleted char ch that sat at (line, col); extends the
+ * current delete run for Backspace and Delete-key sequences
+ */
+void undolog_record_delete(undolog_t* log, int line, int col, char ch);
+
+/*
+ * Record a line split (Enter) at (line, col)
+ */
+void undolog_record_split(undolog_t* log, int line, int col);
+
+/*
+ * Record line joined with the following one at (line, col)
+ */
+void undolog_record_join(undolog_t* log, int line, int col);
+
+/*
+ * Record a whole-line deletion; text is the line's former content
+ */
+void undolog_record_kill_line(undolog_t* log, int line, const char* text);
+
+/*
+ * Get the newest record, or NULL when the journal is empty.
+ * The caller applies the inverse edit, then calls undolog_drop().
+ */
+undolog_op_t* undolog_peek(undolog_t* log);
+
+/*
+ * Discard the newest record (after undoing it)
+ */
+void undolog_drop(undolog_t* log);
+
+#endif /* UNDOLOG_H */
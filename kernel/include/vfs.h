@@ -25,6 +25,13 @@
 #define VFS_SYMLINK     0x06
 #define VFS_MOUNTPOINT  0x08
 
+/* Type test for symlinks (the low bits carry the node type; the
+   mountpoint bit is OR'd on top) */
+#define VFS_IS_SYMLINK(n)   (((n)->flags & 0x07) == VFS_SYMLINK)
+
+/* Most symlinks a single lookup may follow (cycle guard) */
+#define VFS_LINK_MAX        8
+
 /* Open flags */
 #define O_RDONLY    0x0000
 #define O_WRONLY    0x0001
@@ -41,6 +48,7 @@
 /* Forward declarations */
 struct vfs_node;
 struct dirent;
+struct vfs_dir_cursor;
 
 /* File operations function pointers */
 typedef int32_t (*read_fn_t)(struct vfs_node*, uint32_t offset, uint32_t size, uint8_t* buffer);
@@ -48,7 +56,9 @@ typedef int32_t (*write_fn_t)(struct vfs_node*, uint32_t offset, uint32_t size,
 typedef int32_t (*open_fn_t)(struct vfs_node*, uint32_t flags);
 typedef int32_t (*close_fn_t)(struct vfs_node*);
 typedef struct dirent* (*readdir_fn_t)(struct vfs_node*, uint32_t index);
+typedef struct dirent* (*readdir_next_fn_t)(struct vfs_node*, struct vfs_dir_cursor*);
 typedef struct vfs_node* (*finddir_fn_t)(struct vfs_node*, const char* name);
+typedef int32_t (*readlink_fn_t)(struct vfs_node*, char* buf, uint32_t size);
 
 /* VFS node (inode) structure */
 typedef struct vfs_node {
@@ -69,11 +79,23 @@ typedef struct vfs_node {
     open_fn_t open;
     close_fn_t close;
     readdir_fn_t readdir;
+    readdir_next_fn_t readdir_next;
     finddir_fn_t finddir;
+    readlink_fn_t readlink;
 
     /* For mountpoints */
     struct vfs_node* ptr;       /* Mounted filesystem root */
     struct vfs_node* parent;    /* Parent directory */
+
+    /* Sequential-read detection (drives filesystem read-ahead) */
+    uint32_t ra_next_offset;    /* Offset a sequential reader would use next */
+    uint32_t ra_seq_count;      /* Consecutive sequential reads observed */
+    uint32_t ra_prefetched;     /* First block index not yet prefetched */
+
+    /* Cached permission verdicts (see vfs_check_read/write/exec) */
+    uint32_t perm_gen;          /* Credential generation when cached */
+    uint8_t perm_ok;            /* Verdict bits (PERM_READ/WRITE/EXEC) */
+    uint8_t perm_known;         /* Which verdict bits are valid */
 } vfs_node_t;
 
 /* Directory entry */
@@ -82,18 +104,34 @@ typedef struct dirent {
     uint32_t inode;
 } dirent_t;
 
-/* Forward declaration for pipe */
+/*
+ * Directory enumeration cursor (opendir-style). Remembers where the
+ * previous entry ended so each vfs_readdir_next() resumes in place
+ * instead of rescanning the directory from the start, making a full
+ * listing a single pass. fs_block/fs_offset are filesystem-private.
+ */
+typedef struct vfs_dir_cursor {
+    struct vfs_node* node;      /* Directory being enumerated */
+    uint32_t index;             /* Entries returned so far */
+    uint32_t fs_block;          /* Filesystem resume position */
+    uint32_t fs_offset;
+} vfs_dir_cursor_t;
+
+/* Forward declarations for pipe and socket */
 struct pipe;
+struct udp_socket;
 
 /* File descriptor */
 typedef struct {
     vfs_node_t* node;           /* VFS node */
     struct pipe* pipe;          /* Associated pipe (for pipes) */
+    struct udp_socket* sock;    /* Associated socket (for sockets) */
     uint32_t offset;            /* Current position */
     uint32_t flags;             /* Open flags */
     uint32_t refcount;          /* Reference count */
     bool is_pipe;               /* True if this is a pipe */
     bool is_read_end;           /* True if this is the read end of a pipe */
+    bool is_socket;             /* True if this is a socket */
 } file_descriptor_t;
 
 /* VFS root node */
@@ -104,22 +142,63 @@ extern vfs_node_t* vfs_root;
  */
 void vfs_init(void);
 
+/* Scatter-gather buffer descriptor for readv/writev */
+#define IOV_MAX 16
+
+typedef struct {
+    void* iov_base;             /* Buffer start */
+    uint32_t iov_len;           /* Buffer length in bytes */
+} iovec_t;
+
 /*
  * Standard file operations
  */
 int32_t vfs_read(vfs_node_t* node, uint32_t offset, uint32_t size, uint8_t* buffer);
 int32_t vfs_write(vfs_node_t* node, uint32_t offset, uint32_t size, uint8_t* buffer);
+int32_t vfs_readv(vfs_node_t* node, uint32_t offset, const iovec_t* iov, uint32_t iovcnt);
+int32_t vfs_writev(vfs_node_t* node, uint32_t offset, const iovec_t* iov, uint32_t iovcnt);
 int32_t vfs_open(vfs_node_t* node, uint32_t flags);
 int32_t vfs_close(vfs_node_t* node);
+
+/*
+ * Streaming file copy. Copies src's contents into dest through one
+ * large block-aligned heap buffer, so the cost is disk transfers, not
+ * per-call overhead. The optional progress callback is invoked after
+ * each chunk with (bytes_done, bytes_total). Returns bytes copied, or
+ * -1 on a read/write error.
+ */
+typedef void (*vfs_copy_progress_t)(uint32_t bytes_done, uint32_t bytes_total);
+int32_t vfs_copy_file(vfs_node_t* src, vfs_node_t* dest, vfs_copy_progress_t progress);
 dirent_t* vfs_readdir(vfs_node_t* node, uint32_t index);
 vfs_node_t* vfs_finddir(vfs_node_t* node, const char* name);
 
+/*
+ * Cursor-based directory enumeration. vfs_opendir() positions the
+ * cursor at the first entry; vfs_readdir_next() returns entries in
+ * order until NULL. Falls back to indexed readdir for filesystems
+ * without a readdir_next implementation.
+ */
+int vfs_opendir(vfs_node_t* node, vfs_dir_cursor_t* cursor);
+dirent_t* vfs_readdir_next(vfs_dir_cursor_t* cursor);
+
+/*
+ * Drop name-cache entries for (parent, name); NULL parent matches any.
+ * Filesystems must call this when a directory entry is removed.
+ */
+void vfs_dcache_invalidate(vfs_node_t* parent, const char* name);
+
 /*
  * Path operations
  */
 vfs_node_t* vfs_lookup(const char* path);
 vfs_node_t* vfs_namei(const char* path);  /* Resolve path to node */
 
+/*
+ * Read a symlink's target into buf (NUL-terminated). Returns the
+ * target length, or -1 if the node is not a symlink.
+ */
+int32_t vfs_readlink(vfs_node_t* node, char* buf, uint32_t size);
+
 /*
  * Mount operations
  */
@@ -134,5 +213,11 @@ int vfs_check_exec(vfs_node_t* node);
 int vfs_chmod(vfs_node_t* node, uint16_t mode);
 int vfs_chown(vfs_node_t* node, uint32_t uid, uint32_t gid);
 
+/*
+ * Drop every cached permission verdict; called when the current
+ * credentials change (login/logout/su).
+ */
+void vfs_perm_invalidate(void);
+
 #endif /* _VFS_H */
 
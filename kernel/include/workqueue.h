@@ -0,0 +1,50 @@
+/*
+ * MiniOS Kernel Workqueues
+ *
+ * A small pool of kernel worker threads pulls work items off a shared
+ * queue, so interrupt handlers and drivers can defer heavy processing
+ * with one cheap enqueue instead of owning a full daemon process each.
+ */
+
+#ifndef _WORKQUEUE_H
+#define _WORKQUEUE_H
+
+#include "types.h"
+
+/* Worker threads in the pool */
+#define WORKQUEUE_NUM_WORKERS 2
+
+/* Work item. Caller-owned: embed it in your own structure (or make it
+ * static) and keep it alive until the function has run. */
+typedef struct work {
+    void (*func)(void* data);   /* Runs in worker thread context */
+    void* data;                 /* Passed through to func */
+    uint32_t run_at_ticks;      /* Earliest tick to run (delayed work) */
+    struct work* next;          /* Queue linkage (internal) */
+    bool queued;                /* Already on a queue (internal) */
+} work_t;
+
+/*
+ * Start the worker pool (needs process_create, so call after the
+ * scheduler is initialized)
+ */
+void workqueue_init(void);
+
+/*
+ * Queue a work item for execution as soon as a worker is free.
+ * Safe from interrupt context. Returns 0, or -1 if already queued.
+ */
+int schedule_work(work_t* work);
+
+/*
+ * Queue a work item to run no earlier than delay_ms from now.
+ * Safe from interrupt context. Returns 0, or -1 if already queued.
+ */
+int schedule_delayed_work(work_t* work, uint32_t delay_ms);
+
+/*
+ * Items executed / currently queued (for diagnostics)
+ */
+void workqueue_get_stats(uint32_t* executed, uint32_t* pending);
+
+#endif /* _WORKQUEUE_H */
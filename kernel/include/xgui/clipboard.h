@@ -9,8 +9,11 @@
 
 #include "types.h"
 
-/* Maximum clipboard size */
-#define XGUI_CLIPBOARD_MAX  4096
+/* Size of the inline tier; snippets this small avoid the heap */
+#define XGUI_CLIPBOARD_INLINE 256
+
+/* Maximum clipboard size (larger texts are heap-allocated up to this) */
+#define XGUI_CLIPBOARD_MAX  65536
 
 /*
  * Initialize the clipboard
@@ -22,6 +25,25 @@ void xgui_clipboard_init(void);
  */
 void xgui_clipboard_set(const char* text, int length);
 
+/*
+ * Reserve writable clipboard storage for up to max_length chars.
+ * Fill it in place, then finish with xgui_clipboard_commit(); this
+ * skips the app-side staging buffer and its copy.
+ * Returns NULL if the reservation cannot be satisfied.
+ */
+char* xgui_clipboard_reserve(int max_length);
+
+/*
+ * Commit length chars written into the reserved buffer
+ */
+void xgui_clipboard_commit(int length);
+
+/*
+ * Hand a kmalloc'd, NUL-terminated buffer to the clipboard without
+ * copying; the clipboard takes ownership
+ */
+void xgui_clipboard_adopt(char* text, int length);
+
 /*
  * Get clipboard text. Returns pointer to internal buffer.
  * Returns NULL if clipboard is empty.
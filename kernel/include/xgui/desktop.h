@@ -99,8 +99,9 @@ bool xgui_desktop_has_wallpaper(void);
 #define DICON_TYPE_FILE 1
 bool xgui_desktop_add_icon(int type, const char* name, const char* path);
 void xgui_desktop_draw_icons(void);
+void xgui_desktop_invalidate_icons(void);
 void xgui_desktop_draw_popups(void);
-bool xgui_desktop_icon_click(int x, int y, int button);
+bool xgui_desktop_icon_click(int x, int y, int button, int click_count);
 void xgui_desktop_icon_mouse_move(int x, int y);
 bool xgui_desktop_icon_mouse_up(int x, int y);
 bool xgui_desktop_popup_visible(void);
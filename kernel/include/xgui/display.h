@@ -50,6 +50,14 @@
 #define XGUI_MENU_HIGHLIGHT XGUI_RGB(49, 106, 197)   /* Blue */
 #define XGUI_BORDER         XGUI_RGB(127, 157, 185)  /* Border color */
 
+/* Maximum tracked dirty rectangles before merging */
+#define XGUI_MAX_DIRTY_RECTS    16
+
+/* Dirty rectangle: half-open bounds [x1,x2) x [y1,y2) */
+typedef struct {
+    int x1, y1, x2, y2;
+} xgui_rect_t;
+
 /*
  * Display state structure
  */
@@ -67,10 +75,46 @@ typedef struct {
     int       green_mask_size;
     int       blue_position;
     int       blue_mask_size;
-    bool*     dirty_lines;      /* Dirty line flags for partial update */
+    bool      fb_native;        /* Framebuffer layout == backbuffer (straight copy) */
+    xgui_rect_t dirty_rects[XGUI_MAX_DIRTY_RECTS];  /* Pending dirty regions */
+    int       dirty_rect_count; /* Rects currently in the list */
+    bool      all_dirty;        /* Entire screen needs a flush */
     bool      initialized;      /* True if display is ready */
 } xgui_display_t;
 
+/*
+ * Compositor frame statistics. "Compose" covers window repaint and
+ * backbuffer rebuild (frame_begin to flush), "flush" the
+ * backbuffer-to-framebuffer copy; per-frame values describe the most
+ * recently flushed frame.
+ */
+typedef struct {
+    uint32_t frames;            /* Frames flushed since GUI start */
+    uint32_t fps;               /* Frames in the last full second */
+    uint32_t compose_us;        /* Compose time, last frame */
+    uint32_t compose_us_max;    /* Worst compose time */
+    uint32_t flush_us;          /* Flush time, last frame */
+    uint32_t flush_us_max;      /* Worst flush time */
+    uint32_t dirty_pixels;      /* Pixels flushed, last frame */
+    uint32_t dirty_rects;       /* Rects flushed, last frame */
+} xgui_frame_stats_t;
+
+/*
+ * Stamp the start of a frame; the next flush charges the elapsed time
+ * to compose_us
+ */
+void xgui_display_frame_begin(void);
+
+/*
+ * Copy out the frame statistics
+ */
+void xgui_display_get_frame_stats(xgui_frame_stats_t* stats);
+
+/*
+ * Toggle the on-screen frame-time HUD overlay
+ */
+void xgui_display_hud_toggle(void);
+
 /*
  * Initialize the display system
  * Returns 0 on success, -1 if VESA not available
@@ -89,6 +133,14 @@ void xgui_display_cleanup(void);
  */
 int xgui_display_reinit(void);
 
+/*
+ * Save-under cursor overlay: show caches the 16x16 framebuffer patch
+ * the cursor covers and draws over it; hide restores the patch. Both
+ * bypass the backbuffer and dirty list entirely.
+ */
+void xgui_display_cursor_show(int x, int y, const uint32_t* bitmap);
+void xgui_display_cursor_hide(void);
+
 /*
  * Check if display is available
  */
@@ -184,10 +236,16 @@ void xgui_display_copy_rect(int dst_x, int dst_y, int src_x, int src_y, int w, i
 void xgui_display_blit(int x, int y, int w, int h, const uint32_t* bitmap);
 
 /*
- * Mark a region as dirty (will be flushed on next flush call)
+ * Mark a full-width band of lines as dirty (will be flushed on next
+ * flush call)
  */
 void xgui_display_mark_dirty(int y_start, int y_end);
 
+/*
+ * Mark a rectangle as dirty (will be flushed on next flush call)
+ */
+void xgui_display_mark_dirty_rect(int x, int y, int w, int h);
+
 /*
  * Mark the entire display as dirty
  */
@@ -210,6 +268,11 @@ void xgui_display_fb_pixel(int x, int y, uint32_t color);
  */
 void xgui_display_flush_lines(int y_start, int y_end);
 
+/*
+ * Flush one rectangle from backbuffer to framebuffer (erase cursor overlay)
+ */
+void xgui_display_flush_rect(int x, int y, int w, int h);
+
 /*
  * Force flush the entire backbuffer (ignores dirty flags)
  */
@@ -19,6 +19,7 @@ typedef enum {
     XGUI_EVENT_MOUSE_UP,
     XGUI_EVENT_MOUSE_CLICK,
     XGUI_EVENT_MOUSE_DBLCLICK,
+    XGUI_EVENT_MOUSE_DRAGSTART,
     
     /* Keyboard events */
     XGUI_EVENT_KEY_DOWN,
@@ -59,6 +60,7 @@ typedef struct {
     uint8_t button;     /* Button that triggered event */
     uint8_t buttons;    /* Current button state */
     uint8_t modifiers;  /* Modifier keys held */
+    uint8_t click_count;/* Consecutive clicks at this spot (1=single, 2=double) */
 } xgui_mouse_event_t;
 
 /* Keyboard event data */
@@ -86,7 +88,7 @@ typedef struct {
 /* Generic event structure */
 typedef struct {
     xgui_event_type_t type;     /* Event type */
-    uint32_t timestamp;         /* Event timestamp (ticks) */
+    uint64_t timestamp;         /* Capture time in microseconds (TSC clock) */
     uint32_t window_id;         /* Target window ID (0 for global) */
     
     union {
@@ -100,6 +102,9 @@ typedef struct {
 /* Event queue size */
 #define XGUI_EVENT_QUEUE_SIZE 64
 
+/* Largest batch handed out per xgui_event_poll_batch() call */
+#define XGUI_EVENT_BATCH_MAX  32
+
 /*
  * Initialize the event system
  */
@@ -111,6 +116,17 @@ void xgui_event_init(void);
  */
 bool xgui_event_poll(xgui_event_t* event);
 
+/*
+ * Drain up to max_events pending events into the caller's array
+ * Returns the number of events filled in (0 if none were pending)
+ */
+int xgui_event_poll_batch(xgui_event_t* events, int max_events);
+
+/*
+ * Get the number of events dropped due to queue overflow
+ */
+uint32_t xgui_event_dropped(void);
+
 /*
  * Wait for the next event (blocking)
  */
@@ -29,6 +29,15 @@ void xgui_font_save_config(void);
 /* Get font bitmap for a character */
 const uint8_t* xgui_font_get_glyph(char c);
 
+/*
+ * Get a pre-expanded 32bpp tile (XGUI_FONT_WIDTH x XGUI_FONT_HEIGHT)
+ * for a character in the current font with the given colors. Tiles are
+ * cached per (font, char, fg, bg) so text blits with row copies
+ * instead of per-pixel bit tests. The pointer is valid until the next
+ * cache eviction, so copy from it immediately.
+ */
+const uint32_t* xgui_font_tile(char c, uint32_t fg, uint32_t bg);
+
 /* Draw a single character at (x, y) with foreground and background colors */
 void xgui_font_draw_char(int x, int y, char c, uint32_t fg, uint32_t bg);
 
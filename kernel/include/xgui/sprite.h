@@ -0,0 +1,64 @@
+/*
+ * MiniOS XGUI Sprite Scene
+ *
+ * Small helper for animated apps (games) that redraw a handful of
+ * moving sprites over a static background every frame. The background
+ * is captured once into an offscreen buffer; each frame the rects the
+ * sprites occupied are restored from it and the sprites redrawn at
+ * their new positions, so only the moved regions are touched and fed
+ * to the display dirty-rect list. Use with XGUI_WINDOW_NOCLEAR so the
+ * window buffer persists between paints.
+ */
+
+#ifndef _XGUI_SPRITE_H
+#define _XGUI_SPRITE_H
+
+#include "types.h"
+#include "xgui/wm.h"
+
+/* Maximum sprite rects tracked per frame */
+#define XGUI_SPRITE_MAX 64
+
+typedef struct {
+    xgui_window_t* window;
+    uint32_t* background;       /* Window-buffer snapshot, or NULL */
+    int width, height;          /* Buffer dimensions at capture time */
+
+    /* Rects drawn last frame, restored on the next begin() */
+    struct {
+        int x, y, w, h;
+    } rects[XGUI_SPRITE_MAX];
+    int rect_count;
+} xgui_sprite_scene_t;
+
+/*
+ * Attach a scene to a window. Allocates the background buffer;
+ * returns -1 if allocation fails (the caller should then fall back
+ * to full-frame redraws).
+ */
+int xgui_sprite_scene_init(xgui_sprite_scene_t* scene, xgui_window_t* win);
+
+/*
+ * Release the background buffer
+ */
+void xgui_sprite_scene_free(xgui_sprite_scene_t* scene);
+
+/*
+ * Snapshot the window buffer as the static background.
+ * Call after painting the full background once.
+ */
+void xgui_sprite_capture(xgui_sprite_scene_t* scene);
+
+/*
+ * Start a frame: restore every rect drawn last frame from the
+ * background and mark it dirty on the display.
+ */
+void xgui_sprite_begin(xgui_sprite_scene_t* scene);
+
+/*
+ * Register a sprite's bounds after drawing it. The rect is restored
+ * on the next begin() and its screen bounds are marked dirty now.
+ */
+void xgui_sprite_mark(xgui_sprite_scene_t* scene, int x, int y, int w, int h);
+
+#endif /* _XGUI_SPRITE_H */
@@ -23,6 +23,71 @@ typedef struct {
     uint32_t border;
 } xgui_theme_t;
 
+/* Maximum rows in a precomputed gradient strip (covers the title bar,
+ * the panel, and panel buttons — all at most 32px tall) */
+#define XGUI_THEME_GRAD_MAX 32
+
+/* Panel gradient-button kinds (all share the fixed panel-button height) */
+typedef enum {
+    XGUI_BTN_ACCENT,            /* Start button */
+    XGUI_BTN_ACCENT_PRESSED,    /* Start button, pressed */
+    XGUI_BTN_TASK_FOCUSED,      /* Focused task button */
+    XGUI_BTN_TASK,              /* Unfocused task button */
+    XGUI_BTN_NAV,               /* Taskbar scroll arrows */
+    XGUI_BTN_KIND_COUNT
+} xgui_btn_kind_t;
+
+/* One precomputed glossy button: per-row fill plus edge colors */
+typedef struct {
+    uint32_t rows[XGUI_THEME_GRAD_MAX];
+    uint32_t border;            /* Bottom/right edge (all edges when pressed) */
+    uint32_t edge_top;          /* Top edge */
+    uint32_t edge_left;         /* Left edge */
+} xgui_btn_grad_t;
+
+/*
+ * Colors and gradients derived from the active theme.
+ *
+ * The title bar, panel and button draw paths used to redo the
+ * lighten/darken/blend arithmetic for every row of every frame. All of
+ * it is now computed once here when a theme is applied (and after a
+ * display reinit), so per-draw theming is a table index.
+ */
+typedef struct {
+    /* Window frames (wm.c) */
+    uint32_t border_inactive;                    /* Faded border */
+    uint32_t title_grad[2][XGUI_THEME_GRAD_MAX]; /* Rows; [1] = focused */
+    int      title_rows;
+    uint32_t title_gloss;       /* 1px highlight atop a focused title bar */
+    uint32_t title_sep[2];      /* Separator above client area; [1] = focused */
+    uint32_t title_shadow;      /* Focused title text shadow */
+
+    /* Taskbar panel (desktop.c) */
+    uint32_t panel_grad[XGUI_THEME_GRAD_MAX];
+    int      panel_rows;
+    uint32_t panel_highlight;   /* 1px line at the panel's top edge */
+    uint32_t panel_text;
+    uint32_t panel_text_dim;    /* Minimized task button labels */
+    uint32_t panel_sep;         /* Clock/date separators */
+    uint32_t nav_text_dim;      /* Disabled taskbar scroll arrows */
+    uint32_t task_min_border;   /* Minimized task button outline */
+    uint32_t accent_text;       /* Text over selection-colored fills */
+    int      btn_rows;
+    xgui_btn_grad_t btn[XGUI_BTN_KIND_COUNT];
+
+    /* Start menu (desktop.c) — gradient endpoints, not rows: the body
+     * height depends on the item counts, so rows stay parametric */
+    struct {
+        uint32_t hover_top, hover_bot, hover_hi;    /* Item highlight */
+        uint32_t banner_top, banner_bot, banner_hi, banner_text;
+        uint32_t left_top, left_bot, left_text;
+        uint32_t right_top, right_bot, right_text, header_text;
+        uint32_t bottom_top, bottom_bot, bottom_hi;
+        uint32_t div_dark, div_light, left_sep;
+        uint32_t border_light, border_dark;
+    } menu;
+} xgui_theme_derived_t;
+
 /* Preset theme IDs */
 typedef enum {
     XGUI_THEME_CLASSIC,
@@ -48,6 +113,12 @@ const xgui_theme_t* xgui_theme_current(void);
 /* Get current theme ID */
 xgui_theme_id_t xgui_theme_current_id(void);
 
+/* Get the precomputed derived colors/gradients for the current theme */
+const xgui_theme_derived_t* xgui_theme_derived(void);
+
+/* Rebuild the derived tables (called by theme apply and display reinit) */
+void xgui_theme_rebuild_derived(void);
+
 /* Apply a preset theme */
 void xgui_theme_apply(xgui_theme_id_t id);
 
@@ -25,6 +25,7 @@ typedef enum {
 #define XGUI_WIDGET_ENABLED     0x02
 #define XGUI_WIDGET_FOCUSED     0x04
 #define XGUI_WIDGET_HOVERED     0x08
+#define XGUI_WIDGET_DIRTY       0x10    /* Needs repaint (see xgui_widget_invalidate) */
 
 /* Forward declaration */
 struct xgui_widget;
@@ -175,6 +176,32 @@ void xgui_widget_draw(xgui_widget_t* widget);
  */
 void xgui_widgets_draw(xgui_window_t* window);
 
+/*
+ * Mark one widget as needing repaint.
+ * Cheaper than xgui_window_invalidate(): only the dirty widget is
+ * redrawn and only its bounds reach the display dirty-rect list.
+ */
+void xgui_widget_invalidate(xgui_widget_t* widget);
+
+/*
+ * Repaint just the widgets marked dirty by xgui_widget_invalidate().
+ * Called by the WM for windows with no full repaint pending.
+ * Returns true if any widget was redrawn.
+ */
+bool xgui_widgets_repaint(xgui_window_t* window);
+
+/*
+ * True if any widget in the window is marked dirty
+ */
+bool xgui_widgets_any_dirty(xgui_window_t* window);
+
+/*
+ * True if the last xgui_widgets_handle_event() call consumed its event.
+ * The WM uses this to skip the full-window repaint when a widget has
+ * already invalidated just itself. Reading clears the flag.
+ */
+bool xgui_widgets_event_consumed(void);
+
 /*
  * Handle event for widgets in a window
  * Returns true if event was handled
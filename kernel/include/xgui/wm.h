@@ -26,6 +26,7 @@
 #define XGUI_WINDOW_TOPMOST     0x0200
 #define XGUI_WINDOW_MINIMIZED  0x0400
 #define XGUI_WINDOW_MAXIMIZED  0x0800
+#define XGUI_WINDOW_NOCLEAR    0x1000  /* Paint callback manages its own clearing */
 
 /* Default window flags */
 #define XGUI_WINDOW_DEFAULT     (XGUI_WINDOW_VISIBLE | XGUI_WINDOW_MOVABLE | \
@@ -63,7 +64,8 @@ typedef struct xgui_window {
     
     uint32_t* buffer;               /* Per-window pixel buffer (client area) */
     int buf_width, buf_height;      /* Buffer dimensions */
-    bool dirty;                     /* Needs repaint */
+    bool dirty;                     /* Content invalid: run the paint callback */
+    bool expose;                    /* Content valid: recomposite from buffer only */
     
     /* Saved geometry for maximize/restore */
     int saved_x, saved_y;
@@ -221,6 +223,12 @@ int xgui_wm_window_count(void);
  */
 bool xgui_wm_is_dragging(void);
 
+/*
+ * True if any visible window needs repainting (full or widget-level).
+ * Lets the main loop skip composition entirely on an idle desktop.
+ */
+bool xgui_wm_any_damage(void);
+
 /*
  * Composite all windows onto the screen backbuffer.
  * This blits each window's buffer; does NOT call paint callbacks.
@@ -241,5 +249,7 @@ void xgui_win_line(xgui_window_t* win, int x1, int y1, int x2, int y2, uint32_t
 void xgui_win_text(xgui_window_t* win, int x, int y, const char* str, uint32_t fg, uint32_t bg);
 void xgui_win_text_transparent(xgui_window_t* win, int x, int y, const char* str, uint32_t fg);
 void xgui_win_clear(xgui_window_t* win, uint32_t color);
+void xgui_win_copy_rect(xgui_window_t* win, int dst_x, int dst_y,
+                        int src_x, int src_y, int w, int h);
 
 #endif /* _XGUI_WM_H */
@@ -59,6 +59,18 @@ bool xgui_is_running(void);
  */
 void xgui_draw_cursor(int x, int y);
 
+/*
+ * Deadline timers: periodic apps register a callback with a tick
+ * deadline instead of polling every loop iteration. The main loop
+ * services due timers once per wakeup (timer IRQ granularity), so an
+ * idle desktop sleeps in hlt until the next frame is actually due.
+ */
+typedef void (*xgui_timer_cb_t)(void);
+int xgui_timer_after(uint32_t delay_ticks, xgui_timer_cb_t callback);
+int xgui_timer_every(uint32_t period_ticks, xgui_timer_cb_t callback);
+void xgui_timer_cancel(int id);
+void xgui_timers_run(void);
+
 /* Built-in applications */
 void xgui_calculator_create(void);
 void xgui_about_create(void);
@@ -77,7 +89,6 @@ void xgui_taskmgr_create(void);
 void xgui_diskutil_create(void);
 void xgui_clock_settings_create(void);
 void xgui_analogclock_create(void);
-void xgui_analogclock_update(void);
 void xgui_calendar_create(void);
 void xgui_calendar_toggle(void);
 void xgui_stickynotes_restore(void);
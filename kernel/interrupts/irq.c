@@ -9,6 +9,7 @@
 #include "../include/isr.h"
 #include "../include/pic.h"
 #include "../include/vga.h"
+#include "../include/softirq.h"
 
 /* IRQ handler table (separate from ISR handlers) */
 static isr_handler_t irq_handlers[16];
@@ -70,6 +71,10 @@ void irq_handler(registers_t* regs) {
     if (irq_handlers[irq] != NULL) {
         irq_handlers[irq](regs);
     }
+
+    /* Drain any bottom halves the handler raised, with interrupts
+     * enabled so the tick and other devices are not held off */
+    softirq_run();
 }
 
 /*
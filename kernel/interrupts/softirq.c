@@ -0,0 +1,61 @@
+/*
+ * MiniOS Softirq (Bottom Half) Implementation
+ *
+ * A pending bitmask raised from hard-IRQ context, drained on IRQ exit
+ * with interrupts re-enabled. A nesting flag makes the drain loop
+ * non-reentrant: an interrupt arriving mid-drain just sets its bit
+ * and the outer loop picks it up before returning.
+ */
+
+#include "../include/softirq.h"
+#include "../include/io.h"
+
+static softirq_handler_t softirq_handlers[SOFTIRQ_MAX];
+static volatile uint32_t softirq_pending = 0;
+static volatile bool softirq_active = false;
+
+void softirq_register(int nr, softirq_handler_t handler) {
+    if (nr >= 0 && nr < SOFTIRQ_MAX) {
+        softirq_handlers[nr] = handler;
+    }
+}
+
+void softirq_raise(int nr) {
+    if (nr >= 0 && nr < SOFTIRQ_MAX) {
+        softirq_pending |= (1u << nr);
+    }
+}
+
+void softirq_run(void) {
+    if (softirq_active || softirq_pending == 0) {
+        return;
+    }
+    softirq_active = true;
+
+    /* Bottom halves run with interrupts enabled - that is the point */
+    __asm__ volatile("sti");
+
+    for (;;) {
+        /* Atomically claim the current pending set */
+        uint32_t eflags = irq_save();
+        uint32_t bits = softirq_pending;
+        softirq_pending = 0;
+        irq_restore(eflags);
+
+        if (bits == 0) {
+            break;
+        }
+
+        while (bits != 0) {
+            int nr = __builtin_ctz(bits);
+            bits &= bits - 1;
+            if (softirq_handlers[nr] != NULL) {
+                softirq_handlers[nr]();
+            }
+        }
+    }
+
+    /* Leave the way we came in: IRQ context expects interrupts off */
+    __asm__ volatile("cli");
+    softirq_active = false;
+}
@@ -6,48 +6,57 @@
 #include "../include/heap.h"
 #include "../include/string.h"
 #include "../include/process.h"
+#include "../include/scheduler.h"
+#include "../include/socket.h"
+#include "../include/trace.h"
 
-/* Global file descriptor table (per-process in real implementation) */
-static file_descriptor_t* fd_table[MAX_FD];
+/* Pollers park here; any pipe state change that could satisfy a poll()
+ * (data arriving, space freeing, an end closing) wakes the queue */
+static wait_queue_t poll_wait;
 
 /*
- * Initialize file descriptor table
+ * Descriptors live in the owning process's fd_table; there is no
+ * global table. fd_next_free caches the lowest possibly-free slot so
+ * allocation doesn't rescan the whole table on every open.
  */
 void fd_init(void) {
-    for (int i = 0; i < MAX_FD; i++) {
-        fd_table[i] = NULL;
-    }
-
-    /* Reserve standard file descriptors */
-    /* stdin (0), stdout (1), stderr (2) would be initialized here */
+    wait_queue_init(&poll_wait);
 }
 
 /*
- * Allocate a new file descriptor
+ * Allocate a new file descriptor in the current process
  */
 int32_t fd_alloc(void) {
-    /* Start from 3 to reserve 0, 1, 2 for stdin, stdout, stderr */
-    for (int32_t i = 3; i < MAX_FD; i++) {
-        if (fd_table[i] == NULL) {
-            fd_table[i] = (file_descriptor_t*)kmalloc(sizeof(file_descriptor_t));
-            if (fd_table[i]) {
-                memset(fd_table[i], 0, sizeof(file_descriptor_t));
-                return i;
+    process_t* proc = process_current();
+    if (proc == NULL) return -1;
+
+    /* fd_next_free starts at 3: 0, 1, 2 are stdin, stdout, stderr */
+    for (int32_t i = proc->fd_next_free; i < MAX_FD; i++) {
+        if (proc->fd_table[i] == NULL) {
+            file_descriptor_t* desc =
+                (file_descriptor_t*)kmalloc(sizeof(file_descriptor_t));
+            if (desc == NULL) {
+                return -1;
             }
-            return -1;
+            memset(desc, 0, sizeof(file_descriptor_t));
+            proc->fd_table[i] = (struct file_descriptor*)desc;
+            proc->fd_next_free = i + 1;
+            return i;
         }
     }
     return -1;  /* No free descriptors */
 }
 
 /*
- * Free a file descriptor
+ * Close and free a file descriptor of the current process
  */
 void fd_free(int32_t fd) {
+    process_t* proc = process_current();
+    if (proc == NULL) return;
     if (fd < 0 || fd >= MAX_FD) return;
-    if (fd_table[fd] == NULL) return;
 
-    file_descriptor_t* descriptor = fd_table[fd];
+    file_descriptor_t* descriptor = (file_descriptor_t*)proc->fd_table[fd];
+    if (descriptor == NULL) return;
 
     /* Close pipe if this is a pipe descriptor */
     if (descriptor->is_pipe && descriptor->pipe) {
@@ -55,11 +64,17 @@ void fd_free(int32_t fd) {
             descriptor->pipe->readers--;
             if (descriptor->pipe->readers == 0) {
                 descriptor->pipe->read_open = false;
+                /* Blocked writers must see the broken pipe */
+                wake_up(&descriptor->pipe->write_wait);
+                wake_up(&poll_wait);
             }
         } else {
             descriptor->pipe->writers--;
             if (descriptor->pipe->writers == 0) {
                 descriptor->pipe->write_open = false;
+                /* Blocked readers must see EOF */
+                wake_up(&descriptor->pipe->read_wait);
+                wake_up(&poll_wait);
             }
         }
 
@@ -67,52 +82,84 @@ void fd_free(int32_t fd) {
         if (!descriptor->pipe->read_open && !descriptor->pipe->write_open) {
             pipe_destroy(descriptor->pipe);
         }
+    } else if (descriptor->is_socket && descriptor->sock) {
+        socket_close(descriptor->sock);
+    } else if (descriptor->node) {
+        vfs_close(descriptor->node);
     }
 
-    kfree(fd_table[fd]);
-    fd_table[fd] = NULL;
+    kfree(descriptor);
+    proc->fd_table[fd] = NULL;
+    if (fd < proc->fd_next_free) {
+        proc->fd_next_free = fd;
+    }
 }
 
 /*
- * Get file descriptor structure
+ * Get file descriptor structure from the current process
  */
 file_descriptor_t* fd_get(int32_t fd) {
+    process_t* proc = process_current();
+    if (proc == NULL) return NULL;
     if (fd < 0 || fd >= MAX_FD) return NULL;
-    return fd_table[fd];
+    return (file_descriptor_t*)proc->fd_table[fd];
 }
 
 /*
  * Duplicate file descriptor (dup2)
  */
 int32_t fd_dup2(int32_t oldfd, int32_t newfd) {
+    process_t* proc = process_current();
+    if (proc == NULL) return -1;
     if (oldfd < 0 || oldfd >= MAX_FD) return -1;
     if (newfd < 0 || newfd >= MAX_FD) return -1;
-    if (fd_table[oldfd] == NULL) return -1;
+
+    file_descriptor_t* old_desc = (file_descriptor_t*)proc->fd_table[oldfd];
+    if (old_desc == NULL) return -1;
+    if (oldfd == newfd) return newfd;
 
     /* Close newfd if it's already open */
-    if (fd_table[newfd] != NULL) {
+    if (proc->fd_table[newfd] != NULL) {
         fd_free(newfd);
     }
 
     /* Allocate new descriptor */
-    fd_table[newfd] = (file_descriptor_t*)kmalloc(sizeof(file_descriptor_t));
-    if (!fd_table[newfd]) return -1;
+    file_descriptor_t* new_desc =
+        (file_descriptor_t*)kmalloc(sizeof(file_descriptor_t));
+    if (new_desc == NULL) return -1;
 
     /* Copy descriptor */
-    memcpy(fd_table[newfd], fd_table[oldfd], sizeof(file_descriptor_t));
+    memcpy(new_desc, old_desc, sizeof(file_descriptor_t));
+    proc->fd_table[newfd] = (struct file_descriptor*)new_desc;
 
     /* Increment reference counts for pipes */
-    if (fd_table[newfd]->is_pipe && fd_table[newfd]->pipe) {
-        if (fd_table[newfd]->is_read_end) {
-            fd_table[newfd]->pipe->readers++;
+    if (new_desc->is_pipe && new_desc->pipe) {
+        if (new_desc->is_read_end) {
+            new_desc->pipe->readers++;
         } else {
-            fd_table[newfd]->pipe->writers++;
+            new_desc->pipe->writers++;
         }
     }
 
     return newfd;
 }
 
+/*
+ * Close every descriptor the current process still holds. Called on
+ * exit so pipe peers see EOF/EPIPE and nothing leaks with the slot.
+ */
+void fd_close_all(void) {
+    process_t* proc = process_current();
+    if (proc == NULL) return;
+
+    for (int32_t fd = 3; fd < MAX_FD; fd++) {
+        if (proc->fd_table[fd] != NULL) {
+            fd_free(fd);
+        }
+    }
+    proc->fd_next_free = 3;
+}
+
 /*
  * Create a new pipe
  */
@@ -121,6 +168,13 @@ pipe_t* pipe_create(void) {
     if (!pipe) return NULL;
 
     memset(pipe, 0, sizeof(pipe_t));
+    pipe->buffer = (uint8_t*)kmalloc(PIPE_BUF_SIZE);
+    if (pipe->buffer == NULL) {
+        kfree(pipe);
+        return NULL;
+    }
+    pipe->capacity = PIPE_BUF_SIZE;
+    pipe->max_capacity = PIPE_BUF_MAX;
     pipe->read_pos = 0;
     pipe->write_pos = 0;
     pipe->data_size = 0;
@@ -128,6 +182,9 @@ pipe_t* pipe_create(void) {
     pipe->write_open = true;
     pipe->readers = 0;
     pipe->writers = 0;
+    wait_queue_init(&pipe->read_wait);
+    wait_queue_init(&pipe->write_wait);
+    spinlock_init(&pipe->lock, "pipe");
 
     return pipe;
 }
@@ -137,6 +194,7 @@ pipe_t* pipe_create(void) {
  */
 void pipe_destroy(pipe_t* pipe) {
     if (pipe) {
+        kfree(pipe->buffer);
         kfree(pipe);
     }
 }
@@ -152,7 +210,67 @@ bool pipe_is_empty(pipe_t* pipe) {
  * Check if pipe is full
  */
 bool pipe_is_full(pipe_t* pipe) {
-    return pipe->data_size >= PIPE_BUF_SIZE;
+    return pipe->data_size >= pipe->capacity;
+}
+
+/*
+ * Set a pipe's growth cap (F_SETPIPE_SZ). The buffer itself still
+ * grows lazily, when a writer actually fills it; lowering the cap
+ * below the current capacity just stops further growth. Returns the
+ * cap after clamping to [PIPE_BUF_SIZE, PIPE_BUF_MAX].
+ */
+uint32_t pipe_set_capacity(pipe_t* pipe, uint32_t bytes) {
+    if (bytes < PIPE_BUF_SIZE) bytes = PIPE_BUF_SIZE;
+    if (bytes > PIPE_BUF_MAX) bytes = PIPE_BUF_MAX;
+    pipe->max_capacity = bytes;
+    return bytes;
+}
+
+/*
+ * Double a full pipe's buffer (up to max_capacity) so the writer can
+ * keep streaming instead of blocking. The new buffer is allocated
+ * with the lock dropped; the copy linearizes the ring. Returns false
+ * if the pipe is already at its cap or the allocation failed.
+ */
+static bool pipe_grow(pipe_t* pipe) {
+    uint32_t new_cap = pipe->capacity * 2;
+    if (pipe->capacity >= pipe->max_capacity) {
+        return false;
+    }
+    if (new_cap > pipe->max_capacity) {
+        new_cap = pipe->max_capacity;
+    }
+
+    uint8_t* new_buf = (uint8_t*)kmalloc(new_cap);
+    if (new_buf == NULL) {
+        return false;
+    }
+
+    uint32_t eflags = spin_lock_irqsave(&pipe->lock);
+    if (new_cap <= pipe->capacity) {
+        /* Someone else grew it while we were allocating */
+        spin_unlock_irqrestore(&pipe->lock, eflags);
+        kfree(new_buf);
+        return true;
+    }
+
+    /* Unwrap the ring into the start of the new buffer */
+    uint32_t run = pipe->capacity - pipe->read_pos;
+    if (run > pipe->data_size) run = pipe->data_size;
+    memcpy(new_buf, &pipe->buffer[pipe->read_pos], run);
+    if (run < pipe->data_size) {
+        memcpy(new_buf + run, pipe->buffer, pipe->data_size - run);
+    }
+
+    uint8_t* old_buf = pipe->buffer;
+    pipe->buffer = new_buf;
+    pipe->capacity = new_cap;
+    pipe->read_pos = 0;
+    pipe->write_pos = pipe->data_size;
+    spin_unlock_irqrestore(&pipe->lock, eflags);
+
+    kfree(old_buf);
+    return true;
 }
 
 /*
@@ -162,24 +280,48 @@ bool pipe_is_full(pipe_t* pipe) {
 int32_t pipe_read(pipe_t* pipe, uint8_t* buffer, uint32_t size) {
     if (!pipe || !buffer) return -1;
 
-    /* If pipe is empty and write end is closed, return EOF */
-    if (pipe_is_empty(pipe) && !pipe->write_open) {
-        return 0;  /* EOF */
+    TRACE(TRACE_CAT_IPC, TRACE_EV_PIPE_READ, size, 0);
+
+    /* Block until data arrives or the write end closes (EOF). Before
+     * the scheduler runs there is nobody to wake us, so don't block. */
+    while (pipe_is_empty(pipe) && pipe->write_open) {
+        if (!scheduler_running()) {
+            return 0;  /* Would block */
+        }
+        sleep_on(&pipe->read_wait);
     }
 
-    /* If pipe is empty and write end is open, block would happen here */
-    /* For simplicity, we return 0 (would need scheduler integration for real blocking) */
+    /* Empty with write end closed: EOF */
     if (pipe_is_empty(pipe)) {
-        return 0;  /* Would block - TODO: implement blocking */
+        return 0;
     }
 
     uint32_t bytes_read = 0;
+    uint32_t eflags = spin_lock_irqsave(&pipe->lock);
     while (bytes_read < size && !pipe_is_empty(pipe)) {
-        buffer[bytes_read] = pipe->buffer[pipe->read_pos];
-        pipe->read_pos = (pipe->read_pos + 1) % PIPE_BUF_SIZE;
-        pipe->data_size--;
-        bytes_read++;
+        /* Copy the contiguous run up to the end of the ring in one go */
+        uint32_t chunk = size - bytes_read;
+        if (chunk > pipe->data_size) chunk = pipe->data_size;
+        uint32_t run = pipe->capacity - pipe->read_pos;
+        if (chunk > run) chunk = run;
+
+        memcpy(buffer + bytes_read, &pipe->buffer[pipe->read_pos], chunk);
+        pipe->read_pos = (pipe->read_pos + chunk) % pipe->capacity;
+        pipe->data_size -= chunk;
+        bytes_read += chunk;
+    }
+    uint32_t free_space = pipe->capacity - pipe->data_size;
+    uint32_t low_wm = pipe->capacity / 4;
+    spin_unlock_irqrestore(&pipe->lock, eflags);
+
+    /* Low watermark: wake blocked writers once a quarter of the
+     * buffer is free, so they refill in large chunks rather than
+     * byte-by-byte. A writer sleeps only on a full pipe, and free
+     * space only grows while it sleeps, so this always fires. */
+    if (free_space >= low_wm) {
+        wake_up(&pipe->write_wait);
     }
+    wake_up(&poll_wait);
 
     return bytes_read;
 }
@@ -191,20 +333,73 @@ int32_t pipe_read(pipe_t* pipe, uint8_t* buffer, uint32_t size) {
 int32_t pipe_write(pipe_t* pipe, const uint8_t* buffer, uint32_t size) {
     if (!pipe || !buffer) return -1;
 
+    TRACE(TRACE_CAT_IPC, TRACE_EV_PIPE_WRITE, size, 0);
+
     /* If read end is closed, return error (SIGPIPE in real Unix) */
     if (!pipe->read_open) {
         return -1;  /* Broken pipe */
     }
 
-    /* If pipe is full, block would happen here */
-    /* For simplicity, we write what we can (would need scheduler for real blocking) */
+    bool was_empty = pipe_is_empty(pipe);
     uint32_t bytes_written = 0;
-    while (bytes_written < size && !pipe_is_full(pipe)) {
-        pipe->buffer[pipe->write_pos] = buffer[bytes_written];
-        pipe->write_pos = (pipe->write_pos + 1) % PIPE_BUF_SIZE;
-        pipe->data_size++;
-        bytes_written++;
+    while (bytes_written < size) {
+        if (!pipe->read_open) {
+            /* Reader went away mid-write */
+            break;
+        }
+
+        uint32_t eflags = spin_lock_irqsave(&pipe->lock);
+        if (pipe_is_full(pipe)) {
+            spin_unlock_irqrestore(&pipe->lock, eflags);
+            /* Grow instead of blocking while the cap allows it */
+            if (pipe_grow(pipe)) {
+                continue;
+            }
+            /* Without a scheduler, keep the old write-what-fits behavior */
+            if (!scheduler_running()) {
+                break;
+            }
+            /* Let readers drain, then block until there is room */
+            wake_up(&pipe->read_wait);
+            sleep_on(&pipe->write_wait);
+            continue;
+        }
+
+        /* Empty pipe: rewind so the copy lands in one contiguous run */
+        if (pipe->data_size == 0) {
+            pipe->read_pos = 0;
+            pipe->write_pos = 0;
+        }
+
+        uint32_t chunk = size - bytes_written;
+        uint32_t space = pipe->capacity - pipe->data_size;
+        if (chunk > space) chunk = space;
+        uint32_t run = pipe->capacity - pipe->write_pos;
+        if (chunk > run) chunk = run;
+
+        memcpy(&pipe->buffer[pipe->write_pos], buffer + bytes_written, chunk);
+        pipe->write_pos = (pipe->write_pos + chunk) % pipe->capacity;
+        pipe->data_size += chunk;
+        bytes_written += chunk;
+        spin_unlock_irqrestore(&pipe->lock, eflags);
+    }
+
+    /* High watermark: wake readers on the empty->non-empty edge (a
+     * reader sleeps only on an empty pipe, so this bounds its wait)
+     * or once the buffer is half full; in between, a fast producer
+     * keeps streaming without handing the CPU over per write. */
+    if (bytes_written > 0 &&
+        (was_empty || pipe->data_size >= pipe->capacity / 2)) {
+        wake_up(&pipe->read_wait);
+        wake_up(&poll_wait);
     }
 
     return bytes_written;
 }
+
+/*
+ * Wait queue for poll() sleepers
+ */
+wait_queue_t* pipe_poll_queue(void) {
+    return &poll_wait;
+}
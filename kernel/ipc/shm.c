@@ -0,0 +1,128 @@
+/*
+ * MiniOS Shared Memory Implementation
+ */
+
+#include "../include/shm.h"
+#include "../include/paging.h"
+#include "../include/string.h"
+
+/* Global segment table */
+static struct {
+    bool used;
+    int32_t key;                    /* Rendezvous key for shm_get() */
+    uint32_t size;                  /* Requested size in bytes */
+    uint32_t npages;
+    uint32_t attach_count;          /* Live mappings across all processes */
+    uint32_t frames[SHM_MAX_PAGES]; /* Backing physical frames */
+} segments[SHM_MAX_SEGMENTS];
+
+/*
+ * Initialize the segment table
+ */
+void shm_init(void) {
+    memset(segments, 0, sizeof(segments));
+}
+
+/*
+ * Find or create a segment
+ */
+int32_t shm_get(int32_t key, uint32_t size) {
+    /* Existing segment with this key? */
+    for (int i = 0; i < SHM_MAX_SEGMENTS; i++) {
+        if (segments[i].used && segments[i].key == key) {
+            if (size > segments[i].npages * PAGE_SIZE) {
+                return -1;  /* Larger than the existing segment */
+            }
+            return i;
+        }
+    }
+
+    if (size == 0 || size > SHM_MAX_PAGES * PAGE_SIZE) {
+        return -1;
+    }
+
+    /* Create a new one in the first free slot */
+    for (int i = 0; i < SHM_MAX_SEGMENTS; i++) {
+        if (segments[i].used) {
+            continue;
+        }
+
+        uint32_t npages = PAGE_ALIGN_UP(size) / PAGE_SIZE;
+        for (uint32_t p = 0; p < npages; p++) {
+            uint32_t frame = pmm_alloc_frame();
+            if (frame == 0) {
+                while (p > 0) {
+                    pmm_free_frame(segments[i].frames[--p]);
+                }
+                return -1;  /* Out of frames */
+            }
+            /* Frames are identity-mapped in kernel space */
+            memset((void*)frame, 0, PAGE_SIZE);
+            segments[i].frames[p] = frame;
+        }
+
+        segments[i].used = true;
+        segments[i].key = key;
+        segments[i].size = size;
+        segments[i].npages = npages;
+        segments[i].attach_count = 0;
+        return i;
+    }
+
+    return -1;  /* Table full */
+}
+
+/*
+ * Map a segment into the current address space at its fixed window
+ */
+uint32_t shm_attach(int32_t id) {
+    if (id < 0 || id >= SHM_MAX_SEGMENTS || !segments[id].used) {
+        return 0;
+    }
+
+    uint32_t base = SHM_VADDR_BASE + (uint32_t)id * SHM_SLOT_BYTES;
+    for (uint32_t p = 0; p < segments[id].npages; p++) {
+        paging_map_page(base + p * PAGE_SIZE, segments[id].frames[p],
+                        PAGE_USER_RW);
+    }
+
+    segments[id].attach_count++;
+    return base;
+}
+
+/*
+ * Unmap a segment from the current address space
+ */
+int32_t shm_detach(int32_t id) {
+    if (id < 0 || id >= SHM_MAX_SEGMENTS || !segments[id].used) {
+        return -1;
+    }
+
+    uint32_t base = SHM_VADDR_BASE + (uint32_t)id * SHM_SLOT_BYTES;
+    for (uint32_t p = 0; p < segments[id].npages; p++) {
+        paging_unmap_page(base + p * PAGE_SIZE);
+    }
+
+    if (segments[id].attach_count > 0) {
+        segments[id].attach_count--;
+    }
+    return 0;
+}
+
+/*
+ * Free a segment's frames once every attachment is gone
+ */
+int32_t shm_remove(int32_t id) {
+    if (id < 0 || id >= SHM_MAX_SEGMENTS || !segments[id].used) {
+        return -1;
+    }
+    if (segments[id].attach_count != 0) {
+        return -1;  /* Still mapped somewhere */
+    }
+
+    for (uint32_t p = 0; p < segments[id].npages; p++) {
+        pmm_free_frame(segments[id].frames[p]);
+    }
+    segments[id].used = false;
+    return 0;
+}
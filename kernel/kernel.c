@@ -15,20 +15,30 @@
 #include "include/pic.h"
 #include "include/stdio.h"
 #include "include/keyboard.h"
+#include "include/tty.h"
 #include "include/timer.h"
+#include "include/irqwatch.h"
 #include "include/pmm.h"
 #include "include/paging.h"
+#include "include/swap.h"
+#include "include/net.h"
+#include "include/smp.h"
 #include "include/heap.h"
+#include "include/slab.h"
 #include "include/process.h"
 #include "include/scheduler.h"
+#include "include/workqueue.h"
 #include "include/syscall.h"
 #include "include/vfs.h"
 #include "include/ramfs.h"
+#include "include/procfs.h"
 #include "include/shell.h"
 #include "include/loader.h"
+#include "include/elf.h"
 #include "include/user.h"
 #include "include/daemon.h"
 #include "include/pagefault.h"
+#include "include/fpu.h"
 #include "include/ata.h"
 #include "include/blockdev.h"
 #include "include/ext2.h"
@@ -36,6 +46,7 @@
 #include "include/xgui/xgui.h"
 #include "include/serial.h"
 #include "include/rtc.h"
+#include "include/bootprof.h"
 
 /* Kernel end symbol from linker script */
 extern uint32_t _kernel_end;
@@ -81,6 +92,69 @@ static bool cmdline_has_flag(multiboot_info_t* mboot, const char* flag) {
     return false;
 }
 
+/*
+ * Install GRUB-loaded modules as executables in /bin. Each module's
+ * string names the binary (path components and arguments stripped);
+ * a module named like an embedded binary replaces it, so the netboot
+ * farm can pass fresh init/shell/test builds without relinking the
+ * kernel. The copy goes through ramfs, after which the module frames
+ * are returned to the allocator, and each binary is pre-parsed into
+ * the program cache so its first launch skips the header pass.
+ */
+static void install_boot_modules(multiboot_info_t* mboot, vfs_node_t* bin_dir) {
+    if (!(mboot->flags & MULTIBOOT_INFO_MODS) || mboot->mods_count == 0) {
+        return;
+    }
+
+    multiboot_module_t* mods = (multiboot_module_t*)mboot->mods_addr;
+    for (uint32_t i = 0; i < mboot->mods_count; i++) {
+        uint32_t size = (mods[i].mod_end > mods[i].mod_start)
+                            ? mods[i].mod_end - mods[i].mod_start : 0;
+        if (size == 0) {
+            continue;
+        }
+
+        /* Derive the binary name from the module string */
+        char name[VFS_MAX_NAME];
+        const char* str = (mods[i].cmdline != 0) ? (const char*)mods[i].cmdline : "";
+        const char* base = strrchr(str, '/');
+        base = (base != NULL) ? base + 1 : str;
+        uint32_t n = 0;
+        while (base[n] != '\0' && base[n] != ' ' && n < VFS_MAX_NAME - 1) {
+            name[n] = base[n];
+            n++;
+        }
+        name[n] = '\0';
+        if (name[0] == '\0') {
+            snprintf(name, sizeof(name), "mod%u", i);
+        }
+
+        vga_write("[ OK ] ", vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
+        vga_puts("Installing boot module ");
+        vga_puts(name);
+        vga_puts("...\n");
+
+        vfs_node_t* file = vfs_finddir(bin_dir, name);
+        if (file == NULL) {
+            file = ramfs_create_file_in(bin_dir, name, VFS_FILE);
+        }
+        if (file == NULL) {
+            continue;
+        }
+        file->mode = 0755;
+        file->length = 0;  /* Replace an embedded copy, don't append to it */
+        vfs_write(file, 0, size, (uint8_t*)mods[i].mod_start);
+
+        /* Warm the program cache so the first launch skips the parse */
+        char path[VFS_MAX_PATH];
+        snprintf(path, sizeof(path), "/bin/%s", name);
+        elf_preparse_file(path);
+
+        /* The ramfs copy is authoritative now; return the frames */
+        pmm_mark_region_free(mods[i].mod_start, size);
+    }
+}
+
 /*
  * Print a hexadecimal number
  */
@@ -214,6 +288,46 @@ static void parse_fstab(void) {
     }
 }
 
+/*
+ * Background bring-up: the boot stages dominated by device waits.
+ * The ATA probe alone can burn hundreds of milliseconds in identify
+ * timeouts, so it and everything downstream of the disk (fstab
+ * mounts, conf tunables, daemon startup) run in a kernel process;
+ * the shell prompt appears while the probe is still going. Order
+ * inside the sequence still matters: mounts need the probe, the
+ * tunables and some daemons want the mounts. Anything that asks for
+ * conf before /mnt is up just sees defaults, as it always did on a
+ * diskless boot.
+ */
+static void boot_bg_main_sync(void) {
+    ata_init();
+    bootprof_stamp("ata");
+
+    /* Partitions are probed now: look for a swap partition so kswapd
+     * has somewhere to evict to */
+    swap_init();
+
+    /* Bring up networking if a supported NIC is installed */
+    net_init();
+    bootprof_stamp("net");
+
+    /* Parse /etc/fstab and auto-mount filesystems */
+    parse_fstab();
+    bootprof_stamp("mounts");
+
+    /* Config filesystem is reachable now: pick up scheduler tunables */
+    scheduler_load_conf();
+
+    /* Start all system daemons */
+    daemon_start_all();
+    bootprof_stamp("daemons");
+}
+
+static void boot_bg_main(void) {
+    boot_bg_main_sync();
+    process_exit(0);
+}
+
 /*
  * Kernel main entry point
  * Called from boot.asm with multiboot info
@@ -222,10 +336,12 @@ void kernel_main(uint32_t magic, multiboot_info_t* mboot) {
     /* Serial first (useful for debugging graphics-mode boots) */
     serial_init();
     serial_write_string("MiniOS: kernel_main entry\n");
+    bootprof_stamp("entry");
 
     /* Initialize VGA driver first so we can output text */
     vga_init();
     serial_write_string("MiniOS: vga_init done\n");
+    bootprof_stamp("vga");
     
     /* Print banner */
     vga_write("=====================================\n", 
@@ -287,9 +403,13 @@ void kernel_main(uint32_t magic, multiboot_info_t* mboot) {
 
     /* Initialize IDT */
     idt_init();
+    bootprof_stamp("cpu");
     vga_write("[ OK ] ", vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
     vga_puts("IDT initialized\n");
 
+    /* Arm lazy FPU/SSE context switching (needs the IDT for #NM) */
+    fpu_init();
+
     /* Enable interrupts */
     __asm__ volatile("sti");
     vga_write("[ OK ] ", vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
@@ -297,16 +417,35 @@ void kernel_main(uint32_t magic, multiboot_info_t* mboot) {
 
     /* Initialize timer (100 Hz) */
     timer_init(100);
+    bootprof_stamp("timer");
     vga_write("[ OK ] ", vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
     vga_puts("Timer initialized (100 Hz)\n");
 
+    /* Arm the interrupts-off watchdog now that there is a time source */
+    irqwatch_init();
+
+    /* Calibrate the TSC for high-resolution timekeeping (50ms) */
+    timer_calibrate_tsc();
+    bootprof_stamp("tsc");
+    vga_write("[ OK ] ", vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
+    printk("TSC calibrated: %u MHz\n", timer_tsc_khz() / 1000);
+
     /* Initialize keyboard */
     keyboard_init();
+    bootprof_stamp("keyboard");
     vga_write("[ OK ] ", vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
     vga_puts("Keyboard initialized\n");
 
+    /* Initialize tty line discipline (canonical mode) */
+    tty_init();
+
+    /* Switch serial logging to interrupt-driven transmit */
+    serial_enable_irq();
+    bootprof_stamp("serial_irq");
+
     /* Initialize real-time clock */
     rtc_init();
+    bootprof_stamp("rtc");
     vga_write("[ OK ] ", vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
     vga_puts("RTC initialized\n");
 
@@ -314,11 +453,30 @@ void kernel_main(uint32_t magic, multiboot_info_t* mboot) {
     vga_write("[ OK ] ", vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
     vga_puts("Initializing physical memory manager...\n");
     pmm_init(mboot, (uint32_t)&_kernel_end);
+    bootprof_stamp("pmm");
+
+    /* Keep GRUB-loaded modules intact until they are installed into
+     * /bin later in boot (the allocator would hand their frames out) */
+    if ((mboot->flags & MULTIBOOT_INFO_MODS) && mboot->mods_count > 0) {
+        multiboot_module_t* mods = (multiboot_module_t*)mboot->mods_addr;
+        pmm_mark_region_used(mboot->mods_addr,
+                             mboot->mods_count * sizeof(multiboot_module_t));
+        for (uint32_t i = 0; i < mboot->mods_count; i++) {
+            if (mods[i].mod_end > mods[i].mod_start) {
+                pmm_mark_region_used(mods[i].mod_start,
+                                     mods[i].mod_end - mods[i].mod_start);
+            }
+        }
+    }
 
     /* Initialize paging (virtual memory) */
     vga_write("[ OK ] ", vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
     vga_puts("Initializing paging...\n");
     paging_init();
+    bootprof_stamp("paging");
+
+    /* Detect the CPU topology (tables live in identity-mapped low memory) */
+    smp_init();
 
     /* Initialize page fault handler (enables graceful fault handling) */
     vga_write("[ OK ] ", vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
@@ -329,31 +487,41 @@ void kernel_main(uint32_t magic, multiboot_info_t* mboot) {
     vga_write("[ OK ] ", vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
     vga_puts("Initializing kernel heap...\n");
     heap_init(0x400000, HEAP_INITIAL_SIZE);
+    bootprof_stamp("heap");
+
+    /* Initialize slab caches for hot kernel objects */
+    vga_write("[ OK ] ", vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
+    vga_puts("Initializing slab caches...\n");
+    slab_init();
+    bootprof_stamp("slab");
 
     /* Initialize scheduler (creates idle process) */
     vga_write("[ OK ] ", vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
     vga_puts("Initializing scheduler...\n");
     scheduler_init();
+    bootprof_stamp("sched");
 
     /* Initialize system calls */
     vga_write("[ OK ] ", vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
     vga_puts("Initializing system calls...\n");
     syscall_init();
+    bootprof_stamp("syscall");
 
     /* Initialize block device layer */
     vga_write("[ OK ] ", vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
     vga_puts("Initializing block device layer...\n");
     blockdev_init();
+    bootprof_stamp("blockdev");
 
-    /* Initialize ATA disk driver */
-    vga_write("[ OK ] ", vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
-    vga_puts("Initializing ATA driver...\n");
-    ata_init();
+    /* The ATA probe (with its identify timeouts) and everything that
+     * depends on the disk run in a background thread later in boot;
+     * see boot_bg_main() */
 
     /* Initialize VFS */
     vga_write("[ OK ] ", vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
     vga_puts("Initializing VFS...\n");
     vfs_init();
+    bootprof_stamp("vfs");
 
     /* Initialize and mount ramfs as root */
     vfs_node_t* ramfs_root = ramfs_init();
@@ -374,6 +542,14 @@ void kernel_main(uint32_t magic, multiboot_info_t* mboot) {
         ramfs_create_dir("etc");
         ramfs_create_dir("root");
         ramfs_create_dir("mnt");
+        ramfs_create_dir("tmp");
+        ramfs_create_dir("proc");
+
+        /* Mount procfs (generated-on-read stats) */
+        vfs_node_t* procfs_root = procfs_init();
+        if (procfs_root) {
+            vfs_mount("/proc", procfs_root);
+        }
 
         /* Create /etc/fstab for auto-mounting */
         vfs_node_t* etc_dir = vfs_lookup("/etc");
@@ -413,12 +589,12 @@ void kernel_main(uint32_t magic, multiboot_info_t* mboot) {
             init_file->mode = 0755;
             vfs_write(init_file, 0, init_size, _binary_init_start);
         }
+
+        /* Boot modules override/extend the embedded set */
+        install_boot_modules(mboot, bin_dir);
     }
 
-    /* Parse /etc/fstab and auto-mount filesystems */
-    vga_write("[ OK ] ", vga_entry_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK));
-    vga_puts("Parsing /etc/fstab...\n");
-    parse_fstab();
+    bootprof_stamp("ramfs");
 
     /* Print bootloader info */
     if (mboot->flags & 0x200) {  /* Boot loader name flag */
@@ -446,18 +622,30 @@ void kernel_main(uint32_t magic, multiboot_info_t* mboot) {
 
     /* Initialize program loader */
     loader_init();
+    bootprof_stamp("loader");
 
     /* Initialize user subsystem (creates root and guest users) */
     user_init();
+    bootprof_stamp("user");
+
+    /* Start the kernel worker pool (deferred work for drivers) */
+    workqueue_init();
 
     /* Initialize daemon subsystem */
     daemon_init();
 
-    /* Start all system daemons */
-    daemon_start_all();
+    /* Everything left that waits on hardware — the ATA probe, fstab
+     * mounts, conf tunables, daemon startup — runs in a background
+     * kernel process so the prompt is not held up by device timeouts */
+    if (process_create(boot_bg_main, "bootinit") < 0) {
+        /* No process slot (should not happen this early): do it here */
+        boot_bg_main_sync();
+    }
+    bootprof_stamp("bg_spawn");
 
     /* Initialize kernel shell (still used for debug commands) */
     shell_init();
+    bootprof_stamp("shell");
 
     /* ============================================================
      * STAGE 3: BOOT MODE SELECTION
@@ -474,6 +662,8 @@ void kernel_main(uint32_t magic, multiboot_info_t* mboot) {
     serial_write_string("MiniOS: calling vesa_init()\n");
     vesa_init(mboot);
     serial_write_string("MiniOS: returned from vesa_init()\n");
+    bootprof_stamp("vesa");
+    bootprof_publish();
     
     /* Debug: Try to draw something directly to framebuffer if VESA detected */
     if (vesa_available()) {
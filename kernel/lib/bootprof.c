@@ -0,0 +1,136 @@
+/*
+ * MiniOS Boot Profiler
+ *
+ * Each bootprof_stamp() records the TSC and the PIT tick count at the
+ * end of a boot stage. Stage cost is the delta to the previous stamp.
+ * Milliseconds are derived by calibrating TSC cycles against the
+ * 100 Hz timer once it is running; stages before the first tick only
+ * report cycles.
+ */
+
+#include "bootprof.h"
+#include "timer.h"
+#include "vfs.h"
+#include "ramfs.h"
+#include "stdio.h"
+#include "string.h"
+
+/* Milliseconds per PIT tick (timer runs at 100 Hz) */
+#define BOOTPROF_TICK_MS 10
+
+typedef struct {
+    const char* name;
+    uint64_t tsc;
+    uint32_t ticks;
+} bootprof_entry_t;
+
+static bootprof_entry_t stages[BOOTPROF_MAX_STAGES];
+static int stage_count = 0;
+
+static uint64_t rdtsc(void) {
+    uint32_t lo, hi;
+    __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+/*
+ * Record the completion of a boot stage
+ */
+void bootprof_stamp(const char* name) {
+    if (stage_count >= BOOTPROF_MAX_STAGES) {
+        return;
+    }
+    stages[stage_count].name = name;
+    stages[stage_count].tsc = rdtsc();
+    stages[stage_count].ticks = timer_get_ticks();
+    stage_count++;
+}
+
+/*
+ * Kilocycles elapsed between two stamps (avoids 64-bit division)
+ */
+static uint32_t delta_kcycles(uint64_t from, uint64_t to) {
+    return (uint32_t)((to - from) >> 10);
+}
+
+/*
+ * Format the boot profile table into buf
+ */
+int bootprof_format(char* buf, int size) {
+    int pos = 0;
+
+    if (stage_count < 2) {
+        pos += snprintf(buf + pos, size - pos, "boot profile: no data\n");
+        return pos;
+    }
+
+    /* Calibrate kilocycles-per-tick from the tick counter span. The
+     * timer starts mid-boot, so use the first stamp with a nonzero
+     * tick count as the calibration origin. */
+    uint32_t kcyc_per_tick = 0;
+    int cal = -1;
+    for (int i = 0; i < stage_count; i++) {
+        if (stages[i].ticks > 0) { cal = i; break; }
+    }
+    if (cal >= 0 && stages[stage_count - 1].ticks > stages[cal].ticks) {
+        uint32_t dt = stages[stage_count - 1].ticks - stages[cal].ticks;
+        kcyc_per_tick = delta_kcycles(stages[cal].tsc,
+                                      stages[stage_count - 1].tsc) / dt;
+    }
+
+    uint32_t total_k = delta_kcycles(stages[0].tsc, stages[stage_count - 1].tsc);
+    if (total_k == 0) total_k = 1;
+
+    pos += snprintf(buf + pos, size - pos,
+                    "%16s %12s %8s %5s\n", "stage", "kcycles", "ms", "%");
+
+    /* All arithmetic stays 32-bit: the kernel links without libgcc,
+     * so 64-bit division is unavailable */
+    uint32_t kcyc_per_dms = kcyc_per_tick / (BOOTPROF_TICK_MS * 10);
+    uint32_t total_permille = total_k / 1000;
+    if (total_permille == 0) total_permille = 1;
+
+    for (int i = 1; i < stage_count && pos < size - 1; i++) {
+        uint32_t dk = delta_kcycles(stages[i - 1].tsc, stages[i].tsc);
+        uint32_t pct = dk / total_permille;
+
+        pos += snprintf(buf + pos, size - pos, "%16s %12u ",
+                        stages[i].name, dk);
+        if (kcyc_per_dms > 0) {
+            uint32_t ms10 = dk / kcyc_per_dms;
+            pos += snprintf(buf + pos, size - pos, "%6u.%u ",
+                            ms10 / 10, ms10 % 10);
+        } else {
+            pos += snprintf(buf + pos, size - pos, "%8s ", "-");
+        }
+        pos += snprintf(buf + pos, size - pos, "%3u.%u\n",
+                        pct / 10, pct % 10);
+    }
+
+    pos += snprintf(buf + pos, size - pos, "%16s %12u\n", "total", total_k);
+    return pos;
+}
+
+/*
+ * Publish the boot profile as /proc/bootchart
+ */
+void bootprof_publish(void) {
+    static char buf[2048];
+    int len = bootprof_format(buf, sizeof(buf));
+
+    vfs_node_t* proc_dir = vfs_lookup("/proc");
+    if (!proc_dir) {
+        proc_dir = ramfs_create_dir("proc");
+    }
+    if (!proc_dir) {
+        return;
+    }
+
+    vfs_node_t* file = vfs_finddir(proc_dir, "bootchart");
+    if (!file) {
+        file = ramfs_create_file_in(proc_dir, "bootchart", VFS_FILE);
+    }
+    if (file) {
+        vfs_write(file, 0, len, (uint8_t*)buf);
+    }
+}
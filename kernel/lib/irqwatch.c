@@ -0,0 +1,146 @@
+/*
+ * MiniOS Interrupts-Off Watchdog
+ *
+ * Measures how long interrupts stay masked. irq_save (io.h) calls
+ * irqwatch_enter with the call site's EIP when it actually turns
+ * interrupts off (nested saves see IF already clear and stay silent);
+ * the matching irq_restore calls irqwatch_leave, which charges the
+ * elapsed microseconds to that site. Long windows are what turn into
+ * dropped keystrokes and mouse stutter, so the table keeps the worst
+ * offenders for the `irqwatch` shell command.
+ */
+
+#include "irqwatch.h"
+#include "timer.h"
+#include "stdio.h"
+#include "string.h"
+
+/* One tracked call site */
+typedef struct {
+    uint32_t caller;        /* EIP of the irq_save call site */
+    uint32_t count;         /* Windows opened from this site */
+    uint64_t total_us;      /* Accumulated masked time */
+    uint32_t max_us;        /* Worst single window */
+} irqwatch_entry_t;
+
+static irqwatch_entry_t table[IRQWATCH_SLOTS];
+static bool armed = false;
+
+/* Currently-open window. Interrupts are off for its whole lifetime,
+ * so a single pair of statics needs no further protection. */
+static uint64_t off_since_us = 0;
+static uint32_t off_caller = 0;
+
+/*
+ * Arm the watchdog (call after timer_init)
+ */
+void irqwatch_init(void) {
+    armed = true;
+}
+
+/*
+ * A call site just masked interrupts
+ */
+void irqwatch_enter(uint32_t caller_eip) {
+    if (!armed) {
+        return;
+    }
+    off_caller = caller_eip;
+    off_since_us = timer_us();
+}
+
+/*
+ * Interrupts are about to come back on: close the window and charge
+ * it to the opening call site
+ */
+void irqwatch_leave(void) {
+    if (!armed || off_caller == 0) {
+        return;
+    }
+    uint32_t delta = (uint32_t)(timer_us() - off_since_us);
+    uint32_t caller = off_caller;
+    off_caller = 0;
+
+    /* This site's slot, else a free one, else evict the entry with
+     * the mildest worst-case if the new window beats it */
+    int slot = -1;
+    int free_slot = -1;
+    int mildest = 0;
+    for (int i = 0; i < IRQWATCH_SLOTS; i++) {
+        if (table[i].caller == caller) {
+            slot = i;
+            break;
+        }
+        if (table[i].caller == 0 && free_slot < 0) {
+            free_slot = i;
+        }
+        if (table[i].max_us < table[mildest].max_us) {
+            mildest = i;
+        }
+    }
+    if (slot < 0) {
+        slot = free_slot;
+    }
+    if (slot < 0) {
+        if (delta <= table[mildest].max_us) {
+            return;
+        }
+        slot = mildest;
+        memset(&table[slot], 0, sizeof(table[slot]));
+    }
+
+    table[slot].caller = caller;
+    table[slot].count++;
+    table[slot].total_us += delta;
+    if (delta > table[slot].max_us) {
+        table[slot].max_us = delta;
+    }
+}
+
+/*
+ * Clear the offender table
+ */
+void irqwatch_reset(void) {
+    memset(table, 0, sizeof(table));
+}
+
+/*
+ * Print the offender table, worst single window first
+ */
+void irqwatch_report(void) {
+    printk("%10s  %8s  %8s  %10s\n",
+           "caller", "count", "max_us", "total_us");
+
+    /* Report by repeatedly extracting the maximum (same scheme as
+     * profile_report; the table is small) */
+    bool reported[IRQWATCH_SLOTS];
+    memset(reported, 0, sizeof(reported));
+
+    int printed = 0;
+    for (int n = 0; n < IRQWATCH_SLOTS; n++) {
+        int best = -1;
+        for (int i = 0; i < IRQWATCH_SLOTS; i++) {
+            if (table[i].caller == 0 || reported[i]) {
+                continue;
+            }
+            if (best < 0 || table[i].max_us > table[best].max_us) {
+                best = i;
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+        reported[best] = true;
+        printed++;
+
+        printk("0x%08x  %8u  %8u  %10u\n",
+               table[best].caller, table[best].count,
+               table[best].max_us, (uint32_t)table[best].total_us);
+    }
+
+    if (printed == 0) {
+        printk("irqwatch: no masked windows recorded yet\n");
+        return;
+    }
+    printk("resolve addresses against the linker map (kernel.bin.map)\n");
+}
@@ -0,0 +1,199 @@
+/*
+ * MiniOS Kernel Log Ring Buffer Implementation
+ *
+ * Binary record ring with lazy formatting. klog() captures the format
+ * pointer and raw argument words; all printf work is deferred to
+ * klog_render(), which only runs when somebody types dmesg.
+ */
+
+#include "../include/klog.h"
+#include "../include/stdio.h"
+#include "../include/string.h"
+#include "../include/timer.h"
+
+static klog_record_t klog_ring[KLOG_RECORDS];
+static uint32_t klog_head = 0;      /* Next slot to overwrite */
+static uint32_t klog_seq = 0;
+static uint8_t klog_threshold = KLOG_INFO;
+
+static const char* klog_level_names[] = { "ERR ", "WARN", "INFO", "DBG " };
+static const char* klog_subsys_names[KLOG_NUM_SUBS] = {
+    "kern", "mm", "proc", "fs", "blk", "drv", "gui", "daemon"
+};
+
+const char* klog_level_name(uint8_t level) {
+    return (level <= KLOG_DEBUG) ? klog_level_names[level] : "??? ";
+}
+
+const char* klog_subsys_name(uint8_t subsys) {
+    return (subsys < KLOG_NUM_SUBS) ? klog_subsys_names[subsys] : "?";
+}
+
+void klog_set_level(uint8_t level) {
+    if (level > KLOG_DEBUG) level = KLOG_DEBUG;
+    klog_threshold = level;
+}
+
+uint8_t klog_get_level(void) {
+    return klog_threshold;
+}
+
+/*
+ * Append a record. The format string is scanned only to know how many
+ * argument words to capture; %s arguments are copied into the
+ * record's inline pool since the pointed-at text may be a stack
+ * buffer that will not survive until render time.
+ */
+void klog(uint8_t level, uint8_t subsys, const char* fmt, ...) {
+    if (level > klog_threshold) {
+        return;             /* Filtered: one compare, nothing else */
+    }
+
+    uint32_t eflags;
+    __asm__ volatile("pushf; pop %0; cli" : "=r"(eflags));
+
+    klog_record_t* r = &klog_ring[klog_head];
+    klog_head = (klog_head + 1) % KLOG_RECORDS;
+
+    r->us = timer_us();
+    r->fmt = fmt;
+    r->seq = klog_seq++;
+    r->level = level;
+    r->subsys = subsys;
+    r->nargs = 0;
+    r->used = 1;
+
+    va_list args;
+    va_start(args, fmt);
+    uint32_t str_pos = 0;
+
+    for (const char* f = fmt; *f && r->nargs < KLOG_MAX_ARGS; f++) {
+        if (*f != '%') continue;
+        f++;
+        /* Skip flags and width */
+        while (*f == '-' || (*f >= '0' && *f <= '9')) f++;
+        switch (*f) {
+            case 'd': case 'i': case 'u': case 'x': case 'X':
+            case 'p': case 'c':
+                r->args[r->nargs++] = va_arg(args, uint32_t);
+                break;
+            case 's': {
+                const char* s = va_arg(args, const char*);
+                if (s == NULL) s = "(null)";
+                /* Store the offset into the inline pool */
+                r->args[r->nargs++] = str_pos;
+                while (*s && str_pos < KLOG_STR_BYTES - 1) {
+                    r->strbuf[str_pos++] = *s++;
+                }
+                r->strbuf[str_pos] = '\0';
+                if (str_pos < KLOG_STR_BYTES - 1) str_pos++;
+                break;
+            }
+            case '%':
+            case '\0':
+                break;
+            default:
+                break;
+        }
+        if (*f == '\0') break;
+    }
+
+    va_end(args);
+
+    if (eflags & 0x200) {
+        __asm__ volatile("sti");
+    }
+}
+
+/*
+ * 64-by-32 divide via shift-subtract (the kernel links without
+ * libgcc). Render-only path, so the bit loop is fine.
+ */
+static uint32_t klog_udiv64_32(uint64_t dividend, uint32_t divisor, uint32_t* rem_out) {
+    uint64_t rem = 0;
+    uint32_t quot = 0;
+    for (int bit = 63; bit >= 0; bit--) {
+        rem = (rem << 1) | ((dividend >> bit) & 1);
+        if (rem >= divisor) {
+            rem -= divisor;
+            if (bit < 32) {
+                quot |= 1u << bit;
+            }
+        }
+    }
+    if (rem_out) *rem_out = (uint32_t)rem;
+    return quot;
+}
+
+/*
+ * Format one record's message from its captured arguments. Mirrors
+ * the specifier set of vsprintf: each specifier is re-rendered with
+ * snprintf, pulling from the stored words instead of a va_list.
+ */
+static void klog_format(const klog_record_t* r, char* out, int size) {
+    int pos = 0;
+    int ai = 0;
+    const char* f = r->fmt;
+
+    while (*f && pos < size - 1) {
+        if (*f != '%') {
+            out[pos++] = *f++;
+            continue;
+        }
+
+        /* Copy the whole specifier (flags, width, conversion) */
+        char spec[8];
+        int si = 0;
+        spec[si++] = *f++;  /* '%' */
+        while ((*f == '-' || (*f >= '0' && *f <= '9')) && si < 6) {
+            spec[si++] = *f++;
+        }
+        char conv = *f;
+        if (conv == '\0') break;
+        f++;
+
+        if (conv == '%') {
+            out[pos++] = '%';
+            continue;
+        }
+        spec[si++] = conv;
+        spec[si] = '\0';
+
+        uint32_t arg = (ai < r->nargs) ? r->args[ai] : 0;
+        ai++;
+
+        char tmp[48];
+        if (conv == 's') {
+            uint32_t off = (arg < KLOG_STR_BYTES) ? arg : 0;
+            snprintf(tmp, sizeof(tmp), spec, r->strbuf + off);
+        } else {
+            snprintf(tmp, sizeof(tmp), spec, arg);
+        }
+        for (const char* t = tmp; *t && pos < size - 1; t++) {
+            out[pos++] = *t;
+        }
+    }
+    out[pos] = '\0';
+}
+
+/*
+ * Render the ring oldest-first, one formatted line per record
+ */
+void klog_render(void (*emit)(const char* line)) {
+    char msg[96];
+    char line[128];
+
+    for (uint32_t i = 0; i < KLOG_RECORDS; i++) {
+        const klog_record_t* r = &klog_ring[(klog_head + i) % KLOG_RECORDS];
+        if (!r->used) continue;
+
+        klog_format(r, msg, sizeof(msg));
+
+        uint32_t frac;
+        uint32_t secs = klog_udiv64_32(r->us, 1000000u, &frac);
+        snprintf(line, sizeof(line), "[%5u.%06u] %s %s: %s\n",
+                 secs, frac, klog_level_name(r->level),
+                 klog_subsys_name(r->subsys), msg);
+        emit(line);
+    }
+}
@@ -0,0 +1,49 @@
+/*
+ * MiniOS Embedded Kernel Symbol Table (lookup half)
+ *
+ * The table itself is generated at build time (scripts/gen_ksyms.sh)
+ * and linked in on the second link pass; the weak definitions below
+ * keep a pass-one or symbol-less image linking, with every lookup
+ * simply missing.
+ */
+
+#include "../include/ksyms.h"
+
+/* Overridden by the generated table */
+__attribute__((weak)) const ksym_t ksym_table[1] = { { 0, "" } };
+__attribute__((weak)) const uint32_t ksym_count = 0;
+
+/* A hit past the last symbol is only trusted this far (the table has
+ * no sizes, so the last function would otherwise swallow everything
+ * above the kernel) */
+#define KSYM_LAST_WINDOW 0x10000
+
+/*
+ * Binary search for the greatest symbol at or below addr
+ */
+const char* ksym_lookup(uint32_t addr, uint32_t* offset) {
+    if (ksym_count == 0 || addr < ksym_table[0].addr) {
+        return NULL;
+    }
+
+    uint32_t lo = 0;
+    uint32_t hi = ksym_count - 1;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi + 1) / 2;
+        if (ksym_table[mid].addr <= addr) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    if (lo == ksym_count - 1 &&
+        addr - ksym_table[lo].addr >= KSYM_LAST_WINDOW) {
+        return NULL;
+    }
+
+    if (offset != NULL) {
+        *offset = addr - ksym_table[lo].addr;
+    }
+    return ksym_table[lo].name;
+}
@@ -8,6 +8,7 @@
 #include "../include/panic.h"
 #include "../include/stdio.h"
 #include "../include/vga.h"
+#include "../include/ksyms.h"
 
 /*
  * Halt the CPU permanently
@@ -62,6 +63,34 @@ void kernel_panicf(const char* format, ...) {
     halt_forever();
 }
 
+/*
+ * Print one code address with its symbol when the embedded table
+ * knows it
+ */
+static void print_code_addr(const char* label, uint32_t addr) {
+    uint32_t off = 0;
+    const char* name = ksym_lookup(addr, &off);
+    if (name != NULL) {
+        printk("  %s 0x%08x  %s+0x%x\n", label, addr, name, off);
+    } else {
+        printk("  %s 0x%08x\n", label, addr);
+    }
+}
+
+/*
+ * Walk the EBP chain and symbolize each return address
+ */
+static void print_backtrace(uint32_t ebp) {
+    uint32_t* frame = (uint32_t*)ebp;
+    for (int depth = 0;
+         depth < 8 && (uint32_t)frame > 0x100000 &&
+         (uint32_t)frame < 0xC0000000;
+         depth++) {
+        print_code_addr("from", frame[1]);
+        frame = (uint32_t*)frame[0];
+    }
+}
+
 /*
  * Kernel panic with register dump
  */
@@ -83,7 +112,11 @@ void kernel_panic_regs(const char* message, registers_t* regs) {
            regs->eip, regs->cs, regs->eflags);
     printk("  DS=%04X  INT=%02X  ERR=%08X\n",
            regs->ds, regs->int_no, regs->err_code);
-    
+
+    vga_puts("\nBacktrace:\n");
+    print_code_addr("at  ", regs->eip);
+    print_backtrace(regs->ebp);
+
     vga_puts("\n");
     vga_set_color(vga_entry_color(VGA_COLOR_LIGHT_GREY, VGA_COLOR_BLACK));
     vga_puts("System halted. Please reboot.\n");
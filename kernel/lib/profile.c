@@ -0,0 +1,117 @@
+/*
+ * MiniOS Sampling Kernel Profiler
+ *
+ * The histogram covers 1MB (the kernel load address) up to _kernel_end.
+ * Bucket width is computed at start so PROFILE_BUCKETS buckets span the
+ * whole image whatever its size; samples outside the kernel (user code,
+ * spurious EIPs) are counted separately.
+ */
+
+#include "profile.h"
+#include "stdio.h"
+#include "string.h"
+#include "ksyms.h"
+
+extern uint32_t _kernel_end;
+
+/* Kernel image base (see build/kernel.ld) */
+#define PROFILE_TEXT_BASE 0x100000
+
+static uint32_t buckets[PROFILE_BUCKETS];
+static uint32_t bucket_shift = 0;   /* log2 of bucket width in bytes */
+static uint32_t sample_total = 0;
+static uint32_t sample_foreign = 0; /* Samples outside the kernel image */
+static bool running = false;
+
+/*
+ * Start sampling (clears the histogram)
+ */
+void profile_start(void) {
+    memset(buckets, 0, sizeof(buckets));
+    sample_total = 0;
+    sample_foreign = 0;
+
+    /* Pick the smallest power-of-two bucket width that covers the image */
+    uint32_t span = (uint32_t)&_kernel_end - PROFILE_TEXT_BASE;
+    bucket_shift = 5;  /* 32 bytes minimum */
+    while (((uint32_t)PROFILE_BUCKETS << bucket_shift) < span) {
+        bucket_shift++;
+    }
+
+    running = true;
+}
+
+/*
+ * Stop sampling
+ */
+void profile_stop(void) {
+    running = false;
+}
+
+/*
+ * True while sampling is active
+ */
+bool profile_running(void) {
+    return running;
+}
+
+/*
+ * Record one sample; called from the timer interrupt
+ */
+void profile_sample(uint32_t eip) {
+    if (!running) {
+        return;
+    }
+    sample_total++;
+    if (eip < PROFILE_TEXT_BASE || eip >= (uint32_t)&_kernel_end) {
+        sample_foreign++;
+        return;
+    }
+    buckets[(eip - PROFILE_TEXT_BASE) >> bucket_shift]++;
+}
+
+/*
+ * Print the hottest buckets via printk
+ */
+void profile_report(void) {
+    if (sample_total == 0) {
+        printk("profile: no samples (use 'profile start' first)\n");
+        return;
+    }
+
+    printk("profile: %u samples, %u outside kernel, bucket %u bytes\n",
+           sample_total, sample_foreign, 1u << bucket_shift);
+    printk("%10s  %8s  %6s  %s\n", "address", "samples", "%", "symbol");
+
+    /* Report the top buckets by repeatedly extracting the maximum */
+    uint32_t reported[16];
+    int nreported = 0;
+    for (int n = 0; n < 16; n++) {
+        uint32_t best = 0;
+        int best_idx = -1;
+        for (int i = 0; i < PROFILE_BUCKETS; i++) {
+            if (buckets[i] <= best) continue;
+            bool seen = false;
+            for (int j = 0; j < nreported; j++) {
+                if (reported[j] == (uint32_t)i) { seen = true; break; }
+            }
+            if (!seen) {
+                best = buckets[i];
+                best_idx = i;
+            }
+        }
+        if (best_idx < 0) break;
+        reported[nreported++] = (uint32_t)best_idx;
+
+        uint32_t addr = PROFILE_TEXT_BASE + ((uint32_t)best_idx << bucket_shift);
+        uint32_t pct = (best * 1000) / sample_total;
+        uint32_t off = 0;
+        const char* name = ksym_lookup(addr, &off);
+        if (name != NULL) {
+            printk("0x%08x  %8u  %3u.%u  %s+0x%x\n",
+                   addr, best, pct / 10, pct % 10, name, off);
+        } else {
+            printk("0x%08x  %8u  %3u.%u\n", addr, best, pct / 10, pct % 10);
+        }
+    }
+}
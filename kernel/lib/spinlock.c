@@ -0,0 +1,41 @@
+/*
+ * MiniOS Spinlock Registry
+ *
+ * The lock primitives themselves are inline in spinlock.h; this is
+ * just the registry behind the `locks` shell command, so per-lock
+ * acquisition/contention counters can be read at runtime.
+ */
+
+#include "spinlock.h"
+#include "stdio.h"
+
+#define SPINLOCK_MAX_REGISTERED 32
+
+static spinlock_t* registered[SPINLOCK_MAX_REGISTERED];
+static int registered_count = 0;
+
+/*
+ * Add a long-lived lock to the report table
+ */
+void spinlock_register(spinlock_t* lock) {
+    if (registered_count >= SPINLOCK_MAX_REGISTERED) {
+        return;
+    }
+    registered[registered_count++] = lock;
+}
+
+/*
+ * Print every registered lock's counters
+ */
+void spinlock_report(void) {
+    printk("%-12s  %10s  %10s\n", "lock", "taken", "contended");
+    for (int i = 0; i < registered_count; i++) {
+        spinlock_t* lock = registered[i];
+        printk("%-12s  %10u  %10u\n",
+               lock->name != NULL ? lock->name : "?",
+               lock->acquisitions, lock->contentions);
+    }
+    if (registered_count == 0) {
+        printk("locks: nothing registered\n");
+    }
+}
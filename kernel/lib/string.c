@@ -9,9 +9,32 @@
 
 /*
  * Set memory to a specific value
+ * Uses rep stosl for the aligned bulk so large clears (page zeroing,
+ * framebuffer fills) run a dword per iteration instead of a byte.
  */
 void* memset(void* dest, int val, size_t count) {
     unsigned char* ptr = (unsigned char*)dest;
+
+    /* Align to a 4-byte boundary byte-at-a-time */
+    while (count > 0 && ((uint32_t)ptr & 3) != 0) {
+        *ptr++ = (unsigned char)val;
+        count--;
+    }
+
+    /* Bulk fill, a dword at a time */
+    if (count >= 4) {
+        uint32_t fill = (unsigned char)val;
+        fill |= fill << 8;
+        fill |= fill << 16;
+        uint32_t dwords = count / 4;
+        __asm__ volatile("rep stosl"
+                         : "+D"(ptr), "+c"(dwords)
+                         : "a"(fill)
+                         : "memory");
+        count &= 3;
+    }
+
+    /* Remaining tail bytes */
     while (count--) {
         *ptr++ = (unsigned char)val;
     }
@@ -20,12 +43,34 @@ void* memset(void* dest, int val, size_t count) {
 
 /*
  * Copy memory from source to destination
+ * Mutually aligned buffers (the common case: disk blocks, frames,
+ * pipe buffers) go through rep movsl; everything else falls back to
+ * rep movsb, which is still far faster than a C byte loop.
  */
 void* memcpy(void* dest, const void* src, size_t count) {
     unsigned char* d = (unsigned char*)dest;
     const unsigned char* s = (const unsigned char*)src;
-    while (count--) {
-        *d++ = *s++;
+
+    /* Only mutually aligned buffers can reach a dword boundary together */
+    if (count >= 4 && ((((uint32_t)d ^ (uint32_t)s) & 3) == 0)) {
+        while (((uint32_t)d & 3) != 0) {
+            *d++ = *s++;
+            count--;
+        }
+        uint32_t dwords = count / 4;
+        __asm__ volatile("rep movsl"
+                         : "+D"(d), "+S"(s), "+c"(dwords)
+                         :
+                         : "memory");
+        count &= 3;
+    }
+
+    /* Tail bytes, or the whole copy when relative alignment differs */
+    if (count > 0) {
+        __asm__ volatile("rep movsb"
+                         : "+D"(d), "+S"(s), "+c"(count)
+                         :
+                         : "memory");
     }
     return dest;
 }
@@ -37,18 +82,30 @@ void* memmove(void* dest, const void* src, size_t count) {
     unsigned char* d = (unsigned char*)dest;
     const unsigned char* s = (const unsigned char*)src;
 
-    if (d < s) {
-        /* Copy forward */
-        while (count--) {
-            *d++ = *s++;
-        }
-    } else if (d > s) {
-        /* Copy backward to handle overlap */
-        d += count;
-        s += count;
-        while (count--) {
-            *--d = *--s;
-        }
+    if (d == s || count == 0) {
+        return dest;
+    }
+
+    if (d < s || d >= s + count) {
+        /* No destructive overlap: use the forward fast path */
+        return memcpy(dest, src, count);
+    }
+
+    /* Overlap with dest above src: copy backward. Interrupts stay off
+     * while the direction flag is set, since handlers (and memcpy)
+     * assume DF is clear. */
+    d += count - 1;
+    s += count - 1;
+    uint32_t eflags;
+    __asm__ volatile("pushf\n\tpop %0\n\tcli" : "=r"(eflags));
+    __asm__ volatile("std\n\t"
+                     "rep movsb\n\t"
+                     "cld"
+                     : "+D"(d), "+S"(s), "+c"(count)
+                     :
+                     : "memory");
+    if (eflags & 0x200) {
+        __asm__ volatile("sti");
     }
     return dest;
 }
@@ -69,21 +126,86 @@ int memcmp(const void* ptr1, const void* ptr2, size_t count) {
     return 0;
 }
 
+/*
+ * Find the first occurrence of a byte in a memory region
+ */
+void* memchr(const void* ptr, int value, size_t count) {
+    const unsigned char* p = (const unsigned char*)ptr;
+    unsigned char v = (unsigned char)value;
+    while (count--) {
+        if (*p == v) {
+            return (void*)p;
+        }
+        p++;
+    }
+    return NULL;
+}
+
+/* Word-at-a-time scanning: HAS_ZERO(w) is non-zero iff some byte of
+ * the dword w is zero (the classic (w - 0x01010101) & ~w & 0x80808080
+ * trick). Reading the terminator's whole dword never faults because an
+ * aligned dword cannot cross a page boundary. */
+#define ONES_MASK  0x01010101u
+#define HIGHS_MASK 0x80808080u
+#define HAS_ZERO(w) (((w) - ONES_MASK) & ~(w) & HIGHS_MASK)
+
 /*
  * Get the length of a null-terminated string
+ * Scans a dword at a time once the pointer is aligned; runs under
+ * every path lookup and dirent comparison, so the byte loop showed
+ * up in profiles.
  */
 size_t strlen(const char* str) {
-    size_t len = 0;
-    while (str[len]) {
-        len++;
+    const char* s = str;
+
+    /* Byte steps up to an aligned boundary */
+    while (((uint32_t)s & 3) != 0) {
+        if (*s == '\0') {
+            return (size_t)(s - str);
+        }
+        s++;
+    }
+
+    /* Dword scan until a word contains a zero byte */
+    const uint32_t* w = (const uint32_t*)s;
+    while (!HAS_ZERO(*w)) {
+        w++;
+    }
+
+    /* Locate the zero byte within the word */
+    s = (const char*)w;
+    while (*s) {
+        s++;
     }
-    return len;
+    return (size_t)(s - str);
 }
 
 /*
  * Compare two strings
+ * Mutually aligned strings (common: both are lookup keys or dirent
+ * names starting at struct offsets) compare a dword at a time until
+ * the words differ or contain a terminator.
  */
 int strcmp(const char* str1, const char* str2) {
+    /* Dword compare only works when both reach alignment together */
+    if ((((uint32_t)str1 ^ (uint32_t)str2) & 3) == 0) {
+        while (((uint32_t)str1 & 3) != 0) {
+            if (*str1 == '\0' || *str1 != *str2) {
+                return *(unsigned char*)str1 - *(unsigned char*)str2;
+            }
+            str1++;
+            str2++;
+        }
+        const uint32_t* w1 = (const uint32_t*)str1;
+        const uint32_t* w2 = (const uint32_t*)str2;
+        while (*w1 == *w2 && !HAS_ZERO(*w1)) {
+            w1++;
+            w2++;
+        }
+        str1 = (const char*)w1;
+        str2 = (const char*)w2;
+    }
+
     while (*str1 && (*str1 == *str2)) {
         str1++;
         str2++;
@@ -148,14 +270,38 @@ char* strcat(char* dest, const char* src) {
  * Find first occurrence of character in string
  */
 char* strchr(const char* str, int c) {
+    unsigned char ch = (unsigned char)c;
+
+    /* Byte steps up to an aligned boundary */
+    while (((uint32_t)str & 3) != 0) {
+        if (*str == (char)ch) {
+            return (char*)str;
+        }
+        if (*str == '\0') {
+            return NULL;
+        }
+        str++;
+    }
+
+    /* Dword scan: stop at the first word holding ch or the terminator.
+     * XOR against a word of ch turns matching bytes into zero bytes,
+     * so the same zero-byte test finds both. */
+    uint32_t pattern = ch * ONES_MASK;
+    const uint32_t* w = (const uint32_t*)str;
+    while (!HAS_ZERO(*w) && !HAS_ZERO(*w ^ pattern)) {
+        w++;
+    }
+
+    /* Locate the byte within the word */
+    str = (const char*)w;
     while (*str) {
-        if (*str == (char)c) {
+        if (*str == (char)ch) {
             return (char*)str;
         }
         str++;
     }
     /* Check for null terminator */
-    if (c == '\0') {
+    if (ch == '\0') {
         return (char*)str;
     }
     return NULL;
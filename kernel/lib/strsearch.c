@@ -0,0 +1,75 @@
+/*
+ * MiniOS Substring Search
+ *
+ * Boyer-Moore-Horspool: compare the pattern's last character first
+ * and, on a mismatch, shift by how far that haystack character sits
+ * from the end of the pattern (pattern length if it does not occur at
+ * all). grep over a large buffer touches a fraction of the bytes the
+ * naive scan does; the table costs one 256-byte pass per pattern.
+ */
+
+#include "../include/strsearch.h"
+#include "../include/string.h"
+
+/* ASCII-fold a byte when matching case-insensitively */
+static inline uint8_t ss_fold(uint8_t c, bool nocase) {
+    if (nocase && c >= 'A' && c <= 'Z') {
+        c += 32;
+    }
+    return c;
+}
+
+void strsearch_init(strsearch_t* s, const char* pattern, bool nocase) {
+    s->pattern = pattern;
+    s->len = strlen(pattern);
+    s->nocase = nocase;
+
+    uint32_t shift = s->len < 255 ? s->len : 255;
+    for (int i = 0; i < 256; i++) {
+        s->skip[i] = (uint8_t)shift;
+    }
+
+    /* Every pattern byte except the last shifts by its distance from
+     * the end; the table is indexed by folded bytes so one entry
+     * covers both cases of a letter */
+    for (uint32_t i = 0; i + 1 < s->len; i++) {
+        uint32_t d = s->len - 1 - i;
+        if (d > 255) d = 255;
+        s->skip[ss_fold((uint8_t)pattern[i], nocase)] = (uint8_t)d;
+    }
+}
+
+const char* strsearch_find(const strsearch_t* s, const char* haystack,
+                           uint32_t hay_len) {
+    uint32_t m = s->len;
+
+    if (m == 0) return haystack;
+    if (m > hay_len) return NULL;
+
+    /* One-byte pattern: a plain memchr sweep beats any table */
+    if (m == 1 && !s->nocase) {
+        return (const char*)memchr(haystack, s->pattern[0], hay_len);
+    }
+
+    const uint8_t* h = (const uint8_t*)haystack;
+    const uint8_t* p = (const uint8_t*)s->pattern;
+    uint8_t last = ss_fold(p[m - 1], s->nocase);
+
+    uint32_t i = 0;
+    while (i + m <= hay_len) {
+        uint8_t c = ss_fold(h[i + m - 1], s->nocase);
+        if (c == last) {
+            uint32_t j = 0;
+            while (j + 1 < m &&
+                   ss_fold(h[i + j], s->nocase) == ss_fold(p[j], s->nocase)) {
+                j++;
+            }
+            if (j + 1 == m) {
+                return haystack + i;
+            }
+        }
+        i += s->skip[c];
+    }
+
+    return NULL;
+}
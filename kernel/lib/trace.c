@@ -0,0 +1,102 @@
+/*
+ * MiniOS Static Tracepoint Framework Implementation
+ *
+ * One fixed ring of 16-byte records plus per-event hit counters.
+ * Everything is static storage: tracing must work from interrupt
+ * context and before the heap exists.
+ */
+
+#include "../include/trace.h"
+#include "../include/timer.h"
+#include "../include/process.h"
+
+uint32_t trace_enabled_mask = 0;
+
+static trace_record_t trace_ring[TRACE_RING_RECORDS];
+static uint32_t trace_head = 0;     /* Next slot to overwrite */
+static uint32_t trace_count = 0;    /* Valid records (saturates at ring size) */
+static uint32_t trace_counters[TRACE_NUM_EVENTS];
+
+static const char* trace_event_names[TRACE_NUM_EVENTS] = {
+    "sched_switch",
+    "syscall",
+    "blk_read",
+    "blk_write",
+    "pipe_read",
+    "pipe_write",
+    "gui_flush",
+};
+
+const char* trace_event_name(uint16_t event) {
+    return (event < TRACE_NUM_EVENTS) ? trace_event_names[event] : "?";
+}
+
+uint32_t trace_event_count(uint16_t event) {
+    return (event < TRACE_NUM_EVENTS) ? trace_counters[event] : 0;
+}
+
+/*
+ * Write one record. Runs with interrupts disabled so tracepoints in
+ * IRQ handlers and in process context interleave cleanly.
+ */
+void trace_emit(uint16_t event, uint32_t arg1, uint32_t arg2) {
+    uint32_t eflags;
+    __asm__ volatile("pushf; pop %0; cli" : "=r"(eflags));
+
+    trace_record_t* r = &trace_ring[trace_head];
+    trace_head = (trace_head + 1) % TRACE_RING_RECORDS;
+    if (trace_count < TRACE_RING_RECORDS) trace_count++;
+
+    r->us = (uint32_t)timer_us();
+    r->event = event;
+    r->pid = (current_process != NULL) ? (uint16_t)current_process->pid : 0;
+    r->arg1 = arg1;
+    r->arg2 = arg2;
+
+    if (event < TRACE_NUM_EVENTS) {
+        trace_counters[event]++;
+    }
+
+    if (eflags & 0x200) {
+        __asm__ volatile("sti");
+    }
+}
+
+void trace_enable(uint32_t mask) {
+    trace_enabled_mask |= mask & TRACE_CAT_ALL;
+}
+
+void trace_disable(uint32_t mask) {
+    trace_enabled_mask &= ~mask;
+}
+
+void trace_clear(void) {
+    uint32_t eflags;
+    __asm__ volatile("pushf; pop %0; cli" : "=r"(eflags));
+
+    trace_head = 0;
+    trace_count = 0;
+    for (int i = 0; i < TRACE_NUM_EVENTS; i++) {
+        trace_counters[i] = 0;
+    }
+
+    if (eflags & 0x200) {
+        __asm__ volatile("sti");
+    }
+}
+
+/*
+ * Walk the ring oldest-first
+ */
+void trace_dump(void (*cb)(const trace_record_t* rec), uint32_t max_records) {
+    uint32_t n = trace_count;
+    if (max_records != 0 && max_records < n) {
+        n = max_records;
+    }
+
+    /* Start so that exactly the newest n records are visited */
+    uint32_t start = (trace_head + TRACE_RING_RECORDS - n) % TRACE_RING_RECORDS;
+    for (uint32_t i = 0; i < n; i++) {
+        cb(&trace_ring[(start + i) % TRACE_RING_RECORDS]);
+    }
+}
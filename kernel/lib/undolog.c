@@ -0,0 +1,193 @@
+/*
+ * MiniOS Editor Undo Journal
+ *
+ * See include/undolog.h for the model. The journal is a fixed ring of
+ * operation records; only deleted text costs heap, and that is capped
+ * by UNDOLOG_TEXT_BUDGET with oldest-first eviction.
+ */
+
+#include "undolog.h"
+#include "heap.h"
+#include "string.h"
+
+/*
+ * Release a record's text buffer
+ */
+static void op_free_text(undolog_t* log, undolog_op_t* op) {
+    if (op->text) {
+        log->text_bytes -= op->cap;
+        kfree(op->text);
+        op->text = NULL;
+    }
+    op->cap = 0;
+}
+
+/*
+ * Evict the oldest record
+ */
+static void evict_oldest(undolog_t* log) {
+    op_free_text(log, &log->ops[log->head]);
+    log->head = (log->head + 1) % UNDOLOG_MAX_OPS;
+    log->count--;
+}
+
+/*
+ * Newest record, or NULL when empty
+ */
+static undolog_op_t* newest(undolog_t* log) {
+    if (log->count == 0) return NULL;
+    return &log->ops[(log->head + log->count - 1) % UNDOLOG_MAX_OPS];
+}
+
+/*
+ * Append a fresh record, evicting the oldest when the ring is full
+ */
+static undolog_op_t* push(undolog_t* log, undolog_type_t type, int line, int col) {
+    if (log->count == UNDOLOG_MAX_OPS) {
+        evict_oldest(log);
+    }
+    undolog_op_t* op = &log->ops[(log->head + log->count) % UNDOLOG_MAX_OPS];
+    op_free_text(log, op);
+    op->type = (uint8_t)type;
+    op->line = line;
+    op->col = col;
+    op->len = 0;
+    log->count++;
+    return op;
+}
+
+/*
+ * Grow op's text buffer to hold need bytes, evicting old records to
+ * stay inside the byte budget. Returns 0 when it cannot be satisfied.
+ */
+static int text_reserve(undolog_t* log, undolog_op_t* op, int need) {
+    if (need <= op->cap) return 1;
+    int cap = (need + 31) & ~31;
+
+    /* Make room under the budget; never evict the record being grown */
+    while (log->count > 1 && log->text_bytes - op->cap + cap > UNDOLOG_TEXT_BUDGET) {
+        evict_oldest(log);
+    }
+    if (log->text_bytes - op->cap + cap > UNDOLOG_TEXT_BUDGET) {
+        return 0;
+    }
+
+    char* buf = (char*)kmalloc(cap);
+    if (!buf) return 0;
+    if (op->text) {
+        memcpy(buf, op->text, op->len);
+        log->text_bytes -= op->cap;
+        kfree(op->text);
+    }
+    op->text = buf;
+    op->cap = cap;
+    log->text_bytes += cap;
+    return 1;
+}
+
+/*
+ * Initialize an empty journal
+ */
+void undolog_init(undolog_t* log) {
+    memset(log, 0, sizeof(*log));
+}
+
+/*
+ * Discard all records and release their text buffers
+ */
+void undolog_clear(undolog_t* log) {
+    while (log->count > 0) {
+        evict_oldest(log);
+    }
+    log->head = 0;
+}
+
+/*
+ * Record a single inserted char; coalesces left-to-right typing runs
+ */
+void undolog_record_insert(undolog_t* log, int line, int col) {
+    undolog_op_t* op = newest(log);
+    if (op && op->type == UNDOLOG_INSERT && op->line == line &&
+        col == op->col + op->len) {
+        op->len++;
+        return;
+    }
+    op = push(log, UNDOLOG_INSERT, line, col);
+    op->len = 1;
+}
+
+/*
+ * Record a single deleted char; coalesces Backspace runs (position
+ * walking left) and Delete-key runs (position holding still)
+ */
+void undolog_record_delete(undolog_t* log, int line, int col, char ch) {
+    undolog_op_t* op = newest(log);
+    if (op && op->type == UNDOLOG_DELETE && op->line == line) {
+        if (col == op->col && text_reserve(log, op, op->len + 1)) {
+            /* Delete key: chars vanish at the same column, append */
+            op->text[op->len++] = ch;
+            return;
+        }
+        if (col == op->col - 1 && text_reserve(log, op, op->len + 1)) {
+            /* Backspace: run grows leftward, prepend */
+            memmove(op->text + 1, op->text, op->len);
+            op->text[0] = ch;
+            op->col--;
+            op->len++;
+            return;
+        }
+    }
+    op = push(log, UNDOLOG_DELETE, line, col);
+    if (!text_reserve(log, op, 1)) {
+        log->count--;   /* No room even for one char: drop the record */
+        return;
+    }
+    op->text[0] = ch;
+    op->len = 1;
+}
+
+/*
+ * Record a line split (Enter)
+ */
+void undolog_record_split(undolog_t* log, int line, int col) {
+    push(log, UNDOLOG_SPLIT, line, col);
+}
+
+/*
+ * Record a line joined with the next
+ */
+void undolog_record_join(undolog_t* log, int line, int col) {
+    push(log, UNDOLOG_JOIN, line, col);
+}
+
+/*
+ * Record a whole-line deletion with its former content
+ */
+void undolog_record_kill_line(undolog_t* log, int line, const char* text) {
+    undolog_op_t* op = push(log, UNDOLOG_KILL_LINE, line, 0);
+    int len = strlen(text);
+    if (!text_reserve(log, op, len + 1)) {
+        log->count--;
+        return;
+    }
+    memcpy(op->text, text, len);
+    op->text[len] = '\0';
+    op->len = len;
+}
+
+/*
+ * Newest record, or NULL when the journal is empty
+ */
+undolog_op_t* undolog_peek(undolog_t* log) {
+    return newest(log);
+}
+
+/*
+ * Discard the newest record (after undoing it)
+ */
+void undolog_drop(undolog_t* log) {
+    undolog_op_t* op = newest(log);
+    if (!op) return;
+    op_free_text(log, op);
+    log->count--;
+}
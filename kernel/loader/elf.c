@@ -11,6 +11,143 @@
 #include "../include/string.h"
 #include "../include/stdio.h"
 #include "../include/heap.h"
+#include "../include/process.h"
+
+/*
+ * Shared read-only text pages. Demand-paged read-only segments are
+ * keyed by (backing file, page-aligned file offset); the first fault
+ * anywhere fills a frame and registers it here, and later faults —
+ * typically the Nth instance of the same binary — just take a pmm
+ * reference and map the existing frame instead of reading the file
+ * again. The cache holds its own reference, so hot program text
+ * survives even when no instance is running. Slots recycle LRU;
+ * a changed file length invalidates its entries.
+ */
+#define ELF_TEXT_CACHE_SIZE 128
+
+typedef struct {
+    vfs_node_t* file;       /* Backing inode (NULL = free slot) */
+    uint32_t file_offset;   /* Page-aligned offset within the file */
+    uint32_t file_length;   /* File length at insert (staleness guard) */
+    uint32_t frame;         /* Physical frame (cache holds one ref) */
+    uint32_t stamp;         /* LRU */
+} elf_text_page_t;
+
+static elf_text_page_t elf_text_cache[ELF_TEXT_CACHE_SIZE];
+static uint32_t elf_text_stamp = 0;
+
+/*
+ * Find a cached text frame, or 0. A stale entry (file grew or was
+ * rewritten) is dropped on sight.
+ */
+static uint32_t elf_text_lookup(vfs_node_t* file, uint32_t file_offset) {
+    for (int i = 0; i < ELF_TEXT_CACHE_SIZE; i++) {
+        elf_text_page_t* tp = &elf_text_cache[i];
+        if (tp->file != file || tp->file_offset != file_offset) {
+            continue;
+        }
+        if (tp->file_length != file->length) {
+            pmm_free_frame(tp->frame);
+            tp->file = NULL;
+            return 0;
+        }
+        tp->stamp = ++elf_text_stamp;
+        return tp->frame;
+    }
+    return 0;
+}
+
+/*
+ * Register a freshly filled text frame, taking the cache's reference
+ */
+static void elf_text_insert(vfs_node_t* file, uint32_t file_offset, uint32_t frame) {
+    elf_text_page_t* victim = &elf_text_cache[0];
+    for (int i = 0; i < ELF_TEXT_CACHE_SIZE; i++) {
+        elf_text_page_t* tp = &elf_text_cache[i];
+        if (tp->file == NULL) {
+            victim = tp;
+            break;
+        }
+        if (tp->stamp < victim->stamp) {
+            victim = tp;
+        }
+    }
+
+    if (victim->file != NULL) {
+        pmm_free_frame(victim->frame);
+    }
+
+    victim->file = file;
+    victim->file_offset = file_offset;
+    victim->file_length = file->length;
+    victim->frame = frame;
+    victim->stamp = ++elf_text_stamp;
+    pmm_frame_ref(frame);
+}
+
+/*
+ * Parsed-program cache. The text-page cache above spares relaunches
+ * the data reads; this spares them the header reads and validation.
+ * A hit in both means launching a recently run binary touches the
+ * disk not at all: segment descriptors come from here and the pages
+ * from the text cache. Keyed by backing inode, guarded by file
+ * length (the VFS has no mtimes), recycled LRU.
+ */
+#define ELF_META_CACHE_SIZE 8
+
+typedef struct {
+    vfs_node_t* file;       /* Backing inode (NULL = free slot) */
+    uint32_t file_length;   /* File length at parse (staleness guard) */
+    uint32_t entry;         /* ELF entry point */
+    int nload;              /* Valid segment descriptors below */
+    struct {
+        uint32_t vaddr;
+        uint32_t memsz;
+        uint32_t file_offset;
+        uint32_t file_size;
+        uint32_t page_flags;
+    } seg[MAX_VMAS];
+    uint32_t stamp;         /* LRU */
+} elf_meta_t;
+
+static elf_meta_t elf_meta_cache[ELF_META_CACHE_SIZE];
+static uint32_t elf_meta_stamp = 0;
+
+/*
+ * Find a cached parse of this file, or NULL (stale entries dropped)
+ */
+static elf_meta_t* elf_meta_lookup(vfs_node_t* file) {
+    for (int i = 0; i < ELF_META_CACHE_SIZE; i++) {
+        elf_meta_t* m = &elf_meta_cache[i];
+        if (m->file != file) {
+            continue;
+        }
+        if (m->file_length != file->length) {
+            m->file = NULL;
+            return NULL;
+        }
+        m->stamp = ++elf_meta_stamp;
+        return m;
+    }
+    return NULL;
+}
+
+/*
+ * Pick the slot to (re)fill for a file: its own, a free one, or LRU
+ */
+static elf_meta_t* elf_meta_slot(vfs_node_t* file) {
+    elf_meta_t* victim = &elf_meta_cache[0];
+    for (int i = 0; i < ELF_META_CACHE_SIZE; i++) {
+        elf_meta_t* m = &elf_meta_cache[i];
+        if (m->file == file || m->file == NULL) {
+            return m;
+        }
+        if (m->stamp < victim->stamp) {
+            victim = m;
+        }
+    }
+    return victim;
+}
 
 /*
  * Validate an ELF header
@@ -147,9 +284,253 @@ int elf_load(const void* data, size_t size, uint32_t* entry) {
 }
 
 /*
- * Load an ELF executable from VFS
+ * Parse and validate an ELF file's headers into the parsed-program
+ * cache. Returns the filled cache entry, or NULL if the image is
+ * invalid or odd enough that the eager loader should handle it.
  */
-int elf_load_file(const char* path, uint32_t* entry) {
+static elf_meta_t* elf_parse_into_cache(vfs_node_t* node) {
+    elf32_ehdr_t ehdr;
+    if (vfs_read(node, 0, sizeof(ehdr), (uint8_t*)&ehdr) != (int32_t)sizeof(ehdr)) {
+        return NULL;
+    }
+
+    if (!elf_validate(&ehdr)) {
+        return NULL;
+    }
+
+    /* Check that program header table is within file */
+    uint32_t phdr_size = ehdr.e_phnum * sizeof(elf32_phdr_t);
+    if (ehdr.e_phoff + phdr_size > node->length) {
+        printk("ELF: Program header table beyond file end\n");
+        return NULL;
+    }
+
+    elf32_phdr_t* phdr = (elf32_phdr_t*)kmalloc(phdr_size);
+    if (phdr == NULL) {
+        return NULL;
+    }
+
+    if (vfs_read(node, ehdr.e_phoff, phdr_size, (uint8_t*)phdr) != (int32_t)phdr_size) {
+        kfree(phdr);
+        return NULL;
+    }
+
+    /* Validate every segment before caching anything */
+    int nload = 0;
+    for (uint16_t i = 0; i < ehdr.e_phnum; i++) {
+        if (phdr[i].p_type != PT_LOAD) {
+            continue;
+        }
+        if (phdr[i].p_offset + phdr[i].p_filesz > node->length ||
+            phdr[i].p_vaddr < 0x1000 || phdr[i].p_vaddr >= 0xC0000000 ||
+            phdr[i].p_filesz > phdr[i].p_memsz) {
+            printk("ELF: Segment %d invalid\n", i);
+            kfree(phdr);
+            return NULL;
+        }
+        nload++;
+    }
+
+    if (nload == 0 || nload > MAX_VMAS) {
+        kfree(phdr);
+        return NULL;  /* Odd image: let the eager path deal with it */
+    }
+
+    elf_meta_t* meta = elf_meta_slot(node);
+    meta->file = node;
+    meta->file_length = node->length;
+    meta->entry = ehdr.e_entry;
+    meta->nload = 0;
+    for (uint16_t i = 0; i < ehdr.e_phnum; i++) {
+        if (phdr[i].p_type != PT_LOAD) {
+            continue;
+        }
+        int s = meta->nload++;
+        meta->seg[s].vaddr = phdr[i].p_vaddr;
+        meta->seg[s].memsz = phdr[i].p_memsz;
+        meta->seg[s].file_offset = phdr[i].p_offset;
+        meta->seg[s].file_size = phdr[i].p_filesz;
+        meta->seg[s].page_flags = PAGE_USER;
+        if (phdr[i].p_flags & PF_W) {
+            meta->seg[s].page_flags |= PAGE_WRITE;
+        }
+    }
+    meta->stamp = ++elf_meta_stamp;
+
+    kfree(phdr);
+    return meta;
+}
+
+/*
+ * Record the PT_LOAD segments of an ELF file as VMA descriptors on a
+ * process instead of copying the image into memory. At most the ELF
+ * and program headers are read here (none of either on a program
+ * cache hit); pages are faulted in from the file on first access, so
+ * startup cost is proportional to the pages the program touches.
+ * Returns 0 on success, -1 if the image should be loaded eagerly.
+ */
+static int elf_map_lazy(vfs_node_t* node, process_t* proc, uint32_t* entry) {
+    elf_meta_t* meta = elf_meta_lookup(node);
+    if (meta == NULL) {
+        meta = elf_parse_into_cache(node);
+    }
+    if (meta == NULL) {
+        return -1;
+    }
+
+    /* Replace any previous image's descriptors (exec) */
+    elf_release_vmas(proc);
+
+    for (int i = 0; i < meta->nload; i++) {
+        vma_t* vma = &proc->vmas[i];
+        vma->used = true;
+        vma->vaddr = meta->seg[i].vaddr;
+        vma->memsz = meta->seg[i].memsz;
+        vma->file_offset = meta->seg[i].file_offset;
+        vma->file_size = meta->seg[i].file_size;
+        vma->page_flags = meta->seg[i].page_flags;
+
+        /* Pin the backing inode for the life of the process */
+        vma->file = node;
+        vfs_open(node, 0);
+
+        printk("ELF: Mapped segment %d lazily: vaddr=0x%08X memsz=0x%X\n",
+               i, vma->vaddr, vma->memsz);
+    }
+
+    *entry = meta->entry;
+    printk("ELF: Entry point at 0x%08X\n", *entry);
+
+    return 0;
+}
+
+/*
+ * Parse a binary into the program cache ahead of its first launch
+ * (boot-time preload of multiboot modules). Returns 0 on success.
+ */
+int elf_preparse_file(const char* path) {
+    vfs_node_t* node = vfs_lookup(path);
+    if (node == NULL) {
+        return -1;
+    }
+    if (elf_meta_lookup(node) != NULL) {
+        return 0;
+    }
+    return (elf_parse_into_cache(node) != NULL) ? 0 : -1;
+}
+
+/*
+ * Fault in one page of a demand-paged segment of the current process.
+ * Called from the page fault handler for not-present faults.
+ */
+bool elf_handle_fault(uint32_t fault_addr) {
+    process_t* proc = process_current();
+    if (proc == NULL) {
+        return false;
+    }
+
+    for (int i = 0; i < MAX_VMAS; i++) {
+        vma_t* vma = &proc->vmas[i];
+        if (!vma->used) {
+            continue;
+        }
+
+        uint32_t start = PAGE_ALIGN_DOWN(vma->vaddr);
+        uint32_t end = PAGE_ALIGN_UP(vma->vaddr + vma->memsz);
+        if (fault_addr < start || fault_addr >= end) {
+            continue;
+        }
+
+        uint32_t page = PAGE_ALIGN_DOWN(fault_addr);
+
+        /* Read-only file-backed pages have identical content in every
+         * instance of the binary, so they can share one frame. The
+         * segment must be page-congruent (vaddr and file offset agree
+         * modulo PAGE_SIZE) for the (file, offset) key to be valid. */
+        bool sharable = vma->file != NULL &&
+                        (vma->page_flags & PAGE_WRITE) == 0 &&
+                        (vma->vaddr & (PAGE_SIZE - 1)) ==
+                            (vma->file_offset & (PAGE_SIZE - 1));
+        uint32_t key_off = 0;
+        if (sharable) {
+            key_off = PAGE_ALIGN_DOWN(vma->file_offset) +
+                      (page - PAGE_ALIGN_DOWN(vma->vaddr));
+            uint32_t shared_frame = elf_text_lookup(vma->file, key_off);
+            if (shared_frame != 0) {
+                pmm_frame_ref(shared_frame);
+                paging_map_page(page, shared_frame, vma->page_flags);
+                return true;
+            }
+        }
+
+        uint32_t frame = pmm_alloc_frame();
+        if (frame == 0) {
+            printk("ELF: Out of memory faulting in 0x%08X\n", page);
+            return false;
+        }
+
+        /* Map and zero the page (covers BSS and partial pages) */
+        paging_map_page(page, frame, vma->page_flags);
+        memset((void*)page, 0, PAGE_SIZE);
+
+        /* Fill in the file-backed part of the page, if any */
+        uint32_t file_end = vma->vaddr + vma->file_size;
+        if (vma->file != NULL && page < file_end) {
+            uint32_t lo = (page > vma->vaddr) ? page : vma->vaddr;
+            uint32_t hi = (page + PAGE_SIZE < file_end) ? page + PAGE_SIZE : file_end;
+            if (hi > lo) {
+                vfs_read(vma->file, vma->file_offset + (lo - vma->vaddr),
+                         hi - lo, (uint8_t*)lo);
+            }
+        }
+
+        /* Publish the filled frame for later instances to share */
+        if (sharable) {
+            elf_text_insert(vma->file, key_off, frame);
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+/*
+ * Copy VMA descriptors from src to dst (fork). The clone only copies
+ * present page table entries, so the child needs the descriptors to
+ * fault in pages the parent never touched.
+ */
+void elf_clone_vmas(struct process* dst, const struct process* src) {
+    memcpy(dst->vmas, src->vmas, sizeof(dst->vmas));
+    for (int i = 0; i < MAX_VMAS; i++) {
+        if (dst->vmas[i].used && dst->vmas[i].file != NULL) {
+            vfs_open(dst->vmas[i].file, 0);
+        }
+    }
+}
+
+/*
+ * Release a process's VMA descriptors and unpin their backing files
+ */
+void elf_release_vmas(struct process* proc) {
+    if (proc == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < MAX_VMAS; i++) {
+        vma_t* vma = &proc->vmas[i];
+        if (vma->used && vma->file != NULL) {
+            vfs_close(vma->file);
+        }
+        vma->used = false;
+        vma->file = NULL;
+    }
+}
+
+/*
+ * Map an ELF executable from VFS into a process's address space
+ */
+int elf_map_file(const char* path, struct process* proc, uint32_t* entry) {
     /* Look up the file */
     vfs_node_t* node = vfs_lookup(path);
     if (node == NULL) {
@@ -164,6 +545,14 @@ int elf_load_file(const char* path, uint32_t* entry) {
         return -1;
     }
 
+    /* Demand paging: record segments as VMAs and let the page fault
+     * handler read pages in on first touch */
+    if (proc != NULL && elf_map_lazy(node, proc, entry) == 0) {
+        return 0;
+    }
+
+    /* Eager fallback: read the whole image and map every page now */
+
     /* Allocate buffer for file contents */
     void* data = kmalloc(size);
     if (data == NULL) {
@@ -188,3 +577,10 @@ int elf_load_file(const char* path, uint32_t* entry) {
     return result;
 }
 
+/*
+ * Load an ELF executable from VFS into the current process
+ */
+int elf_load_file(const char* path, uint32_t* entry) {
+    return elf_map_file(path, process_current(), entry);
+}
+
@@ -1,25 +1,41 @@
 /*
  * MiniOS Kernel Heap Implementation
- * 
- * Simple first-fit free list allocator.
- * Blocks are split when possible and merged on free.
+ *
+ * Segregated-fit allocator with power-of-two size classes.
+ * Each class keeps its own free list so small allocations are
+ * served in O(1); blocks are split when possible and physically
+ * adjacent free blocks are merged on free.
  */
 
 #include "../include/heap.h"
 #include "../include/string.h"
 #include "../include/stdio.h"
 #include "../include/panic.h"
+#include "../include/spinlock.h"
 
 /* Heap state */
 static uint32_t heap_start = 0;
 static uint32_t heap_end = 0;
 static uint32_t heap_size = 0;
-static heap_block_t* free_list = NULL;
+
+/*
+ * Per-class free lists. Class i holds free blocks whose total size
+ * (header included) is at least HEAP_CLASS_SIZE(i); the last class
+ * collects everything larger and is searched first-fit.
+ */
+static heap_block_t* free_lists[HEAP_NUM_CLASSES];
+
+/* Protects the free lists, statistics and block headers */
+static spinlock_t heap_lock = SPINLOCK_INIT("heap");
 
 /* Statistics */
 static uint32_t total_allocated = 0;
 static uint32_t block_count = 0;
 
+/* Per-size-class counters: allocations ever made and currently live */
+static uint32_t class_alloc_total[HEAP_NUM_CLASSES];
+static uint32_t class_alloc_live[HEAP_NUM_CLASSES];
+
 /*
  * Get block header from user pointer
  */
@@ -42,112 +58,222 @@ static inline bool validate_block(heap_block_t* block) {
 }
 
 /*
- * Split a block if it's large enough
+ * Smallest class whose blocks are guaranteed to hold 'total' bytes.
+ * Used on the allocation path.
+ */
+static int class_for_alloc(size_t total) {
+    for (int i = 0; i < HEAP_NUM_CLASSES - 1; i++) {
+        if (HEAP_CLASS_SIZE(i) >= total) return i;
+    }
+    return HEAP_NUM_CLASSES - 1;
+}
+
+/*
+ * Largest class whose minimum size a free block of 'total' bytes
+ * still satisfies. Used when inserting freed blocks.
+ */
+static int class_for_free(size_t total) {
+    for (int i = HEAP_NUM_CLASSES - 1; i > 0; i--) {
+        if (HEAP_CLASS_SIZE(i) <= total) return i;
+    }
+    return 0;
+}
+
+/*
+ * Push a free block onto its size-class list
+ */
+static void freelist_push(heap_block_t* block) {
+    int cls = class_for_free(block->size);
+    block->next = free_lists[cls];
+    free_lists[cls] = block;
+}
+
+/*
+ * Unlink a specific block from its size-class list
+ */
+static void freelist_remove(heap_block_t* block) {
+    int cls = class_for_free(block->size);
+    heap_block_t* prev = NULL;
+
+    for (heap_block_t* cur = free_lists[cls]; cur; cur = cur->next) {
+        if (cur == block) {
+            if (prev) prev->next = block->next;
+            else free_lists[cls] = block->next;
+            block->next = NULL;
+            return;
+        }
+        prev = cur;
+    }
+
+    kernel_panic("heap: free block missing from class list");
+}
+
+/*
+ * Split a block if it's large enough; the remainder goes back
+ * onto its size-class list.
  */
 static void split_block(heap_block_t* block, size_t size) {
     size_t total_needed = size + sizeof(heap_block_t);
     size_t remaining = block->size - total_needed;
-    
+
     /* Only split if remaining space is useful */
     if (remaining >= HEAP_MIN_BLOCK + sizeof(heap_block_t)) {
         heap_block_t* new_block = (heap_block_t*)((uint8_t*)block + total_needed);
         new_block->size = remaining;
         new_block->magic = HEAP_MAGIC;
         new_block->is_free = true;
-        new_block->next = block->next;
-        
+
         block->size = total_needed;
-        block->next = new_block;
-        
+
+        new_block->caller = 0;
+        freelist_push(new_block);
         block_count++;
     }
 }
 
 /*
- * Merge adjacent free blocks
+ * Bookkeeping for a block handed out / returned. The class is
+ * derived from the block's final (post-split) size, so alloc and
+ * free agree on the bucket.
  */
-static void merge_blocks(void) {
-    heap_block_t* block = (heap_block_t*)heap_start;
-    
-    while ((uint32_t)block < heap_end) {
-        if (block->is_free) {
-            heap_block_t* next = (heap_block_t*)((uint8_t*)block + block->size);
-            
-            while ((uint32_t)next < heap_end && next->is_free) {
-                block->size += next->size;
-                block->next = next->next;
-                block_count--;
-                next = (heap_block_t*)((uint8_t*)block + block->size);
-            }
-        }
-        block = (heap_block_t*)((uint8_t*)block + block->size);
+static void account_alloc(heap_block_t* block, uint32_t caller) {
+    int cls = class_for_alloc(block->size);
+    class_alloc_total[cls]++;
+    class_alloc_live[cls]++;
+    block->caller = caller;
+}
+
+static void account_free(heap_block_t* block) {
+    int cls = class_for_alloc(block->size);
+    if (class_alloc_live[cls] > 0) {
+        class_alloc_live[cls]--;
     }
+    block->caller = 0;
 }
 
 void heap_init(uint32_t start, uint32_t size) {
     heap_start = start;
     heap_size = size;
     heap_end = start + size;
-    
+
+    for (int i = 0; i < HEAP_NUM_CLASSES; i++) {
+        free_lists[i] = NULL;
+    }
+
+    for (int i = 0; i < HEAP_NUM_CLASSES; i++) {
+        class_alloc_total[i] = 0;
+        class_alloc_live[i] = 0;
+    }
+
     /* Create initial free block spanning entire heap */
-    free_list = (heap_block_t*)start;
-    free_list->size = size;
-    free_list->magic = HEAP_MAGIC;
-    free_list->is_free = true;
-    free_list->next = NULL;
-    
+    heap_block_t* initial = (heap_block_t*)start;
+    initial->size = size;
+    initial->magic = HEAP_MAGIC;
+    initial->is_free = true;
+    initial->next = NULL;
+    initial->caller = 0;
+    freelist_push(initial);
+
     block_count = 1;
     total_allocated = 0;
-    
-    printk("Heap: Initialized at 0x%08X, size %u KB\n", start, size / 1024);
+
+    spinlock_register(&heap_lock);
+
+    printk("Heap: Initialized at 0x%08X, size %u KB (%u size classes)\n",
+           start, size / 1024, HEAP_NUM_CLASSES);
 }
 
-void* kmalloc(size_t size) {
+/*
+ * Core allocator; 'caller' is the EIP of the allocation site and is
+ * stored in the block header for the site profiler.
+ */
+static void* kmalloc_caller(size_t size, uint32_t caller) {
     if (size == 0) return NULL;
-    
+
     /* Align size to 4 bytes */
     size = (size + 3) & ~3;
-    
-    /* Find first fit */
-    heap_block_t* block = (heap_block_t*)heap_start;
-    
-    while ((uint32_t)block < heap_end) {
+
+    size_t total = size + sizeof(heap_block_t);
+    int cls = class_for_alloc(total);
+
+    uint32_t eflags = spin_lock_irqsave(&heap_lock);
+
+    /*
+     * Exact classes: any block on list 'i' is large enough for
+     * requests mapped to class <= i, so just pop the head.
+     */
+    for (int i = cls; i < HEAP_NUM_CLASSES - 1; i++) {
+        heap_block_t* block = free_lists[i];
+        if (block == NULL) continue;
+
         if (!validate_block(block)) {
             kernel_panic("heap: corrupted block detected");
+            spin_unlock_irqrestore(&heap_lock, eflags);
             return NULL;
         }
-        
-        if (block->is_free && block->size >= size + sizeof(heap_block_t)) {
-            /* Found a suitable block */
+
+        free_lists[i] = block->next;
+        block->next = NULL;
+
+        split_block(block, size);
+        block->is_free = false;
+        total_allocated += block->size;
+        account_alloc(block, caller);
+        spin_unlock_irqrestore(&heap_lock, eflags);
+        return get_ptr(block);
+    }
+
+    /* Overflow class: variable sizes, first fit */
+    heap_block_t* prev = NULL;
+    for (heap_block_t* block = free_lists[HEAP_NUM_CLASSES - 1];
+         block; block = block->next) {
+        if (!validate_block(block)) {
+            kernel_panic("heap: corrupted block detected");
+            spin_unlock_irqrestore(&heap_lock, eflags);
+            return NULL;
+        }
+
+        if (block->size >= total) {
+            if (prev) prev->next = block->next;
+            else free_lists[HEAP_NUM_CLASSES - 1] = block->next;
+            block->next = NULL;
+
             split_block(block, size);
             block->is_free = false;
             total_allocated += block->size;
+            account_alloc(block, caller);
+            spin_unlock_irqrestore(&heap_lock, eflags);
             return get_ptr(block);
         }
-        
-        block = (heap_block_t*)((uint8_t*)block + block->size);
+        prev = block;
     }
-    
+    spin_unlock_irqrestore(&heap_lock, eflags);
+
     /* No suitable block found */
     printk("heap: out of memory (requested %u bytes)\n", size);
     return NULL;
 }
 
+void* kmalloc(size_t size) {
+    return kmalloc_caller(size, (uint32_t)__builtin_return_address(0));
+}
+
 void* kmalloc_aligned(size_t size, size_t alignment) {
     /* Simple implementation: allocate extra and align */
-    void* ptr = kmalloc(size + alignment);
+    void* ptr = kmalloc_caller(size + alignment,
+                               (uint32_t)__builtin_return_address(0));
     if (ptr == NULL) return NULL;
-    
+
     uint32_t addr = (uint32_t)ptr;
     uint32_t aligned = (addr + alignment - 1) & ~(alignment - 1);
-    
+
     /* For simplicity, we waste the unaligned portion */
     /* A more sophisticated implementation would track this */
     return (void*)aligned;
 }
 
 void* kzalloc(size_t size) {
-    void* ptr = kmalloc(size);
+    void* ptr = kmalloc_caller(size, (uint32_t)__builtin_return_address(0));
     if (ptr) memset(ptr, 0, size);
     return ptr;
 }
@@ -157,8 +283,10 @@ void* kcalloc(size_t count, size_t size) {
 }
 
 void* krealloc(void* ptr, size_t new_size) {
+    uint32_t caller = (uint32_t)__builtin_return_address(0);
+
     if (ptr == NULL) {
-        return kmalloc(new_size);
+        return kmalloc_caller(new_size, caller);
     }
 
     if (new_size == 0) {
@@ -180,7 +308,7 @@ void* krealloc(void* ptr, size_t new_size) {
     }
 
     /* Allocate new block and copy */
-    void* new_ptr = kmalloc(new_size);
+    void* new_ptr = kmalloc_caller(new_size, caller);
     if (new_ptr == NULL) {
         return NULL;
     }
@@ -206,11 +334,33 @@ void kfree(void* ptr) {
         return;
     }
 
-    block->is_free = true;
+    uint32_t eflags = spin_lock_irqsave(&heap_lock);
+
     total_allocated -= block->size;
+    account_free(block);
+
+    /*
+     * Merge forward with physically adjacent free blocks. Each
+     * neighbor is unlinked from its class list before being
+     * absorbed, so only local blocks are touched (no heap walk).
+     */
+    heap_block_t* next = (heap_block_t*)((uint8_t*)block + block->size);
+    while ((uint32_t)next < heap_end && next->is_free) {
+        if (!validate_block(next)) {
+            kernel_panic("heap: corrupted block detected");
+            spin_unlock_irqrestore(&heap_lock, eflags);
+            return;
+        }
+        freelist_remove(next);
+        block->size += next->size;
+        block_count--;
+        next = (heap_block_t*)((uint8_t*)block + block->size);
+    }
+
+    block->is_free = true;
+    freelist_push(block);
 
-    /* Merge adjacent free blocks */
-    merge_blocks();
+    spin_unlock_irqrestore(&heap_lock, eflags);
 }
 
 void heap_get_stats(heap_stats_t* stats) {
@@ -219,14 +369,101 @@ void heap_get_stats(heap_stats_t* stats) {
     stats->free_size = heap_size - total_allocated;
     stats->block_count = block_count;
 
-    /* Count free blocks */
+    /* Count free blocks across the class lists and track the largest;
+     * (free - largest) / free is a quick fragmentation read */
     uint32_t free_count = 0;
+    uint32_t largest = 0;
+    for (int i = 0; i < HEAP_NUM_CLASSES; i++) {
+        for (heap_block_t* block = free_lists[i]; block; block = block->next) {
+            free_count++;
+            if (block->size > largest) largest = block->size;
+        }
+    }
+    stats->free_block_count = free_count;
+    stats->largest_free = largest;
+}
+
+void heap_dump_classes(void) {
+    printk("Class       Size  Total alloc  Live\n");
+    for (int i = 0; i < HEAP_NUM_CLASSES; i++) {
+        if (class_alloc_total[i] == 0) continue;
+        if (i == HEAP_NUM_CLASSES - 1) {
+            printk("%5d  >=%6u  %11u  %4u\n", i,
+                   (uint32_t)HEAP_CLASS_SIZE(i),
+                   class_alloc_total[i], class_alloc_live[i]);
+        } else {
+            printk("%5d  %8u  %11u  %4u\n", i,
+                   (uint32_t)HEAP_CLASS_SIZE(i),
+                   class_alloc_total[i], class_alloc_live[i]);
+        }
+    }
+}
+
+/* Aggregation table for heap_dump_sites; sized for one dump */
+#define HEAP_MAX_SITES 48
+
+void heap_dump_sites(void) {
+    struct {
+        uint32_t caller;
+        uint32_t count;
+        uint32_t bytes;
+    } sites[HEAP_MAX_SITES];
+    int nsites = 0;
+    uint32_t overflow = 0;
+
+    /* Walk the heap and bucket live blocks by allocation site */
     heap_block_t* block = (heap_block_t*)heap_start;
     while ((uint32_t)block < heap_end) {
-        if (block->is_free) free_count++;
+        if (!validate_block(block)) {
+            printk("heap: invalid block at 0x%08X, aborting dump\n",
+                   (uint32_t)block);
+            return;
+        }
+        if (!block->is_free && block->caller != 0) {
+            int i;
+            for (i = 0; i < nsites; i++) {
+                if (sites[i].caller == block->caller) break;
+            }
+            if (i < nsites) {
+                sites[i].count++;
+                sites[i].bytes += block->size;
+            } else if (nsites < HEAP_MAX_SITES) {
+                sites[nsites].caller = block->caller;
+                sites[nsites].count = 1;
+                sites[nsites].bytes = block->size;
+                nsites++;
+            } else {
+                overflow++;
+            }
+        }
         block = (heap_block_t*)((uint8_t*)block + block->size);
     }
-    stats->free_block_count = free_count;
+
+    /* Selection sort by bytes, descending: the table is tiny */
+    for (int i = 0; i < nsites - 1; i++) {
+        int best = i;
+        for (int j = i + 1; j < nsites; j++) {
+            if (sites[j].bytes > sites[best].bytes) best = j;
+        }
+        if (best != i) {
+            uint32_t tc = sites[i].caller, tn = sites[i].count, tb = sites[i].bytes;
+            sites[i].caller = sites[best].caller;
+            sites[i].count = sites[best].count;
+            sites[i].bytes = sites[best].bytes;
+            sites[best].caller = tc;
+            sites[best].count = tn;
+            sites[best].bytes = tb;
+        }
+    }
+
+    printk("Caller        Blocks       Bytes\n");
+    for (int i = 0; i < nsites; i++) {
+        printk("0x%08X  %8u  %10u\n",
+               sites[i].caller, sites[i].count, sites[i].bytes);
+    }
+    if (overflow > 0) {
+        printk("(%u blocks from additional sites not shown)\n", overflow);
+    }
 }
 
 void heap_print_stats(void) {
@@ -276,4 +513,3 @@ uint32_t heap_get_used(void) {
     }
     return used;
 }
-
@@ -9,7 +9,11 @@
 #include "../include/idt.h"
 #include "../include/isr.h"
 #include "../include/paging.h"
+#include "../include/pmm.h"
+#include "../include/swap.h"
 #include "../include/process.h"
+#include "../include/elf.h"
+#include "../include/string.h"
 #include "../include/stdio.h"
 #include "../include/vga.h"
 #include "../include/serial.h"
@@ -30,6 +34,45 @@ static inline uint32_t get_cr2(void) {
     return cr2;
 }
 
+/* Top of the user stack region (first address past the stack) */
+#define USER_STACK_TOP  (USER_STACK_BASE + PAGE_SIZE)
+
+/*
+ * Lazy stack growth: only the top page of a user stack is committed
+ * at spawn. A not-present fault inside the growth window maps a fresh
+ * zeroed frame; the lowest page of the window is a guard that stays
+ * unmapped, so runaway recursion still dies with a clean SIGSEGV
+ * instead of silently corrupting whatever sits below.
+ */
+static bool stack_handle_fault(uint32_t fault_addr) {
+    process_t* proc = process_current();
+    if (proc == NULL || !proc->is_user_mode) {
+        return false;
+    }
+
+    /* Inside the growable window? (guard page excluded) */
+    if (fault_addr >= USER_STACK_TOP ||
+        fault_addr < USER_STACK_TOP - USER_STACK_MAX_SIZE + PAGE_SIZE) {
+        return false;
+    }
+
+    uint32_t page = PAGE_ALIGN_DOWN(fault_addr);
+    if (paging_is_mapped(page)) {
+        return false;  /* Protection fault, not growth */
+    }
+
+    uint32_t frame = pmm_alloc_frame_zeroed();
+    if (frame == 0) {
+        return false;  /* Out of memory - let the process die */
+    }
+    paging_map_page(page, frame, PAGE_USER | PAGE_WRITE);
+
+    if (page < proc->user_stack_base) {
+        proc->user_stack_base = page;
+    }
+    return true;
+}
+
 /*
  * Page fault handler
  * Called by ISR 14
@@ -44,7 +87,31 @@ static void page_fault_handler(registers_t* regs) {
     bool user = (err & PF_USER) != 0;
     bool reserved = (err & PF_RESERVED) != 0;
     bool ifetch = (err & PF_IFETCH) != 0;
-    
+
+    /* Copy-on-write: a write to a present page we deliberately mapped
+     * read-only. Break the sharing and retry the instruction. */
+    if (write && present && paging_handle_cow_fault(fault_addr)) {
+        return;
+    }
+
+    /* Swapped-out page: read it back in from the swap partition.
+     * Checked before the ELF path so an evicted ELF page restores its
+     * (possibly dirtied) swap copy, not the pristine file contents. */
+    if (!present && swap_handle_fault(fault_addr)) {
+        return;
+    }
+
+    /* Demand paging: a not-present page inside a recorded ELF segment
+     * is read in from the executable on first touch */
+    if (!present && elf_handle_fault(fault_addr)) {
+        return;
+    }
+
+    /* Stack growth: first touch below the committed user stack */
+    if (!present && stack_handle_fault(fault_addr)) {
+        return;
+    }
+
     /* Check if fault occurred in user mode */
     if (user) {
         /* User mode page fault - kill the process, preserve the system */
@@ -6,6 +6,8 @@
  */
 
 #include "../include/paging.h"
+#include "../include/swap.h"
+#include "../include/shm.h"
 #include "../include/pmm.h"
 #include "../include/string.h"
 #include "../include/stdio.h"
@@ -17,6 +19,28 @@ page_directory_t* kernel_directory = NULL;
 /* Current active page directory */
 static page_directory_t* current_directory = NULL;
 
+/* CPU supports 4MB pages (CPUID PSE bit, CR4.PSE set at init) */
+static bool pse_available = false;
+
+/*
+ * Write-combining via PAT: entry 1 of IA32_PAT (selected by PWT=1,
+ * PCD=0 in a PTE or large-page PDE) is reprogrammed from write-through
+ * to write-combining at init. Nothing else in the kernel uses WT, so
+ * the PWT bit becomes "this is framebuffer-style memory".
+ */
+#define MSR_IA32_PAT    0x277
+#define PAT_WC          0x01
+
+static bool pat_wc_enabled = false;
+
+static inline void rdmsr64(uint32_t msr, uint32_t* lo, uint32_t* hi) {
+    __asm__ volatile("rdmsr" : "=a"(*lo), "=d"(*hi) : "c"(msr));
+}
+
+static inline void wrmsr64(uint32_t msr, uint32_t lo, uint32_t hi) {
+    __asm__ volatile("wrmsr" : : "c"(msr), "a"(lo), "d"(hi));
+}
+
 /*
  * Load page directory into CR3
  */
@@ -68,6 +92,10 @@ static page_table_t* get_page_table(page_directory_t* dir, uint32_t virtual_addr
     uint32_t dir_index = PAGE_DIR_INDEX(virtual_addr);
     
     if (dir->entries[dir_index] & PAGE_PRESENT) {
+        if (dir->entries[dir_index] & PAGE_SIZE_4MB) {
+            /* Covered by a large page: there is no table to return */
+            return NULL;
+        }
         /* Page table exists */
         return (page_table_t*)PAGE_FRAME(dir->entries[dir_index]);
     }
@@ -76,16 +104,14 @@ static page_table_t* get_page_table(page_directory_t* dir, uint32_t virtual_addr
         return NULL;
     }
     
-    /* Allocate a new page table */
-    uint32_t table_phys = pmm_alloc_frame();
+    /* Allocate a new page table (pre-zeroed - no stale entries) */
+    uint32_t table_phys = pmm_alloc_frame_zeroed();
     if (table_phys == 0) {
         kernel_panic("paging: out of memory for page table");
         return NULL;
     }
-    
-    /* Clear the new page table */
+
     page_table_t* table = (page_table_t*)table_phys;
-    memset(table, 0, sizeof(page_table_t));
     
     /* Add to page directory */
     dir->entries[dir_index] = table_phys | PAGE_PRESENT | PAGE_WRITE | PAGE_USER;
@@ -93,6 +119,29 @@ static page_table_t* get_page_table(page_directory_t* dir, uint32_t virtual_addr
     return table;
 }
 
+/*
+ * Map a 4MB page: one directory entry, one TLB slot. Caller must
+ * check paging_pse_available() and pass 4MB-aligned addresses.
+ */
+void paging_map_4mb(uint32_t virtual_addr, uint32_t physical_addr, uint32_t flags) {
+    uint32_t dir_index = PAGE_DIR_INDEX(virtual_addr);
+    current_directory->entries[dir_index] =
+        (physical_addr & 0xFFC00000) | (flags & 0xFFF) | PAGE_PRESENT | PAGE_SIZE_4MB;
+    paging_flush_tlb_entry(virtual_addr);
+}
+
+bool paging_pse_available(void) {
+    return pse_available;
+}
+
+/*
+ * Cache flags for framebuffer mappings: write-combining when the PAT
+ * supports it, plain uncached otherwise
+ */
+uint32_t paging_fb_cache_flags(void) {
+    return pat_wc_enabled ? PAGE_WRITETHROUGH : PAGE_NOCACHE;
+}
+
 void paging_map_page(uint32_t virtual_addr, uint32_t physical_addr, uint32_t flags) {
     virtual_addr = PAGE_ALIGN_DOWN(virtual_addr);
     physical_addr = PAGE_ALIGN_DOWN(physical_addr);
@@ -123,6 +172,11 @@ void paging_unmap_page(uint32_t virtual_addr) {
 }
 
 uint32_t paging_get_physical(uint32_t virtual_addr) {
+    uint32_t pde = current_directory->entries[PAGE_DIR_INDEX(virtual_addr)];
+    if ((pde & PAGE_PRESENT) && (pde & PAGE_SIZE_4MB)) {
+        return (pde & 0xFFC00000) | (virtual_addr & 0x3FFFFF);
+    }
+
     page_table_t* table = get_page_table(current_directory, virtual_addr, false);
     if (table == NULL) {
         return 0;
@@ -137,6 +191,11 @@ uint32_t paging_get_physical(uint32_t virtual_addr) {
 }
 
 bool paging_is_mapped(uint32_t virtual_addr) {
+    uint32_t pde = current_directory->entries[PAGE_DIR_INDEX(virtual_addr)];
+    if ((pde & PAGE_PRESENT) && (pde & PAGE_SIZE_4MB)) {
+        return true;
+    }
+
     page_table_t* table = get_page_table(current_directory, virtual_addr, false);
     if (table == NULL) {
         return false;
@@ -146,14 +205,63 @@ bool paging_is_mapped(uint32_t virtual_addr) {
     return (table->entries[table_index] & PAGE_PRESENT) != 0;
 }
 
+/*
+ * Check a whole virtual range for present mappings in one walk.
+ * The page table pointer is re-derived only when the range crosses
+ * into a new directory entry, so validating a large buffer touches
+ * the directory once per 4MB window instead of once per page.
+ */
+bool paging_is_range_mapped(uint32_t start, uint32_t size) {
+    if (size == 0) {
+        return true;
+    }
+
+    uint32_t end = start + size - 1;
+    if (end < start) {
+        return false;  /* Range wraps the address space */
+    }
+
+    uint32_t page = PAGE_ALIGN_DOWN(start);
+    page_table_t* table = NULL;
+    uint32_t table_base = 0;
+
+    while (1) {
+        uint32_t dir_base = page & 0xFFC00000;
+        if (table == NULL || dir_base != table_base) {
+            uint32_t pde = current_directory->entries[PAGE_DIR_INDEX(page)];
+            if ((pde & PAGE_PRESENT) && (pde & PAGE_SIZE_4MB)) {
+                /* Whole 4MB window is present - skip past it */
+                if (end - dir_base < 0x400000) {
+                    return true;
+                }
+                page = dir_base + 0x400000;
+                table = NULL;
+                continue;
+            }
+            table = get_page_table(current_directory, page, false);
+            if (table == NULL) {
+                return false;
+            }
+            table_base = dir_base;
+        }
+
+        if (!(table->entries[PAGE_TABLE_INDEX(page)] & PAGE_PRESENT)) {
+            return false;
+        }
+        if (end - page < PAGE_SIZE) {
+            return true;
+        }
+        page += PAGE_SIZE;
+    }
+}
+
 page_directory_t* paging_create_directory(void) {
-    uint32_t phys = pmm_alloc_frame();
+    uint32_t phys = pmm_alloc_frame_zeroed();
     if (phys == 0) {
         return NULL;
     }
 
     page_directory_t* dir = (page_directory_t*)phys;
-    memset(dir, 0, sizeof(page_directory_t));
 
     /* Copy kernel page tables (upper memory) to new directory */
     /* For now, we identity map, so just copy all entries */
@@ -165,35 +273,106 @@ page_directory_t* paging_create_directory(void) {
 }
 
 page_directory_t* paging_clone_directory(page_directory_t* src) {
-    /* For now, just create a copy - COW can be added later */
     page_directory_t* dir = paging_create_directory();
     if (dir == NULL) {
         return NULL;
     }
 
-    /* Copy user-space page tables */
-    for (int i = 0; i < 768; i++) {  /* First 3GB is user space */
-        if (src->entries[i] & PAGE_PRESENT) {
-            /* Allocate new page table */
-            uint32_t table_phys = pmm_alloc_frame();
-            if (table_phys == 0) {
-                /* TODO: cleanup on failure */
-                return NULL;
+    /* Copy user-space page tables (first 3GB). Tables the source
+     * shares with the kernel (identity map) stay shared; process
+     * private tables are copied, but the frames they map are shared
+     * copy-on-write: both sides lose PAGE_WRITE and gain PAGE_COW,
+     * and the frame's refcount is bumped. */
+    for (int i = 0; i < 768; i++) {
+        if (!(src->entries[i] & PAGE_PRESENT)) {
+            continue;
+        }
+        if (src->entries[i] == kernel_directory->entries[i]) {
+            continue;  /* Already present via paging_create_directory */
+        }
+
+        uint32_t table_phys = pmm_alloc_frame();
+        if (table_phys == 0) {
+            paging_free_directory(dir);
+            return NULL;
+        }
+
+        page_table_t* src_table = (page_table_t*)PAGE_FRAME(src->entries[i]);
+        page_table_t* dst_table = (page_table_t*)table_phys;
+
+        for (int j = 0; j < PAGES_PER_TABLE; j++) {
+            uint32_t pte = src_table->entries[j];
+            if (!(pte & PAGE_PRESENT)) {
+                dst_table->entries[j] = pte;
+                continue;
             }
 
-            page_table_t* src_table = (page_table_t*)PAGE_FRAME(src->entries[i]);
-            page_table_t* dst_table = (page_table_t*)table_phys;
+            /* Shared memory attachments stay writable and shared;
+             * COW-copying them on fork would break the sharing */
+            uint32_t vaddr = ((uint32_t)i << 22) | ((uint32_t)j << 12);
+            if (vaddr >= SHM_VADDR_BASE && vaddr < SHM_VADDR_END) {
+                dst_table->entries[j] = pte;
+                continue;
+            }
 
-            /* Copy page table entries */
-            memcpy(dst_table, src_table, sizeof(page_table_t));
+            if (pte & PAGE_WRITE) {
+                /* Downgrade to read-only COW in both directories */
+                pte = (pte & ~(uint32_t)PAGE_WRITE) | PAGE_COW;
+                src_table->entries[j] = pte;
+            }
 
-            dir->entries[i] = table_phys | (src->entries[i] & 0xFFF);
+            pmm_frame_ref(PAGE_FRAME(pte));
+            dst_table->entries[j] = pte;
         }
+
+        dir->entries[i] = table_phys | (src->entries[i] & 0xFFF);
+    }
+
+    /* The source's TLB may still cache writable mappings */
+    if (src == current_directory) {
+        paging_flush_tlb();
     }
 
     return dir;
 }
 
+/*
+ * Break copy-on-write sharing for a faulting write. The last holder
+ * of a frame just gets its write permission back; otherwise the frame
+ * is duplicated and this address space remaps to the private copy.
+ */
+bool paging_handle_cow_fault(uint32_t fault_addr) {
+    page_table_t* table = get_page_table(current_directory, fault_addr, false);
+    if (table == NULL) {
+        return false;
+    }
+
+    uint32_t index = PAGE_TABLE_INDEX(fault_addr);
+    uint32_t pte = table->entries[index];
+    if (!(pte & PAGE_PRESENT) || !(pte & PAGE_COW)) {
+        return false;
+    }
+
+    uint32_t old_frame = PAGE_FRAME(pte);
+    uint32_t flags = (pte & 0xFFF & ~(uint32_t)PAGE_COW) | PAGE_WRITE;
+
+    if (pmm_frame_refcount(old_frame) == 1) {
+        /* Sole remaining user: write access can simply be restored */
+        table->entries[index] = old_frame | flags;
+    } else {
+        uint32_t new_frame = pmm_alloc_frame();
+        if (new_frame == 0) {
+            return false;
+        }
+        memcpy((void*)new_frame, (void*)old_frame, PAGE_SIZE);
+        table->entries[index] = new_frame | flags;
+        pmm_free_frame(old_frame);  /* Drop this space's reference */
+    }
+
+    paging_flush_tlb_entry(PAGE_ALIGN_DOWN(fault_addr));
+    return true;
+}
+
 void paging_free_directory(page_directory_t* dir) {
     if (dir == NULL || dir == kernel_directory) {
         return;
@@ -201,15 +380,100 @@ void paging_free_directory(page_directory_t* dir) {
 
     /* Free user-space page tables */
     for (int i = 0; i < 768; i++) {
-        if (dir->entries[i] & PAGE_PRESENT) {
-            pmm_free_frame(PAGE_FRAME(dir->entries[i]));
+        if (!(dir->entries[i] & PAGE_PRESENT)) {
+            continue;
+        }
+        if (dir->entries[i] == kernel_directory->entries[i]) {
+            continue;  /* Shared kernel table: not ours to free */
         }
+
+        /* Drop references to frames shared copy-on-write, and release
+         * swap slots still holding evicted pages */
+        page_table_t* table = (page_table_t*)PAGE_FRAME(dir->entries[i]);
+        for (int j = 0; j < PAGES_PER_TABLE; j++) {
+            uint32_t pte = table->entries[j];
+            if ((pte & PAGE_PRESENT) && (pte & PAGE_COW)) {
+                pmm_free_frame(PAGE_FRAME(pte));
+            } else if (!(pte & PAGE_PRESENT) && (pte & PAGE_SWAPPED)) {
+                swap_slot_free(pte >> PAGE_SHIFT);
+            }
+        }
+
+        pmm_free_frame((uint32_t)table);
     }
 
     /* Free the directory itself */
     pmm_free_frame((uint32_t)dir);
 }
 
+uint32_t paging_get_entry(page_directory_t* dir, uint32_t virtual_addr) {
+    uint32_t pde = dir->entries[PAGE_DIR_INDEX(virtual_addr)];
+    if (!(pde & PAGE_PRESENT) || (pde & PAGE_SIZE_4MB)) {
+        return 0;
+    }
+    page_table_t* table = (page_table_t*)PAGE_FRAME(pde);
+    return table->entries[PAGE_TABLE_INDEX(virtual_addr)];
+}
+
+void paging_set_entry(page_directory_t* dir, uint32_t virtual_addr, uint32_t entry) {
+    uint32_t pde = dir->entries[PAGE_DIR_INDEX(virtual_addr)];
+    if (!(pde & PAGE_PRESENT) || (pde & PAGE_SIZE_4MB)) {
+        return;
+    }
+    page_table_t* table = (page_table_t*)PAGE_FRAME(pde);
+    table->entries[PAGE_TABLE_INDEX(virtual_addr)] = entry;
+    if (dir == current_directory) {
+        paging_flush_tlb_entry(virtual_addr);
+    }
+}
+
+/*
+ * Accessed-bit aging scan (see paging.h). Directory entries shared
+ * with the kernel (identity map) are skipped wholesale: only process
+ * private tables can hold user pages worth evicting.
+ */
+uint32_t paging_scan_cold(page_directory_t* dir, uint32_t* cursor, uint32_t* budget) {
+    uint32_t vaddr = PAGE_ALIGN_DOWN(*cursor);
+
+    while (*budget > 0) {
+        if (vaddr >= 0xC0000000) {
+            vaddr = 0;  /* Wrap back to the start of user space */
+        }
+
+        uint32_t dir_index = PAGE_DIR_INDEX(vaddr);
+        uint32_t pde = dir->entries[dir_index];
+        if (!(pde & PAGE_PRESENT) || (pde & PAGE_SIZE_4MB) ||
+            pde == kernel_directory->entries[dir_index]) {
+            vaddr = (vaddr & 0xFFC00000) + 0x400000;
+            (*budget)--;
+            continue;
+        }
+
+        page_table_t* table = (page_table_t*)PAGE_FRAME(pde);
+        uint32_t index = PAGE_TABLE_INDEX(vaddr);
+        uint32_t pte = table->entries[index];
+
+        if ((pte & PAGE_PRESENT) && (pte & PAGE_USER)) {
+            if (pte & PAGE_ACCESSED) {
+                /* Used since the last round: age it and move on */
+                table->entries[index] = pte & ~(uint32_t)PAGE_ACCESSED;
+                if (dir == current_directory) {
+                    paging_flush_tlb_entry(vaddr);
+                }
+            } else {
+                *cursor = vaddr + PAGE_SIZE;
+                return vaddr;
+            }
+        }
+
+        vaddr += PAGE_SIZE;
+        (*budget)--;
+    }
+
+    *cursor = vaddr;
+    return 0;
+}
+
 /*
  * Initialize paging with identity mapping
  */
@@ -243,8 +507,47 @@ void paging_init(void) {
 
     printk("Paging: Identity mapping first %u MB...\n", map_limit / (1024 * 1024));
 
-    for (uint32_t addr = 0; addr < map_limit; addr += PAGE_SIZE) {
-        paging_map_page(addr, addr, PAGE_KERNEL);
+    /* CPUID.1 EDX bit 3: PSE (4MB pages) */
+    uint32_t cpuid_eax, cpuid_edx;
+    __asm__ volatile("cpuid"
+                     : "=a"(cpuid_eax), "=d"(cpuid_edx)
+                     : "a"(1)
+                     : "ebx", "ecx");
+    (void)cpuid_eax;
+    pse_available = (cpuid_edx & (1 << 3)) != 0;
+
+    if (pse_available) {
+        uint32_t cr4;
+        __asm__ volatile("mov %%cr4, %0" : "=r"(cr4));
+        cr4 |= 0x10;  /* CR4.PSE */
+        __asm__ volatile("mov %0, %%cr4" : : "r"(cr4));
+
+        /* One directory entry per 4MB instead of a 1024-entry table:
+         * the whole identity map costs 128 PDEs and large TLB slots */
+        uint32_t big_limit = map_limit & 0xFFC00000;
+        for (uint32_t addr = 0; addr < big_limit; addr += 0x400000) {
+            kernel_directory->entries[PAGE_DIR_INDEX(addr)] =
+                addr | PAGE_KERNEL | PAGE_SIZE_4MB;
+        }
+        for (uint32_t addr = big_limit; addr < map_limit; addr += PAGE_SIZE) {
+            paging_map_page(addr, addr, PAGE_KERNEL);
+        }
+        printk("Paging: PSE enabled, identity map uses 4MB pages\n");
+    } else {
+        for (uint32_t addr = 0; addr < map_limit; addr += PAGE_SIZE) {
+            paging_map_page(addr, addr, PAGE_KERNEL);
+        }
+    }
+
+    /* CPUID.1 EDX bit 16: PAT. Repoint entry 1 (PWT) at
+     * write-combining for framebuffer mappings. */
+    if (cpuid_edx & (1 << 16)) {
+        uint32_t pat_lo, pat_hi;
+        rdmsr64(MSR_IA32_PAT, &pat_lo, &pat_hi);
+        pat_lo = (pat_lo & ~0x0000FF00u) | ((uint32_t)PAT_WC << 8);
+        wrmsr64(MSR_IA32_PAT, pat_lo, pat_hi);
+        pat_wc_enabled = true;
+        printk("Paging: PAT entry 1 set to write-combining\n");
     }
 
     /* Load page directory and enable paging */
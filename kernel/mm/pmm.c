@@ -8,6 +8,7 @@
 #include "../include/pmm.h"
 #include "../include/string.h"
 #include "../include/stdio.h"
+#include "../include/spinlock.h"
 
 /* Bitmap for tracking physical frames */
 static uint32_t* pmm_bitmap = NULL;
@@ -19,6 +20,34 @@ static uint32_t pmm_used_frames = 0;
 static uint32_t pmm_memory_start = 0;
 static uint32_t pmm_memory_end = 0;
 
+/*
+ * Per-frame reference counts for frames shared between address spaces
+ * (copy-on-write). 0 means "never shared" and is treated as 1; the
+ * count saturates at 255 rather than wrapping, at which point the
+ * frame is pinned forever (safer than a double free).
+ */
+static uint8_t* pmm_refcount = NULL;
+
+/*
+ * Rotating next-fit cursors. Single-frame allocation resumes from the
+ * bitmap word of the previous hit instead of rescanning from frame 0;
+ * contiguous allocations keep one cursor per power-of-two order so a
+ * fill-up in one size band does not slow the others.
+ */
+static uint32_t frame_cursor = 0;
+static uint32_t region_cursor[PMM_REGION_ORDERS];
+
+/*
+ * Order of a region: smallest o with (1 << o) >= count, clamped
+ */
+static uint32_t region_order(uint32_t count) {
+    uint32_t order = 0;
+    while ((1u << order) < count && order < PMM_REGION_ORDERS - 1) {
+        order++;
+    }
+    return order;
+}
+
 /*
  * Set a bit in the bitmap (mark frame as used)
  */
@@ -41,15 +70,18 @@ static inline bool bitmap_test(uint32_t frame) {
 }
 
 /*
- * Find first free frame
+ * Find a free frame, next-fit: resume from the cursor word, skip full
+ * words, wrap around once.
  */
 static uint32_t bitmap_find_free(void) {
-    for (uint32_t i = 0; i < pmm_bitmap_size; i++) {
+    for (uint32_t n = 0; n < pmm_bitmap_size; n++) {
+        uint32_t i = (frame_cursor + n) % pmm_bitmap_size;
         if (pmm_bitmap[i] != 0xFFFFFFFF) {
             /* Found a uint32_t with at least one free bit */
             for (uint32_t j = 0; j < 32; j++) {
                 uint32_t frame = i * 32 + j;
                 if (frame < pmm_total_frames && !bitmap_test(frame)) {
+                    frame_cursor = i;
                     return frame;
                 }
             }
@@ -59,13 +91,20 @@ static uint32_t bitmap_find_free(void) {
 }
 
 /*
- * Find contiguous free frames
+ * Scan [from, limit) for 'count' contiguous free frames, skipping a
+ * whole word whenever it is fully allocated.
  */
-static uint32_t bitmap_find_free_region(uint32_t count) {
-    uint32_t start = 0;
+static uint32_t region_scan(uint32_t from, uint32_t limit, uint32_t count) {
+    uint32_t start = from;
     uint32_t found = 0;
-    
-    for (uint32_t frame = 0; frame < pmm_total_frames; frame++) {
+
+    for (uint32_t frame = from; frame < limit; ) {
+        if ((frame % 32) == 0 && pmm_bitmap[frame / 32] == 0xFFFFFFFF) {
+            /* Whole word allocated: restart the run past it */
+            frame += 32;
+            found = 0;
+            continue;
+        }
         if (!bitmap_test(frame)) {
             if (found == 0) start = frame;
             found++;
@@ -73,8 +112,31 @@ static uint32_t bitmap_find_free_region(uint32_t count) {
         } else {
             found = 0;
         }
+        frame++;
     }
-    return (uint32_t)-1;  /* Not enough contiguous frames */
+    return (uint32_t)-1;
+}
+
+/*
+ * Find contiguous free frames, next-fit from the per-order cursor
+ */
+static uint32_t bitmap_find_free_region(uint32_t count) {
+    uint32_t order = region_order(count);
+    uint32_t hint = region_cursor[order];
+    if (hint >= pmm_total_frames) hint = 0;
+
+    /* Cursor to end, then wrap and cover the skipped prefix */
+    uint32_t start = region_scan(hint, pmm_total_frames, count);
+    if (start == (uint32_t)-1 && hint > 0) {
+        uint32_t limit = hint + count - 1;
+        if (limit > pmm_total_frames) limit = pmm_total_frames;
+        start = region_scan(0, limit, count);
+    }
+
+    if (start != (uint32_t)-1) {
+        region_cursor[order] = start + count;
+    }
+    return start;
 }
 
 void pmm_mark_used(uint32_t addr) {
@@ -109,17 +171,83 @@ void pmm_mark_region_free(uint32_t start, uint32_t size) {
     }
 }
 
+/*
+ * Pool of pre-zeroed frames, filled by the idle loop. Frames in the
+ * pool are marked used in the bitmap, so they are invisible to the
+ * normal allocator until popped. Push/pop run under interrupt masking
+ * (the idle filler and allocation paths interleave freely).
+ */
+#define PMM_ZERO_POOL_SIZE 64
+static uint32_t zero_pool[PMM_ZERO_POOL_SIZE];
+static uint32_t zero_pool_count = 0;
+static spinlock_t zero_pool_lock = SPINLOCK_INIT("zero_pool");
+
+static uint32_t zero_pool_pop(void) {
+    uint32_t eflags = spin_lock_irqsave(&zero_pool_lock);
+    uint32_t addr = 0;
+    if (zero_pool_count > 0) {
+        addr = zero_pool[--zero_pool_count];
+    }
+    spin_unlock_irqrestore(&zero_pool_lock, eflags);
+    return addr;
+}
+
 uint32_t pmm_alloc_frame(void) {
     uint32_t frame = bitmap_find_free();
     if (frame == (uint32_t)-1) {
-        return 0;  /* Out of memory */
+        /* Bitmap exhausted: raid the zero pool before giving up */
+        return zero_pool_pop();
     }
-    
+
     bitmap_set(frame);
     pmm_used_frames++;
     return FRAME_TO_ADDR(frame);
 }
 
+uint32_t pmm_alloc_frame_zeroed(void) {
+    uint32_t addr = zero_pool_pop();
+    if (addr != 0) {
+        return addr;
+    }
+
+    /* Pool empty: zero on the allocation path like before */
+    addr = pmm_alloc_frame();
+    if (addr != 0) {
+        memset((void*)addr, 0, PAGE_SIZE);
+    }
+    return addr;
+}
+
+bool pmm_zero_pool_topup(void) {
+    if (zero_pool_count >= PMM_ZERO_POOL_SIZE) {
+        return false;
+    }
+
+    uint32_t frame = bitmap_find_free();
+    if (frame == (uint32_t)-1) {
+        return false;  /* No memory to stage */
+    }
+    bitmap_set(frame);
+    pmm_used_frames++;
+
+    uint32_t addr = FRAME_TO_ADDR(frame);
+    memset((void*)addr, 0, PAGE_SIZE);
+
+    uint32_t eflags = spin_lock_irqsave(&zero_pool_lock);
+    bool pushed = false;
+    if (zero_pool_count < PMM_ZERO_POOL_SIZE) {
+        zero_pool[zero_pool_count++] = addr;
+        pushed = true;
+    }
+    spin_unlock_irqrestore(&zero_pool_lock, eflags);
+
+    if (!pushed) {
+        /* Raced with another filler: hand the frame back */
+        pmm_free_frame(addr);
+    }
+    return pushed;
+}
+
 uint32_t pmm_alloc_frames(uint32_t count) {
     uint32_t start = bitmap_find_free_region(count);
     if (start == (uint32_t)-1) {
@@ -135,16 +263,52 @@ uint32_t pmm_alloc_frames(uint32_t count) {
 
 void pmm_free_frame(uint32_t addr) {
     uint32_t frame = ADDR_TO_FRAME(addr);
-    if (frame < pmm_total_frames && bitmap_test(frame)) {
-        bitmap_clear(frame);
-        pmm_used_frames--;
+    if (frame >= pmm_total_frames || !bitmap_test(frame)) {
+        return;
+    }
+
+    if (pmm_refcount != NULL && pmm_refcount[frame] > 1) {
+        if (pmm_refcount[frame] < 255) {
+            pmm_refcount[frame]--;
+        }
+        return;  /* Still referenced by another address space */
+    }
+
+    if (pmm_refcount != NULL) {
+        pmm_refcount[frame] = 0;
+    }
+    bitmap_clear(frame);
+    pmm_used_frames--;
+}
+
+void pmm_frame_ref(uint32_t addr) {
+    uint32_t frame = ADDR_TO_FRAME(addr);
+    if (pmm_refcount == NULL || frame >= pmm_total_frames || !bitmap_test(frame)) {
+        return;
     }
+
+    if (pmm_refcount[frame] == 0) {
+        pmm_refcount[frame] = 2;   /* Owner plus the new reference */
+    } else if (pmm_refcount[frame] < 255) {
+        pmm_refcount[frame]++;
+    }
+}
+
+uint32_t pmm_frame_refcount(uint32_t addr) {
+    uint32_t frame = ADDR_TO_FRAME(addr);
+    if (pmm_refcount == NULL || frame >= pmm_total_frames) {
+        return 1;
+    }
+    return (pmm_refcount[frame] == 0) ? 1 : pmm_refcount[frame];
 }
 
 void pmm_free_frames(uint32_t addr, uint32_t count) {
     for (uint32_t i = 0; i < count; i++) {
         pmm_free_frame(addr + i * PAGE_SIZE);
     }
+
+    /* Freed regions are the best place for the next same-order search */
+    region_cursor[region_order(count)] = ADDR_TO_FRAME(addr);
 }
 
 bool pmm_is_frame_used(uint32_t addr) {
@@ -200,13 +364,15 @@ void pmm_init(multiboot_info_t* mboot, uint32_t kernel_end) {
     pmm_bitmap_size = (pmm_total_frames + 31) / 32;
     uint32_t bitmap_bytes = pmm_bitmap_size * sizeof(uint32_t);
 
-    /* Place bitmap right after kernel */
+    /* Place bitmap right after kernel, refcount array after that */
     pmm_bitmap = (uint32_t*)PAGE_ALIGN_UP(kernel_end);
-    pmm_memory_start = (uint32_t)pmm_bitmap + bitmap_bytes;
+    pmm_refcount = (uint8_t*)((uint32_t)pmm_bitmap + bitmap_bytes);
+    pmm_memory_start = (uint32_t)pmm_refcount + pmm_total_frames;
     pmm_memory_start = PAGE_ALIGN_UP(pmm_memory_start);
 
     /* Initially mark ALL frames as used */
     memset(pmm_bitmap, 0xFF, bitmap_bytes);
+    memset(pmm_refcount, 0, pmm_total_frames);
     pmm_used_frames = pmm_total_frames;
 
     /* Parse memory map and mark available regions as free */
@@ -240,9 +406,11 @@ void pmm_init(multiboot_info_t* mboot, uint32_t kernel_end) {
         mmap = (multiboot_mmap_entry_t*)((uint32_t)mmap + mmap->size + sizeof(mmap->size));
     }
 
-    /* Mark kernel and bitmap as used */
+    /* Mark kernel, bitmap and refcount array as used */
     pmm_mark_region_used(0x100000, kernel_end - 0x100000);  /* Kernel */
-    pmm_mark_region_used((uint32_t)pmm_bitmap, bitmap_bytes);  /* Bitmap */
+    pmm_mark_region_used((uint32_t)pmm_bitmap, bitmap_bytes + pmm_total_frames);
+
+    spinlock_register(&zero_pool_lock);
 
     printk("PMM: Bitmap at 0x%08X (%u bytes)\n", (uint32_t)pmm_bitmap, bitmap_bytes);
     pmm_print_stats();
@@ -0,0 +1,121 @@
+/*
+ * MiniOS Slab Cache Implementation
+ *
+ * Fixed-size object caches layered over the kernel heap. Each cache
+ * grabs SLAB_SIZE chunks from kmalloc, carves them into padded
+ * objects and threads the free ones through an intrusive free list,
+ * so kmem_cache_alloc/kmem_cache_free are a pointer pop/push with no
+ * header overhead or block splitting in the general heap.
+ */
+
+#include "../include/slab.h"
+#include "../include/heap.h"
+#include "../include/string.h"
+#include "../include/stdio.h"
+#include "../include/panic.h"
+#include "../include/vfs.h"
+
+/* Standard caches */
+kmem_cache_t* vfs_node_cache = NULL;
+kmem_cache_t* dirent_cache = NULL;
+
+/* All caches, for stats reporting */
+static kmem_cache_t* cache_list = NULL;
+
+/*
+ * Add one slab's worth of objects to a cache's free list
+ */
+static bool cache_grow(kmem_cache_t* cache) {
+    kmem_slab_t* slab = (kmem_slab_t*)kmalloc(SLAB_SIZE);
+    if (slab == NULL) return false;
+
+    slab->next = cache->slabs;
+    cache->slabs = slab;
+
+    /* Objects start after the slab header, aligned */
+    uint32_t base = (uint32_t)slab + sizeof(kmem_slab_t);
+    base = (base + SLAB_OBJ_ALIGN - 1) & ~(SLAB_OBJ_ALIGN - 1);
+
+    for (uint32_t i = 0; i < cache->objs_per_slab; i++) {
+        void* obj = (void*)(base + i * cache->stride);
+        *(void**)obj = cache->free_head;
+        cache->free_head = obj;
+    }
+
+    cache->total_objs += cache->objs_per_slab;
+    return true;
+}
+
+kmem_cache_t* kmem_cache_create(const char* name, size_t obj_size) {
+    if (obj_size < sizeof(void*)) obj_size = sizeof(void*);
+
+    kmem_cache_t* cache = (kmem_cache_t*)kzalloc(sizeof(kmem_cache_t));
+    if (cache == NULL) return NULL;
+
+    strncpy(cache->name, name, KMEM_CACHE_NAME_MAX - 1);
+    cache->obj_size = obj_size;
+    cache->stride = (obj_size + SLAB_OBJ_ALIGN - 1) & ~(size_t)(SLAB_OBJ_ALIGN - 1);
+
+    size_t usable = SLAB_SIZE - SLAB_OBJ_ALIGN;  /* header + alignment slack */
+    cache->objs_per_slab = usable / cache->stride;
+
+    if (cache->objs_per_slab == 0) {
+        /* Object bigger than a slab: not a slab candidate */
+        kfree(cache);
+        return NULL;
+    }
+
+    cache->next = cache_list;
+    cache_list = cache;
+
+    return cache;
+}
+
+void* kmem_cache_alloc(kmem_cache_t* cache) {
+    if (cache == NULL) return NULL;
+
+    if (cache->free_head == NULL && !cache_grow(cache)) {
+        printk("slab: cache '%s' cannot grow\n", cache->name);
+        return NULL;
+    }
+
+    void* obj = cache->free_head;
+    cache->free_head = *(void**)obj;
+    cache->in_use++;
+
+    memset(obj, 0, cache->obj_size);
+    return obj;
+}
+
+void kmem_cache_free(kmem_cache_t* cache, void* obj) {
+    if (cache == NULL || obj == NULL) return;
+
+    if (cache->in_use == 0) {
+        kernel_panic("slab: free with no objects in use");
+        return;
+    }
+
+    *(void**)obj = cache->free_head;
+    cache->free_head = obj;
+    cache->in_use--;
+}
+
+void kmem_cache_print_stats(void) {
+    printk("Slab caches:\n");
+    for (kmem_cache_t* c = cache_list; c; c = c->next) {
+        printk("  %s: obj %u bytes, %u/%u in use\n",
+               c->name, c->obj_size, c->in_use, c->total_objs);
+    }
+}
+
+void slab_init(void) {
+    vfs_node_cache = kmem_cache_create("vfs_node", sizeof(vfs_node_t));
+    dirent_cache = kmem_cache_create("dirent", sizeof(dirent_t));
+
+    if (vfs_node_cache == NULL || dirent_cache == NULL) {
+        kernel_panic("slab: failed to create standard caches");
+        return;
+    }
+
+    printk("Slab: Standard caches created (vfs_node, dirent)\n");
+}
@@ -0,0 +1,286 @@
+/*
+ * MiniOS Swap Implementation
+ *
+ * Backs cold user pages with a dedicated Linux-swap (type 0x82)
+ * partition. One slot is one page (8 sectors); slots are tracked in a
+ * bitmap with a rotating allocation hint.
+ *
+ * Eviction is careful about the race with the owning process: the
+ * page is written to disk first while still mapped, and the PTE is
+ * only replaced (with interrupts off) if the entry is unchanged and
+ * its accessed bit is still clear - any touch during the disk write
+ * sets the bit and aborts the eviction. On this uniprocessor kernel
+ * the victim cannot run between that check and the PTE swap, and its
+ * TLB is rebuilt by the CR3 reload at the next context switch.
+ */
+
+#include "../include/swap.h"
+#include "../include/paging.h"
+#include "../include/pmm.h"
+#include "../include/blockdev.h"
+#include "../include/process.h"
+#include "../include/shm.h"
+#include "../include/heap.h"
+#include "../include/string.h"
+#include "../include/stdio.h"
+#include "../include/io.h"
+
+/* Sectors per page-sized slot */
+#define SWAP_SECTORS_PER_PAGE   (PAGE_SIZE / BLOCKDEV_SECTOR_SIZE)
+
+/* Slot cap: the PTE frame field holds the slot number, but 64MB of
+ * swap is already generous next to our 128MB units */
+#define SWAP_MAX_SLOTS          16384
+
+/* Free-frame watermarks: kswapd starts evicting below the low mark
+ * and the shrinker aims to climb back above the high mark */
+#define SWAP_LOW_FRAMES         256     /* 1MB */
+#define SWAP_HIGH_FRAMES        512     /* 2MB */
+
+/* PTEs examined per scan call, so one shrink pass stays bounded */
+#define SWAP_SCAN_BUDGET        4096
+
+static blockdev_t* swap_dev = NULL;
+static uint32_t swap_slots = 0;
+static uint8_t* swap_map = NULL;    /* One bit per slot, 1 = in use */
+static uint32_t swap_hint = 0;      /* Next slot to try */
+static swap_stats_t swap_stats;
+
+/* Per-process scan cursors, indexed by process table slot */
+static uint32_t scan_cursor[MAX_PROCESSES];
+
+/*
+ * Allocate one slot; SWAP_SLOT_INVALID when the partition is full
+ */
+static uint32_t swap_slot_alloc(void) {
+    uint32_t flags = irq_save();
+
+    for (uint32_t n = 0; n < swap_slots; n++) {
+        uint32_t slot = (swap_hint + n) % swap_slots;
+        if (!(swap_map[slot / 8] & (1 << (slot % 8)))) {
+            swap_map[slot / 8] |= (1 << (slot % 8));
+            swap_hint = slot + 1;
+            swap_stats.used_slots++;
+            irq_restore(flags);
+            return slot;
+        }
+    }
+
+    irq_restore(flags);
+    return SWAP_SLOT_INVALID;
+}
+
+void swap_slot_free(uint32_t slot) {
+    if (slot >= swap_slots) {
+        return;
+    }
+
+    uint32_t flags = irq_save();
+    if (swap_map[slot / 8] & (1 << (slot % 8))) {
+        swap_map[slot / 8] &= ~(1 << (slot % 8));
+        swap_stats.used_slots--;
+    }
+    irq_restore(flags);
+}
+
+/*
+ * Find a Linux-swap partition among the registered block devices
+ */
+void swap_init(void) {
+    for (uint8_t i = 0; i < blockdev_count(); i++) {
+        blockdev_t* dev = blockdev_get(i);
+        if (dev == NULL || dev->type != BLOCKDEV_TYPE_PARTITION ||
+            dev->parent == NULL) {
+            continue;
+        }
+
+        /* Match the partition back to its MBR entry for the type */
+        blockdev_t* disk = dev->parent;
+        for (int p = 0; p < disk->partition_count; p++) {
+            if (disk->partitions[p].start_lba == dev->start_lba &&
+                disk->partitions[p].type == PART_TYPE_LINUX_SWAP) {
+                swap_dev = dev;
+                break;
+            }
+        }
+        if (swap_dev != NULL) {
+            break;
+        }
+    }
+
+    if (swap_dev == NULL) {
+        printk("Swap: no swap partition found, overcommit disabled\n");
+        return;
+    }
+
+    swap_slots = swap_dev->sector_count / SWAP_SECTORS_PER_PAGE;
+    if (swap_slots > SWAP_MAX_SLOTS) {
+        swap_slots = SWAP_MAX_SLOTS;
+    }
+
+    swap_map = (uint8_t*)kmalloc((swap_slots + 7) / 8);
+    if (swap_map == NULL) {
+        printk("Swap: slot bitmap allocation failed, overcommit disabled\n");
+        swap_dev = NULL;
+        swap_slots = 0;
+        return;
+    }
+    memset(swap_map, 0, (swap_slots + 7) / 8);
+    memset(&swap_stats, 0, sizeof(swap_stats));
+    swap_stats.total_slots = swap_slots;
+
+    printk("Swap: using %s (%u slots, %u MB)\n",
+           swap_dev->name, swap_slots,
+           (swap_slots * PAGE_SIZE) / (1024 * 1024));
+}
+
+bool swap_available(void) {
+    return swap_dev != NULL;
+}
+
+/*
+ * Watermarks with hysteresis: reclaim starts when free frames drop
+ * below the low mark and keeps going until back above the high mark,
+ * so kswapd does batched work instead of oscillating at the edge.
+ */
+bool swap_pressure(void) {
+    static bool reclaiming = false;
+
+    pmm_stats_t stats;
+    pmm_get_stats(&stats);
+
+    if (reclaiming) {
+        if (stats.free_frames >= SWAP_HIGH_FRAMES) {
+            reclaiming = false;
+        }
+    } else if (stats.free_frames < SWAP_LOW_FRAMES) {
+        reclaiming = true;
+    }
+    return reclaiming;
+}
+
+/*
+ * Try to evict one page of a process. Returns true if the page went
+ * to swap and its frame was freed.
+ */
+static bool swap_out_page(page_directory_t* dir, uint32_t vaddr) {
+    uint32_t pte = paging_get_entry(dir, vaddr);
+    if (!(pte & PAGE_PRESENT) || !(pte & PAGE_USER)) {
+        return false;
+    }
+
+    /* Frames shared between address spaces (COW, shm) would need the
+     * swap entry reflected in every holder - skip them */
+    uint32_t frame = PAGE_FRAME(pte);
+    if ((pte & PAGE_COW) || pmm_frame_refcount(frame) != 1) {
+        return false;
+    }
+
+    uint32_t slot = swap_slot_alloc();
+    if (slot == SWAP_SLOT_INVALID) {
+        return false;
+    }
+
+    /* Write the page out while it is still mapped */
+    if (!blockdev_write(swap_dev, slot * SWAP_SECTORS_PER_PAGE,
+                        SWAP_SECTORS_PER_PAGE, (void*)frame)) {
+        swap_slot_free(slot);
+        return false;
+    }
+
+    /* Commit: the entry must be untouched since the scan picked it.
+     * A touch during the disk write sets the accessed bit. */
+    uint32_t flags = irq_save();
+    if (paging_get_entry(dir, vaddr) != pte || (pte & PAGE_ACCESSED)) {
+        irq_restore(flags);
+        swap_slot_free(slot);
+        return false;
+    }
+    paging_set_entry(dir, vaddr,
+                     (slot << PAGE_SHIFT) | PAGE_SWAPPED |
+                     (pte & (PAGE_WRITE | PAGE_USER)));
+    irq_restore(flags);
+
+    pmm_free_frame(frame);
+    swap_stats.pages_out++;
+    return true;
+}
+
+/*
+ * Evict up to max_pages cold user pages, round-robin over processes
+ */
+uint32_t swap_shrink(uint32_t max_pages) {
+    if (swap_dev == NULL) {
+        return 0;
+    }
+
+    uint32_t evicted = 0;
+
+    for (int i = 0; i < MAX_PROCESSES && evicted < max_pages; i++) {
+        process_t* proc = &process_table[i];
+        if (proc->state == PROCESS_STATE_UNUSED ||
+            proc->state == PROCESS_STATE_ZOMBIE ||
+            !proc->is_user_mode || proc->page_directory == 0) {
+            continue;
+        }
+
+        page_directory_t* dir = (page_directory_t*)proc->page_directory;
+        uint32_t budget = SWAP_SCAN_BUDGET;
+
+        while (evicted < max_pages && budget > 0) {
+            uint32_t vaddr = paging_scan_cold(dir, &scan_cursor[i], &budget);
+            if (vaddr == 0) {
+                break;  /* Budget spent without a cold page */
+            }
+
+            /* The mmap window and shm attachments have their own
+             * backing; only anonymous memory goes to swap */
+            if (vaddr >= USER_MMAP_BASE && vaddr < SHM_VADDR_END) {
+                continue;
+            }
+
+            if (swap_out_page(dir, vaddr)) {
+                evicted++;
+            }
+        }
+    }
+
+    return evicted;
+}
+
+/*
+ * Fault a page back in from swap (current address space)
+ */
+bool swap_handle_fault(uint32_t fault_addr) {
+    if (swap_dev == NULL) {
+        return false;
+    }
+
+    page_directory_t* dir = paging_get_directory();
+    uint32_t page = PAGE_ALIGN_DOWN(fault_addr);
+    uint32_t pte = paging_get_entry(dir, page);
+    if ((pte & PAGE_PRESENT) || !(pte & PAGE_SWAPPED)) {
+        return false;
+    }
+
+    uint32_t slot = pte >> PAGE_SHIFT;
+    uint32_t frame = pmm_alloc_frame();
+    if (frame == 0) {
+        return false;  /* Out of memory - let the process die */
+    }
+
+    if (!blockdev_read(swap_dev, slot * SWAP_SECTORS_PER_PAGE,
+                       SWAP_SECTORS_PER_PAGE, (void*)frame)) {
+        pmm_free_frame(frame);
+        return false;
+    }
+
+    paging_map_page(page, frame, pte & (PAGE_WRITE | PAGE_USER));
+    swap_slot_free(slot);
+    swap_stats.pages_in++;
+    return true;
+}
+
+void swap_get_stats(swap_stats_t* stats) {
+    *stats = swap_stats;
+}
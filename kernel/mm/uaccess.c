@@ -43,15 +43,10 @@ bool access_ok(const void* addr, size_t size, bool write) {
         return false;
     }
     
-    /* Verify each page is mapped with correct permissions */
-    for (uint32_t page = PAGE_ALIGN_DOWN(start); page < end; page += PAGE_SIZE) {
-        if (!paging_is_mapped(page)) {
-            return false;
-        }
-        /* TODO: Check write permission if write is requested */
-    }
-    
-    return true;
+    /* Verify the whole span is mapped in a single page-table walk
+     * (one directory lookup per 4MB window, one entry test per page) */
+    return paging_is_range_mapped(start, size);
+    /* TODO: Check write permission when page tables support it */
 }
 
 /*
@@ -87,20 +82,27 @@ int copyinstr(char* dst, const char* src, size_t max_len) {
     }
     
     size_t len = 0;
-    
+
     while (len < max_len - 1) {
-        uint8_t c;
-        if (get_user_byte(src + len, &c) < 0) {
+        /* Validate once per page, then scan its bytes directly instead
+         * of paying a full pointer check per character */
+        uint32_t addr = (uint32_t)(src + len);
+        size_t chunk = PAGE_SIZE - (addr & (PAGE_SIZE - 1));
+        if (chunk > max_len - 1 - len) {
+            chunk = max_len - 1 - len;
+        }
+        if (!access_ok((const void*)addr, chunk, false)) {
             return -EFAULT;
         }
-        
-        dst[len] = (char)c;
-        
-        if (c == '\0') {
-            return (int)len;
+
+        const char* p = (const char*)addr;
+        for (size_t i = 0; i < chunk; i++) {
+            dst[len] = p[i];
+            if (p[i] == '\0') {
+                return (int)len;
+            }
+            len++;
         }
-        
-        len++;
     }
     
     /* String was too long, null-terminate and return */
@@ -0,0 +1,450 @@
+/*
+ * MiniOS Network Stack Core
+ *
+ * Ethernet framing, ARP, IPv4, ICMP echo and UDP on top of a single
+ * registered NIC. RX runs in the NIC's IRQ handler: frames are parsed
+ * in place and UDP payloads handed to the socket layer as the same
+ * pbuf the driver filled, with data advanced past the headers. TX
+ * prepends headers into the pbuf headroom, so the only copy on the
+ * transmit path is the user-to-kernel one in sendto().
+ */
+
+#include "../include/net.h"
+#include "../include/socket.h"
+#include "../include/spinlock.h"
+#include "../include/string.h"
+#include "../include/stdio.h"
+
+/* Static address configuration (QEMU slirp defaults, host order) */
+static uint32_t local_ip = IP_ADDR(10, 0, 2, 15);
+static uint32_t netmask  = IP_ADDR(255, 255, 255, 0);
+static uint32_t gateway  = IP_ADDR(10, 0, 2, 2);
+
+static netdev_t* netdev = NULL;
+
+static const uint8_t eth_broadcast[ETH_ALEN] =
+    { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+
+/* IP identification counter for outgoing datagrams */
+static uint16_t ip_next_id = 1;
+
+/* ============================================
+ * ARP cache
+ * ============================================ */
+
+#define ARP_CACHE_SIZE  8
+
+#define ARP_OP_REQUEST  1
+#define ARP_OP_REPLY    2
+
+typedef struct {
+    uint16_t hw_type;           /* 1 = ethernet */
+    uint16_t proto_type;        /* 0x0800 = IPv4 */
+    uint8_t  hw_len;            /* 6 */
+    uint8_t  proto_len;         /* 4 */
+    uint16_t opcode;
+    uint8_t  sender_mac[ETH_ALEN];
+    uint32_t sender_ip;         /* Network order, unaligned is fine on x86 */
+    uint8_t  target_mac[ETH_ALEN];
+    uint32_t target_ip;
+} __attribute__((packed)) arp_packet_t;
+
+/*
+ * One cache entry per next-hop IP. While unresolved, a single pbuf
+ * may be parked here; it is transmitted (or replaced by a newer one)
+ * when the reply arrives, Linux-style.
+ */
+typedef struct {
+    uint32_t ip;                /* Host order, 0 = free */
+    uint8_t mac[ETH_ALEN];
+    bool resolved;
+    pbuf_t* pending;            /* Frame waiting on resolution */
+} arp_entry_t;
+
+static arp_entry_t arp_cache[ARP_CACHE_SIZE];
+static uint32_t arp_evict_next = 0;
+
+/* Forward declarations */
+static void eth_transmit(pbuf_t* p, const uint8_t* dst_mac, uint16_t type);
+static void arp_send_request(uint32_t ip);
+
+/*
+ * Find or allocate the cache entry for an IP (host order). Allocation
+ * evicts round-robin; a parked frame on the victim is dropped.
+ * Caller holds interrupts disabled.
+ */
+static arp_entry_t* arp_lookup(uint32_t ip) {
+    for (int i = 0; i < ARP_CACHE_SIZE; i++) {
+        if (arp_cache[i].ip == ip) {
+            return &arp_cache[i];
+        }
+    }
+    for (int i = 0; i < ARP_CACHE_SIZE; i++) {
+        if (arp_cache[i].ip == 0) {
+            arp_cache[i].ip = ip;
+            return &arp_cache[i];
+        }
+    }
+
+    arp_entry_t* e = &arp_cache[arp_evict_next];
+    arp_evict_next = (arp_evict_next + 1) % ARP_CACHE_SIZE;
+    if (e->pending != NULL) {
+        pbuf_free(e->pending);
+        e->pending = NULL;
+    }
+    e->ip = ip;
+    e->resolved = false;
+    return e;
+}
+
+/*
+ * Handle a received ARP packet: answer requests for our address and
+ * fill the cache from replies (and from requests, which carry the
+ * sender's mapping for free).
+ */
+static void arp_rx(pbuf_t* p) {
+    if (p->len < sizeof(arp_packet_t)) {
+        pbuf_free(p);
+        return;
+    }
+
+    arp_packet_t* arp = (arp_packet_t*)p->data;
+    if (ntohs(arp->hw_type) != 1 || ntohs(arp->proto_type) != ETH_TYPE_IP) {
+        pbuf_free(p);
+        return;
+    }
+
+    uint32_t sender_ip = ntohl(arp->sender_ip);
+    uint16_t op = ntohs(arp->opcode);
+
+    /* Learn the sender's mapping and flush any parked frame */
+    if (sender_ip != 0) {
+        arp_entry_t* e = arp_lookup(sender_ip);
+        memcpy(e->mac, arp->sender_mac, ETH_ALEN);
+        e->resolved = true;
+        if (e->pending != NULL) {
+            pbuf_t* queued = e->pending;
+            e->pending = NULL;
+            eth_transmit(queued, e->mac, ETH_TYPE_IP);
+        }
+    }
+
+    if (op == ARP_OP_REQUEST && ntohl(arp->target_ip) == local_ip) {
+        /* Rewrite the request into a reply in place */
+        arp->opcode = htons(ARP_OP_REPLY);
+        memcpy(arp->target_mac, arp->sender_mac, ETH_ALEN);
+        arp->target_ip = arp->sender_ip;
+        memcpy(arp->sender_mac, netdev->mac, ETH_ALEN);
+        arp->sender_ip = htonl(local_ip);
+        eth_transmit(p, arp->target_mac, ETH_TYPE_ARP);
+        return;
+    }
+
+    pbuf_free(p);
+}
+
+/* Broadcast a who-has request for an IP (host order) */
+static void arp_send_request(uint32_t ip) {
+    pbuf_t* p = pbuf_alloc(sizeof(arp_packet_t));
+    if (p == NULL) {
+        return;
+    }
+
+    arp_packet_t* arp = (arp_packet_t*)p->data;
+    arp->hw_type = htons(1);
+    arp->proto_type = htons(ETH_TYPE_IP);
+    arp->hw_len = ETH_ALEN;
+    arp->proto_len = 4;
+    arp->opcode = htons(ARP_OP_REQUEST);
+    memcpy(arp->sender_mac, netdev->mac, ETH_ALEN);
+    arp->sender_ip = htonl(local_ip);
+    memset(arp->target_mac, 0, ETH_ALEN);
+    arp->target_ip = htonl(ip);
+
+    eth_transmit(p, eth_broadcast, ETH_TYPE_ARP);
+}
+
+/* ============================================
+ * Ethernet
+ * ============================================ */
+
+/*
+ * Prepend an ethernet header and hand the frame to the driver.
+ * Consumes the pbuf reference (the driver takes it).
+ */
+static void eth_transmit(pbuf_t* p, const uint8_t* dst_mac, uint16_t type) {
+    eth_header_t* eth = (eth_header_t*)pbuf_push(p, ETH_HDR_LEN);
+    if (eth == NULL) {
+        pbuf_free(p);
+        return;
+    }
+
+    memcpy(eth->dst, dst_mac, ETH_ALEN);
+    memcpy(eth->src, netdev->mac, ETH_ALEN);
+    eth->type = htons(type);
+
+    if (!netdev->transmit(netdev, p)) {
+        pbuf_free(p);
+    }
+}
+
+/* ============================================
+ * IPv4
+ * ============================================ */
+
+/* Standard internet checksum over a header (len must be even) */
+static uint16_t ip_checksum(const void* data, uint32_t len) {
+    const uint16_t* words = (const uint16_t*)data;
+    uint32_t sum = 0;
+
+    for (uint32_t i = 0; i < len / 2; i++) {
+        sum += words[i];
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return (uint16_t)~sum;
+}
+
+/*
+ * Prepend an IP header and route the datagram: on-link destinations
+ * resolve directly, everything else goes via the gateway. If the next
+ * hop is not in the ARP cache the frame is parked on the entry and a
+ * request goes out. Consumes the pbuf reference.
+ */
+static void ip_transmit(pbuf_t* p, uint32_t dst_ip, uint8_t protocol) {
+    ip_header_t* ip = (ip_header_t*)pbuf_push(p, IP_HDR_LEN);
+    if (ip == NULL) {
+        pbuf_free(p);
+        return;
+    }
+
+    ip->ver_ihl = 0x45;
+    ip->tos = 0;
+    ip->total_len = htons((uint16_t)p->len);
+    ip->id = htons(ip_next_id++);
+    ip->frag_off = 0;
+    ip->ttl = 64;
+    ip->protocol = protocol;
+    ip->checksum = 0;
+    ip->src = htonl(local_ip);
+    ip->dst = htonl(dst_ip);
+    ip->checksum = ip_checksum(ip, IP_HDR_LEN);
+
+    /* Broadcast needs no resolution */
+    if (dst_ip == IP_ADDR(255, 255, 255, 255) ||
+        dst_ip == (local_ip | ~netmask)) {
+        eth_transmit(p, eth_broadcast, ETH_TYPE_IP);
+        return;
+    }
+
+    uint32_t next_hop =
+        ((dst_ip & netmask) == (local_ip & netmask)) ? dst_ip : gateway;
+
+    uint32_t flags = irq_save();
+    arp_entry_t* e = arp_lookup(next_hop);
+    if (e->resolved) {
+        uint8_t mac[ETH_ALEN];
+        memcpy(mac, e->mac, ETH_ALEN);
+        irq_restore(flags);
+        eth_transmit(p, mac, ETH_TYPE_IP);
+        return;
+    }
+
+    /* Park the frame (newest wins) and ask for the mapping */
+    if (e->pending != NULL) {
+        pbuf_free(e->pending);
+    }
+    /* Header is already built; when the reply lands eth_transmit just
+     * needs the IP frame, so strip nothing and remember it as-is */
+    e->pending = p;
+    irq_restore(flags);
+
+    arp_send_request(next_hop);
+}
+
+/* ICMP echo: type 8 request, type 0 reply */
+typedef struct __attribute__((packed)) {
+    uint8_t  type;
+    uint8_t  code;
+    uint16_t checksum;
+    uint16_t id;
+    uint16_t seq;
+} icmp_header_t;
+
+/*
+ * Answer echo requests in place: flip the type, fix the checksum and
+ * send the same pbuf back. Consumes the reference; p->data points at
+ * the ICMP header.
+ */
+static void icmp_rx(pbuf_t* p, uint32_t src_ip) {
+    if (p->len < sizeof(icmp_header_t)) {
+        pbuf_free(p);
+        return;
+    }
+
+    icmp_header_t* icmp = (icmp_header_t*)p->data;
+    if (icmp->type != 8 || icmp->code != 0) {
+        pbuf_free(p);
+        return;
+    }
+
+    icmp->type = 0;
+    icmp->checksum = 0;
+    /* Odd-length echo payloads are rare; pad byte is already zero in
+     * the buffer when QEMU sends them, so sum the even prefix */
+    icmp->checksum = ip_checksum(icmp, p->len & ~1u);
+
+    ip_transmit(p, src_ip, IP_PROTO_ICMP);
+}
+
+/* Parse an IP datagram; p->data points at the IP header */
+static void ip_rx(pbuf_t* p) {
+    if (p->len < IP_HDR_LEN) {
+        pbuf_free(p);
+        return;
+    }
+
+    ip_header_t* ip = (ip_header_t*)p->data;
+    uint32_t hdr_len = (ip->ver_ihl & 0x0F) * 4;
+    if ((ip->ver_ihl >> 4) != 4 || hdr_len < IP_HDR_LEN ||
+        p->len < ntohs(ip->total_len) || hdr_len > ntohs(ip->total_len)) {
+        pbuf_free(p);
+        return;
+    }
+
+    /* No reassembly: drop fragments (DF is set on everything we send) */
+    if (ntohs(ip->frag_off) & 0x3FFF) {
+        pbuf_free(p);
+        return;
+    }
+
+    uint32_t dst = ntohl(ip->dst);
+    if (dst != local_ip && dst != IP_ADDR(255, 255, 255, 255) &&
+        dst != (local_ip | ~netmask)) {
+        pbuf_free(p);
+        return;
+    }
+
+    uint32_t src_ip = ntohl(ip->src);
+    uint8_t protocol = ip->protocol;
+
+    /* Trim link-layer padding, then strip the IP header */
+    p->len = ntohs(ip->total_len);
+    pbuf_pull(p, hdr_len);
+
+    if (protocol == IP_PROTO_ICMP) {
+        icmp_rx(p, src_ip);
+        return;
+    }
+
+    if (protocol == IP_PROTO_UDP) {
+        if (p->len < UDP_HDR_LEN) {
+            pbuf_free(p);
+            return;
+        }
+        udp_header_t* udp = (udp_header_t*)p->data;
+        uint16_t src_port = ntohs(udp->src_port);
+        uint16_t dst_port = ntohs(udp->dst_port);
+        uint16_t udp_len = ntohs(udp->length);
+        if (udp_len < UDP_HDR_LEN || udp_len > p->len) {
+            pbuf_free(p);
+            return;
+        }
+        p->len = udp_len;
+        pbuf_pull(p, UDP_HDR_LEN);
+        /* The socket layer consumes the reference */
+        socket_udp_input(src_ip, src_port, dst_port, p);
+        return;
+    }
+
+    pbuf_free(p);
+}
+
+/* ============================================
+ * Public interface
+ * ============================================ */
+
+void net_rx(netdev_t* dev, pbuf_t* p) {
+    (void)dev;
+
+    if (p->len < ETH_HDR_LEN) {
+        pbuf_free(p);
+        return;
+    }
+
+    eth_header_t* eth = (eth_header_t*)p->data;
+    uint16_t type = ntohs(eth->type);
+    pbuf_pull(p, ETH_HDR_LEN);
+
+    if (type == ETH_TYPE_ARP) {
+        arp_rx(p);
+    } else if (type == ETH_TYPE_IP) {
+        ip_rx(p);
+    } else {
+        pbuf_free(p);
+    }
+}
+
+int net_udp_send(uint32_t dst_ip, uint16_t src_port, uint16_t dst_port,
+                 pbuf_t* p) {
+    if (netdev == NULL) {
+        pbuf_free(p);
+        return -1;
+    }
+
+    udp_header_t* udp = (udp_header_t*)pbuf_push(p, UDP_HDR_LEN);
+    if (udp == NULL) {
+        pbuf_free(p);
+        return -1;
+    }
+
+    udp->src_port = htons(src_port);
+    udp->dst_port = htons(dst_port);
+    udp->length = htons((uint16_t)p->len);
+    udp->checksum = 0;      /* Optional for UDP over IPv4 */
+
+    ip_transmit(p, dst_ip, IP_PROTO_UDP);
+    return 0;
+}
+
+int netdev_register(netdev_t* dev) {
+    if (netdev != NULL) {
+        return -1;
+    }
+    netdev = dev;
+    printk("Net: %s registered, MAC %02X:%02X:%02X:%02X:%02X:%02X\n",
+           dev->name, dev->mac[0], dev->mac[1], dev->mac[2],
+           dev->mac[3], dev->mac[4], dev->mac[5]);
+    return 0;
+}
+
+netdev_t* netdev_get(void) {
+    return netdev;
+}
+
+uint32_t net_local_ip(void) {
+    return local_ip;
+}
+
+void net_init(void) {
+    memset(arp_cache, 0, sizeof(arp_cache));
+    socket_init();
+
+    /* Probe for supported NICs; the driver registers itself */
+    extern void rtl8139_init(void);
+    rtl8139_init();
+
+    if (netdev == NULL) {
+        printk("Net: no supported NIC found\n");
+        return;
+    }
+
+    printk("Net: ip %u.%u.%u.%u mask %u.%u.%u.%u gw %u.%u.%u.%u\n",
+           (local_ip >> 24) & 0xFF, (local_ip >> 16) & 0xFF,
+           (local_ip >> 8) & 0xFF, local_ip & 0xFF,
+           (netmask >> 24) & 0xFF, (netmask >> 16) & 0xFF,
+           (netmask >> 8) & 0xFF, netmask & 0xFF,
+           (gateway >> 24) & 0xFF, (gateway >> 16) & 0xFF,
+           (gateway >> 8) & 0xFF, gateway & 0xFF);
+}
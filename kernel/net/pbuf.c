@@ -0,0 +1,59 @@
+/*
+ * MiniOS Packet Buffer Implementation
+ *
+ * See pbuf.h for the model. Allocation is a single kmalloc per
+ * packet; everything after that is pointer arithmetic.
+ */
+
+#include "../include/pbuf.h"
+#include "../include/heap.h"
+#include "../include/string.h"
+
+pbuf_t* pbuf_alloc(uint32_t len) {
+    if (len > PBUF_MAX_DATA) {
+        return NULL;
+    }
+
+    pbuf_t* p = (pbuf_t*)kmalloc(sizeof(pbuf_t));
+    if (p == NULL) {
+        return NULL;
+    }
+
+    p->data = p->buf + PBUF_HEADROOM;
+    p->len = len;
+    p->refcount = 1;
+    return p;
+}
+
+void pbuf_ref(pbuf_t* p) {
+    if (p != NULL) {
+        p->refcount++;
+    }
+}
+
+void pbuf_free(pbuf_t* p) {
+    if (p == NULL) {
+        return;
+    }
+    if (--p->refcount == 0) {
+        kfree(p);
+    }
+}
+
+uint8_t* pbuf_push(pbuf_t* p, uint32_t n) {
+    if (p->data - p->buf < (int)n) {
+        return NULL;
+    }
+    p->data -= n;
+    p->len += n;
+    return p->data;
+}
+
+uint8_t* pbuf_pull(pbuf_t* p, uint32_t n) {
+    if (p->len < n) {
+        return NULL;
+    }
+    p->data += n;
+    p->len -= n;
+    return p->data;
+}
@@ -0,0 +1,199 @@
+/*
+ * MiniOS Socket Layer Implementation
+ *
+ * See socket.h. The table is tiny and fixed like the other kernel
+ * object tables; the rx queues are protected by brief cli sections
+ * because the producer (socket_udp_input) runs in NIC IRQ context.
+ */
+
+#include "../include/socket.h"
+#include "../include/net.h"
+#include "../include/spinlock.h"
+#include "../include/string.h"
+#include "../include/heap.h"
+
+static udp_socket_t sockets[SOCK_MAX];
+
+/* Next ephemeral port to try, wrapping within the dynamic range */
+static uint16_t ephemeral_next = SOCK_EPHEMERAL_BASE;
+
+void socket_init(void) {
+    memset(sockets, 0, sizeof(sockets));
+    for (int i = 0; i < SOCK_MAX; i++) {
+        wait_queue_init(&sockets[i].rx_wait);
+    }
+}
+
+udp_socket_t* socket_create(void) {
+    uint32_t flags = irq_save();
+    for (int i = 0; i < SOCK_MAX; i++) {
+        if (!sockets[i].in_use) {
+            udp_socket_t* sock = &sockets[i];
+            sock->in_use = true;
+            sock->local_port = 0;
+            sock->rxq_head = 0;
+            sock->rxq_count = 0;
+            irq_restore(flags);
+            return sock;
+        }
+    }
+    irq_restore(flags);
+    return NULL;
+}
+
+void socket_close(udp_socket_t* sock) {
+    if (sock == NULL || !sock->in_use) {
+        return;
+    }
+
+    uint32_t flags = irq_save();
+    while (sock->rxq_count > 0) {
+        pbuf_free(sock->rxq[sock->rxq_head]);
+        sock->rxq_head = (sock->rxq_head + 1) % SOCK_RXQ_MAX;
+        sock->rxq_count--;
+    }
+    sock->local_port = 0;
+    sock->in_use = false;
+    irq_restore(flags);
+
+    /* Anyone still blocked in recvfrom sees the socket go away */
+    wake_up(&sock->rx_wait);
+}
+
+/* True if some socket already owns the port. Caller disables IRQs. */
+static bool port_in_use(uint16_t port) {
+    for (int i = 0; i < SOCK_MAX; i++) {
+        if (sockets[i].in_use && sockets[i].local_port == port) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int socket_bind(udp_socket_t* sock, uint16_t port) {
+    if (sock == NULL || !sock->in_use || port == 0) {
+        return -1;
+    }
+
+    uint32_t flags = irq_save();
+    if (port_in_use(port)) {
+        irq_restore(flags);
+        return -1;
+    }
+    sock->local_port = port;
+    irq_restore(flags);
+    return 0;
+}
+
+/* Pick a free port from the dynamic range. Caller disables IRQs. */
+static uint16_t ephemeral_alloc(void) {
+    for (int tries = 0; tries < SOCK_MAX + 1; tries++) {
+        uint16_t port = ephemeral_next;
+        ephemeral_next = (ephemeral_next == 0xFFFF)
+                             ? SOCK_EPHEMERAL_BASE : ephemeral_next + 1;
+        if (!port_in_use(port)) {
+            return port;
+        }
+    }
+    return 0;
+}
+
+int socket_sendto(udp_socket_t* sock, const void* buf, uint32_t len,
+                  uint32_t dst_ip, uint16_t dst_port) {
+    if (sock == NULL || !sock->in_use || buf == NULL ||
+        len > UDP_MAX_PAYLOAD || dst_port == 0) {
+        return -1;
+    }
+
+    if (sock->local_port == 0) {
+        uint32_t flags = irq_save();
+        sock->local_port = ephemeral_alloc();
+        irq_restore(flags);
+        if (sock->local_port == 0) {
+            return -1;
+        }
+    }
+
+    pbuf_t* p = pbuf_alloc(len);
+    if (p == NULL) {
+        return -1;
+    }
+
+    /* The single TX copy: user data into the packet buffer. From here
+     * the same pbuf travels through UDP/IP/ethernet to the NIC. */
+    memcpy(p->data, buf, len);
+
+    if (net_udp_send(dst_ip, sock->local_port, dst_port, p) < 0) {
+        return -1;
+    }
+    return (int)len;
+}
+
+int socket_recvfrom(udp_socket_t* sock, void* buf, uint32_t len,
+                    uint32_t* src_ip, uint16_t* src_port) {
+    if (sock == NULL || !sock->in_use || buf == NULL) {
+        return -1;
+    }
+
+    /* Block until a datagram is queued (or the socket is torn down) */
+    uint32_t flags = irq_save();
+    while (sock->rxq_count == 0) {
+        irq_restore(flags);
+        sleep_on(&sock->rx_wait);
+        if (!sock->in_use) {
+            return -1;
+        }
+        flags = irq_save();
+    }
+
+    uint32_t slot = sock->rxq_head;
+    pbuf_t* p = sock->rxq[slot];
+    uint32_t from_ip = sock->rx_src_ip[slot];
+    uint16_t from_port = sock->rx_src_port[slot];
+    sock->rxq_head = (slot + 1) % SOCK_RXQ_MAX;
+    sock->rxq_count--;
+    irq_restore(flags);
+
+    /* The single RX copy: packet buffer into user data */
+    uint32_t n = (p->len < len) ? p->len : len;
+    memcpy(buf, p->data, n);
+    pbuf_free(p);
+
+    if (src_ip != NULL) {
+        *src_ip = from_ip;
+    }
+    if (src_port != NULL) {
+        *src_port = from_port;
+    }
+    return (int)n;
+}
+
+void socket_udp_input(uint32_t src_ip, uint16_t src_port,
+                      uint16_t dst_port, pbuf_t* p) {
+    /* Runs with interrupts off (NIC IRQ), so the queue is safe */
+    for (int i = 0; i < SOCK_MAX; i++) {
+        udp_socket_t* sock = &sockets[i];
+        if (!sock->in_use || sock->local_port != dst_port) {
+            continue;
+        }
+
+        if (sock->rxq_count == SOCK_RXQ_MAX) {
+            /* Queue full: drop the oldest so fresh data wins */
+            pbuf_free(sock->rxq[sock->rxq_head]);
+            sock->rxq_head = (sock->rxq_head + 1) % SOCK_RXQ_MAX;
+            sock->rxq_count--;
+        }
+
+        uint32_t slot = (sock->rxq_head + sock->rxq_count) % SOCK_RXQ_MAX;
+        sock->rxq[slot] = p;
+        sock->rx_src_ip[slot] = src_ip;
+        sock->rx_src_port[slot] = src_port;
+        sock->rxq_count++;
+
+        wake_up(&sock->rx_wait);
+        return;
+    }
+
+    /* No listener on this port */
+    pbuf_free(p);
+}
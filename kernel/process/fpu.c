@@ -0,0 +1,152 @@
+/*
+ * MiniOS Lazy FPU/SSE Context Switching Implementation
+ *
+ * One process at a time "owns" the hardware FPU registers. Context
+ * switches never touch FPU state; they only set CR0.TS when the
+ * incoming process is not the owner. The first FPU instruction then
+ * raises #NM, and the handler swaps the 512-byte FXSAVE images. On
+ * CPUs without FXSR the x87-only FNSAVE/FRSTOR pair is used instead
+ * (it fits in the same buffer).
+ */
+
+#include "../include/fpu.h"
+#include "../include/process.h"
+#include "../include/isr.h"
+#include "../include/stdio.h"
+#include "../include/string.h"
+
+/* Process whose state is live in the FPU registers (NULL = none) */
+static process_t* fpu_owner = NULL;
+
+static bool fpu_fxsr = false;   /* FXSAVE/FXRSTOR available */
+static bool fpu_sse = false;    /* SSE present (enables CR4.OSFXSR) */
+
+/* CR0.TS: set = next FPU instruction raises #NM */
+#define CR0_TS  0x00000008
+
+static inline void fpu_set_ts(void) {
+    uint32_t cr0;
+    __asm__ volatile("mov %%cr0, %0" : "=r"(cr0));
+    __asm__ volatile("mov %0, %%cr0" :: "r"(cr0 | CR0_TS));
+}
+
+static inline void fpu_clear_ts(void) {
+    __asm__ volatile("clts");
+}
+
+static void fpu_save(process_t* proc) {
+    if (fpu_fxsr) {
+        __asm__ volatile("fxsave (%0)" :: "r"(proc->fpu_state) : "memory");
+    } else {
+        __asm__ volatile("fnsave (%0)" :: "r"(proc->fpu_state) : "memory");
+    }
+}
+
+static void fpu_restore(process_t* proc) {
+    if (fpu_fxsr) {
+        __asm__ volatile("fxrstor (%0)" :: "r"(proc->fpu_state));
+    } else {
+        __asm__ volatile("frstor (%0)" :: "r"(proc->fpu_state));
+    }
+}
+
+/* Put the FPU into a clean state for a first-time user */
+static void fpu_fresh(void) {
+    __asm__ volatile("fninit");
+    if (fpu_sse) {
+        static const uint32_t mxcsr_default = 0x1F80;
+        __asm__ volatile("ldmxcsr %0" :: "m"(mxcsr_default));
+    }
+}
+
+/*
+ * #NM handler: the running process touched the FPU while TS was set.
+ * Swap ownership here - this is the only place state moves.
+ */
+static void fpu_dna_handler(registers_t* regs) {
+    (void)regs;
+
+    /* FPU access is legal from here on */
+    fpu_clear_ts();
+
+    process_t* cur = process_current();
+    if (cur == NULL || cur == fpu_owner) {
+        /* Early boot, or a spurious trap for the current owner */
+        return;
+    }
+
+    if (fpu_owner != NULL) {
+        fpu_save(fpu_owner);
+    }
+
+    if (cur->fpu_used) {
+        fpu_restore(cur);
+    } else {
+        fpu_fresh();
+        cur->fpu_used = 1;
+    }
+
+    fpu_owner = cur;
+}
+
+void fpu_on_switch(process_t* next) {
+    if (next == fpu_owner) {
+        fpu_clear_ts();
+    } else {
+        fpu_set_ts();
+    }
+}
+
+void fpu_release(process_t* proc) {
+    if (fpu_owner == proc) {
+        fpu_owner = NULL;
+    }
+}
+
+void fpu_fork(process_t* parent, process_t* child) {
+    if (parent == fpu_owner) {
+        /* Live registers beat the memory image; flush them first */
+        fpu_clear_ts();
+        fpu_save(parent);
+        fpu_set_ts();
+    }
+    if (parent->fpu_used) {
+        memcpy(child->fpu_state, parent->fpu_state,
+               sizeof(child->fpu_state));
+    }
+    child->fpu_used = parent->fpu_used;
+}
+
+void fpu_init(void) {
+    /* CPUID leaf 1: EDX bit 24 = FXSR, bit 25 = SSE */
+    uint32_t eax, edx;
+    __asm__ volatile(
+        "cpuid"
+        : "=a"(eax), "=d"(edx)
+        : "a"(1)
+        : "ebx", "ecx"
+    );
+    fpu_fxsr = (edx >> 24) & 1;
+    fpu_sse = ((edx >> 25) & 1) && fpu_fxsr;
+
+    if (fpu_fxsr) {
+        /* CR4.OSFXSR (bit 9) enables FXSAVE/SSE; OSXMMEXCPT (bit 10)
+         * routes SSE faults to #XM instead of #UD */
+        uint32_t cr4;
+        __asm__ volatile("mov %%cr4, %0" : "=r"(cr4));
+        cr4 |= (1 << 9);
+        if (fpu_sse) {
+            cr4 |= (1 << 10);
+        }
+        __asm__ volatile("mov %0, %%cr4" :: "r"(cr4));
+    }
+
+    isr_register_handler(7, fpu_dna_handler);
+
+    /* Arm the trap: whoever uses the FPU first becomes the owner */
+    fpu_set_ts();
+
+    printk("FPU: lazy switching enabled (%s%s)\n",
+           fpu_fxsr ? "fxsave" : "fnsave",
+           fpu_sse ? ", sse" : "");
+}
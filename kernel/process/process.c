@@ -12,38 +12,129 @@
 #include "../include/pmm.h"
 #include "../include/elf.h"
 #include "../include/signal.h"
+#include "../include/timer.h"
+#include "../include/fpu.h"
+#include "../include/pipe.h"
+#include "../include/scheduler.h"
 
 /* Process table */
 process_t process_table[MAX_PROCESSES];
 process_t* current_process = NULL;
-process_t* ready_queue = NULL;
+
+/* Per-priority ready queues: bit N of ready_bitmap set = level N non-empty */
+process_t* ready_queues[PROCESS_NUM_PRIORITIES];
+uint32_t ready_bitmap = 0;
+static process_t* ready_tails[PROCESS_NUM_PRIORITIES];
+
+/* Clamp a priority value to a valid queue level */
+static inline uint32_t ready_level(uint32_t priority) {
+    return (priority >= PROCESS_NUM_PRIORITIES) ? PROCESS_NUM_PRIORITIES - 1 : priority;
+}
 
 /* Next available PID */
 static uint32_t next_pid = 0;
 
+/* Free-slot bitmap: bit N of word N/32 set = process_table[N] free */
+#define SLOT_BITMAP_WORDS ((MAX_PROCESSES + 31) / 32)
+static uint32_t slot_bitmap[SLOT_BITMAP_WORDS];
+
 /*
- * Allocate a free process slot
+ * PID -> slot hash for O(1) process_get. Buckets chain through
+ * pid_hash_next[], indexed by table slot; -1 terminates a chain.
  */
-static process_t* alloc_process_slot(void) {
-    for (int i = 0; i < MAX_PROCESSES; i++) {
-        if (process_table[i].state == PROCESS_STATE_UNUSED) {
-            return &process_table[i];
+#define PID_HASH_SIZE 128
+#define PID_HASH(pid) ((pid) & (PID_HASH_SIZE - 1))
+static int16_t pid_hash_head[PID_HASH_SIZE];
+static int16_t pid_hash_next[MAX_PROCESSES];
+
+/*
+ * Enter a process into the PID hash. Called once its PID is assigned.
+ */
+static void pid_hash_insert(process_t* proc) {
+    int idx = (int)(proc - process_table);
+    uint32_t bucket = PID_HASH(proc->pid);
+    pid_hash_next[idx] = pid_hash_head[bucket];
+    pid_hash_head[bucket] = (int16_t)idx;
+}
+
+/*
+ * Unlink a process from the PID hash. Safe to call on a slot that was
+ * never inserted (failed creation before PID assignment).
+ */
+static void pid_hash_remove(process_t* proc) {
+    int idx = (int)(proc - process_table);
+    int16_t* link = &pid_hash_head[PID_HASH(proc->pid)];
+
+    while (*link >= 0) {
+        if (*link == idx) {
+            *link = pid_hash_next[idx];
+            pid_hash_next[idx] = -1;
+            return;
         }
+        link = &pid_hash_next[*link];
+    }
+}
+
+/*
+ * Allocate a free process slot: find-first-set on the bitmap, O(1)
+ */
+static process_t* alloc_process_slot(void) {
+    for (int w = 0; w < SLOT_BITMAP_WORDS; w++) {
+        if (slot_bitmap[w] == 0) continue;
+        int bit = __builtin_ctz(slot_bitmap[w]);
+        slot_bitmap[w] &= ~(1u << bit);
+        return &process_table[w * 32 + bit];
     }
     return NULL;
 }
 
+/*
+ * Return a slot to the free pool and drop it from the PID hash.
+ * The single release path for reaping and failed creations.
+ */
+void process_slot_free(process_t* proc) {
+    if (proc == NULL) return;
+
+    int idx = (int)(proc - process_table);
+    if (idx < 0 || idx >= MAX_PROCESSES) return;
+
+    pid_hash_remove(proc);
+    fpu_release(proc);
+    proc->state = PROCESS_STATE_UNUSED;
+    proc->pid = 0;
+    proc->ppid = 0;
+    slot_bitmap[idx / 32] |= 1u << (idx % 32);
+}
+
 /*
  * Initialize the process subsystem
  */
 void process_init(void) {
     /* Clear process table */
     memset(process_table, 0, sizeof(process_table));
-    
+
     current_process = NULL;
-    ready_queue = NULL;
+    memset(ready_queues, 0, sizeof(ready_queues));
+    memset(ready_tails, 0, sizeof(ready_tails));
+    ready_bitmap = 0;
     next_pid = 0;
-    
+
+    /* All slots start free; mask off bits past MAX_PROCESSES */
+    for (int i = 0; i < SLOT_BITMAP_WORDS; i++) {
+        slot_bitmap[i] = 0xFFFFFFFFu;
+    }
+    if (MAX_PROCESSES % 32) {
+        slot_bitmap[SLOT_BITMAP_WORDS - 1] =
+            (1u << (MAX_PROCESSES % 32)) - 1;
+    }
+
+    for (int i = 0; i < PID_HASH_SIZE; i++) {
+        pid_hash_head[i] = -1;
+    }
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        pid_hash_next[i] = -1;
+    }
+
     printk("Process: Initialized (max %d processes)\n", MAX_PROCESSES);
 }
 
@@ -61,14 +152,16 @@ int process_create(void (*entry_point)(void), const char* name) {
     uint32_t stack_base = (uint32_t)kmalloc(KERNEL_STACK_SIZE);
     if (stack_base == 0) {
         printk("Process: Cannot allocate kernel stack\n");
+        process_slot_free(proc);
         return -1;
     }
-    
+
     /* Stack grows downward, so top is at base + size */
     uint32_t stack_top = stack_base + KERNEL_STACK_SIZE;
-    
+
     /* Initialize PCB */
     proc->pid = next_pid++;
+    pid_hash_insert(proc);
     proc->ppid = current_process ? current_process->pid : 0;
     strncpy(proc->name, name, sizeof(proc->name) - 1);
     proc->name[sizeof(proc->name) - 1] = '\0';
@@ -108,13 +201,24 @@ int process_create(void (*entry_point)(void), const char* name) {
     for (int i = 0; i < MAX_OPEN_FILES; i++) {
         proc->fd_table[i] = NULL;
     }
+    proc->fd_next_free = 3;
 
     /* Initialize signal handling */
     signal_init_process(proc);
 
-    proc->priority = 1;         /* Default priority */
+    proc->priority = PROCESS_PRIORITY_DEFAULT;
     proc->time_slice = 10;      /* 10 timer ticks */
     proc->total_ticks = 0;
+    proc->ready_since_us = 0;
+    proc->sched_delay_us = 0;
+    proc->sched_delay_max_us = 0;
+    proc->dispatches = 0;
+    proc->vol_switches = 0;
+    proc->invol_switches = 0;
+    proc->boost_left = 0;
+    proc->full_slices = 0;
+    proc->queued_level = ready_level(proc->priority);
+    proc->fpu_used = 0;
     
     proc->next = NULL;
     proc->prev = NULL;
@@ -185,6 +289,7 @@ int process_create_user(void (*entry_point)(void), const char* name) {
     uint32_t kstack_base = (uint32_t)kmalloc(KERNEL_STACK_SIZE);
     if (kstack_base == 0) {
         printk("Process: Cannot allocate kernel stack\n");
+        process_slot_free(proc);
         return -1;
     }
     uint32_t kstack_top = kstack_base + KERNEL_STACK_SIZE;
@@ -194,12 +299,14 @@ int process_create_user(void (*entry_point)(void), const char* name) {
     if (ustack_base == 0) {
         printk("Process: Cannot allocate user stack\n");
         kfree((void*)kstack_base);
+        process_slot_free(proc);
         return -1;
     }
     uint32_t ustack_top = ustack_base + USER_STACK_SIZE;
 
     /* Initialize PCB */
     proc->pid = next_pid++;
+    pid_hash_insert(proc);
     proc->ppid = current_process ? current_process->pid : 0;
     strncpy(proc->name, name, sizeof(proc->name) - 1);
     proc->name[sizeof(proc->name) - 1] = '\0';
@@ -239,13 +346,24 @@ int process_create_user(void (*entry_point)(void), const char* name) {
     for (int i = 0; i < MAX_OPEN_FILES; i++) {
         proc->fd_table[i] = NULL;
     }
+    proc->fd_next_free = 3;
 
     /* Initialize signal handling */
     signal_init_process(proc);
 
-    proc->priority = 1;
+    proc->priority = PROCESS_PRIORITY_DEFAULT;
     proc->time_slice = 10;
     proc->total_ticks = 0;
+    proc->ready_since_us = 0;
+    proc->sched_delay_us = 0;
+    proc->sched_delay_max_us = 0;
+    proc->dispatches = 0;
+    proc->vol_switches = 0;
+    proc->invol_switches = 0;
+    proc->boost_left = 0;
+    proc->full_slices = 0;
+    proc->queued_level = ready_level(proc->priority);
+    proc->fpu_used = 0;
 
     proc->next = NULL;
     proc->prev = NULL;
@@ -285,6 +403,9 @@ void process_exit(int exit_code) {
     printk("Process: '%s' (PID %d) exiting with code %d\n",
            current_process->name, current_process->pid, exit_code);
 
+    /* Close any descriptors still open so pipe peers see EOF/EPIPE */
+    fd_close_all();
+
     current_process->exit_code = exit_code;
     current_process->state = PROCESS_STATE_ZOMBIE;
 
@@ -324,10 +445,11 @@ void process_exit(int exit_code) {
 }
 
 /*
- * Get process by PID
+ * Get process by PID: one hash bucket walk, O(1) in practice
  */
 process_t* process_get(uint32_t pid) {
-    for (int i = 0; i < MAX_PROCESSES; i++) {
+    for (int16_t i = pid_hash_head[PID_HASH(pid)]; i >= 0;
+         i = pid_hash_next[i]) {
         if (process_table[i].state != PROCESS_STATE_UNUSED &&
             process_table[i].pid == pid) {
             return &process_table[i];
@@ -353,20 +475,25 @@ void process_ready(process_t* proc) {
 
     proc->state = PROCESS_STATE_READY;
 
-    /* Add to end of ready queue */
-    if (ready_queue == NULL) {
-        ready_queue = proc;
-        proc->next = NULL;
-        proc->prev = NULL;
+    /* Stamp the wait start so the scheduler can measure how long the
+     * process sat ready before it ran */
+    proc->ready_since_us = timer_us();
+
+    /* Append to the tail of this priority's queue: O(1). Dynamic
+     * priority may promote sleepers or demote hogs a level; remember
+     * where we enqueued so process_unready finds the right queue. */
+    uint32_t level = sched_effective_level(proc);
+    proc->queued_level = level;
+    proc->next = NULL;
+    proc->prev = ready_tails[level];
+
+    if (ready_tails[level] != NULL) {
+        ready_tails[level]->next = proc;
     } else {
-        process_t* last = ready_queue;
-        while (last->next != NULL) {
-            last = last->next;
-        }
-        last->next = proc;
-        proc->prev = last;
-        proc->next = NULL;
+        ready_queues[level] = proc;
     }
+    ready_tails[level] = proc;
+    ready_bitmap |= (1u << level);
 }
 
 /*
@@ -377,15 +504,28 @@ void process_unready(process_t* proc) {
         return;
     }
 
-    /* Remove from linked list */
+    uint32_t level = ready_level(proc->queued_level);
+
+    /* Not queued at this level? (e.g. running process) */
+    if (proc->prev == NULL && ready_queues[level] != proc) {
+        proc->next = NULL;
+        return;
+    }
+
     if (proc->prev != NULL) {
         proc->prev->next = proc->next;
-    } else if (ready_queue == proc) {
-        ready_queue = proc->next;
+    } else {
+        ready_queues[level] = proc->next;
     }
 
     if (proc->next != NULL) {
         proc->next->prev = proc->prev;
+    } else {
+        ready_tails[level] = proc->prev;
+    }
+
+    if (ready_queues[level] == NULL) {
+        ready_bitmap &= ~(1u << level);
     }
 
     proc->next = NULL;
@@ -419,6 +559,105 @@ void process_unblock(process_t* proc) {
     process_ready(proc);
 }
 
+/*
+ * Change a process's priority. A ready process is moved to its new
+ * queue immediately; a running process is requeued at the new level
+ * on its next reschedule.
+ */
+void process_set_priority(process_t* proc, uint32_t priority) {
+    if (proc == NULL || proc->state == PROCESS_STATE_UNUSED) {
+        return;
+    }
+
+    uint32_t level = ready_level(priority);
+
+    if (proc->state == PROCESS_STATE_READY) {
+        process_unready(proc);
+        proc->priority = level;
+        process_ready(proc);
+    } else {
+        proc->priority = level;
+    }
+}
+
+/*
+ * Initialize a wait queue
+ */
+void wait_queue_init(wait_queue_t* wq) {
+    wq->head = NULL;
+    wq->tail = NULL;
+}
+
+/*
+ * Block the current process on a wait queue. The sleeper reuses the
+ * PCB's next/prev links (a blocked process is never on a ready queue)
+ * and is appended FIFO so wake_up_one is fair.
+ */
+void sleep_on(wait_queue_t* wq) {
+    extern bool scheduler_running(void);
+    extern void schedule(void);
+
+    if (wq == NULL || current_process == NULL || !scheduler_running()) {
+        return;
+    }
+
+    uint32_t eflags;
+    __asm__ volatile("pushf; pop %0; cli" : "=r"(eflags));
+
+    process_t* proc = current_process;
+    process_unready(proc);
+    proc->state = PROCESS_STATE_BLOCKED;
+
+    proc->next = NULL;
+    proc->prev = wq->tail;
+    if (wq->tail != NULL) {
+        wq->tail->next = proc;
+    } else {
+        wq->head = proc;
+    }
+    wq->tail = proc;
+
+    schedule();
+
+    if (eflags & 0x200) {
+        __asm__ volatile("sti");
+    }
+}
+
+/*
+ * Wake the first sleeper on a wait queue
+ */
+void wake_up_one(wait_queue_t* wq) {
+    uint32_t eflags;
+    __asm__ volatile("pushf; pop %0; cli" : "=r"(eflags));
+
+    process_t* proc = wq->head;
+    if (proc != NULL) {
+        wq->head = proc->next;
+        if (wq->head != NULL) {
+            wq->head->prev = NULL;
+        } else {
+            wq->tail = NULL;
+        }
+        proc->next = NULL;
+        proc->prev = NULL;
+        process_ready(proc);
+    }
+
+    if (eflags & 0x200) {
+        __asm__ volatile("sti");
+    }
+}
+
+/*
+ * Wake every sleeper on a wait queue
+ */
+void wake_up(wait_queue_t* wq) {
+    while (wq->head != NULL) {
+        wake_up_one(wq);
+    }
+}
+
 /*
  * Print process list (for debugging)
  */
@@ -497,6 +736,7 @@ int process_fork(void) {
     uint32_t kstack_base = (uint32_t)kmalloc(KERNEL_STACK_SIZE);
     if (kstack_base == 0) {
         printk("fork: cannot allocate kernel stack\n");
+        process_slot_free(child);
         return -1;
     }
     uint32_t kstack_top = kstack_base + KERNEL_STACK_SIZE;
@@ -507,11 +747,13 @@ int process_fork(void) {
     if (child_dir == NULL) {
         kfree((void*)kstack_base);
         printk("fork: cannot clone page directory\n");
+        process_slot_free(child);
         return -1;
     }
 
     /* Initialize child PCB */
     child->pid = next_pid++;
+    pid_hash_insert(child);
     child->ppid = parent->pid;
     strncpy(child->name, parent->name, sizeof(child->name) - 1);
     child->name[sizeof(child->name) - 1] = '\0';
@@ -535,16 +777,53 @@ int process_fork(void) {
     child->heap_start = parent->heap_start;
     child->heap_break = parent->heap_break;
 
-    /* Copy file descriptor table (increment refcounts) */
+    /* Share the demand-paged segments: the COW clone only carries
+     * present pages, the child faults in the rest from the file */
+    elf_clone_vmas(child, parent);
+
+    /* Child inherits the parent's open descriptors; pipe ends gain a
+     * reference so a close in one process doesn't break the other */
     memset(child->fd_table, 0, sizeof(child->fd_table));
-    /* TODO: Implement proper fd sharing with refcount */
+    child->fd_next_free = parent->fd_next_free;
+    for (int i = 0; i < MAX_OPEN_FILES; i++) {
+        file_descriptor_t* desc = (file_descriptor_t*)parent->fd_table[i];
+        if (desc == NULL) {
+            continue;
+        }
+        file_descriptor_t* copy =
+            (file_descriptor_t*)kmalloc(sizeof(file_descriptor_t));
+        if (copy == NULL) {
+            continue;  /* Child simply misses this descriptor */
+        }
+        memcpy(copy, desc, sizeof(file_descriptor_t));
+        if (copy->is_pipe && copy->pipe) {
+            if (copy->is_read_end) {
+                copy->pipe->readers++;
+            } else {
+                copy->pipe->writers++;
+            }
+        }
+        child->fd_table[i] = (struct file_descriptor*)copy;
+    }
 
     child->priority = parent->priority;
     child->time_slice = 10;
     child->total_ticks = 0;
+    child->ready_since_us = 0;
+    child->sched_delay_us = 0;
+    child->sched_delay_max_us = 0;
+    child->dispatches = 0;
+    child->vol_switches = 0;
+    child->invol_switches = 0;
+    child->boost_left = 0;
+    child->full_slices = 0;
+    child->queued_level = ready_level(child->priority);
     child->next = NULL;
     child->prev = NULL;
 
+    /* Child inherits the parent's FPU state (if any) */
+    fpu_fork(parent, child);
+
     /* Set up child's kernel stack for context switch */
     /* Child will return 0 from fork */
     uint32_t* stack = (uint32_t*)kstack_top;
@@ -589,14 +868,13 @@ int process_exec(const char* path, char* const argv[]) {
 
     /* Allocate new user stack */
     uint32_t new_stack_base = USER_STACK_BASE;
-    uint32_t stack_frame = pmm_alloc_frame();
+    uint32_t stack_frame = pmm_alloc_frame_zeroed();
     if (stack_frame == 0) {
         printk("exec: cannot allocate user stack\n");
         return -1;
     }
 
     paging_map_page(new_stack_base, stack_frame, PAGE_USER | PAGE_WRITE);
-    memset((void*)new_stack_base, 0, PAGE_SIZE);
 
     uint32_t stack_top = new_stack_base + PAGE_SIZE;
 
@@ -743,11 +1021,10 @@ int process_wait(int* status) {
                 if (child->page_directory) {
                     paging_free_directory((page_directory_t*)child->page_directory);
                 }
+                elf_release_vmas(child);
 
-                /* Mark slot as unused */
-                child->state = PROCESS_STATE_UNUSED;
-                child->pid = 0;
-                child->ppid = 0;
+                /* Release the slot */
+                process_slot_free(child);
 
                 return child_pid;
             }
@@ -777,45 +1054,55 @@ int process_wait(int* status) {
 
 /*
  * Create a new user process from an ELF file and start it
- * This is used to launch the initial userland processes from the kernel
+ *
+ * Combined fork+exec fast path: the child is built directly from the
+ * ELF image, so no intermediate address-space copy is made just to be
+ * thrown away by exec. The parent keeps running; the child's pid is
+ * returned. Called from the kernel at boot (no parent) and from
+ * sys_spawn on behalf of user processes.
  */
-int process_exec_elf(const char* path) {
-    /* First, load the ELF to get the entry point */
-    uint32_t entry;
-    int result = elf_load_file(path, &entry);
-    if (result < 0) {
-        printk("exec_elf: failed to load '%s'\n", path);
+int process_spawn(const char* path, char* const argv[]) {
+    /* Allocate a process slot first so the loader can record the ELF
+     * segments as demand-paged VMAs on the new process */
+    process_t* proc = alloc_process_slot();
+    if (proc == NULL) {
+        printk("spawn: No free process slots\n");
         return -1;
     }
+    proc->state = PROCESS_STATE_CREATED;
 
-    /* Allocate a process slot */
-    process_t* proc = alloc_process_slot();
-    if (proc == NULL) {
-        printk("exec_elf: No free process slots\n");
+    /* Map the ELF to get the entry point */
+    uint32_t entry;
+    int result = elf_map_file(path, proc, &entry);
+    if (result < 0) {
+        printk("spawn: failed to load '%s'\n", path);
+        process_slot_free(proc);
         return -1;
     }
 
     /* Allocate kernel stack */
     uint32_t kstack_base = (uint32_t)kmalloc(KERNEL_STACK_SIZE);
     if (kstack_base == 0) {
-        printk("exec_elf: Cannot allocate kernel stack\n");
+        printk("spawn: Cannot allocate kernel stack\n");
+        elf_release_vmas(proc);
+        process_slot_free(proc);
         return -1;
     }
     uint32_t kstack_top = kstack_base + KERNEL_STACK_SIZE;
 
-    /* Allocate user stack - needs to be in user space */
-    uint32_t ustack_base = USER_STACK_BASE - (USER_STACK_SIZE - PAGE_SIZE);
-    for (uint32_t offset = 0; offset < USER_STACK_SIZE; offset += PAGE_SIZE) {
-        uint32_t stack_frame = pmm_alloc_frame();
-        if (stack_frame == 0) {
-            printk("exec_elf: Cannot allocate user stack frame\n");
-            kfree((void*)kstack_base);
-            return -1;
-        }
-        paging_map_page(ustack_base + offset, stack_frame, PAGE_USER | PAGE_WRITE);
-        memset((void*)(ustack_base + offset), 0, PAGE_SIZE);
+    /* Commit only the top page of the user stack; deeper pages are
+     * mapped on first touch by the stack-growth fault handler, with a
+     * guard page under USER_STACK_MAX_SIZE catching runaway recursion */
+    uint32_t ustack_base = USER_STACK_BASE;
+    uint32_t stack_frame = pmm_alloc_frame_zeroed();
+    if (stack_frame == 0) {
+        printk("spawn: Cannot allocate user stack frame\n");
+        kfree((void*)kstack_base);
+        elf_release_vmas(proc);
+        process_slot_free(proc);
+        return -1;
     }
-    uint32_t ustack_top = ustack_base + USER_STACK_SIZE - 16;
+    paging_map_page(ustack_base, stack_frame, PAGE_USER | PAGE_WRITE);
 
     /* Extract program name from path */
     const char* name = path;
@@ -823,9 +1110,69 @@ int process_exec_elf(const char* path) {
         if (*p == '/') name = p + 1;
     }
 
+    /* Build argc/argv on the new user stack - same layout process_exec
+     * uses, so _start sees an identical frame either way. The stack is
+     * mapped in the shared kernel directory, so we can write it directly. */
+    uint32_t stack_top = ustack_base + PAGE_SIZE;
+
+    int spawn_argc = 0;
+    size_t strings_size = 0;
+    if (argv != NULL) {
+        for (int i = 0; argv[i] != NULL; i++) {
+            spawn_argc++;
+            strings_size += strlen(argv[i]) + 1;
+        }
+    }
+    if (spawn_argc == 0) {
+        /* No args provided - use the program name as argv[0] */
+        spawn_argc = 1;
+        strings_size = strlen(name) + 1;
+    }
+
+    stack_top -= strings_size;
+    stack_top &= ~3;
+    uint32_t strings_start = stack_top;
+
+    uint32_t* argv_ptrs = (uint32_t*)kmalloc((spawn_argc + 1) * sizeof(uint32_t));
+    if (argv_ptrs == NULL) {
+        kfree((void*)kstack_base);
+        elf_release_vmas(proc);
+        process_slot_free(proc);
+        return -1;
+    }
+
+    char* str_ptr = (char*)strings_start;
+    if (argv != NULL && argv[0] != NULL) {
+        for (int i = 0; i < spawn_argc; i++) {
+            size_t len = strlen(argv[i]) + 1;
+            memcpy(str_ptr, argv[i], len);
+            argv_ptrs[i] = (uint32_t)str_ptr;
+            str_ptr += len;
+        }
+    } else {
+        size_t len = strlen(name) + 1;
+        memcpy(str_ptr, name, len);
+        argv_ptrs[0] = (uint32_t)str_ptr;
+    }
+    argv_ptrs[spawn_argc] = 0;
+
+    stack_top -= (spawn_argc + 1) * sizeof(uint32_t);
+    stack_top &= ~3;
+    uint32_t argv_start = stack_top;
+    memcpy((void*)argv_start, argv_ptrs, (spawn_argc + 1) * sizeof(uint32_t));
+    kfree(argv_ptrs);
+
+    /* Push argv pointer and argc */
+    stack_top -= sizeof(uint32_t);
+    *(uint32_t*)stack_top = argv_start;
+    stack_top -= sizeof(uint32_t);
+    *(uint32_t*)stack_top = (uint32_t)spawn_argc;
+
+    uint32_t ustack_top = stack_top;
+
     /* Initialize PCB */
     proc->pid = next_pid++;
-    proc->ppid = 0;  /* No parent - kernel launched */
+    pid_hash_insert(proc);
     strncpy(proc->name, name, sizeof(proc->name) - 1);
     proc->name[sizeof(proc->name) - 1] = '\0';
 
@@ -833,11 +1180,21 @@ int process_exec_elf(const char* path) {
     proc->exit_code = 0;
     proc->is_user_mode = 1;
 
-    /* Run as root */
-    proc->uid = 0;
-    proc->gid = 0;
-    proc->euid = 0;
-    proc->egid = 0;
+    /* Inherit parent and credentials when spawned from a process;
+     * kernel-launched processes have no parent and run as root */
+    if (current_process != NULL) {
+        proc->ppid = current_process->pid;
+        proc->uid = current_process->uid;
+        proc->gid = current_process->gid;
+        proc->euid = current_process->euid;
+        proc->egid = current_process->egid;
+    } else {
+        proc->ppid = 0;
+        proc->uid = 0;
+        proc->gid = 0;
+        proc->euid = 0;
+        proc->egid = 0;
+    }
 
     proc->kernel_stack = kstack_top;
     proc->kernel_stack_base = kstack_base;
@@ -857,13 +1214,24 @@ int process_exec_elf(const char* path) {
     for (int i = 0; i < MAX_OPEN_FILES; i++) {
         proc->fd_table[i] = NULL;
     }
+    proc->fd_next_free = 3;
 
     /* Initialize signal handling */
     signal_init_process(proc);
 
-    proc->priority = 1;
+    proc->priority = PROCESS_PRIORITY_DEFAULT;
     proc->time_slice = 10;
     proc->total_ticks = 0;
+    proc->ready_since_us = 0;
+    proc->sched_delay_us = 0;
+    proc->sched_delay_max_us = 0;
+    proc->dispatches = 0;
+    proc->vol_switches = 0;
+    proc->invol_switches = 0;
+    proc->boost_left = 0;
+    proc->full_slices = 0;
+    proc->queued_level = ready_level(proc->priority);
+    proc->fpu_used = 0;
     proc->next = NULL;
     proc->prev = NULL;
 
@@ -879,7 +1247,14 @@ int process_exec_elf(const char* path) {
     /* Add to ready queue */
     process_ready(proc);
 
-    printk("exec_elf: Started '%s' (PID %d, entry 0x%x)\n", name, proc->pid, entry);
+    printk("spawn: Started '%s' (PID %d, entry 0x%x)\n", name, proc->pid, entry);
     return proc->pid;
 }
 
+/*
+ * Legacy entry point: spawn with no explicit argument vector
+ */
+int process_exec_elf(const char* path) {
+    return process_spawn(path, NULL);
+}
+
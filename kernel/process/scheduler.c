@@ -1,25 +1,67 @@
 /*
  * MiniOS Scheduler Implementation
  * 
- * Simple round-robin scheduler with timer preemption.
+ * Priority scheduler with timer preemption: fixed priority levels,
+ * round-robin within each level.
  */
 
 #include "../include/scheduler.h"
 #include "../include/process.h"
 #include "../include/stdio.h"
 #include "../include/string.h"
+#include "../include/timer.h"
+#include "../include/trace.h"
+#include "../include/fpu.h"
+#include "../include/conf.h"
+#include "../include/pmm.h"
 
 /* Scheduler state */
 static bool scheduler_active = false;
 static uint64_t total_switches = 0;
 static uint64_t idle_ticks = 0;
 
+/* Dynamic-priority tuning (overridable via the "sched" config section,
+ * see scheduler_load_conf) */
+static uint32_t sched_boost_dispatches = 3; /* Runs a sleeper stays boosted */
+static uint32_t sched_boost_slice = 3;      /* Quantum while boosted (ticks) */
+static uint32_t sched_hog_threshold = 3;    /* Full quanta before demotion */
+static uint32_t sched_hog_slice = 20;       /* Quantum once demoted (ticks) */
+
+/* Latency instrumentation */
+static bool in_tick_preempt = false;    /* schedule() came from the tick */
+static uint64_t total_delay_us = 0;     /* Sum of all ready->running waits */
+static uint32_t max_delay_us = 0;       /* Worst wait since boot */
+static uint32_t total_dispatches = 0;
+static uint32_t total_voluntary = 0;
+static uint32_t total_involuntary = 0;
+
 /* Idle process - runs when nothing else is ready */
 static void idle_process(void) {
     while (1) {
-        /* Enable interrupts and halt until next interrupt */
+        /* Use otherwise-dead time to stage pre-zeroed frames for the
+         * allocator; only halt once the pool is full */
+        if (ready_bitmap == 0 && pmm_zero_pool_topup()) {
+            continue;
+        }
+
+        /* Stretch the tick while nothing is runnable, halt, then
+         * restore the periodic rate on wakeup */
+        __asm__ volatile("cli");
+        if (ready_bitmap == 0) {
+            timer_enter_idle();
+        }
         __asm__ volatile("sti; hlt");
+
+        __asm__ volatile("cli");
+        timer_exit_idle();
+        __asm__ volatile("sti");
         idle_ticks++;
+
+        /* An interrupt may have woken somebody: run them now instead
+         * of waiting for the preemption tick */
+        if (ready_bitmap != 0) {
+            schedule();
+        }
     }
 }
 
@@ -34,34 +76,106 @@ void scheduler_init(void) {
     /* Initialize process subsystem */
     process_init();
     
-    /* Create idle process (PID 0) */
+    /* Create idle process (PID 0) at the lowest priority so every
+     * other ready process is picked before it */
     int idle_pid = process_create(idle_process, "idle");
     if (idle_pid < 0) {
         printk("Scheduler: Failed to create idle process!\n");
         return;
     }
-    
+    process_set_priority(process_get(idle_pid), PROCESS_PRIORITY_IDLE);
+
     printk("Scheduler: Initialized\n");
 }
 
 /*
- * Get next process to run
+ * Ready-queue level under dynamic priority. A process that recently
+ * slept (keyboard, pipe, disk) runs one level above its base priority
+ * for its next few dispatches; one that keeps burning whole quanta
+ * runs one level below. Idle keeps its own level either way.
+ */
+uint32_t sched_effective_level(process_t* proc) {
+    uint32_t prio = proc->priority;
+
+    if (prio >= PROCESS_PRIORITY_IDLE) {
+        return PROCESS_NUM_PRIORITIES - 1;
+    }
+    if (proc->boost_left > 0) {
+        if (prio > 0) {
+            prio--;
+        }
+    } else if (proc->full_slices >= sched_hog_threshold &&
+               prio + 1 < PROCESS_PRIORITY_IDLE) {
+        prio++;
+    }
+    return prio;
+}
+
+/*
+ * Pull the dynamic-priority knobs from /mnt/conf/sched.conf. Missing
+ * keys keep their compiled-in defaults.
+ */
+void scheduler_load_conf(void) {
+    conf_section_t sec;
+    if (conf_load(&sec, "sched") != 0) {
+        return;
+    }
+    sched_boost_dispatches =
+        conf_get_uint32(&sec, "boost_dispatches", sched_boost_dispatches);
+    sched_boost_slice =
+        conf_get_uint32(&sec, "boost_slice", sched_boost_slice);
+    sched_hog_threshold =
+        conf_get_uint32(&sec, "hog_threshold", sched_hog_threshold);
+    sched_hog_slice =
+        conf_get_uint32(&sec, "hog_slice", sched_hog_slice);
+
+    if (sched_boost_slice == 0) sched_boost_slice = 1;
+    if (sched_hog_threshold == 0) sched_hog_threshold = 1;
+    if (sched_hog_slice == 0) sched_hog_slice = DEFAULT_TIME_SLICE;
+}
+
+/*
+ * Get next process to run: find-first-set on the ready bitmap gives
+ * the highest non-empty priority level, whose head runs next. O(1).
  */
 static process_t* get_next_process(void) {
-    /* Round-robin: get first ready process that is not idle */
-    process_t* p = ready_queue;
-    while (p != NULL) {
-        if (p->pid != 0) {
-            return p;
+    if (ready_bitmap == 0) {
+        /* Nothing ready (idle is running) - keep running idle */
+        return process_get(0);
+    }
+    return ready_queues[__builtin_ctz(ready_bitmap)];
+}
+
+/* Last point at which the running process was charged for CPU */
+static uint64_t cpu_charge_us = 0;
+
+/*
+ * Charge the time since the last charge point to p's current bucket.
+ * Kernel processes always accrue kernel time; user processes split
+ * on cpu_in_kernel, which syscall entry/exit flips.
+ */
+static void sched_cpu_account(process_t* p) {
+    uint64_t now = timer_us();
+    if (p != NULL) {
+        uint64_t delta = now - cpu_charge_us;
+        if (p->cpu_in_kernel || !p->is_user_mode) {
+            p->cpu_kernel_us += delta;
+        } else {
+            p->cpu_user_us += delta;
         }
-        p = p->next;
     }
-    
-    /* Only idle is ready, or queue is empty - return idle (PID 0) */
-    if (ready_queue != NULL && ready_queue->pid == 0) {
-        return ready_queue;
+    cpu_charge_us = now;
+}
+
+/*
+ * Flip the running process's CPU accounting bucket (1 = kernel)
+ */
+void sched_cpu_mark(int in_kernel) {
+    if (current_process == NULL) {
+        return;
     }
-    return process_get(0);
+    sched_cpu_account(current_process);
+    current_process->cpu_in_kernel = in_kernel ? 1 : 0;
 }
 
 /*
@@ -71,7 +185,12 @@ void schedule(void) {
     if (!scheduler_active) {
         return;
     }
-    
+
+    /* Consume the tick flag up front: the call may context-switch
+     * away and not return until much later */
+    bool tick_preempt = in_tick_preempt;
+    in_tick_preempt = false;
+
     process_t* prev = current_process;
     process_t* next = get_next_process();
     
@@ -85,7 +204,51 @@ void schedule(void) {
         /* Same process, no switch needed */
         return;
     }
-    
+
+    /* Classify why prev gave up the CPU: still RUNNING at this point
+     * means preemption (tick) or an explicit yield; anything else
+     * blocked or exited of its own accord */
+    if (prev != NULL) {
+        if (prev->state == PROCESS_STATE_RUNNING && tick_preempt) {
+            prev->invol_switches++;
+            total_involuntary++;
+            /* Burned the whole quantum: one step closer to hog status
+             * (early preemption by a boosted waker doesn't count) */
+            if (prev->time_slice == 0) {
+                prev->full_slices++;
+                prev->boost_left = 0;
+            }
+        } else {
+            prev->vol_switches++;
+            total_voluntary++;
+            prev->full_slices = 0;
+            /* A genuine sleep (not a yield) earns a latency boost for
+             * the wakeup that follows */
+            if (prev->state == PROCESS_STATE_BLOCKED) {
+                prev->boost_left = sched_boost_dispatches;
+            }
+        }
+    }
+
+    /* Close out prev's CPU charge; next is charged from here on */
+    sched_cpu_account(prev);
+
+    /* Charge next's time on the ready queue to its delay counters */
+    if (next->ready_since_us != 0) {
+        uint64_t wait = timer_us() - next->ready_since_us;
+        next->sched_delay_us += wait;
+        total_delay_us += wait;
+        if ((uint32_t)wait > next->sched_delay_max_us) {
+            next->sched_delay_max_us = (uint32_t)wait;
+        }
+        if ((uint32_t)wait > max_delay_us) {
+            max_delay_us = (uint32_t)wait;
+        }
+        next->ready_since_us = 0;
+    }
+    next->dispatches++;
+    total_dispatches++;
+
     /* Update states */
     if (prev != NULL && prev->state == PROCESS_STATE_RUNNING) {
         prev->state = PROCESS_STATE_READY;
@@ -94,13 +257,28 @@ void schedule(void) {
         process_ready(prev);
     }
     
-    /* Remove next from ready queue and mark as running */
+    /* Remove next from ready queue and mark as running. Boosted
+     * sleepers run often but briefly; hogs run rarely but longer. */
     process_unready(next);
     next->state = PROCESS_STATE_RUNNING;
-    next->time_slice = DEFAULT_TIME_SLICE;
+    if (next->boost_left > 0) {
+        next->boost_left--;
+        next->time_slice = sched_boost_slice;
+    } else if (next->full_slices >= sched_hog_threshold) {
+        next->time_slice = sched_hog_slice;
+    } else {
+        next->time_slice = DEFAULT_TIME_SLICE;
+    }
     
     current_process = next;
     total_switches++;
+
+    /* Arm the lazy-FPU trap: no state moves unless next actually
+     * touches the FPU */
+    fpu_on_switch(next);
+
+    TRACE(TRACE_CAT_SCHED, TRACE_EV_SCHED_SWITCH,
+          prev != NULL ? prev->pid : 0, next->pid);
     
     /* Perform context switch */
     if (prev != NULL) {
@@ -133,8 +311,13 @@ void scheduler_tick(void) {
         current_process->time_slice--;
     }
     
-    /* Preempt if time slice expired */
-    if (current_process->time_slice == 0) {
+    /* Preempt if the slice expired, or early if somebody more urgent
+     * (a boosted sleeper) is waiting at a higher level */
+    if (current_process->time_slice == 0 ||
+        (ready_bitmap != 0 &&
+         (uint32_t)__builtin_ctz(ready_bitmap) <
+             sched_effective_level(current_process))) {
+        in_tick_preempt = true;
         schedule();
     }
 }
@@ -181,13 +364,18 @@ void scheduler_enable(void) {
 void scheduler_get_stats(scheduler_stats_t* stats) {
     stats->total_switches = total_switches;
     stats->idle_ticks = idle_ticks;
+    stats->total_delay_us = total_delay_us;
+    stats->max_delay_us = max_delay_us;
+    stats->dispatches = total_dispatches;
+    stats->voluntary = total_voluntary;
+    stats->involuntary = total_involuntary;
 
-    /* Count ready processes */
+    /* Count ready processes across all priority levels */
     uint32_t count = 0;
-    process_t* p = ready_queue;
-    while (p != NULL) {
-        count++;
-        p = p->next;
+    for (int level = 0; level < PROCESS_NUM_PRIORITIES; level++) {
+        for (process_t* p = ready_queues[level]; p != NULL; p = p->next) {
+            count++;
+        }
     }
     stats->num_ready = count;
 }
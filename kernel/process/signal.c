@@ -144,18 +144,12 @@ void signal_deliver_to(process_t* proc) {
         return;
     }
 
-    /* Check each signal */
-    for (int sig = 1; sig < NSIG; sig++) {
-        /* Skip if not pending */
-        if (!(proc->pending_signals & (1 << sig))) {
-            continue;
-        }
-
-        /* Skip if blocked (unless SIGKILL/SIGSTOP) */
-        if ((proc->blocked_signals & (1 << sig)) &&
-            sig != SIGKILL && sig != SIGSTOP) {
-            continue;
-        }
+    /* Pick signals straight off the deliverable mask: find-first-set
+     * per delivery, no walk over the 31 slots when most are clear */
+    uint32_t deliverable;
+    while ((deliverable = SIG_DELIVERABLE(proc->pending_signals,
+                                          proc->blocked_signals)) != 0) {
+        int sig = __builtin_ctz(deliverable);
 
         /* Clear pending bit */
         proc->pending_signals &= ~(1 << sig);
@@ -0,0 +1,168 @@
+/*
+ * MiniOS Kernel Workqueue Implementation
+ *
+ * Two lists protected by interrupt masking: a FIFO of runnable items
+ * and a deadline-sorted list of delayed items. Workers sleep on a
+ * wait queue while both are empty; schedule_work wakes one. Delayed
+ * items are promoted to the FIFO by the worker that sleeps on their
+ * deadline, so no timer callback slot is consumed.
+ */
+
+#include "../include/workqueue.h"
+#include "../include/process.h"
+#include "../include/scheduler.h"
+#include "../include/timer.h"
+#include "../include/stdio.h"
+#include "../include/io.h"
+
+/* Runnable work, FIFO order */
+static work_t* pending_head = NULL;
+static work_t* pending_tail = NULL;
+
+/* Delayed work, sorted by run_at_ticks ascending */
+static work_t* delayed_head = NULL;
+
+/* Workers park here while there is nothing to run */
+static wait_queue_t work_wait;
+
+static uint32_t works_executed = 0;
+static uint32_t works_pending = 0;
+
+/*
+ * Append to the runnable FIFO. Caller holds interrupts off.
+ */
+static void pending_enqueue(work_t* work) {
+    work->next = NULL;
+    if (pending_tail != NULL) {
+        pending_tail->next = work;
+    } else {
+        pending_head = work;
+    }
+    pending_tail = work;
+}
+
+/*
+ * Move every delayed item whose deadline has passed onto the FIFO.
+ * Caller holds interrupts off. Returns ticks until the next deadline,
+ * or 0 if no delayed work remains.
+ */
+static uint32_t delayed_promote(uint32_t now) {
+    while (delayed_head != NULL &&
+           (int32_t)(now - delayed_head->run_at_ticks) >= 0) {
+        work_t* work = delayed_head;
+        delayed_head = work->next;
+        pending_enqueue(work);
+    }
+    if (delayed_head == NULL) {
+        return 0;
+    }
+    return delayed_head->run_at_ticks - now;
+}
+
+/*
+ * Worker thread body: run items until both lists drain, then park
+ */
+static void worker_thread(void) {
+    while (1) {
+        uint32_t eflags = irq_save();
+
+        uint32_t wait_ticks = delayed_promote(timer_get_ticks());
+
+        work_t* work = pending_head;
+        if (work != NULL) {
+            pending_head = work->next;
+            if (pending_head == NULL) {
+                pending_tail = NULL;
+            }
+            work->queued = false;
+            works_pending--;
+        }
+
+        irq_restore(eflags);
+
+        if (work != NULL) {
+            work->func(work->data);
+            works_executed++;
+            continue;
+        }
+
+        if (wait_ticks != 0) {
+            /* Nothing runnable yet, but a deadline is coming: doze in
+             * short steps so a schedule_work wake isn't stalled long */
+            timer_sleep_ticks(wait_ticks < 10 ? wait_ticks : 10);
+        } else {
+            sleep_on(&work_wait);
+        }
+    }
+}
+
+int schedule_work(work_t* work) {
+    if (work == NULL || work->func == NULL || work->queued) {
+        return -1;
+    }
+
+    uint32_t eflags = irq_save();
+    work->queued = true;
+    work->run_at_ticks = 0;
+    pending_enqueue(work);
+    works_pending++;
+    irq_restore(eflags);
+
+    wake_up_one(&work_wait);
+    return 0;
+}
+
+int schedule_delayed_work(work_t* work, uint32_t delay_ms) {
+    if (work == NULL || work->func == NULL || work->queued) {
+        return -1;
+    }
+    if (delay_ms == 0) {
+        return schedule_work(work);
+    }
+
+    uint32_t eflags = irq_save();
+    work->queued = true;
+    work->run_at_ticks = timer_get_ticks() + (delay_ms + 9) / 10;  /* 100Hz PIT */
+
+    /* Insert in deadline order so workers only look at the head */
+    work_t** link = &delayed_head;
+    while (*link != NULL &&
+           (int32_t)((*link)->run_at_ticks - work->run_at_ticks) <= 0) {
+        link = &(*link)->next;
+    }
+    work->next = *link;
+    *link = work;
+    works_pending++;
+    irq_restore(eflags);
+
+    /* A parked worker must re-evaluate the nearest deadline */
+    wake_up_one(&work_wait);
+    return 0;
+}
+
+void workqueue_get_stats(uint32_t* executed, uint32_t* pending) {
+    if (executed != NULL) {
+        *executed = works_executed;
+    }
+    if (pending != NULL) {
+        *pending = works_pending;
+    }
+}
+
+void workqueue_init(void) {
+    static const char* worker_names[WORKQUEUE_NUM_WORKERS] = {
+        "kworker0", "kworker1"
+    };
+
+    wait_queue_init(&work_wait);
+
+    for (int i = 0; i < WORKQUEUE_NUM_WORKERS; i++) {
+        int pid = process_create(worker_thread, worker_names[i]);
+        if (pid < 0) {
+            printk("Workqueue: failed to create %s\n", worker_names[i]);
+            continue;
+        }
+    }
+
+    printk("Workqueue: %d workers started\n", WORKQUEUE_NUM_WORKERS);
+}
@@ -25,20 +25,57 @@
 #include "../include/blockdev.h"
 #include "../include/ext2.h"
 #include "../include/timer.h"
+#include "../include/bootprof.h"
+#include "../include/klog.h"
+#include "../include/trace.h"
+#include "../include/scheduler.h"
+#include "../include/profile.h"
+#include "../include/irqwatch.h"
+#include "../include/spinlock.h"
+#include "../include/smp.h"
+#include "../include/ksyms.h"
+#include "../include/pipe.h"
+#include "../include/strsearch.h"
 
 /* Maximum number of registered commands */
-#define MAX_COMMANDS 90
+#define MAX_COMMANDS 120
 
-/* Command history */
-#define MAX_HISTORY 16
+/* Command history: a ring buffer, so inserting is one copy into the
+ * head slot with no shifting regardless of the history size. Logical
+ * index 0 is the oldest retained entry. */
+#define MAX_HISTORY 64
 static char history[MAX_HISTORY][SHELL_MAX_CMD_LEN];
-static int history_count = 0;
-static int history_index = 0;
+static int history_head = 0;    /* Next physical slot to overwrite */
+static int history_size = 0;    /* Entries currently retained */
+static int history_index = 0;   /* Logical recall cursor (0..size) */
+
+/* Logical index (0 = oldest) to stored line */
+static const char* history_at(int i) {
+    int phys = history_head - history_size + i;
+    if (phys < 0) phys += MAX_HISTORY;
+    return history[phys % MAX_HISTORY];
+}
 
 /* Command table */
 static shell_command_t commands[MAX_COMMANDS];
 static int num_commands = 0;
 
+/* Command lookup: open-addressed hash mapping name -> commands[] slot,
+ * plus an alphabetically sorted index for help and tab completion.
+ * Commands are never unregistered, so no tombstones are needed. */
+#define CMD_HASH_SIZE 256   /* Power of two, > 2x MAX_COMMANDS */
+static int16_t cmd_hash[CMD_HASH_SIZE];
+static int16_t cmd_sorted[MAX_COMMANDS];
+static bool cmd_hash_ready = false;
+
+static uint32_t cmd_hash_name(const char* name) {
+    uint32_t h = 5381;
+    while (*name) {
+        h = h * 33 + (uint8_t)*name++;
+    }
+    return h & (CMD_HASH_SIZE - 1);
+}
+
 /* Input buffer */
 static char input_buffer[SHELL_MAX_CMD_LEN];
 static int input_len = 0;    /* Length of input string */
@@ -87,6 +124,115 @@ void shell_output(const char* str) {
     }
 }
 
+/*
+ * Batched output and pager: long-output builtins run with the VGA
+ * output redirect pointed at a capture buffer, so their printk/vga
+ * calls cost a memory append instead of a per-character screen write
+ * with scrolling. When the command finishes the buffer is flushed in
+ * one go - paged a screenful at a time when it would not fit, so a
+ * huge listing shows its first screen immediately.
+ */
+#define PAGE_BUFFER_SIZE 32768
+
+static char page_buffer[PAGE_BUFFER_SIZE];
+static int page_len = 0;
+static bool page_overflow = false;
+static int page_esc_state = 0;
+
+static void page_capture_char(char c) {
+    /* Swallow the ANSI color escapes vga_write() emits while
+       redirected; the replay goes through plain vga_puts */
+    if (page_esc_state == 1) {
+        if (c == 'm') page_esc_state = 0;
+        return;
+    }
+    if (c == '\x1b') {
+        page_esc_state = 1;
+        return;
+    }
+
+    if (page_len >= PAGE_BUFFER_SIZE - 1) {
+        /* Too big to hold: dump what we have and stream the rest
+           straight to the screen like before */
+        vga_set_output_redirect(NULL);
+        page_buffer[page_len] = '\0';
+        vga_puts(page_buffer);
+        page_len = 0;
+        page_overflow = true;
+        vga_putchar(c);
+        return;
+    }
+    page_buffer[page_len++] = c;
+}
+
+static void page_flush(void) {
+    vga_set_output_redirect(NULL);
+    if (page_len == 0) {
+        page_overflow = false;
+        return;
+    }
+    page_buffer[page_len] = '\0';
+
+    int lines = 0;
+    for (int i = 0; i < page_len; i++) {
+        if (page_buffer[i] == '\n') lines++;
+    }
+
+    int rows = VGA_HEIGHT - 1;
+    if (page_overflow || lines <= rows) {
+        /* Fits on screen (or already partially streamed): one write */
+        vga_puts(page_buffer);
+        page_len = 0;
+        page_overflow = false;
+        return;
+    }
+
+    /* less-style pager over the captured buffer */
+    int shown = 0;
+    int i = 0;
+    while (i < page_len) {
+        int start = i;
+        while (i < page_len && page_buffer[i] != '\n') i++;
+        if (i < page_len) i++;
+
+        char saved = page_buffer[i];
+        page_buffer[i] = '\0';
+        vga_puts(&page_buffer[start]);
+        page_buffer[i] = saved;
+        shown++;
+
+        if (shown >= rows && i < page_len) {
+            vga_write("--More--", vga_entry_color(VGA_COLOR_BLACK, VGA_COLOR_LIGHT_GREY));
+            char key = keyboard_getchar();
+            for (int k = 0; k < 8; k++) vga_move_cursor_left();
+            for (int k = 0; k < 8; k++) vga_putchar(' ');
+            for (int k = 0; k < 8; k++) vga_move_cursor_left();
+            if (key == 'q' || key == 'Q') break;
+            /* Enter advances one line, anything else a full page */
+            shown = (key == '\n') ? rows - 1 : 0;
+        }
+    }
+    page_len = 0;
+    page_overflow = false;
+}
+
+/*
+ * Builtins whose output is worth capturing: non-interactive, can emit
+ * screenfuls. Interactive commands (nano, login, ...) must keep the
+ * console live and are never captured.
+ */
+static bool shell_cmd_paged(const char* name) {
+    static const char* paged[] = {
+        "help", "ls", "cat", "ps", "dmesg", "man", "history", "find",
+        "grep", "sort", "hexdump", "xxd", "strings", "env", "df",
+        "mount", "diff", "seq", NULL
+    };
+    for (int i = 0; paged[i] != NULL; i++) {
+        if (strcmp(paged[i], name) == 0) return true;
+    }
+    return false;
+}
+
 /*
  * Helper function to resolve a path (relative or absolute) to a full path
  */
@@ -117,6 +263,115 @@ static vfs_node_t* find_file(const char* name) {
 /* Forward declaration for shell_prompt */
 static void shell_prompt(void);
 
+/*
+ * Completion index: sorted name snapshots of the directories TAB last
+ * completed in, so repeated presses binary-search an in-memory array
+ * instead of re-enumerating the directory (a disk walk on ext2).
+ * Snapshots expire after a short TTL or when the directory's recorded
+ * size changes (the VFS has no mtime), and the whole index is dropped
+ * whenever a command runs, since any command may change the tree.
+ */
+#define COMP_CACHE_DIRS     4
+#define COMP_CACHE_NAMES    128
+#define COMP_CACHE_TTL      200     /* Ticks (100Hz): 2 seconds */
+
+typedef struct {
+    vfs_node_t* dir;            /* Snapshotted directory (key) */
+    uint32_t dir_length;        /* node->length when taken */
+    uint32_t taken;             /* Tick the snapshot was taken */
+    int count;                  /* Names held (sorted) */
+    bool valid;
+    uint32_t stamp;             /* LRU */
+    char names[COMP_CACHE_NAMES][VFS_MAX_NAME];
+} comp_dir_cache_t;
+
+static comp_dir_cache_t comp_cache[COMP_CACHE_DIRS];
+static uint32_t comp_cache_stamp = 0;
+
+static void comp_cache_drop(void) {
+    for (int i = 0; i < COMP_CACHE_DIRS; i++) {
+        comp_cache[i].valid = false;
+    }
+}
+
+/*
+ * Snapshot a directory's names, sorted, for prefix search. Returns
+ * NULL for directories too big for a snapshot; callers fall back to
+ * direct enumeration.
+ */
+static comp_dir_cache_t* comp_snapshot(vfs_node_t* dir) {
+    uint32_t now = timer_get_ticks();
+
+    comp_dir_cache_t* slot = NULL;
+    for (int i = 0; i < COMP_CACHE_DIRS; i++) {
+        comp_dir_cache_t* c = &comp_cache[i];
+        if (c->valid && c->dir == dir) {
+            if (c->dir_length == dir->length && now - c->taken < COMP_CACHE_TTL) {
+                c->stamp = ++comp_cache_stamp;
+                return c;
+            }
+            slot = c;   /* Stale: rebuild in place */
+            break;
+        }
+        if (slot == NULL || !c->valid ||
+            (slot->valid && c->stamp < slot->stamp)) {
+            slot = c;
+        }
+    }
+
+    /* Build the snapshot with one cursor pass, insertion-sorting the
+       names as they arrive */
+    slot->valid = false;
+    slot->count = 0;
+
+    vfs_dir_cursor_t cursor;
+    if (vfs_opendir(dir, &cursor) != 0) {
+        return NULL;
+    }
+    dirent_t* entry;
+    while ((entry = vfs_readdir_next(&cursor)) != NULL) {
+        if (strcmp(entry->name, ".") == 0 || strcmp(entry->name, "..") == 0) {
+            continue;
+        }
+        if (slot->count >= COMP_CACHE_NAMES) {
+            return NULL;    /* Too big: don't cache a partial view */
+        }
+        int pos = slot->count;
+        while (pos > 0 && strcmp(slot->names[pos - 1], entry->name) > 0) {
+            memcpy(slot->names[pos], slot->names[pos - 1], VFS_MAX_NAME);
+            pos--;
+        }
+        strncpy(slot->names[pos], entry->name, VFS_MAX_NAME - 1);
+        slot->names[pos][VFS_MAX_NAME - 1] = '\0';
+        slot->count++;
+    }
+
+    slot->dir = dir;
+    slot->dir_length = dir->length;
+    slot->taken = now;
+    slot->valid = true;
+    slot->stamp = ++comp_cache_stamp;
+    return slot;
+}
+
+/*
+ * First index in the snapshot whose name is >= the prefix; the run of
+ * matches (if any) starts here since the names are sorted.
+ */
+static int comp_lower_bound(const comp_dir_cache_t* c, const char* prefix, int len) {
+    int lo = 0;
+    int hi = c->count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (strncmp(c->names[mid], prefix, len) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
 /*
  * Tab completion helper - find common prefix among matches
  */
@@ -155,10 +410,11 @@ static void shell_tab_complete(void) {
     int match_count = 0;
     
     if (is_command) {
-        /* Complete command names */
+        /* Complete command names (sorted index gives alphabetical matches) */
         for (int i = 0; i < num_commands && match_count < 32; i++) {
-            if (strncmp(commands[i].name, partial, partial_len) == 0) {
-                matches[match_count++] = commands[i].name;
+            const shell_command_t* cmd = shell_command_sorted(i);
+            if (strncmp(cmd->name, partial, partial_len) == 0) {
+                matches[match_count++] = cmd->name;
             }
         }
     } else {
@@ -194,16 +450,28 @@ static void shell_tab_complete(void) {
         vfs_node_t* dir_node = vfs_lookup(resolved_dir);
         
         if (dir_node && (dir_node->flags & VFS_DIRECTORY)) {
-            static char match_names[32][VFS_MAX_NAME];
-            uint32_t idx = 0;
-            dirent_t* entry;
-            
-            while ((entry = vfs_readdir(dir_node, idx++)) != NULL && match_count < 32) {
-                if (strncmp(entry->name, file_prefix, prefix_len) == 0) {
-                    strncpy(match_names[match_count], entry->name, VFS_MAX_NAME - 1);
-                    match_names[match_count][VFS_MAX_NAME - 1] = '\0';
-                    matches[match_count] = match_names[match_count];
-                    match_count++;
+            comp_dir_cache_t* snap = comp_snapshot(dir_node);
+            if (snap) {
+                /* Sorted snapshot: binary-search to the first candidate
+                   and take the contiguous run of prefix matches */
+                int i = comp_lower_bound(snap, file_prefix, prefix_len);
+                while (i < snap->count && match_count < 32 &&
+                       strncmp(snap->names[i], file_prefix, prefix_len) == 0) {
+                    matches[match_count++] = snap->names[i++];
+                }
+            } else {
+                /* Directory too large to snapshot: enumerate directly */
+                static char match_names[32][VFS_MAX_NAME];
+                uint32_t idx = 0;
+                dirent_t* entry;
+
+                while ((entry = vfs_readdir(dir_node, idx++)) != NULL && match_count < 32) {
+                    if (strncmp(entry->name, file_prefix, prefix_len) == 0) {
+                        strncpy(match_names[match_count], entry->name, VFS_MAX_NAME - 1);
+                        match_names[match_count][VFS_MAX_NAME - 1] = '\0';
+                        matches[match_count] = match_names[match_count];
+                        match_count++;
+                    }
                 }
             }
         }
@@ -289,9 +557,15 @@ static int cmd_ps(int argc, char* argv[]);
 static int cmd_touch(int argc, char* argv[]);
 static int cmd_write(int argc, char* argv[]);
 static int cmd_run(int argc, char* argv[]);
+static int cmd_sh(int argc, char* argv[]);
 static int cmd_progs(int argc, char* argv[]);
 static int cmd_mem(int argc, char* argv[]);
 static int cmd_uptime(int argc, char* argv[]);
+static int cmd_bootchart(int argc, char* argv[]);
+static int cmd_profile(int argc, char* argv[]);
+static int cmd_irqwatch(int argc, char* argv[]);
+static int cmd_locks(int argc, char* argv[]);
+static int cmd_cpus(int argc, char* argv[]);
 static int cmd_date(int argc, char* argv[]);
 static int cmd_uname(int argc, char* argv[]);
 static int cmd_kill(int argc, char* argv[]);
@@ -304,6 +578,7 @@ static int cmd_rm(int argc, char* argv[]);
 static int cmd_rmdir(int argc, char* argv[]);
 static int cmd_cp(int argc, char* argv[]);
 static int cmd_mv(int argc, char* argv[]);
+static int cmd_ln(int argc, char* argv[]);
 static int cmd_stat(int argc, char* argv[]);
 static int cmd_head(int argc, char* argv[]);
 static int cmd_tail(int argc, char* argv[]);
@@ -321,6 +596,8 @@ static int cmd_dmesg(int argc, char* argv[]);
 static int cmd_interrupts(int argc, char* argv[]);
 static int cmd_lscpu(int argc, char* argv[]);
 static int cmd_diskmgmt(int argc, char* argv[]);
+static int cmd_iostat(int argc, char* argv[]);
+static int cmd_trace(int argc, char* argv[]);
 /* 10.4: Text/Data Commands */
 static int cmd_hexdump(int argc, char* argv[]);
 static int cmd_xxd(int argc, char* argv[]);
@@ -338,6 +615,7 @@ static int cmd_peek(int argc, char* argv[]);
 static int cmd_poke(int argc, char* argv[]);
 static int cmd_dump(int argc, char* argv[]);
 static int cmd_heap(int argc, char* argv[]);
+static int cmd_bench(int argc, char* argv[]);
 static int cmd_regs(int argc, char* argv[]);
 static int cmd_gdt(int argc, char* argv[]);
 static int cmd_idt(int argc, char* argv[]);
@@ -365,6 +643,7 @@ static int cmd_chown(int argc, char* argv[]);
 static int cmd_id(int argc, char* argv[]);
 /* Documentation */
 static int cmd_man(int argc, char* argv[]);
+static int cmd_apropos(int argc, char* argv[]);
 /* Daemon Commands */
 static int cmd_daemons(int argc, char* argv[]);
 static int cmd_service(int argc, char* argv[]);
@@ -414,18 +693,43 @@ static int parse_command(char* input, char* argv[], int max_args) {
     return argc;
 }
 
+/*
+ * Run an already-resolved command. Shared by the interactive path and
+ * script mode (which resolves handlers once at parse time).
+ */
+static int run_resolved_command(const shell_command_t* cmd, int argc, char* argv[]) {
+    /* Any command may create or remove files: drop the completion
+       snapshots rather than guess which directories it touched */
+    comp_cache_drop();
+
+    /* Capture long-output builtins for batching and paging (not
+       when piping, and not inside the GUI terminal's redirect) */
+    bool paged = !pipe_capture_mode && !vga_is_redirected() &&
+                 shell_cmd_paged(argv[0]);
+    if (paged) {
+        page_len = 0;
+        page_overflow = false;
+        page_esc_state = 0;
+        vga_set_output_redirect(page_capture_char);
+    }
+    int result = cmd->handler(argc, argv);
+    if (paged) {
+        page_flush();
+    }
+    return result;
+}
+
 /*
  * Find and execute a command
  */
 static int execute_command(int argc, char* argv[]) {
     if (argc == 0) return 0;
-    
-    for (int i = 0; i < num_commands; i++) {
-        if (strcmp(argv[0], commands[i].name) == 0) {
-            return commands[i].handler(argc, argv);
-        }
+
+    const shell_command_t* cmd = shell_find_command(argv[0]);
+    if (cmd) {
+        return run_resolved_command(cmd, argc, argv);
     }
-    
+
     vga_write("Unknown command: ", vga_entry_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK));
     vga_puts(argv[0]);
     vga_puts("\nType 'help' for available commands.\n");
@@ -549,19 +853,14 @@ static void process_input(void) {
     input_buffer[input_len] = '\0';
 
     if (input_len > 0) {
-        /* Save to history */
-        if (history_count < MAX_HISTORY) {
-            strncpy(history[history_count], input_buffer, SHELL_MAX_CMD_LEN - 1);
-            history[history_count][SHELL_MAX_CMD_LEN - 1] = '\0';
-            history_count++;
-        } else {
-            /* Shift history up */
-            for (int i = 0; i < MAX_HISTORY - 1; i++) {
-                strncpy(history[i], history[i + 1], SHELL_MAX_CMD_LEN);
-            }
-            strncpy(history[MAX_HISTORY - 1], input_buffer, SHELL_MAX_CMD_LEN - 1);
+        /* Save to history: one copy into the ring head, O(1) */
+        strncpy(history[history_head], input_buffer, SHELL_MAX_CMD_LEN - 1);
+        history[history_head][SHELL_MAX_CMD_LEN - 1] = '\0';
+        history_head = (history_head + 1) % MAX_HISTORY;
+        if (history_size < MAX_HISTORY) {
+            history_size++;
         }
-        history_index = history_count;
+        history_index = history_size;
 
         /* Check for pipeline and execute */
         execute_pipeline(input_buffer);
@@ -577,15 +876,60 @@ static void process_input(void) {
  */
 int shell_register_command(const char* name, const char* desc, shell_cmd_handler_t handler) {
     if (num_commands >= MAX_COMMANDS) return -1;
-    
+
+    if (!cmd_hash_ready) {
+        for (int i = 0; i < CMD_HASH_SIZE; i++) cmd_hash[i] = -1;
+        cmd_hash_ready = true;
+    }
+
     commands[num_commands].name = name;
     commands[num_commands].description = desc;
     commands[num_commands].handler = handler;
+
+    /* Insert into the hash with linear probing (table stays < 3/4 full) */
+    uint32_t h = cmd_hash_name(name);
+    while (cmd_hash[h] >= 0) {
+        h = (h + 1) & (CMD_HASH_SIZE - 1);
+    }
+    cmd_hash[h] = (int16_t)num_commands;
+
+    /* Keep the sorted index ordered by name */
+    int pos = num_commands;
+    while (pos > 0 && strcmp(commands[cmd_sorted[pos - 1]].name, name) > 0) {
+        cmd_sorted[pos] = cmd_sorted[pos - 1];
+        pos--;
+    }
+    cmd_sorted[pos] = (int16_t)num_commands;
+
     num_commands++;
     
     return 0;
 }
 
+/*
+ * Look up a command by name (O(1) via the hash table)
+ */
+const shell_command_t* shell_find_command(const char* name) {
+    if (!cmd_hash_ready) return NULL;
+
+    uint32_t h = cmd_hash_name(name);
+    while (cmd_hash[h] >= 0) {
+        if (strcmp(commands[cmd_hash[h]].name, name) == 0) {
+            return &commands[cmd_hash[h]];
+        }
+        h = (h + 1) & (CMD_HASH_SIZE - 1);
+    }
+    return NULL;
+}
+
+/*
+ * Get the idx'th command in alphabetical order
+ */
+const shell_command_t* shell_command_sorted(int idx) {
+    if (idx < 0 || idx >= num_commands) return NULL;
+    return &commands[cmd_sorted[idx]];
+}
+
 static int cmd_mount(int argc, char* argv[]) {
     if (argc < 3) {
         vga_puts("Usage: mount <device> <mountpoint> [ext2]\n");
@@ -660,9 +1004,15 @@ void shell_init(void) {
     shell_register_command("touch", "Create a file", cmd_touch);
     shell_register_command("write", "Write to a file", cmd_write);
     shell_register_command("run", "Run a program", cmd_run);
+    shell_register_command("sh", "Run a pre-parsed command script", cmd_sh);
     shell_register_command("progs", "List available programs", cmd_progs);
     shell_register_command("mem", "Show memory info", cmd_mem);
     shell_register_command("uptime", "Show system uptime", cmd_uptime);
+    shell_register_command("bootchart", "Show boot stage timings", cmd_bootchart);
+    shell_register_command("profile", "Sampling profiler (start/stop/report)", cmd_profile);
+    shell_register_command("irqwatch", "Show longest interrupts-off windows", cmd_irqwatch);
+    shell_register_command("locks", "Show spinlock counters", cmd_locks);
+    shell_register_command("cpus", "Show detected CPU topology", cmd_cpus);
     shell_register_command("date", "Show current date and time", cmd_date);
     shell_register_command("uname", "Show system info", cmd_uname);
     shell_register_command("kill", "Kill a process", cmd_kill);
@@ -676,6 +1026,7 @@ void shell_init(void) {
     shell_register_command("rmdir", "Remove directory", cmd_rmdir);
     shell_register_command("cp", "Copy file", cmd_cp);
     shell_register_command("mv", "Move/rename file", cmd_mv);
+    shell_register_command("ln", "Create symbolic link", cmd_ln);
     shell_register_command("stat", "Show file info", cmd_stat);
     shell_register_command("head", "Show first lines", cmd_head);
     shell_register_command("tail", "Show last lines", cmd_tail);
@@ -695,6 +1046,9 @@ void shell_init(void) {
     shell_register_command("interrupts", "Show IRQ stats", cmd_interrupts);
     shell_register_command("lscpu", "Show CPU info", cmd_lscpu);
     shell_register_command("diskmgmt", "Disk management", cmd_diskmgmt);
+    shell_register_command("iostat", "Per-device I/O statistics", cmd_iostat);
+    shell_register_command("trace", "Kernel tracepoints", cmd_trace);
+    shell_register_command("bench", "Run kernel microbenchmarks", cmd_bench);
 
     /* 10.4: Text/Data Commands */
     shell_register_command("hexdump", "Hex dump file", cmd_hexdump);
@@ -745,6 +1099,7 @@ void shell_init(void) {
 
     /* Documentation */
     shell_register_command("man", "Show command manual", cmd_man);
+    shell_register_command("apropos", "Search manual pages", cmd_apropos);
 
     /* Daemon Commands */
     shell_register_command("daemons", "List system daemons", cmd_daemons);
@@ -782,10 +1137,11 @@ static int cmd_help(int argc, char* argv[]) {
 
     vga_puts("Available commands:\n");
     for (int i = 0; i < num_commands; i++) {
+        const shell_command_t* cmd = shell_command_sorted(i);
         vga_write("  ", vga_entry_color(VGA_COLOR_LIGHT_GREY, VGA_COLOR_BLACK));
-        vga_write(commands[i].name, vga_entry_color(VGA_COLOR_LIGHT_CYAN, VGA_COLOR_BLACK));
+        vga_write(cmd->name, vga_entry_color(VGA_COLOR_LIGHT_CYAN, VGA_COLOR_BLACK));
         vga_puts(" - ");
-        vga_puts(commands[i].description);
+        vga_puts(cmd->description);
         vga_puts("\n");
     }
     return 0;
@@ -944,11 +1300,15 @@ static void ls_directory(vfs_node_t* dir_node, const char* path, bool long_forma
 
 static void ls_directory(vfs_node_t* dir_node, const char* path, bool long_format,
                          bool show_all, bool human_readable, bool one_per_line, bool recursive) {
-    uint32_t idx = 0;
+    vfs_dir_cursor_t cursor;
     dirent_t* entry;
     int count = 0;
 
-    while ((entry = vfs_readdir(dir_node, idx++)) != NULL) {
+    if (vfs_opendir(dir_node, &cursor) != 0) {
+        return;
+    }
+
+    while ((entry = vfs_readdir_next(&cursor)) != NULL) {
         /* Skip hidden files unless -a */
         if (!show_all && entry->name[0] == '.') {
             continue;
@@ -973,8 +1333,10 @@ static void ls_directory(vfs_node_t* dir_node, const char* path, bool long_forma
 
     /* Recursive listing */
     if (recursive) {
-        idx = 0;
-        while ((entry = vfs_readdir(dir_node, idx++)) != NULL) {
+        if (vfs_opendir(dir_node, &cursor) != 0) {
+            return;
+        }
+        while ((entry = vfs_readdir_next(&cursor)) != NULL) {
             if (!show_all && entry->name[0] == '.') continue;
             if (strcmp(entry->name, ".") == 0 || strcmp(entry->name, "..") == 0) continue;
 
@@ -1321,11 +1683,16 @@ static int cmd_write(int argc, char* argv[]) {
  */
 static int cmd_run(int argc, char* argv[]) {
     if (argc < 2) {
-        vga_puts("Usage: run <program>\n");
+        vga_puts("Usage: run <program> [args...]\n");
         return -1;
     }
 
+    /* Embedded flat binaries first; anything else is spawned straight
+     * from its ELF image (no intermediate address-space copy) */
     int pid = loader_exec(argv[1]);
+    if (pid < 0) {
+        pid = process_spawn(argv[1], &argv[1]);
+    }
     if (pid < 0) {
         vga_puts("Failed to run: ");
         vga_puts(argv[1]);
@@ -1347,6 +1714,202 @@ static int cmd_run(int argc, char* argv[]) {
     return 0;
 }
 
+/*
+ * sh - Pre-parsed script execution
+ *
+ * Runs a command file without touching the interactive path: the
+ * whole file is parsed ONCE into an array of steps, each holding its
+ * argc/argv (pointers into the loaded source, tokenized in place) and
+ * the builtin's handler resolved through the command registry. A
+ * `repeat N ... end` construct loops over steps by index, so every
+ * iteration after the first costs a table walk and the handlers
+ * themselves - zero re-tokenizing, zero re-resolving. Path-looking
+ * arguments are looked up once at parse time purely to warm the
+ * dcache, so the first iteration's vfs_lookup calls hit memory too.
+ *
+ * Unknown commands and unbalanced loops are reported with their line
+ * number before anything runs, like a compile step.
+ */
+
+#define SCRIPT_MAX_STEPS    128
+#define SCRIPT_MAX_DEPTH    8
+
+typedef enum {
+    SCRIPT_STEP_CMD,        /* Resolved builtin invocation */
+    SCRIPT_STEP_REPEAT,     /* Loop head: run the body `count` times */
+    SCRIPT_STEP_END         /* Loop tail: jump back to its repeat */
+} script_step_kind_t;
+
+typedef struct {
+    script_step_kind_t kind;
+    const shell_command_t* cmd; /* CMD: handler resolved at parse time */
+    int argc;
+    char* argv[SHELL_MAX_ARGS];
+    uint32_t count;             /* REPEAT: iteration count */
+    uint32_t remaining;         /* REPEAT: iterations left this run */
+    int jump;                   /* REPEAT: step past its end; END: its repeat */
+} script_step_t;
+
+static int cmd_sh(int argc, char* argv[]) {
+    if (argc < 2) {
+        vga_puts("Usage: sh <script>\n");
+        return -1;
+    }
+
+    vfs_node_t* node = find_file(argv[1]);
+    if (node == NULL || (node->flags & VFS_DIRECTORY)) {
+        printk("sh: cannot open '%s'\n", argv[1]);
+        return -1;
+    }
+
+    /* Load the whole script; tokenization happens in this buffer and
+     * the step table points into it, so it lives until execution ends */
+    char* src = (char*)kmalloc(node->length + 1);
+    script_step_t* steps =
+        (script_step_t*)kmalloc(sizeof(script_step_t) * SCRIPT_MAX_STEPS);
+    if (src == NULL || steps == NULL) {
+        if (src) kfree(src);
+        if (steps) kfree(steps);
+        printk("sh: out of memory\n");
+        return -1;
+    }
+    int32_t len = vfs_read(node, 0, node->length, (uint8_t*)src);
+    if (len < 0) {
+        printk("sh: read error on '%s'\n", argv[1]);
+        kfree(src);
+        kfree(steps);
+        return -1;
+    }
+    src[len] = '\0';
+
+    /* ---- Parse pass: one walk over the source ---- */
+    int num_steps = 0;
+    int loop_stack[SCRIPT_MAX_DEPTH];
+    int depth = 0;
+    int line_no = 0;
+    char* line = src;
+    bool ok = true;
+
+    while (line != NULL && *line != '\0') {
+        line_no++;
+        char* next = strchr(line, '\n');
+        if (next != NULL) {
+            *next++ = '\0';
+        }
+
+        /* Comments run to end of line; blank lines are skipped */
+        char* hash = strchr(line, '#');
+        if (hash != NULL) {
+            *hash = '\0';
+        }
+
+        /* Skip blank lines before charging them against the limit */
+        char* probe = line;
+        while (*probe == ' ' || *probe == '\t') probe++;
+        if (*probe == '\0') {
+            line = next;
+            continue;
+        }
+
+        if (num_steps == SCRIPT_MAX_STEPS) {
+            printk("sh: line %d: script too long (max %d commands)\n",
+                   line_no, SCRIPT_MAX_STEPS);
+            ok = false;
+            break;
+        }
+
+        script_step_t* step = &steps[num_steps];
+        step->argc = parse_command(line, step->argv, SHELL_MAX_ARGS);
+        line = next;
+
+        if (strcmp(step->argv[0], "repeat") == 0) {
+            if (step->argc != 2 || atoi(step->argv[1]) < 0) {
+                printk("sh: line %d: usage: repeat <count>\n", line_no);
+                ok = false;
+                break;
+            }
+            if (depth == SCRIPT_MAX_DEPTH) {
+                printk("sh: line %d: loops nested too deep\n", line_no);
+                ok = false;
+                break;
+            }
+            step->kind = SCRIPT_STEP_REPEAT;
+            step->count = (uint32_t)atoi(step->argv[1]);
+            loop_stack[depth++] = num_steps++;
+            continue;
+        }
+
+        if (strcmp(step->argv[0], "end") == 0) {
+            if (depth == 0) {
+                printk("sh: line %d: end without repeat\n", line_no);
+                ok = false;
+                break;
+            }
+            int head = loop_stack[--depth];
+            step->kind = SCRIPT_STEP_END;
+            step->jump = head;
+            steps[head].jump = num_steps + 1;
+            num_steps++;
+            continue;
+        }
+
+        /* Resolve the builtin once, here */
+        step->kind = SCRIPT_STEP_CMD;
+        step->cmd = shell_find_command(step->argv[0]);
+        if (step->cmd == NULL) {
+            printk("sh: line %d: unknown command '%s'\n",
+                   line_no, step->argv[0]);
+            ok = false;
+            break;
+        }
+
+        /* Warm the dcache for anything that could be a path (flags
+         * can't be; failed lookups are harmless) */
+        for (int i = 1; i < step->argc; i++) {
+            if (step->argv[i][0] != '-') {
+                find_file(step->argv[i]);
+            }
+        }
+        num_steps++;
+    }
+
+    if (ok && depth != 0) {
+        printk("sh: repeat without end (depth %d at EOF)\n", depth);
+        ok = false;
+    }
+
+    /* ---- Execute pass: walk the step table by index ---- */
+    int result = -1;
+    if (ok) {
+        result = 0;
+        int pc = 0;
+        while (pc < num_steps) {
+            script_step_t* step = &steps[pc];
+            switch (step->kind) {
+                case SCRIPT_STEP_REPEAT:
+                    step->remaining = step->count;
+                    pc = (step->count == 0) ? step->jump : pc + 1;
+                    break;
+                case SCRIPT_STEP_END: {
+                    script_step_t* head = &steps[step->jump];
+                    pc = (--head->remaining > 0) ? step->jump + 1 : pc + 1;
+                    break;
+                }
+                case SCRIPT_STEP_CMD:
+                default:
+                    result = run_resolved_command(step->cmd,
+                                                  step->argc, step->argv);
+                    pc++;
+                    break;
+            }
+        }
+    }
+
+    kfree(src);
+    kfree(steps);
+    return result;
+}
+
 /*
  * progs - List available programs
  */
@@ -1399,6 +1962,82 @@ static int cmd_uptime(int argc, char* argv[]) {
     return 0;
 }
 
+/*
+ * bootchart - Show boot stage timings from the boot profiler
+ */
+static int cmd_bootchart(int argc, char* argv[]) {
+    (void)argc; (void)argv;
+
+    static char buf[2048];
+    bootprof_format(buf, sizeof(buf));
+    printk("%s", buf);
+
+    return 0;
+}
+
+/*
+ * profile - Control the sampling kernel profiler
+ */
+static int cmd_profile(int argc, char* argv[]) {
+    if (argc < 2) {
+        vga_puts("Usage: profile start|stop|report\n");
+        return 1;
+    }
+
+    if (strcmp(argv[1], "start") == 0) {
+        profile_start();
+        vga_puts("Profiler started (sampling EIP at 100 Hz)\n");
+    } else if (strcmp(argv[1], "stop") == 0) {
+        profile_stop();
+        vga_puts("Profiler stopped\n");
+    } else if (strcmp(argv[1], "report") == 0) {
+        if (profile_running()) {
+            profile_stop();
+        }
+        profile_report();
+    } else {
+        vga_puts("Usage: profile start|stop|report\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+/*
+ * irqwatch - Show the longest interrupts-off windows by call site
+ */
+static int cmd_irqwatch(int argc, char* argv[]) {
+    if (argc >= 2 && strcmp(argv[1], "reset") == 0) {
+        irqwatch_reset();
+        vga_puts("irqwatch table cleared\n");
+        return 0;
+    }
+    if (argc >= 2) {
+        vga_puts("Usage: irqwatch [reset]\n");
+        return 1;
+    }
+    irqwatch_report();
+    return 0;
+}
+
+/*
+ * locks - Show registered spinlock acquisition/contention counters
+ */
+static int cmd_locks(int argc, char* argv[]) {
+    (void)argc; (void)argv;
+    spinlock_report();
+    return 0;
+}
+
+/*
+ * cpus - Show the CPU topology detected at boot
+ */
+static int cmd_cpus(int argc, char* argv[]) {
+    (void)argc; (void)argv;
+    smp_report();
+    return 0;
+}
+
 /*
  * date - Show current date and time from RTC
  */
@@ -1550,17 +2189,6 @@ static int cmd_kill(int argc, char* argv[]) {
     return 0;
 }
 
-/* Helper for port I/O */
-static inline uint8_t inb(uint16_t port) {
-    uint8_t ret;
-    __asm__ volatile("inb %1, %0" : "=a"(ret) : "Nd"(port));
-    return ret;
-}
-
-static inline void outb(uint16_t port, uint8_t val) {
-    __asm__ volatile("outb %0, %1" : : "a"(val), "Nd"(port));
-}
-
 /*
  * reboot - Reboot the system
  */
@@ -1902,16 +2530,9 @@ static int cp_file(vfs_node_t* src, vfs_node_t* dest_parent, const char* dest_na
     }
     if (!dest) return -1;
 
-    uint8_t buf[4096];
-    uint32_t offset = 0;
-    int32_t bytes;
-    while ((bytes = vfs_read(src, offset, 4096, buf)) > 0) {
-        int32_t written = vfs_write(dest, offset, bytes, buf);
-        if (written < 0) {
-            printk("cp: write error at offset %u\n", offset);
-            return -1;
-        }
-        offset += bytes;
+    if (vfs_copy_file(src, dest, NULL) < 0) {
+        printk("cp: error copying '%s'\n", src->name);
+        return -1;
     }
     if (verbose) printk("'%s' -> '%s'\n", src->name, dest_name);
     return 0;
@@ -2024,6 +2645,59 @@ static int cmd_mv(int argc, char* argv[]) {
     return 0;
 }
 
+static int cmd_ln(int argc, char* argv[]) {
+    bool symbolic = false;
+    const char* target = NULL;
+    const char* link_name = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0) {
+            symbolic = true;
+        } else if (!target) {
+            target = argv[i];
+        } else {
+            link_name = argv[i];
+        }
+    }
+
+    if (!target || !link_name) {
+        vga_puts("Usage: ln [-s] <target> <name>\n");
+        return -1;
+    }
+
+    vfs_node_t* parent = current_dir_node;
+    const char* name = link_name;
+    if (name[0] == '/') {
+        parent = vfs_root;
+        name++;
+    }
+
+    if (parent == NULL || parent->readdir != ext2_vfs_readdir) {
+        vga_puts("ln: links need an ext2 filesystem\n");
+        return -1;
+    }
+
+    if (symbolic) {
+        if (ext2_create_symlink(parent, name, target) == NULL) {
+            vga_puts("ln: failed to create link\n");
+            return -1;
+        }
+    } else {
+        vfs_node_t* tnode = find_file(target);
+        if (tnode == NULL) {
+            printk("ln: cannot stat '%s': No such file or directory\n", target);
+            return -1;
+        }
+        if (ext2_create_hardlink(parent, name, tnode) == NULL) {
+            vga_puts("ln: failed to create link\n");
+            return -1;
+        }
+    }
+
+    printk("Created %s -> %s\n", link_name, target);
+    return 0;
+}
+
 static int cmd_stat(int argc, char* argv[]) {
     if (argc < 2) {
         vga_puts("Usage: stat <filename>\n");
@@ -2300,8 +2974,26 @@ static char dmesg_buffer[2048] = "MiniOS Boot Log\n"
     "[ OK ] Shell initialized\n";
 
 static int cmd_dmesg(int argc, char* argv[]) {
-    (void)argc; (void)argv;
+    /* Runtime level filter: dmesg level <0-3> */
+    if (argc >= 2 && strcmp(argv[1], "level") == 0) {
+        if (argc < 3) {
+            printk("dmesg: log level is %u (%s)\n",
+                   klog_get_level(), klog_level_name(klog_get_level()));
+            return 0;
+        }
+        int lvl = atoi(argv[2]);
+        if (lvl < 0 || lvl > KLOG_DEBUG) {
+            vga_puts("dmesg: level must be 0 (err) .. 3 (debug)\n");
+            return -1;
+        }
+        klog_set_level((uint8_t)lvl);
+        printk("dmesg: log level set to %d (%s)\n", lvl, klog_level_name((uint8_t)lvl));
+        return 0;
+    }
+
     vga_puts(dmesg_buffer);
+    /* Binary ring records are formatted only here, on demand */
+    klog_render(vga_puts);
     return 0;
 }
 
@@ -2312,7 +3004,8 @@ static int cmd_interrupts(int argc, char* argv[]) {
 
     vga_puts("IRQ Statistics:\n");
     printk("  IRQ0 (Timer):    %u\n", timer_get_ticks());
-    vga_puts("  IRQ1 (Keyboard): (count not tracked)\n");
+    printk("  IRQ1 (Keyboard): %u (%u dropped)\n",
+           keyboard_irq_count(), keyboard_overrun_count());
     return 0;
 }
 
@@ -2320,66 +3013,130 @@ static int cmd_interrupts(int argc, char* argv[]) {
  * 10.4: Text/Data Commands
  * ============================================ */
 
-static int cmd_hexdump(int argc, char* argv[]) {
-    if (argc < 2) {
-        vga_puts("Usage: hexdump <file>\n");
-        return -1;
-    }
+/*
+ * Shared hex-formatting engine for hexdump/xxd/dump. Files are read
+ * in 64KB chunks and formatted into one big output buffer with
+ * table-lookup nibble conversion, then emitted through shell_output
+ * so the pager/batch path sees whole chunks instead of per-byte
+ * printk calls.
+ */
+#define HEXFMT_CHUNK      (64 * 1024)
+#define HEXFMT_LINE_MAX   80    /* Worst-case formatted line */
 
-    vfs_node_t* node = find_file(argv[1]);
-    if (node == NULL) {
-        vga_puts("hexdump: file not found\n");
-        return -1;
+static const char hexfmt_digits[] = "0123456789abcdef";
+
+static char* hexfmt_u32(char* out, uint32_t v) {
+    for (int shift = 28; shift >= 0; shift -= 4) {
+        *out++ = hexfmt_digits[(v >> shift) & 0xF];
     }
+    return out;
+}
 
-    uint8_t buf[256];
-    int32_t bytes = vfs_read(node, 0, node->length < 256 ? node->length : 256, buf);
+/*
+ * Format one 16-byte line. xxd style groups byte pairs and appends
+ * the ASCII column; hexdump style is plain space-separated bytes.
+ */
+static char* hexfmt_line(char* out, uint32_t offset, const uint8_t* data,
+                         uint32_t count, bool xxd_style) {
+    out = hexfmt_u32(out, offset);
+    *out++ = ':';
+    *out++ = ' ';
+
+    for (uint32_t j = 0; j < 16; j++) {
+        if (j < count) {
+            *out++ = hexfmt_digits[data[j] >> 4];
+            *out++ = hexfmt_digits[data[j] & 0xF];
+        } else if (xxd_style) {
+            *out++ = ' ';
+            *out++ = ' ';
+        } else {
+            break;
+        }
+        if (xxd_style) {
+            if ((j & 1) != 0) *out++ = ' ';
+        } else {
+            *out++ = ' ';
+        }
+    }
 
-    for (int i = 0; i < bytes; i += 16) {
-        printk("%08x  ", i);
-        for (int j = 0; j < 16 && i + j < bytes; j++) {
-            printk("%02x ", buf[i + j]);
+    if (xxd_style) {
+        *out++ = ' ';
+        for (uint32_t j = 0; j < count; j++) {
+            char c = (char)data[j];
+            *out++ = (c >= 32 && c < 127) ? c : '.';
         }
-        vga_putchar('\n');
     }
-    return 0;
+    *out++ = '\n';
+    return out;
 }
 
-static int cmd_xxd(int argc, char* argv[]) {
-    if (argc < 2) {
-        vga_puts("Usage: xxd <file>\n");
+/*
+ * Dump a whole file chunk by chunk
+ */
+static int hexfmt_dump_file(const char* path, bool xxd_style,
+                            const char* tool) {
+    vfs_node_t* node = find_file(path);
+    if (node == NULL) {
+        printk("%s: file not found\n", tool);
         return -1;
     }
 
-    vfs_node_t* node = find_file(argv[1]);
-    if (node == NULL) {
-        vga_puts("xxd: file not found\n");
+    uint8_t* data = (uint8_t*)kmalloc(HEXFMT_CHUNK);
+    char* out = (char*)kmalloc((HEXFMT_CHUNK / 16 + 1) * HEXFMT_LINE_MAX);
+    if (data == NULL || out == NULL) {
+        printk("%s: out of memory\n", tool);
+        kfree(data);
+        kfree(out);
         return -1;
     }
 
-    uint8_t buf[256];
-    int32_t bytes = vfs_read(node, 0, node->length < 256 ? node->length : 256, buf);
+    uint32_t offset = 0;
+    while (offset < node->length) {
+        uint32_t want = node->length - offset;
+        if (want > HEXFMT_CHUNK) want = HEXFMT_CHUNK;
 
-    for (int i = 0; i < bytes; i += 16) {
-        printk("%08x: ", i);
-        for (int j = 0; j < 16; j++) {
-            if (i + j < bytes) printk("%02x", buf[i + j]);
-            else vga_puts("  ");
-            if (j % 2 == 1) vga_putchar(' ');
+        int32_t bytes = vfs_read(node, offset, want, data);
+        if (bytes <= 0) {
+            break;
         }
-        vga_puts(" ");
-        for (int j = 0; j < 16 && i + j < bytes; j++) {
-            char c = buf[i + j];
-            vga_putchar((c >= 32 && c < 127) ? c : '.');
+
+        char* p = out;
+        for (int32_t i = 0; i < bytes; i += 16) {
+            uint32_t count = (uint32_t)(bytes - i);
+            if (count > 16) count = 16;
+            p = hexfmt_line(p, offset + (uint32_t)i, data + i, count,
+                            xxd_style);
         }
-        vga_putchar('\n');
+        *p = '\0';
+        shell_output(out);
+
+        offset += (uint32_t)bytes;
     }
+
+    kfree(data);
+    kfree(out);
     return 0;
 }
 
+static int cmd_hexdump(int argc, char* argv[]) {
+    if (argc < 2) {
+        vga_puts("Usage: hexdump <file>\n");
+        return -1;
+    }
+    return hexfmt_dump_file(argv[1], false, "hexdump");
+}
+
+static int cmd_xxd(int argc, char* argv[]) {
+    if (argc < 2) {
+        vga_puts("Usage: xxd <file>\n");
+        return -1;
+    }
+    return hexfmt_dump_file(argv[1], true, "xxd");
+}
+
 static int cmd_strings(int argc, char* argv[]) {
     if (argc < 2) {
-        vga_puts("Usage: strings <file>\n");
+        vga_puts("Usage: strings <file> [pattern]\n");
         return -1;
     }
 
@@ -2389,26 +3146,30 @@ static int cmd_strings(int argc, char* argv[]) {
         return -1;
     }
 
+    /* Optional filter: only print strings containing the pattern */
+    strsearch_t search;
+    bool filter = (argc >= 3);
+    if (filter) {
+        strsearch_init(&search, argv[2], false);
+    }
+
     uint8_t buf[512];
     int32_t bytes = vfs_read(node, 0, node->length < 512 ? node->length : 512, buf);
 
     char str[64];
     int len = 0;
-    for (int i = 0; i < bytes; i++) {
-        if (buf[i] >= 32 && buf[i] < 127) {
+    for (int i = 0; i <= bytes; i++) {
+        if (i < bytes && buf[i] >= 32 && buf[i] < 127) {
             if (len < 63) str[len++] = buf[i];
         } else {
-            if (len >= 4) {
+            if (len >= 4 &&
+                (!filter || strsearch_find(&search, str, (uint32_t)len) != NULL)) {
                 str[len] = '\0';
                 printk("%s\n", str);
             }
             len = 0;
         }
     }
-    if (len >= 4) {
-        str[len] = '\0';
-        printk("%s\n", str);
-    }
     return 0;
 }
 
@@ -2419,13 +3180,13 @@ static int cmd_strings(int argc, char* argv[]) {
 static int cmd_history(int argc, char* argv[]) {
     (void)argc; (void)argv;
 
-    if (history_count == 0) {
+    if (history_size == 0) {
         vga_puts("No commands in history.\n");
         return 0;
     }
 
-    for (int i = 0; i < history_count; i++) {
-        printk("  %d  %s\n", i + 1, history[i]);
+    for (int i = 0; i < history_size; i++) {
+        printk("  %d  %s\n", i + 1, history_at(i));
     }
     return 0;
 }
@@ -2533,14 +3294,17 @@ static int cmd_dump(int argc, char* argv[]) {
     }
     if (len > 256) len = 256;
 
+    /* Format the whole range in one pass through the shared engine */
     uint8_t* ptr = (uint8_t*)addr;
+    char out[(256 / 16) * HEXFMT_LINE_MAX + 1];
+    char* p = out;
     for (int i = 0; i < len; i += 16) {
-        printk("%08x: ", addr + i);
-        for (int j = 0; j < 16 && i + j < len; j++) {
-            printk("%02x ", ptr[i + j]);
-        }
-        vga_putchar('\n');
+        uint32_t count = (uint32_t)(len - i);
+        if (count > 16) count = 16;
+        p = hexfmt_line(p, addr + (uint32_t)i, ptr + i, count, false);
     }
+    *p = '\0';
+    shell_output(out);
     return 0;
 }
 
@@ -2557,12 +3321,279 @@ static int cmd_heap(int argc, char* argv[]) {
     uint32_t total = end - start;
     uint32_t free_mem = total - used;
 
+    heap_stats_t stats;
+    heap_get_stats(&stats);
+
+    /* Fragmentation: share of free space outside the largest block */
+    uint32_t frag_pct = 0;
+    if (stats.free_size > 0 && stats.largest_free < stats.free_size) {
+        frag_pct = 100 - (stats.largest_free / (stats.free_size / 100 + 1));
+    }
+
     vga_puts("Kernel Heap Info:\n");
     printk("  Start:   0x%08x\n", start);
     printk("  End:     0x%08x\n", end);
     printk("  Total:   %u bytes\n", total);
     printk("  Used:    %u bytes\n", used);
     printk("  Free:    %u bytes\n", free_mem);
+    printk("  Blocks:  %u total, %u free\n",
+           stats.block_count, stats.free_block_count);
+    printk("  Largest free: %u bytes (fragmentation %u%%)\n",
+           stats.largest_free, frag_pct);
+
+    vga_puts("\nAllocations by size class:\n");
+    heap_dump_classes();
+
+    vga_puts("\nLive allocations by caller:\n");
+    heap_dump_sites();
+    return 0;
+}
+
+/* ============================================
+ * Microbenchmarks (kernel-side half; the userland half is
+ * userland/bin/bench.c)
+ * ============================================ */
+
+/* xorshift32 PRNG for the random-read benchmark */
+static uint32_t bench_seed = 0x1234ABCD;
+static uint32_t bench_rand(void) {
+    bench_seed ^= bench_seed << 13;
+    bench_seed ^= bench_seed >> 17;
+    bench_seed ^= bench_seed << 5;
+    return bench_seed;
+}
+
+/* 64/32 division: the kernel links without libgcc (same pattern as
+ * timer.c) */
+static uint32_t bench_udiv64_32(uint64_t n, uint32_t d) {
+    uint64_t rem = n;
+    uint64_t div = d;
+    uint32_t quot = 0;
+    int shift = 0;
+
+    if (d == 0) return 0;
+
+    while (div < rem && !(div & 0x8000000000000000ull) && shift < 31) {
+        div <<= 1;
+        shift++;
+    }
+
+    while (shift >= 0) {
+        quot <<= 1;
+        if (rem >= div) {
+            rem -= div;
+            quot |= 1;
+        }
+        div >>= 1;
+        shift--;
+    }
+
+    return quot;
+}
+
+static uint32_t bench_ops_per_sec(uint32_t ops, uint32_t us) {
+    if (us == 0) return 0;
+    return bench_udiv64_32((uint64_t)ops * 1000000ull, us);
+}
+
+/* bytes/us == MB/s */
+static uint32_t bench_mb_per_sec(uint32_t bytes, uint32_t us) {
+    if (us == 0) return 0;
+    return bytes / us;
+}
+
+static void bench_heap_run(void) {
+    const uint32_t iters = 50000;
+
+    uint64_t t0 = timer_us();
+    for (uint32_t i = 0; i < iters; i++) {
+        void* p = kmalloc(64);
+        if (!p) break;
+        kfree(p);
+    }
+    uint32_t us = (uint32_t)(timer_us() - t0);
+    printk("kmalloc/kfree 64B:   %u pairs in %u us (%u ops/s)\n",
+           iters, us, bench_ops_per_sec(iters, us));
+
+    t0 = timer_us();
+    for (uint32_t i = 0; i < iters; i++) {
+        void* p = kmalloc(4096);
+        if (!p) break;
+        kfree(p);
+    }
+    us = (uint32_t)(timer_us() - t0);
+    printk("kmalloc/kfree 4K:    %u pairs in %u us (%u ops/s)\n",
+           iters, us, bench_ops_per_sec(iters, us));
+}
+
+static void bench_memcpy_run(void) {
+    const uint32_t size = 64 * 1024;
+    const uint32_t passes = 256;
+
+    uint8_t* src = kmalloc(size);
+    uint8_t* dst = kmalloc(size);
+    if (!src || !dst) {
+        vga_puts("memcpy: allocation failed\n");
+        if (src) kfree(src);
+        if (dst) kfree(dst);
+        return;
+    }
+    memset(src, 0xA5, size);
+
+    uint64_t t0 = timer_us();
+    for (uint32_t i = 0; i < passes; i++) {
+        memcpy(dst, src, size);
+    }
+    uint32_t us = (uint32_t)(timer_us() - t0);
+    printk("memcpy 64K:          %u passes in %u us (%u MB/s)\n",
+           passes, us, bench_mb_per_sec(size * passes, us));
+
+    kfree(src);
+    kfree(dst);
+}
+
+static void bench_pipe_run(void) {
+    const uint32_t chunk = 2048;
+    const uint32_t iters = 4096;
+
+    pipe_t* pipe = pipe_create();
+    uint8_t* buf = kmalloc(chunk);
+    if (!pipe || !buf) {
+        vga_puts("pipe: allocation failed\n");
+        if (pipe) pipe_destroy(pipe);
+        if (buf) kfree(buf);
+        return;
+    }
+    memset(buf, 0x5A, chunk);
+
+    /* Chunk stays below the pipe buffer size, so the single-threaded
+     * write-then-read loop never blocks */
+    uint64_t t0 = timer_us();
+    for (uint32_t i = 0; i < iters; i++) {
+        pipe_write(pipe, buf, chunk);
+        pipe_read(pipe, buf, chunk);
+    }
+    uint32_t us = (uint32_t)(timer_us() - t0);
+    printk("pipe write+read 2K:  %u round trips in %u us (%u MB/s)\n",
+           iters, us, bench_mb_per_sec(chunk * iters, us));
+
+    pipe_destroy(pipe);
+    kfree(buf);
+}
+
+static void bench_fs_run(const char* path) {
+    const uint32_t chunk = 4096;
+
+    vfs_node_t* node = vfs_lookup(path);
+    if (!node) {
+        printk("fs: %s not found, skipping\n", path);
+        return;
+    }
+
+    uint8_t* buf = kmalloc(chunk);
+    if (!buf) {
+        vga_puts("fs: allocation failed\n");
+        return;
+    }
+
+    /* Sequential: read the whole file in 4K chunks. Repeat runs are
+     * served from the block cache, so run once after boot for the
+     * cold-disk figure. */
+    uint32_t total = 0;
+    uint64_t t0 = timer_us();
+    while (total < node->length) {
+        int32_t n = vfs_read(node, total, chunk, buf);
+        if (n <= 0) break;
+        total += (uint32_t)n;
+    }
+    uint32_t us = (uint32_t)(timer_us() - t0);
+    uint32_t kbs = (us > 0)
+        ? bench_udiv64_32((uint64_t)total * 1000, us) : 0;
+    printk("fs seq read:         %s, %u bytes in %u us (%u KB/s)\n",
+           path, total, us, kbs);
+
+    /* Random: 4K reads at random offsets within the file */
+    if (node->length > chunk) {
+        const uint32_t reads = 128;
+        uint32_t span = node->length - chunk;
+        t0 = timer_us();
+        for (uint32_t i = 0; i < reads; i++) {
+            vfs_read(node, bench_rand() % span, chunk, buf);
+        }
+        us = (uint32_t)(timer_us() - t0);
+        printk("fs random read 4K:   %u reads in %u us (%u ops/s)\n",
+               reads, us, bench_ops_per_sec(reads, us));
+    }
+
+    kfree(buf);
+}
+
+static void bench_gui_run(void) {
+    if (!xgui_display_available()) {
+        vga_puts("gui: display not initialized, skipping\n");
+        return;
+    }
+
+    int w = xgui_display_width();
+    int h = xgui_display_height();
+
+    /* Fills and blits land in the backbuffer only; nothing is flushed
+     * to the screen from here */
+    const uint32_t fills = 40;
+    uint64_t t0 = timer_us();
+    for (uint32_t i = 0; i < fills; i++) {
+        xgui_display_rect_filled(0, 0, w, h, XGUI_RGB(i & 0xFF, 64, 128));
+    }
+    uint32_t us = (uint32_t)(timer_us() - t0);
+    uint32_t px = (uint32_t)(w * h) * fills;
+    printk("gui fill %dx%d:    %u fills in %u us (%u Mpx/s)\n",
+           w, h, fills, us, (us > 0) ? px / us : 0);
+
+    const int bw = 128;
+    const int bh = 128;
+    const uint32_t blits = 400;
+    uint32_t* bitmap = kmalloc((uint32_t)(bw * bh) * sizeof(uint32_t));
+    if (!bitmap) {
+        vga_puts("gui: allocation failed\n");
+        return;
+    }
+    for (int i = 0; i < bw * bh; i++) {
+        bitmap[i] = XGUI_RGB(200, 100, 50);
+    }
+
+    t0 = timer_us();
+    for (uint32_t i = 0; i < blits; i++) {
+        xgui_display_blit((int)(i % 64), (int)(i % 32), bw, bh, bitmap);
+    }
+    us = (uint32_t)(timer_us() - t0);
+    px = (uint32_t)(bw * bh) * blits;
+    printk("gui blit 128x128:    %u blits in %u us (%u Mpx/s)\n",
+           blits, us, (us > 0) ? px / us : 0);
+
+    kfree(bitmap);
+}
+
+static int cmd_bench(int argc, char* argv[]) {
+    const char* which = (argc > 1) ? argv[1] : "all";
+    const char* path = (argc > 2) ? argv[2] : "/bin/shell";
+
+    if (strcmp(which, "--help") == 0 || strcmp(which, "-h") == 0) {
+        vga_puts("Usage: bench [heap|memcpy|pipe|fs|gui|all] [path]\n\n");
+        vga_puts("Kernel-side microbenchmarks (TSC timed).\n");
+        vga_puts("path is used by the fs benchmark (default /bin/shell).\n");
+        vga_puts("Syscall round-trip cost is measured by the userland\n");
+        vga_puts("bench binary, which needs the ring transition.\n");
+        return 0;
+    }
+
+    bool all = (strcmp(which, "all") == 0);
+
+    if (all || strcmp(which, "heap") == 0)   bench_heap_run();
+    if (all || strcmp(which, "memcpy") == 0) bench_memcpy_run();
+    if (all || strcmp(which, "pipe") == 0)   bench_pipe_run();
+    if (all || strcmp(which, "fs") == 0)     bench_fs_run(path);
+    if (all || strcmp(which, "gui") == 0)    bench_gui_run();
+
     return 0;
 }
 
@@ -2659,8 +3690,8 @@ static int cmd_credits(int argc, char* argv[]) {
 
 static int cmd_top(int argc, char* argv[]) {
     (void)argc; (void)argv;
-    vga_puts("PID  NAME             STATE      TICKS\n");
-    vga_puts("---  ---------------  ---------  -----\n");
+    vga_puts("PID  NAME             STATE     CPU-US    SYS-US    DLYAVG  DLYMAX  VOL    INVOL\n");
+    vga_puts("---  ---------------  --------  --------  --------  ------  ------  -----  -----\n");
     for (int i = 0; i < MAX_PROCESSES; i++) {
         process_t* p = process_get(i);
         if (p != NULL && p->state != PROCESS_STATE_UNUSED) {
@@ -2673,16 +3704,55 @@ static int cmd_top(int argc, char* argv[]) {
                 case PROCESS_STATE_ZOMBIE:  state_str = "ZOMBIE";  break;
                 default: break;
             }
-            printk("%-4d %-16s %-9s  %d\n", p->pid, p->name, state_str, p->total_ticks);
+            /* Average ready->running delay in us (truncated 32-bit
+             * math: the kernel links without libgcc) */
+            uint32_t avg = 0;
+            if (p->dispatches > 0) {
+                avg = (uint32_t)p->sched_delay_us / p->dispatches;
+            }
+            printk("%-4d %-16s %-8s  %-8u  %-8u  %-6u  %-6u  %-5u  %u\n",
+                   p->pid, p->name, state_str,
+                   (uint32_t)(p->cpu_user_us + p->cpu_kernel_us),
+                   (uint32_t)p->cpu_kernel_us,
+                   avg, p->sched_delay_max_us,
+                   p->vol_switches, p->invol_switches);
         }
     }
+
+    scheduler_stats_t st;
+    scheduler_get_stats(&st);
+    printk("\nSwitches: %u voluntary, %u involuntary; "
+           "worst scheduling delay %u us\n",
+           st.voluntary, st.involuntary, st.max_delay_us);
     return 0;
 }
 
 static int cmd_nice(int argc, char* argv[]) {
-    (void)argc; (void)argv;
-    vga_puts("nice: Priority scheduling not implemented\n");
-    vga_puts("      All processes share equal time slices\n");
+    if (argc < 2) {
+        printk("nice: current priority %d (0=highest, %d=lowest)\n",
+               current_process ? current_process->priority : PROCESS_PRIORITY_DEFAULT,
+               PROCESS_NUM_PRIORITIES - 1);
+        return 0;
+    }
+
+    if (argc < 3) {
+        vga_puts("Usage: nice [pid] [priority]\n");
+        return -1;
+    }
+
+    int pid = atoi(argv[1]);
+    int priority = atoi(argv[2]);
+
+    process_t* proc = process_get(pid);
+    if (proc == NULL || proc->state == PROCESS_STATE_UNUSED) {
+        printk("nice: no such process: %d\n", pid);
+        return -1;
+    }
+
+    if (priority < 0) priority = 0;
+    process_set_priority(proc, (uint32_t)priority);
+    printk("nice: PID %d '%s' priority set to %d\n",
+           proc->pid, proc->name, proc->priority);
     return 0;
 }
 
@@ -2793,10 +3863,144 @@ static int cmd_diskmgmt(int argc, char* argv[]) {
     vga_puts("---------- -------- ---------- -----\n");
     vga_puts("ramfs      ramfs    (memory)   /\n");
     vga_puts("\n");
-    
+
     return 0;
 }
 
+/*
+ * iostat command - Per-device I/O statistics
+ * Counter table for every block device plus log2-microsecond latency
+ * histograms, so cache hits (low buckets) separate from disk-bound
+ * operations (high buckets) at a glance.
+ */
+static int cmd_iostat(int argc, char* argv[]) {
+    (void)argc; (void)argv;
+
+    uint8_t bdev_count = blockdev_count();
+    if (bdev_count == 0) {
+        vga_puts("No block devices registered.\n");
+        return 0;
+    }
+
+    vga_puts("NAME       READS      WRITES     RSECT      WSECT      QDEP QMAX\n");
+    vga_puts("---------- ---------- ---------- ---------- ---------- ---- ----\n");
+    for (int i = 0; i < bdev_count; i++) {
+        blockdev_t* bdev = blockdev_get(i);
+        if (bdev == NULL) continue;
+        blockdev_stats_t* st = &bdev->stats;
+        printk("%-10s %-10u %-10u %-10u %-10u %-4u %u\n",
+               bdev->name, st->reads, st->writes,
+               st->read_sectors, st->write_sectors,
+               st->queue_depth, st->queue_max);
+    }
+
+    vga_puts("\nLatency (bucket = microsecond range, R = reads, W = writes):\n");
+    for (int i = 0; i < bdev_count; i++) {
+        blockdev_t* bdev = blockdev_get(i);
+        if (bdev == NULL) continue;
+        blockdev_stats_t* st = &bdev->stats;
+        if (st->reads == 0 && st->writes == 0) continue;
+
+        printk("%s:\n", bdev->name);
+        for (int b = 0; b < BLOCKDEV_LAT_BUCKETS; b++) {
+            if (st->read_lat[b] == 0 && st->write_lat[b] == 0) continue;
+            if (b == BLOCKDEV_LAT_BUCKETS - 1) {
+                printk("  >=%u us", 1u << b);
+            } else if (b == 0) {
+                vga_puts("  0-1 us");
+            } else {
+                printk("  %u-%u us", 1u << b, (2u << b) - 1);
+            }
+            printk(": R %u  W %u\n", st->read_lat[b], st->write_lat[b]);
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * trace command - Static tracepoint control
+ */
+static const struct {
+    const char* name;
+    uint32_t mask;
+} trace_cats[] = {
+    { "sched",   TRACE_CAT_SCHED },
+    { "syscall", TRACE_CAT_SYSCALL },
+    { "block",   TRACE_CAT_BLOCK },
+    { "ipc",     TRACE_CAT_IPC },
+    { "gui",     TRACE_CAT_GUI },
+    { "all",     TRACE_CAT_ALL },
+};
+#define TRACE_NUM_CATS ((int)(sizeof(trace_cats) / sizeof(trace_cats[0])))
+
+static uint32_t trace_cat_mask(const char* name) {
+    for (int i = 0; i < TRACE_NUM_CATS; i++) {
+        if (strcmp(name, trace_cats[i].name) == 0) {
+            return trace_cats[i].mask;
+        }
+    }
+    return 0;
+}
+
+static void trace_print_rec(const trace_record_t* rec) {
+    printk("%10u us  %-12s pid %-3u  0x%x 0x%x\n",
+           rec->us, trace_event_name(rec->event), rec->pid,
+           rec->arg1, rec->arg2);
+}
+
+static int cmd_trace(int argc, char* argv[]) {
+    if (argc < 2) {
+        vga_puts("Usage: trace on|off <cat> | dump [n] | clear\n");
+        vga_puts("Categories: sched syscall block ipc gui all\n\n");
+        printk("Enabled mask: 0x%02x (", trace_enabled_mask);
+        for (int i = 0; i < TRACE_NUM_CATS - 1; i++) {
+            if (trace_enabled_mask & trace_cats[i].mask) {
+                printk(" %s", trace_cats[i].name);
+            }
+        }
+        vga_puts(" )\n\nEvent counters:\n");
+        for (uint16_t e = 0; e < TRACE_NUM_EVENTS; e++) {
+            printk("  %-12s %u\n", trace_event_name(e), trace_event_count(e));
+        }
+        return 0;
+    }
+
+    if (strcmp(argv[1], "on") == 0 || strcmp(argv[1], "off") == 0) {
+        if (argc < 3) {
+            vga_puts("trace: missing category\n");
+            return -1;
+        }
+        uint32_t mask = trace_cat_mask(argv[2]);
+        if (mask == 0) {
+            printk("trace: unknown category '%s'\n", argv[2]);
+            return -1;
+        }
+        if (argv[1][1] == 'n') {
+            trace_enable(mask);
+        } else {
+            trace_disable(mask);
+        }
+        printk("trace: mask now 0x%02x\n", trace_enabled_mask);
+        return 0;
+    }
+
+    if (strcmp(argv[1], "dump") == 0) {
+        uint32_t max = (argc >= 3) ? (uint32_t)atoi(argv[2]) : 0;
+        trace_dump(trace_print_rec, max);
+        return 0;
+    }
+
+    if (strcmp(argv[1], "clear") == 0) {
+        trace_clear();
+        vga_puts("trace: ring and counters cleared\n");
+        return 0;
+    }
+
+    printk("trace: unknown subcommand '%s'\n", argv[1]);
+    return -1;
+}
+
 /* ============================================
  * Additional 10.4: Text/Data Commands
  * ============================================ */
@@ -2805,10 +4009,6 @@ static int cmd_diskmgmt(int argc, char* argv[]) {
  * grep - Search for pattern in file
  * Flags: -i (case insensitive), -v (invert), -c (count), -n (line numbers)
  */
-static char grep_tolower(char c) {
-    if (c >= 'A' && c <= 'Z') return c + 32;
-    return c;
-}
 
 static int cmd_grep(int argc, char* argv[]) {
     bool case_insensitive = false;
@@ -2866,36 +4066,21 @@ static int cmd_grep(int argc, char* argv[]) {
         return -1;
     }
 
-    /* Search line by line */
+    /* Search line by line; the skip table is built once and reused
+       for every line */
+    strsearch_t search;
+    strsearch_init(&search, pattern, case_insensitive);
+
     int line_start = 0;
     int line_num = 1;
     int match_count = 0;
-    int pattern_len = strlen(pattern);
     char num_buf[16];
 
     for (int i = 0; i <= bytes; i++) {
         if (i == bytes || buf[i] == '\n') {
             /* Check if line contains pattern */
-            int found = 0;
-            for (int j = line_start; j <= i - pattern_len; j++) {
-                int match = 1;
-                for (int k = 0; pattern[k]; k++) {
-                    char bc = buf[j + k];
-                    char pc = pattern[k];
-                    if (case_insensitive) {
-                        bc = grep_tolower(bc);
-                        pc = grep_tolower(pc);
-                    }
-                    if (bc != pc) {
-                        match = 0;
-                        break;
-                    }
-                }
-                if (match) {
-                    found = 1;
-                    break;
-                }
-            }
+            int found = strsearch_find(&search, (const char*)buf + line_start,
+                                       (uint32_t)(i - line_start)) != NULL;
 
             /* Apply invert flag */
             if (invert_match) found = !found;
@@ -3013,7 +4198,7 @@ static int cmd_set(int argc, char* argv[]) {
     vga_puts("Shell options:\n");
     vga_puts("  echo     = off\n");
     vga_puts("  verbose  = off\n");
-    vga_puts("  history  = on (16 entries)\n");
+    vga_puts("  history  = on (64 entries)\n");
     return 0;
 }
 
@@ -3105,7 +4290,15 @@ static int cmd_stack(int argc, char* argv[]) {
     int depth = 0;
     while (frame != NULL && depth < 8 && (uint32_t)frame > 0x100000) {
         uint32_t ret_addr = frame[1];
-        printk("  Frame %d: EBP=0x%08x RET=0x%08x\n", depth, (uint32_t)frame, ret_addr);
+        uint32_t off = 0;
+        const char* name = ksym_lookup(ret_addr, &off);
+        if (name != NULL) {
+            printk("  Frame %d: EBP=0x%08x RET=0x%08x  %s+0x%x\n",
+                   depth, (uint32_t)frame, ret_addr, name, off);
+        } else {
+            printk("  Frame %d: EBP=0x%08x RET=0x%08x\n",
+                   depth, (uint32_t)frame, ret_addr);
+        }
         frame = (uint32_t*)frame[0];
         depth++;
     }
@@ -3585,6 +4778,739 @@ static int cmd_id(int argc, char* argv[]) {
 /*
  * man - Display manual page for a command
  */
+/*
+ * Embedded manual pages, sorted by name so man/apropos binary-search
+ * and scan a flat table instead of a 100-way strcmp chain. Each page
+ * is one string and goes out through shell_output in a single call.
+ */
+typedef struct {
+    const char* name;
+    const char* text;
+} man_page_t;
+
+static const man_page_t man_pages[] = {
+    { "about",
+      "ABOUT(1)                 MiniOS Manual                 ABOUT(1)\n\n"
+      "NAME\n    about - about MiniOS\n\n"
+      "SYNOPSIS\n    about\n\n"
+      "DESCRIPTION\n    Display information about MiniOS.\n\n"
+      "EXAMPLES\n    about    Show about info\n" },
+    { "alias",
+      "ALIAS(1)                 MiniOS Manual                 ALIAS(1)\n\n"
+      "NAME\n    alias - create command alias\n\n"
+      "SYNOPSIS\n    alias [name=value]\n\n"
+      "DESCRIPTION\n    Create or display command aliases.\n\n"
+      "EXAMPLES\n    alias    Show aliases\n" },
+    { "banner",
+      "BANNER(1)                MiniOS Manual                BANNER(1)\n\n"
+      "NAME\n    banner - display ASCII art text\n\n"
+      "SYNOPSIS\n    banner <text>\n\n"
+      "DESCRIPTION\n    Display text as large ASCII art letters.\n\n"
+      "EXAMPLES\n    banner HELLO    Display HELLO in ASCII art\n" },
+    { "basic",
+      "BASIC(1)                 MiniOS Manual                 BASIC(1)\n\n"
+      "NAME\n    basic - BASIC programming language interpreter\n\n"
+      "SYNOPSIS\n    basic [file.bas]\n\n"
+      "DESCRIPTION\n    Interactive BASIC interpreter supporting classic\n"
+      "    commands and statements. Programs can be saved/loaded.\n\n"
+      "COMMANDS\n    RUN       Execute the program\n"
+      "    LIST      Display program listing\n"
+      "    NEW       Clear program from memory\n"
+      "    SAVE \"f\"  Save program to file\n"
+      "    LOAD \"f\"  Load program from file\n"
+      "    BYE       Exit BASIC interpreter\n\n"
+      "STATEMENTS\n    PRINT expr    Output to screen\n"
+      "    INPUT var     Read user input\n"
+      "    LET var=expr  Assign variable\n"
+      "    IF cond THEN  Conditional execution\n"
+      "    GOTO line     Jump to line number\n"
+      "    GOSUB/RETURN  Subroutine call\n"
+      "    FOR/NEXT      Loop construct\n"
+      "    REM comment   Comment line\n"
+      "    END           End program\n"
+      "    CLS           Clear screen\n\n"
+      "FUNCTIONS\n    RND(x)  Random number 0-1\n"
+      "    ABS(x)  Absolute value\n"
+      "    INT(x)  Integer part\n\n"
+      "EXAMPLES\n    10 PRINT \"HELLO WORLD\"\n"
+      "    20 FOR I=1 TO 10\n"
+      "    30 PRINT I\n"
+      "    40 NEXT I\n" },
+    { "beep",
+      "BEEP(1)                  MiniOS Manual                  BEEP(1)\n\n"
+      "NAME\n    beep - make a beep sound\n\n"
+      "SYNOPSIS\n    beep\n\n"
+      "DESCRIPTION\n    Play a beep using the PC speaker.\n\n"
+      "EXAMPLES\n    beep    Make beep sound\n" },
+    { "cat",
+      "CAT(1)                   MiniOS Manual                   CAT(1)\n\n"
+      "NAME\n    cat - concatenate and display files\n\n"
+      "SYNOPSIS\n    cat [-nb] <filename>\n\n"
+      "DESCRIPTION\n    Display the contents of a file to the terminal.\n\n"
+      "OPTIONS\n"
+      "    -n    Number all output lines\n"
+      "    -b    Number non-empty lines only\n\n"
+      "EXAMPLES\n    cat file.txt      Display contents\n"
+      "    cat -n file.txt   Display with line numbers\n" },
+    { "cd",
+      "CD(1)                    MiniOS Manual                    CD(1)\n\n"
+      "NAME\n    cd - change directory\n\n"
+      "SYNOPSIS\n    cd [directory]\n\n"
+      "DESCRIPTION\n    Change the current working directory.\n"
+      "    Without arguments, changes to root (/).\n\n"
+      "EXAMPLES\n    cd /home      Go to /home\n"
+      "    cd ..        Go to parent directory\n"
+      "    cd           Go to root\n" },
+    { "chmod",
+      "CHMOD(1)                 MiniOS Manual                 CHMOD(1)\n\n"
+      "NAME\n    chmod - change file permissions\n\n"
+      "SYNOPSIS\n    chmod <mode> <file>\n\n"
+      "DESCRIPTION\n    Change file permissions using octal mode.\n"
+      "    Mode: owner|group|other (rwx = 4+2+1)\n\n"
+      "EXAMPLES\n    chmod 755 script    rwxr-xr-x\n"
+      "    chmod 644 file.txt  rw-r--r--\n" },
+    { "chown",
+      "CHOWN(1)                 MiniOS Manual                 CHOWN(1)\n\n"
+      "NAME\n    chown - change file owner\n\n"
+      "SYNOPSIS\n    chown <user> <file>\n\n"
+      "DESCRIPTION\n    Change the owner of a file. Root only.\n\n"
+      "EXAMPLES\n    chown bob file.txt    Make bob owner\n" },
+    { "clear",
+      "CLEAR(1)                 MiniOS Manual                 CLEAR(1)\n\n"
+      "NAME\n    clear - clear the terminal screen\n\n"
+      "SYNOPSIS\n    clear\n\n"
+      "DESCRIPTION\n    Clear all text from the terminal screen.\n\n"
+      "EXAMPLES\n    clear    Clear screen\n" },
+    { "color",
+      "COLOR(1)                 MiniOS Manual                 COLOR(1)\n\n"
+      "NAME\n    color - set terminal text color\n\n"
+      "SYNOPSIS\n    color <fg> [bg]\n\n"
+      "DESCRIPTION\n    Set foreground and background colors (0-15).\n\n"
+      "EXAMPLES\n    color 10      Light green text\n"
+      "    color 15 1   White on blue\n" },
+    { "cp",
+      "CP(1)                    MiniOS Manual                    CP(1)\n\n"
+      "NAME\n    cp - copy files and directories\n\n"
+      "SYNOPSIS\n    cp [-rv] <source> <destination>\n\n"
+      "DESCRIPTION\n    Copy files and directories.\n\n"
+      "OPTIONS\n"
+      "    -r    Recursive (copy directories)\n"
+      "    -v    Verbose (show files being copied)\n\n"
+      "EXAMPLES\n    cp file.txt backup.txt  Copy a file\n"
+      "    cp -r src/ dest/       Copy directory recursively\n" },
+    { "credits",
+      "CREDITS(1)               MiniOS Manual               CREDITS(1)\n\n"
+      "NAME\n    credits - show credits\n\n"
+      "SYNOPSIS\n    credits\n\n"
+      "DESCRIPTION\n    Display MiniOS credits and acknowledgments.\n\n"
+      "EXAMPLES\n    credits    Show credits\n" },
+    { "daemons",
+      "DAEMONS(1)               MiniOS Manual               DAEMONS(1)\n\n"
+      "NAME\n    daemons - list system daemons\n\n"
+      "SYNOPSIS\n    daemons\n\n"
+      "DESCRIPTION\n    Display status of all system daemons including\n"
+      "    their PID, state, and description.\n\n"
+      "EXAMPLES\n    daemons    Show all daemon status\n" },
+    { "date",
+      "DATE(1)                  MiniOS Manual                  DATE(1)\n\n"
+      "NAME\n    date - display date and time\n\n"
+      "SYNOPSIS\n    date\n\n"
+      "DESCRIPTION\n    Show current system uptime as date/time.\n\n"
+      "EXAMPLES\n    date    Show date/time\n" },
+    { "df",
+      "DF(1)                    MiniOS Manual                    DF(1)\n\n"
+      "NAME\n    df - report filesystem disk space usage\n\n"
+      "SYNOPSIS\n    df\n\n"
+      "DESCRIPTION\n    Display information about mounted filesystems including\n"
+      "    total blocks, used space, available space, and mount point.\n\n"
+      "EXAMPLES\n    df    Show all mounted filesystems\n" },
+    { "diff",
+      "DIFF(1)                  MiniOS Manual                  DIFF(1)\n\n"
+      "NAME\n    diff - compare two files\n\n"
+      "SYNOPSIS\n    diff <file1> <file2>\n\n"
+      "DESCRIPTION\n    Compare two files and show differences.\n\n"
+      "EXAMPLES\n    diff old.txt new.txt    Compare files\n" },
+    { "dmesg",
+      "DMESG(1)                 MiniOS Manual                 DMESG(1)\n\n"
+      "NAME\n    dmesg - print kernel boot messages\n\n"
+      "SYNOPSIS\n    dmesg\n\n"
+      "DESCRIPTION\n    Display kernel boot and initialization messages.\n\n"
+      "EXAMPLES\n    dmesg    Show boot messages\n" },
+    { "dump",
+      "DUMP(1)                  MiniOS Manual                  DUMP(1)\n\n"
+      "NAME\n    dump - dump memory range\n\n"
+      "SYNOPSIS\n    dump <address> [length]\n\n"
+      "DESCRIPTION\n    Display memory contents in hex format.\n\n"
+      "EXAMPLES\n    dump 0x100000 64    Dump 64 bytes at 1MB\n" },
+    { "echo",
+      "ECHO(1)                  MiniOS Manual                  ECHO(1)\n\n"
+      "NAME\n    echo - display text\n\n"
+      "SYNOPSIS\n    echo [-neE] [text...]\n\n"
+      "DESCRIPTION\n    Print arguments to the terminal.\n\n"
+      "OPTIONS\n"
+      "    -n    Do not output trailing newline\n"
+      "    -e    Enable interpretation of backslash escapes\n"
+      "    -E    Disable interpretation of escapes (default)\n\n"
+      "ESCAPE SEQUENCES (with -e)\n"
+      "    \\\\n   newline    \\\\t   tab    \\\\\\\\   backslash\n\n"
+      "EXAMPLES\n    echo Hello World      Prints: Hello World\n"
+      "    echo -n no newline   No trailing newline\n"
+      "    echo -e 'a\\\\tb'       Tab between a and b\n" },
+    { "env",
+      "ENV(1)                   MiniOS Manual                   ENV(1)\n\n"
+      "NAME\n    env - show environment variables\n\n"
+      "SYNOPSIS\n    env\n\n"
+      "DESCRIPTION\n    Display all environment variables.\n\n"
+      "EXAMPLES\n    env    Show environment\n" },
+    { "export",
+      "EXPORT(1)                MiniOS Manual                EXPORT(1)\n\n"
+      "NAME\n    export - set environment variable\n\n"
+      "SYNOPSIS\n    export [name=value]\n\n"
+      "DESCRIPTION\n    Set or display environment variables.\n\n"
+      "EXAMPLES\n    export PATH=/bin    Set PATH\n" },
+    { "find",
+      "FIND(1)                  MiniOS Manual                  FIND(1)\n\n"
+      "NAME\n    find - search for files in a directory hierarchy\n\n"
+      "SYNOPSIS\n    find [path] [-name pattern]\n\n"
+      "DESCRIPTION\n    Recursively search for files matching a pattern.\n"
+      "    Without -name, lists all files. Pattern uses substring match.\n\n"
+      "OPTIONS\n    -name pattern    Match files containing pattern\n\n"
+      "EXAMPLES\n    find /home           List all files under /home\n"
+      "    find . -name txt    Find files containing 'txt'\n"
+      "    find /mnt -name log Find log files on mounted drive\n" },
+    { "fortune",
+      "FORTUNE(1)               MiniOS Manual               FORTUNE(1)\n\n"
+      "NAME\n    fortune - display random quote\n\n"
+      "SYNOPSIS\n    fortune\n\n"
+      "DESCRIPTION\n    Display a random programming quote or fortune.\n\n"
+      "EXAMPLES\n    fortune    Show random quote\n" },
+    { "free",
+      "FREE(1)                  MiniOS Manual                  FREE(1)\n\n"
+      "NAME\n    free - display memory usage\n\n"
+      "SYNOPSIS\n    free\n\n"
+      "DESCRIPTION\n    Show detailed memory usage including heap stats.\n\n"
+      "EXAMPLES\n    free    Show memory usage\n" },
+    { "gdt",
+      "GDT(1)                   MiniOS Manual                   GDT(1)\n\n"
+      "NAME\n    gdt - show Global Descriptor Table\n\n"
+      "SYNOPSIS\n    gdt\n\n"
+      "DESCRIPTION\n    Display GDT entries and segment information.\n\n"
+      "EXAMPLES\n    gdt    Show GDT\n" },
+    { "grep",
+      "GREP(1)                  MiniOS Manual                  GREP(1)\n\n"
+      "NAME\n    grep - search for pattern in files\n\n"
+      "SYNOPSIS\n    grep [-ivnc] <pattern> [file]\n\n"
+      "DESCRIPTION\n    Search for lines matching pattern.\n\n"
+      "OPTIONS\n"
+      "    -i    Case-insensitive matching\n"
+      "    -v    Invert match (show non-matching lines)\n"
+      "    -n    Show line numbers\n"
+      "    -c    Count matching lines only\n\n"
+      "EXAMPLES\n    grep error log.txt       Find 'error' in log.txt\n"
+      "    grep -i ERROR log.txt   Case-insensitive search\n"
+      "    grep -n TODO *.c        Show line numbers\n"
+      "    ls | grep txt           Filter pipe output\n" },
+    { "groupadd",
+      "GROUPADD(1)              MiniOS Manual              GROUPADD(1)\n\n"
+      "NAME\n    groupadd - create a new group\n\n"
+      "SYNOPSIS\n    groupadd <groupname> [gid]\n\n"
+      "DESCRIPTION\n    Create a new group. Root only.\n\n"
+      "EXAMPLES\n    groupadd developers    Create developers group\n" },
+    { "groups",
+      "GROUPS(1)                MiniOS Manual                GROUPS(1)\n\n"
+      "NAME\n    groups - show user's groups\n\n"
+      "SYNOPSIS\n    groups [username]\n\n"
+      "DESCRIPTION\n    Display groups the user belongs to.\n\n"
+      "EXAMPLES\n    groups        Show own groups\n"
+      "    groups bob   Show bob's groups\n" },
+    { "head",
+      "HEAD(1)                  MiniOS Manual                  HEAD(1)\n\n"
+      "NAME\n    head - display first lines of a file\n\n"
+      "SYNOPSIS\n    head [-n lines] <file>\n\n"
+      "DESCRIPTION\n    Display the first N lines of a file (default 10).\n\n"
+      "EXAMPLES\n    head file.txt       First 10 lines\n"
+      "    head -n 5 file.txt  First 5 lines\n" },
+    { "heap",
+      "HEAP(1)                  MiniOS Manual                  HEAP(1)\n\n"
+      "NAME\n    heap - show heap statistics\n\n"
+      "SYNOPSIS\n    heap\n\n"
+      "DESCRIPTION\n    Display kernel heap usage and block information.\n\n"
+      "EXAMPLES\n    heap    Show heap stats\n" },
+    { "help",
+      "HELP(1)                  MiniOS Manual                  HELP(1)\n\n"
+      "NAME\n    help - display available commands\n\n"
+      "SYNOPSIS\n    help\n\n"
+      "DESCRIPTION\n    List all available shell commands with descriptions.\n\n"
+      "SEE ALSO\n    man - for detailed command documentation\n" },
+    { "hexdump",
+      "HEXDUMP(1)               MiniOS Manual               HEXDUMP(1)\n\n"
+      "NAME\n    hexdump - display file in hexadecimal\n\n"
+      "SYNOPSIS\n    hexdump <file>\n\n"
+      "DESCRIPTION\n    Display file contents in hexadecimal format.\n\n"
+      "EXAMPLES\n    hexdump binary.bin    Hex dump of binary.bin\n" },
+    { "history",
+      "HISTORY(1)               MiniOS Manual               HISTORY(1)\n\n"
+      "NAME\n    history - show command history\n\n"
+      "SYNOPSIS\n    history\n\n"
+      "DESCRIPTION\n    Display previously executed commands.\n\n"
+      "EXAMPLES\n    history    Show command history\n" },
+    { "hostname",
+      "HOSTNAME(1)              MiniOS Manual              HOSTNAME(1)\n\n"
+      "NAME\n    hostname - show system hostname\n\n"
+      "SYNOPSIS\n    hostname\n\n"
+      "DESCRIPTION\n    Display the system's hostname.\n\n"
+      "EXAMPLES\n    hostname    Show hostname\n" },
+    { "id",
+      "ID(1)                    MiniOS Manual                    ID(1)\n\n"
+      "NAME\n    id - display user and group IDs\n\n"
+      "SYNOPSIS\n    id [username]\n\n"
+      "DESCRIPTION\n    Show UID and GID for current or specified user.\n\n"
+      "EXAMPLES\n    id         Show own IDs\n"
+      "    id guest   Show guest's IDs\n" },
+    { "idt",
+      "IDT(1)                   MiniOS Manual                   IDT(1)\n\n"
+      "NAME\n    idt - show Interrupt Descriptor Table\n\n"
+      "SYNOPSIS\n    idt\n\n"
+      "DESCRIPTION\n    Display IDT summary and interrupt handlers.\n\n"
+      "EXAMPLES\n    idt    Show IDT\n" },
+    { "interrupts",
+      "INTERRUPTS(1)            MiniOS Manual            INTERRUPTS(1)\n\n"
+      "NAME\n    interrupts - show IRQ statistics\n\n"
+      "SYNOPSIS\n    interrupts\n\n"
+      "DESCRIPTION\n    Display interrupt request statistics.\n\n"
+      "EXAMPLES\n    interrupts    Show IRQ stats\n" },
+    { "kill",
+      "KILL(1)                  MiniOS Manual                  KILL(1)\n\n"
+      "NAME\n    kill - send signal to a process\n\n"
+      "SYNOPSIS\n    kill [-s signal | -signal] <pid>\n"
+      "           kill -l\n\n"
+      "DESCRIPTION\n    Send a signal to a process.\n\n"
+      "OPTIONS\n"
+      "    -s SIG   Specify signal to send\n"
+      "    -TERM    Send SIGTERM (same as -s TERM)\n"
+      "    -9       Send SIGKILL\n"
+      "    -l       List available signals\n\n"
+      "EXAMPLES\n    kill 5          Send SIGTERM to PID 5\n"
+      "    kill -9 5       Force kill PID 5\n"
+      "    kill -s HUP 5   Send SIGHUP to PID 5\n" },
+    { "login",
+      "LOGIN(1)                 MiniOS Manual                 LOGIN(1)\n\n"
+      "NAME\n    login - log in as a user\n\n"
+      "SYNOPSIS\n    login <username>\n\n"
+      "DESCRIPTION\n    Log in as the specified user. Prompts for password.\n\n"
+      "EXAMPLES\n    login guest    Log in as guest\n" },
+    { "logout",
+      "LOGOUT(1)                MiniOS Manual                LOGOUT(1)\n\n"
+      "NAME\n    logout - log out current user\n\n"
+      "SYNOPSIS\n    logout\n\n"
+      "DESCRIPTION\n    Log out and return to root user.\n\n"
+      "EXAMPLES\n    logout    Return to root\n" },
+    { "ls",
+      "LS(1)                    MiniOS Manual                    LS(1)\n\n"
+      "NAME\n    ls - list directory contents\n\n"
+      "SYNOPSIS\n    ls [-lahR1] [directory]\n\n"
+      "DESCRIPTION\n    List files and directories.\n\n"
+      "OPTIONS\n"
+      "    -l    Long format (permissions, size, owner)\n"
+      "    -a    Show all files including hidden (dot files)\n"
+      "    -h    Human-readable sizes (K, M, G)\n"
+      "    -R    Recursive listing of subdirectories\n"
+      "    -1    One file per line\n\n"
+      "EXAMPLES\n    ls           List current directory\n"
+      "    ls -la       Long format with hidden files\n"
+      "    ls -lh /home Human-readable listing of /home\n" },
+    { "lscpu",
+      "LSCPU(1)                 MiniOS Manual                 LSCPU(1)\n\n"
+      "NAME\n    lscpu - display CPU information\n\n"
+      "SYNOPSIS\n    lscpu\n\n"
+      "DESCRIPTION\n    Show CPU vendor and feature information via CPUID.\n\n"
+      "EXAMPLES\n    lscpu    Show CPU info\n" },
+    { "man",
+      "MAN(1)                   MiniOS Manual                   MAN(1)\n\n"
+      "NAME\n    man - display command manual\n\n"
+      "SYNOPSIS\n    man <command>\n\n"
+      "DESCRIPTION\n    Display the manual page for a command, including\n"
+      "    usage, description, and examples.\n\n"
+      "EXAMPLES\n    man ls      Show manual for ls\n"
+      "    man chmod   Show manual for chmod\n" },
+    { "mem",
+      "MEM(1)                   MiniOS Manual                   MEM(1)\n\n"
+      "NAME\n    mem - display memory information\n\n"
+      "SYNOPSIS\n    mem\n\n"
+      "DESCRIPTION\n    Show physical memory usage statistics.\n\n"
+      "EXAMPLES\n    mem    Show memory info\n" },
+    { "mkdir",
+      "MKDIR(1)                 MiniOS Manual                 MKDIR(1)\n\n"
+      "NAME\n    mkdir - create directories\n\n"
+      "SYNOPSIS\n    mkdir [-pv] <dirname>\n\n"
+      "DESCRIPTION\n    Create a new directory.\n\n"
+      "OPTIONS\n"
+      "    -p    Create parent directories as needed\n"
+      "    -v    Verbose output\n\n"
+      "EXAMPLES\n    mkdir docs           Create docs directory\n"
+      "    mkdir -p a/b/c       Create nested directories\n" },
+    { "mount",
+      "MOUNT(1)                 MiniOS Manual                 MOUNT(1)\n\n"
+      "NAME\n    mount - mount a filesystem\n\n"
+      "SYNOPSIS\n    mount <device> <mountpoint> <fstype>\n\n"
+      "DESCRIPTION\n    Mount a block device at a directory. Currently\n"
+      "    supports ext2 filesystem type.\n\n"
+      "EXAMPLES\n    mount hd0p1 /mnt ext2    Mount partition 1 at /mnt\n" },
+    { "mv",
+      "MV(1)                    MiniOS Manual                    MV(1)\n\n"
+      "NAME\n    mv - move or rename a file\n\n"
+      "SYNOPSIS\n    mv <source> <destination>\n\n"
+      "DESCRIPTION\n    Rename a file or move it to a new location.\n\n"
+      "EXAMPLES\n    mv old.txt new.txt    Rename old.txt to new.txt\n" },
+    { "nano",
+      "NANO(1)                  MiniOS Manual                  NANO(1)\n\n"
+      "NAME\n    nano - text editor\n\n"
+      "SYNOPSIS\n    nano [filename]\n\n"
+      "DESCRIPTION\n    Full-featured text editor with cut/copy/paste,\n"
+      "    search, and file save/load capabilities.\n\n"
+      "KEYS\n    Ctrl+O: Save   Ctrl+X: Exit   Ctrl+K: Cut line\n"
+      "    Ctrl+U: Paste  Ctrl+W: Search Ctrl+G: Go to line\n\n"
+      "EXAMPLES\n    nano              New file\n"
+      "    nano file.txt     Edit file.txt\n" },
+    { "nice",
+      "NICE(1)                  MiniOS Manual                  NICE(1)\n\n"
+      "NAME\n    nice - show or set process priority\n\n"
+      "SYNOPSIS\n    nice [pid] [priority]\n\n"
+      "DESCRIPTION\n    Display or modify process scheduling priority.\n\n"
+      "EXAMPLES\n    nice         Show current priority\n"
+      "    nice 5 10   Set PID 5 priority to 10\n" },
+    { "pages",
+      "PAGES(1)                 MiniOS Manual                 PAGES(1)\n\n"
+      "NAME\n    pages - show page table information\n\n"
+      "SYNOPSIS\n    pages\n\n"
+      "DESCRIPTION\n    Display paging and virtual memory information.\n\n"
+      "EXAMPLES\n    pages    Show page tables\n" },
+    { "passwd",
+      "PASSWD(1)                MiniOS Manual                PASSWD(1)\n\n"
+      "NAME\n    passwd - change user password\n\n"
+      "SYNOPSIS\n    passwd [username]\n\n"
+      "DESCRIPTION\n    Change password for current user or specified user\n"
+      "    (root only for other users).\n\n"
+      "EXAMPLES\n    passwd         Change own password\n"
+      "    passwd guest  Change guest's password (root)\n" },
+    { "peek",
+      "PEEK(1)                  MiniOS Manual                  PEEK(1)\n\n"
+      "NAME\n    peek - read memory address\n\n"
+      "SYNOPSIS\n    peek <address>\n\n"
+      "DESCRIPTION\n    Read and display value at memory address (hex).\n\n"
+      "EXAMPLES\n    peek 0xB8000    Read VGA memory\n" },
+    { "poke",
+      "POKE(1)                  MiniOS Manual                  POKE(1)\n\n"
+      "NAME\n    poke - write to memory address\n\n"
+      "SYNOPSIS\n    poke <address> <value>\n\n"
+      "DESCRIPTION\n    Write value to memory address. Use with caution!\n\n"
+      "EXAMPLES\n    poke 0xB8000 0x0741    Write 'A' to VGA\n" },
+    { "progs",
+      "PROGS(1)                 MiniOS Manual                 PROGS(1)\n\n"
+      "NAME\n    progs - list available programs\n\n"
+      "SYNOPSIS\n    progs\n\n"
+      "DESCRIPTION\n    Display a list of all available programs.\n\n"
+      "EXAMPLES\n    progs    List programs\n" },
+    { "ps",
+      "PS(1)                    MiniOS Manual                    PS(1)\n\n"
+      "NAME\n    ps - list running processes\n\n"
+      "SYNOPSIS\n    ps [-ale]\n\n"
+      "DESCRIPTION\n    Display a list of running processes.\n\n"
+      "OPTIONS\n"
+      "    -a    Show all processes\n"
+      "    -l    Long format (PID, PPID, UID, state, etc.)\n"
+      "    -e    Extended information\n\n"
+      "EXAMPLES\n    ps       Show all processes\n"
+      "    ps -l    Long format listing\n" },
+    { "pwd",
+      "PWD(1)                   MiniOS Manual                   PWD(1)\n\n"
+      "NAME\n    pwd - print working directory\n\n"
+      "SYNOPSIS\n    pwd\n\n"
+      "DESCRIPTION\n    Display the current working directory path.\n\n"
+      "EXAMPLES\n    pwd    Shows: /home/user\n" },
+    { "reboot",
+      "REBOOT(1)                MiniOS Manual                REBOOT(1)\n\n"
+      "NAME\n    reboot - restart the system\n\n"
+      "SYNOPSIS\n    reboot\n\n"
+      "DESCRIPTION\n    Restart the computer. Use with caution.\n\n"
+      "EXAMPLES\n    reboot    Restart system\n" },
+    { "regs",
+      "REGS(1)                  MiniOS Manual                  REGS(1)\n\n"
+      "NAME\n    regs - display CPU registers\n\n"
+      "SYNOPSIS\n    regs\n\n"
+      "DESCRIPTION\n    Show current CPU register values.\n\n"
+      "EXAMPLES\n    regs    Show registers\n" },
+    { "rev",
+      "REV(1)                   MiniOS Manual                   REV(1)\n\n"
+      "NAME\n    rev - reverse lines of a file\n\n"
+      "SYNOPSIS\n    rev <filename>\n\n"
+      "DESCRIPTION\n    Read a file and output each line with characters\n"
+      "    reversed. Useful for text manipulation.\n\n"
+      "EXAMPLES\n    rev file.txt    Reverse each line\n"
+      "    (hello -> olleh)\n" },
+    { "rm",
+      "RM(1)                    MiniOS Manual                    RM(1)\n\n"
+      "NAME\n    rm - remove files and directories\n\n"
+      "SYNOPSIS\n    rm [-rfv] <filename>\n\n"
+      "DESCRIPTION\n    Delete files and directories.\n\n"
+      "OPTIONS\n"
+      "    -r    Recursive (remove directories and contents)\n"
+      "    -f    Force (ignore nonexistent files, no prompts)\n"
+      "    -v    Verbose (print each file removed)\n\n"
+      "EXAMPLES\n    rm file.txt        Delete file.txt\n"
+      "    rm -rf dir/        Remove directory and contents\n" },
+    { "rmdir",
+      "RMDIR(1)                 MiniOS Manual                 RMDIR(1)\n\n"
+      "NAME\n    rmdir - remove an empty directory\n\n"
+      "SYNOPSIS\n    rmdir <dirname>\n\n"
+      "DESCRIPTION\n    Remove an empty directory.\n\n"
+      "EXAMPLES\n    rmdir olddir    Remove olddir directory\n" },
+    { "run",
+      "RUN(1)                   MiniOS Manual                   RUN(1)\n\n"
+      "NAME\n    run - execute a program\n\n"
+      "SYNOPSIS\n    run <program>\n\n"
+      "DESCRIPTION\n    Execute a built-in program by name.\n\n"
+      "EXAMPLES\n    run hello    Run the hello program\n" },
+    { "seq",
+      "SEQ(1)                   MiniOS Manual                   SEQ(1)\n\n"
+      "NAME\n    seq - print a sequence of numbers\n\n"
+      "SYNOPSIS\n    seq [start] [step] end\n\n"
+      "DESCRIPTION\n    Print numbers from start to end. Default start is 1,\n"
+      "    default step is 1. Negative step counts down.\n\n"
+      "EXAMPLES\n    seq 5           Print 1 2 3 4 5\n"
+      "    seq 2 5         Print 2 3 4 5\n"
+      "    seq 1 2 10      Print 1 3 5 7 9 (step 2)\n"
+      "    seq 10 -1 1     Print 10 9 8 ... 1\n" },
+    { "service",
+      "SERVICE(1)               MiniOS Manual               SERVICE(1)\n\n"
+      "NAME\n    service - manage system services\n\n"
+      "SYNOPSIS\n    service <name> [action]\n\n"
+      "DESCRIPTION\n    Start, stop, restart, or check status of daemons.\n"
+      "    Actions: start, stop, restart, status (default)\n\n"
+      "EXAMPLES\n    service klogd status   Check klogd status\n"
+      "    service crond restart  Restart crond\n" },
+    { "set",
+      "SET(1)                   MiniOS Manual                   SET(1)\n\n"
+      "NAME\n    set - show or set shell options\n\n"
+      "SYNOPSIS\n    set [option]\n\n"
+      "DESCRIPTION\n    Display or modify shell options.\n\n"
+      "EXAMPLES\n    set    Show options\n" },
+    { "sh",
+      "SH(1)                    MiniOS Manual                    SH(1)\n\n"
+      "NAME\n    sh - run a pre-parsed command script\n\n"
+      "SYNOPSIS\n    sh <script>\n\n"
+      "DESCRIPTION\n    Parse a command file once into resolved handlers,\n"
+      "    then execute it. Lines hold shell builtins; # starts a\n"
+      "    comment. `repeat N ... end` runs the enclosed commands N\n"
+      "    times (loops may nest) with no re-parsing per iteration.\n"
+      "    Unknown commands are reported with their line number\n"
+      "    before anything runs.\n\n"
+      "EXAMPLES\n    sh /mnt/provision     Run a provisioning script\n"
+      "    repeat 100            Loop body 100 times\n" },
+    { "sleep",
+      "SLEEP(1)                 MiniOS Manual                 SLEEP(1)\n\n"
+      "NAME\n    sleep - pause for specified seconds\n\n"
+      "SYNOPSIS\n    sleep <seconds>\n\n"
+      "DESCRIPTION\n    Pause execution for the specified number of seconds.\n\n"
+      "EXAMPLES\n    sleep 5    Pause for 5 seconds\n" },
+    { "sort",
+      "SORT(1)                  MiniOS Manual                  SORT(1)\n\n"
+      "NAME\n    sort - sort lines of text files\n\n"
+      "SYNOPSIS\n    sort [-rnuf] [file]\n\n"
+      "DESCRIPTION\n    Read input and output lines in sorted order.\n\n"
+      "OPTIONS\n"
+      "    -r    Reverse sort order\n"
+      "    -n    Numeric sort (compare as numbers)\n"
+      "    -u    Unique (remove duplicate lines)\n"
+      "    -f    Case-insensitive sorting\n\n"
+      "EXAMPLES\n    sort names.txt       Sort alphabetically\n"
+      "    sort -r names.txt   Reverse order\n"
+      "    sort -n numbers.txt Sort numerically\n"
+      "    ls | sort -u        Unique sorted listing\n" },
+    { "spreadsheet",
+      "SPREADSHEET(1)           MiniOS Manual           SPREADSHEET(1)\n\n"
+      "NAME\n    spreadsheet - spreadsheet application\n\n"
+      "SYNOPSIS\n    spreadsheet [file.csv]\n\n"
+      "DESCRIPTION\n    Full-featured spreadsheet with formulas.\n"
+      "    Arrows: Navigate  Enter: Edit cell  ESC: Exit\n"
+      "    F2: Save  F3: Load  F5: Clear all\n\n"
+      "FORMULAS\n    =A1+B1  =A1*2  =SUM(A1:A10)\n\n"
+      "EXAMPLES\n    spreadsheet           New spreadsheet\n"
+      "    spreadsheet data.csv  Open file\n" },
+    { "stack",
+      "STACK(1)                 MiniOS Manual                 STACK(1)\n\n"
+      "NAME\n    stack - show stack trace\n\n"
+      "SYNOPSIS\n    stack\n\n"
+      "DESCRIPTION\n    Display current stack with return addresses.\n\n"
+      "EXAMPLES\n    stack    Show stack trace\n" },
+    { "stat",
+      "STAT(1)                  MiniOS Manual                  STAT(1)\n\n"
+      "NAME\n    stat - display file information\n\n"
+      "SYNOPSIS\n    stat <filename>\n\n"
+      "DESCRIPTION\n    Show detailed information about a file including\n"
+      "    size, type, and inode number.\n\n"
+      "EXAMPLES\n    stat file.txt    Show info about file.txt\n" },
+    { "strings",
+      "STRINGS(1)               MiniOS Manual               STRINGS(1)\n\n"
+      "NAME\n    strings - print printable strings from file\n\n"
+      "SYNOPSIS\n    strings <file>\n\n"
+      "DESCRIPTION\n    Extract and display printable strings from a file.\n\n"
+      "EXAMPLES\n    strings binary    Find text in binary file\n" },
+    { "su",
+      "SU(1)                    MiniOS Manual                    SU(1)\n\n"
+      "NAME\n    su - switch user\n\n"
+      "SYNOPSIS\n    su <username>\n\n"
+      "DESCRIPTION\n    Switch to another user account.\n\n"
+      "EXAMPLES\n    su guest    Switch to guest user\n" },
+    { "tail",
+      "TAIL(1)                  MiniOS Manual                  TAIL(1)\n\n"
+      "NAME\n    tail - display last lines of a file\n\n"
+      "SYNOPSIS\n    tail [-n lines] <file>\n\n"
+      "DESCRIPTION\n    Display the last N lines of a file (default 10).\n\n"
+      "EXAMPLES\n    tail file.txt       Last 10 lines\n"
+      "    tail -n 5 file.txt  Last 5 lines\n" },
+    { "time",
+      "TIME(1)                  MiniOS Manual                  TIME(1)\n\n"
+      "NAME\n    time - time command execution\n\n"
+      "SYNOPSIS\n    time <command> [args...]\n\n"
+      "DESCRIPTION\n    Execute a command and report how long it took.\n"
+      "    Shows elapsed time in seconds and milliseconds.\n\n"
+      "EXAMPLES\n    time sleep 2       Time a 2-second sleep\n"
+      "    time find /        Time a recursive find\n"
+      "    time cat bigfile   Time reading a large file\n" },
+    { "top",
+      "TOP(1)                   MiniOS Manual                   TOP(1)\n\n"
+      "NAME\n    top - display process statistics\n\n"
+      "SYNOPSIS\n    top\n\n"
+      "DESCRIPTION\n    Show process statistics including PID, name, state,\n"
+      "    and CPU ticks used.\n\n"
+      "EXAMPLES\n    top    Show process stats\n" },
+    { "touch",
+      "TOUCH(1)                 MiniOS Manual                 TOUCH(1)\n\n"
+      "NAME\n    touch - create an empty file\n\n"
+      "SYNOPSIS\n    touch <filename>\n\n"
+      "DESCRIPTION\n    Create a new empty file in the current directory.\n\n"
+      "EXAMPLES\n    touch newfile.txt    Create newfile.txt\n" },
+    { "type",
+      "TYPE(1)                  MiniOS Manual                  TYPE(1)\n\n"
+      "NAME\n    type - display command type\n\n"
+      "SYNOPSIS\n    type <command>\n\n"
+      "DESCRIPTION\n    Show the type of a command: shell builtin, external\n"
+      "    program, or alias.\n\n"
+      "EXAMPLES\n    type echo     Shows: echo is a shell builtin\n"
+      "    type shell    Shows: shell is /bin/shell\n" },
+    { "uname",
+      "UNAME(1)                 MiniOS Manual                 UNAME(1)\n\n"
+      "NAME\n    uname - print system information\n\n"
+      "SYNOPSIS\n    uname\n\n"
+      "DESCRIPTION\n    Display system name and version information.\n\n"
+      "EXAMPLES\n    uname    Show system info\n" },
+    { "uptime",
+      "UPTIME(1)                MiniOS Manual                UPTIME(1)\n\n"
+      "NAME\n    uptime - show system uptime\n\n"
+      "SYNOPSIS\n    uptime\n\n"
+      "DESCRIPTION\n    Display how long the system has been running.\n\n"
+      "EXAMPLES\n    uptime    Show uptime\n" },
+    { "useradd",
+      "USERADD(1)               MiniOS Manual               USERADD(1)\n\n"
+      "NAME\n    useradd - create a new user\n\n"
+      "SYNOPSIS\n    useradd <username> [uid] [gid]\n\n"
+      "DESCRIPTION\n    Create a new user account with home directory.\n"
+      "    Default password is the username. Root only.\n\n"
+      "EXAMPLES\n    useradd bob         Create user bob\n"
+      "    useradd bob 1002   Create bob with UID 1002\n" },
+    { "userdel",
+      "USERDEL(1)               MiniOS Manual               USERDEL(1)\n\n"
+      "NAME\n    userdel - delete a user\n\n"
+      "SYNOPSIS\n    userdel <username>\n\n"
+      "DESCRIPTION\n    Remove a user account. Root only.\n\n"
+      "EXAMPLES\n    userdel bob    Delete user bob\n" },
+    { "version",
+      "VERSION(1)               MiniOS Manual               VERSION(1)\n\n"
+      "NAME\n    version - show MiniOS version\n\n"
+      "SYNOPSIS\n    version\n\n"
+      "DESCRIPTION\n    Display MiniOS version information.\n\n"
+      "EXAMPLES\n    version    Show version\n" },
+    { "wc",
+      "WC(1)                    MiniOS Manual                    WC(1)\n\n"
+      "NAME\n    wc - word, line, and byte count\n\n"
+      "SYNOPSIS\n    wc [-lwc] <file>\n\n"
+      "DESCRIPTION\n    Count lines, words, and bytes in a file.\n\n"
+      "OPTIONS\n"
+      "    -l    Print line count only\n"
+      "    -w    Print word count only\n"
+      "    -c    Print byte count only\n\n"
+      "EXAMPLES\n    wc file.txt     Show all counts\n"
+      "    wc -l file.txt  Show line count only\n"
+      "    ls | wc -l      Count files in directory\n" },
+    { "which",
+      "WHICH(1)                 MiniOS Manual                 WHICH(1)\n\n"
+      "NAME\n    which - locate a command\n\n"
+      "SYNOPSIS\n    which <command>\n\n"
+      "DESCRIPTION\n    Show whether a command is a shell built-in or an\n"
+      "    external program in /bin. Displays the path if found.\n\n"
+      "EXAMPLES\n    which ls       Shows: ls: shell built-in\n"
+      "    which shell    Shows: /bin/shell\n" },
+    { "whoami",
+      "WHOAMI(1)                MiniOS Manual                WHOAMI(1)\n\n"
+      "NAME\n    whoami - print current username\n\n"
+      "SYNOPSIS\n    whoami\n\n"
+      "DESCRIPTION\n    Display the username of the current user.\n\n"
+      "EXAMPLES\n    whoami    Shows: root\n" },
+    { "write",
+      "WRITE(1)                 MiniOS Manual                 WRITE(1)\n\n"
+      "NAME\n    write - write text to a file\n\n"
+      "SYNOPSIS\n    write <filename> <text...>\n\n"
+      "DESCRIPTION\n    Append text to a file. Creates the file if needed.\n\n"
+      "EXAMPLES\n    write file.txt Hello World\n" },
+    { "xxd",
+      "XXD(1)                   MiniOS Manual                   XXD(1)\n\n"
+      "NAME\n    xxd - hex dump with ASCII display\n\n"
+      "SYNOPSIS\n    xxd <file>\n\n"
+      "DESCRIPTION\n    Display file in hex with ASCII representation.\n\n"
+      "EXAMPLES\n    xxd file.bin    Hex+ASCII dump\n" },
+};
+
+#define MAN_PAGE_COUNT (sizeof(man_pages) / sizeof(man_pages[0]))
+
+/*
+ * Binary search the page index
+ */
+static const man_page_t* man_lookup(const char* name) {
+    int lo = 0;
+    int hi = (int)MAN_PAGE_COUNT - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = strcmp(name, man_pages[mid].name);
+        if (cmp == 0) return &man_pages[mid];
+        if (cmp < 0) hi = mid - 1;
+        else lo = mid + 1;
+    }
+    return NULL;
+}
+
+/*
+ * One-line summary of a page: the line after the NAME heading
+ */
+static void man_summary(const man_page_t* page, char* out, size_t size) {
+    const char* p = page->text;
+    out[0] = '\0';
+    while (*p != '\0') {
+        if (strncmp(p, "NAME\n", 5) == 0) {
+            p += 5;
+            while (*p == ' ') p++;
+            size_t n = 0;
+            while (p[n] != '\0' && p[n] != '\n' && n + 1 < size) {
+                out[n] = p[n];
+                n++;
+            }
+            out[n] = '\0';
+            return;
+        }
+        p++;
+    }
+}
+
 static int cmd_man(int argc, char* argv[]) {
     if (argc < 2) {
         vga_puts("Usage: man <command>\n");
@@ -3607,693 +5533,42 @@ static int cmd_man(int argc, char* argv[]) {
         return 0;
     }
 
-    const char* cmd = argv[1];
-
-    /* File System Commands */
-    if (strcmp(cmd, "ls") == 0) {
-        vga_puts("LS(1)                    MiniOS Manual                    LS(1)\n\n");
-        vga_puts("NAME\n    ls - list directory contents\n\n");
-        vga_puts("SYNOPSIS\n    ls [-lahR1] [directory]\n\n");
-        vga_puts("DESCRIPTION\n    List files and directories.\n\n");
-        vga_puts("OPTIONS\n");
-        vga_puts("    -l    Long format (permissions, size, owner)\n");
-        vga_puts("    -a    Show all files including hidden (dot files)\n");
-        vga_puts("    -h    Human-readable sizes (K, M, G)\n");
-        vga_puts("    -R    Recursive listing of subdirectories\n");
-        vga_puts("    -1    One file per line\n\n");
-        vga_puts("EXAMPLES\n    ls           List current directory\n");
-        vga_puts("    ls -la       Long format with hidden files\n");
-        vga_puts("    ls -lh /home Human-readable listing of /home\n");
-    } else if (strcmp(cmd, "cat") == 0) {
-        vga_puts("CAT(1)                   MiniOS Manual                   CAT(1)\n\n");
-        vga_puts("NAME\n    cat - concatenate and display files\n\n");
-        vga_puts("SYNOPSIS\n    cat [-nb] <filename>\n\n");
-        vga_puts("DESCRIPTION\n    Display the contents of a file to the terminal.\n\n");
-        vga_puts("OPTIONS\n");
-        vga_puts("    -n    Number all output lines\n");
-        vga_puts("    -b    Number non-empty lines only\n\n");
-        vga_puts("EXAMPLES\n    cat file.txt      Display contents\n");
-        vga_puts("    cat -n file.txt   Display with line numbers\n");
-    } else if (strcmp(cmd, "touch") == 0) {
-        vga_puts("TOUCH(1)                 MiniOS Manual                 TOUCH(1)\n\n");
-        vga_puts("NAME\n    touch - create an empty file\n\n");
-        vga_puts("SYNOPSIS\n    touch <filename>\n\n");
-        vga_puts("DESCRIPTION\n    Create a new empty file in the current directory.\n\n");
-        vga_puts("EXAMPLES\n    touch newfile.txt    Create newfile.txt\n");
-    } else if (strcmp(cmd, "write") == 0) {
-        vga_puts("WRITE(1)                 MiniOS Manual                 WRITE(1)\n\n");
-        vga_puts("NAME\n    write - write text to a file\n\n");
-        vga_puts("SYNOPSIS\n    write <filename> <text...>\n\n");
-        vga_puts("DESCRIPTION\n    Append text to a file. Creates the file if needed.\n\n");
-        vga_puts("EXAMPLES\n    write file.txt Hello World\n");
-    } else if (strcmp(cmd, "mkdir") == 0) {
-        vga_puts("MKDIR(1)                 MiniOS Manual                 MKDIR(1)\n\n");
-        vga_puts("NAME\n    mkdir - create directories\n\n");
-        vga_puts("SYNOPSIS\n    mkdir [-pv] <dirname>\n\n");
-        vga_puts("DESCRIPTION\n    Create a new directory.\n\n");
-        vga_puts("OPTIONS\n");
-        vga_puts("    -p    Create parent directories as needed\n");
-        vga_puts("    -v    Verbose output\n\n");
-        vga_puts("EXAMPLES\n    mkdir docs           Create docs directory\n");
-        vga_puts("    mkdir -p a/b/c       Create nested directories\n");
-    } else if (strcmp(cmd, "rmdir") == 0) {
-        vga_puts("RMDIR(1)                 MiniOS Manual                 RMDIR(1)\n\n");
-        vga_puts("NAME\n    rmdir - remove an empty directory\n\n");
-        vga_puts("SYNOPSIS\n    rmdir <dirname>\n\n");
-        vga_puts("DESCRIPTION\n    Remove an empty directory.\n\n");
-        vga_puts("EXAMPLES\n    rmdir olddir    Remove olddir directory\n");
-    } else if (strcmp(cmd, "rm") == 0) {
-        vga_puts("RM(1)                    MiniOS Manual                    RM(1)\n\n");
-        vga_puts("NAME\n    rm - remove files and directories\n\n");
-        vga_puts("SYNOPSIS\n    rm [-rfv] <filename>\n\n");
-        vga_puts("DESCRIPTION\n    Delete files and directories.\n\n");
-        vga_puts("OPTIONS\n");
-        vga_puts("    -r    Recursive (remove directories and contents)\n");
-        vga_puts("    -f    Force (ignore nonexistent files, no prompts)\n");
-        vga_puts("    -v    Verbose (print each file removed)\n\n");
-        vga_puts("EXAMPLES\n    rm file.txt        Delete file.txt\n");
-        vga_puts("    rm -rf dir/        Remove directory and contents\n");
-    } else if (strcmp(cmd, "cp") == 0) {
-        vga_puts("CP(1)                    MiniOS Manual                    CP(1)\n\n");
-        vga_puts("NAME\n    cp - copy files and directories\n\n");
-        vga_puts("SYNOPSIS\n    cp [-rv] <source> <destination>\n\n");
-        vga_puts("DESCRIPTION\n    Copy files and directories.\n\n");
-        vga_puts("OPTIONS\n");
-        vga_puts("    -r    Recursive (copy directories)\n");
-        vga_puts("    -v    Verbose (show files being copied)\n\n");
-        vga_puts("EXAMPLES\n    cp file.txt backup.txt  Copy a file\n");
-        vga_puts("    cp -r src/ dest/       Copy directory recursively\n");
-    } else if (strcmp(cmd, "mv") == 0) {
-        vga_puts("MV(1)                    MiniOS Manual                    MV(1)\n\n");
-        vga_puts("NAME\n    mv - move or rename a file\n\n");
-        vga_puts("SYNOPSIS\n    mv <source> <destination>\n\n");
-        vga_puts("DESCRIPTION\n    Rename a file or move it to a new location.\n\n");
-        vga_puts("EXAMPLES\n    mv old.txt new.txt    Rename old.txt to new.txt\n");
-    } else if (strcmp(cmd, "pwd") == 0) {
-        vga_puts("PWD(1)                   MiniOS Manual                   PWD(1)\n\n");
-        vga_puts("NAME\n    pwd - print working directory\n\n");
-        vga_puts("SYNOPSIS\n    pwd\n\n");
-        vga_puts("DESCRIPTION\n    Display the current working directory path.\n\n");
-        vga_puts("EXAMPLES\n    pwd    Shows: /home/user\n");
-    } else if (strcmp(cmd, "cd") == 0) {
-        vga_puts("CD(1)                    MiniOS Manual                    CD(1)\n\n");
-        vga_puts("NAME\n    cd - change directory\n\n");
-        vga_puts("SYNOPSIS\n    cd [directory]\n\n");
-        vga_puts("DESCRIPTION\n    Change the current working directory.\n");
-        vga_puts("    Without arguments, changes to root (/).\n\n");
-        vga_puts("EXAMPLES\n    cd /home      Go to /home\n");
-        vga_puts("    cd ..        Go to parent directory\n");
-        vga_puts("    cd           Go to root\n");
-    } else if (strcmp(cmd, "stat") == 0) {
-        vga_puts("STAT(1)                  MiniOS Manual                  STAT(1)\n\n");
-        vga_puts("NAME\n    stat - display file information\n\n");
-        vga_puts("SYNOPSIS\n    stat <filename>\n\n");
-        vga_puts("DESCRIPTION\n    Show detailed information about a file including\n");
-        vga_puts("    size, type, and inode number.\n\n");
-        vga_puts("EXAMPLES\n    stat file.txt    Show info about file.txt\n");
-    } else if (strcmp(cmd, "head") == 0) {
-        vga_puts("HEAD(1)                  MiniOS Manual                  HEAD(1)\n\n");
-        vga_puts("NAME\n    head - display first lines of a file\n\n");
-        vga_puts("SYNOPSIS\n    head [-n lines] <file>\n\n");
-        vga_puts("DESCRIPTION\n    Display the first N lines of a file (default 10).\n\n");
-        vga_puts("EXAMPLES\n    head file.txt       First 10 lines\n");
-        vga_puts("    head -n 5 file.txt  First 5 lines\n");
-    } else if (strcmp(cmd, "tail") == 0) {
-        vga_puts("TAIL(1)                  MiniOS Manual                  TAIL(1)\n\n");
-        vga_puts("NAME\n    tail - display last lines of a file\n\n");
-        vga_puts("SYNOPSIS\n    tail [-n lines] <file>\n\n");
-        vga_puts("DESCRIPTION\n    Display the last N lines of a file (default 10).\n\n");
-        vga_puts("EXAMPLES\n    tail file.txt       Last 10 lines\n");
-        vga_puts("    tail -n 5 file.txt  Last 5 lines\n");
-    } else if (strcmp(cmd, "wc") == 0) {
-        vga_puts("WC(1)                    MiniOS Manual                    WC(1)\n\n");
-        vga_puts("NAME\n    wc - word, line, and byte count\n\n");
-        vga_puts("SYNOPSIS\n    wc [-lwc] <file>\n\n");
-        vga_puts("DESCRIPTION\n    Count lines, words, and bytes in a file.\n\n");
-        vga_puts("OPTIONS\n");
-        vga_puts("    -l    Print line count only\n");
-        vga_puts("    -w    Print word count only\n");
-        vga_puts("    -c    Print byte count only\n\n");
-        vga_puts("EXAMPLES\n    wc file.txt     Show all counts\n");
-        vga_puts("    wc -l file.txt  Show line count only\n");
-        vga_puts("    ls | wc -l      Count files in directory\n");
-    } else if (strcmp(cmd, "hexdump") == 0) {
-        vga_puts("HEXDUMP(1)               MiniOS Manual               HEXDUMP(1)\n\n");
-        vga_puts("NAME\n    hexdump - display file in hexadecimal\n\n");
-        vga_puts("SYNOPSIS\n    hexdump <file>\n\n");
-        vga_puts("DESCRIPTION\n    Display file contents in hexadecimal format.\n\n");
-        vga_puts("EXAMPLES\n    hexdump binary.bin    Hex dump of binary.bin\n");
-    } else if (strcmp(cmd, "xxd") == 0) {
-        vga_puts("XXD(1)                   MiniOS Manual                   XXD(1)\n\n");
-        vga_puts("NAME\n    xxd - hex dump with ASCII display\n\n");
-        vga_puts("SYNOPSIS\n    xxd <file>\n\n");
-        vga_puts("DESCRIPTION\n    Display file in hex with ASCII representation.\n\n");
-        vga_puts("EXAMPLES\n    xxd file.bin    Hex+ASCII dump\n");
-    } else if (strcmp(cmd, "strings") == 0) {
-        vga_puts("STRINGS(1)               MiniOS Manual               STRINGS(1)\n\n");
-        vga_puts("NAME\n    strings - print printable strings from file\n\n");
-        vga_puts("SYNOPSIS\n    strings <file>\n\n");
-        vga_puts("DESCRIPTION\n    Extract and display printable strings from a file.\n\n");
-        vga_puts("EXAMPLES\n    strings binary    Find text in binary file\n");
-    /* Process Commands */
-    } else if (strcmp(cmd, "ps") == 0) {
-        vga_puts("PS(1)                    MiniOS Manual                    PS(1)\n\n");
-        vga_puts("NAME\n    ps - list running processes\n\n");
-        vga_puts("SYNOPSIS\n    ps [-ale]\n\n");
-        vga_puts("DESCRIPTION\n    Display a list of running processes.\n\n");
-        vga_puts("OPTIONS\n");
-        vga_puts("    -a    Show all processes\n");
-        vga_puts("    -l    Long format (PID, PPID, UID, state, etc.)\n");
-        vga_puts("    -e    Extended information\n\n");
-        vga_puts("EXAMPLES\n    ps       Show all processes\n");
-        vga_puts("    ps -l    Long format listing\n");
-    } else if (strcmp(cmd, "kill") == 0) {
-        vga_puts("KILL(1)                  MiniOS Manual                  KILL(1)\n\n");
-        vga_puts("NAME\n    kill - send signal to a process\n\n");
-        vga_puts("SYNOPSIS\n    kill [-s signal | -signal] <pid>\n");
-        vga_puts("           kill -l\n\n");
-        vga_puts("DESCRIPTION\n    Send a signal to a process.\n\n");
-        vga_puts("OPTIONS\n");
-        vga_puts("    -s SIG   Specify signal to send\n");
-        vga_puts("    -TERM    Send SIGTERM (same as -s TERM)\n");
-        vga_puts("    -9       Send SIGKILL\n");
-        vga_puts("    -l       List available signals\n\n");
-        vga_puts("EXAMPLES\n    kill 5          Send SIGTERM to PID 5\n");
-        vga_puts("    kill -9 5       Force kill PID 5\n");
-        vga_puts("    kill -s HUP 5   Send SIGHUP to PID 5\n");
-    } else if (strcmp(cmd, "sleep") == 0) {
-        vga_puts("SLEEP(1)                 MiniOS Manual                 SLEEP(1)\n\n");
-        vga_puts("NAME\n    sleep - pause for specified seconds\n\n");
-        vga_puts("SYNOPSIS\n    sleep <seconds>\n\n");
-        vga_puts("DESCRIPTION\n    Pause execution for the specified number of seconds.\n\n");
-        vga_puts("EXAMPLES\n    sleep 5    Pause for 5 seconds\n");
-    } else if (strcmp(cmd, "top") == 0) {
-        vga_puts("TOP(1)                   MiniOS Manual                   TOP(1)\n\n");
-        vga_puts("NAME\n    top - display process statistics\n\n");
-        vga_puts("SYNOPSIS\n    top\n\n");
-        vga_puts("DESCRIPTION\n    Show process statistics including PID, name, state,\n");
-        vga_puts("    and CPU ticks used.\n\n");
-        vga_puts("EXAMPLES\n    top    Show process stats\n");
-    } else if (strcmp(cmd, "nice") == 0) {
-        vga_puts("NICE(1)                  MiniOS Manual                  NICE(1)\n\n");
-        vga_puts("NAME\n    nice - show or set process priority\n\n");
-        vga_puts("SYNOPSIS\n    nice [pid] [priority]\n\n");
-        vga_puts("DESCRIPTION\n    Display or modify process scheduling priority.\n\n");
-        vga_puts("EXAMPLES\n    nice         Show current priority\n");
-        vga_puts("    nice 5 10   Set PID 5 priority to 10\n");
-    } else if (strcmp(cmd, "run") == 0) {
-        vga_puts("RUN(1)                   MiniOS Manual                   RUN(1)\n\n");
-        vga_puts("NAME\n    run - execute a program\n\n");
-        vga_puts("SYNOPSIS\n    run <program>\n\n");
-        vga_puts("DESCRIPTION\n    Execute a built-in program by name.\n\n");
-        vga_puts("EXAMPLES\n    run hello    Run the hello program\n");
-    } else if (strcmp(cmd, "progs") == 0) {
-        vga_puts("PROGS(1)                 MiniOS Manual                 PROGS(1)\n\n");
-        vga_puts("NAME\n    progs - list available programs\n\n");
-        vga_puts("SYNOPSIS\n    progs\n\n");
-        vga_puts("DESCRIPTION\n    Display a list of all available programs.\n\n");
-        vga_puts("EXAMPLES\n    progs    List programs\n");
-    /* System Commands */
-    } else if (strcmp(cmd, "mem") == 0) {
-        vga_puts("MEM(1)                   MiniOS Manual                   MEM(1)\n\n");
-        vga_puts("NAME\n    mem - display memory information\n\n");
-        vga_puts("SYNOPSIS\n    mem\n\n");
-        vga_puts("DESCRIPTION\n    Show physical memory usage statistics.\n\n");
-        vga_puts("EXAMPLES\n    mem    Show memory info\n");
-    } else if (strcmp(cmd, "free") == 0) {
-        vga_puts("FREE(1)                  MiniOS Manual                  FREE(1)\n\n");
-        vga_puts("NAME\n    free - display memory usage\n\n");
-        vga_puts("SYNOPSIS\n    free\n\n");
-        vga_puts("DESCRIPTION\n    Show detailed memory usage including heap stats.\n\n");
-        vga_puts("EXAMPLES\n    free    Show memory usage\n");
-    } else if (strcmp(cmd, "uptime") == 0) {
-        vga_puts("UPTIME(1)                MiniOS Manual                UPTIME(1)\n\n");
-        vga_puts("NAME\n    uptime - show system uptime\n\n");
-        vga_puts("SYNOPSIS\n    uptime\n\n");
-        vga_puts("DESCRIPTION\n    Display how long the system has been running.\n\n");
-        vga_puts("EXAMPLES\n    uptime    Show uptime\n");
-    } else if (strcmp(cmd, "uname") == 0) {
-        vga_puts("UNAME(1)                 MiniOS Manual                 UNAME(1)\n\n");
-        vga_puts("NAME\n    uname - print system information\n\n");
-        vga_puts("SYNOPSIS\n    uname\n\n");
-        vga_puts("DESCRIPTION\n    Display system name and version information.\n\n");
-        vga_puts("EXAMPLES\n    uname    Show system info\n");
-    } else if (strcmp(cmd, "date") == 0) {
-        vga_puts("DATE(1)                  MiniOS Manual                  DATE(1)\n\n");
-        vga_puts("NAME\n    date - display date and time\n\n");
-        vga_puts("SYNOPSIS\n    date\n\n");
-        vga_puts("DESCRIPTION\n    Show current system uptime as date/time.\n\n");
-        vga_puts("EXAMPLES\n    date    Show date/time\n");
-    } else if (strcmp(cmd, "hostname") == 0) {
-        vga_puts("HOSTNAME(1)              MiniOS Manual              HOSTNAME(1)\n\n");
-        vga_puts("NAME\n    hostname - show system hostname\n\n");
-        vga_puts("SYNOPSIS\n    hostname\n\n");
-        vga_puts("DESCRIPTION\n    Display the system's hostname.\n\n");
-        vga_puts("EXAMPLES\n    hostname    Show hostname\n");
-    } else if (strcmp(cmd, "dmesg") == 0) {
-        vga_puts("DMESG(1)                 MiniOS Manual                 DMESG(1)\n\n");
-        vga_puts("NAME\n    dmesg - print kernel boot messages\n\n");
-        vga_puts("SYNOPSIS\n    dmesg\n\n");
-        vga_puts("DESCRIPTION\n    Display kernel boot and initialization messages.\n\n");
-        vga_puts("EXAMPLES\n    dmesg    Show boot messages\n");
-    } else if (strcmp(cmd, "interrupts") == 0) {
-        vga_puts("INTERRUPTS(1)            MiniOS Manual            INTERRUPTS(1)\n\n");
-        vga_puts("NAME\n    interrupts - show IRQ statistics\n\n");
-        vga_puts("SYNOPSIS\n    interrupts\n\n");
-        vga_puts("DESCRIPTION\n    Display interrupt request statistics.\n\n");
-        vga_puts("EXAMPLES\n    interrupts    Show IRQ stats\n");
-    } else if (strcmp(cmd, "lscpu") == 0) {
-        vga_puts("LSCPU(1)                 MiniOS Manual                 LSCPU(1)\n\n");
-        vga_puts("NAME\n    lscpu - display CPU information\n\n");
-        vga_puts("SYNOPSIS\n    lscpu\n\n");
-        vga_puts("DESCRIPTION\n    Show CPU vendor and feature information via CPUID.\n\n");
-        vga_puts("EXAMPLES\n    lscpu    Show CPU info\n");
-    } else if (strcmp(cmd, "reboot") == 0) {
-        vga_puts("REBOOT(1)                MiniOS Manual                REBOOT(1)\n\n");
-        vga_puts("NAME\n    reboot - restart the system\n\n");
-        vga_puts("SYNOPSIS\n    reboot\n\n");
-        vga_puts("DESCRIPTION\n    Restart the computer. Use with caution.\n\n");
-        vga_puts("EXAMPLES\n    reboot    Restart system\n");
-    /* User Commands */
-    } else if (strcmp(cmd, "login") == 0) {
-        vga_puts("LOGIN(1)                 MiniOS Manual                 LOGIN(1)\n\n");
-        vga_puts("NAME\n    login - log in as a user\n\n");
-        vga_puts("SYNOPSIS\n    login <username>\n\n");
-        vga_puts("DESCRIPTION\n    Log in as the specified user. Prompts for password.\n\n");
-        vga_puts("EXAMPLES\n    login guest    Log in as guest\n");
-    } else if (strcmp(cmd, "logout") == 0) {
-        vga_puts("LOGOUT(1)                MiniOS Manual                LOGOUT(1)\n\n");
-        vga_puts("NAME\n    logout - log out current user\n\n");
-        vga_puts("SYNOPSIS\n    logout\n\n");
-        vga_puts("DESCRIPTION\n    Log out and return to root user.\n\n");
-        vga_puts("EXAMPLES\n    logout    Return to root\n");
-    } else if (strcmp(cmd, "su") == 0) {
-        vga_puts("SU(1)                    MiniOS Manual                    SU(1)\n\n");
-        vga_puts("NAME\n    su - switch user\n\n");
-        vga_puts("SYNOPSIS\n    su <username>\n\n");
-        vga_puts("DESCRIPTION\n    Switch to another user account.\n\n");
-        vga_puts("EXAMPLES\n    su guest    Switch to guest user\n");
-    } else if (strcmp(cmd, "passwd") == 0) {
-        vga_puts("PASSWD(1)                MiniOS Manual                PASSWD(1)\n\n");
-        vga_puts("NAME\n    passwd - change user password\n\n");
-        vga_puts("SYNOPSIS\n    passwd [username]\n\n");
-        vga_puts("DESCRIPTION\n    Change password for current user or specified user\n");
-        vga_puts("    (root only for other users).\n\n");
-        vga_puts("EXAMPLES\n    passwd         Change own password\n");
-        vga_puts("    passwd guest  Change guest's password (root)\n");
-    } else if (strcmp(cmd, "useradd") == 0) {
-        vga_puts("USERADD(1)               MiniOS Manual               USERADD(1)\n\n");
-        vga_puts("NAME\n    useradd - create a new user\n\n");
-        vga_puts("SYNOPSIS\n    useradd <username> [uid] [gid]\n\n");
-        vga_puts("DESCRIPTION\n    Create a new user account with home directory.\n");
-        vga_puts("    Default password is the username. Root only.\n\n");
-        vga_puts("EXAMPLES\n    useradd bob         Create user bob\n");
-        vga_puts("    useradd bob 1002   Create bob with UID 1002\n");
-    } else if (strcmp(cmd, "userdel") == 0) {
-        vga_puts("USERDEL(1)               MiniOS Manual               USERDEL(1)\n\n");
-        vga_puts("NAME\n    userdel - delete a user\n\n");
-        vga_puts("SYNOPSIS\n    userdel <username>\n\n");
-        vga_puts("DESCRIPTION\n    Remove a user account. Root only.\n\n");
-        vga_puts("EXAMPLES\n    userdel bob    Delete user bob\n");
-    } else if (strcmp(cmd, "groupadd") == 0) {
-        vga_puts("GROUPADD(1)              MiniOS Manual              GROUPADD(1)\n\n");
-        vga_puts("NAME\n    groupadd - create a new group\n\n");
-        vga_puts("SYNOPSIS\n    groupadd <groupname> [gid]\n\n");
-        vga_puts("DESCRIPTION\n    Create a new group. Root only.\n\n");
-        vga_puts("EXAMPLES\n    groupadd developers    Create developers group\n");
-    } else if (strcmp(cmd, "groups") == 0) {
-        vga_puts("GROUPS(1)                MiniOS Manual                GROUPS(1)\n\n");
-        vga_puts("NAME\n    groups - show user's groups\n\n");
-        vga_puts("SYNOPSIS\n    groups [username]\n\n");
-        vga_puts("DESCRIPTION\n    Display groups the user belongs to.\n\n");
-        vga_puts("EXAMPLES\n    groups        Show own groups\n");
-        vga_puts("    groups bob   Show bob's groups\n");
-    } else if (strcmp(cmd, "chmod") == 0) {
-        vga_puts("CHMOD(1)                 MiniOS Manual                 CHMOD(1)\n\n");
-        vga_puts("NAME\n    chmod - change file permissions\n\n");
-        vga_puts("SYNOPSIS\n    chmod <mode> <file>\n\n");
-        vga_puts("DESCRIPTION\n    Change file permissions using octal mode.\n");
-        vga_puts("    Mode: owner|group|other (rwx = 4+2+1)\n\n");
-        vga_puts("EXAMPLES\n    chmod 755 script    rwxr-xr-x\n");
-        vga_puts("    chmod 644 file.txt  rw-r--r--\n");
-    } else if (strcmp(cmd, "chown") == 0) {
-        vga_puts("CHOWN(1)                 MiniOS Manual                 CHOWN(1)\n\n");
-        vga_puts("NAME\n    chown - change file owner\n\n");
-        vga_puts("SYNOPSIS\n    chown <user> <file>\n\n");
-        vga_puts("DESCRIPTION\n    Change the owner of a file. Root only.\n\n");
-        vga_puts("EXAMPLES\n    chown bob file.txt    Make bob owner\n");
-    } else if (strcmp(cmd, "id") == 0) {
-        vga_puts("ID(1)                    MiniOS Manual                    ID(1)\n\n");
-        vga_puts("NAME\n    id - display user and group IDs\n\n");
-        vga_puts("SYNOPSIS\n    id [username]\n\n");
-        vga_puts("DESCRIPTION\n    Show UID and GID for current or specified user.\n\n");
-        vga_puts("EXAMPLES\n    id         Show own IDs\n");
-        vga_puts("    id guest   Show guest's IDs\n");
-    } else if (strcmp(cmd, "whoami") == 0) {
-        vga_puts("WHOAMI(1)                MiniOS Manual                WHOAMI(1)\n\n");
-        vga_puts("NAME\n    whoami - print current username\n\n");
-        vga_puts("SYNOPSIS\n    whoami\n\n");
-        vga_puts("DESCRIPTION\n    Display the username of the current user.\n\n");
-        vga_puts("EXAMPLES\n    whoami    Shows: root\n");
-    /* Shell Commands */
-    } else if (strcmp(cmd, "help") == 0) {
-        vga_puts("HELP(1)                  MiniOS Manual                  HELP(1)\n\n");
-        vga_puts("NAME\n    help - display available commands\n\n");
-        vga_puts("SYNOPSIS\n    help\n\n");
-        vga_puts("DESCRIPTION\n    List all available shell commands with descriptions.\n\n");
-        vga_puts("SEE ALSO\n    man - for detailed command documentation\n");
-    } else if (strcmp(cmd, "clear") == 0) {
-        vga_puts("CLEAR(1)                 MiniOS Manual                 CLEAR(1)\n\n");
-        vga_puts("NAME\n    clear - clear the terminal screen\n\n");
-        vga_puts("SYNOPSIS\n    clear\n\n");
-        vga_puts("DESCRIPTION\n    Clear all text from the terminal screen.\n\n");
-        vga_puts("EXAMPLES\n    clear    Clear screen\n");
-    } else if (strcmp(cmd, "echo") == 0) {
-        vga_puts("ECHO(1)                  MiniOS Manual                  ECHO(1)\n\n");
-        vga_puts("NAME\n    echo - display text\n\n");
-        vga_puts("SYNOPSIS\n    echo [-neE] [text...]\n\n");
-        vga_puts("DESCRIPTION\n    Print arguments to the terminal.\n\n");
-        vga_puts("OPTIONS\n");
-        vga_puts("    -n    Do not output trailing newline\n");
-        vga_puts("    -e    Enable interpretation of backslash escapes\n");
-        vga_puts("    -E    Disable interpretation of escapes (default)\n\n");
-        vga_puts("ESCAPE SEQUENCES (with -e)\n");
-        vga_puts("    \\\\n   newline    \\\\t   tab    \\\\\\\\   backslash\n\n");
-        vga_puts("EXAMPLES\n    echo Hello World      Prints: Hello World\n");
-        vga_puts("    echo -n no newline   No trailing newline\n");
-        vga_puts("    echo -e 'a\\\\tb'       Tab between a and b\n");
-    } else if (strcmp(cmd, "history") == 0) {
-        vga_puts("HISTORY(1)               MiniOS Manual               HISTORY(1)\n\n");
-        vga_puts("NAME\n    history - show command history\n\n");
-        vga_puts("SYNOPSIS\n    history\n\n");
-        vga_puts("DESCRIPTION\n    Display previously executed commands.\n\n");
-        vga_puts("EXAMPLES\n    history    Show command history\n");
-    } else if (strcmp(cmd, "env") == 0) {
-        vga_puts("ENV(1)                   MiniOS Manual                   ENV(1)\n\n");
-        vga_puts("NAME\n    env - show environment variables\n\n");
-        vga_puts("SYNOPSIS\n    env\n\n");
-        vga_puts("DESCRIPTION\n    Display all environment variables.\n\n");
-        vga_puts("EXAMPLES\n    env    Show environment\n");
-    } else if (strcmp(cmd, "alias") == 0) {
-        vga_puts("ALIAS(1)                 MiniOS Manual                 ALIAS(1)\n\n");
-        vga_puts("NAME\n    alias - create command alias\n\n");
-        vga_puts("SYNOPSIS\n    alias [name=value]\n\n");
-        vga_puts("DESCRIPTION\n    Create or display command aliases.\n\n");
-        vga_puts("EXAMPLES\n    alias    Show aliases\n");
-    } else if (strcmp(cmd, "export") == 0) {
-        vga_puts("EXPORT(1)                MiniOS Manual                EXPORT(1)\n\n");
-        vga_puts("NAME\n    export - set environment variable\n\n");
-        vga_puts("SYNOPSIS\n    export [name=value]\n\n");
-        vga_puts("DESCRIPTION\n    Set or display environment variables.\n\n");
-        vga_puts("EXAMPLES\n    export PATH=/bin    Set PATH\n");
-    } else if (strcmp(cmd, "set") == 0) {
-        vga_puts("SET(1)                   MiniOS Manual                   SET(1)\n\n");
-        vga_puts("NAME\n    set - show or set shell options\n\n");
-        vga_puts("SYNOPSIS\n    set [option]\n\n");
-        vga_puts("DESCRIPTION\n    Display or modify shell options.\n\n");
-        vga_puts("EXAMPLES\n    set    Show options\n");
-    /* Debug Commands */
-    } else if (strcmp(cmd, "peek") == 0) {
-        vga_puts("PEEK(1)                  MiniOS Manual                  PEEK(1)\n\n");
-        vga_puts("NAME\n    peek - read memory address\n\n");
-        vga_puts("SYNOPSIS\n    peek <address>\n\n");
-        vga_puts("DESCRIPTION\n    Read and display value at memory address (hex).\n\n");
-        vga_puts("EXAMPLES\n    peek 0xB8000    Read VGA memory\n");
-    } else if (strcmp(cmd, "poke") == 0) {
-        vga_puts("POKE(1)                  MiniOS Manual                  POKE(1)\n\n");
-        vga_puts("NAME\n    poke - write to memory address\n\n");
-        vga_puts("SYNOPSIS\n    poke <address> <value>\n\n");
-        vga_puts("DESCRIPTION\n    Write value to memory address. Use with caution!\n\n");
-        vga_puts("EXAMPLES\n    poke 0xB8000 0x0741    Write 'A' to VGA\n");
-    } else if (strcmp(cmd, "dump") == 0) {
-        vga_puts("DUMP(1)                  MiniOS Manual                  DUMP(1)\n\n");
-        vga_puts("NAME\n    dump - dump memory range\n\n");
-        vga_puts("SYNOPSIS\n    dump <address> [length]\n\n");
-        vga_puts("DESCRIPTION\n    Display memory contents in hex format.\n\n");
-        vga_puts("EXAMPLES\n    dump 0x100000 64    Dump 64 bytes at 1MB\n");
-    } else if (strcmp(cmd, "heap") == 0) {
-        vga_puts("HEAP(1)                  MiniOS Manual                  HEAP(1)\n\n");
-        vga_puts("NAME\n    heap - show heap statistics\n\n");
-        vga_puts("SYNOPSIS\n    heap\n\n");
-        vga_puts("DESCRIPTION\n    Display kernel heap usage and block information.\n\n");
-        vga_puts("EXAMPLES\n    heap    Show heap stats\n");
-    } else if (strcmp(cmd, "regs") == 0) {
-        vga_puts("REGS(1)                  MiniOS Manual                  REGS(1)\n\n");
-        vga_puts("NAME\n    regs - display CPU registers\n\n");
-        vga_puts("SYNOPSIS\n    regs\n\n");
-        vga_puts("DESCRIPTION\n    Show current CPU register values.\n\n");
-        vga_puts("EXAMPLES\n    regs    Show registers\n");
-    } else if (strcmp(cmd, "gdt") == 0) {
-        vga_puts("GDT(1)                   MiniOS Manual                   GDT(1)\n\n");
-        vga_puts("NAME\n    gdt - show Global Descriptor Table\n\n");
-        vga_puts("SYNOPSIS\n    gdt\n\n");
-        vga_puts("DESCRIPTION\n    Display GDT entries and segment information.\n\n");
-        vga_puts("EXAMPLES\n    gdt    Show GDT\n");
-    } else if (strcmp(cmd, "idt") == 0) {
-        vga_puts("IDT(1)                   MiniOS Manual                   IDT(1)\n\n");
-        vga_puts("NAME\n    idt - show Interrupt Descriptor Table\n\n");
-        vga_puts("SYNOPSIS\n    idt\n\n");
-        vga_puts("DESCRIPTION\n    Display IDT summary and interrupt handlers.\n\n");
-        vga_puts("EXAMPLES\n    idt    Show IDT\n");
-    } else if (strcmp(cmd, "pages") == 0) {
-        vga_puts("PAGES(1)                 MiniOS Manual                 PAGES(1)\n\n");
-        vga_puts("NAME\n    pages - show page table information\n\n");
-        vga_puts("SYNOPSIS\n    pages\n\n");
-        vga_puts("DESCRIPTION\n    Display paging and virtual memory information.\n\n");
-        vga_puts("EXAMPLES\n    pages    Show page tables\n");
-    } else if (strcmp(cmd, "stack") == 0) {
-        vga_puts("STACK(1)                 MiniOS Manual                 STACK(1)\n\n");
-        vga_puts("NAME\n    stack - show stack trace\n\n");
-        vga_puts("SYNOPSIS\n    stack\n\n");
-        vga_puts("DESCRIPTION\n    Display current stack with return addresses.\n\n");
-        vga_puts("EXAMPLES\n    stack    Show stack trace\n");
-    /* Text Commands */
-    } else if (strcmp(cmd, "grep") == 0) {
-        vga_puts("GREP(1)                  MiniOS Manual                  GREP(1)\n\n");
-        vga_puts("NAME\n    grep - search for pattern in files\n\n");
-        vga_puts("SYNOPSIS\n    grep [-ivnc] <pattern> [file]\n\n");
-        vga_puts("DESCRIPTION\n    Search for lines matching pattern.\n\n");
-        vga_puts("OPTIONS\n");
-        vga_puts("    -i    Case-insensitive matching\n");
-        vga_puts("    -v    Invert match (show non-matching lines)\n");
-        vga_puts("    -n    Show line numbers\n");
-        vga_puts("    -c    Count matching lines only\n\n");
-        vga_puts("EXAMPLES\n    grep error log.txt       Find 'error' in log.txt\n");
-        vga_puts("    grep -i ERROR log.txt   Case-insensitive search\n");
-        vga_puts("    grep -n TODO *.c        Show line numbers\n");
-        vga_puts("    ls | grep txt           Filter pipe output\n");
-    } else if (strcmp(cmd, "diff") == 0) {
-        vga_puts("DIFF(1)                  MiniOS Manual                  DIFF(1)\n\n");
-        vga_puts("NAME\n    diff - compare two files\n\n");
-        vga_puts("SYNOPSIS\n    diff <file1> <file2>\n\n");
-        vga_puts("DESCRIPTION\n    Compare two files and show differences.\n\n");
-        vga_puts("EXAMPLES\n    diff old.txt new.txt    Compare files\n");
-    /* Misc Commands */
-    } else if (strcmp(cmd, "color") == 0) {
-        vga_puts("COLOR(1)                 MiniOS Manual                 COLOR(1)\n\n");
-        vga_puts("NAME\n    color - set terminal text color\n\n");
-        vga_puts("SYNOPSIS\n    color <fg> [bg]\n\n");
-        vga_puts("DESCRIPTION\n    Set foreground and background colors (0-15).\n\n");
-        vga_puts("EXAMPLES\n    color 10      Light green text\n");
-        vga_puts("    color 15 1   White on blue\n");
-    } else if (strcmp(cmd, "version") == 0) {
-        vga_puts("VERSION(1)               MiniOS Manual               VERSION(1)\n\n");
-        vga_puts("NAME\n    version - show MiniOS version\n\n");
-        vga_puts("SYNOPSIS\n    version\n\n");
-        vga_puts("DESCRIPTION\n    Display MiniOS version information.\n\n");
-        vga_puts("EXAMPLES\n    version    Show version\n");
-    } else if (strcmp(cmd, "about") == 0) {
-        vga_puts("ABOUT(1)                 MiniOS Manual                 ABOUT(1)\n\n");
-        vga_puts("NAME\n    about - about MiniOS\n\n");
-        vga_puts("SYNOPSIS\n    about\n\n");
-        vga_puts("DESCRIPTION\n    Display information about MiniOS.\n\n");
-        vga_puts("EXAMPLES\n    about    Show about info\n");
-    } else if (strcmp(cmd, "credits") == 0) {
-        vga_puts("CREDITS(1)               MiniOS Manual               CREDITS(1)\n\n");
-        vga_puts("NAME\n    credits - show credits\n\n");
-        vga_puts("SYNOPSIS\n    credits\n\n");
-        vga_puts("DESCRIPTION\n    Display MiniOS credits and acknowledgments.\n\n");
-        vga_puts("EXAMPLES\n    credits    Show credits\n");
-    } else if (strcmp(cmd, "beep") == 0) {
-        vga_puts("BEEP(1)                  MiniOS Manual                  BEEP(1)\n\n");
-        vga_puts("NAME\n    beep - make a beep sound\n\n");
-        vga_puts("SYNOPSIS\n    beep\n\n");
-        vga_puts("DESCRIPTION\n    Play a beep using the PC speaker.\n\n");
-        vga_puts("EXAMPLES\n    beep    Make beep sound\n");
-    } else if (strcmp(cmd, "banner") == 0) {
-        vga_puts("BANNER(1)                MiniOS Manual                BANNER(1)\n\n");
-        vga_puts("NAME\n    banner - display ASCII art text\n\n");
-        vga_puts("SYNOPSIS\n    banner <text>\n\n");
-        vga_puts("DESCRIPTION\n    Display text as large ASCII art letters.\n\n");
-        vga_puts("EXAMPLES\n    banner HELLO    Display HELLO in ASCII art\n");
-    } else if (strcmp(cmd, "fortune") == 0) {
-        vga_puts("FORTUNE(1)               MiniOS Manual               FORTUNE(1)\n\n");
-        vga_puts("NAME\n    fortune - display random quote\n\n");
-        vga_puts("SYNOPSIS\n    fortune\n\n");
-        vga_puts("DESCRIPTION\n    Display a random programming quote or fortune.\n\n");
-        vga_puts("EXAMPLES\n    fortune    Show random quote\n");
-    } else if (strcmp(cmd, "man") == 0) {
-        vga_puts("MAN(1)                   MiniOS Manual                   MAN(1)\n\n");
-        vga_puts("NAME\n    man - display command manual\n\n");
-        vga_puts("SYNOPSIS\n    man <command>\n\n");
-        vga_puts("DESCRIPTION\n    Display the manual page for a command, including\n");
-        vga_puts("    usage, description, and examples.\n\n");
-        vga_puts("EXAMPLES\n    man ls      Show manual for ls\n");
-        vga_puts("    man chmod   Show manual for chmod\n");
-    /* Daemon Commands */
-    } else if (strcmp(cmd, "daemons") == 0) {
-        vga_puts("DAEMONS(1)               MiniOS Manual               DAEMONS(1)\n\n");
-        vga_puts("NAME\n    daemons - list system daemons\n\n");
-        vga_puts("SYNOPSIS\n    daemons\n\n");
-        vga_puts("DESCRIPTION\n    Display status of all system daemons including\n");
-        vga_puts("    their PID, state, and description.\n\n");
-        vga_puts("EXAMPLES\n    daemons    Show all daemon status\n");
-    } else if (strcmp(cmd, "service") == 0) {
-        vga_puts("SERVICE(1)               MiniOS Manual               SERVICE(1)\n\n");
-        vga_puts("NAME\n    service - manage system services\n\n");
-        vga_puts("SYNOPSIS\n    service <name> [action]\n\n");
-        vga_puts("DESCRIPTION\n    Start, stop, restart, or check status of daemons.\n");
-        vga_puts("    Actions: start, stop, restart, status (default)\n\n");
-        vga_puts("EXAMPLES\n    service klogd status   Check klogd status\n");
-        vga_puts("    service crond restart  Restart crond\n");
-    /* Applications */
-    } else if (strcmp(cmd, "spreadsheet") == 0) {
-        vga_puts("SPREADSHEET(1)           MiniOS Manual           SPREADSHEET(1)\n\n");
-        vga_puts("NAME\n    spreadsheet - spreadsheet application\n\n");
-        vga_puts("SYNOPSIS\n    spreadsheet [file.csv]\n\n");
-        vga_puts("DESCRIPTION\n    Full-featured spreadsheet with formulas.\n");
-        vga_puts("    Arrows: Navigate  Enter: Edit cell  ESC: Exit\n");
-        vga_puts("    F2: Save  F3: Load  F5: Clear all\n\n");
-        vga_puts("FORMULAS\n    =A1+B1  =A1*2  =SUM(A1:A10)\n\n");
-        vga_puts("EXAMPLES\n    spreadsheet           New spreadsheet\n");
-        vga_puts("    spreadsheet data.csv  Open file\n");
-    /* New Commands */
-    } else if (strcmp(cmd, "which") == 0) {
-        vga_puts("WHICH(1)                 MiniOS Manual                 WHICH(1)\n\n");
-        vga_puts("NAME\n    which - locate a command\n\n");
-        vga_puts("SYNOPSIS\n    which <command>\n\n");
-        vga_puts("DESCRIPTION\n    Show whether a command is a shell built-in or an\n");
-        vga_puts("    external program in /bin. Displays the path if found.\n\n");
-        vga_puts("EXAMPLES\n    which ls       Shows: ls: shell built-in\n");
-        vga_puts("    which shell    Shows: /bin/shell\n");
-    } else if (strcmp(cmd, "type") == 0) {
-        vga_puts("TYPE(1)                  MiniOS Manual                  TYPE(1)\n\n");
-        vga_puts("NAME\n    type - display command type\n\n");
-        vga_puts("SYNOPSIS\n    type <command>\n\n");
-        vga_puts("DESCRIPTION\n    Show the type of a command: shell builtin, external\n");
-        vga_puts("    program, or alias.\n\n");
-        vga_puts("EXAMPLES\n    type echo     Shows: echo is a shell builtin\n");
-        vga_puts("    type shell    Shows: shell is /bin/shell\n");
-    } else if (strcmp(cmd, "df") == 0) {
-        vga_puts("DF(1)                    MiniOS Manual                    DF(1)\n\n");
-        vga_puts("NAME\n    df - report filesystem disk space usage\n\n");
-        vga_puts("SYNOPSIS\n    df\n\n");
-        vga_puts("DESCRIPTION\n    Display information about mounted filesystems including\n");
-        vga_puts("    total blocks, used space, available space, and mount point.\n\n");
-        vga_puts("EXAMPLES\n    df    Show all mounted filesystems\n");
-    } else if (strcmp(cmd, "find") == 0) {
-        vga_puts("FIND(1)                  MiniOS Manual                  FIND(1)\n\n");
-        vga_puts("NAME\n    find - search for files in a directory hierarchy\n\n");
-        vga_puts("SYNOPSIS\n    find [path] [-name pattern]\n\n");
-        vga_puts("DESCRIPTION\n    Recursively search for files matching a pattern.\n");
-        vga_puts("    Without -name, lists all files. Pattern uses substring match.\n\n");
-        vga_puts("OPTIONS\n    -name pattern    Match files containing pattern\n\n");
-        vga_puts("EXAMPLES\n    find /home           List all files under /home\n");
-        vga_puts("    find . -name txt    Find files containing 'txt'\n");
-        vga_puts("    find /mnt -name log Find log files on mounted drive\n");
-    } else if (strcmp(cmd, "sort") == 0) {
-        vga_puts("SORT(1)                  MiniOS Manual                  SORT(1)\n\n");
-        vga_puts("NAME\n    sort - sort lines of text files\n\n");
-        vga_puts("SYNOPSIS\n    sort [-rnuf] [file]\n\n");
-        vga_puts("DESCRIPTION\n    Read input and output lines in sorted order.\n\n");
-        vga_puts("OPTIONS\n");
-        vga_puts("    -r    Reverse sort order\n");
-        vga_puts("    -n    Numeric sort (compare as numbers)\n");
-        vga_puts("    -u    Unique (remove duplicate lines)\n");
-        vga_puts("    -f    Case-insensitive sorting\n\n");
-        vga_puts("EXAMPLES\n    sort names.txt       Sort alphabetically\n");
-        vga_puts("    sort -r names.txt   Reverse order\n");
-        vga_puts("    sort -n numbers.txt Sort numerically\n");
-        vga_puts("    ls | sort -u        Unique sorted listing\n");
-    } else if (strcmp(cmd, "time") == 0) {
-        vga_puts("TIME(1)                  MiniOS Manual                  TIME(1)\n\n");
-        vga_puts("NAME\n    time - time command execution\n\n");
-        vga_puts("SYNOPSIS\n    time <command> [args...]\n\n");
-        vga_puts("DESCRIPTION\n    Execute a command and report how long it took.\n");
-        vga_puts("    Shows elapsed time in seconds and milliseconds.\n\n");
-        vga_puts("EXAMPLES\n    time sleep 2       Time a 2-second sleep\n");
-        vga_puts("    time find /        Time a recursive find\n");
-        vga_puts("    time cat bigfile   Time reading a large file\n");
-    } else if (strcmp(cmd, "seq") == 0) {
-        vga_puts("SEQ(1)                   MiniOS Manual                   SEQ(1)\n\n");
-        vga_puts("NAME\n    seq - print a sequence of numbers\n\n");
-        vga_puts("SYNOPSIS\n    seq [start] [step] end\n\n");
-        vga_puts("DESCRIPTION\n    Print numbers from start to end. Default start is 1,\n");
-        vga_puts("    default step is 1. Negative step counts down.\n\n");
-        vga_puts("EXAMPLES\n    seq 5           Print 1 2 3 4 5\n");
-        vga_puts("    seq 2 5         Print 2 3 4 5\n");
-        vga_puts("    seq 1 2 10      Print 1 3 5 7 9 (step 2)\n");
-        vga_puts("    seq 10 -1 1     Print 10 9 8 ... 1\n");
-    } else if (strcmp(cmd, "rev") == 0) {
-        vga_puts("REV(1)                   MiniOS Manual                   REV(1)\n\n");
-        vga_puts("NAME\n    rev - reverse lines of a file\n\n");
-        vga_puts("SYNOPSIS\n    rev <filename>\n\n");
-        vga_puts("DESCRIPTION\n    Read a file and output each line with characters\n");
-        vga_puts("    reversed. Useful for text manipulation.\n\n");
-        vga_puts("EXAMPLES\n    rev file.txt    Reverse each line\n");
-        vga_puts("    (hello -> olleh)\n");
-    } else if (strcmp(cmd, "nano") == 0) {
-        vga_puts("NANO(1)                  MiniOS Manual                  NANO(1)\n\n");
-        vga_puts("NAME\n    nano - text editor\n\n");
-        vga_puts("SYNOPSIS\n    nano [filename]\n\n");
-        vga_puts("DESCRIPTION\n    Full-featured text editor with cut/copy/paste,\n");
-        vga_puts("    search, and file save/load capabilities.\n\n");
-        vga_puts("KEYS\n    Ctrl+O: Save   Ctrl+X: Exit   Ctrl+K: Cut line\n");
-        vga_puts("    Ctrl+U: Paste  Ctrl+W: Search Ctrl+G: Go to line\n\n");
-        vga_puts("EXAMPLES\n    nano              New file\n");
-        vga_puts("    nano file.txt     Edit file.txt\n");
-    } else if (strcmp(cmd, "basic") == 0) {
-        vga_puts("BASIC(1)                 MiniOS Manual                 BASIC(1)\n\n");
-        vga_puts("NAME\n    basic - BASIC programming language interpreter\n\n");
-        vga_puts("SYNOPSIS\n    basic [file.bas]\n\n");
-        vga_puts("DESCRIPTION\n    Interactive BASIC interpreter supporting classic\n");
-        vga_puts("    commands and statements. Programs can be saved/loaded.\n\n");
-        vga_puts("COMMANDS\n    RUN       Execute the program\n");
-        vga_puts("    LIST      Display program listing\n");
-        vga_puts("    NEW       Clear program from memory\n");
-        vga_puts("    SAVE \"f\"  Save program to file\n");
-        vga_puts("    LOAD \"f\"  Load program from file\n");
-        vga_puts("    BYE       Exit BASIC interpreter\n\n");
-        vga_puts("STATEMENTS\n    PRINT expr    Output to screen\n");
-        vga_puts("    INPUT var     Read user input\n");
-        vga_puts("    LET var=expr  Assign variable\n");
-        vga_puts("    IF cond THEN  Conditional execution\n");
-        vga_puts("    GOTO line     Jump to line number\n");
-        vga_puts("    GOSUB/RETURN  Subroutine call\n");
-        vga_puts("    FOR/NEXT      Loop construct\n");
-        vga_puts("    REM comment   Comment line\n");
-        vga_puts("    END           End program\n");
-        vga_puts("    CLS           Clear screen\n\n");
-        vga_puts("FUNCTIONS\n    RND(x)  Random number 0-1\n");
-        vga_puts("    ABS(x)  Absolute value\n");
-        vga_puts("    INT(x)  Integer part\n\n");
-        vga_puts("EXAMPLES\n    10 PRINT \"HELLO WORLD\"\n");
-        vga_puts("    20 FOR I=1 TO 10\n");
-        vga_puts("    30 PRINT I\n");
-        vga_puts("    40 NEXT I\n");
-    } else if (strcmp(cmd, "mount") == 0) {
-        vga_puts("MOUNT(1)                 MiniOS Manual                 MOUNT(1)\n\n");
-        vga_puts("NAME\n    mount - mount a filesystem\n\n");
-        vga_puts("SYNOPSIS\n    mount <device> <mountpoint> <fstype>\n\n");
-        vga_puts("DESCRIPTION\n    Mount a block device at a directory. Currently\n");
-        vga_puts("    supports ext2 filesystem type.\n\n");
-        vga_puts("EXAMPLES\n    mount hd0p1 /mnt ext2    Mount partition 1 at /mnt\n");
-    } else {
-        printk("No manual entry for '%s'\n", cmd);
-        vga_puts("Use 'man' without arguments to see available topics.\n");
+    const man_page_t* page = man_lookup(argv[1]);
+    if (page == NULL) {
+        printk("No manual entry for '%s'\n", argv[1]);
         return 1;
     }
+    shell_output(page->text);
+    return 0;
+}
 
+/*
+ * apropos - Search manual page names and descriptions
+ */
+static int cmd_apropos(int argc, char* argv[]) {
+    if (argc < 2) {
+        vga_puts("Usage: apropos <keyword>\n");
+        return 1;
+    }
+
+    strsearch_t search;
+    strsearch_init(&search, argv[1], false);
+
+    char summary[80];
+    int hits = 0;
+    for (size_t i = 0; i < MAN_PAGE_COUNT; i++) {
+        man_summary(&man_pages[i], summary, sizeof(summary));
+        if (strsearch_find(&search, man_pages[i].name,
+                           strlen(man_pages[i].name)) == NULL &&
+            strsearch_find(&search, summary, strlen(summary)) == NULL) {
+            continue;
+        }
+        printk("%-12s %s\n", man_pages[i].name, summary);
+        hits++;
+    }
+    if (hits == 0) {
+        printk("apropos: nothing matches '%s'\n", argv[1]);
+    }
     return 0;
 }
 
@@ -4497,6 +5772,7 @@ static int cmd_xgui(int argc, char* argv[]) {
         vga_puts("  - PS/2 mouse recommended\n\n");
         vga_puts("Controls:\n");
         vga_puts("  ESC       Exit GUI and return to shell\n");
+        vga_puts("  Ctrl+F    Toggle frame-time HUD\n");
         vga_puts("  Mouse     Click and drag windows\n");
         return 0;
     }
@@ -4508,6 +5784,103 @@ static int cmd_xgui(int argc, char* argv[]) {
     return 0;
 }
 
+/*
+ * Ctrl-R incremental history search. Each keystroke narrows the query
+ * and the newest matching entry is shown live; Ctrl-R again steps to
+ * the next older match, Enter accepts the shown line into the input
+ * buffer, Esc cancels back to the line being edited. Matching scans
+ * the ring newest-first with one Boyer-Moore-Horspool table per
+ * keystroke, so even a history of thousands of entries responds
+ * instantly.
+ */
+static int history_search_back(const char* query, int from) {
+    if (query[0] == '\0' || from < 0) {
+        return -1;
+    }
+
+    strsearch_t search;
+    strsearch_init(&search, query, false);
+
+    for (int i = from; i >= 0; i--) {
+        const char* line = history_at(i);
+        if (strsearch_find(&search, line, strlen(line)) != NULL) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void shell_history_search(void) {
+    char query[64];
+    int qlen = 0;
+    int match = -1;             /* Logical index of the shown entry */
+    int shown = 0;              /* Characters currently rendered */
+
+    query[0] = '\0';
+
+    /* Take the edited line off the screen (it stays in input_buffer
+       until a match is accepted) */
+    while (cursor_pos > 0) {
+        cursor_pos--;
+        vga_move_cursor_left();
+    }
+    for (int i = 0; i < input_len; i++) vga_putchar(' ');
+    for (int i = 0; i < input_len; i++) vga_move_cursor_left();
+
+    while (1) {
+        /* Render "(reverse-i-search)`query': line" in place */
+        char render[SHELL_MAX_CMD_LEN + 96];
+        snprintf(render, sizeof(render), "(reverse-i-search)`%s': %s",
+                 query, match >= 0 ? history_at(match) : "");
+        int rlen = strlen(render);
+
+        for (int i = 0; i < shown; i++) vga_move_cursor_left();
+        vga_puts(render);
+        for (int i = rlen; i < shown; i++) vga_putchar(' ');
+        for (int i = rlen; i < shown; i++) vga_move_cursor_left();
+        shown = rlen;
+
+        char c = keyboard_getchar();
+        uint8_t uc = (uint8_t)c;
+
+        if (c == '\n' || c == 27 || (uc >= 0x80 && uc != KEY_DELETE)) {
+            /* Clear the search render */
+            for (int i = 0; i < shown; i++) vga_move_cursor_left();
+            for (int i = 0; i < shown; i++) vga_putchar(' ');
+            for (int i = 0; i < shown; i++) vga_move_cursor_left();
+
+            if (c == '\n' && match >= 0) {
+                strncpy(input_buffer, history_at(match), SHELL_MAX_CMD_LEN - 1);
+                input_buffer[SHELL_MAX_CMD_LEN - 1] = '\0';
+                input_len = strlen(input_buffer);
+                cursor_pos = input_len;
+            }
+            /* Esc (or arrows etc.) restores the original line */
+            input_buffer[input_len] = '\0';
+            vga_puts(input_buffer);
+            cursor_pos = input_len;
+            return;
+        } else if (c == 18) {
+            /* Ctrl-R again: next older match */
+            if (match > 0) {
+                int next = history_search_back(query, match - 1);
+                if (next >= 0) match = next;
+            }
+        } else if (c == '\b') {
+            if (qlen > 0) {
+                query[--qlen] = '\0';
+                match = history_search_back(query, history_size - 1);
+            }
+        } else if (c >= 32 && c < 127 && qlen < (int)sizeof(query) - 1) {
+            query[qlen++] = c;
+            query[qlen] = '\0';
+            /* Narrowing: the current match may still qualify */
+            match = history_search_back(query,
+                                        match >= 0 ? match : history_size - 1);
+        }
+    }
+}
+
 /*
  * Run the shell main loop
  */
@@ -4550,7 +5923,7 @@ void shell_run(void) {
                     vga_move_cursor_left();
                 }
                 /* Copy history entry to input buffer */
-                strncpy(input_buffer, history[history_index], SHELL_MAX_CMD_LEN - 1);
+                strncpy(input_buffer, history_at(history_index), SHELL_MAX_CMD_LEN - 1);
                 input_buffer[SHELL_MAX_CMD_LEN - 1] = '\0';
                 input_len = strlen(input_buffer);
                 cursor_pos = input_len;
@@ -4559,7 +5932,7 @@ void shell_run(void) {
             continue;
         } else if (uc == KEY_DOWN) {
             /* Navigate to next command in history */
-            if (history_index < history_count - 1) {
+            if (history_index < history_size - 1) {
                 history_index++;
                 /* Clear current input */
                 while (cursor_pos > 0) {
@@ -4574,14 +5947,14 @@ void shell_run(void) {
                     vga_move_cursor_left();
                 }
                 /* Copy history entry to input buffer */
-                strncpy(input_buffer, history[history_index], SHELL_MAX_CMD_LEN - 1);
+                strncpy(input_buffer, history_at(history_index), SHELL_MAX_CMD_LEN - 1);
                 input_buffer[SHELL_MAX_CMD_LEN - 1] = '\0';
                 input_len = strlen(input_buffer);
                 cursor_pos = input_len;
                 vga_puts(input_buffer);
-            } else if (history_index == history_count - 1) {
+            } else if (history_index == history_size - 1) {
                 /* At end of history, clear to empty line */
-                history_index = history_count;
+                history_index = history_size;
                 while (cursor_pos > 0) {
                     cursor_pos--;
                     vga_move_cursor_left();
@@ -4637,6 +6010,9 @@ void shell_run(void) {
         } else if (c == '\t') {
             /* Tab completion */
             shell_tab_complete();
+        } else if (c == 18) {
+            /* Ctrl+R - incremental history search */
+            shell_history_search();
         } else if (c == '\b') {
             /* Backspace - delete character before cursor */
             if (cursor_pos > 0) {
@@ -4744,12 +6120,10 @@ static int cmd_which(int argc, char* argv[]) {
         return -1;
     }
 
-    for (int i = 0; i < num_commands; i++) {
-        if (strcmp(commands[i].name, argv[1]) == 0) {
-            shell_output(argv[1]);
-            shell_output(": shell built-in\n");
-            return 0;
-        }
+    if (shell_find_command(argv[1])) {
+        shell_output(argv[1]);
+        shell_output(": shell built-in\n");
+        return 0;
     }
 
     /* Check /bin for external commands */
@@ -4776,12 +6150,10 @@ static int cmd_type(int argc, char* argv[]) {
         return -1;
     }
 
-    for (int i = 0; i < num_commands; i++) {
-        if (strcmp(commands[i].name, argv[1]) == 0) {
-            shell_output(argv[1]);
-            shell_output(" is a shell builtin\n");
-            return 0;
-        }
+    if (shell_find_command(argv[1])) {
+        shell_output(argv[1]);
+        shell_output(" is a shell builtin\n");
+        return 0;
     }
 
     /* Check /bin */
@@ -4812,16 +6184,28 @@ static int cmd_df(int argc, char* argv[]) {
     /* Show ramfs (root) - estimate based on heap */
     shell_output("ramfs            N/A        N/A       N/A    -    /\n");
 
-    /* Check for mounted ext2 at /mnt */
-    vfs_node_t* mnt = vfs_lookup("/mnt");
-    if (mnt && (mnt->flags & VFS_MOUNTPOINT)) {
-        /* Get ext2 superblock info - we need to read from the mounted fs */
-        vfs_node_t* mounted_root = mnt->ptr;
-        if (mounted_root && mounted_root->impl) {
-            /* Access ext2 filesystem structure */
-            /* For now, show placeholder - would need ext2 API to get stats */
-            shell_output("hd0p1            ext2       ext2      ext2   -    /mnt\n");
+    /* Mounted ext2 filesystems: the counters come straight from the
+     * in-memory superblock (maintained by the alloc/free paths), so
+     * this costs no disk I/O */
+    static const char* mount_paths[] = { "/mnt", "/mnt2", "/mnt3", NULL };
+    for (int m = 0; mount_paths[m]; m++) {
+        vfs_node_t* mp = vfs_lookup(mount_paths[m]);
+        if (!mp || mp->readdir != ext2_vfs_readdir || !mp->impl) {
+            continue;
+        }
+
+        ext2_fs_stats_t st;
+        if (!ext2_get_fs_stats(mp, &st)) {
+            continue;
         }
+
+        uint32_t used = st.total_blocks - st.free_blocks;
+        uint32_t pct = st.total_blocks ? (used * 100) / st.total_blocks : 0;
+
+        char line[96];
+        snprintf(line, sizeof(line), "ext2      %10u %9u %9u  %3u%%  %s\n",
+                 st.total_blocks, used, st.free_blocks, pct, mount_paths[m]);
+        shell_output(line);
     }
 
     return 0;
@@ -4829,35 +6213,76 @@ static int cmd_df(int argc, char* argv[]) {
 
 /*
  * find - Search for files recursively
+ *
+ * The walk is iterative: one frame per open directory holds the node
+ * handle and a readdir cursor, so each directory is enumerated in a
+ * single pass and a deep tree costs a fixed-size frame stack instead
+ * of unbounded kernel stack. One shared path buffer is edited in
+ * place; each frame remembers the length to truncate back to.
  */
-static void find_recursive(vfs_node_t* dir, const char* pattern, const char* current_path) {
-    if (!dir || !(dir->flags & VFS_DIRECTORY)) return;
+#define FIND_MAX_DEPTH 32
 
-    uint32_t idx = 0;
-    dirent_t* entry;
+typedef struct {
+    vfs_node_t* dir;            /* Reused for every entry in the dir */
+    vfs_dir_cursor_t cursor;
+    int path_len;               /* Path length at this frame's root */
+} find_frame_t;
+
+static void find_walk(vfs_node_t* start, const char* pattern, const char* start_path) {
+    if (!start || !(start->flags & VFS_DIRECTORY)) return;
+
+    /* One skip table for every name tested */
+    strsearch_t search;
+    if (pattern) {
+        strsearch_init(&search, pattern, false);
+    }
+
+    char path[VFS_MAX_PATH];
+    strncpy(path, start_path, sizeof(path) - 1);
+    path[sizeof(path) - 1] = '\0';
 
-    while ((entry = vfs_readdir(dir, idx++)) != NULL) {
+    find_frame_t stack[FIND_MAX_DEPTH];
+    int depth = 0;
+    stack[0].dir = start;
+    stack[0].path_len = strlen(path);
+    vfs_opendir(start, &stack[0].cursor);
+
+    while (depth >= 0) {
+        find_frame_t* f = &stack[depth];
+        dirent_t* entry = vfs_readdir_next(&f->cursor);
+        if (entry == NULL) {
+            depth--;
+            continue;
+        }
         if (strcmp(entry->name, ".") == 0 || strcmp(entry->name, "..") == 0) {
             continue;
         }
 
-        char full_path[VFS_MAX_PATH];
-        if (strcmp(current_path, "/") == 0) {
-            snprintf(full_path, sizeof(full_path), "/%s", entry->name);
-        } else {
-            snprintf(full_path, sizeof(full_path), "%s/%s", current_path, entry->name);
-        }
+        /* Append the entry name at this frame's base length */
+        path[f->path_len] = '\0';
+        bool at_root = (f->path_len == 1 && path[0] == '/');
+        snprintf(path + f->path_len, sizeof(path) - f->path_len,
+                 at_root ? "%s" : "/%s", entry->name);
 
-        /* Check if name matches pattern (simple substring match) */
-        if (pattern == NULL || strstr(entry->name, pattern) != NULL) {
-            shell_output(full_path);
+        if (pattern == NULL ||
+            strsearch_find(&search, entry->name, strlen(entry->name)) != NULL) {
+            shell_output(path);
             shell_output("\n");
         }
 
-        /* Recurse into subdirectories */
-        vfs_node_t* child = vfs_finddir(dir, entry->name);
+        /* Descend into subdirectories, depth permitting */
+        vfs_node_t* child = vfs_finddir(f->dir, entry->name);
         if (child && (child->flags & VFS_DIRECTORY)) {
-            find_recursive(child, pattern, full_path);
+            if (depth + 1 < FIND_MAX_DEPTH) {
+                depth++;
+                stack[depth].dir = child;
+                stack[depth].path_len = strlen(path);
+                vfs_opendir(child, &stack[depth].cursor);
+            } else {
+                shell_output("find: ");
+                shell_output(path);
+                shell_output(": too deep, skipping\n");
+            }
         }
     }
 }
@@ -4887,7 +6312,7 @@ static int cmd_find(int argc, char* argv[]) {
     }
 
     if (start->flags & VFS_DIRECTORY) {
-        find_recursive(start, pattern, resolved);
+        find_walk(start, pattern, resolved);
     } else {
         /* Single file */
         if (pattern == NULL || strstr(start->name, pattern) != NULL) {
@@ -4915,6 +6340,299 @@ static int sort_atoi(const char* s) {
     return n * sign;
 }
 
+/* Inputs larger than this are sorted in chunks spilled to /tmp */
+#define SORT_SPILL_BUDGET   (256 * 1024)
+#define SORT_MAX_RUNS       32
+#define SORT_RUN_LINE_MAX   512
+
+static int sort_line_cmp(const char* a, const char* b,
+                         bool numeric, bool case_fold, bool reverse) {
+    int cmp;
+    if (numeric) {
+        cmp = sort_atoi(a) - sort_atoi(b);
+    } else if (case_fold) {
+        while (*a && *b) {
+            char ca = (*a >= 'A' && *a <= 'Z') ? *a + 32 : *a;
+            char cb = (*b >= 'A' && *b <= 'Z') ? *b + 32 : *b;
+            if (ca != cb) break;
+            a++; b++;
+        }
+        char ca = (*a >= 'A' && *a <= 'Z') ? *a + 32 : *a;
+        char cb = (*b >= 'A' && *b <= 'Z') ? *b + 32 : *b;
+        cmp = ca - cb;
+    } else {
+        cmp = strcmp(a, b);
+    }
+    return reverse ? -cmp : cmp;
+}
+
+/*
+ * Stable natural merge sort on line pointers. Each pass detects the
+ * runs that are already in order and merges neighbours, so presorted
+ * or mostly-sorted input finishes in one or two passes; worst case is
+ * O(n log n) instead of the old bubble sort's O(n^2). Returns false
+ * if the scratch array cannot be allocated.
+ */
+static bool sort_lines_stable(char** lines, int n,
+                              bool numeric, bool case_fold, bool reverse) {
+    if (n < 2) return true;
+
+    char** tmp = (char**)kmalloc(n * sizeof(char*));
+    if (!tmp) return false;
+
+    bool merged;
+    do {
+        merged = false;
+        int pos = 0;
+        while (pos < n) {
+            /* Detect the run starting at pos */
+            int mid = pos + 1;
+            while (mid < n &&
+                   sort_line_cmp(lines[mid - 1], lines[mid],
+                                 numeric, case_fold, reverse) <= 0) {
+                mid++;
+            }
+            if (mid >= n) break;   /* Trailing run already in place */
+
+            /* And the run after it */
+            int end = mid + 1;
+            while (end < n &&
+                   sort_line_cmp(lines[end - 1], lines[end],
+                                 numeric, case_fold, reverse) <= 0) {
+                end++;
+            }
+
+            /* Merge the pair; <= keeps the left run's equal lines
+               first, which is what makes the sort stable */
+            int i = pos, j = mid, k = pos;
+            while (i < mid && j < end) {
+                if (sort_line_cmp(lines[i], lines[j],
+                                  numeric, case_fold, reverse) <= 0) {
+                    tmp[k++] = lines[i++];
+                } else {
+                    tmp[k++] = lines[j++];
+                }
+            }
+            while (i < mid) tmp[k++] = lines[i++];
+            while (j < end) tmp[k++] = lines[j++];
+            memcpy(&lines[pos], &tmp[pos], (end - pos) * sizeof(char*));
+
+            merged = true;
+            pos = end;
+        }
+    } while (merged);
+
+    kfree(tmp);
+    return true;
+}
+
+/* Buffered line reader over one spilled run file */
+typedef struct {
+    vfs_node_t* node;
+    uint32_t offset;                /* Next byte to read from the run */
+    uint8_t buf[512];
+    int buf_len;
+    int buf_pos;
+    char line[SORT_RUN_LINE_MAX];
+    bool has_line;
+} sort_run_t;
+
+static bool sort_run_next(sort_run_t* r) {
+    int len = 0;
+    bool saw_any = false;
+
+    while (1) {
+        if (r->buf_pos >= r->buf_len) {
+            int32_t got = vfs_read(r->node, r->offset, sizeof(r->buf), r->buf);
+            if (got <= 0) break;
+            r->offset += (uint32_t)got;
+            r->buf_len = got;
+            r->buf_pos = 0;
+        }
+        saw_any = true;
+        uint8_t c = r->buf[r->buf_pos++];
+        if (c == '\n') break;
+        if (len < SORT_RUN_LINE_MAX - 1) r->line[len++] = (char)c;
+    }
+
+    r->line[len] = '\0';
+    r->has_line = saw_any || len > 0;
+    return r->has_line;
+}
+
+/*
+ * External merge sort for files over the memory budget: the file is
+ * read in budget-sized line-aligned chunks, each chunk is sorted in
+ * memory and spilled to /tmp as a run, and the runs are merged
+ * streaming to the output. Peak memory is one chunk plus the run
+ * readers regardless of file size.
+ */
+static int sort_external(vfs_node_t* file, bool numeric, bool case_fold,
+                         bool reverse, bool unique) {
+    vfs_node_t* tmp_dir = vfs_lookup("/tmp");
+    if (!tmp_dir) {
+        tmp_dir = ramfs_create_dir("tmp");
+    }
+    if (!tmp_dir) {
+        shell_output("sort: cannot create /tmp for spill runs\n");
+        return -1;
+    }
+
+    int run_count = 0;
+    char run_name[16];
+    uint32_t chunk_off = 0;
+    int rc = -1;
+
+    /* Phase 1: sorted runs */
+    while (chunk_off < file->length) {
+        if (run_count >= SORT_MAX_RUNS) {
+            shell_output("sort: file too large (too many spill runs)\n");
+            goto cleanup;
+        }
+
+        uint32_t size = file->length - chunk_off;
+        if (size > SORT_SPILL_BUDGET) size = SORT_SPILL_BUDGET;
+
+        uint8_t* chunk = (uint8_t*)kmalloc(size + 1);
+        if (!chunk) {
+            shell_output("sort: out of memory\n");
+            goto cleanup;
+        }
+        int32_t got = vfs_read(file, chunk_off, size, chunk);
+        if (got <= 0) {
+            kfree(chunk);
+            shell_output("sort: read error\n");
+            goto cleanup;
+        }
+        size = (uint32_t)got;
+
+        /* Cut the chunk back to the last complete line unless this is
+           the tail of the file */
+        if (chunk_off + size < file->length) {
+            uint32_t nl = size;
+            while (nl > 0 && chunk[nl - 1] != '\n') nl--;
+            if (nl == 0) {
+                kfree(chunk);
+                shell_output("sort: line longer than spill budget\n");
+                goto cleanup;
+            }
+            size = nl;
+        }
+        chunk[size] = '\0';
+
+        /* Split, sort, and spill the chunk */
+        int n = 0;
+        for (uint32_t i = 0; i < size; i++) {
+            if (chunk[i] == '\n') n++;
+        }
+        if (size > 0 && chunk[size - 1] != '\n') n++;
+
+        char** lines = (char**)kmalloc((n > 0 ? n : 1) * sizeof(char*));
+        uint8_t* out = (uint8_t*)kmalloc(size + 1);
+        if (!lines || !out) {
+            if (lines) kfree(lines);
+            if (out) kfree(out);
+            kfree(chunk);
+            shell_output("sort: out of memory\n");
+            goto cleanup;
+        }
+
+        int li = 0;
+        char* start = (char*)chunk;
+        for (uint32_t i = 0; i < size; i++) {
+            if (chunk[i] == '\n') {
+                chunk[i] = '\0';
+                if (li < n) lines[li++] = start;
+                start = (char*)&chunk[i + 1];
+            }
+        }
+        if (*start && li < n) lines[li++] = start;
+        n = li;
+
+        if (!sort_lines_stable(lines, n, numeric, case_fold, reverse)) {
+            kfree(lines); kfree(out); kfree(chunk);
+            shell_output("sort: out of memory\n");
+            goto cleanup;
+        }
+
+        uint32_t out_len = 0;
+        for (int i = 0; i < n; i++) {
+            uint32_t l = strlen(lines[i]);
+            memcpy(out + out_len, lines[i], l);
+            out_len += l;
+            out[out_len++] = '\n';
+        }
+
+        snprintf(run_name, sizeof(run_name), ".sort%d", run_count);
+        vfs_node_t* run = ramfs_create_file_in(tmp_dir, run_name, VFS_FILE);
+        if (!run || vfs_write(run, 0, out_len, out) < 0) {
+            kfree(lines); kfree(out); kfree(chunk);
+            shell_output("sort: cannot write spill run\n");
+            goto cleanup;
+        }
+        run_count++;
+
+        kfree(lines);
+        kfree(out);
+        kfree(chunk);
+        chunk_off += size;
+    }
+
+    /* Phase 2: k-way merge of the runs, streaming to the output */
+    {
+        sort_run_t* runs = (sort_run_t*)kmalloc(run_count * sizeof(sort_run_t));
+        if (!runs) {
+            shell_output("sort: out of memory\n");
+            goto cleanup;
+        }
+        memset(runs, 0, run_count * sizeof(sort_run_t));
+
+        for (int i = 0; i < run_count; i++) {
+            snprintf(run_name, sizeof(run_name), ".sort%d", i);
+            runs[i].node = vfs_finddir(tmp_dir, run_name);
+            if (runs[i].node) sort_run_next(&runs[i]);
+        }
+
+        char prev[SORT_RUN_LINE_MAX];
+        bool have_prev = false;
+
+        while (1) {
+            int best = -1;
+            for (int i = 0; i < run_count; i++) {
+                if (!runs[i].has_line) continue;
+                /* Strict < keeps the lowest run (earliest chunk)
+                   first on ties: the merge stays stable */
+                if (best < 0 ||
+                    sort_line_cmp(runs[i].line, runs[best].line,
+                                  numeric, case_fold, reverse) < 0) {
+                    best = i;
+                }
+            }
+            if (best < 0) break;
+
+            if (runs[best].line[0] != '\0' &&
+                (!unique || !have_prev || strcmp(prev, runs[best].line) != 0)) {
+                shell_output(runs[best].line);
+                shell_output("\n");
+                strncpy(prev, runs[best].line, sizeof(prev) - 1);
+                prev[sizeof(prev) - 1] = '\0';
+                have_prev = true;
+            }
+            sort_run_next(&runs[best]);
+        }
+
+        kfree(runs);
+    }
+    rc = 0;
+
+cleanup:
+    for (int i = 0; i < run_count; i++) {
+        snprintf(run_name, sizeof(run_name), ".sort%d", i);
+        ramfs_delete(tmp_dir, run_name);
+    }
+    return rc;
+}
+
 static int cmd_sort(int argc, char* argv[]) {
     bool reverse = false;
     bool numeric = false;
@@ -4960,6 +6678,13 @@ static int cmd_sort(int argc, char* argv[]) {
         }
         if (file->length == 0) return 0;
 
+        /* Inputs over the memory budget are sorted in chunks spilled
+           to /tmp and merged streaming, so sort works on files larger
+           than the heap can hold at once */
+        if (file->length > SORT_SPILL_BUDGET) {
+            return sort_external(file, numeric, case_fold, reverse, unique);
+        }
+
         content = (uint8_t*)kmalloc(file->length + 1);
         if (!content) {
             shell_output("sort: out of memory\n");
@@ -5018,34 +6743,12 @@ static int cmd_sort(int argc, char* argv[]) {
     }
     num_lines = line_idx;
 
-    /* Bubble sort with options */
-    for (int i = 0; i < num_lines - 1; i++) {
-        for (int j = 0; j < num_lines - i - 1; j++) {
-            int cmp;
-            if (numeric) {
-                cmp = sort_atoi(lines[j]) - sort_atoi(lines[j + 1]);
-            } else if (case_fold) {
-                /* Case-insensitive comparison */
-                const char *a = lines[j], *b = lines[j + 1];
-                while (*a && *b) {
-                    char ca = (*a >= 'A' && *a <= 'Z') ? *a + 32 : *a;
-                    char cb = (*b >= 'A' && *b <= 'Z') ? *b + 32 : *b;
-                    if (ca != cb) break;
-                    a++; b++;
-                }
-                char ca = (*a >= 'A' && *a <= 'Z') ? *a + 32 : *a;
-                char cb = (*b >= 'A' && *b <= 'Z') ? *b + 32 : *b;
-                cmp = ca - cb;
-            } else {
-                cmp = strcmp(lines[j], lines[j + 1]);
-            }
-            if (reverse) cmp = -cmp;
-            if (cmp > 0) {
-                char* tmp = lines[j];
-                lines[j] = lines[j + 1];
-                lines[j + 1] = tmp;
-            }
-        }
+    /* Stable merge sort on the line pointers */
+    if (!sort_lines_stable(lines, num_lines, numeric, case_fold, reverse)) {
+        kfree(lines);
+        kfree(work_content);
+        shell_output("sort: out of memory\n");
+        return -1;
     }
 
     /* Print sorted lines (with optional unique filter) */
@@ -5075,24 +6778,34 @@ static int cmd_time(int argc, char* argv[]) {
         return -1;
     }
 
-    uint32_t start_ticks = timer_get_ticks();
+    uint64_t start_us = timer_us();
+    process_t* self = process_current();
+    uint64_t user0 = 0, sys0 = 0;
+    if (self != NULL) {
+        user0 = self->cpu_user_us;
+        sys0 = self->cpu_kernel_us;
+    }
 
     /* Execute the command */
     int result = execute_command(argc - 1, &argv[1]);
 
-    uint32_t end_ticks = timer_get_ticks();
-    uint32_t elapsed = end_ticks - start_ticks;
-
-    /* Convert ticks to time (100 Hz timer) */
-    uint32_t ms = elapsed * 10;
-    uint32_t secs = ms / 1000;
-    ms = ms % 1000;
+    uint64_t elapsed_us = timer_us() - start_us;
+    uint32_t secs = bench_udiv64_32(elapsed_us, 1000000);
+    uint32_t micros = (uint32_t)(elapsed_us - (uint64_t)secs * 1000000);
 
+    char buf[48];
     shell_output("\nreal\t");
-    char buf[32];
-    snprintf(buf, sizeof(buf), "%u.%03us\n", secs, ms);
+    snprintf(buf, sizeof(buf), "%u.%06us\n", secs, micros);
     shell_output(buf);
 
+    /* Builtin CPU split (children spawned via run account separately) */
+    if (self != NULL) {
+        snprintf(buf, sizeof(buf), "user\t%uus\nsys\t%uus\n",
+                 (uint32_t)(self->cpu_user_us - user0),
+                 (uint32_t)(self->cpu_kernel_us - sys0));
+        shell_output(buf);
+    }
+
     return result;
 }
 
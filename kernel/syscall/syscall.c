@@ -13,6 +13,7 @@
 #include "../include/scheduler.h"
 #include "../include/vga.h"
 #include "../include/keyboard.h"
+#include "../include/tty.h"
 #include "../include/timer.h"
 #include "../include/vfs.h"
 #include "../include/heap.h"
@@ -24,6 +25,10 @@
 #include "../include/pipe.h"
 #include "../include/signal.h"
 #include "../include/uaccess.h"
+#include "../include/trace.h"
+#include "../include/shm.h"
+#include "../include/paging.h"
+#include "../include/socket.h"
 
 /* External references to current directory from shell */
 extern vfs_node_t* current_dir_node;
@@ -32,10 +37,57 @@ extern char current_dir[VFS_MAX_PATH];
 /* System call table */
 static syscall_handler_t syscall_table[NUM_SYSCALLS];
 
+/* SYSENTER machine state registers */
+#define MSR_SYSENTER_CS     0x174
+#define MSR_SYSENTER_ESP    0x175
+#define MSR_SYSENTER_EIP    0x176
+
+static bool sysenter_enabled = false;
+
+static inline void wrmsr(uint32_t msr, uint32_t lo, uint32_t hi) {
+    __asm__ volatile("wrmsr" : : "c"(msr), "a"(lo), "d"(hi));
+}
+
+/*
+ * SYSENTER fast path dispatcher. The asm stub passes at most three
+ * arguments, which covers the hot read/write/getpid style calls; the
+ * handlers all take five, so the rest are zero.
+ */
+int32_t syscall_fast_dispatch(uint32_t num, uint32_t a1, uint32_t a2, uint32_t a3) {
+    if (num < NUM_SYSCALLS && syscall_table[num] != NULL) {
+        TRACE(TRACE_CAT_SYSCALL, TRACE_EV_SYSCALL, num, a1);
+        int32_t result = syscall_table[num](a1, a2, a3, 0, 0);
+
+        /* Signal fast path: one AND decides whether anything needs
+         * delivering before we drop back to user mode */
+        process_t* proc = process_current();
+        if (proc != NULL &&
+            SIG_DELIVERABLE(proc->pending_signals, proc->blocked_signals)) {
+            signal_deliver_to(proc);
+        }
+
+        return result;
+    }
+    return -1;
+}
+
+/*
+ * Keep IA32_SYSENTER_ESP pointing at the running process's kernel
+ * stack so a fast syscall lands on the same stack an interrupt would
+ */
+void syscall_sysenter_stack(uint32_t esp0) {
+    if (sysenter_enabled) {
+        wrmsr(MSR_SYSENTER_ESP, esp0, 0);
+    }
+}
+
 /*
  * System call interrupt handler
  */
 static void syscall_handler(registers_t* regs) {
+    /* Time from here until the return is kernel CPU, not user */
+    sched_cpu_mark(1);
+
     /* Get syscall number from EAX */
     uint32_t syscall_num = regs->eax;
 
@@ -44,6 +96,7 @@ static void syscall_handler(registers_t* regs) {
         regs->eax = (uint32_t)-1;
         /* Ensure interrupts are enabled when returning to user mode */
         regs->eflags |= 0x200;
+        sched_cpu_mark(0);
         return;
     }
 
@@ -53,9 +106,12 @@ static void syscall_handler(registers_t* regs) {
         regs->eax = (uint32_t)-1;
         /* Ensure interrupts are enabled when returning to user mode */
         regs->eflags |= 0x200;
+        sched_cpu_mark(0);
         return;
     }
 
+    TRACE(TRACE_CAT_SYSCALL, TRACE_EV_SYSCALL, syscall_num, regs->ebx);
+
     /* Call handler with arguments from registers */
     /* Arguments: EBX, ECX, EDX, ESI, EDI */
     int32_t result = handler(regs->ebx, regs->ecx, regs->edx, regs->esi, regs->edi);
@@ -63,10 +119,21 @@ static void syscall_handler(registers_t* regs) {
     /* Return value in EAX */
     regs->eax = (uint32_t)result;
 
+    /* Signal fast path: one AND decides whether anything needs
+     * delivering before the IRET back to user mode */
+    process_t* proc = process_current();
+    if (proc != NULL &&
+        SIG_DELIVERABLE(proc->pending_signals, proc->blocked_signals)) {
+        signal_deliver_to(proc);
+    }
+
     /* Ensure interrupts are enabled when returning to user mode.
      * When INT 0x80 is executed, the CPU clears the IF flag and saves EFLAGS.
      * Without this, IRET would restore EFLAGS with IF=0, keeping interrupts disabled. */
     regs->eflags |= 0x200;
+
+    /* Back to user-mode accounting */
+    sched_cpu_mark(0);
 }
 
 /*
@@ -105,7 +172,9 @@ int32_t sys_write(uint32_t fd, uint32_t buf, uint32_t count, uint32_t a4, uint32
 /*
  * sys_read - read from file descriptor
  * For now, only supports stdin (fd=0)
- * Note: Does NOT echo - application is responsible for echoing if desired
+ * Goes through the tty line discipline: canonical mode edits and
+ * echoes in the kernel and delivers whole lines, raw mode (see
+ * sys_ttymode) delivers each key immediately with no echo.
  */
 int32_t sys_read(uint32_t fd, uint32_t buf, uint32_t count, uint32_t a4, uint32_t a5) {
     (void)a4; (void)a5;
@@ -114,29 +183,21 @@ int32_t sys_read(uint32_t fd, uint32_t buf, uint32_t count, uint32_t a4, uint32_
         return -1;  /* Invalid fd */
     }
 
-    char* buffer = (char*)buf;
-    uint32_t read_count = 0;
-
-    /* Read characters from keyboard */
-    while (read_count < count) {
-        /* Enable interrupts so keyboard IRQ can fire */
-        __asm__ volatile("sti");
+    /* Enable interrupts so the keyboard IRQ can fire while we block */
+    __asm__ volatile("sti");
 
-        /* Busy-wait for keyboard input */
-        while (!keyboard_has_key()) {
-            /* Use hlt to save power - wakes on any interrupt */
-            __asm__ volatile("hlt");
-        }
-
-        char c = keyboard_getchar_nonblock();
-        buffer[read_count++] = c;
+    return tty_read((char*)buf, count);
+}
 
-        /* Return after each character for line-buffered input
-         * This allows the shell to handle echoing and line editing */
-        break;
-    }
+/*
+ * sys_ttymode - select console input mode
+ * mode: 0 = canonical (kernel line editing + echo), 1 = raw
+ */
+int32_t sys_ttymode(uint32_t mode, uint32_t a2, uint32_t a3, uint32_t a4, uint32_t a5) {
+    (void)a2; (void)a3; (void)a4; (void)a5;
 
-    return (int32_t)read_count;
+    tty_set_raw(mode != 0);
+    return 0;
 }
 
 /*
@@ -249,40 +310,25 @@ int32_t sys_open(uint32_t path_ptr, uint32_t flags, uint32_t mode, uint32_t a4,
         return -1;  /* File not found and couldn't create */
     }
 
-    /* Find a free file descriptor slot */
-    int fd = -1;
-    for (int i = 3; i < MAX_OPEN_FILES; i++) {  /* Skip stdin/stdout/stderr */
-        if (proc->fd_table[i] == NULL) {
-            fd = i;
-            break;
-        }
-    }
-
+    /* Allocate a descriptor (O(1) via the process's lowest-free hint) */
+    int fd = fd_alloc();
     if (fd < 0) {
         return -1;  /* No free file descriptors */
     }
+    file_descriptor_t* file_desc = fd_get(fd);
 
-    /* Allocate file descriptor structure */
-    file_descriptor_t* file_desc = (file_descriptor_t*)kmalloc(sizeof(file_descriptor_t));
-    if (file_desc == NULL) {
+    /* Open the file before filling in the descriptor, so a failed
+     * open is undone by fd_free without touching the node */
+    if (vfs_open(node, flags) < 0) {
+        fd_free(fd);
         return -1;
     }
 
-    /* Initialize file descriptor */
     file_desc->node = node;
     file_desc->offset = 0;
     file_desc->flags = flags;
     file_desc->refcount = 1;
 
-    /* Open the file */
-    if (vfs_open(node, flags) < 0) {
-        kfree(file_desc);
-        return -1;
-    }
-
-    /* Store in process fd table */
-    proc->fd_table[fd] = (struct file_descriptor*)file_desc;
-
     return fd;
 }
 
@@ -303,17 +349,12 @@ int32_t sys_close(uint32_t fd, uint32_t a2, uint32_t a3, uint32_t a4, uint32_t a
         return -1;
     }
 
-    file_descriptor_t* file_desc = (file_descriptor_t*)proc->fd_table[fd];
-    if (file_desc == NULL) {
+    if (proc->fd_table[fd] == NULL) {
         return -1;  /* Not open */
     }
 
-    /* Close the file */
-    vfs_close(file_desc->node);
-
-    /* Free the file descriptor */
-    kfree(file_desc);
-    proc->fd_table[fd] = NULL;
+    /* fd_free closes the node or pipe end and recycles the slot */
+    fd_free(fd);
 
     return 0;
 }
@@ -387,6 +428,27 @@ int32_t sys_exec(uint32_t path, uint32_t argv, uint32_t a3, uint32_t a4, uint32_
     return process_exec(pathname, argvec);
 }
 
+/*
+ * sys_spawn - Launch a new program in a fresh process (fork+exec in one
+ * step, no intermediate address-space copy)
+ * path: path to executable
+ * argv: argument vector for the child (NULL = program name only)
+ * Returns child PID to the caller, -1 on error
+ */
+int32_t sys_spawn(uint32_t path, uint32_t argv, uint32_t a3, uint32_t a4, uint32_t a5) {
+    (void)a3; (void)a4; (void)a5;
+
+    /* Safely copy path from user space */
+    char pathname[256];
+    if (copyinstr(pathname, (const char*)path, sizeof(pathname)) < 0) {
+        return -1;  /* Bad path pointer */
+    }
+
+    char* const* argvec = (char* const*)argv;
+
+    return process_spawn(pathname, argvec);
+}
+
 /*
  * sys_wait - Wait for child process to exit
  * status_ptr: pointer to store exit status (can be NULL)
@@ -847,6 +909,140 @@ int32_t sys_fwrite(uint32_t fd, uint32_t buf_ptr, uint32_t count, uint32_t a4, u
     return bytes_written;
 }
 
+/*
+ * sys_readv - Read into a list of buffers in one kernel crossing
+ * Returns: total bytes read, 0 on EOF, -1 on error
+ */
+int32_t sys_readv(uint32_t fd, uint32_t iov_ptr, uint32_t iovcnt, uint32_t a4, uint32_t a5) {
+    (void)a4; (void)a5;
+
+    const iovec_t* iov = (const iovec_t*)iov_ptr;
+    if (iov == NULL || iovcnt == 0 || iovcnt > IOV_MAX) {
+        return -1;
+    }
+
+    /* stdin delivers one key per call; fill the first real buffer */
+    if (fd == STDIN_FILENO) {
+        for (uint32_t i = 0; i < iovcnt; i++) {
+            if (iov[i].iov_len > 0) {
+                return sys_read(fd, (uint32_t)iov[i].iov_base,
+                                iov[i].iov_len, 0, 0);
+            }
+        }
+        return 0;
+    }
+
+    process_t* proc = process_current();
+    if (proc == NULL || fd >= MAX_OPEN_FILES) {
+        return -1;
+    }
+
+    file_descriptor_t* desc = (file_descriptor_t*)proc->fd_table[fd];
+    if (desc == NULL) {
+        return -1;
+    }
+
+    if (desc->is_pipe && desc->pipe) {
+        if (!desc->is_read_end) {
+            return -1;
+        }
+        int32_t total = 0;
+        for (uint32_t i = 0; i < iovcnt; i++) {
+            if (iov[i].iov_len == 0) {
+                continue;
+            }
+            int32_t n = pipe_read(desc->pipe, (uint8_t*)iov[i].iov_base,
+                                  iov[i].iov_len);
+            if (n < 0) {
+                return (total > 0) ? total : n;
+            }
+            total += n;
+            if ((uint32_t)n < iov[i].iov_len) {
+                break;  /* Drained what was buffered */
+            }
+        }
+        return total;
+    }
+
+    if (desc->node) {
+        int32_t total = vfs_readv(desc->node, desc->offset, iov, iovcnt);
+        if (total > 0) {
+            desc->offset += total;
+        }
+        return total;
+    }
+
+    return -1;
+}
+
+/*
+ * sys_writev - Write a list of buffers in one kernel crossing
+ * Returns: total bytes written, -1 on error
+ */
+int32_t sys_writev(uint32_t fd, uint32_t iov_ptr, uint32_t iovcnt, uint32_t a4, uint32_t a5) {
+    (void)a4; (void)a5;
+
+    const iovec_t* iov = (const iovec_t*)iov_ptr;
+    if (iov == NULL || iovcnt == 0 || iovcnt > IOV_MAX) {
+        return -1;
+    }
+
+    /* Console output goes straight to the VGA like sys_write */
+    if (fd == STDOUT_FILENO || fd == STDERR_FILENO) {
+        int32_t total = 0;
+        for (uint32_t i = 0; i < iovcnt; i++) {
+            const char* str = (const char*)iov[i].iov_base;
+            for (uint32_t j = 0; j < iov[i].iov_len; j++) {
+                vga_putchar(str[j]);
+            }
+            total += (int32_t)iov[i].iov_len;
+        }
+        return total;
+    }
+
+    process_t* proc = process_current();
+    if (proc == NULL || fd >= MAX_OPEN_FILES) {
+        return -1;
+    }
+
+    file_descriptor_t* desc = (file_descriptor_t*)proc->fd_table[fd];
+    if (desc == NULL) {
+        return -1;
+    }
+
+    if (desc->is_pipe && desc->pipe) {
+        if (desc->is_read_end) {
+            return -1;
+        }
+        int32_t total = 0;
+        for (uint32_t i = 0; i < iovcnt; i++) {
+            if (iov[i].iov_len == 0) {
+                continue;
+            }
+            int32_t n = pipe_write(desc->pipe, (const uint8_t*)iov[i].iov_base,
+                                   iov[i].iov_len);
+            if (n < 0) {
+                return (total > 0) ? total : n;
+            }
+            total += n;
+            if ((uint32_t)n < iov[i].iov_len) {
+                break;  /* Reader went away mid-write */
+            }
+        }
+        return total;
+    }
+
+    if (desc->node) {
+        int32_t total = vfs_writev(desc->node, desc->offset, iov, iovcnt);
+        if (total > 0) {
+            desc->offset += total;
+        }
+        return total;
+    }
+
+    return -1;
+}
+
 /*
  * sys_meminfo - Get memory information
  * buf: array of 4 uint32_t: [total, used, free, heap_used]
@@ -893,6 +1089,22 @@ int32_t sys_date(uint32_t buf_ptr, uint32_t a2, uint32_t a3, uint32_t a4, uint32
     return 0;
 }
 
+/*
+ * sys_gettime - Monotonic nanosecond clock (TSC-based)
+ * ns_ptr: array of 2 uint32_t receiving the high and low halves
+ */
+int32_t sys_gettime(uint32_t ns_ptr, uint32_t a2, uint32_t a3, uint32_t a4, uint32_t a5) {
+    (void)a2; (void)a3; (void)a4; (void)a5;
+
+    uint32_t* out = (uint32_t*)ns_ptr;
+    if (!out) return -1;
+
+    uint64_t ns = timer_ns();
+    out[0] = (uint32_t)(ns >> 32);
+    out[1] = (uint32_t)ns;
+    return 0;
+}
+
 /*
  * sys_pipe - Create a pipe
  * pipefd: array of 2 integers to store read and write file descriptors
@@ -944,6 +1156,260 @@ int32_t sys_pipe(uint32_t pipefd_ptr, uint32_t a2, uint32_t a3, uint32_t a4, uin
     return 0;
 }
 
+/*
+ * Scan a poll set once, filling revents. Returns the number of entries
+ * with events pending; sets *has_kbd when the set watches stdin (which
+ * has no wait queue, so the caller must rescan instead of parking).
+ */
+static int32_t poll_scan(pollfd_t* fds, uint32_t nfds, bool* has_kbd) {
+    int32_t ready = 0;
+
+    for (uint32_t i = 0; i < nfds; i++) {
+        fds[i].revents = 0;
+        int32_t fd = fds[i].fd;
+
+        if (fd < 0) {
+            continue;  /* Entry disabled */
+        }
+
+        if (fd == STDIN_FILENO) {
+            *has_kbd = true;
+            if ((fds[i].events & POLLIN) && keyboard_has_key()) {
+                fds[i].revents |= POLLIN;
+            }
+        } else {
+            file_descriptor_t* desc = fd_get(fd);
+            if (desc == NULL) {
+                fds[i].revents = POLLNVAL;
+            } else if (desc->is_pipe && desc->pipe) {
+                if (desc->is_read_end) {
+                    if ((fds[i].events & POLLIN) && !pipe_is_empty(desc->pipe)) {
+                        fds[i].revents |= POLLIN;
+                    }
+                    if (!desc->pipe->write_open) {
+                        fds[i].revents |= POLLHUP;
+                    }
+                } else {
+                    if (!desc->pipe->read_open) {
+                        fds[i].revents |= POLLERR;
+                    } else if ((fds[i].events & POLLOUT) && !pipe_is_full(desc->pipe)) {
+                        fds[i].revents |= POLLOUT;
+                    }
+                }
+            } else if (desc->node) {
+                /* Regular files never block */
+                fds[i].revents = fds[i].events & (POLLIN | POLLOUT);
+            } else {
+                fds[i].revents = POLLNVAL;
+            }
+        }
+
+        if (fds[i].revents != 0) {
+            ready++;
+        }
+    }
+
+    return ready;
+}
+
+/*
+ * sys_poll - Wait for events on a set of file descriptors
+ * timeout_ms: 0 = return immediately, < 0 = block until ready
+ * Returns: number of ready descriptors, 0 on timeout, -1 on error
+ */
+int32_t sys_poll(uint32_t fds_ptr, uint32_t nfds, uint32_t timeout_arg, uint32_t a4, uint32_t a5) {
+    (void)a4; (void)a5;
+
+    pollfd_t* fds = (pollfd_t*)fds_ptr;
+    int32_t timeout_ms = (int32_t)timeout_arg;
+
+    if (fds == NULL || nfds == 0 || nfds > MAX_FD) {
+        return -1;
+    }
+
+    uint32_t deadline = 0;
+    if (timeout_ms > 0) {
+        uint32_t ticks = ((uint32_t)timeout_ms + 9) / 10;  /* 100Hz PIT */
+        deadline = timer_get_ticks() + ticks;
+    }
+
+    while (1) {
+        bool has_kbd = false;
+        int32_t ready = poll_scan(fds, nfds, &has_kbd);
+
+        if (ready > 0) {
+            return ready;
+        }
+        if (timeout_ms == 0 || !scheduler_running()) {
+            return 0;  /* Would block */
+        }
+        if (timeout_ms > 0 && (int32_t)(timer_get_ticks() - deadline) >= 0) {
+            return 0;  /* Timed out */
+        }
+
+        if (has_kbd || timeout_ms > 0) {
+            /* Keyboard input and deadlines have no waker for the poll
+             * queue; give up the slice and rescan next time around */
+            __asm__ volatile("sti");
+            yield();
+        } else {
+            /* Pipe-only set: sleep until a pipe state change wakes us */
+            sleep_on(pipe_poll_queue());
+        }
+    }
+}
+
+/*
+ * sys_shmget - Find or create a shared memory segment
+ * Returns: segment id, -1 on error
+ */
+int32_t sys_shmget(uint32_t key, uint32_t size, uint32_t a3, uint32_t a4, uint32_t a5) {
+    (void)a3; (void)a4; (void)a5;
+
+    return shm_get((int32_t)key, size);
+}
+
+/*
+ * sys_shmat - Map a shared segment into the calling process
+ * Returns: attach address, 0 on error
+ */
+int32_t sys_shmat(uint32_t id, uint32_t a2, uint32_t a3, uint32_t a4, uint32_t a5) {
+    (void)a2; (void)a3; (void)a4; (void)a5;
+
+    return (int32_t)shm_attach((int32_t)id);
+}
+
+/*
+ * sys_shmdt - Unmap a shared segment from the calling process
+ */
+int32_t sys_shmdt(uint32_t id, uint32_t a2, uint32_t a3, uint32_t a4, uint32_t a5) {
+    (void)a2; (void)a3; (void)a4; (void)a5;
+
+    return shm_detach((int32_t)id);
+}
+
+/*
+ * sys_shmrm - Free a segment no process has mapped
+ */
+int32_t sys_shmrm(uint32_t id, uint32_t a2, uint32_t a3, uint32_t a4, uint32_t a5) {
+    (void)a2; (void)a3; (void)a4; (void)a5;
+
+    return shm_remove((int32_t)id);
+}
+
+/*
+ * sys_mmap - Map an open file read-only into user space
+ * The mapping is recorded as a VMA, the same descriptor used for
+ * demand-paged ELF segments: no data is copied here, pages are read
+ * in from the file by the page fault handler on first access. A
+ * write to the mapping faults and kills the process. offset must be
+ * page-aligned.
+ * Returns: mapping address, 0 on error
+ */
+int32_t sys_mmap(uint32_t fd, uint32_t offset, uint32_t length, uint32_t a4, uint32_t a5) {
+    (void)a4; (void)a5;
+
+    process_t* proc = process_current();
+    if (proc == NULL || length == 0 || (offset & (PAGE_SIZE - 1)) != 0) {
+        return 0;
+    }
+
+    if (fd >= MAX_OPEN_FILES) {
+        return 0;
+    }
+    file_descriptor_t* file_desc = (file_descriptor_t*)proc->fd_table[fd];
+    if (file_desc == NULL || file_desc->is_pipe || file_desc->node == NULL) {
+        return 0;
+    }
+    vfs_node_t* node = file_desc->node;
+    if (node->flags & VFS_DIRECTORY) {
+        return 0;
+    }
+
+    /* Find a free VMA descriptor */
+    vma_t* vma = NULL;
+    for (int i = 0; i < MAX_VMAS; i++) {
+        if (!proc->vmas[i].used) {
+            vma = &proc->vmas[i];
+            break;
+        }
+    }
+    if (vma == NULL) {
+        return 0;
+    }
+
+    /* Place the mapping above any existing ones in the mmap window */
+    uint32_t base = USER_MMAP_BASE;
+    for (int i = 0; i < MAX_VMAS; i++) {
+        vma_t* v = &proc->vmas[i];
+        if (!v->used || v->vaddr < USER_MMAP_BASE || v->vaddr >= USER_MMAP_END) {
+            continue;
+        }
+        uint32_t end = PAGE_ALIGN_UP(v->vaddr + v->memsz);
+        if (end > base) base = end;
+    }
+    if (base + length < base || base + length > USER_MMAP_END) {
+        return 0;
+    }
+
+    vma->used = true;
+    vma->vaddr = base;
+    vma->memsz = length;
+    vma->file_offset = offset;
+    vma->file_size = (offset < node->length) ? node->length - offset : 0;
+    if (vma->file_size > length) {
+        vma->file_size = length;
+    }
+    vma->page_flags = PAGE_USER;    /* Read-only */
+
+    /* Pin the backing inode for the life of the mapping */
+    vma->file = node;
+    vfs_open(node, 0);
+
+    return (int32_t)base;
+}
+
+/*
+ * sys_munmap - Drop a mapping created by sys_mmap
+ * addr must be the address the mapping was created at.
+ * Returns 0 on success, -1 on error
+ */
+int32_t sys_munmap(uint32_t addr, uint32_t a2, uint32_t a3, uint32_t a4, uint32_t a5) {
+    (void)a2; (void)a3; (void)a4; (void)a5;
+
+    process_t* proc = process_current();
+    if (proc == NULL || addr < USER_MMAP_BASE || addr >= USER_MMAP_END) {
+        return -1;
+    }
+
+    for (int i = 0; i < MAX_VMAS; i++) {
+        vma_t* vma = &proc->vmas[i];
+        if (!vma->used || vma->vaddr != addr) {
+            continue;
+        }
+
+        /* Release the pages that were actually faulted in */
+        uint32_t start = PAGE_ALIGN_DOWN(vma->vaddr);
+        uint32_t end = PAGE_ALIGN_UP(vma->vaddr + vma->memsz);
+        for (uint32_t page = start; page < end; page += PAGE_SIZE) {
+            uint32_t phys = paging_get_physical(page);
+            if (phys != 0) {
+                paging_unmap_page(page);
+                pmm_free_frame(phys & ~0xFFF);
+            }
+        }
+
+        if (vma->file != NULL) {
+            vfs_close(vma->file);
+            vma->file = NULL;
+        }
+        vma->used = false;
+        return 0;
+    }
+
+    return -1;
+}
+
 /*
  * sys_dup2 - Duplicate file descriptor
  */
@@ -1015,6 +1481,163 @@ int32_t sys_signal(uint32_t signum, uint32_t handler, uint32_t a3, uint32_t a4,
     return -1;
 }
 
+/*
+ * sys_ioring - Drain a batched submission ring (SYS_IORING)
+ *
+ * The ring sits entirely in the caller's memory (see ioring_t in
+ * syscall.h). Every submission between sq_head and sq_tail is
+ * executed through the normal handlers and answered with one
+ * completion entry, so a batch of file operations costs a single
+ * kernel crossing. Returns the number of operations completed, -1 on
+ * a bad ring pointer.
+ */
+int32_t sys_ioring(uint32_t ring_ptr, uint32_t a2, uint32_t a3, uint32_t a4, uint32_t a5) {
+    (void)a2; (void)a3; (void)a4; (void)a5;
+
+    ioring_t* ring = (ioring_t*)ring_ptr;
+    if (ring == NULL || !access_ok(ring, sizeof(ioring_t), true)) {
+        return -1;
+    }
+
+    /* Snapshot the tail so a buggy producer cannot spin us forever */
+    uint32_t tail = ring->sq_tail;
+    if (tail - ring->sq_head > IORING_ENTRIES) {
+        return -1;
+    }
+
+    int32_t completed = 0;
+    while (ring->sq_head != tail) {
+        ioring_sqe_t* sqe = &ring->sqes[ring->sq_head & (IORING_ENTRIES - 1)];
+        int32_t result;
+
+        switch (sqe->opcode) {
+            case IORING_OP_NOP:
+                result = 0;
+                break;
+            case IORING_OP_READ:
+                result = sys_fread((uint32_t)sqe->fd, sqe->buf, sqe->len, 0, 0);
+                break;
+            case IORING_OP_WRITE:
+                result = sys_fwrite((uint32_t)sqe->fd, sqe->buf, sqe->len, 0, 0);
+                break;
+            case IORING_OP_OPEN:
+                result = sys_open(sqe->buf, sqe->len, 0, 0, 0);
+                break;
+            case IORING_OP_CLOSE:
+                result = sys_close((uint32_t)sqe->fd, 0, 0, 0, 0);
+                break;
+            default:
+                result = -1;
+                break;
+        }
+
+        ioring_cqe_t* cqe = &ring->cqes[ring->cq_tail & (IORING_ENTRIES - 1)];
+        cqe->user_data = sqe->user_data;
+        cqe->result = result;
+        ring->cq_tail++;
+        ring->sq_head++;
+        completed++;
+    }
+
+    return completed;
+}
+
+/*
+ * sys_fcntl - Descriptor control. Only the pipe-size commands exist
+ * for now: F_SETPIPE_SZ sets a pipe's growth cap (the buffer itself
+ * still grows on demand) and F_GETPIPE_SZ reads it back.
+ */
+int32_t sys_fcntl(uint32_t fd, uint32_t cmd, uint32_t arg, uint32_t a4, uint32_t a5) {
+    (void)a4; (void)a5;
+
+    file_descriptor_t* desc = fd_get((int32_t)fd);
+    if (desc == NULL) return -1;
+
+    switch (cmd) {
+        case F_GETPIPE_SZ:
+            if (!desc->is_pipe || desc->pipe == NULL) return -1;
+            return (int32_t)desc->pipe->max_capacity;
+        case F_SETPIPE_SZ:
+            if (!desc->is_pipe || desc->pipe == NULL) return -1;
+            return (int32_t)pipe_set_capacity(desc->pipe, arg);
+        default:
+            return -1;
+    }
+}
+
+/*
+ * sys_socket - Create a UDP datagram socket
+ * Returns a file descriptor; close() releases it like any other.
+ */
+int32_t sys_socket(uint32_t a1, uint32_t a2, uint32_t a3, uint32_t a4, uint32_t a5) {
+    (void)a1; (void)a2; (void)a3; (void)a4; (void)a5;
+
+    udp_socket_t* sock = socket_create();
+    if (sock == NULL) return -1;
+
+    int32_t fd = fd_alloc();
+    if (fd < 0) {
+        socket_close(sock);
+        return -1;
+    }
+
+    file_descriptor_t* desc = fd_get(fd);
+    desc->sock = sock;
+    desc->is_socket = true;
+    desc->flags = O_RDWR;
+    return fd;
+}
+
+/*
+ * sys_bind - Bind a socket to a local UDP port
+ */
+int32_t sys_bind(uint32_t fd, uint32_t port, uint32_t a3, uint32_t a4, uint32_t a5) {
+    (void)a3; (void)a4; (void)a5;
+
+    file_descriptor_t* desc = fd_get((int32_t)fd);
+    if (desc == NULL || !desc->is_socket || desc->sock == NULL) return -1;
+    if (port == 0 || port > 0xFFFF) return -1;
+
+    return socket_bind(desc->sock, (uint16_t)port);
+}
+
+/*
+ * sys_sendto - Send a datagram to ip:port (both host order)
+ * Returns bytes sent, or -1.
+ */
+int32_t sys_sendto(uint32_t fd, uint32_t buf_ptr, uint32_t len, uint32_t ip, uint32_t port) {
+    file_descriptor_t* desc = fd_get((int32_t)fd);
+    if (desc == NULL || !desc->is_socket || desc->sock == NULL) return -1;
+    if (buf_ptr == 0 || port == 0 || port > 0xFFFF) return -1;
+
+    return socket_sendto(desc->sock, (const void*)buf_ptr, len,
+                         ip, (uint16_t)port);
+}
+
+/*
+ * sys_recvfrom - Receive one datagram, blocking until one arrives
+ * from_ptr, when non-zero, points at uint32_t[2] that receives the
+ * source {ip, port}. Returns bytes copied, or -1.
+ */
+int32_t sys_recvfrom(uint32_t fd, uint32_t buf_ptr, uint32_t len, uint32_t from_ptr, uint32_t a5) {
+    (void)a5;
+
+    file_descriptor_t* desc = fd_get((int32_t)fd);
+    if (desc == NULL || !desc->is_socket || desc->sock == NULL) return -1;
+    if (buf_ptr == 0) return -1;
+
+    uint32_t src_ip = 0;
+    uint16_t src_port = 0;
+    int32_t n = socket_recvfrom(desc->sock, (void*)buf_ptr, len,
+                                &src_ip, &src_port);
+    if (n >= 0 && from_ptr != 0) {
+        uint32_t* from = (uint32_t*)from_ptr;
+        from[0] = src_ip;
+        from[1] = src_port;
+    }
+    return n;
+}
+
 /*
  * Register a system call handler
  */
@@ -1065,10 +1688,31 @@ void syscall_init(void) {
     syscall_register(SYS_DUP2, sys_dup2);
     syscall_register(SYS_KILL, sys_kill);
     syscall_register(SYS_SIGNAL, sys_signal);
+    syscall_register(SYS_POLL, sys_poll);
+    syscall_register(SYS_SHMGET, sys_shmget);
+    syscall_register(SYS_SHMAT, sys_shmat);
+    syscall_register(SYS_SHMDT, sys_shmdt);
+    syscall_register(SYS_SHMRM, sys_shmrm);
+    syscall_register(SYS_READV, sys_readv);
+    syscall_register(SYS_WRITEV, sys_writev);
+    syscall_register(SYS_GETTIME, sys_gettime);
+    syscall_register(SYS_MMAP, sys_mmap);
+    syscall_register(SYS_MUNMAP, sys_munmap);
+    syscall_register(SYS_SPAWN, sys_spawn);
+    syscall_register(SYS_TTYMODE, sys_ttymode);
+    syscall_register(SYS_IORING, sys_ioring);
+    syscall_register(SYS_FCNTL, sys_fcntl);
+    syscall_register(SYS_SOCKET, sys_socket);
+    syscall_register(SYS_BIND, sys_bind);
+    syscall_register(SYS_SENDTO, sys_sendto);
+    syscall_register(SYS_RECVFROM, sys_recvfrom);
 
     /* Initialize file descriptor table */
     fd_init();
 
+    /* Initialize shared memory segments */
+    shm_init();
+
     /* Register INT 0x80 handler */
     /* Note: We need to set this up with ring 3 access so user mode can call it */
     extern void isr128(void);  /* Defined in interrupts.asm */
@@ -1080,6 +1724,24 @@ void syscall_init(void) {
     /* Register the C handler for ISR 128 */
     isr_register_handler(0x80, syscall_handler);
 
+    /* Enable the SYSENTER fast path when the CPU has SEP. SYSEXIT
+     * derives user CS/SS from IA32_SYSENTER_CS + 16/24, which lines
+     * up with this GDT (0x08 kernel code -> 0x18/0x20 user). INT 0x80
+     * stays as the fallback for older CPUs and >3 argument calls. */
+    uint32_t cpuid_eax, cpuid_edx;
+    __asm__ volatile("cpuid"
+                     : "=a"(cpuid_eax), "=d"(cpuid_edx)
+                     : "a"(1)
+                     : "ebx", "ecx");
+    if (cpuid_edx & (1 << 11)) {
+        extern void sysenter_entry(void);
+        wrmsr(MSR_SYSENTER_CS, GDT_KERNEL_CODE, 0);
+        wrmsr(MSR_SYSENTER_ESP, 0, 0);  /* Set when a process runs */
+        wrmsr(MSR_SYSENTER_EIP, (uint32_t)sysenter_entry, 0);
+        sysenter_enabled = true;
+        printk("Syscall: SYSENTER fast path enabled\n");
+    }
+
     printk("Syscall: Initialized (%d syscalls)\n", NUM_SYSCALLS);
 }
 
@@ -12,6 +12,23 @@
 static user_t users[MAX_USERS];
 static group_t groups[MAX_GROUPS];
 
+/*
+ * uid→slot and gid→slot indexes. Permission checks (vfs_check_read
+ * et al.) and `ls -l` name resolution call user_get()/group_get() per
+ * file; open-addressed hash probes make those O(1) instead of a scan
+ * of the whole table. Tables are at most half full (size is twice the
+ * slot count), so a probe always terminates at an empty entry.
+ * Entries store slot+1, 0 means empty; the index is rebuilt lazily
+ * after useradd/userdel-style mutations.
+ */
+#define USER_INDEX_SIZE     (MAX_USERS * 2)
+#define GROUP_INDEX_SIZE    (MAX_GROUPS * 2)
+
+static uint8_t user_index[USER_INDEX_SIZE];
+static uint8_t group_index[GROUP_INDEX_SIZE];
+static bool user_index_stale = true;
+static bool group_index_stale = true;
+
 /* Current logged-in user */
 uint32_t current_uid = ROOT_UID;
 uint32_t current_gid = ROOT_GID;
@@ -19,6 +36,38 @@ uint32_t current_gid = ROOT_GID;
 /* Forward declaration for creating home directories */
 static void create_user_home(const char* username, const char* home_path);
 
+static inline uint32_t id_hash(uint32_t id, uint32_t size) {
+    return (id * 2654435761u) & (size - 1);
+}
+
+/*
+ * Rebuild the uid index from the active user slots.
+ */
+static void user_index_rebuild(void) {
+    memset(user_index, 0, sizeof(user_index));
+    for (int i = 0; i < MAX_USERS; i++) {
+        if (!users[i].is_active) continue;
+        uint32_t h = id_hash(users[i].uid, USER_INDEX_SIZE);
+        while (user_index[h]) h = (h + 1) & (USER_INDEX_SIZE - 1);
+        user_index[h] = (uint8_t)(i + 1);
+    }
+    user_index_stale = false;
+}
+
+/*
+ * Rebuild the gid index from the active group slots.
+ */
+static void group_index_rebuild(void) {
+    memset(group_index, 0, sizeof(group_index));
+    for (int i = 0; i < MAX_GROUPS; i++) {
+        if (!groups[i].is_active) continue;
+        uint32_t h = id_hash(groups[i].gid, GROUP_INDEX_SIZE);
+        while (group_index[h]) h = (h + 1) & (GROUP_INDEX_SIZE - 1);
+        group_index[h] = (uint8_t)(i + 1);
+    }
+    group_index_stale = false;
+}
+
 /*
  * Initialize user subsystem
  */
@@ -26,6 +75,8 @@ void user_init(void) {
     /* Clear databases */
     memset(users, 0, sizeof(users));
     memset(groups, 0, sizeof(groups));
+    user_index_stale = true;
+    group_index_stale = true;
 
     /* Create directory structure */
 
@@ -131,6 +182,7 @@ int user_add(const char* username, const char* password, uint32_t uid, uint32_t
             strncpy(users[i].home, home ? home : "/", MAX_HOME_PATH - 1);
             users[i].home[MAX_HOME_PATH - 1] = '\0';
             users[i].is_active = 1;
+            user_index_stale = true;
             return 0;
         }
     }
@@ -147,6 +199,7 @@ int user_del(uint32_t uid) {
     for (int i = 0; i < MAX_USERS; i++) {
         if (users[i].is_active && users[i].uid == uid) {
             users[i].is_active = 0;
+            user_index_stale = true;
             return 0;
         }
     }
@@ -157,10 +210,12 @@ int user_del(uint32_t uid) {
  * Get user by UID
  */
 user_t* user_get(uint32_t uid) {
-    for (int i = 0; i < MAX_USERS; i++) {
-        if (users[i].is_active && users[i].uid == uid) {
-            return &users[i];
-        }
+    if (user_index_stale) user_index_rebuild();
+    uint32_t h = id_hash(uid, USER_INDEX_SIZE);
+    while (user_index[h]) {
+        user_t* user = &users[user_index[h] - 1];
+        if (user->uid == uid) return user;
+        h = (h + 1) & (USER_INDEX_SIZE - 1);
     }
     return NULL;
 }
@@ -216,6 +271,7 @@ int user_login(const char* username, const char* password) {
     
     current_uid = user->uid;
     current_gid = user->gid;
+    vfs_perm_invalidate();
     return 0;
 }
 
@@ -225,6 +281,7 @@ int user_login(const char* username, const char* password) {
 void user_logout(void) {
     current_uid = ROOT_UID;
     current_gid = ROOT_GID;
+    vfs_perm_invalidate();
 }
 
 /*
@@ -238,6 +295,7 @@ int user_switch(uint32_t uid, const char* password) {
     if (current_uid == ROOT_UID) {
         current_uid = user->uid;
         current_gid = user->gid;
+        vfs_perm_invalidate();
         return 0;
     }
 
@@ -247,6 +305,7 @@ int user_switch(uint32_t uid, const char* password) {
 
     current_uid = user->uid;
     current_gid = user->gid;
+    vfs_perm_invalidate();
     return 0;
 }
 
@@ -272,6 +331,7 @@ int group_add(const char* groupname, uint32_t gid) {
             groups[i].groupname[MAX_USERNAME - 1] = '\0';
             groups[i].member_count = 0;
             groups[i].is_active = 1;
+            group_index_stale = true;
             return 0;
         }
     }
@@ -288,6 +348,7 @@ int group_del(uint32_t gid) {
     for (int i = 0; i < MAX_GROUPS; i++) {
         if (groups[i].is_active && groups[i].gid == gid) {
             groups[i].is_active = 0;
+            group_index_stale = true;
             return 0;
         }
     }
@@ -298,10 +359,12 @@ int group_del(uint32_t gid) {
  * Get group by GID
  */
 group_t* group_get(uint32_t gid) {
-    for (int i = 0; i < MAX_GROUPS; i++) {
-        if (groups[i].is_active && groups[i].gid == gid) {
-            return &groups[i];
-        }
+    if (group_index_stale) group_index_rebuild();
+    uint32_t h = id_hash(gid, GROUP_INDEX_SIZE);
+    while (group_index[h]) {
+        group_t* group = &groups[group_index[h] - 1];
+        if (group->gid == gid) return group;
+        h = (h + 1) & (GROUP_INDEX_SIZE - 1);
     }
     return NULL;
 }
@@ -335,6 +398,7 @@ int group_add_member(uint32_t gid, uint32_t uid) {
     if (group->member_count >= MAX_GROUP_MEMBERS) return -1;
 
     group->members[group->member_count++] = uid;
+    vfs_perm_invalidate();
     return 0;
 }
 
@@ -352,6 +416,7 @@ int group_remove_member(uint32_t gid, uint32_t uid) {
                 group->members[j] = group->members[j + 1];
             }
             group->member_count--;
+            vfs_perm_invalidate();
             return 0;
         }
     }
@@ -17,6 +17,7 @@ static xgui_window_t* clock_window = NULL;
 
 /* Last drawn second — used to detect when to redraw */
 static uint8_t last_second = 255;
+static int clock_timer = -1;
 
 /*
  * Fixed-point sine table (0..90 degrees inclusive), scaled by 1024.
@@ -247,15 +248,19 @@ static void analogclock_paint(xgui_window_t* win) {
  */
 static void analogclock_handler(xgui_window_t* win, xgui_event_t* event) {
     if (event->type == XGUI_EVENT_WINDOW_CLOSE) {
+        xgui_timer_cancel(clock_timer);
+        clock_timer = -1;
         xgui_window_destroy(win);
         clock_window = NULL;
     }
 }
 
 /*
- * Update callback — called from the main loop to refresh every second
+ * Timer callback — checks for a second-hand change four times a
+ * second (the RTC second boundary is not phase-locked to the PIT, so
+ * an exact one-second period would tick up to a second late)
  */
-void xgui_analogclock_update(void) {
+static void analogclock_tick(void) {
     if (!clock_window) return;
 
     rtc_time_t now;
@@ -291,4 +296,5 @@ void xgui_analogclock_create(void) {
     xgui_window_set_bgcolor(clock_window, XGUI_RGB(240, 240, 240));
 
     last_second = 255;
+    clock_timer = xgui_timer_every(25, analogclock_tick);  /* 250ms at 100Hz */
 }
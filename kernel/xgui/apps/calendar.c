@@ -44,6 +44,7 @@
 
 /* State */
 static xgui_window_t* cal_window = NULL;
+static int cal_timer = -1;
 static int cal_month = 1;   /* 1-12 */
 static int cal_year = 2026;
 static int cal_sel_day = 0; /* 0 = no selection */
@@ -326,11 +327,20 @@ static int cal_hit_day(int mx, int my, int cw) {
     return day;
 }
 
+/*
+ * Timer callback — repaint so the today-highlight tracks the date
+ */
+static void cal_tick(void) {
+    if (cal_window) xgui_window_invalidate(cal_window);
+}
+
 /*
  * Event handler
  */
 static void cal_handler(xgui_window_t* win, xgui_event_t* event) {
     if (event->type == XGUI_EVENT_WINDOW_CLOSE) {
+        xgui_timer_cancel(cal_timer);
+        cal_timer = -1;
         xgui_window_destroy(win);
         cal_window = NULL;
         cal_input_mode = 0;
@@ -477,4 +487,7 @@ void xgui_calendar_create(void) {
     cal_window->bg_color = CAL_BG;
     xgui_window_set_paint(cal_window, cal_paint);
     xgui_window_set_handler(cal_window, cal_handler);
+
+    /* Refresh once a minute so the today-highlight survives midnight */
+    cal_timer = xgui_timer_every(6000, cal_tick);
 }
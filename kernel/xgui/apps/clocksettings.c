@@ -14,6 +14,7 @@
 
 /* Window */
 static xgui_window_t* clock_win = NULL;
+static int clock_timer_id = -1;
 
 /* Widgets */
 static xgui_widget_t* tz_field = NULL;
@@ -262,12 +263,21 @@ static void apply_time_click(xgui_widget_t* widget) {
     if (clock_win) xgui_window_invalidate(clock_win);
 }
 
+/*
+ * Timer callback — repaint so the time preview ticks once a second
+ */
+static void clock_settings_tick(void) {
+    if (clock_win) xgui_window_invalidate(clock_win);
+}
+
 /*
  * Close button click
  */
 static void close_click(xgui_widget_t* widget) {
     (void)widget;
     if (clock_win) {
+        xgui_timer_cancel(clock_timer_id);
+        clock_timer_id = -1;
         xgui_window_destroy(clock_win);
         clock_win = NULL;
         tz_field = NULL;
@@ -286,6 +296,8 @@ static void clock_settings_handler(xgui_window_t* win, xgui_event_t* event) {
     }
 
     if (event->type == XGUI_EVENT_WINDOW_CLOSE) {
+        xgui_timer_cancel(clock_timer_id);
+        clock_timer_id = -1;
         xgui_window_destroy(win);
         clock_win = NULL;
         tz_field = NULL;
@@ -389,6 +401,8 @@ void xgui_clock_settings_create(void) {
     xgui_window_set_paint(clock_win, clock_settings_paint);
     xgui_window_set_handler(clock_win, clock_settings_handler);
 
+    clock_timer_id = xgui_timer_every(100, clock_settings_tick);  /* 1s at 100Hz */
+
     /* Get current adjusted time for field defaults */
     rtc_time_t now;
     rtc_get_adjusted_time(&now);
@@ -187,6 +187,7 @@ static void theme_button_click(xgui_widget_t* widget) {
 static void font_button_click(xgui_widget_t* widget) {
     int id = (int)(uint32_t)xgui_widget_get_userdata(widget);
     xgui_font_set(id);
+    xgui_desktop_invalidate_icons();
     xgui_font_save_config();
     if (cp_window) cp_window->dirty = true;
 }
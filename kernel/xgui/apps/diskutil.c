@@ -62,6 +62,8 @@ typedef struct {
     bool has_fs_stats;
     ext2_fs_stats_t fs_stats;
     char mount_path[32];
+    /* I/O counters snapshot */
+    blockdev_stats_t io;
 } du_dev_t;
 
 static du_dev_t du_devs[DU_MAX_DEVS];
@@ -104,6 +106,7 @@ static void du_refresh(void) {
         d->size_mb = bdev->size_mb;
         d->start_lba = bdev->start_lba;
         d->partition_count = bdev->partition_count;
+        d->io = bdev->stats;
 
         /* Copy partition table for whole disks */
         if (bdev->type == BLOCKDEV_TYPE_DISK) {
@@ -305,6 +308,68 @@ static void du_paint(xgui_window_t* win) {
 
     dy += DU_SECTION_GAP;
 
+    /* --- I/O Statistics section --- */
+    if (dy + 70 < DU_DETAIL_Y + detail_h) {
+        blockdev_stats_t* st = &dev->io;
+
+        xgui_win_text_transparent(win, dx, dy, "I/O Statistics", XGUI_BLACK);
+        dy += DU_LABEL_H + 4;
+        xgui_win_hline(win, dx, dy, detail_w - 16, XGUI_LIGHT_GRAY);
+        dy += 4;
+
+        snprintf(buf, sizeof(buf), "%u reads / %u writes", st->reads, st->writes);
+        dy = du_draw_field(win, dx, dy, lw, "Operations:", buf);
+
+        snprintf(buf, sizeof(buf), "%u read / %u written",
+                 st->read_sectors, st->write_sectors);
+        dy = du_draw_field(win, dx, dy, lw, "Sectors:", buf);
+
+        snprintf(buf, sizeof(buf), "%u now / %u peak",
+                 st->queue_depth, st->queue_max);
+        dy = du_draw_field(win, dx, dy, lw, "Queue:", buf);
+
+        /* Latency histogram: one bar pair per log2-us bucket, reads
+         * blue and writes orange, scaled to the tallest bucket */
+        if ((st->reads > 0 || st->writes > 0) &&
+            dy + 46 < DU_DETAIL_Y + detail_h) {
+            uint32_t max_count = 1;
+            for (int b = 0; b < BLOCKDEV_LAT_BUCKETS; b++) {
+                if (st->read_lat[b] > max_count) max_count = st->read_lat[b];
+                if (st->write_lat[b] > max_count) max_count = st->write_lat[b];
+            }
+
+            int hist_h = 24;
+            int bar_w = 6;
+            int pair_w = bar_w * 2 + 2;
+            for (int b = 0; b < BLOCKDEV_LAT_BUCKETS; b++) {
+                int bx = dx + b * pair_w;
+                int rh = (int)(st->read_lat[b] * (uint32_t)hist_h / max_count);
+                int wh = (int)(st->write_lat[b] * (uint32_t)hist_h / max_count);
+                if (rh == 0 && st->read_lat[b] > 0) rh = 1;
+                if (wh == 0 && st->write_lat[b] > 0) wh = 1;
+                if (rh > 0) {
+                    xgui_win_rect_filled(win, bx, dy + hist_h - rh,
+                                         bar_w, rh, XGUI_RGB(70, 130, 180));
+                }
+                if (wh > 0) {
+                    xgui_win_rect_filled(win, bx + bar_w, dy + hist_h - wh,
+                                         bar_w, wh, XGUI_RGB(180, 100, 70));
+                }
+            }
+            xgui_win_hline(win, dx, dy + hist_h,
+                           BLOCKDEV_LAT_BUCKETS * pair_w, XGUI_DARK_GRAY);
+            dy += hist_h + 3;
+
+            /* Axis: buckets run from 1 us to 32+ ms */
+            xgui_win_text_transparent(win, dx, dy, "1us", XGUI_DARK_GRAY);
+            xgui_win_text_transparent(win, dx + BLOCKDEV_LAT_BUCKETS * pair_w - 44,
+                                      dy, "32ms+", XGUI_DARK_GRAY);
+            dy += DU_LABEL_H;
+        }
+
+        dy += DU_SECTION_GAP;
+    }
+
     /* --- ATA Info section (for physical disks) --- */
     if (dev->has_ata) {
         xgui_win_text_transparent(win, dx, dy, "Hardware Information", XGUI_BLACK);
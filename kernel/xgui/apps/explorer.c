@@ -16,7 +16,6 @@
 #include "string.h"
 #include "stdio.h"
 #include "heap.h"
-#include "timer.h"
 
 /* Explorer configuration */
 #define EXPLORER_WIDTH      540
@@ -66,6 +65,17 @@ static int entry_count = 0;
 static int selected_index = -1;
 static int scroll_offset = 0;
 
+/* Cached list geometry, filled in by explorer_paint. The incremental
+ * repaint paths (selection moves, one-row scrolls) reuse it instead of
+ * re-deriving the layout, and only touch the rows that changed. */
+static int vl_rx = 0;       /* List left edge */
+static int vl_rw = 0;       /* List width */
+static int vl_item_y = 0;   /* Top of first row (below column header) */
+static int vl_visible = 0;  /* Rows that fit in the list area */
+static int vl_cw = 0;       /* Client width (for the size column) */
+
+static void list_select(int idx);
+
 /* Context menu state */
 #define CTX_MENU_W      180
 #define CTX_MENU_ITEM_H 20
@@ -171,14 +181,17 @@ static void load_directory(const char* path) {
         }
     }
 
-    /* Read directory entries */
-    uint32_t index = 0;
+    /* Read directory entries in one pass */
+    vfs_dir_cursor_t cursor;
     dirent_t* dirent;
+    if (vfs_opendir(dir, &cursor) != 0) {
+        if (explorer_window) explorer_window->dirty = true;
+        return;
+    }
 
-    while ((dirent = vfs_readdir(dir, index)) != NULL && entry_count < MAX_DIR_ENTRIES) {
+    while ((dirent = vfs_readdir_next(&cursor)) != NULL && entry_count < MAX_DIR_ENTRIES) {
         /* Skip . and .. */
         if (strcmp(dirent->name, ".") == 0 || strcmp(dirent->name, "..") == 0) {
-            index++;
             continue;
         }
 
@@ -199,7 +212,6 @@ static void load_directory(const char* path) {
         }
 
         entry_count++;
-        index++;
     }
 
     /* Sort entries */
@@ -251,8 +263,7 @@ static void handle_item_click(int item_index) {
         return;
     }
 
-    selected_index = item_index;
-    if (explorer_window) explorer_window->dirty = true;
+    list_select(item_index);
 }
 
 /*
@@ -302,17 +313,6 @@ static int explorer_copy_file(const char* src_path, const char* dest_dir) {
     }
     if (!fname[0]) return -1;
 
-    /* Read source file */
-    uint32_t size = src->length;
-    uint8_t* buf = NULL;
-    if (size > 0) {
-        buf = (uint8_t*)kmalloc(size);
-        if (!buf) return -1;
-        int32_t rd = vfs_read(src, 0, size, buf);
-        if (rd < 0) { kfree(buf); return -1; }
-        size = (uint32_t)rd;
-    }
-
     /* Build destination path */
     char dest_path[VFS_MAX_PATH];
     if (strcmp(dest_dir, "/") == 0) {
@@ -329,21 +329,17 @@ static int explorer_copy_file(const char* src_path, const char* dest_dir) {
     } else {
         /* Create new file in destination directory */
         vfs_node_t* parent = vfs_lookup(dest_dir);
-        if (!parent) { if (buf) kfree(buf); return -1; }
+        if (!parent) return -1;
         if (parent->readdir == ext2_vfs_readdir) {
             dst = ext2_create_file(parent, fname);
         } else {
             dst = ramfs_create_file_in(parent, fname, VFS_FILE);
         }
-        if (!dst) { if (buf) kfree(buf); return -1; }
+        if (!dst) return -1;
     }
 
-    /* Write data */
-    if (size > 0 && buf) {
-        vfs_write(dst, 0, size, buf);
-        kfree(buf);
-    }
-    return 0;
+    /* Stream the contents through the shared copy engine */
+    return vfs_copy_file(src, dst, NULL) < 0 ? -1 : 0;
 }
 
 /*
@@ -488,6 +484,212 @@ static void draw_sidebar(xgui_window_t* win, int ch) {
     }
 }
 
+/*
+ * Paint one visible row slot using the cached list geometry.
+ * Slots past the end of the directory are cleared to the background.
+ */
+static void draw_list_row(xgui_window_t* win, int i) {
+    int idx = i + scroll_offset;
+    int y = vl_item_y + i * ITEM_HEIGHT;
+    uint32_t accent = xgui_theme_current()->selection;
+
+    if (idx < 0 || idx >= entry_count) {
+        xgui_win_rect_filled(win, vl_rx, y, vl_rw - 16, ITEM_HEIGHT, XGUI_WHITE);
+        return;
+    }
+    explorer_entry_t* entry = &entries[idx];
+
+    /* Row background: alternating (by entry, so it scrolls with the
+     * content) or selected */
+    uint32_t row_bg = (idx % 2 == 0) ? XGUI_WHITE : XGUI_RGB(247, 249, 252);
+    bool is_selected = (idx == selected_index);
+
+    if (is_selected) {
+        /* Selection highlight with subtle gradient */
+        for (int row = 0; row < ITEM_HEIGHT; row++) {
+            int r1 = (accent >> 16) & 0xFF, g1 = (accent >> 8) & 0xFF, b1 = accent & 0xFF;
+            int r = r1 + (20 - row * 40 / ITEM_HEIGHT);
+            int g = g1 + (20 - row * 40 / ITEM_HEIGHT);
+            int b = b1 + (20 - row * 40 / ITEM_HEIGHT);
+            if (r > 255) r = 255;
+            if (r < 0) r = 0;
+            if (g > 255) g = 255;
+            if (g < 0) g = 0;
+            if (b > 255) b = 255;
+            if (b < 0) b = 0;
+            xgui_win_hline(win, vl_rx, y + row, vl_rw - 16, XGUI_RGB(r, g, b));
+        }
+    } else {
+        xgui_win_rect_filled(win, vl_rx, y, vl_rw - 16, ITEM_HEIGHT, row_bg);
+    }
+
+    uint32_t text_color = is_selected ? XGUI_WHITE : XGUI_RGB(30, 30, 30);
+
+    /* Icon */
+    int icon_x = vl_rx + 6;
+    int icon_y = y + (ITEM_HEIGHT - 10) / 2;
+    if (entry->is_dir) {
+        if (!is_selected) draw_folder_icon(win, icon_x, icon_y);
+        else {
+            xgui_win_rect_filled(win, icon_x, icon_y, 5, 2, XGUI_RGB(255, 240, 160));
+            xgui_win_rect_filled(win, icon_x, icon_y + 2, 12, 8, XGUI_RGB(255, 240, 160));
+            xgui_win_rect(win, icon_x, icon_y + 2, 12, 8, XGUI_RGB(255, 255, 200));
+        }
+    } else {
+        if (!is_selected) draw_file_icon(win, icon_x + 1, icon_y);
+        else {
+            xgui_win_rect_filled(win, icon_x + 1, icon_y, 10, 12, XGUI_RGB(255, 255, 255));
+            xgui_win_rect(win, icon_x + 1, icon_y, 10, 12, XGUI_RGB(200, 220, 255));
+        }
+    }
+
+    /* Name */
+    char name_buf[40];
+    int max_name = (vl_rw - 120) / 8;
+    if (max_name > 35) max_name = 35;
+    if (max_name < 8) max_name = 8;
+    strncpy(name_buf, entry->name, max_name);
+    name_buf[max_name] = '\0';
+    if ((int)strlen(entry->name) > max_name) strcat(name_buf, "...");
+    xgui_win_text_transparent(win, vl_rx + 24, y + 4, name_buf, text_color);
+
+    /* Size */
+    if (!entry->is_dir) {
+        char size_buf[16];
+        format_size(entry->size, size_buf, sizeof(size_buf));
+        xgui_win_text_transparent(win, vl_cw - 80, y + 4, size_buf,
+                                  is_selected ? XGUI_RGB(220, 230, 255) : XGUI_RGB(100, 100, 100));
+    } else {
+        xgui_win_text_transparent(win, vl_cw - 80, y + 4, "<DIR>",
+                                  is_selected ? XGUI_RGB(220, 230, 255) : XGUI_RGB(140, 140, 140));
+    }
+
+    /* Subtle bottom border per row */
+    if (!is_selected) {
+        xgui_win_hline(win, vl_rx, y + ITEM_HEIGHT - 1, vl_rw - 16, XGUI_RGB(235, 235, 235));
+    }
+}
+
+/*
+ * Draw the list scrollbar (arrow buttons, track, thumb) from the
+ * cached geometry
+ */
+static void draw_list_scrollbar(xgui_window_t* win) {
+    int sb_x = vl_cw - 14;
+    int sb_full_y = vl_item_y;
+    int sb_full_h = vl_visible * ITEM_HEIGHT;
+    int sb_btn_h = 14;
+
+    if (entry_count <= vl_visible || vl_visible <= 0) {
+        return;
+    }
+
+    xgui_win_rect_filled(win, sb_x, sb_full_y, 14, sb_full_h, XGUI_RGB(240, 240, 240));
+    xgui_win_vline(win, sb_x, sb_full_y, sb_full_h, XGUI_RGB(210, 210, 210));
+
+    /* Up arrow button */
+    xgui_win_rect_filled(win, sb_x, sb_full_y, 14, sb_btn_h, XGUI_RGB(225, 225, 228));
+    xgui_win_rect(win, sb_x, sb_full_y, 14, sb_btn_h, XGUI_RGB(190, 190, 190));
+    xgui_win_hline(win, sb_x + 1, sb_full_y + 1, 12, XGUI_RGB(245, 245, 248));
+    for (int r = 0; r < 4; r++) {
+        xgui_win_hline(win, sb_x + 7 - r, sb_full_y + 4 + r, r * 2 + 1, XGUI_RGB(80, 80, 80));
+    }
+
+    /* Down arrow button */
+    int dn_y = sb_full_y + sb_full_h - sb_btn_h;
+    xgui_win_rect_filled(win, sb_x, dn_y, 14, sb_btn_h, XGUI_RGB(225, 225, 228));
+    xgui_win_rect(win, sb_x, dn_y, 14, sb_btn_h, XGUI_RGB(190, 190, 190));
+    xgui_win_hline(win, sb_x + 1, dn_y + 1, 12, XGUI_RGB(245, 245, 248));
+    for (int r = 0; r < 4; r++) {
+        xgui_win_hline(win, sb_x + 7 - r, dn_y + 9 - r, r * 2 + 1, XGUI_RGB(80, 80, 80));
+    }
+
+    /* Track area */
+    int track_y = sb_full_y + sb_btn_h;
+    int track_h = sb_full_h - sb_btn_h * 2;
+
+    if (track_h > 4) {
+        int thumb_h = (vl_visible * track_h) / entry_count;
+        if (thumb_h < 16) thumb_h = 16;
+        int scroll_range = entry_count - vl_visible;
+        int thumb_y = track_y;
+        if (scroll_range > 0)
+            thumb_y = track_y + (scroll_offset * (track_h - thumb_h)) / scroll_range;
+
+        xgui_win_rect_filled(win, sb_x + 1, thumb_y, 12, thumb_h, XGUI_RGB(180, 180, 185));
+        xgui_win_hline(win, sb_x + 2, thumb_y, 10, XGUI_RGB(210, 210, 215));
+        xgui_win_hline(win, sb_x + 2, thumb_y + thumb_h - 1, 10, XGUI_RGB(155, 155, 160));
+        int grip_y = thumb_y + thumb_h / 2 - 3;
+        for (int g = 0; g < 3; g++) {
+            xgui_win_hline(win, sb_x + 4, grip_y + g * 3, 6, XGUI_RGB(155, 155, 160));
+            xgui_win_hline(win, sb_x + 4, grip_y + g * 3 + 1, 6, XGUI_RGB(210, 210, 215));
+        }
+    }
+}
+
+/*
+ * Repaint a single entry's row in place and composite it, without
+ * running the full paint callback. Falls back to a full repaint when
+ * the cached geometry is stale or the context menu is up.
+ */
+static void list_refresh_entry(int idx) {
+    xgui_window_t* win = explorer_window;
+    if (!win) return;
+    if (win->dirty) return;
+    if (vl_visible <= 0 || ctx_menu_visible) {
+        win->dirty = true;
+        return;
+    }
+    int i = idx - scroll_offset;
+    if (i < 0 || i >= vl_visible) return;   /* Off-screen: nothing to paint */
+    draw_list_row(win, i);
+    win->expose = true;
+}
+
+/*
+ * Change the selection, repainting only the two affected rows
+ */
+static void list_select(int idx) {
+    int old = selected_index;
+    if (old == idx) return;
+    selected_index = idx;
+    list_refresh_entry(old);
+    list_refresh_entry(idx);
+}
+
+/*
+ * Scroll the list to new_offset. One-row steps shift the row band with
+ * copy_rect and paint just the incoming row plus the scrollbar thumb;
+ * larger jumps repaint the whole window.
+ */
+static void list_scroll_to(int new_offset) {
+    xgui_window_t* win = explorer_window;
+    int delta = new_offset - scroll_offset;
+    if (delta == 0) return;
+    scroll_offset = new_offset;
+    if (!win) return;
+    if (win->dirty || vl_visible <= 1 || ctx_menu_visible ||
+        (delta != 1 && delta != -1)) {
+        win->dirty = true;
+        return;
+    }
+
+    int band_h = (vl_visible - 1) * ITEM_HEIGHT;
+    if (delta == 1) {
+        /* Content moves up: shift rows 1..n-1 into 0..n-2, paint the last */
+        xgui_win_copy_rect(win, vl_rx, vl_item_y,
+                           vl_rx, vl_item_y + ITEM_HEIGHT, vl_rw - 16, band_h);
+        draw_list_row(win, vl_visible - 1);
+    } else {
+        /* Content moves down: shift rows 0..n-2 into 1..n-1, paint the first */
+        xgui_win_copy_rect(win, vl_rx, vl_item_y + ITEM_HEIGHT,
+                           vl_rx, vl_item_y, vl_rw - 16, band_h);
+        draw_list_row(win, 0);
+    }
+    draw_list_scrollbar(win);
+    win->expose = true;
+}
+
 /*
  * Window paint callback
  * All coordinates are client-relative (0,0 = top-left of client area).
@@ -496,7 +698,6 @@ static void draw_sidebar(xgui_window_t* win, int ch) {
 static void explorer_paint(xgui_window_t* win) {
     int cw = win->client_width;
     int ch = win->client_height;
-    uint32_t accent = xgui_theme_current()->selection;
 
     /* Right pane starts after sidebar */
     int rx = SIDEBAR_WIDTH;
@@ -564,140 +765,24 @@ static void explorer_paint(xgui_window_t* win) {
     xgui_win_text_transparent(win, rx + 24, header_y + 4, "Name", XGUI_RGB(80, 80, 80));
     xgui_win_text_transparent(win, cw - 80, header_y + 4, "Size", XGUI_RGB(80, 80, 80));
 
-    /* --- Draw entries --- */
+    /* --- Draw entries (virtualized: only the visible row slots) --- */
     int item_y = header_y + header_h;
     int visible_items = (list_h - header_h) / ITEM_HEIGHT;
     if (visible_items > MAX_VISIBLE_ITEMS) visible_items = MAX_VISIBLE_ITEMS;
 
-    uint32_t row_even = XGUI_WHITE;
-    uint32_t row_odd  = XGUI_RGB(247, 249, 252);
-
-    for (int i = 0; i < visible_items && (i + scroll_offset) < entry_count; i++) {
-        int idx = i + scroll_offset;
-        explorer_entry_t* entry = &entries[idx];
-        int y = item_y + i * ITEM_HEIGHT;
-
-        /* Row background: alternating or selected */
-        uint32_t row_bg = (i % 2 == 0) ? row_even : row_odd;
-        bool is_selected = (idx == selected_index);
-
-        if (is_selected) {
-            /* Selection highlight with subtle gradient */
-            for (int row = 0; row < ITEM_HEIGHT; row++) {
-                int t = (row * 255) / ITEM_HEIGHT;
-                int r1 = (accent >> 16) & 0xFF, g1 = (accent >> 8) & 0xFF, b1 = accent & 0xFF;
-                int r = r1 + (20 - row * 40 / ITEM_HEIGHT);
-                int g = g1 + (20 - row * 40 / ITEM_HEIGHT);
-                int b = b1 + (20 - row * 40 / ITEM_HEIGHT);
-                if (r > 255) r = 255;
-                if (r < 0) r = 0;
-                if (g > 255) g = 255;
-                if (g < 0) g = 0;
-                if (b > 255) b = 255;
-                if (b < 0) b = 0;
-                (void)t;
-                xgui_win_hline(win, rx, y + row, rw - 16, XGUI_RGB(r, g, b));
-            }
-        } else {
-            xgui_win_rect_filled(win, rx, y, rw - 16, ITEM_HEIGHT, row_bg);
-        }
+    /* Refresh the cached geometry used by the incremental repaint paths */
+    vl_rx = rx;
+    vl_rw = rw;
+    vl_item_y = item_y;
+    vl_visible = visible_items;
+    vl_cw = cw;
 
-        uint32_t text_color = is_selected ? XGUI_WHITE : XGUI_RGB(30, 30, 30);
-
-        /* Icon */
-        int icon_x = rx + 6;
-        int icon_y = y + (ITEM_HEIGHT - 10) / 2;
-        if (entry->is_dir) {
-            if (!is_selected) draw_folder_icon(win, icon_x, icon_y);
-            else {
-                xgui_win_rect_filled(win, icon_x, icon_y, 5, 2, XGUI_RGB(255, 240, 160));
-                xgui_win_rect_filled(win, icon_x, icon_y + 2, 12, 8, XGUI_RGB(255, 240, 160));
-                xgui_win_rect(win, icon_x, icon_y + 2, 12, 8, XGUI_RGB(255, 255, 200));
-            }
-        } else {
-            if (!is_selected) draw_file_icon(win, icon_x + 1, icon_y);
-            else {
-                xgui_win_rect_filled(win, icon_x + 1, icon_y, 10, 12, XGUI_RGB(255, 255, 255));
-                xgui_win_rect(win, icon_x + 1, icon_y, 10, 12, XGUI_RGB(200, 220, 255));
-            }
-        }
-
-        /* Name */
-        char name_buf[40];
-        int max_name = (rw - 120) / 8;
-        if (max_name > 35) max_name = 35;
-        if (max_name < 8) max_name = 8;
-        strncpy(name_buf, entry->name, max_name);
-        name_buf[max_name] = '\0';
-        if ((int)strlen(entry->name) > max_name) strcat(name_buf, "...");
-        xgui_win_text_transparent(win, rx + 24, y + 4, name_buf, text_color);
-
-        /* Size */
-        if (!entry->is_dir) {
-            char size_buf[16];
-            format_size(entry->size, size_buf, sizeof(size_buf));
-            xgui_win_text_transparent(win, cw - 80, y + 4, size_buf,
-                                      is_selected ? XGUI_RGB(220, 230, 255) : XGUI_RGB(100, 100, 100));
-        } else {
-            xgui_win_text_transparent(win, cw - 80, y + 4, "<DIR>",
-                                      is_selected ? XGUI_RGB(220, 230, 255) : XGUI_RGB(140, 140, 140));
-        }
-
-        /* Subtle bottom border per row */
-        if (!is_selected) {
-            xgui_win_hline(win, rx, y + ITEM_HEIGHT - 1, rw - 16, XGUI_RGB(235, 235, 235));
-        }
+    for (int i = 0; i < visible_items; i++) {
+        draw_list_row(win, i);
     }
 
     /* --- Scrollbar with arrow buttons --- */
-    int sb_x = cw - 14;
-    int sb_full_y = item_y;
-    int sb_full_h = visible_items * ITEM_HEIGHT;
-    int sb_btn_h = 14;
-
-    if (entry_count > visible_items && visible_items > 0) {
-        xgui_win_rect_filled(win, sb_x, sb_full_y, 14, sb_full_h, XGUI_RGB(240, 240, 240));
-        xgui_win_vline(win, sb_x, sb_full_y, sb_full_h, XGUI_RGB(210, 210, 210));
-
-        /* Up arrow button */
-        xgui_win_rect_filled(win, sb_x, sb_full_y, 14, sb_btn_h, XGUI_RGB(225, 225, 228));
-        xgui_win_rect(win, sb_x, sb_full_y, 14, sb_btn_h, XGUI_RGB(190, 190, 190));
-        xgui_win_hline(win, sb_x + 1, sb_full_y + 1, 12, XGUI_RGB(245, 245, 248));
-        for (int r = 0; r < 4; r++) {
-            xgui_win_hline(win, sb_x + 7 - r, sb_full_y + 4 + r, r * 2 + 1, XGUI_RGB(80, 80, 80));
-        }
-
-        /* Down arrow button */
-        int dn_y = sb_full_y + sb_full_h - sb_btn_h;
-        xgui_win_rect_filled(win, sb_x, dn_y, 14, sb_btn_h, XGUI_RGB(225, 225, 228));
-        xgui_win_rect(win, sb_x, dn_y, 14, sb_btn_h, XGUI_RGB(190, 190, 190));
-        xgui_win_hline(win, sb_x + 1, dn_y + 1, 12, XGUI_RGB(245, 245, 248));
-        for (int r = 0; r < 4; r++) {
-            xgui_win_hline(win, sb_x + 7 - r, dn_y + 9 - r, r * 2 + 1, XGUI_RGB(80, 80, 80));
-        }
-
-        /* Track area */
-        int track_y = sb_full_y + sb_btn_h;
-        int track_h = sb_full_h - sb_btn_h * 2;
-
-        if (track_h > 4) {
-            int thumb_h = (visible_items * track_h) / entry_count;
-            if (thumb_h < 16) thumb_h = 16;
-            int scroll_range = entry_count - visible_items;
-            int thumb_y = track_y;
-            if (scroll_range > 0)
-                thumb_y = track_y + (scroll_offset * (track_h - thumb_h)) / scroll_range;
-
-            xgui_win_rect_filled(win, sb_x + 1, thumb_y, 12, thumb_h, XGUI_RGB(180, 180, 185));
-            xgui_win_hline(win, sb_x + 2, thumb_y, 10, XGUI_RGB(210, 210, 215));
-            xgui_win_hline(win, sb_x + 2, thumb_y + thumb_h - 1, 10, XGUI_RGB(155, 155, 160));
-            int grip_y = thumb_y + thumb_h / 2 - 3;
-            for (int g = 0; g < 3; g++) {
-                xgui_win_hline(win, sb_x + 4, grip_y + g * 3, 6, XGUI_RGB(155, 155, 160));
-                xgui_win_hline(win, sb_x + 4, grip_y + g * 3 + 1, 6, XGUI_RGB(210, 210, 215));
-            }
-        }
-    }
+    draw_list_scrollbar(win);
 
     /* --- Status bar --- */
     int status_y = ch - 22;
@@ -934,14 +1019,12 @@ static void explorer_handler(xgui_window_t* win, xgui_event_t* event) {
             if (mx >= sb_x && mx < sb_x + 14) {
                 /* Up arrow button */
                 if (my >= sb_top && my < sb_top + sb_btn) {
-                    if (scroll_offset > 0) scroll_offset--;
-                    win->dirty = true;
+                    if (scroll_offset > 0) list_scroll_to(scroll_offset - 1);
                     return;
                 }
                 /* Down arrow button */
                 if (my >= sb_top + sb_h - sb_btn && my < sb_top + sb_h) {
-                    if (scroll_offset < scroll_max) scroll_offset++;
-                    win->dirty = true;
+                    if (scroll_offset < scroll_max) list_scroll_to(scroll_offset + 1);
                     return;
                 }
             }
@@ -970,22 +1053,12 @@ static void explorer_handler(xgui_window_t* win, xgui_event_t* event) {
             my >= list_y && my < list_y + visible_items * ITEM_HEIGHT) {
             int clicked_item = (my - list_y) / ITEM_HEIGHT + scroll_offset;
             if (clicked_item >= 0 && clicked_item < entry_count) {
-                /* Double-click detection using timer ticks */
-                static int last_clicked = -1;
-                static uint32_t last_click_ticks = 0;
-
-                uint32_t now = timer_get_ticks();
-
-                if (clicked_item == last_clicked && (now - last_click_ticks) < 50) {
+                if (event->mouse.click_count >= 2) {
                     /* Double-click - open item */
                     handle_item_open(clicked_item);
-                    last_clicked = -1;
-                    last_click_ticks = 0;
                 } else {
                     /* Single click - select item */
                     handle_item_click(clicked_item);
-                    last_clicked = clicked_item;
-                    last_click_ticks = now;
                 }
             }
         }
@@ -1003,21 +1076,25 @@ static void explorer_handler(xgui_window_t* win, xgui_event_t* event) {
         switch (event->key.keycode) {
             case 0x80: /* Up arrow */
                 if (selected_index > 0) {
-                    selected_index--;
-                    if (selected_index < scroll_offset) {
-                        scroll_offset = selected_index;
+                    if (selected_index - 1 < scroll_offset) {
+                        int old = selected_index--;
+                        list_scroll_to(selected_index);
+                        list_refresh_entry(old);
+                    } else {
+                        list_select(selected_index - 1);
                     }
-                    win->dirty = true;
                 }
                 break;
 
             case 0x81: /* Down arrow */
                 if (selected_index < entry_count - 1) {
-                    selected_index++;
-                    if (selected_index >= scroll_offset + visible_items) {
-                        scroll_offset = selected_index - visible_items + 1;
+                    if (selected_index + 1 >= scroll_offset + visible_items) {
+                        int old = selected_index++;
+                        list_scroll_to(selected_index - visible_items + 1);
+                        list_refresh_entry(old);
+                    } else {
+                        list_select(selected_index + 1);
                     }
-                    win->dirty = true;
                 }
                 break;
 
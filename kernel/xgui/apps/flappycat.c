@@ -7,6 +7,7 @@
 #include "xgui/xgui.h"
 #include "xgui/wm.h"
 #include "xgui/display.h"
+#include "xgui/sprite.h"
 #include "xgui/theme.h"
 #include "string.h"
 #include "keyboard.h"
@@ -15,6 +16,10 @@
 
 static xgui_window_t* fc_window = NULL;
 
+/* Sprite scene: static sky background with restore/redraw sprites */
+static xgui_sprite_scene_t fc_scene;
+static bool fc_scene_valid = false;
+
 #define FC_W    240
 #define FC_H    380
 #define GRAVITY         1
@@ -207,20 +212,57 @@ static void draw_gameover(xgui_window_t* w) {
     xgui_win_text_transparent(w, FC_W / 2 - 48, FC_H / 2 + 18, "Press R to retry", XGUI_RGB(180, 180, 180));
 }
 
-/* Paint callback */
+/* Paint callback. The window is NOCLEAR: the sky gradient is drawn
+ * once and captured; each frame restores/redraws only the sprite
+ * rects. The scrolling ground repaints itself opaquely, so it is
+ * marked but never restored from the background. */
 static void fc_paint(xgui_window_t* w) {
     if (fc_state == FC_MENU) {
         draw_menu(w);
+        fc_scene_valid = false;
         return;
     }
 
-    draw_sky(w);
-    for (int i = 0; i < MAX_PIPES; i++) draw_pipe(w, &pipes[i]);
+    if (fc_state == FC_GAMEOVER) {
+        /* Freeze the last frame and overlay the results */
+        draw_gameover(w);
+        fc_scene_valid = false;
+        return;
+    }
+
+    if (!fc_scene_valid) {
+        draw_sky(w);
+        draw_ground(w);
+        xgui_sprite_capture(&fc_scene);
+        /* Without a background buffer, fall back to full redraws */
+        fc_scene_valid = (fc_scene.background != NULL);
+    } else {
+        xgui_sprite_begin(&fc_scene);
+    }
+
+    /* Pipes (caps extend 3px either side of the shaft) */
+    for (int i = 0; i < MAX_PIPES; i++) {
+        if (!pipes[i].active) continue;
+        draw_pipe(w, &pipes[i]);
+        xgui_sprite_mark(&fc_scene, pipes[i].x - 3, 0,
+                         PIPE_W + 6, FC_H - GROUND_H);
+    }
+
+    /* Ground redraws its full strip each frame (stripes scroll), so
+     * only flag it for flushing */
     draw_ground(w);
+    xgui_display_mark_dirty_rect(w->x + w->client_x,
+                                 w->y + w->client_y + FC_H - GROUND_H,
+                                 FC_W, GROUND_H);
+
+    /* Cat (whiskers/tail extend 4px past the body box) */
     draw_cat(w, cat_y, cat_vy);
-    draw_score_text(w, fc_score);
+    xgui_sprite_mark(&fc_scene, CAT_X - CAT_W / 2 - 4, cat_y - CAT_H / 2 - 1,
+                     CAT_W + 8, CAT_H + 2);
 
-    if (fc_state == FC_GAMEOVER) draw_gameover(w);
+    /* Score */
+    draw_score_text(w, fc_score);
+    xgui_sprite_mark(&fc_scene, FC_W / 2 - 6, 20, 48, 18);
 }
 
 /* Game tick */
@@ -286,6 +328,8 @@ static void fc_tick(void) {
 /* Event handler */
 static void fc_handler(xgui_window_t* w, xgui_event_t* event) {
     if (event->type == XGUI_EVENT_WINDOW_CLOSE) {
+        xgui_sprite_scene_free(&fc_scene);
+        fc_scene_valid = false;
         xgui_window_destroy(w);
         fc_window = NULL;
         fc_state = FC_MENU;
@@ -297,6 +341,7 @@ static void fc_handler(xgui_window_t* w, xgui_event_t* event) {
         if (fc_state == FC_MENU && c == ' ') {
             fc_reset();
             fc_state = FC_PLAYING;
+            fc_scene_valid = false;
             w->dirty = true;
             return;
         }
@@ -307,6 +352,7 @@ static void fc_handler(xgui_window_t* w, xgui_event_t* event) {
         if (fc_state == FC_GAMEOVER && (c == 'r' || c == 'R')) {
             fc_reset();
             fc_state = FC_PLAYING;
+            fc_scene_valid = false;
             w->dirty = true;
             return;
         }
@@ -335,9 +381,13 @@ void xgui_flappycat_create(void) {
     }
     fc_state = FC_MENU;
     fc_window = xgui_window_create("Flappy Cat", 120, 30, FC_W, FC_H,
-                                    XGUI_WINDOW_DEFAULT);
+                                    XGUI_WINDOW_DEFAULT | XGUI_WINDOW_NOCLEAR);
     if (!fc_window) return;
     xgui_window_set_paint(fc_window, fc_paint);
     xgui_window_set_handler(fc_window, fc_handler);
     xgui_window_set_bgcolor(fc_window, XGUI_RGB(100, 180, 255));
+
+    /* Scene init can fail; fc_paint then keeps doing full redraws */
+    xgui_sprite_scene_init(&fc_scene, fc_window);
+    fc_scene_valid = false;
 }
@@ -16,6 +16,7 @@
 #include "ext2.h"
 #include "shell.h"
 #include "heap.h"
+#include "undolog.h"
 
 /* Editor configuration */
 #define ED_MAX_LINES    256
@@ -72,6 +73,30 @@ static xgui_widget_t* btn_saveas = NULL;
 static char ed_status_msg[64];
 static int ed_status_ticks = 0;
 
+/* Undo journal (shared operation log, see include/undolog.h) */
+static undolog_t ed_undo;
+
+/*
+ * Wrap layout cache: screen rows per buffer line, computed lazily for
+ * the lines a pass actually touches and invalidated per edited line,
+ * so typing relayouts one line instead of rescanning the document.
+ * With fixed-width wrap the row count fully describes the layout
+ * (break positions fall on column-width boundaries). 0 = invalid;
+ * the whole cache drops when the wrap width changes (resize).
+ */
+static uint16_t ed_wrap_cache[ED_MAX_LINES];
+static int ed_wrap_cache_cols = -1;
+
+static void ed_layout_invalidate(int ln) {
+    if (ln >= 0 && ln < ED_MAX_LINES) ed_wrap_cache[ln] = 0;
+}
+
+/* Line inserts/deletes shift every slot below the edit point */
+static void ed_layout_invalidate_from(int ln) {
+    if (ln < 0) ln = 0;
+    for (int i = ln; i < ED_MAX_LINES; i++) ed_wrap_cache[i] = 0;
+}
+
 /*
  * Get length of a line
  */
@@ -96,12 +121,23 @@ static int ed_wrap_cols(void) {
 
 /*
  * How many screen rows does buffer line 'ln' occupy with word wrap
+ * (served from the layout cache when the entry is still valid)
  */
 static int ed_line_screen_rows(int ln) {
-    int len = ed_line_len(ln);
     int cols = ed_wrap_cols();
-    if (len == 0) return 1;
-    return (len + cols - 1) / cols;
+    if (cols != ed_wrap_cache_cols) {
+        ed_layout_invalidate_from(0);
+        ed_wrap_cache_cols = cols;
+    }
+    if (ln >= 0 && ln < ED_MAX_LINES && ed_wrap_cache[ln] != 0) {
+        return ed_wrap_cache[ln];
+    }
+    int len = ed_line_len(ln);
+    int rows = (len == 0) ? 1 : (len + cols - 1) / cols;
+    if (ln >= 0 && ln < ED_MAX_LINES) {
+        ed_wrap_cache[ln] = (uint16_t)rows;
+    }
+    return rows;
 }
 
 /*
@@ -151,11 +187,13 @@ static void ed_ensure_visible(void) {
 static void ed_insert_char(char c) {
     int len = ed_line_len(ed_cur_line);
     if (len >= ED_MAX_COLS) return;
+    undolog_record_insert(&ed_undo, ed_cur_line, ed_cur_col);
     for (int i = len; i >= ed_cur_col; i--) {
         ed_lines[ed_cur_line][i + 1] = ed_lines[ed_cur_line][i];
     }
     ed_lines[ed_cur_line][ed_cur_col] = c;
     ed_cur_col++;
+    ed_layout_invalidate(ed_cur_line);
     ed_modified = 1;
 }
 
@@ -164,6 +202,7 @@ static void ed_insert_char(char c) {
  */
 static void ed_insert_newline(void) {
     if (ed_line_count >= ED_MAX_LINES) return;
+    undolog_record_split(&ed_undo, ed_cur_line, ed_cur_col);
     for (int i = ed_line_count; i > ed_cur_line + 1; i--) {
         memcpy(ed_lines[i], ed_lines[i - 1], ED_MAX_COLS + 1);
     }
@@ -171,6 +210,7 @@ static void ed_insert_newline(void) {
     int len = ed_line_len(ed_cur_line);
     memcpy(ed_lines[ed_cur_line + 1], &ed_lines[ed_cur_line][ed_cur_col], len - ed_cur_col + 1);
     ed_lines[ed_cur_line][ed_cur_col] = '\0';
+    ed_layout_invalidate_from(ed_cur_line);
     ed_cur_line++;
     ed_cur_col = 0;
     ed_modified = 1;
@@ -183,15 +223,19 @@ static void ed_insert_newline(void) {
 static void ed_backspace(void) {
     if (ed_cur_col > 0) {
         int len = ed_line_len(ed_cur_line);
+        undolog_record_delete(&ed_undo, ed_cur_line, ed_cur_col - 1,
+                              ed_lines[ed_cur_line][ed_cur_col - 1]);
         for (int i = ed_cur_col - 1; i < len; i++) {
             ed_lines[ed_cur_line][i] = ed_lines[ed_cur_line][i + 1];
         }
         ed_cur_col--;
+        ed_layout_invalidate(ed_cur_line);
         ed_modified = 1;
     } else if (ed_cur_line > 0) {
         int prev_len = ed_line_len(ed_cur_line - 1);
         int cur_len = ed_line_len(ed_cur_line);
         if (prev_len + cur_len <= ED_MAX_COLS) {
+            undolog_record_join(&ed_undo, ed_cur_line - 1, prev_len);
             memcpy(&ed_lines[ed_cur_line - 1][prev_len], ed_lines[ed_cur_line], cur_len + 1);
             for (int i = ed_cur_line; i < ed_line_count - 1; i++) {
                 memcpy(ed_lines[i], ed_lines[i + 1], ED_MAX_COLS + 1);
@@ -199,6 +243,7 @@ static void ed_backspace(void) {
             ed_line_count--;
             ed_cur_line--;
             ed_cur_col = prev_len;
+            ed_layout_invalidate_from(ed_cur_line);
             ed_modified = 1;
         }
     }
@@ -211,14 +256,18 @@ static void ed_backspace(void) {
 static void ed_delete_char(void) {
     int len = ed_line_len(ed_cur_line);
     if (ed_cur_col < len) {
+        undolog_record_delete(&ed_undo, ed_cur_line, ed_cur_col,
+                              ed_lines[ed_cur_line][ed_cur_col]);
         for (int i = ed_cur_col; i < len; i++) {
             ed_lines[ed_cur_line][i] = ed_lines[ed_cur_line][i + 1];
         }
+        ed_layout_invalidate(ed_cur_line);
         ed_modified = 1;
     } else if (ed_cur_line < ed_line_count - 1) {
         /* Join with next line */
         int next_len = ed_line_len(ed_cur_line + 1);
         if (len + next_len <= ED_MAX_COLS) {
+            undolog_record_join(&ed_undo, ed_cur_line, len);
             memcpy(&ed_lines[ed_cur_line][len], ed_lines[ed_cur_line + 1], next_len + 1);
             for (int i = ed_cur_line + 1; i < ed_line_count - 1; i++) {
                 memcpy(ed_lines[i], ed_lines[i + 1], ED_MAX_COLS + 1);
@@ -229,6 +278,99 @@ static void ed_delete_char(void) {
     }
 }
 
+static void ed_clear_selection(void);
+
+/*
+ * Undo the newest journal operation by applying its inverse edit
+ * directly to the line buffer (nothing here re-logs)
+ */
+static void ed_undo_cmd(void) {
+    undolog_op_t* op = undolog_peek(&ed_undo);
+    if (!op) {
+        strncpy(ed_status_msg, "Nothing to undo", sizeof(ed_status_msg));
+        ed_status_ticks = 100;
+        return;
+    }
+
+    switch (op->type) {
+        case UNDOLOG_INSERT: {
+            /* Remove the inserted run */
+            int len = ed_line_len(op->line);
+            int end = op->col + op->len;
+            if (end > len) end = len;
+            if (op->col < end) {
+                memmove(&ed_lines[op->line][op->col], &ed_lines[op->line][end],
+                        len - end + 1);
+            }
+            ed_cur_line = op->line;
+            ed_cur_col = op->col;
+            break;
+        }
+
+        case UNDOLOG_DELETE: {
+            /* Re-insert the deleted run */
+            int len = ed_line_len(op->line);
+            int n = op->len;
+            if (len + n > ED_MAX_COLS) n = ED_MAX_COLS - len;
+            if (n > 0) {
+                memmove(&ed_lines[op->line][op->col + n], &ed_lines[op->line][op->col],
+                        len - op->col + 1);
+                memcpy(&ed_lines[op->line][op->col], op->text, n);
+            }
+            ed_cur_line = op->line;
+            ed_cur_col = op->col + (n > 0 ? n : 0);
+            break;
+        }
+
+        case UNDOLOG_SPLIT:
+            /* Join the two halves back together */
+            if (op->line < ed_line_count - 1) {
+                int l1 = ed_line_len(op->line);
+                int l2 = ed_line_len(op->line + 1);
+                if (l1 + l2 <= ED_MAX_COLS) {
+                    memcpy(&ed_lines[op->line][l1], ed_lines[op->line + 1], l2 + 1);
+                    for (int i = op->line + 1; i < ed_line_count - 1; i++) {
+                        memcpy(ed_lines[i], ed_lines[i + 1], ED_MAX_COLS + 1);
+                    }
+                    ed_line_count--;
+                }
+            }
+            ed_cur_line = op->line;
+            ed_cur_col = op->col;
+            break;
+
+        case UNDOLOG_JOIN:
+            /* Re-split at the join point */
+            if (ed_line_count < ED_MAX_LINES) {
+                for (int i = ed_line_count; i > op->line + 1; i--) {
+                    memcpy(ed_lines[i], ed_lines[i - 1], ED_MAX_COLS + 1);
+                }
+                ed_line_count++;
+                int len = ed_line_len(op->line);
+                if (op->col <= len) {
+                    memcpy(ed_lines[op->line + 1], &ed_lines[op->line][op->col],
+                           len - op->col + 1);
+                    ed_lines[op->line][op->col] = '\0';
+                }
+            }
+            ed_cur_line = op->line;
+            ed_cur_col = op->col;
+            break;
+
+        default:
+            /* KILL_LINE is not recorded by this editor */
+            break;
+    }
+    undolog_drop(&ed_undo);
+    ed_layout_invalidate_from(op->line);
+
+    if (ed_cur_line >= ed_line_count) ed_cur_line = ed_line_count - 1;
+    if (ed_cur_col > ed_line_len(ed_cur_line)) ed_cur_col = ed_line_len(ed_cur_line);
+    ed_clear_selection();
+    ed_modified = 1;
+    ed_ensure_visible();
+}
+
 /*
  * Load file from VFS
  */
@@ -249,6 +391,7 @@ static int ed_load_file(const char* path) {
         /* Empty file */
         memset(ed_lines, 0, sizeof(ed_lines));
         ed_line_count = 1;
+        ed_layout_invalidate_from(0);
         strncpy(ed_filename, resolved, ED_FNAME_MAX - 1);
         ed_filename[ED_FNAME_MAX - 1] = '\0';
         ed_modified = 0;
@@ -294,6 +437,8 @@ static int ed_load_file(const char* path) {
     ed_cur_line = 0;
     ed_cur_col = 0;
     ed_scroll_y = 0;
+    ed_layout_invalidate_from(0);
+    undolog_clear(&ed_undo);
     return 0;
 }
 
@@ -399,6 +544,8 @@ static void ed_new_file(void) {
     ed_scroll_x = 0;
     ed_filename[0] = '\0';
     ed_modified = 0;
+    ed_layout_invalidate_from(0);
+    undolog_clear(&ed_undo);
 }
 
 /*
@@ -495,21 +642,24 @@ static void ed_copy_selection(void) {
     int sl, sc, el, ec;
     ed_get_selection(&sl, &sc, &el, &ec);
 
-    char buf[XGUI_CLIPBOARD_MAX];
+    /* Build the text in the clipboard's own storage (no staging copy) */
+    int cap = (el - sl + 1) * (ED_MAX_COLS + 1);
+    if (cap >= XGUI_CLIPBOARD_MAX) cap = XGUI_CLIPBOARD_MAX - 1;
+    char* buf = xgui_clipboard_reserve(cap);
+    if (!buf) return;
     int pos = 0;
 
-    for (int ln = sl; ln <= el && pos < XGUI_CLIPBOARD_MAX - 2; ln++) {
+    for (int ln = sl; ln <= el && pos < cap; ln++) {
         int start = (ln == sl) ? sc : 0;
         int end = (ln == el) ? ec : ed_line_len(ln);
-        for (int c = start; c < end && pos < XGUI_CLIPBOARD_MAX - 2; c++) {
+        for (int c = start; c < end && pos < cap; c++) {
             buf[pos++] = ed_lines[ln][c];
         }
-        if (ln < el && pos < XGUI_CLIPBOARD_MAX - 2) {
+        if (ln < el && pos < cap) {
             buf[pos++] = '\n';
         }
     }
-    buf[pos] = '\0';
-    xgui_clipboard_set(buf, pos);
+    xgui_clipboard_commit(pos);
 }
 
 /*
@@ -520,6 +670,10 @@ static void ed_delete_selection(void) {
     int sl, sc, el, ec;
     ed_get_selection(&sl, &sc, &el, &ec);
 
+    /* Block deletes are not journaled; drop history so undo never
+     * replays against a buffer it no longer matches */
+    undolog_clear(&ed_undo);
+
     if (sl == el) {
         /* Single line: remove chars [sc, ec) */
         int len = ed_line_len(sl);
@@ -543,6 +697,7 @@ static void ed_delete_selection(void) {
 
     ed_cur_line = sl;
     ed_cur_col = sc;
+    ed_layout_invalidate_from(sl);
     ed_modified = 1;
     ed_clear_selection();
     ed_ensure_visible();
@@ -868,6 +1023,10 @@ static void ed_handler(xgui_window_t* win, xgui_event_t* event) {
             ed_select_all();
             win->dirty = true;
             return;
+        case 26:  /* Ctrl+Z */
+            ed_undo_cmd();
+            win->dirty = true;
+            return;
         case 19:  /* Ctrl+S */
             if (ed_filename[0]) {
                 ed_save_file(ed_filename);
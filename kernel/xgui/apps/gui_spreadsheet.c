@@ -575,12 +575,268 @@ static void gs_eval_cell(int r, int c) {
 }
 
 /*
- * Evaluate all cells
+ * Formula dependency graph, mirroring the shell spreadsheet: each
+ * formula registers the ranges it reads, so an edit re-evaluates only
+ * the cells transitively downstream of it, in dependency order. Edges
+ * are kept as ranges, so a SUM over a column is a single entry.
  */
-static void gs_eval_all(void) {
+#define GS_MAX_FORMULAS 512
+#define GS_MAX_DEPS     8
+
+typedef struct {
+    uint8_t r1, c1;             /* Top-left of referenced range */
+    uint8_t r2, c2;             /* Bottom-right (inclusive) */
+} gs_dep_t;
+
+typedef struct {
+    uint8_t in_use;
+    uint8_t row, col;           /* Where the formula lives */
+    uint8_t ndeps;
+    gs_dep_t deps[GS_MAX_DEPS];
+} gs_formula_t;
+
+static gs_formula_t gs_formulas[GS_MAX_FORMULAS];
+static int16_t gs_formula_idx[GS_ROWS][GS_COLS];
+static uint8_t gs_dirty[GS_ROWS][GS_COLS];
+static uint16_t gs_recalc_queue[GS_MAX_FORMULAS + 1];
+
+static void gs_deps_reset(void) {
+    memset(gs_formulas, 0, sizeof(gs_formulas));
+    memset(gs_dirty, 0, sizeof(gs_dirty));
     for (int r = 0; r < GS_ROWS; r++)
         for (int c = 0; c < GS_COLS; c++)
+            gs_formula_idx[r][c] = -1;
+}
+
+static void gs_deps_add(gs_formula_t* fo, int r1, int c1, int r2, int c2) {
+    if (r1 > r2) { int t = r1; r1 = r2; r2 = t; }
+    if (c1 > c2) { int t = c1; c1 = c2; c2 = t; }
+    if (fo->ndeps >= GS_MAX_DEPS) {
+        /* Out of slots: conservatively depend on the whole sheet */
+        fo->deps[0].r1 = 0;
+        fo->deps[0].c1 = 0;
+        fo->deps[0].r2 = GS_ROWS - 1;
+        fo->deps[0].c2 = GS_COLS - 1;
+        return;
+    }
+    gs_dep_t* d = &fo->deps[fo->ndeps++];
+    d->r1 = r1;
+    d->c1 = c1;
+    d->r2 = r2;
+    d->c2 = c2;
+}
+
+/*
+ * Pull the cell references and ranges out of a formula string. Function
+ * names (letters followed by letters or '(') are skipped; a reference
+ * is a single column letter followed by digits, optionally ":ref".
+ */
+static void gs_extract_deps(const char* p, gs_formula_t* fo) {
+    fo->ndeps = 0;
+
+    while (*p) {
+        char c = *p;
+        if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
+            char n = p[1];
+            if ((n >= 'A' && n <= 'Z') || (n >= 'a' && n <= 'z') || n == '(') {
+                while ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z')) p++;
+                continue;
+            }
+
+            char ref[8];
+            int i = 0;
+            ref[i++] = *p++;
+            while (*p >= '0' && *p <= '9' && i < 7) ref[i++] = *p++;
+            ref[i] = '\0';
+
+            int r1, c1;
+            if (gs_parse_ref(ref, &r1, &c1) < 0) continue;
+            int r2 = r1, c2 = c1;
+
+            if (*p == ':') {
+                const char* q = p + 1;
+                if ((*q >= 'A' && *q <= 'Z') || (*q >= 'a' && *q <= 'z')) {
+                    char ref2[8];
+                    int j = 0;
+                    ref2[j++] = *q++;
+                    while (*q >= '0' && *q <= '9' && j < 7) ref2[j++] = *q++;
+                    ref2[j] = '\0';
+                    if (gs_parse_ref(ref2, &r2, &c2) == 0) {
+                        p = q;
+                    } else {
+                        r2 = r1;
+                        c2 = c1;
+                    }
+                }
+            }
+
+            gs_deps_add(fo, r1, c1, r2, c2);
+        } else {
+            p++;
+        }
+    }
+}
+
+/*
+ * Keep the dependency registry in sync after a cell changes
+ */
+static void gs_track_cell(int row, int col) {
+    int idx = gs_formula_idx[row][col];
+
+    if (gs_cells[row][col].type != GS_FORMULA) {
+        if (idx >= 0) {
+            gs_formulas[idx].in_use = 0;
+            gs_formula_idx[row][col] = -1;
+        }
+        return;
+    }
+
+    if (idx < 0) {
+        for (int i = 0; i < GS_MAX_FORMULAS; i++) {
+            if (!gs_formulas[i].in_use) {
+                idx = i;
+                break;
+            }
+        }
+        if (idx < 0) return;    /* Registry full: cell recalcs only when edited */
+        gs_formulas[idx].in_use = 1;
+        gs_formulas[idx].row = row;
+        gs_formulas[idx].col = col;
+        gs_formula_idx[row][col] = (int16_t)idx;
+    }
+
+    gs_extract_deps(gs_cells[row][col].content, &gs_formulas[idx]);
+}
+
+/*
+ * Does this formula read the given cell?
+ */
+static int gs_dep_hits(gs_formula_t* fo, int row, int col) {
+    for (int i = 0; i < fo->ndeps; i++) {
+        gs_dep_t* d = &fo->deps[i];
+        if (row >= d->r1 && row <= d->r2 && col >= d->c1 && col <= d->c2)
+            return 1;
+    }
+    return 0;
+}
+
+/*
+ * Does this formula still read a cell waiting to be recalculated?
+ */
+static int gs_deps_dirty(gs_formula_t* fo) {
+    for (int i = 0; i < fo->ndeps; i++) {
+        gs_dep_t* d = &fo->deps[i];
+        for (int r = d->r1; r <= d->r2; r++)
+            for (int c = d->c1; c <= d->c2; c++)
+                if (gs_dirty[r][c]) return 1;
+    }
+    return 0;
+}
+
+/*
+ * Evaluate every dirty formula in dependency order. If a round makes no
+ * progress the remaining cells form a reference cycle: they are zeroed
+ * and flagged in the status bar instead of looping forever.
+ */
+static void gs_cell_refresh(int r, int c);
+
+static void gs_recalc_run(void) {
+    int progress = 1;
+    int remaining = 0;
+
+    do {
+        progress = 0;
+        remaining = 0;
+        for (int i = 0; i < GS_MAX_FORMULAS; i++) {
+            gs_formula_t* fo = &gs_formulas[i];
+            if (!fo->in_use || !gs_dirty[fo->row][fo->col]) continue;
+            if (gs_deps_dirty(fo)) {
+                remaining = 1;
+                continue;
+            }
+            double old_value = gs_cells[fo->row][fo->col].value;
+            gs_eval_cell(fo->row, fo->col);
+            gs_dirty[fo->row][fo->col] = 0;
+            progress = 1;
+            /* Only repaint cells whose displayed value actually changed */
+            if (gs_cells[fo->row][fo->col].value != old_value) {
+                gs_cell_refresh(fo->row, fo->col);
+            }
+        }
+    } while (progress && remaining);
+
+    if (remaining) {
+        for (int i = 0; i < GS_MAX_FORMULAS; i++) {
+            gs_formula_t* fo = &gs_formulas[i];
+            if (!fo->in_use || !gs_dirty[fo->row][fo->col]) continue;
+            gs_cells[fo->row][fo->col].value = 0;
+            gs_dirty[fo->row][fo->col] = 0;
+        }
+        strncpy(gs_status_msg, "Circular reference", sizeof(gs_status_msg));
+        gs_status_ticks = 100;
+    }
+}
+
+/*
+ * Re-evaluate only the cells transitively downstream of an edit
+ */
+static void gs_recalc(int row, int col) {
+    int head = 0, tail = 0;
+
+    gs_dirty[row][col] = 1;
+    gs_recalc_queue[tail++] = (uint16_t)(row * GS_COLS + col);
+
+    /* Closure: pull in every formula reading a cell already queued */
+    while (head < tail) {
+        int id = gs_recalc_queue[head++];
+        int r = id / GS_COLS;
+        int c = id % GS_COLS;
+
+        for (int i = 0; i < GS_MAX_FORMULAS; i++) {
+            gs_formula_t* fo = &gs_formulas[i];
+            if (!fo->in_use || gs_dirty[fo->row][fo->col]) continue;
+            if (gs_dep_hits(fo, r, c) && tail <= GS_MAX_FORMULAS) {
+                gs_dirty[fo->row][fo->col] = 1;
+                gs_recalc_queue[tail++] = (uint16_t)(fo->row * GS_COLS + fo->col);
+            }
+        }
+    }
+
+    /* The edited cell's own value is already final unless it is a
+     * formula; untracked formulas (registry full) evaluate in place */
+    if (gs_cells[row][col].type != GS_FORMULA) {
+        gs_dirty[row][col] = 0;
+    } else if (gs_formula_idx[row][col] < 0) {
+        gs_eval_cell(row, col);
+        gs_dirty[row][col] = 0;
+    }
+
+    gs_recalc_run();
+}
+
+/*
+ * Evaluate all cells (full rebuild after load): derive every cell's
+ * type and value first, then redo the formulas in dependency order
+ */
+static void gs_eval_all(void) {
+    for (int r = 0; r < GS_ROWS; r++) {
+        for (int c = 0; c < GS_COLS; c++) {
             gs_eval_cell(r, c);
+            gs_track_cell(r, c);
+        }
+    }
+
+    for (int i = 0; i < GS_MAX_FORMULAS; i++) {
+        if (gs_formulas[i].in_use)
+            gs_dirty[gs_formulas[i].row][gs_formulas[i].col] = 1;
+    }
+    gs_recalc_run();
+
+    /* Formulas that did not fit the registry still get a single pass */
+    for (int r = 0; r < GS_ROWS; r++)
+        for (int c = 0; c < GS_COLS; c++)
+            if (gs_cells[r][c].type == GS_FORMULA && gs_formula_idx[r][c] < 0)
+                gs_eval_cell(r, c);
 }
 
 /*
@@ -596,7 +852,9 @@ static void gs_commit_edit(void) {
         strncpy(cell->content, gs_edit_buf, GS_MAX_CONTENT - 1);
         cell->content[GS_MAX_CONTENT - 1] = '\0';
     }
-    gs_eval_all();
+    gs_eval_cell(gs_cur_row, gs_cur_col);
+    gs_track_cell(gs_cur_row, gs_cur_col);
+    gs_recalc(gs_cur_row, gs_cur_col);
     gs_editing = 0;
 }
 
@@ -738,6 +996,7 @@ static int gs_load_file(const char* path) {
     uint32_t size = node->length;
     if (size == 0) {
         memset(gs_cells, 0, sizeof(gs_cells));
+        gs_deps_reset();
         strncpy(gs_filename, resolved, GS_FNAME_MAX - 1);
         gs_filename[GS_FNAME_MAX - 1] = '\0';
         gs_eval_all();
@@ -762,6 +1021,7 @@ static int gs_load_file(const char* path) {
 
     /* Parse CSV */
     memset(gs_cells, 0, sizeof(gs_cells));
+    gs_deps_reset();
     int row = 0, col = 0, ci = 0;
     for (int i = 0; i <= rd && row < GS_ROWS; i++) {
         char ch = (i < rd) ? (char)buf[i] : '\n';
@@ -831,12 +1091,249 @@ static void gs_on_save_as(xgui_widget_t* w) {
     if (gs_window) gs_window->dirty = true;
 }
 
+/*
+ * True when a text cell's content is wider than its cell, so painting
+ * it spills an overlay across the neighbouring cells
+ */
+static int gs_cell_overflows(int r, int c) {
+    gs_cell_t* cell = &gs_cells[r][c];
+    int cell_chars = (GS_CELL_W - 4) / GS_CHAR_W;
+    return cell->type == GS_TEXT && (int)strlen(cell->content) > cell_chars;
+}
+
+/*
+ * Draw one cell at its on-screen position (no-op when scrolled out of
+ * view). Used both by the full paint and by the incremental paths.
+ */
+static void gs_draw_cell_at(xgui_window_t* win, int r, int c) {
+    int vis = gs_vis_rows(win);
+    int vcols = gs_vis_cols(win);
+    if (r < gs_view_row || r >= gs_view_row + vis) return;
+    if (c < gs_view_col || c >= gs_view_col + vcols) return;
+
+    int grid_y = GS_TOOLBAR_H + GS_FBAR_H;
+    int x = GS_HDR_W + (c - gs_view_col) * GS_CELL_W;
+    int y = grid_y + GS_HDR_H + (r - gs_view_row) * GS_CELL_H;
+    if (x >= win->client_width) return;
+    gs_cell_t* cell = &gs_cells[r][c];
+
+    /* Background */
+    uint32_t bg = GS_GRID_BG;
+    if (r == gs_cur_row && c == gs_cur_col) {
+        bg = gs_editing ? GS_EDIT_BG : GS_CURSOR_BG;
+    }
+    xgui_win_rect_filled(win, x, y, GS_CELL_W, GS_CELL_H, bg);
+
+    /* Cell border */
+    xgui_win_vline(win, x, y, GS_CELL_H, GS_GRID_LINE);
+    xgui_win_hline(win, x, y + GS_CELL_H - 1, GS_CELL_W, GS_GRID_LINE);
+
+    /* Cursor highlight */
+    if (r == gs_cur_row && c == gs_cur_col) {
+        xgui_win_rect(win, x, y, GS_CELL_W, GS_CELL_H, GS_CURSOR_BRD);
+    }
+
+    /* Cell text */
+    if (r == gs_cur_row && c == gs_cur_col && gs_editing) {
+        /* Show edit buffer with cursor */
+        if (gs_edit_buf[0]) {
+            char disp[GS_MAX_CONTENT];
+            int maxch = (GS_CELL_W - 4) / GS_CHAR_W;
+            strncpy(disp, gs_edit_buf, maxch);
+            disp[maxch] = '\0';
+            xgui_win_text_transparent(win, x + 2, y + 1, disp, GS_TEXT_FG);
+        }
+        /* Edit cursor */
+        int cx = x + 2 + gs_edit_pos * GS_CHAR_W;
+        if (cx < x + GS_CELL_W - 2) {
+            xgui_win_rect_filled(win, cx, y + 1, 2, GS_CELL_H - 2, XGUI_BLACK);
+        }
+    } else if (cell->type != GS_EMPTY) {
+        char disp[GS_MAX_CONTENT];
+        int maxch = (GS_CELL_W - 4) / GS_CHAR_W;
+
+        if (cell->type == GS_NUMBER || cell->type == GS_FORMULA) {
+            int whole = (int)cell->value;
+            int frac = (int)((cell->value - whole) * 100);
+            if (frac < 0) frac = -frac;
+            if (frac == 0) snprintf(disp, maxch + 1, "%d", whole);
+            else snprintf(disp, maxch + 1, "%d.%02d", whole, frac);
+            /* Right-align numbers */
+            int len = strlen(disp);
+            int tx = x + GS_CELL_W - 2 - len * GS_CHAR_W;
+            if (tx < x + 2) tx = x + 2;
+            uint32_t fg = cell->type == GS_FORMULA ? GS_FORMULA_FG : GS_NUM_FG;
+            xgui_win_text_transparent(win, tx, y + 1, disp, fg);
+        } else {
+            strncpy(disp, cell->content, maxch);
+            disp[maxch] = '\0';
+            xgui_win_text_transparent(win, x + 2, y + 1, disp, GS_TEXT_FG);
+        }
+    }
+}
+
+/*
+ * Draw one row-number header (highlighted when it holds the cursor)
+ */
+static void gs_draw_row_hdr(xgui_window_t* win, int r) {
+    int vis = gs_vis_rows(win);
+    if (r < gs_view_row || r >= gs_view_row + vis) return;
+    int y = GS_TOOLBAR_H + GS_FBAR_H + GS_HDR_H + (r - gs_view_row) * GS_CELL_H;
+
+    xgui_win_rect_filled(win, 0, y, GS_HDR_W, GS_CELL_H, GS_HDR_BG);
+    char rnum[4];
+    snprintf(rnum, sizeof(rnum), "%d", r + 1);
+    xgui_win_text_transparent(win, 4, y + 1, rnum,
+                              r == gs_cur_row ? GS_CURSOR_BRD : GS_HDR_FG);
+}
+
+/*
+ * Draw one column-letter header (highlighted when it holds the cursor)
+ */
+static void gs_draw_col_hdr(xgui_window_t* win, int c) {
+    int vcols = gs_vis_cols(win);
+    if (c < gs_view_col || c >= gs_view_col + vcols) return;
+    int grid_y = GS_TOOLBAR_H + GS_FBAR_H;
+    int x = GS_HDR_W + (c - gs_view_col) * GS_CELL_W;
+    if (x >= win->client_width) return;
+
+    xgui_win_rect_filled(win, x, grid_y, GS_CELL_W, GS_HDR_H - 1, GS_HDR_BG);
+    char lbl[2] = { 'A' + c, '\0' };
+    int tx = x + GS_CELL_W / 2 - GS_CHAR_W / 2;
+    xgui_win_text_transparent(win, tx, grid_y + 1, lbl,
+                              c == gs_cur_col ? GS_CURSOR_BRD : GS_HDR_FG);
+    xgui_win_vline(win, x, grid_y, GS_HDR_H, GS_GRID_LINE);
+}
+
+/*
+ * Draw the formula bar (cell reference + current content)
+ */
+static void gs_draw_fbar(xgui_window_t* win) {
+    int cw = win->client_width;
+    int fbar_y = GS_TOOLBAR_H;
+    xgui_win_rect_filled(win, 0, fbar_y, cw, GS_FBAR_H, GS_FBAR_BG);
+
+    /* Cell reference (e.g., "A1" or "Z100") */
+    char ref[8];
+    ref[0] = 'A' + gs_cur_col;
+    snprintf(ref + 1, sizeof(ref) - 1, "%d", gs_cur_row + 1);
+    xgui_win_text_transparent(win, 4, fbar_y + 2, ref, XGUI_BLACK);
+    xgui_win_vline(win, 40, fbar_y, GS_FBAR_H, GS_GRID_LINE);
+
+    /* Show content or edit buffer - clip at window edge naturally */
+    const char* show = gs_editing ? gs_edit_buf : gs_cells[gs_cur_row][gs_cur_col].content;
+    if (show && show[0]) {
+        /* Calculate how many chars fit before clipping */
+        int avail_pixels = cw - 46 - 4; /* Leave 4px margin on right */
+        int max_chars = avail_pixels / GS_CHAR_W;
+        int len = strlen(show);
+
+        if (len <= max_chars) {
+            /* Show full text */
+            xgui_win_text_transparent(win, 46, fbar_y + 2, show, XGUI_BLACK);
+        } else {
+            /* Show with ellipsis indicator */
+            char display[GS_MAX_CONTENT + 1];
+            if (max_chars > 3) {
+                strncpy(display, show, max_chars - 3);
+                strcpy(display + max_chars - 3, "...");
+            } else {
+                strncpy(display, show, max_chars);
+                display[max_chars] = '\0';
+            }
+            xgui_win_text_transparent(win, 46, fbar_y + 2, display, XGUI_BLACK);
+        }
+    }
+    xgui_win_hline(win, 0, fbar_y + GS_FBAR_H - 1, cw, GS_GRID_LINE);
+}
+
+/*
+ * Draw the status bar (filename prompt, status message, or cell ref)
+ */
+static void gs_draw_status(xgui_window_t* win) {
+    int cw = win->client_width;
+    int sy = win->client_height - GS_STATUS_H;
+    xgui_win_rect_filled(win, 0, sy, cw, GS_STATUS_H, GS_STATUS_BG);
+
+    if (gs_fname_mode) {
+        const char* prompt = gs_fname_mode == 1 ? "Open: " : "Save as: ";
+        char status[128];
+        snprintf(status, sizeof(status), "%s%s_", prompt, gs_fname_buf);
+        xgui_win_text_transparent(win, 4, sy + 2, status, GS_STATUS_FG);
+    } else if (gs_status_ticks > 0) {
+        xgui_win_text_transparent(win, 4, sy + 2, gs_status_msg, XGUI_RGB(255, 255, 100));
+        gs_status_ticks--;
+        if (gs_status_ticks > 0) win->dirty = true;
+    } else {
+        char status[128];
+        snprintf(status, sizeof(status), " %s  Cell %c%d",
+                 gs_filename[0] ? gs_filename : "[No File]",
+                 'A' + gs_cur_col, gs_cur_row + 1);
+        xgui_win_text_transparent(win, 4, sy + 2, status, GS_STATUS_FG);
+    }
+}
+
+/*
+ * Move the cursor, repainting only the two affected cells plus their
+ * header labels and the formula/status bars, then compositing via the
+ * window's expose flag. Falls back to a full repaint when the view
+ * scrolls or an overflowing text cell's overlay is involved.
+ */
+static void gs_move_cursor(int new_row, int new_col) {
+    xgui_window_t* win = gs_window;
+    int old_row = gs_cur_row;
+    int old_col = gs_cur_col;
+    if (new_row == old_row && new_col == old_col) return;
+
+    gs_cur_row = new_row;
+    gs_cur_col = new_col;
+    if (!win) return;
+
+    int pv_row = gs_view_row, pv_col = gs_view_col;
+    gs_ensure_visible();
+
+    if (win->dirty || gs_editing ||
+        gs_view_row != pv_row || gs_view_col != pv_col ||
+        gs_cell_overflows(old_row, old_col) ||
+        gs_cell_overflows(new_row, new_col)) {
+        win->dirty = true;
+        return;
+    }
+
+    gs_draw_cell_at(win, old_row, old_col);
+    gs_draw_cell_at(win, new_row, new_col);
+    if (old_row != new_row) {
+        gs_draw_row_hdr(win, old_row);
+        gs_draw_row_hdr(win, new_row);
+    }
+    if (old_col != new_col) {
+        gs_draw_col_hdr(win, old_col);
+        gs_draw_col_hdr(win, new_col);
+    }
+    gs_draw_fbar(win);
+    gs_draw_status(win);
+    win->expose = true;
+}
+
+/*
+ * Repaint one cell in place after a recalc changed its value
+ */
+static void gs_cell_refresh(int r, int c) {
+    xgui_window_t* win = gs_window;
+    if (!win || win->dirty) return;
+    if (gs_cell_overflows(r, c)) {
+        win->dirty = true;
+        return;
+    }
+    gs_draw_cell_at(win, r, c);
+    win->expose = true;
+}
+
 /*
  * Paint callback
  */
 static void gs_paint(xgui_window_t* win) {
     int cw = win->client_width;
-    int ch = win->client_height;
     int vis = gs_vis_rows(win);
 
     /* Toolbar background */
@@ -847,42 +1344,7 @@ static void gs_paint(xgui_window_t* win) {
     xgui_widgets_draw(win);
 
     /* Formula bar */
-    int fbar_y = GS_TOOLBAR_H;
-    xgui_win_rect_filled(win, 0, fbar_y, cw, GS_FBAR_H, GS_FBAR_BG);
-    {
-        /* Cell reference (e.g., "A1" or "Z100") */
-        char ref[8];
-        ref[0] = 'A' + gs_cur_col;
-        snprintf(ref + 1, sizeof(ref) - 1, "%d", gs_cur_row + 1);
-        xgui_win_text_transparent(win, 4, fbar_y + 2, ref, XGUI_BLACK);
-        xgui_win_vline(win, 40, fbar_y, GS_FBAR_H, GS_GRID_LINE);
-
-        /* Show content or edit buffer - clip at window edge naturally */
-        const char* show = gs_editing ? gs_edit_buf : gs_cells[gs_cur_row][gs_cur_col].content;
-        if (show && show[0]) {
-            /* Calculate how many chars fit before clipping */
-            int avail_pixels = cw - 46 - 4; /* Leave 4px margin on right */
-            int max_chars = avail_pixels / GS_CHAR_W;
-            int len = strlen(show);
-
-            if (len <= max_chars) {
-                /* Show full text */
-                xgui_win_text_transparent(win, 46, fbar_y + 2, show, XGUI_BLACK);
-            } else {
-                /* Show with ellipsis indicator */
-                char display[GS_MAX_CONTENT + 1];
-                if (max_chars > 3) {
-                    strncpy(display, show, max_chars - 3);
-                    strcpy(display + max_chars - 3, "...");
-                } else {
-                    strncpy(display, show, max_chars);
-                    display[max_chars] = '\0';
-                }
-                xgui_win_text_transparent(win, 46, fbar_y + 2, display, XGUI_BLACK);
-            }
-        }
-    }
-    xgui_win_hline(win, 0, fbar_y + GS_FBAR_H - 1, cw, GS_GRID_LINE);
+    gs_draw_fbar(win);
 
     int grid_y = GS_TOOLBAR_H + GS_FBAR_H;
 
@@ -893,89 +1355,19 @@ static void gs_paint(xgui_window_t* win) {
     for (int ci = 0; ci < vcols; ci++) {
         int c = gs_view_col + ci;
         if (c >= GS_COLS) break;
-        int x = GS_HDR_W + ci * GS_CELL_W;
-        if (x >= cw) break;
-        char lbl[2] = { 'A' + c, '\0' };
-        int tx = x + GS_CELL_W / 2 - GS_CHAR_W / 2;
-        xgui_win_text_transparent(win, tx, grid_y + 1, lbl,
-                                  c == gs_cur_col ? GS_CURSOR_BRD : GS_HDR_FG);
-        xgui_win_vline(win, x, grid_y, GS_HDR_H, GS_GRID_LINE);
+        gs_draw_col_hdr(win, c);
     }
 
     /* Row headers + cells */
     for (int vi = 0; vi < vis; vi++) {
         int r = gs_view_row + vi;
         if (r >= GS_ROWS) break;
-        int y = grid_y + GS_HDR_H + vi * GS_CELL_H;
-
-        /* Row number */
-        xgui_win_rect_filled(win, 0, y, GS_HDR_W, GS_CELL_H, GS_HDR_BG);
-        char rnum[4];
-        snprintf(rnum, sizeof(rnum), "%d", r + 1);
-        xgui_win_text_transparent(win, 4, y + 1, rnum,
-                                  r == gs_cur_row ? GS_CURSOR_BRD : GS_HDR_FG);
 
-        /* Cells */
+        gs_draw_row_hdr(win, r);
         for (int ci = 0; ci < vcols; ci++) {
             int c = gs_view_col + ci;
             if (c >= GS_COLS) break;
-            int x = GS_HDR_W + ci * GS_CELL_W;
-            if (x >= cw) break;
-            gs_cell_t* cell = &gs_cells[r][c];
-
-            /* Background */
-            uint32_t bg = GS_GRID_BG;
-            if (r == gs_cur_row && c == gs_cur_col) {
-                bg = gs_editing ? GS_EDIT_BG : GS_CURSOR_BG;
-            }
-            xgui_win_rect_filled(win, x, y, GS_CELL_W, GS_CELL_H, bg);
-
-            /* Cell border */
-            xgui_win_vline(win, x, y, GS_CELL_H, GS_GRID_LINE);
-            xgui_win_hline(win, x, y + GS_CELL_H - 1, GS_CELL_W, GS_GRID_LINE);
-
-            /* Cursor highlight */
-            if (r == gs_cur_row && c == gs_cur_col) {
-                xgui_win_rect(win, x, y, GS_CELL_W, GS_CELL_H, GS_CURSOR_BRD);
-            }
-
-            /* Cell text */
-            if (r == gs_cur_row && c == gs_cur_col && gs_editing) {
-                /* Show edit buffer with cursor */
-                if (gs_edit_buf[0]) {
-                    char disp[GS_MAX_CONTENT];
-                    int maxch = (GS_CELL_W - 4) / GS_CHAR_W;
-                    strncpy(disp, gs_edit_buf, maxch);
-                    disp[maxch] = '\0';
-                    xgui_win_text_transparent(win, x + 2, y + 1, disp, GS_TEXT_FG);
-                }
-                /* Edit cursor */
-                int cx = x + 2 + gs_edit_pos * GS_CHAR_W;
-                if (cx < x + GS_CELL_W - 2) {
-                    xgui_win_rect_filled(win, cx, y + 1, 2, GS_CELL_H - 2, XGUI_BLACK);
-                }
-            } else if (cell->type != GS_EMPTY) {
-                char disp[GS_MAX_CONTENT];
-                int maxch = (GS_CELL_W - 4) / GS_CHAR_W;
-
-                if (cell->type == GS_NUMBER || cell->type == GS_FORMULA) {
-                    int whole = (int)cell->value;
-                    int frac = (int)((cell->value - whole) * 100);
-                    if (frac < 0) frac = -frac;
-                    if (frac == 0) snprintf(disp, maxch + 1, "%d", whole);
-                    else snprintf(disp, maxch + 1, "%d.%02d", whole, frac);
-                    /* Right-align numbers */
-                    int len = strlen(disp);
-                    int tx = x + GS_CELL_W - 2 - len * GS_CHAR_W;
-                    if (tx < x + 2) tx = x + 2;
-                    uint32_t fg = cell->type == GS_FORMULA ? GS_FORMULA_FG : GS_NUM_FG;
-                    xgui_win_text_transparent(win, tx, y + 1, disp, fg);
-                } else {
-                    strncpy(disp, cell->content, maxch);
-                    disp[maxch] = '\0';
-                    xgui_win_text_transparent(win, x + 2, y + 1, disp, GS_TEXT_FG);
-                }
-            }
+            gs_draw_cell_at(win, r, c);
         }
     }
 
@@ -1062,25 +1454,7 @@ static void gs_paint(xgui_window_t* win) {
     }
 
     /* Status bar */
-    int sy = ch - GS_STATUS_H;
-    xgui_win_rect_filled(win, 0, sy, cw, GS_STATUS_H, GS_STATUS_BG);
-
-    if (gs_fname_mode) {
-        const char* prompt = gs_fname_mode == 1 ? "Open: " : "Save as: ";
-        char status[128];
-        snprintf(status, sizeof(status), "%s%s_", prompt, gs_fname_buf);
-        xgui_win_text_transparent(win, 4, sy + 2, status, GS_STATUS_FG);
-    } else if (gs_status_ticks > 0) {
-        xgui_win_text_transparent(win, 4, sy + 2, gs_status_msg, XGUI_RGB(255, 255, 100));
-        gs_status_ticks--;
-        if (gs_status_ticks > 0) win->dirty = true;
-    } else {
-        char status[128];
-        snprintf(status, sizeof(status), " %s  Cell %c%d",
-                 gs_filename[0] ? gs_filename : "[No File]",
-                 'A' + gs_cur_col, gs_cur_row + 1);
-        xgui_win_text_transparent(win, 4, sy + 2, status, GS_STATUS_FG);
-    }
+    gs_draw_status(win);
 }
 
 /*
@@ -1149,10 +1523,15 @@ static void gs_handler(xgui_window_t* win, xgui_event_t* event) {
             int new_row = gs_view_row + (my - grid_y) / GS_CELL_H;
             if (new_col >= 0 && new_col < GS_COLS &&
                 new_row >= 0 && new_row < GS_ROWS) {
-                if (gs_editing) gs_commit_edit();
-                gs_cur_col = new_col;
-                gs_cur_row = new_row;
-                win->dirty = true;
+                if (gs_editing) {
+                    /* Leaving edit mode changes more than two cells */
+                    gs_commit_edit();
+                    gs_cur_col = new_col;
+                    gs_cur_row = new_row;
+                    win->dirty = true;
+                } else {
+                    gs_move_cursor(new_row, new_col);
+                }
             }
         }
         return;
@@ -1218,28 +1597,26 @@ static void gs_handler(xgui_window_t* win, xgui_event_t* event) {
         }
     }
 
-    /* Navigation mode */
+    /* Navigation mode: cursor moves go through gs_move_cursor so a
+     * plain step costs two cell redraws, not a full grid repaint */
+    int new_row = gs_cur_row;
+    int new_col = gs_cur_col;
     switch (key) {
         case KEY_UP:
-            if (gs_cur_row > 0) gs_cur_row--;
-            gs_ensure_visible();
+            if (new_row > 0) new_row--;
             break;
         case KEY_DOWN:
-            if (gs_cur_row < GS_ROWS - 1) gs_cur_row++;
-            gs_ensure_visible();
+            if (new_row < GS_ROWS - 1) new_row++;
             break;
         case KEY_LEFT:
-            if (gs_cur_col > 0) gs_cur_col--;
-            gs_ensure_visible();
+            if (new_col > 0) new_col--;
             break;
         case KEY_RIGHT:
-            if (gs_cur_col < GS_COLS - 1) gs_cur_col++;
-            gs_ensure_visible();
+            if (new_col < GS_COLS - 1) new_col++;
             break;
         case '\t':
-            if (gs_cur_col < GS_COLS - 1) gs_cur_col++;
-            else if (gs_cur_row < GS_ROWS - 1) { gs_cur_col = 0; gs_cur_row++; }
-            gs_ensure_visible();
+            if (new_col < GS_COLS - 1) new_col++;
+            else if (new_row < GS_ROWS - 1) { new_col = 0; new_row++; }
             break;
         case '\n':
         case '\r':
@@ -1248,36 +1625,35 @@ static void gs_handler(xgui_window_t* win, xgui_event_t* event) {
             strncpy(gs_edit_buf, gs_cells[gs_cur_row][gs_cur_col].content, GS_MAX_CONTENT - 1);
             gs_edit_buf[GS_MAX_CONTENT - 1] = '\0';
             gs_edit_pos = strlen(gs_edit_buf);
-            break;
+            win->dirty = true;
+            return;
         case KEY_DELETE:
             /* Delete cell contents */
             gs_cells[gs_cur_row][gs_cur_col].type = GS_EMPTY;
             gs_cells[gs_cur_row][gs_cur_col].content[0] = '\0';
             gs_cells[gs_cur_row][gs_cur_col].value = 0;
-            gs_eval_all();
-            break;
+            gs_track_cell(gs_cur_row, gs_cur_col);
+            gs_recalc(gs_cur_row, gs_cur_col);
+            win->dirty = true;
+            return;
         case KEY_HOME:
-            gs_cur_col = 0;
-            gs_ensure_visible();
+            new_col = 0;
             break;
         case KEY_END:
-            gs_cur_col = GS_COLS - 1;
-            gs_ensure_visible();
+            new_col = GS_COLS - 1;
             break;
         case KEY_PAGEUP:
-            gs_cur_row -= gs_vis_rows(win);
-            if (gs_cur_row < 0) gs_cur_row = 0;
-            gs_ensure_visible();
+            new_row -= gs_vis_rows(win);
+            if (new_row < 0) new_row = 0;
             break;
         case KEY_PAGEDOWN:
-            gs_cur_row += gs_vis_rows(win);
-            if (gs_cur_row >= GS_ROWS) gs_cur_row = GS_ROWS - 1;
-            gs_ensure_visible();
+            new_row += gs_vis_rows(win);
+            if (new_row >= GS_ROWS) new_row = GS_ROWS - 1;
             break;
         default:
             return;
     }
-    win->dirty = true;
+    gs_move_cursor(new_row, new_col);
 }
 
 /*
@@ -1291,6 +1667,7 @@ void xgui_gui_spreadsheet_create(void) {
 
     /* Reset state */
     memset(gs_cells, 0, sizeof(gs_cells));
+    gs_deps_reset();
     gs_cur_row = 0;
     gs_cur_col = 0;
     gs_view_row = 0;
@@ -76,6 +76,11 @@ typedef struct {
     int sel_end_line;
     int sel_end_col;
     bool selecting;     /* Mouse drag in progress */
+    /* Wrap layout cache: screen rows per line, 0 = recompute lazily.
+     * Invalidated per edited line (and below, for line shifts); the
+     * whole cache drops when the wrap width changes. */
+    uint8_t wrap_cache[SN_MAX_LINES];
+    int wrap_cache_cols;
 } sticky_note_t;
 
 static sticky_note_t notes[SN_MAX_NOTES];
@@ -189,6 +194,8 @@ static int sn_load_with_geo(int slot) {
     sn->bg_color = sn_colors[slot];
     sn->slot = slot;
     memset(sn->lines, 0, sizeof(sn->lines));
+    memset(sn->wrap_cache, 0, sizeof(sn->wrap_cache));
+    sn->wrap_cache_cols = -1;
 
     char path[64];
     sn_filepath(slot, path, sizeof(path));
@@ -270,6 +277,16 @@ static int sn_line_len(sticky_note_t* sn, int ln) {
     return len;
 }
 
+static void sn_layout_invalidate(sticky_note_t* sn, int ln) {
+    if (ln >= 0 && ln < SN_MAX_LINES) sn->wrap_cache[ln] = 0;
+}
+
+/* Line inserts/deletes shift every slot below the edit point */
+static void sn_layout_invalidate_from(sticky_note_t* sn, int ln) {
+    if (ln < 0) ln = 0;
+    for (int i = ln; i < SN_MAX_LINES; i++) sn->wrap_cache[i] = 0;
+}
+
 /* Word wrap: how many columns fit in the note width */
 static int sn_wrap_cols(sticky_note_t* sn) {
     if (!sn->window) return 28;
@@ -277,12 +294,23 @@ static int sn_wrap_cols(sticky_note_t* sn) {
     return cols > 0 ? cols : 1;
 }
 
-/* How many screen rows does a logical line occupy with word wrap */
+/* How many screen rows does a logical line occupy with word wrap
+ * (served from the layout cache when the entry is still valid) */
 static int sn_line_screen_rows(sticky_note_t* sn, int ln) {
-    int len = sn_line_len(sn, ln);
     int cols = sn_wrap_cols(sn);
-    if (len == 0) return 1;
-    return (len + cols - 1) / cols;
+    if (cols != sn->wrap_cache_cols) {
+        sn_layout_invalidate_from(sn, 0);
+        sn->wrap_cache_cols = cols;
+    }
+    if (ln >= 0 && ln < SN_MAX_LINES && sn->wrap_cache[ln] != 0) {
+        return sn->wrap_cache[ln];
+    }
+    int len = sn_line_len(sn, ln);
+    int rows = (len == 0) ? 1 : (len + cols - 1) / cols;
+    if (ln >= 0 && ln < SN_MAX_LINES) {
+        sn->wrap_cache[ln] = (uint8_t)rows;
+    }
+    return rows;
 }
 
 static void sn_ensure_visible(sticky_note_t* sn) {
@@ -308,6 +336,7 @@ static void sn_insert_char(sticky_note_t* sn, char c) {
     }
     sn->lines[sn->cur_line][sn->cur_col] = c;
     sn->cur_col++;
+    sn_layout_invalidate(sn, sn->cur_line);
 }
 
 static void sn_insert_newline(sticky_note_t* sn) {
@@ -319,6 +348,7 @@ static void sn_insert_newline(sticky_note_t* sn) {
     int len = sn_line_len(sn, sn->cur_line);
     memcpy(sn->lines[sn->cur_line + 1], &sn->lines[sn->cur_line][sn->cur_col], len - sn->cur_col + 1);
     sn->lines[sn->cur_line][sn->cur_col] = '\0';
+    sn_layout_invalidate_from(sn, sn->cur_line);
     sn->cur_line++;
     sn->cur_col = 0;
     sn_ensure_visible(sn);
@@ -331,6 +361,7 @@ static void sn_do_backspace(sticky_note_t* sn) {
             sn->lines[sn->cur_line][i] = sn->lines[sn->cur_line][i + 1];
         }
         sn->cur_col--;
+        sn_layout_invalidate(sn, sn->cur_line);
     } else if (sn->cur_line > 0) {
         int prev_len = sn_line_len(sn, sn->cur_line - 1);
         int cur_len = sn_line_len(sn, sn->cur_line);
@@ -342,6 +373,7 @@ static void sn_do_backspace(sticky_note_t* sn) {
             sn->line_count--;
             sn->cur_line--;
             sn->cur_col = prev_len;
+            sn_layout_invalidate_from(sn, sn->cur_line);
         }
     }
     sn_ensure_visible(sn);
@@ -391,20 +423,23 @@ static void sn_copy_selection(sticky_note_t* sn) {
     int sl, sc, el, ec;
     sn_get_selection(sn, &sl, &sc, &el, &ec);
 
-    char buf[XGUI_CLIPBOARD_MAX];
+    /* Build the text in the clipboard's own storage (no staging copy) */
+    int cap = (el - sl + 1) * (SN_MAX_COLS + 1);
+    if (cap >= XGUI_CLIPBOARD_MAX) cap = XGUI_CLIPBOARD_MAX - 1;
+    char* buf = xgui_clipboard_reserve(cap);
+    if (!buf) return;
     int pos = 0;
-    for (int ln = sl; ln <= el && pos < XGUI_CLIPBOARD_MAX - 2; ln++) {
+    for (int ln = sl; ln <= el && pos < cap; ln++) {
         int start = (ln == sl) ? sc : 0;
         int end = (ln == el) ? ec : sn_line_len(sn, ln);
-        for (int c = start; c < end && pos < XGUI_CLIPBOARD_MAX - 2; c++) {
+        for (int c = start; c < end && pos < cap; c++) {
             buf[pos++] = sn->lines[ln][c];
         }
-        if (ln < el && pos < XGUI_CLIPBOARD_MAX - 2) {
+        if (ln < el && pos < cap) {
             buf[pos++] = '\n';
         }
     }
-    buf[pos] = '\0';
-    xgui_clipboard_set(buf, pos);
+    xgui_clipboard_commit(pos);
 }
 
 static void sn_delete_selection(sticky_note_t* sn) {
@@ -430,6 +465,7 @@ static void sn_delete_selection(sticky_note_t* sn) {
     }
     sn->cur_line = sl;
     sn->cur_col = sc;
+    sn_layout_invalidate_from(sn, sl);
     sn_clear_selection(sn);
     sn_ensure_visible(sn);
 }
@@ -775,6 +811,8 @@ void xgui_notepad_create(void) {
     sn->scroll_y = 0;
     sn->bg_color = sn_colors[slot];
     sn->slot = slot;
+    sn_layout_invalidate_from(sn, 0);
+    sn->wrap_cache_cols = -1;
     sn_clear_selection(sn);
 
     sn_open_window(slot, sn_offsets[slot][0], sn_offsets[slot][1], 0);
@@ -236,65 +236,115 @@ static void canvas_ellipse_fill(int cx, int cy, int rx, int ry, uint32_t color)
     }
 }
 
-/* Scanline flood fill */
-static void canvas_flood_fill(int sx, int sy, uint32_t fill) {
+/*
+ * Scanline flood fill with an explicit segment stack.
+ *
+ * Each stack entry is a parent span [x1,x2] whose row y is still to be
+ * scanned, plus the direction dy the fill was moving; leaks past the
+ * parent's ends are pushed back in the opposite direction so U-shaped
+ * regions fill completely. Span scans index the canvas row directly
+ * instead of going through the bounds-checked per-pixel helpers.
+ *
+ * The filled bounding box is returned through fx/fy/fw/fh (fw/fh are 0
+ * when nothing was filled) so the caller can flush just that region.
+ */
+#define FILL_STACK_MAX 2048
+
+typedef struct {
+    int16_t x1, x2;     /* Parent span, inclusive */
+    int16_t y;          /* Row to scan */
+    int16_t dy;         /* Fill direction: +1 down, -1 up */
+} fill_seg_t;
+
+static void canvas_flood_fill(int sx, int sy, uint32_t fill,
+                              int* fx, int* fy, int* fw, int* fh) {
+    *fx = *fy = *fw = *fh = 0;
     if (sx < 0 || sx >= CANVAS_W || sy < 0 || sy >= CANVAS_H) return;
-    uint32_t target = canvas_get(sx, sy);
+    uint32_t target = canvas[sy * CANVAS_W + sx];
     if (target == fill) return;
 
-    #define FILL_MAX 8192
-    int16_t* stk_x = (int16_t*)kmalloc(FILL_MAX * sizeof(int16_t));
-    int16_t* stk_y = (int16_t*)kmalloc(FILL_MAX * sizeof(int16_t));
-    if (!stk_x || !stk_y) { kfree(stk_x); kfree(stk_y); return; }
-
+    fill_seg_t* stk = (fill_seg_t*)kmalloc(FILL_STACK_MAX * sizeof(fill_seg_t));
+    if (!stk) return;
     int sp = 0;
-    stk_x[sp] = (int16_t)sx;
-    stk_y[sp] = (int16_t)sy;
-    sp++;
+
+    int minx = CANVAS_W, maxx = -1, miny = CANVAS_H, maxy = -1;
+
+    #define FILL_PUSH(Y, XL, XR, DY)                                       \
+        do {                                                               \
+            if (sp < FILL_STACK_MAX && (Y) >= 0 && (Y) < CANVAS_H) {       \
+                stk[sp].y = (int16_t)(Y);                                  \
+                stk[sp].x1 = (int16_t)(XL);                                \
+                stk[sp].x2 = (int16_t)(XR);                                \
+                stk[sp].dy = (int16_t)(DY);                                \
+                sp++;                                                      \
+            }                                                              \
+        } while (0)
+
+    FILL_PUSH(sy, sx, sx, 1);
+    FILL_PUSH(sy - 1, sx, sx, -1);
 
     while (sp > 0) {
         sp--;
-        int x = stk_x[sp], y = stk_y[sp];
-        if (canvas_get(x, y) != target) continue;
-
-        /* Find left edge of this scanline */
-        int left = x;
-        while (left > 0 && canvas_get(left - 1, y) == target) left--;
-
-        /* Fill rightward, seeding rows above and below */
-        int right = left;
-        bool a_add = false, b_add = false;
-        while (right < CANVAS_W && canvas_get(right, y) == target) {
-            canvas_set(right, y, fill);
-            if (y > 0) {
-                if (canvas_get(right, y - 1) == target) {
-                    if (!a_add && sp < FILL_MAX) {
-                        stk_x[sp] = (int16_t)right;
-                        stk_y[sp] = (int16_t)(y - 1);
-                        sp++;
-                        a_add = true;
-                    }
-                } else {
-                    a_add = false;
+        int y  = stk[sp].y;
+        int x1 = stk[sp].x1;
+        int x2 = stk[sp].x2;
+        int dy = stk[sp].dy;
+        uint32_t* row = &canvas[y * CANVAS_W];
+
+        /* Extend leftward from the parent span's left end */
+        int x = x1;
+        while (x >= 0 && row[x] == target) {
+            row[x] = fill;
+            x--;
+        }
+
+        bool skip = (x >= x1);      /* Nothing at x1: hunt inside [x1,x2] */
+        int left = x + 1;
+        if (!skip && left < x1) {
+            /* Leaked past the parent's left end: runs back the other way */
+            FILL_PUSH(y - dy, left, x1 - 1, -dy);
+        }
+
+        x = skip ? x1 : x1 + 1;
+        while (1) {
+            if (!skip) {
+                /* Fill rightward until the run ends */
+                while (x < CANVAS_W && row[x] == target) {
+                    row[x] = fill;
+                    x++;
                 }
-            }
-            if (y < CANVAS_H - 1) {
-                if (canvas_get(right, y + 1) == target) {
-                    if (!b_add && sp < FILL_MAX) {
-                        stk_x[sp] = (int16_t)right;
-                        stk_y[sp] = (int16_t)(y + 1);
-                        sp++;
-                        b_add = true;
-                    }
-                } else {
-                    b_add = false;
+
+                /* Run [left, x-1] on row y is now filled */
+                if (left < minx)  minx = left;
+                if (x - 1 > maxx) maxx = x - 1;
+                if (y < miny)     miny = y;
+                if (y > maxy)     maxy = y;
+
+                FILL_PUSH(y + dy, left, x - 1, dy);
+                if (x > x2 + 1) {
+                    /* Leaked past the parent's right end */
+                    FILL_PUSH(y - dy, x2 + 1, x - 1, -dy);
                 }
             }
-            right++;
+
+            /* Find the next run within the parent span */
+            x++;
+            while (x <= x2 && row[x] != target) x++;
+            if (x > x2) break;
+            left = x;
+            skip = false;
         }
     }
-    kfree(stk_x);
-    kfree(stk_y);
+
+    #undef FILL_PUSH
+    kfree(stk);
+
+    if (maxx >= minx && maxy >= miny) {
+        *fx = minx;
+        *fy = miny;
+        *fw = maxx - minx + 1;
+        *fh = maxy - miny + 1;
+    }
 }
 
 /* Commit a finished shape from drag coordinates onto canvas */
@@ -1002,10 +1052,20 @@ static void paint_handler(xgui_window_t* win, xgui_event_t* event) {
                 else fg_color = canvas_get(cx, cy);
                 win->dirty = true;
                 break;
-            case TOOL_FILL:
-                canvas_flood_fill(cx, cy, right_btn ? bg_color : fg_color);
-                win->dirty = true;
+            case TOOL_FILL: {
+                int ffx, ffy, ffw, ffh;
+                canvas_flood_fill(cx, cy, right_btn ? bg_color : fg_color,
+                                  &ffx, &ffy, &ffw, &ffh);
+                if (ffw > 0 && ffh > 0) {
+                    /* Only the filled bounding box needs flushing */
+                    xgui_display_mark_dirty_rect(
+                        win->x + win->client_x + CANVAS_X + ffx,
+                        win->y + win->client_y + CANVAS_Y + ffy,
+                        ffw, ffh);
+                    win->dirty = true;
+                }
                 break;
+            }
             case TOOL_LINE:
             case TOOL_RECT:
             case TOOL_FILLED_RECT:
@@ -9,6 +9,7 @@
 #include "xgui/xgui.h"
 #include "xgui/wm.h"
 #include "xgui/display.h"
+#include "xgui/sprite.h"
 #include "xgui/theme.h"
 #include "string.h"
 #include "keyboard.h"
@@ -18,6 +19,10 @@
 /* Window */
 static xgui_window_t* ski_window = NULL;
 
+/* Sprite scene: static snow background with restore/redraw sprites */
+static xgui_sprite_scene_t ski_scene;
+static bool ski_scene_valid = false;
+
 /* Game area */
 #define GAME_W  280
 #define GAME_H  360
@@ -383,48 +388,64 @@ static void draw_gameover(xgui_window_t* win) {
 }
 
 /*
- * Paint callback
+ * Paint callback. The window is NOCLEAR: during play the snow
+ * background is drawn once and captured into the sprite scene, and
+ * each frame only restores/redraws the sprite rects.
  */
 static void ski_paint(xgui_window_t* win) {
     if (game_state == SKI_STATE_MENU) {
         draw_menu(win);
+        ski_scene_valid = false;
         return;
     }
 
-    /* Snow background */
-    xgui_win_clear(win, XGUI_RGB(235, 240, 250));
-
-    /* Subtle snow texture — scattered dots */
-    uint32_t snow_seed = frame_count * 7 + 1;
-    for (int i = 0; i < 30; i++) {
-        snow_seed ^= snow_seed << 13;
-        snow_seed ^= snow_seed >> 17;
-        snow_seed ^= snow_seed << 5;
-        int sx = snow_seed % GAME_W;
-        int sy = (snow_seed / GAME_W) % GAME_H;
-        xgui_win_pixel(win, sx, sy, XGUI_RGB(220, 225, 235));
+    if (game_state == SKI_STATE_GAMEOVER) {
+        /* Freeze the last frame and overlay the results */
+        draw_gameover(win);
+        ski_scene_valid = false;
+        return;
     }
 
-    /* Draw trail */
+    if (!ski_scene_valid) {
+        /* Snow background with a static sprinkling of darker flakes */
+        xgui_win_clear(win, XGUI_RGB(235, 240, 250));
+        uint32_t snow_seed = rng_state | 1;
+        for (int i = 0; i < 30; i++) {
+            snow_seed ^= snow_seed << 13;
+            snow_seed ^= snow_seed >> 17;
+            snow_seed ^= snow_seed << 5;
+            int sx = snow_seed % GAME_W;
+            int sy = (snow_seed / GAME_W) % GAME_H;
+            xgui_win_pixel(win, sx, sy, XGUI_RGB(220, 225, 235));
+        }
+        xgui_sprite_capture(&ski_scene);
+        /* Without a background buffer, fall back to full redraws */
+        ski_scene_valid = (ski_scene.background != NULL);
+    } else {
+        xgui_sprite_begin(&ski_scene);
+    }
+
+    /* Trail */
     draw_trail(win);
+    xgui_sprite_mark(&ski_scene, player_x - 8, 20, 17, 44);
 
-    /* Draw obstacles */
+    /* Obstacles */
     for (int i = 0; i < MAX_OBSTACLES; i++) {
         if (obstacles[i].active && obstacles[i].y > -20 && obstacles[i].y < GAME_H + 10) {
             draw_obstacle(win, &obstacles[i]);
+            xgui_sprite_mark(&ski_scene, obstacles[i].x - 9,
+                             obstacles[i].y - 17, 19, 23);
         }
     }
 
-    /* Draw skier */
+    /* Skier at (player_x, 60) */
     draw_skier(win);
+    xgui_sprite_mark(&ski_scene, player_x - 9, 51, 19, 21);
 
     /* HUD */
     draw_hud(win);
-
-    /* Game over overlay */
-    if (game_state == SKI_STATE_GAMEOVER) {
-        draw_gameover(win);
-    }
+    xgui_sprite_mark(&ski_scene, 5, 5, 110, 16);
+    xgui_sprite_mark(&ski_scene, GAME_W - 90, 5, 88, 16);
 }
 
 /*
@@ -541,6 +562,8 @@ static void ski_tick(void) {
  */
 static void ski_handler(xgui_window_t* win, xgui_event_t* event) {
     if (event->type == XGUI_EVENT_WINDOW_CLOSE) {
+        xgui_sprite_scene_free(&ski_scene);
+        ski_scene_valid = false;
         xgui_window_destroy(win);
         ski_window = NULL;
         game_state = SKI_STATE_MENU;
@@ -555,6 +578,7 @@ static void ski_handler(xgui_window_t* win, xgui_event_t* event) {
             if (c == ' ') {
                 ski_reset();
                 game_state = SKI_STATE_PLAYING;
+                ski_scene_valid = false;
                 win->dirty = true;
             }
             return;
@@ -564,6 +588,7 @@ static void ski_handler(xgui_window_t* win, xgui_event_t* event) {
             if (c == 'r' || c == 'R') {
                 ski_reset();
                 game_state = SKI_STATE_PLAYING;
+                ski_scene_valid = false;
                 win->dirty = true;
             }
             return;
@@ -603,10 +628,14 @@ void xgui_skigame_create(void) {
     game_state = SKI_STATE_MENU;
 
     ski_window = xgui_window_create("Ski Game", 100, 40, WIN_W, WIN_H,
-                                     XGUI_WINDOW_DEFAULT);
+                                     XGUI_WINDOW_DEFAULT | XGUI_WINDOW_NOCLEAR);
     if (!ski_window) return;
 
     xgui_window_set_paint(ski_window, ski_paint);
     xgui_window_set_handler(ski_window, ski_handler);
     xgui_window_set_bgcolor(ski_window, XGUI_WHITE);
+
+    /* Scene init can fail; ski_paint then keeps doing full redraws */
+    xgui_sprite_scene_init(&ski_scene, ski_window);
+    ski_scene_valid = false;
 }
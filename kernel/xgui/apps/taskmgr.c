@@ -13,10 +13,11 @@
 #include "string.h"
 #include "stdio.h"
 #include "timer.h"
+#include "scheduler.h"
 
 /* Task Manager configuration */
 #define TM_WIDTH        340
-#define TM_HEIGHT       320
+#define TM_HEIGHT       352
 #define TM_TOOLBAR_H    28
 #define TM_ITEM_H       18
 #define TM_MAX_TASKS    16
@@ -118,7 +119,7 @@ static void tm_paint(xgui_window_t* win) {
     xgui_widgets_draw(win);
 
     /* List area background */
-    int list_h = ch - TM_LIST_Y - 80;
+    int list_h = ch - TM_LIST_Y - 112;
     xgui_win_rect_filled(win, TM_LIST_X, TM_LIST_Y, cw - 12, list_h, XGUI_WHITE);
     xgui_win_rect_3d_sunken(win, TM_LIST_X, TM_LIST_Y, cw - 12, list_h);
 
@@ -159,7 +160,7 @@ static void tm_paint(xgui_window_t* win) {
     }
 
     /* Memory info section */
-    int info_y = ch - 72;
+    int info_y = ch - 104;
     xgui_win_hline(win, 6, info_y, cw - 12, XGUI_DARK_GRAY);
     xgui_win_text_transparent(win, 8, info_y + 6, "System Memory", XGUI_BLACK);
 
@@ -209,9 +210,29 @@ static void tm_paint(xgui_window_t* win) {
         xgui_win_rect_filled(win, bar_x + 2, bar_y + 2, used_w, bar_h - 4, bar_color);
     }
 
-    /* Window count */
-    snprintf(line, sizeof(line), "Windows: %d", task_count);
+    /* Window count and scheduler latency summary */
+    scheduler_stats_t sched;
+    scheduler_get_stats(&sched);
+    uint32_t avg_delay = 0;
+    if (sched.dispatches > 0) {
+        /* Truncated 32-bit math: the kernel links without libgcc */
+        avg_delay = (uint32_t)sched.total_delay_us / sched.dispatches;
+    }
+
+    snprintf(line, sizeof(line), "Windows: %d   Sched: %u/%u us",
+             task_count, avg_delay, sched.max_delay_us);
     xgui_win_text_transparent(win, 170, info_y + 50, line, XGUI_BLACK);
+
+    snprintf(line, sizeof(line), "Switches: %uV / %uI",
+             sched.voluntary, sched.involuntary);
+    xgui_win_text_transparent(win, 170, info_y + 64, line, XGUI_BLACK);
+
+    /* Compositor frame timing */
+    xgui_frame_stats_t frame;
+    xgui_display_get_frame_stats(&frame);
+    snprintf(line, sizeof(line), "Frame: %u fps  %u/%u us",
+             frame.fps, frame.compose_us, frame.flush_us);
+    xgui_win_text_transparent(win, 8, info_y + 78, line, XGUI_BLACK);
 }
 
 /*
@@ -240,7 +261,7 @@ static void tm_handler(xgui_window_t* win, xgui_event_t* event) {
 
         int hdr_y = TM_LIST_Y + 2;
         int item_y = hdr_y + TM_ITEM_H + 2;
-        int list_h = win->client_height - TM_LIST_Y - 80;
+        int list_h = win->client_height - TM_LIST_Y - 112;
         int visible = (list_h - TM_ITEM_H - 6) / TM_ITEM_H;
 
         if (mx >= TM_LIST_X && mx < cw - 6 &&
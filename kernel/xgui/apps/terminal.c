@@ -13,9 +13,10 @@
 #include "string.h"
 #include "stdio.h"
 #include "keyboard.h"
+#include "heap.h"
 
 /* Terminal configuration */
-#define TERM_MAX_LINES   200
+#define TERM_MAX_LINES   2048
 #define TERM_MAX_COLS    80
 #define TERM_INPUT_MAX   256
 #define TERM_HISTORY_MAX 16
@@ -42,12 +43,37 @@ static int term_sel_end_line = -1;
 static int term_sel_end_col = -1;
 static bool term_selecting = false;
 
-/* Scrollback buffer (extra space for inline ANSI escape codes) */
+/* Scrollback ring buffer (extra space for inline ANSI escape codes).
+ * Allocated on first terminal creation; lines are immutable once added,
+ * so scrolling never rewrites them. */
 #define TERM_LINE_BUF  160
-static char term_lines[TERM_MAX_LINES][TERM_LINE_BUF + 1];
+#define TERM_LINE_SIZE (TERM_LINE_BUF + 1)
+static char* term_ring = NULL;
+static int term_line_start = 0;  /* Ring index of the oldest line */
 static int term_line_count = 0;
 static int term_scroll = 0;  /* Lines scrolled up from bottom (0 = latest visible) */
 
+/* Damage tracking: what changed since the last paint. The paint callback
+ * uses this to scroll the window buffer and redraw only new lines instead
+ * of re-rendering every visible cell on each frame. */
+static uint32_t term_total_lines = 0;   /* Lines ever added (monotonic) */
+static bool term_input_dirty = false;   /* Input row needs redraw */
+static bool term_full_damage = true;    /* Everything needs redraw */
+
+/* Layout snapshot from the previous paint (for the incremental path) */
+static int term_last_cw = -1, term_last_ch = -1;
+static uint32_t term_last_first_abs = 0;
+static uint32_t term_last_total = 0;
+static int term_last_scroll = 0;
+static bool term_had_selection = false;
+
+/*
+ * Get the i-th scrollback line (0 = oldest)
+ */
+static char* term_line(int idx) {
+    return &term_ring[((term_line_start + idx) % TERM_MAX_LINES) * TERM_LINE_SIZE];
+}
+
 /* Current input */
 static char term_input[TERM_INPUT_MAX];
 static int term_input_len = 0;
@@ -67,15 +93,17 @@ static int capture_pos = 0;
  * Add a line to the scrollback buffer
  */
 static void term_add_line(const char* line) {
+    if (!term_ring) return;
     if (term_line_count >= TERM_MAX_LINES) {
-        /* Scroll buffer: discard oldest line */
-        memmove(term_lines[0], term_lines[1],
-                (TERM_MAX_LINES - 1) * (TERM_LINE_BUF + 1));
+        /* Ring full: reuse the oldest slot */
+        term_line_start = (term_line_start + 1) % TERM_MAX_LINES;
         term_line_count = TERM_MAX_LINES - 1;
     }
-    strncpy(term_lines[term_line_count], line, TERM_LINE_BUF);
-    term_lines[term_line_count][TERM_LINE_BUF] = '\0';
+    char* dst = term_line(term_line_count);
+    strncpy(dst, line, TERM_LINE_BUF);
+    dst[TERM_LINE_BUF] = '\0';
     term_line_count++;
+    term_total_lines++;
 }
 
 /*
@@ -240,12 +268,12 @@ static void term_tab_complete(void) {
     int match_count = 0;
 
     if (is_first_word) {
-        /* Complete against shell commands */
-        int cmd_count = 0;
-        const shell_command_t* cmds = shell_get_commands(&cmd_count);
-        for (int i = 0; i < cmd_count && match_count < TAB_MAX_MATCHES; i++) {
-            if (strncmp(cmds[i].name, prefix, prefix_len) == 0) {
-                matches[match_count++] = cmds[i].name;
+        /* Complete against shell commands (alphabetical order) */
+        const shell_command_t* cmd;
+        for (int i = 0; (cmd = shell_command_sorted(i)) != NULL &&
+                        match_count < TAB_MAX_MATCHES; i++) {
+            if (strncmp(cmd->name, prefix, prefix_len) == 0) {
+                matches[match_count++] = cmd->name;
             }
         }
     } else {
@@ -425,8 +453,11 @@ static void term_execute(void) {
 
     /* Handle built-in commands */
     if (strcmp(term_input, "clear") == 0) {
+        term_line_start = 0;
         term_line_count = 0;
+        term_total_lines = 0;
         term_scroll = 0;
+        term_full_damage = true;
         goto done;
     }
 
@@ -480,6 +511,7 @@ done:
     term_cursor = 0;
     term_scroll = 0;
     term_hist_pos = -1;
+    term_input_dirty = true;
 }
 
 /* ------------------------------------------------------------------ */
@@ -526,7 +558,7 @@ static bool term_in_selection(int line, int col) {
  */
 static int term_visible_len(int line_idx) {
     if (line_idx < 0 || line_idx >= term_line_count) return 0;
-    const char* s = term_lines[line_idx];
+    const char* s = term_line(line_idx);
     int len = 0;
     for (int i = 0; s[i]; i++) {
         if (s[i] == '\x1b' && s[i + 1] == '[') {
@@ -545,7 +577,7 @@ static int term_visible_len(int line_idx) {
  */
 static char term_visible_char(int line_idx, int vis_col) {
     if (line_idx < 0 || line_idx >= term_line_count) return 0;
-    const char* s = term_lines[line_idx];
+    const char* s = term_line(line_idx);
     int col = 0;
     for (int i = 0; s[i]; i++) {
         if (s[i] == '\x1b' && s[i + 1] == '[') {
@@ -564,21 +596,24 @@ static void term_copy_selection(void) {
     int sl, sc, el, ec;
     term_get_selection(&sl, &sc, &el, &ec);
 
-    char buf[XGUI_CLIPBOARD_MAX];
+    /* Build the text in the clipboard's own storage (no staging copy) */
+    int cap = (el - sl + 1) * (TERM_MAX_COLS + 1);
+    if (cap >= XGUI_CLIPBOARD_MAX) cap = XGUI_CLIPBOARD_MAX - 1;
+    char* buf = xgui_clipboard_reserve(cap);
+    if (!buf) return;
     int pos = 0;
-    for (int ln = sl; ln <= el && pos < XGUI_CLIPBOARD_MAX - 2; ln++) {
+    for (int ln = sl; ln <= el && pos < cap; ln++) {
         int start = (ln == sl) ? sc : 0;
         int end = (ln == el) ? ec : term_visible_len(ln);
-        for (int c = start; c < end && pos < XGUI_CLIPBOARD_MAX - 2; c++) {
+        for (int c = start; c < end && pos < cap; c++) {
             char ch = term_visible_char(ln, c);
             if (ch) buf[pos++] = ch;
         }
-        if (ln < el && pos < XGUI_CLIPBOARD_MAX - 2) {
+        if (ln < el && pos < cap) {
             buf[pos++] = '\n';
         }
     }
-    buf[pos] = '\0';
-    xgui_clipboard_set(buf, pos);
+    xgui_clipboard_commit(pos);
 }
 
 static void term_paste(void) {
@@ -633,8 +668,55 @@ static void term_screen_to_pos(xgui_window_t* win, int mx, int my,
     *out_col = col;
 }
 
+/*
+ * Redraw a single scrollback row: clear its strip, then render the line
+ */
+static void term_draw_row(xgui_window_t* win, int row, int line_idx, int max_cols) {
+    int y = TERM_PAD + row * TERM_CHAR_H;
+    xgui_win_rect_filled(win, 0, y, win->client_width, TERM_CHAR_H, TERM_BG);
+    if (line_idx >= 0 && line_idx < term_line_count && term_line(line_idx)[0]) {
+        term_render_line(win, TERM_PAD, y, term_line(line_idx), max_cols);
+    }
+}
+
+/*
+ * Redraw the input row: separator, prompt + input text, cursor
+ */
+static void term_draw_input(xgui_window_t* win, int input_y, int max_cols) {
+    int cw = win->client_width;
+    int ch = win->client_height;
+
+    /* Clear the input strip (separator down to the bottom edge) */
+    xgui_win_rect_filled(win, 0, input_y - 2, cw, ch - (input_y - 2), TERM_BG);
+
+    /* Separator line above input */
+    xgui_win_hline(win, TERM_PAD, input_y - 2, cw - TERM_PAD * 2, TERM_FG_DIM);
+
+    /* Build display string: "$ " + input */
+    char input_display[TERM_MAX_COLS + 4];
+    snprintf(input_display, sizeof(input_display), "$ %s", term_input);
+
+    /* Truncate to visible */
+    if ((int)strlen(input_display) > max_cols) {
+        input_display[max_cols] = '\0';
+    }
+
+    xgui_win_text(win, TERM_PAD, input_y, input_display, TERM_FG_BRIGHT, TERM_BG);
+
+    /* Draw cursor */
+    int cursor_x = TERM_PAD + (term_cursor + 2) * TERM_CHAR_W;  /* +2 for "$ " */
+    if (cursor_x < cw - TERM_PAD) {
+        xgui_win_rect_filled(win, cursor_x, input_y, 2, TERM_CHAR_H, TERM_CURSOR_CLR);
+    }
+}
+
 /*
  * Window paint callback
+ *
+ * Tracks damage between paints: when only new lines were appended at the
+ * bottom, the unchanged region is scrolled up with one block copy and
+ * just the new rows are rendered. Everything else falls back to a full
+ * repaint (the window has XGUI_WINDOW_NOCLEAR, so clearing is ours).
  */
 static void terminal_paint(xgui_window_t* win) {
     int cw = win->client_width;
@@ -651,15 +733,62 @@ static void terminal_paint(xgui_window_t* win) {
     int first_line = term_line_count - output_rows - term_scroll;
     if (first_line < 0) first_line = 0;
 
+    /* Absolute (monotonic) line number of the first visible row, so
+     * scroll distance survives the ring discarding old lines */
+    uint32_t first_abs = term_total_lines - (uint32_t)(term_line_count - first_line);
+    int delta = (int)(first_abs - term_last_first_abs);
+
+    bool selection = term_has_selection();
+    bool full = term_full_damage || selection || term_had_selection ||
+                cw != term_last_cw || ch != term_last_ch ||
+                term_scroll != 0 || term_last_scroll != 0;
+    if (!full && (delta < 0 || delta >= output_rows)) {
+        full = true;
+    }
+    bool input_dirty = term_input_dirty;
+    uint32_t last_total = term_last_total;
+
+    /* Snapshot layout for the next paint and reset damage */
+    term_last_cw = cw;
+    term_last_ch = ch;
+    term_last_first_abs = first_abs;
+    term_last_total = term_total_lines;
+    term_last_scroll = term_scroll;
+    term_had_selection = selection;
+    term_full_damage = false;
+    term_input_dirty = false;
+
+    if (!full) {
+        /* Incremental path: shift the surviving rows up in one copy,
+         * then render only lines added since the last paint */
+        if (delta > 0) {
+            xgui_win_copy_rect(win, 0, TERM_PAD, 0, TERM_PAD + delta * TERM_CHAR_H,
+                               cw, (output_rows - delta) * TERM_CHAR_H);
+        }
+        for (int i = 0; i < output_rows; i++) {
+            int line_idx = first_line + i;
+            if (line_idx >= term_line_count) break;
+            if (first_abs + (uint32_t)i >= last_total) {
+                term_draw_row(win, i, line_idx, max_cols);
+            }
+        }
+        if (delta > 0 || input_dirty) {
+            term_draw_input(win, TERM_PAD + output_rows * TERM_CHAR_H, max_cols);
+        }
+        return;
+    }
+
+    xgui_win_clear(win, TERM_BG);
+
     /* Draw scrollback lines (with selection highlighting) */
     for (int i = 0; i < output_rows; i++) {
         int line_idx = first_line + i;
         if (line_idx >= term_line_count) break;
 
         int y = TERM_PAD + i * TERM_CHAR_H;
-        if (term_has_selection()) {
+        if (selection) {
             /* Render character by character for selection highlight */
-            const char* s = term_lines[line_idx];
+            const char* s = term_line(line_idx);
             uint32_t color = TERM_FG;
             int col = 0;
             for (int si = 0; s[si] && col < max_cols; si++) {
@@ -687,33 +816,13 @@ static void terminal_paint(xgui_window_t* win) {
                 }
                 col++;
             }
-        } else if (term_lines[line_idx][0]) {
-            term_render_line(win, TERM_PAD, y, term_lines[line_idx], max_cols);
+        } else if (term_line(line_idx)[0]) {
+            term_render_line(win, TERM_PAD, y, term_line(line_idx), max_cols);
         }
     }
 
     /* Draw input line at bottom */
-    int input_y = TERM_PAD + output_rows * TERM_CHAR_H;
-
-    /* Separator line above input */
-    xgui_win_hline(win, TERM_PAD, input_y - 2, cw - TERM_PAD * 2, TERM_FG_DIM);
-
-    /* Build display string: "$ " + input */
-    char input_display[TERM_MAX_COLS + 4];
-    snprintf(input_display, sizeof(input_display), "$ %s", term_input);
-
-    /* Truncate to visible */
-    if ((int)strlen(input_display) > max_cols) {
-        input_display[max_cols] = '\0';
-    }
-
-    xgui_win_text(win, TERM_PAD, input_y, input_display, TERM_FG_BRIGHT, TERM_BG);
-
-    /* Draw cursor */
-    int cursor_x = TERM_PAD + (term_cursor + 2) * TERM_CHAR_W;  /* +2 for "$ " */
-    if (cursor_x < cw - TERM_PAD) {
-        xgui_win_rect_filled(win, cursor_x, input_y, 2, TERM_CHAR_H, TERM_CURSOR_CLR);
-    }
+    term_draw_input(win, TERM_PAD + output_rows * TERM_CHAR_H, max_cols);
 
     /* Scroll indicator */
     if (term_scroll > 0) {
@@ -793,6 +902,7 @@ static void terminal_handler(xgui_window_t* win, xgui_event_t* event) {
             term_input[term_cursor] = c;
             term_input_len++;
             term_cursor++;
+            term_input_dirty = true;
             win->dirty = true;
         }
         return;
@@ -803,6 +913,10 @@ static void terminal_handler(xgui_window_t* win, xgui_event_t* event) {
     uint8_t key = event->key.keycode;
     uint8_t mods = event->key.modifiers;
 
+    /* Every key below either edits the input line or forces a full
+     * repaint anyway, so mark the input row once here */
+    term_input_dirty = true;
+
     /* Ctrl shortcuts: keycode 1-26 means Ctrl was held (control chars).
      * For terminal, Ctrl+Shift+C/V = copy/paste (check Shift in mods).
      * Ctrl+C without Shift is just swallowed (SIGINT handled by keyboard driver).
@@ -944,8 +1058,19 @@ void xgui_terminal_create(void) {
         return;
     }
 
+    /* Allocate the scrollback ring on first use */
+    if (!term_ring) {
+        term_ring = (char*)kmalloc(TERM_MAX_LINES * TERM_LINE_SIZE);
+        if (!term_ring) return;
+    }
+
     /* Reset state */
+    term_line_start = 0;
     term_line_count = 0;
+    term_total_lines = 0;
+    term_full_damage = true;
+    term_last_cw = -1;
+    term_last_ch = -1;
     term_input[0] = '\0';
     term_input_len = 0;
     term_cursor = 0;
@@ -960,7 +1085,8 @@ void xgui_terminal_create(void) {
 
     /* Create window */
     terminal_window = xgui_window_create("Terminal", 40, 25, 530, 380,
-                                         XGUI_WINDOW_DEFAULT | XGUI_WINDOW_MAXIMIZABLE);
+                                         XGUI_WINDOW_DEFAULT | XGUI_WINDOW_MAXIMIZABLE |
+                                         XGUI_WINDOW_NOCLEAR);
     if (!terminal_window) return;
 
     terminal_window->bg_color = TERM_BG;
@@ -2,47 +2,153 @@
  * MiniOS XGUI Clipboard
  *
  * Global text clipboard for cut/copy/paste across GUI apps.
+ *
+ * Storage is size-tiered: small snippets (the common case) live in a
+ * fixed inline buffer, larger texts go to one heap allocation. Reads
+ * are always zero-copy -- xgui_clipboard_get() hands out the storage
+ * pointer and apps paste straight from it. For zero-copy writes, apps
+ * build text in place via reserve/commit instead of staging it in a
+ * buffer of their own and copying it in with xgui_clipboard_set().
  */
 
 #include "xgui/clipboard.h"
 #include "string.h"
+#include "heap.h"
 
-/* Clipboard buffer */
-static char clipboard_buf[XGUI_CLIPBOARD_MAX];
+/* Inline tier for small snippets; larger texts are heap-allocated */
+static char clipboard_inline[XGUI_CLIPBOARD_INLINE];
+static char* clipboard_heap = NULL;     /* Heap tier (NULL when unused) */
+static int clipboard_heap_cap = 0;      /* Usable bytes in heap tier */
+static char* clipboard_ptr = clipboard_inline;  /* Active storage */
 static int clipboard_len = 0;
 
+/*
+ * Release the heap tier and fall back to the inline buffer
+ */
+static void clipboard_drop_heap(void) {
+    if (clipboard_heap) {
+        kfree(clipboard_heap);
+        clipboard_heap = NULL;
+        clipboard_heap_cap = 0;
+    }
+    clipboard_ptr = clipboard_inline;
+}
+
 /*
  * Initialize the clipboard
  */
 void xgui_clipboard_init(void) {
-    clipboard_buf[0] = '\0';
+    clipboard_heap = NULL;
+    clipboard_heap_cap = 0;
+    clipboard_ptr = clipboard_inline;
+    clipboard_inline[0] = '\0';
     clipboard_len = 0;
 }
 
+/*
+ * Pick storage that can hold length chars plus the terminator:
+ * the inline buffer when it fits, one heap allocation otherwise.
+ * Returns NULL if a needed heap allocation fails.
+ */
+static char* clipboard_storage_for(int length) {
+    if (length < XGUI_CLIPBOARD_INLINE) {
+        clipboard_drop_heap();
+        return clipboard_inline;
+    }
+    /* Reuse the existing heap block when it is big enough */
+    if (clipboard_heap && clipboard_heap_cap >= length + 1) {
+        clipboard_ptr = clipboard_heap;
+        return clipboard_heap;
+    }
+    clipboard_drop_heap();
+    clipboard_heap = (char*)kmalloc(length + 1);
+    if (!clipboard_heap) {
+        return NULL;
+    }
+    clipboard_heap_cap = length + 1;
+    clipboard_ptr = clipboard_heap;
+    return clipboard_heap;
+}
+
 /*
  * Copy text to clipboard (replaces current contents)
  */
 void xgui_clipboard_set(const char* text, int length) {
     if (!text || length <= 0) {
-        clipboard_buf[0] = '\0';
-        clipboard_len = 0;
+        xgui_clipboard_clear();
         return;
     }
     if (length >= XGUI_CLIPBOARD_MAX) {
         length = XGUI_CLIPBOARD_MAX - 1;
     }
-    memcpy(clipboard_buf, text, length);
-    clipboard_buf[length] = '\0';
+    char* dst = clipboard_storage_for(length);
+    if (!dst) {
+        xgui_clipboard_clear();
+        return;
+    }
+    memcpy(dst, text, length);
+    dst[length] = '\0';
+    clipboard_len = length;
+}
+
+/*
+ * Reserve writable clipboard storage for up to max_length chars.
+ * The caller fills it in place and finishes with xgui_clipboard_commit();
+ * this avoids staging the text in an app-side buffer and copying it.
+ * Returns NULL if the reservation cannot be satisfied.
+ */
+char* xgui_clipboard_reserve(int max_length) {
+    if (max_length <= 0) {
+        return NULL;
+    }
+    if (max_length >= XGUI_CLIPBOARD_MAX) {
+        max_length = XGUI_CLIPBOARD_MAX - 1;
+    }
+    char* dst = clipboard_storage_for(max_length);
+    if (!dst) {
+        return NULL;
+    }
+    /* Until commit, the clipboard reads as empty */
+    dst[0] = '\0';
+    clipboard_len = 0;
+    return dst;
+}
+
+/*
+ * Commit length chars written into the buffer from xgui_clipboard_reserve()
+ */
+void xgui_clipboard_commit(int length) {
+    if (length < 0) length = 0;
+    if (length >= XGUI_CLIPBOARD_MAX) length = XGUI_CLIPBOARD_MAX - 1;
+    clipboard_ptr[length] = '\0';
+    clipboard_len = length;
+}
+
+/*
+ * Hand a kmalloc'd, NUL-terminated buffer to the clipboard without
+ * copying; the clipboard owns (and eventually kfrees) it afterwards
+ */
+void xgui_clipboard_adopt(char* text, int length) {
+    if (!text || length <= 0) {
+        if (text) kfree(text);
+        xgui_clipboard_clear();
+        return;
+    }
+    clipboard_drop_heap();
+    clipboard_heap = text;
+    clipboard_heap_cap = length + 1;
+    clipboard_ptr = text;
+    text[length] = '\0';
     clipboard_len = length;
 }
 
 /*
- * Get clipboard text. Returns pointer to internal buffer.
+ * Get clipboard text. Returns pointer to internal storage.
  * Returns NULL if clipboard is empty.
  */
 const char* xgui_clipboard_get(void) {
     if (clipboard_len == 0) return NULL;
-    return clipboard_buf;
+    return clipboard_ptr;
 }
 
 /*
@@ -56,7 +162,8 @@ int xgui_clipboard_length(void) {
  * Clear the clipboard
  */
 void xgui_clipboard_clear(void) {
-    clipboard_buf[0] = '\0';
+    clipboard_drop_heap();
+    clipboard_inline[0] = '\0';
     clipboard_len = 0;
 }
 
@@ -9,8 +9,8 @@
 #include "xgui/wm.h"
 #include "xgui/event.h"
 #include "xgui/theme.h"
+#include "xgui/font.h"
 #include "xgui/xgui.h"
-#include "timer.h"
 #include "string.h"
 #include "serial.h"
 #include "rtc.h"
@@ -32,6 +32,21 @@ static int wallpaper_w = 0;
 static int wallpaper_h = 0;
 static wp_mode_t wallpaper_mode = WP_MODE_CENTER;
 
+/* Pre-composed desktop backgrounds, one per display size seen. The
+ * scaled/letterboxed result is rendered once per size, so exposure
+ * redraws are a straight blit instead of per-pixel resampling. A mode
+ * change via xgui_display_reinit() just fills another slot, keeping
+ * the old size warm in case the user switches back. */
+#define WP_CACHE_SIZE 3
+typedef struct {
+    uint32_t* pixels;   /* w x desk_h, XGUI_RGB format */
+    int w;
+    int desk_h;
+    uint32_t stamp;     /* LRU: last lookup */
+} wp_cache_t;
+static wp_cache_t wp_cache[WP_CACHE_SIZE];
+static uint32_t wp_cache_stamp = 0;
+
 /* Panel state */
 static int panel_y = 0;
 
@@ -67,8 +82,20 @@ typedef struct {
 static desktop_icon_t dicons[DICON_MAX];
 static int dicon_count = 0;
 static int dicon_selected = -1;         /* Currently selected icon index */
-static uint32_t dicon_last_click_tick = 0;
-static int dicon_last_click_idx = -1;
+
+/* Spatial hit-test grid: icons sit on fixed grid cells, so mapping a
+ * point to its cell and looking the cell up here makes hit testing
+ * O(1) regardless of icon count. Rebuilt whenever positions change. */
+#define DICON_GRID_COLS 32
+#define DICON_GRID_ROWS 24
+static int8_t dicon_cell[DICON_GRID_COLS][DICON_GRID_ROWS];
+
+/* Pre-rendered icon bitmaps: graphic + shadowed label composited once
+ * into a kmalloc'd DICON_W x DICON_H ARGB patch (alpha 0 pixels are
+ * transparent to xgui_display_blit). Invalidated on add/remove, icon
+ * reload, and font change; repaints become a straight blit. */
+static uint32_t* dicon_bitmap[DICON_MAX];
+static bool dicon_bitmap_valid[DICON_MAX];
 
 /* Desktop icon drag state */
 static bool dicon_dragging = false;
@@ -152,13 +179,8 @@ static uint32_t darken(uint32_t c, int amount) {
     return XGUI_RGB(r, g, b);
 }
 
-static bool is_dark_color(uint32_t c) {
-    int lum = XGUI_GET_R(c) * 299 + XGUI_GET_G(c) * 587 + XGUI_GET_B(c) * 114;
-    return lum < 128000;
-}
-
 static uint32_t panel_text_color(void) {
-    return is_dark_color(xgui_theme_current()->panel_bg) ? XGUI_WHITE : XGUI_BLACK;
+    return xgui_theme_derived()->panel_text;
 }
 
 /*
@@ -226,6 +248,38 @@ static void dicon_get_rect(int idx, int* x, int* y, int* w, int* h) {
     *h = DICON_H;
 }
 
+/* Rebuild the cell -> icon map after any position change */
+static void dicon_grid_rebuild(void) {
+    memset(dicon_cell, -1, sizeof(dicon_cell));
+    for (int i = 0; i < DICON_MAX; i++) {
+        if (!dicons[i].used) continue;
+        int c = dicons[i].grid_col;
+        int r = dicons[i].grid_row;
+        if (c >= 0 && c < DICON_GRID_COLS && r >= 0 && r < DICON_GRID_ROWS) {
+            dicon_cell[c][r] = (int8_t)i;
+        }
+    }
+}
+
+/* O(1) point -> icon lookup via the grid (-1 if no icon is hit) */
+static int dicon_at(int x, int y) {
+    int rel_x = x - DICON_PAD_X;
+    int rel_y = y - DICON_PAD_Y;
+    if (rel_x < 0 || rel_y < 0) return -1;
+
+    int col = rel_x / (DICON_W + DICON_PAD_X);
+    int row = rel_y / (DICON_H + DICON_PAD_Y);
+    if (col >= DICON_GRID_COLS || row >= DICON_GRID_ROWS) return -1;
+
+    /* Reject the padding gap between cells */
+    if (rel_x - col * (DICON_W + DICON_PAD_X) >= DICON_W) return -1;
+    if (rel_y - row * (DICON_H + DICON_PAD_Y) >= DICON_H) return -1;
+
+    int idx = dicon_cell[col][row];
+    if (idx < 0 || !dicons[idx].used) return -1;
+    return idx;
+}
+
 /* Save desktop icons to /mnt/conf/desktop.conf */
 static void dicon_save(void) {
     conf_section_t sec;
@@ -328,6 +382,8 @@ bool xgui_desktop_add_icon(int type, const char* name, const char* path) {
     dicons[slot].path[127] = '\0';
     dicon_next_free_pos(&dicons[slot].grid_col, &dicons[slot].grid_row);
     dicon_count++;
+    dicon_bitmap_valid[slot] = false;
+    dicon_grid_rebuild();
     dicon_save();
     return true;
 }
@@ -339,6 +395,8 @@ static void dicon_remove(int idx) {
     memset(&dicons[idx], 0, sizeof(desktop_icon_t));
     dicon_count--;
     if (dicon_count < 0) dicon_count = 0;
+    dicon_bitmap_valid[idx] = false;
+    dicon_grid_rebuild();
     dicon_save();
 }
 
@@ -385,31 +443,121 @@ static void dicon_launch(int idx) {
     }
 }
 
+/* Buffer-targeted drawing primitives for the icon bitmap cache */
+static void dbuf_rect_filled(uint32_t* buf, int x, int y, int w, int h, uint32_t color) {
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > DICON_W) w = DICON_W - x;
+    if (y + h > DICON_H) h = DICON_H - y;
+    for (int row = 0; row < h; row++) {
+        uint32_t* dst = &buf[(y + row) * DICON_W + x];
+        for (int col = 0; col < w; col++) dst[col] = color;
+    }
+}
+
+static void dbuf_hline(uint32_t* buf, int x, int y, int length, uint32_t color) {
+    dbuf_rect_filled(buf, x, y, length, 1, color);
+}
+
+static void dbuf_rect(uint32_t* buf, int x, int y, int w, int h, uint32_t color) {
+    dbuf_rect_filled(buf, x, y, w, 1, color);
+    dbuf_rect_filled(buf, x, y + h - 1, w, 1, color);
+    dbuf_rect_filled(buf, x, y, 1, h, color);
+    dbuf_rect_filled(buf, x + w - 1, y, 1, h, color);
+}
+
+static void dbuf_text(uint32_t* buf, int x, int y, const char* str, uint32_t color) {
+    for (; *str; str++, x += XGUI_FONT_WIDTH) {
+        const uint8_t* glyph = xgui_font_get_glyph(*str);
+        if (!glyph) continue;
+        for (int row = 0; row < XGUI_FONT_HEIGHT; row++) {
+            int py = y + row;
+            if (py < 0 || py >= DICON_H) continue;
+            uint8_t bits = glyph[row];
+            for (int col = 0; col < XGUI_FONT_WIDTH; col++) {
+                if (!(bits & (0x80 >> col))) continue;
+                int px = x + col;
+                if (px >= 0 && px < DICON_W) {
+                    buf[py * DICON_W + px] = color;
+                }
+            }
+        }
+    }
+}
+
 /* Draw a small app icon (generic) */
-static void dicon_draw_app_icon(int cx, int cy) {
+static void dicon_draw_app_icon(uint32_t* buf, int cx, int cy) {
     /* Simple colored square with window-like appearance */
-    xgui_display_rect_filled(cx, cy, DICON_ICON_SZ, DICON_ICON_SZ, XGUI_RGB(60, 120, 200));
-    xgui_display_rect_filled(cx + 1, cy + 1, DICON_ICON_SZ - 2, 5, XGUI_RGB(40, 80, 160));
-    xgui_display_rect_filled(cx + 2, cy + 7, DICON_ICON_SZ - 4, DICON_ICON_SZ - 9, XGUI_WHITE);
-    xgui_display_rect(cx, cy, DICON_ICON_SZ, DICON_ICON_SZ, XGUI_RGB(30, 60, 120));
+    dbuf_rect_filled(buf, cx, cy, DICON_ICON_SZ, DICON_ICON_SZ, XGUI_RGB(60, 120, 200));
+    dbuf_rect_filled(buf, cx + 1, cy + 1, DICON_ICON_SZ - 2, 5, XGUI_RGB(40, 80, 160));
+    dbuf_rect_filled(buf, cx + 2, cy + 7, DICON_ICON_SZ - 4, DICON_ICON_SZ - 9, XGUI_WHITE);
+    dbuf_rect(buf, cx, cy, DICON_ICON_SZ, DICON_ICON_SZ, XGUI_RGB(30, 60, 120));
 }
 
 /* Draw a small folder icon */
-static void dicon_draw_folder_icon(int cx, int cy) {
-    xgui_display_rect_filled(cx, cy + 2, 8, 4, XGUI_RGB(220, 180, 60));
-    xgui_display_rect_filled(cx, cy + 4, DICON_ICON_SZ, DICON_ICON_SZ - 4, XGUI_RGB(240, 200, 80));
-    xgui_display_hline(cx + 1, cy + 5, DICON_ICON_SZ - 2, XGUI_RGB(255, 230, 140));
-    xgui_display_rect(cx, cy + 4, DICON_ICON_SZ, DICON_ICON_SZ - 4, XGUI_RGB(180, 140, 40));
+static void dicon_draw_folder_icon(uint32_t* buf, int cx, int cy) {
+    dbuf_rect_filled(buf, cx, cy + 2, 8, 4, XGUI_RGB(220, 180, 60));
+    dbuf_rect_filled(buf, cx, cy + 4, DICON_ICON_SZ, DICON_ICON_SZ - 4, XGUI_RGB(240, 200, 80));
+    dbuf_hline(buf, cx + 1, cy + 5, DICON_ICON_SZ - 2, XGUI_RGB(255, 230, 140));
+    dbuf_rect(buf, cx, cy + 4, DICON_ICON_SZ, DICON_ICON_SZ - 4, XGUI_RGB(180, 140, 40));
 }
 
 /* Draw a small file icon */
-static void dicon_draw_file_icon(int cx, int cy) {
-    xgui_display_rect_filled(cx + 2, cy, DICON_ICON_SZ - 4, DICON_ICON_SZ, XGUI_WHITE);
-    xgui_display_rect(cx + 2, cy, DICON_ICON_SZ - 4, DICON_ICON_SZ, XGUI_RGB(140, 140, 140));
-    xgui_display_rect_filled(cx + DICON_ICON_SZ - 6, cy, 4, 4, XGUI_RGB(200, 200, 200));
-    xgui_display_hline(cx + 5, cy + 6, DICON_ICON_SZ - 10, XGUI_RGB(180, 200, 220));
-    xgui_display_hline(cx + 5, cy + 9, DICON_ICON_SZ - 10, XGUI_RGB(180, 200, 220));
-    xgui_display_hline(cx + 5, cy + 12, DICON_ICON_SZ - 12, XGUI_RGB(180, 200, 220));
+static void dicon_draw_file_icon(uint32_t* buf, int cx, int cy) {
+    dbuf_rect_filled(buf, cx + 2, cy, DICON_ICON_SZ - 4, DICON_ICON_SZ, XGUI_WHITE);
+    dbuf_rect(buf, cx + 2, cy, DICON_ICON_SZ - 4, DICON_ICON_SZ, XGUI_RGB(140, 140, 140));
+    dbuf_rect_filled(buf, cx + DICON_ICON_SZ - 6, cy, 4, 4, XGUI_RGB(200, 200, 200));
+    dbuf_hline(buf, cx + 5, cy + 6, DICON_ICON_SZ - 10, XGUI_RGB(180, 200, 220));
+    dbuf_hline(buf, cx + 5, cy + 9, DICON_ICON_SZ - 10, XGUI_RGB(180, 200, 220));
+    dbuf_hline(buf, cx + 5, cy + 12, DICON_ICON_SZ - 12, XGUI_RGB(180, 200, 220));
+}
+
+/*
+ * Compose an icon's bitmap: graphic plus shadowed label on a
+ * transparent background. Includes the per-icon vfs_lookup that used
+ * to run on every repaint, so it only happens on invalidation now.
+ */
+static void dicon_render(int i) {
+    if (dicon_bitmap[i] == NULL) {
+        dicon_bitmap[i] = (uint32_t*)kmalloc(DICON_W * DICON_H * sizeof(uint32_t));
+        if (dicon_bitmap[i] == NULL) return;
+    }
+    uint32_t* buf = dicon_bitmap[i];
+    memset(buf, 0, DICON_W * DICON_H * sizeof(uint32_t));
+
+    /* Icon graphic centered horizontally */
+    int icon_x = (DICON_W - DICON_ICON_SZ) / 2;
+    int icon_y = 2;
+
+    if (dicons[i].type == DICON_TYPE_APP) {
+        dicon_draw_app_icon(buf, icon_x, icon_y);
+    } else {
+        vfs_node_t* node = vfs_lookup(dicons[i].path);
+        if (node && (node->flags & VFS_DIRECTORY)) {
+            dicon_draw_folder_icon(buf, icon_x, icon_y);
+        } else {
+            dicon_draw_file_icon(buf, icon_x, icon_y);
+        }
+    }
+
+    /* Label centered below icon, shadow first for readability */
+    int tw = xgui_display_text_width(dicons[i].name);
+    int tx = (DICON_W - tw) / 2;
+    int ty = DICON_ICON_SZ + 6;
+    if (tx < 0) tx = 0;
+
+    dbuf_text(buf, tx + 1, ty + 1, dicons[i].name, XGUI_RGB(0, 0, 0));
+    dbuf_text(buf, tx, ty, dicons[i].name, XGUI_WHITE);
+}
+
+/*
+ * Drop every cached icon bitmap (font change etc.); they re-render
+ * lazily on the next repaint
+ */
+void xgui_desktop_invalidate_icons(void) {
+    for (int i = 0; i < DICON_MAX; i++) {
+        dicon_bitmap_valid[i] = false;
+    }
 }
 
 /* Draw all desktop icons (called before wm_composite so windows appear on top) */
@@ -426,36 +574,19 @@ void xgui_desktop_draw_icons(void) {
             iy = dicon_drag_py;
         }
 
-        /* Selection highlight */
+        /* Selection highlight (the bitmap is transparent around the
+         * graphic and label, so the highlight shows through) */
         if (i == dicon_selected) {
             xgui_display_rect_filled(ix, iy, iw, ih, XGUI_RGB(60, 100, 180));
         }
 
-        /* Icon graphic centered horizontally */
-        int icon_x = ix + (iw - DICON_ICON_SZ) / 2;
-        int icon_y = iy + 2;
-
-        if (dicons[i].type == DICON_TYPE_APP) {
-            dicon_draw_app_icon(icon_x, icon_y);
-        } else {
-            vfs_node_t* node = vfs_lookup(dicons[i].path);
-            if (node && (node->flags & VFS_DIRECTORY)) {
-                dicon_draw_folder_icon(icon_x, icon_y);
-            } else {
-                dicon_draw_file_icon(icon_x, icon_y);
-            }
+        if (!dicon_bitmap_valid[i]) {
+            dicon_render(i);
+            dicon_bitmap_valid[i] = (dicon_bitmap[i] != NULL);
+        }
+        if (dicon_bitmap[i] != NULL) {
+            xgui_display_blit(ix, iy, DICON_W, DICON_H, dicon_bitmap[i]);
         }
-
-        /* Label centered below icon */
-        int tw = xgui_display_text_width(dicons[i].name);
-        int tx = ix + (iw - tw) / 2;
-        int ty = iy + DICON_ICON_SZ + 6;
-        if (tx < ix) tx = ix;
-
-        /* Text shadow for readability */
-        xgui_display_text_transparent(tx + 1, ty + 1, dicons[i].name, XGUI_RGB(0, 0, 0));
-        uint32_t text_col = (i == dicon_selected) ? XGUI_WHITE : XGUI_RGB(255, 255, 255);
-        xgui_display_text_transparent(tx, ty, dicons[i].name, text_col);
     }
 }
 
@@ -506,6 +637,8 @@ void xgui_desktop_init(void) {
     memset(dicons, 0, sizeof(dicons));
     dicon_count = 0;
     dicon_load();
+    dicon_grid_rebuild();
+    xgui_desktop_invalidate_icons();
 }
 
 /*
@@ -525,6 +658,129 @@ static inline uint32_t wp_sample(int sx_fp, int sy_fp) {
     return wallpaper_pixels[sy * wallpaper_w + sx];
 }
 
+/*
+ * Render the wallpaper scaled for the given desktop size into dst
+ * (w x desk_h pixels), applying the current mode and letterbox color.
+ * Runs once per display size; redraws reuse the result.
+ */
+static void wp_compose(uint32_t* dst, int w, int desk_h) {
+    if (wallpaper_mode == WP_MODE_FILL) {
+        /* Stretch to fill entire desktop (ignores aspect ratio) */
+        int sx_step = (wallpaper_w << 16) / w;
+        int sy_step = (wallpaper_h << 16) / desk_h;
+        for (int dy = 0; dy < desk_h; dy++) {
+            int sy_fp = dy * sy_step;
+            uint32_t* out = &dst[dy * w];
+            for (int dx = 0; dx < w; dx++) {
+                out[dx] = wp_sample(dx * sx_step, sy_fp);
+            }
+        }
+        return;
+    }
+
+    /* FIT and CENTER letterbox with the background color */
+    for (int i = 0; i < w * desk_h; i++) {
+        dst[i] = desktop_color;
+    }
+
+    if (wallpaper_mode == WP_MODE_FIT) {
+        /* Scale to fit preserving aspect ratio */
+        int scale_w, scale_h;
+        /* Compare aspect ratios: img_w/img_h vs w/desk_h */
+        if (wallpaper_w * desk_h > wallpaper_h * w) {
+            /* Image is wider — fit to width */
+            scale_w = w;
+            scale_h = (wallpaper_h * w) / wallpaper_w;
+        } else {
+            /* Image is taller — fit to height */
+            scale_h = desk_h;
+            scale_w = (wallpaper_w * desk_h) / wallpaper_h;
+        }
+        int ox = (w - scale_w) / 2;
+        int oy = (desk_h - scale_h) / 2;
+        int sx_step = (wallpaper_w << 16) / scale_w;
+        int sy_step = (wallpaper_h << 16) / scale_h;
+        for (int dy = 0; dy < scale_h; dy++) {
+            int sy_fp = dy * sy_step;
+            uint32_t* out = &dst[(oy + dy) * w + ox];
+            for (int dx = 0; dx < scale_w; dx++) {
+                out[dx] = wp_sample(dx * sx_step, sy_fp);
+            }
+        }
+    } else {
+        /* WP_MODE_CENTER — original size, centered */
+        int ox = (w - wallpaper_w) / 2;
+        int oy = (desk_h - wallpaper_h) / 2;
+        if (ox < 0) ox = 0;
+        if (oy < 0) oy = 0;
+        int blit_w = wallpaper_w < w ? wallpaper_w : w;
+        int blit_h = wallpaper_h < desk_h ? wallpaper_h : desk_h;
+        int src_x = (wallpaper_w > w) ? (wallpaper_w - w) / 2 : 0;
+        for (int row = 0; row < blit_h; row++) {
+            int src_row = (wallpaper_h > desk_h) ? row + (wallpaper_h - desk_h) / 2 : row;
+            if (src_row < 0 || src_row >= wallpaper_h) continue;
+            int dst_y = oy + row;
+            if (dst_y >= desk_h) break;
+            memcpy(&dst[dst_y * w + ox],
+                   &wallpaper_pixels[src_row * wallpaper_w + src_x],
+                   blit_w * sizeof(uint32_t));
+        }
+    }
+}
+
+/*
+ * Drop all pre-composed backgrounds (wallpaper, mode or color changed)
+ */
+static void wp_cache_drop(void) {
+    for (int i = 0; i < WP_CACHE_SIZE; i++) {
+        if (wp_cache[i].pixels) {
+            kfree(wp_cache[i].pixels);
+        }
+        wp_cache[i].pixels = NULL;
+        wp_cache[i].w = 0;
+        wp_cache[i].desk_h = 0;
+        wp_cache[i].stamp = 0;
+    }
+}
+
+/*
+ * Find or build the composed background for the given desktop size.
+ * Returns NULL when the compose buffer cannot be allocated.
+ */
+static uint32_t* wp_cache_get(int w, int desk_h) {
+    for (int i = 0; i < WP_CACHE_SIZE; i++) {
+        if (wp_cache[i].pixels && wp_cache[i].w == w &&
+            wp_cache[i].desk_h == desk_h) {
+            wp_cache[i].stamp = ++wp_cache_stamp;
+            return wp_cache[i].pixels;
+        }
+    }
+
+    /* Miss: take a free slot, else evict the least recently used */
+    wp_cache_t* slot = &wp_cache[0];
+    for (int i = 1; i < WP_CACHE_SIZE && slot->pixels != NULL; i++) {
+        if (wp_cache[i].pixels == NULL || wp_cache[i].stamp < slot->stamp) {
+            slot = &wp_cache[i];
+        }
+    }
+
+    uint32_t* pixels = (uint32_t*)kmalloc(w * desk_h * sizeof(uint32_t));
+    if (!pixels) {
+        serial_write_string("DESKTOP: wallpaper compose alloc failed\n");
+        return NULL;
+    }
+    wp_compose(pixels, w, desk_h);
+
+    if (slot->pixels) {
+        kfree(slot->pixels);
+    }
+    slot->pixels = pixels;
+    slot->w = w;
+    slot->desk_h = desk_h;
+    slot->stamp = ++wp_cache_stamp;
+    return pixels;
+}
+
 void xgui_desktop_draw(void) {
     /* Use live display dimensions in case init order was wrong */
     int w = xgui_display_width();
@@ -536,72 +792,28 @@ void xgui_desktop_draw(void) {
     int desk_h = h - XGUI_PANEL_HEIGHT;
 
     if (wallpaper_pixels && wallpaper_w > 0 && wallpaper_h > 0) {
-        if (wallpaper_mode == WP_MODE_FILL) {
-            /* Stretch to fill entire desktop (ignores aspect ratio) */
-            int sx_step = (wallpaper_w << 16) / w;
-            int sy_step = (wallpaper_h << 16) / desk_h;
-            for (int dy = 0; dy < desk_h; dy++) {
-                int sy_fp = dy * sy_step;
-                for (int dx = 0; dx < w; dx++) {
-                    xgui_display_pixel(dx, dy, wp_sample(dx * sx_step, sy_fp));
-                }
-            }
-        } else if (wallpaper_mode == WP_MODE_FIT) {
-            /* Scale to fit preserving aspect ratio, letterbox with bg color */
-            xgui_display_rect_filled(0, 0, w, desk_h, desktop_color);
-            int scale_w, scale_h;
-            /* Compare aspect ratios: img_w/img_h vs w/desk_h */
-            if (wallpaper_w * desk_h > wallpaper_h * w) {
-                /* Image is wider — fit to width */
-                scale_w = w;
-                scale_h = (wallpaper_h * w) / wallpaper_w;
-            } else {
-                /* Image is taller — fit to height */
-                scale_h = desk_h;
-                scale_w = (wallpaper_w * desk_h) / wallpaper_h;
-            }
-            int ox = (w - scale_w) / 2;
-            int oy = (desk_h - scale_h) / 2;
-            int sx_step = (wallpaper_w << 16) / scale_w;
-            int sy_step = (wallpaper_h << 16) / scale_h;
-            for (int dy = 0; dy < scale_h; dy++) {
-                int sy_fp = dy * sy_step;
-                for (int dx = 0; dx < scale_w; dx++) {
-                    xgui_display_pixel(ox + dx, oy + dy, wp_sample(dx * sx_step, sy_fp));
-                }
-            }
-        } else {
-            /* WP_MODE_CENTER — original size, centered */
-            xgui_display_rect_filled(0, 0, w, desk_h, desktop_color);
-            int ox = (w - wallpaper_w) / 2;
-            int oy = (desk_h - wallpaper_h) / 2;
-            if (ox < 0) ox = 0;
-            if (oy < 0) oy = 0;
-            int blit_w = wallpaper_w < w ? wallpaper_w : w;
-            int blit_h = wallpaper_h < desk_h ? wallpaper_h : desk_h;
-            for (int row = 0; row < blit_h; row++) {
-                int src_row = (wallpaper_h > desk_h) ? row + (wallpaper_h - desk_h) / 2 : row;
-                if (src_row < 0 || src_row >= wallpaper_h) continue;
-                int dst_y = oy + row;
-                if (dst_y >= desk_h) break;
-                uint32_t* src = &wallpaper_pixels[src_row * wallpaper_w];
-                int src_x = (wallpaper_w > w) ? (wallpaper_w - w) / 2 : 0;
-                for (int col = 0; col < blit_w; col++) {
-                    xgui_display_pixel(ox + col, dst_y, src[src_x + col]);
-                }
-            }
+        /* Exposure is a straight blit of the pre-composed background */
+        uint32_t* bg = wp_cache_get(w, desk_h);
+        if (bg) {
+            xgui_display_blit(0, 0, w, desk_h, bg);
+            return;
         }
-    } else {
-        /* Solid color fill */
-        xgui_display_rect_filled(0, 0, w, desk_h, desktop_color);
+        /* Compose failed (out of heap): fall through to solid color */
     }
+
+    /* Solid color fill */
+    xgui_display_rect_filled(0, 0, w, desk_h, desktop_color);
 }
 
 /*
  * Set desktop wallpaper color (does NOT clear BMP wallpaper)
  */
 void xgui_desktop_set_color(uint32_t color) {
-    desktop_color = color;
+    if (desktop_color != color) {
+        desktop_color = color;
+        /* Letterbox bars bake the color into composed backgrounds */
+        wp_cache_drop();
+    }
 }
 
 /*
@@ -613,6 +825,7 @@ void xgui_desktop_clear_wallpaper(void) {
         wallpaper_pixels = NULL;
         wallpaper_w = 0;
         wallpaper_h = 0;
+        wp_cache_drop();
     }
 }
 
@@ -751,13 +964,17 @@ int xgui_desktop_set_wallpaper(const char* path) {
     wallpaper_pixels = pixels;
     wallpaper_w = bmp_w;
     wallpaper_h = bmp_h;
+    wp_cache_drop();
 
     serial_write_string("WALLPAPER: loaded OK\n");
     return 0;
 }
 
 void xgui_desktop_set_wp_mode(wp_mode_t mode) {
-    if (mode < WP_MODE_COUNT) wallpaper_mode = mode;
+    if (mode < WP_MODE_COUNT && mode != wallpaper_mode) {
+        wallpaper_mode = mode;
+        wp_cache_drop();
+    }
 }
 
 wp_mode_t xgui_desktop_get_wp_mode(void) {
@@ -777,42 +994,20 @@ void xgui_panel_init(void) {
 }
 
 /*
- * Draw a 3D gradient-filled rectangle (glossy button look)
- * Top half: bright highlight fading to base color
- * Bottom half: base color fading to darker shade
+ * Draw a 3D gradient-filled rectangle (glossy button look) from a
+ * row table precomputed by xgui_theme_rebuild_derived()
  */
-static void draw_gradient_button(int x, int y, int w, int h, uint32_t base, bool pressed) {
-    uint32_t top_color, mid_color, bot_color;
-    if (pressed) {
-        top_color = darken(base, 20);
-        mid_color = darken(base, 10);
-        bot_color = darken(base, 30);
-    } else {
-        top_color = lighten(base, 50);
-        mid_color = base;
-        bot_color = darken(base, 35);
-    }
-    
-    int mid = h / 2;
-    /* Top half: highlight to base */
-    for (int row = 0; row < mid; row++) {
-        int t = (row * 255) / mid;
-        uint32_t c = blend_color(top_color, mid_color, t);
-        xgui_display_hline(x + 1, y + row, w - 2, c);
-    }
-    /* Bottom half: base to dark */
-    for (int row = mid; row < h; row++) {
-        int t = ((row - mid) * 255) / (h - mid);
-        uint32_t c = blend_color(mid_color, bot_color, t);
-        xgui_display_hline(x + 1, y + row, w - 2, c);
+static void draw_gradient_button(int x, int y, int w, int h, const xgui_btn_grad_t* g) {
+    if (h > XGUI_THEME_GRAD_MAX) h = XGUI_THEME_GRAD_MAX;
+    for (int row = 0; row < h; row++) {
+        xgui_display_hline(x + 1, y + row, w - 2, g->rows[row]);
     }
-    
+
     /* 1px border for definition */
-    uint32_t border_col = darken(base, 50);
-    xgui_display_hline(x + 1, y, w - 2, pressed ? border_col : lighten(base, 70)); /* top */
-    xgui_display_hline(x + 1, y + h - 1, w - 2, border_col);                       /* bottom */
-    xgui_display_vline(x, y + 1, h - 2, pressed ? border_col : lighten(base, 30));  /* left */
-    xgui_display_vline(x + w - 1, y + 1, h - 2, border_col);                        /* right */
+    xgui_display_hline(x + 1, y, w - 2, g->edge_top);           /* top */
+    xgui_display_hline(x + 1, y + h - 1, w - 2, g->border);     /* bottom */
+    xgui_display_vline(x, y + 1, h - 2, g->edge_left);          /* left */
+    xgui_display_vline(x + w - 1, y + 1, h - 2, g->border);     /* right */
 }
 
 /*
@@ -823,14 +1018,15 @@ static void draw_start_button(bool pressed) {
     int y = panel_y + 4;
     int w = 60;
     int h = XGUI_PANEL_HEIGHT - 8;
-    
-    uint32_t accent = xgui_theme_current()->selection;
-    draw_gradient_button(x, y, w, h, accent, pressed);
-    
+
+    const xgui_theme_derived_t* td = xgui_theme_derived();
+    draw_gradient_button(x, y, w, h,
+                         &td->btn[pressed ? XGUI_BTN_ACCENT_PRESSED : XGUI_BTN_ACCENT]);
+
     /* "Go" text, centered, auto-contrast */
-    uint32_t btn_text = is_dark_color(accent) ? XGUI_WHITE : XGUI_BLACK;
     int text_w = 2 * 8; /* "Go" = 2 chars * 8px */
-    xgui_display_text_transparent(x + (w - text_w) / 2, y + (h - 16) / 2, "Go", btn_text);
+    xgui_display_text_transparent(x + (w - text_w) / 2, y + (h - 16) / 2, "Go",
+                                  td->accent_text);
 }
 
 /*
@@ -839,25 +1035,21 @@ static void draw_start_button(bool pressed) {
 static void draw_task_button(xgui_window_t* win, int x, int y, int w, int h) {
     bool focused = (win->flags & XGUI_WINDOW_FOCUSED);
     bool minimized = (win->flags & XGUI_WINDOW_MINIMIZED);
-    uint32_t panel_bg = xgui_theme_current()->panel_bg;
-    uint32_t accent = xgui_theme_current()->selection;
-    
+    const xgui_theme_derived_t* td = xgui_theme_derived();
+
     if (focused) {
         /* Focused: full 3D gradient button */
-        uint32_t btn_base = lighten(panel_bg, is_dark_color(panel_bg) ? 30 : -15);
-        draw_gradient_button(x, y, w, h, btn_base, false);
+        draw_gradient_button(x, y, w, h, &td->btn[XGUI_BTN_TASK_FOCUSED]);
         /* Accent bar at bottom (inside border) */
-        xgui_display_rect_filled(x + 2, y + h - 4, w - 4, 3, accent);
+        xgui_display_rect_filled(x + 2, y + h - 4, w - 4, 3,
+                                 xgui_theme_current()->selection);
     } else if (minimized) {
         /* Minimized: very subtle, blends with panel */
-        uint32_t btn_base = panel_bg;
-        uint32_t border_col = is_dark_color(panel_bg) ? lighten(panel_bg, 20) : darken(panel_bg, 20);
-        xgui_display_rect_filled(x, y, w, h, btn_base);
-        xgui_display_rect(x, y, w, h, border_col);
+        xgui_display_rect_filled(x, y, w, h, xgui_theme_current()->panel_bg);
+        xgui_display_rect(x, y, w, h, td->task_min_border);
     } else {
         /* Non-focused, non-minimized: subtle 3D gradient */
-        uint32_t btn_base = lighten(panel_bg, is_dark_color(panel_bg) ? 15 : -8);
-        draw_gradient_button(x, y, w, h, btn_base, false);
+        draw_gradient_button(x, y, w, h, &td->btn[XGUI_BTN_TASK]);
     }
     
     /* Window title (truncated) */
@@ -872,8 +1064,8 @@ static void draw_task_button(xgui_window_t* win, int x, int y, int w, int h) {
         title[max_chars] = '\0';
     }
     
-    uint32_t text_col = panel_text_color();
-    if (minimized) text_col = blend_color(text_col, panel_bg, 100); /* Dimmed */
+    uint32_t text_col = minimized ? td->panel_text_dim /* Dimmed */
+                                  : td->panel_text;
     xgui_display_text_transparent(x + 6, y + (h - 16) / 2, title, text_col);
 }
 
@@ -921,9 +1113,8 @@ static void draw_clock(void) {
     int time_x = screen_width - time_w + 4;
     int text_y = panel_y + (XGUI_PANEL_HEIGHT - 16) / 2;
 
-    uint32_t panel_bg = xgui_theme_current()->panel_bg;
     uint32_t text_col = panel_text_color();
-    uint32_t sep_col = is_dark_color(panel_bg) ? lighten(panel_bg, 30) : darken(panel_bg, 30);
+    uint32_t sep_col = xgui_theme_derived()->panel_sep;
 
     /* Subtle left separator */
     xgui_display_vline(date_x - 2, panel_y + 6, XGUI_PANEL_HEIGHT - 12, sep_col);
@@ -939,18 +1130,16 @@ static void draw_clock(void) {
  * Draw the panel
  */
 void xgui_panel_draw(void) {
-    uint32_t panel_bg = xgui_theme_current()->panel_bg;
-    
-    /* Gradient panel background: lighter at top, darker at bottom */
-    for (int row = 0; row < XGUI_PANEL_HEIGHT; row++) {
-        int t = (row * 255) / XGUI_PANEL_HEIGHT;
-        uint32_t row_color = blend_color(lighten(panel_bg, 15), darken(panel_bg, 15), t);
-        xgui_display_hline(0, panel_y + row, screen_width, row_color);
+    const xgui_theme_derived_t* td = xgui_theme_derived();
+
+    /* Gradient panel background: lighter at top, darker at bottom
+     * (rows precomputed when the theme was applied) */
+    for (int row = 0; row < td->panel_rows; row++) {
+        xgui_display_hline(0, panel_y + row, screen_width, td->panel_grad[row]);
     }
-    
+
     /* Thin highlight line at top edge */
-    xgui_display_hline(0, panel_y, screen_width,
-                       is_dark_color(panel_bg) ? lighten(panel_bg, 40) : lighten(panel_bg, 30));
+    xgui_display_hline(0, panel_y, screen_width, td->panel_highlight);
     
     /* Subtle shadow above the panel (drawn into desktop area) */
     for (int s = 0; s < 4; s++) {
@@ -1014,11 +1203,9 @@ void xgui_panel_draw(void) {
     if (need_nav) {
         int nav_x = 68;
         int nav_y = task_y;
-        uint32_t nav_bg = lighten(panel_bg, is_dark_color(panel_bg) ? 20 : -10);
-        uint32_t nav_fg = panel_text_color();
         bool can_left = (panel_task_scroll > 0);
-        if (!can_left) nav_fg = blend_color(nav_fg, panel_bg, 150);
-        draw_gradient_button(nav_x, nav_y, PANEL_NAV_W, task_h, nav_bg, false);
+        uint32_t nav_fg = can_left ? td->panel_text : td->nav_text_dim;
+        draw_gradient_button(nav_x, nav_y, PANEL_NAV_W, task_h, &td->btn[XGUI_BTN_NAV]);
         /* Left triangle */
         for (int r = 0; r < 4; r++) {
             xgui_display_hline(nav_x + 9 - r, nav_y + task_h / 2 - 3 + r, 1 + r, nav_fg);
@@ -1039,11 +1226,9 @@ void xgui_panel_draw(void) {
     if (need_nav) {
         int nav_x = task_x + 2;
         int nav_y = task_y;
-        uint32_t nav_bg = lighten(panel_bg, is_dark_color(panel_bg) ? 20 : -10);
-        uint32_t nav_fg = panel_text_color();
         bool can_right = (panel_task_scroll + max_visible < total_tasks);
-        if (!can_right) nav_fg = blend_color(nav_fg, panel_bg, 150);
-        draw_gradient_button(nav_x, nav_y, PANEL_NAV_W, task_h, nav_bg, false);
+        uint32_t nav_fg = can_right ? td->panel_text : td->nav_text_dim;
+        draw_gradient_button(nav_x, nav_y, PANEL_NAV_W, task_h, &td->btn[XGUI_BTN_NAV]);
         /* Right triangle */
         for (int r = 0; r < 4; r++) {
             xgui_display_hline(nav_x + 6 + r, nav_y + task_h / 2 - 3 + r, 4 - r, nav_fg);
@@ -1079,14 +1264,15 @@ extern void xgui_quit(void);
 /*
  * Draw a hover-highlighted menu item row with gradient
  */
-static void draw_menu_highlight(int x, int y, int w, int h, uint32_t accent) {
+static void draw_menu_highlight(int x, int y, int w, int h) {
+    const xgui_theme_derived_t* td = xgui_theme_derived();
     for (int row = 0; row < h; row++) {
         int t = (row * 255) / h;
-        uint32_t c = blend_color(lighten(accent, 30), darken(accent, 5), t);
+        uint32_t c = blend_color(td->menu.hover_top, td->menu.hover_bot, t);
         xgui_display_hline(x, y + row, w, c);
     }
     /* Subtle top highlight */
-    xgui_display_hline(x, y, w, lighten(accent, 50));
+    xgui_display_hline(x, y, w, td->menu.hover_hi);
 }
 
 /*
@@ -1098,14 +1284,8 @@ void xgui_draw_start_menu(void) {
         return;
     }
 
-    uint32_t accent = xgui_theme_current()->selection;
-    uint32_t menu_bg = xgui_theme_current()->window_bg;
-    bool dark = is_dark_color(menu_bg);
+    const xgui_theme_derived_t* td = xgui_theme_derived();
     uint32_t hover_text = XGUI_WHITE;
-    uint32_t hover_bg = is_dark_color(accent) ? lighten(accent, 15) : accent;
-
-    /* Right column background: slightly tinted */
-    uint32_t right_bg = dark ? lighten(menu_bg, 12) : darken(menu_bg, 12);
 
     /* Compute body height: max of left/right item counts */
     int left_body = LEFT_COUNT * SMENU_ITEM_H;
@@ -1160,78 +1340,73 @@ void xgui_draw_start_menu(void) {
     /* --- Top banner: accent gradient with "MiniOS" --- */
     for (int row = 0; row < SMENU_BANNER_H; row++) {
         int t = (row * 255) / SMENU_BANNER_H;
-        uint32_t c = blend_color(lighten(accent, 25), darken(accent, 15), t);
+        uint32_t c = blend_color(td->menu.banner_top, td->menu.banner_bot, t);
         xgui_display_hline(menu_x + 1, menu_y + row, SMENU_W - 2, c);
     }
     /* Banner highlight */
-    xgui_display_hline(menu_x + 1, menu_y + 1, SMENU_W - 2, lighten(accent, 50));
+    xgui_display_hline(menu_x + 1, menu_y + 1, SMENU_W - 2, td->menu.banner_hi);
     /* Banner text */
-    uint32_t banner_text = is_dark_color(accent) ? XGUI_WHITE : XGUI_BLACK;
-    xgui_display_text_transparent(menu_x + 12, menu_y + 8, "MiniOS", banner_text);
+    xgui_display_text_transparent(menu_x + 12, menu_y + 8, "MiniOS", td->menu.banner_text);
 
     /* --- Left column: white/light background --- */
     for (int row = 0; row < body_h; row++) {
         int t = (row * 40) / body_h;
-        uint32_t c = dark ? blend_color(menu_bg, lighten(menu_bg, 8), t)
-                          : blend_color(XGUI_WHITE, XGUI_RGB(245, 245, 245), t);
+        uint32_t c = blend_color(td->menu.left_top, td->menu.left_bot, t);
         xgui_display_hline(menu_x + 1, body_top + row, SMENU_LEFT_W - 1, c);
     }
 
     /* --- Right column: tinted background --- */
     for (int row = 0; row < body_h; row++) {
         int t = (row * 40) / body_h;
-        uint32_t c = blend_color(right_bg, darken(right_bg, 5), t);
+        uint32_t c = blend_color(td->menu.right_top, td->menu.right_bot, t);
         xgui_display_hline(right_x0, body_top + row, SMENU_RIGHT_W - 1, c);
     }
 
     /* Vertical divider between columns (etched line) */
-    uint32_t div_dark = dark ? lighten(menu_bg, 20) : darken(menu_bg, 30);
-    uint32_t div_light = dark ? lighten(menu_bg, 40) : lighten(menu_bg, 10);
-    xgui_display_vline(right_x0 - 1, body_top + 4, body_h - 8, div_dark);
-    xgui_display_vline(right_x0, body_top + 4, body_h - 8, div_light);
+    xgui_display_vline(right_x0 - 1, body_top + 4, body_h - 8, td->menu.div_dark);
+    xgui_display_vline(right_x0, body_top + 4, body_h - 8, td->menu.div_light);
 
     /* --- Left column items --- */
-    uint32_t left_text = dark ? XGUI_WHITE : XGUI_RGB(20, 20, 20);
     for (int i = 0; i < LEFT_COUNT; i++) {
         int iy = body_top + SMENU_PAD + i * SMENU_ITEM_H;
         if (menu_hover_item == i) {
-            draw_menu_highlight(menu_x + 2, iy, SMENU_LEFT_W - 4, SMENU_ITEM_H, hover_bg);
+            draw_menu_highlight(menu_x + 2, iy, SMENU_LEFT_W - 4, SMENU_ITEM_H);
             xgui_display_text_transparent(menu_x + 12, iy + 4, left_labels[i], hover_text);
         } else {
-            xgui_display_text_transparent(menu_x + 12, iy + 4, left_labels[i], left_text);
+            xgui_display_text_transparent(menu_x + 12, iy + 4, left_labels[i],
+                                          td->menu.left_text);
         }
     }
 
     /* Separator line in left column after main apps (before games) */
     int sep_after = 8; /* After "Clock" (index 8), before "Ski Game" */
     int sep_ly = body_top + SMENU_PAD + sep_after * SMENU_ITEM_H - 1;
-    uint32_t lsep = dark ? lighten(menu_bg, 20) : XGUI_RGB(210, 210, 210);
-    xgui_display_hline(menu_x + 10, sep_ly, SMENU_LEFT_W - 20, lsep);
+    xgui_display_hline(menu_x + 10, sep_ly, SMENU_LEFT_W - 20, td->menu.left_sep);
 
     /* --- Right column items --- */
     /* Section header */
-    uint32_t hdr_col = dark ? XGUI_RGB(180, 200, 255) : XGUI_RGB(60, 80, 140);
-    xgui_display_text_transparent(right_x0 + 8, body_top + SMENU_PAD - 1, "System", hdr_col);
+    xgui_display_text_transparent(right_x0 + 8, body_top + SMENU_PAD - 1, "System",
+                                  td->menu.header_text);
     int right_item_start = body_top + SMENU_PAD + 16;
 
     for (int i = 0; i < RIGHT_COUNT; i++) {
         int iy = right_item_start + i * SMENU_ITEM_H;
         if (menu_hover_item == RIGHT_BASE + i) {
-            draw_menu_highlight(right_x0 + 1, iy, SMENU_RIGHT_W - 3, SMENU_ITEM_H, hover_bg);
+            draw_menu_highlight(right_x0 + 1, iy, SMENU_RIGHT_W - 3, SMENU_ITEM_H);
             xgui_display_text_transparent(right_x0 + 10, iy + 4, right_labels[i], hover_text);
         } else {
-            uint32_t rt = dark ? XGUI_RGB(220, 220, 220) : XGUI_RGB(40, 40, 40);
-            xgui_display_text_transparent(right_x0 + 10, iy + 4, right_labels[i], rt);
+            xgui_display_text_transparent(right_x0 + 10, iy + 4, right_labels[i],
+                                          td->menu.right_text);
         }
     }
 
     /* --- Bottom bar: neutral background --- */
     for (int row = 0; row < SMENU_BOTTOM_H; row++) {
         int t = (row * 255) / SMENU_BOTTOM_H;
-        uint32_t c = blend_color(darken(accent, 10), darken(accent, 30), t);
+        uint32_t c = blend_color(td->menu.bottom_top, td->menu.bottom_bot, t);
         xgui_display_hline(menu_x + 1, bot_y + row, SMENU_W - 2, c);
     }
-    xgui_display_hline(menu_x + 1, bot_y, SMENU_W - 2, lighten(accent, 20));
+    xgui_display_hline(menu_x + 1, bot_y, SMENU_W - 2, td->menu.bottom_hi);
 
     /* Small red Shutdown button (right-aligned in bottom bar) */
     {
@@ -1260,12 +1435,10 @@ void xgui_draw_start_menu(void) {
     }
 
     /* --- Outer border (beveled) --- */
-    uint32_t brd_light = dark ? lighten(menu_bg, 40) : darken(menu_bg, 15);
-    uint32_t brd_dark = dark ? lighten(menu_bg, 15) : darken(menu_bg, 50);
-    xgui_display_hline(menu_x, menu_y, SMENU_W, brd_light);
-    xgui_display_vline(menu_x, menu_y, menu_h, brd_light);
-    xgui_display_hline(menu_x, menu_y + menu_h - 1, SMENU_W, brd_dark);
-    xgui_display_vline(menu_x + SMENU_W - 1, menu_y, menu_h, brd_dark);
+    xgui_display_hline(menu_x, menu_y, SMENU_W, td->menu.border_light);
+    xgui_display_vline(menu_x, menu_y, menu_h, td->menu.border_light);
+    xgui_display_hline(menu_x, menu_y + menu_h - 1, SMENU_W, td->menu.border_dark);
+    xgui_display_vline(menu_x + SMENU_W - 1, menu_y, menu_h, td->menu.border_dark);
 
     /* Drop shadow */
     draw_drop_shadow(menu_x, menu_y, SMENU_W, menu_h, 6);
@@ -1289,7 +1462,7 @@ static const char* smenu_app_ids[] = {
  * Called from xgui.c for clicks on the desktop area (not on windows/panel).
  * Returns true if the click was consumed.
  */
-bool xgui_desktop_icon_click(int x, int y, int button) {
+bool xgui_desktop_icon_click(int x, int y, int button, int click_count) {
     /* Handle desktop icon context menu (Remove Shortcut) clicks */
     if (dicon_ctx_visible) {
         int mw = 160, mh = 24;
@@ -1327,47 +1500,41 @@ bool xgui_desktop_icon_click(int x, int y, int button) {
         return true;
     }
 
-    /* Check if click is on a desktop icon */
-    for (int i = 0; i < DICON_MAX; i++) {
-        if (!dicons[i].used) continue;
+    /* Check if click is on a desktop icon (O(1) grid lookup) */
+    int i = dicon_at(x, y);
+    if (i >= 0) {
         int ix, iy, iw, ih;
         dicon_get_rect(i, &ix, &iy, &iw, &ih);
-        if (x >= ix && x < ix + iw && y >= iy && y < iy + ih) {
-            if (button == XGUI_MOUSE_RIGHT) {
-                /* Right-click: show remove context menu */
-                dicon_ctx_visible = true;
-                dicon_ctx_x = x;
-                dicon_ctx_y = y;
-                dicon_ctx_idx = i;
-                dicon_ctx_hover = -1;
-                dicon_selected = i;
-                return true;
-            }
-            /* Left-click: select and begin potential drag */
+        (void)iw; (void)ih;
+        if (button == XGUI_MOUSE_RIGHT) {
+            /* Right-click: show remove context menu */
+            dicon_ctx_visible = true;
+            dicon_ctx_x = x;
+            dicon_ctx_y = y;
+            dicon_ctx_idx = i;
+            dicon_ctx_hover = -1;
             dicon_selected = i;
-            dicon_dragging = true;
-            dicon_drag_idx = i;
-            dicon_drag_started = false;
-            dicon_drag_start_mx = x;
-            dicon_drag_start_my = y;
-            dicon_drag_ox = x - ix;
-            dicon_drag_oy = y - iy;
-            dicon_drag_px = ix;
-            dicon_drag_py = iy;
-
-            /* Double-click detection */
-            uint32_t now = timer_get_ticks();
-            if (i == dicon_last_click_idx && (now - dicon_last_click_tick) < 50) {
-                dicon_launch(i);
-                dicon_selected = -1;
-                dicon_last_click_idx = -1;
-                dicon_dragging = false;
-            } else {
-                dicon_last_click_idx = i;
-                dicon_last_click_tick = now;
-            }
             return true;
         }
+        /* Left-click: select and begin potential drag */
+        dicon_selected = i;
+        dicon_dragging = true;
+        dicon_drag_idx = i;
+        dicon_drag_started = false;
+        dicon_drag_start_mx = x;
+        dicon_drag_start_my = y;
+        dicon_drag_ox = x - ix;
+        dicon_drag_oy = y - iy;
+        dicon_drag_px = ix;
+        dicon_drag_py = iy;
+
+        /* Event layer tracks the click chain; a count of 2+ opens */
+        if (click_count >= 2) {
+            dicon_launch(i);
+            dicon_selected = -1;
+            dicon_dragging = false;
+        }
+        return true;
     }
 
     /* Click on empty desktop: deselect */
@@ -1411,8 +1578,6 @@ void xgui_desktop_icon_mouse_move(int x, int y) {
             if (dy < 0) dy = -dy;
             if (dx > 4 || dy > 4) {
                 dicon_drag_started = true;
-                /* Cancel double-click once drag starts */
-                dicon_last_click_idx = -1;
             }
         }
         if (dicon_drag_started) {
@@ -1447,19 +1612,18 @@ bool xgui_desktop_icon_mouse_up(int x, int y) {
         int new_col, new_row;
         dicon_snap_to_grid(dicon_drag_px, dicon_drag_py, &new_col, &new_row);
 
-        /* Check if target cell is occupied by another icon — swap if so */
-        for (int i = 0; i < DICON_MAX; i++) {
-            if (i == dicon_drag_idx || !dicons[i].used) continue;
-            if (dicons[i].grid_col == new_col && dicons[i].grid_row == new_row) {
-                /* Swap positions */
-                dicons[i].grid_col = dicons[dicon_drag_idx].grid_col;
-                dicons[i].grid_row = dicons[dicon_drag_idx].grid_row;
-                break;
+        /* If the target cell is occupied by another icon, swap */
+        if (new_col < DICON_GRID_COLS && new_row < DICON_GRID_ROWS) {
+            int other = dicon_cell[new_col][new_row];
+            if (other >= 0 && other != dicon_drag_idx && dicons[other].used) {
+                dicons[other].grid_col = dicons[dicon_drag_idx].grid_col;
+                dicons[other].grid_row = dicons[dicon_drag_idx].grid_row;
             }
         }
 
         dicons[dicon_drag_idx].grid_col = new_col;
         dicons[dicon_drag_idx].grid_row = new_row;
+        dicon_grid_rebuild();
         dicon_save();
     }
 
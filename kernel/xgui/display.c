@@ -6,14 +6,42 @@
 
 #include "xgui/display.h"
 #include "xgui/font.h"
+#include "xgui/theme.h"
 #include "vesa.h"
 #include "heap.h"
 #include "string.h"
 #include "serial.h"
+#include "stdio.h"
+#include "timer.h"
+#include "trace.h"
 
 /* Global display state */
 static xgui_display_t display;
 
+/* Frame timing: per-frame compose/flush times plus a one-second fps
+ * window, sampled in xgui_display_flush */
+static xgui_frame_stats_t frame_stats;
+static uint64_t frame_begin_us = 0;
+static uint64_t fps_window_start = 0;
+static uint32_t fps_window_frames = 0;
+static bool hud_enabled = false;
+
+/*
+ * Fill count pixels with one color in a single rep stosl burst; the
+ * same idiom as memset in lib/string.c, but with a 32-bit pattern.
+ * MMX/SSE wide stores are off the table inside the kernel: lazy FPU
+ * switching (process/fpu.c) means those registers hold some process's
+ * live state and CR0.TS may be set, so any MMX/SSE instruction here
+ * would fault or corrupt user context. rep stosl already saturates
+ * the backbuffer's write bandwidth on the CPUs we target.
+ */
+static inline void pixel_fill(uint32_t* dst, uint32_t color, int count) {
+    __asm__ volatile("rep stosl"
+                     : "+D"(dst), "+c"(count)
+                     : "a"(color)
+                     : "memory");
+}
+
 static inline uint32_t pack_rgb(uint8_t r, uint8_t g, uint8_t b) {
     uint32_t pixel = 0;
     pixel |= ((uint32_t)r) << display.red_position;
@@ -34,20 +62,229 @@ static inline uint32_t backbuf_to_fb32(uint32_t c) {
     return pack_rgb(r, g, b);
 }
 
-static void flush_line_24bpp(int y) {
-    uint8_t* dst = display.framebuffer + (uint32_t)y * (uint32_t)display.pitch;
-    uint32_t* src = &display.backbuffer[y * display.width];
+/*
+ * Line staging buffer for non-native framebuffer formats: the dirty
+ * span is converted here, then copied to the framebuffer in one
+ * rep-movs burst, so the (write-combining) framebuffer sees streaming
+ * stores instead of scattered per-pixel writes. 8KB covers a
+ * 2730-pixel span at 24bpp.
+ */
+#define FLUSH_STAGING_BYTES 8192
+static uint8_t flush_staging[FLUSH_STAGING_BYTES];
+
+/*
+ * Push one rectangle (half-open, pre-clipped) from the backbuffer to
+ * the framebuffer
+ */
+static void flush_rect(int x1, int y1, int x2, int y2) {
+    int span = x2 - x1;
+    if (span <= 0) return;
+
+    if (display.fb_native) {
+        /* Framebuffer layout matches the backbuffer: straight copy */
+        for (int y = y1; y < y2; y++) {
+            uint32_t* src = &display.backbuffer[y * display.width];
+            uint32_t* dst = (uint32_t*)(display.framebuffer + (uint32_t)y * (uint32_t)display.pitch);
+            memcpy(&dst[x1], &src[x1], (uint32_t)span * sizeof(uint32_t));
+        }
+        return;
+    }
+
+    if (display.bytes_per_pixel == 3) {
+        bool staged = (uint32_t)span * 3 <= FLUSH_STAGING_BYTES;
+        for (int y = y1; y < y2; y++) {
+            uint8_t* dst = display.framebuffer + (uint32_t)y * (uint32_t)display.pitch;
+            uint32_t* src = &display.backbuffer[y * display.width];
+
+            if (staged) {
+                uint8_t* p = flush_staging;
+                for (int x = x1; x < x2; x++) {
+                    uint32_t px = backbuf_to_fb32(src[x]);
+                    *p++ = (uint8_t)(px & 0xFF);
+                    *p++ = (uint8_t)((px >> 8) & 0xFF);
+                    *p++ = (uint8_t)((px >> 16) & 0xFF);
+                }
+                memcpy(dst + x1 * 3, flush_staging, (uint32_t)span * 3);
+            } else {
+                for (int x = x1; x < x2; x++) {
+                    uint32_t px = backbuf_to_fb32(src[x]);
+                    dst[x * 3 + 0] = (uint8_t)(px & 0xFF);
+                    dst[x * 3 + 1] = (uint8_t)((px >> 8) & 0xFF);
+                    dst[x * 3 + 2] = (uint8_t)((px >> 16) & 0xFF);
+                }
+            }
+        }
+        return;
+    }
+
+    /* 32bpp with a non-native channel order */
+    bool staged = (uint32_t)span * sizeof(uint32_t) <= FLUSH_STAGING_BYTES;
+    for (int y = y1; y < y2; y++) {
+        uint32_t* src = &display.backbuffer[y * display.width];
+        uint32_t* dst = (uint32_t*)(display.framebuffer + (uint32_t)y * (uint32_t)display.pitch);
+        if (staged) {
+            uint32_t* p = (uint32_t*)flush_staging;
+            for (int x = x1; x < x2; x++) {
+                *p++ = backbuf_to_fb32(src[x]);
+            }
+            memcpy(&dst[x1], flush_staging, (uint32_t)span * sizeof(uint32_t));
+        } else {
+            for (int x = x1; x < x2; x++) {
+                dst[x] = backbuf_to_fb32(src[x]);
+            }
+        }
+    }
+}
+
+/*
+ * Save-under mouse cursor layer. The cursor draws straight into the
+ * framebuffer and the framebuffer-format pixels it covers are cached,
+ * so motion costs a restore of the old 16x16 patch plus a draw at the
+ * new spot - no recomposite, no dirty-list traffic.
+ */
+#define CURSOR_W 16
+#define CURSOR_H 16
+
+static struct {
+    int x1, y1, x2, y2;             /* Clipped patch bounds on screen */
+    bool visible;
+    uint8_t saved[CURSOR_W * CURSOR_H * 4];    /* FB-format pixels */
+} cursor;
 
-    for (int x = 0; x < display.width; x++) {
-        uint32_t c = src[x];
-        uint8_t r = (uint8_t)((c >> 16) & 0xFF);
-        uint8_t g = (uint8_t)((c >> 8) & 0xFF);
-        uint8_t b = (uint8_t)(c & 0xFF);
-        uint32_t px = pack_rgb(r, g, b);
-        dst[x * 3 + 0] = (uint8_t)(px & 0xFF);
-        dst[x * 3 + 1] = (uint8_t)((px >> 8) & 0xFF);
-        dst[x * 3 + 2] = (uint8_t)((px >> 16) & 0xFF);
+/* Write one framebuffer pixel in the current format */
+static inline void fb_store(uint8_t* dst, uint32_t fb_px) {
+    if (display.bytes_per_pixel == 3) {
+        dst[0] = (uint8_t)(fb_px & 0xFF);
+        dst[1] = (uint8_t)((fb_px >> 8) & 0xFF);
+        dst[2] = (uint8_t)((fb_px >> 16) & 0xFF);
+    } else {
+        *(uint32_t*)dst = fb_px;
+    }
+}
+
+/*
+ * Restore the framebuffer patch under the cursor from the save cache
+ */
+void xgui_display_cursor_hide(void) {
+    if (!display.initialized || !cursor.visible) return;
+
+    int span = cursor.x2 - cursor.x1;
+    uint8_t* src = cursor.saved;
+    for (int y = cursor.y1; y < cursor.y2; y++) {
+        uint8_t* dst = display.framebuffer + (uint32_t)y * (uint32_t)display.pitch
+                     + cursor.x1 * display.bytes_per_pixel;
+        memcpy(dst, src, (uint32_t)(span * display.bytes_per_pixel));
+        src += span * display.bytes_per_pixel;
     }
+    cursor.visible = false;
+}
+
+/*
+ * Draw the cursor bitmap (16x16 ARGB, 0 = transparent) at x,y, saving
+ * the pixels it covers. The saved patch is rebuilt from the backbuffer
+ * rather than read back from the framebuffer, which is mapped
+ * write-combining and slow to read.
+ */
+void xgui_display_cursor_show(int x, int y, const uint32_t* bitmap) {
+    if (!display.initialized || !bitmap) return;
+
+    if (cursor.visible) {
+        xgui_display_cursor_hide();
+    }
+
+    int x1 = (x < 0) ? 0 : x;
+    int y1 = (y < 0) ? 0 : y;
+    int x2 = (x + CURSOR_W > display.width) ? display.width : x + CURSOR_W;
+    int y2 = (y + CURSOR_H > display.height) ? display.height : y + CURSOR_H;
+    if (x1 >= x2 || y1 >= y2) return;
+
+    cursor.x1 = x1;
+    cursor.y1 = y1;
+    cursor.x2 = x2;
+    cursor.y2 = y2;
+
+    uint8_t* save = cursor.saved;
+    for (int row = y1; row < y2; row++) {
+        uint32_t* back = &display.backbuffer[row * display.width];
+        uint8_t* dst = display.framebuffer + (uint32_t)row * (uint32_t)display.pitch
+                     + x1 * display.bytes_per_pixel;
+
+        /* Cache what belongs under the cursor... */
+        for (int col = x1; col < x2; col++) {
+            fb_store(save, backbuf_to_fb32(back[col]));
+            save += display.bytes_per_pixel;
+        }
+
+        /* ...then draw the opaque cursor pixels over it */
+        for (int col = x1; col < x2; col++) {
+            uint32_t px = bitmap[(row - y) * CURSOR_W + (col - x)];
+            if (px != 0) {
+                fb_store(dst, backbuf_to_fb32(px));
+            }
+            dst += display.bytes_per_pixel;
+        }
+    }
+    cursor.visible = true;
+}
+
+/*
+ * Record a dirty rectangle (half-open bounds). Rects that overlap or
+ * touch an existing entry are merged into it; when the list is full
+ * the new rect is folded into the entry whose union grows the least,
+ * so flushing never loses pixels, it only gets slightly coarser.
+ */
+static void mark_rect(int x1, int y1, int x2, int y2) {
+    if (display.all_dirty) return;
+
+    /* Clip to screen bounds */
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 > display.width) x2 = display.width;
+    if (y2 > display.height) y2 = display.height;
+    if (x1 >= x2 || y1 >= y2) return;
+
+    /* Merge with an overlapping or touching rect if there is one */
+    for (int i = 0; i < display.dirty_rect_count; i++) {
+        xgui_rect_t* r = &display.dirty_rects[i];
+        if (x1 <= r->x2 && x2 >= r->x1 && y1 <= r->y2 && y2 >= r->y1) {
+            if (x1 < r->x1) r->x1 = x1;
+            if (y1 < r->y1) r->y1 = y1;
+            if (x2 > r->x2) r->x2 = x2;
+            if (y2 > r->y2) r->y2 = y2;
+            return;
+        }
+    }
+
+    if (display.dirty_rect_count < XGUI_MAX_DIRTY_RECTS) {
+        xgui_rect_t* r = &display.dirty_rects[display.dirty_rect_count++];
+        r->x1 = x1;
+        r->y1 = y1;
+        r->x2 = x2;
+        r->y2 = y2;
+        return;
+    }
+
+    /* List full: fold into the rect whose union adds the least area */
+    int best = 0;
+    int best_cost = 0x7FFFFFFF;
+    for (int i = 0; i < display.dirty_rect_count; i++) {
+        xgui_rect_t* r = &display.dirty_rects[i];
+        int ux1 = (x1 < r->x1) ? x1 : r->x1;
+        int uy1 = (y1 < r->y1) ? y1 : r->y1;
+        int ux2 = (x2 > r->x2) ? x2 : r->x2;
+        int uy2 = (y2 > r->y2) ? y2 : r->y2;
+        int cost = (ux2 - ux1) * (uy2 - uy1) - (r->x2 - r->x1) * (r->y2 - r->y1);
+        if (cost < best_cost) {
+            best_cost = cost;
+            best = i;
+        }
+    }
+
+    xgui_rect_t* r = &display.dirty_rects[best];
+    if (x1 < r->x1) r->x1 = x1;
+    if (y1 < r->y1) r->y1 = y1;
+    if (x2 > r->x2) r->x2 = x2;
+    if (y2 > r->y2) r->y2 = y2;
 }
 
 /*
@@ -68,6 +305,15 @@ int xgui_display_init(void) {
 
     vesa_info_t* vesa = vesa_get_info();
 
+    /* Prefer a native 32bpp mode: the per-pixel 24bpp conversion in
+     * the flush path disappears entirely when the hardware can take
+     * the backbuffer format directly */
+    if (vesa->bpp == 24 && vesa_bochs_available()) {
+        if (vesa_set_mode((int)vesa->width, (int)vesa->height, 32) == 0) {
+            serial_write_string("XGUI: switched to native 32bpp mode\n");
+        }
+    }
+
     display.framebuffer = vesa->framebuffer;
     display.width = vesa->width;
     display.height = vesa->height;
@@ -80,6 +326,10 @@ int xgui_display_init(void) {
     display.green_mask_size = (int)vesa->green_mask_size;
     display.blue_position = (int)vesa->blue_position;
     display.blue_mask_size = (int)vesa->blue_mask_size;
+    display.fb_native = (display.bytes_per_pixel == 4 &&
+                         display.red_position == 16 &&
+                         display.green_position == 8 &&
+                         display.blue_position == 0);
 
     serial_write_string("XGUI: fb bpp=");
     serial_write_hex((uint32_t)display.bpp);
@@ -110,18 +360,10 @@ int xgui_display_init(void) {
         return -1;
     }
 
-    /* Allocate dirty line flags */
-    display.dirty_lines = (bool*)kmalloc(display.height * sizeof(bool));
-    if (!display.dirty_lines) {
-        serial_write_string("XGUI: display_init - kmalloc dirty_lines failed\n");
-        kfree(display.backbuffer);
-        display.backbuffer = NULL;
-        return -1;
-    }
-
     /* Clear the backbuffer and mark all dirty */
     memset(display.backbuffer, 0, buffer_size);
-    memset(display.dirty_lines, 1, display.height * sizeof(bool));
+    display.dirty_rect_count = 0;
+    display.all_dirty = true;
 
     display.initialized = true;
     serial_write_string("XGUI: display_init OK\n");
@@ -141,11 +383,6 @@ void xgui_display_cleanup(void) {
         display.backbuffer = NULL;
     }
 
-    if (display.dirty_lines) {
-        kfree(display.dirty_lines);
-        display.dirty_lines = NULL;
-    }
-
     display.initialized = false;
 }
 
@@ -158,9 +395,8 @@ int xgui_display_reinit(void) {
 
     vesa_info_t* vesa = vesa_get_info();
 
-    /* Free old buffers */
+    /* Free old buffer */
     if (display.backbuffer) kfree(display.backbuffer);
-    if (display.dirty_lines) kfree(display.dirty_lines);
 
     /* Update display state from VESA */
     display.framebuffer = vesa->framebuffer;
@@ -169,6 +405,10 @@ int xgui_display_reinit(void) {
     display.pitch = vesa->pitch;
     display.bpp = (int)vesa->bpp;
     display.bytes_per_pixel = (int)vesa->bytes_per_pixel;
+    display.fb_native = (display.bytes_per_pixel == 4 &&
+                         display.red_position == 16 &&
+                         display.green_position == 8 &&
+                         display.blue_position == 0);
 
     /* Allocate new backbuffer */
     uint32_t buffer_size = display.width * display.height * sizeof(uint32_t);
@@ -179,19 +419,14 @@ int xgui_display_reinit(void) {
         return -1;
     }
 
-    /* Allocate new dirty line flags */
-    display.dirty_lines = (bool*)kmalloc(display.height * sizeof(bool));
-    if (!display.dirty_lines) {
-        serial_write_string("XGUI: display_reinit - kmalloc dirty_lines failed\n");
-        kfree(display.backbuffer);
-        display.backbuffer = NULL;
-        display.initialized = false;
-        return -1;
-    }
-
     /* Clear and mark all dirty */
     memset(display.backbuffer, 0, buffer_size);
-    memset(display.dirty_lines, 1, display.height * sizeof(bool));
+    display.dirty_rect_count = 0;
+    display.all_dirty = true;
+
+    /* Derived theme tables are cheap to rebuild and this keeps them
+     * valid should any of them ever become mode-dependent */
+    xgui_theme_rebuild_derived();
 
     serial_write_string("XGUI: display_reinit OK\n");
     return 0;
@@ -228,12 +463,7 @@ uint32_t* xgui_display_get_backbuffer(void) {
 void xgui_display_clear(uint32_t color) {
     if (!display.initialized) return;
 
-    uint32_t* p = display.backbuffer;
-    int count = display.width * display.height;
-
-    while (count--) {
-        *p++ = color;
-    }
+    pixel_fill(display.backbuffer, color, display.width * display.height);
 
     xgui_display_mark_all_dirty();
 }
@@ -246,7 +476,7 @@ void xgui_display_pixel(int x, int y, uint32_t color) {
     if (x < 0 || x >= display.width || y < 0 || y >= display.height) return;
 
     display.backbuffer[y * display.width + x] = color;
-    display.dirty_lines[y] = true;
+    mark_rect(x, y, x + 1, y + 1);
 }
 
 /*
@@ -277,11 +507,8 @@ void xgui_display_hline(int x, int y, int length, uint32_t color) {
     }
     if (length <= 0) return;
 
-    uint32_t* p = &display.backbuffer[y * display.width + x];
-    while (length--) {
-        *p++ = color;
-    }
-    display.dirty_lines[y] = true;
+    mark_rect(x, y, x + length, y + 1);
+    pixel_fill(&display.backbuffer[y * display.width + x], color, length);
 }
 
 /*
@@ -303,44 +530,143 @@ void xgui_display_vline(int x, int y, int length, uint32_t color) {
     if (length <= 0) return;
 
     uint32_t* p = &display.backbuffer[y * display.width + x];
+    mark_rect(x, y, x + 1, y + length);
     while (length--) {
         *p = color;
         p += display.width;
-        display.dirty_lines[y++] = true;
     }
 }
 
+/* Cohen-Sutherland outcodes for line clipping */
+#define CLIP_LEFT   0x1
+#define CLIP_RIGHT  0x2
+#define CLIP_TOP    0x4
+#define CLIP_BOTTOM 0x8
+
+static int clip_outcode(int x, int y) {
+    int code = 0;
+    if (x < 0) code |= CLIP_LEFT;
+    else if (x >= display.width) code |= CLIP_RIGHT;
+    if (y < 0) code |= CLIP_TOP;
+    else if (y >= display.height) code |= CLIP_BOTTOM;
+    return code;
+}
+
 /*
- * Draw a line using Bresenham's algorithm
+ * Clip a segment to the screen with Cohen-Sutherland.
+ * Returns false when the segment lies fully outside.
  */
-void xgui_display_line(int x1, int y1, int x2, int y2, uint32_t color) {
-    if (!display.initialized) return;
-
-    int dx = x2 - x1;
-    int dy = y2 - y1;
-    int sx = (dx > 0) ? 1 : -1;
-    int sy = (dy > 0) ? 1 : -1;
+static bool clip_line(int* x1, int* y1, int* x2, int* y2) {
+    int code1 = clip_outcode(*x1, *y1);
+    int code2 = clip_outcode(*x2, *y2);
+
+    for (;;) {
+        if ((code1 | code2) == 0) return true;   /* Both inside */
+        if ((code1 & code2) != 0) return false;  /* Shared outside zone */
+
+        /* Push the endpoint that is outside to the crossed boundary */
+        int out = code1 ? code1 : code2;
+        int x, y;
+        if (out & CLIP_BOTTOM) {
+            x = *x1 + (*x2 - *x1) * (display.height - 1 - *y1) / (*y2 - *y1);
+            y = display.height - 1;
+        } else if (out & CLIP_TOP) {
+            x = *x1 + (*x2 - *x1) * (0 - *y1) / (*y2 - *y1);
+            y = 0;
+        } else if (out & CLIP_RIGHT) {
+            y = *y1 + (*y2 - *y1) * (display.width - 1 - *x1) / (*x2 - *x1);
+            x = display.width - 1;
+        } else {
+            y = *y1 + (*y2 - *y1) * (0 - *x1) / (*x2 - *x1);
+            x = 0;
+        }
 
-    if (dx < 0) dx = -dx;
-    if (dy < 0) dy = -dy;
+        if (out == code1) {
+            *x1 = x;
+            *y1 = y;
+            code1 = clip_outcode(x, y);
+        } else {
+            *x2 = x;
+            *y2 = y;
+            code2 = clip_outcode(x, y);
+        }
+    }
+}
 
-    int err = dx - dy;
+/*
+ * Draw a line using Bresenham's algorithm.
+ * The segment is clipped once up front (Cohen-Sutherland) and then
+ * rendered without any per-pixel bounds checks: shallow lines emit
+ * horizontal spans through the rep-stosl fill, steep lines store
+ * straight into the backbuffer.
+ */
+void xgui_display_line(int x1, int y1, int x2, int y2, uint32_t color) {
+    if (!display.initialized) return;
+    if (!clip_line(&x1, &y1, &x2, &y2)) return;
 
-    while (1) {
-        xgui_display_pixel(x1, y1, color);
+    /* Axis-aligned segments are whole spans */
+    if (y1 == y2) {
+        int xl = (x1 < x2) ? x1 : x2;
+        int xr = (x1 < x2) ? x2 : x1;
+        xgui_display_hline(xl, y1, xr - xl + 1, color);
+        return;
+    }
+    if (x1 == x2) {
+        int yt = (y1 < y2) ? y1 : y2;
+        int yb = (y1 < y2) ? y2 : y1;
+        xgui_display_vline(x1, yt, yb - yt + 1, color);
+        return;
+    }
 
-        if (x1 == x2 && y1 == y2) break;
+    int dx = (x2 > x1) ? x2 - x1 : x1 - x2;
+    int dy = (y2 > y1) ? y2 - y1 : y1 - y2;
 
-        int e2 = 2 * err;
-        if (e2 > -dy) {
+    if (dx >= dy) {
+        /* Shallow: walk x left to right, flush a span at each y step */
+        if (x1 > x2) {
+            int t = x1; x1 = x2; x2 = t;
+            t = y1; y1 = y2; y2 = t;
+        }
+        int sy = (y2 > y1) ? 1 : -1;
+        int err = dx / 2;
+        int y = y1;
+        int run_start = x1;
+        for (int x = x1; x <= x2; x++) {
             err -= dy;
-            x1 += sx;
+            if (err < 0 || x == x2) {
+                pixel_fill(&display.backbuffer[y * display.width + run_start],
+                           color, x - run_start + 1);
+                err += dx;
+                y += sy;
+                run_start = x + 1;
+            }
+        }
+    } else {
+        /* Steep: walk y top to bottom, one unchecked store per row */
+        if (y1 > y2) {
+            int t = x1; x1 = x2; x2 = t;
+            t = y1; y1 = y2; y2 = t;
         }
-        if (e2 < dx) {
-            err += dx;
-            y1 += sy;
+        int sx = (x2 > x1) ? 1 : -1;
+        int err = dy / 2;
+        uint32_t* p = &display.backbuffer[y1 * display.width + x1];
+        for (int y = y1; y <= y2; y++) {
+            *p = color;
+            err -= dx;
+            if (err < 0) {
+                p += sx;
+                err += dy;
+            }
+            p += display.width;
         }
     }
+
+    /* One dirty rect for the whole segment */
+    int mx1 = (x1 < x2) ? x1 : x2;
+    int mx2 = (x1 < x2) ? x2 : x1;
+    int my1 = (y1 < y2) ? y1 : y2;
+    int my2 = (y1 < y2) ? y2 : y1;
+    mark_rect(mx1, my1, mx2 + 1, my2 + 1);
 }
 
 /*
@@ -379,12 +705,9 @@ void xgui_display_rect_filled(int x, int y, int w, int h, uint32_t color) {
     int clipped_w = x2 - x1;
 
     for (int row = y1; row < y2; row++) {
-        uint32_t* p = &display.backbuffer[row * display.width + x1];
-        for (int col = 0; col < clipped_w; col++) {
-            *p++ = color;
-        }
-        display.dirty_lines[row] = true;
+        pixel_fill(&display.backbuffer[row * display.width + x1], color, clipped_w);
     }
+    mark_rect(x1, y1, x2, y2);
 }
 
 /*
@@ -434,16 +757,34 @@ void xgui_display_rect_3d_sunken(int x, int y, int w, int h) {
 }
 
 /*
- * Draw text at position using the built-in font
+ * Draw text at position using the built-in font.
+ * Opaque text blits cached 32bpp glyph tiles into the backbuffer with
+ * row copies instead of per-pixel bit tests.
  */
 void xgui_display_text(int x, int y, const char* str, uint32_t fg, uint32_t bg) {
     if (!display.initialized || !str) return;
 
+    int start_x = x;
+
     while (*str) {
-        xgui_font_draw_char(x, y, *str, fg, bg);
+        const uint32_t* tile = xgui_font_tile(*str, fg, bg);
+
+        int x1 = (x < 0) ? 0 : x;
+        int y1 = (y < 0) ? 0 : y;
+        int x2 = (x + XGUI_FONT_WIDTH > display.width) ? display.width : x + XGUI_FONT_WIDTH;
+        int y2 = (y + XGUI_FONT_HEIGHT > display.height) ? display.height : y + XGUI_FONT_HEIGHT;
+
+        for (int row = y1; row < y2; row++) {
+            if (x1 >= x2) break;
+            memcpy(&display.backbuffer[row * display.width + x1],
+                   &tile[(row - y) * XGUI_FONT_WIDTH + (x1 - x)],
+                   (uint32_t)(x2 - x1) * sizeof(uint32_t));
+        }
         x += XGUI_FONT_WIDTH;
         str++;
     }
+
+    mark_rect(start_x, y, x, y + XGUI_FONT_HEIGHT);
 }
 
 /*
@@ -506,7 +847,7 @@ void xgui_display_copy_rect(int dst_x, int dst_y, int src_x, int src_y, int w, i
 
             if (start < end) {
                 memmove(dst + start, src + start, (end - start) * sizeof(uint32_t));
-                display.dirty_lines[dy] = true;
+                mark_rect(dst_x + start, dy, dst_x + end, dy + 1);
             }
         }
     } else {
@@ -529,7 +870,7 @@ void xgui_display_copy_rect(int dst_x, int dst_y, int src_x, int src_y, int w, i
 
             if (start < end) {
                 memmove(dst + start, src + start, (end - start) * sizeof(uint32_t));
-                display.dirty_lines[dy] = true;
+                mark_rect(dst_x + start, dy, dst_x + end, dy + 1);
             }
         }
     }
@@ -542,48 +883,66 @@ void xgui_display_blit(int x, int y, int w, int h, const uint32_t* bitmap) {
     if (!display.initialized || !bitmap) return;
     if (w <= 0 || h <= 0) return;
 
-    for (int row = 0; row < h; row++) {
-        int dy = y + row;
-        if (dy < 0 || dy >= display.height) continue;
-
-        for (int col = 0; col < w; col++) {
-            int dx = x + col;
-            if (dx < 0 || dx >= display.width) continue;
-
-            uint32_t pixel = bitmap[row * w + col];
+    /* Clip once instead of bounds-testing every pixel */
+    int col0 = (x < 0) ? -x : 0;
+    int col1 = (x + w > display.width) ? display.width - x : w;
+    int row0 = (y < 0) ? -y : 0;
+    int row1 = (y + h > display.height) ? display.height - y : h;
+    if (col0 >= col1 || row0 >= row1) return;
+
+    for (int row = row0; row < row1; row++) {
+        const uint32_t* src = &bitmap[row * w];
+        uint32_t* dst = &display.backbuffer[(y + row) * display.width + x];
+
+        int col = col0;
+        while (col < col1) {
+            /* Opaque pixels are the common case (XGUI_RGB bakes in
+             * 0xFF alpha): copy whole runs of them in one rep-movs
+             * burst instead of storing pixel by pixel */
+            if (XGUI_GET_A(src[col]) == 0xFF) {
+                int run = col + 1;
+                while (run < col1 && XGUI_GET_A(src[run]) == 0xFF) {
+                    run++;
+                }
+                memcpy(&dst[col], &src[col],
+                       (uint32_t)(run - col) * sizeof(uint32_t));
+                col = run;
+                continue;
+            }
 
-            /* Handle alpha blending if pixel has transparency */
+            uint32_t pixel = src[col];
             uint8_t alpha = XGUI_GET_A(pixel);
-            if (alpha == 0xFF) {
-                display.backbuffer[dy * display.width + dx] = pixel;
-            } else if (alpha > 0) {
+            if (alpha > 0) {
                 /* Simple alpha blending */
-                uint32_t bg = display.backbuffer[dy * display.width + dx];
+                uint32_t bg = dst[col];
                 uint8_t inv_alpha = 255 - alpha;
 
                 uint8_t r = (XGUI_GET_R(pixel) * alpha + XGUI_GET_R(bg) * inv_alpha) / 255;
                 uint8_t g = (XGUI_GET_G(pixel) * alpha + XGUI_GET_G(bg) * inv_alpha) / 255;
                 uint8_t b = (XGUI_GET_B(pixel) * alpha + XGUI_GET_B(bg) * inv_alpha) / 255;
 
-                display.backbuffer[dy * display.width + dx] = XGUI_RGB(r, g, b);
+                dst[col] = XGUI_RGB(r, g, b);
             }
+            col++;
         }
-        display.dirty_lines[dy] = true;
     }
+    mark_rect(x, y, x + w, y + h);
 }
 
 /*
- * Mark a region as dirty
+ * Mark a full-width band of lines as dirty
  */
 void xgui_display_mark_dirty(int y_start, int y_end) {
     if (!display.initialized) return;
+    mark_rect(0, y_start, display.width, y_end);
+}
 
-    if (y_start < 0) y_start = 0;
-    if (y_end > display.height) y_end = display.height;
-
-    for (int y = y_start; y < y_end; y++) {
-        display.dirty_lines[y] = true;
-    }
+/*
+ * Mark a rectangle as dirty
+ */
+void xgui_display_mark_dirty_rect(int x, int y, int w, int h) {
+    if (!display.initialized) return;
+    mark_rect(x, y, x + w, y + h);
 }
 
 /*
@@ -591,35 +950,124 @@ void xgui_display_mark_dirty(int y_start, int y_end) {
  */
 void xgui_display_mark_all_dirty(void) {
     if (!display.initialized) return;
-    memset(display.dirty_lines, 1, display.height * sizeof(bool));
+    display.all_dirty = true;
+    display.dirty_rect_count = 0;
+}
+
+void xgui_display_frame_begin(void) {
+    frame_begin_us = timer_us();
+}
+
+void xgui_display_get_frame_stats(xgui_frame_stats_t* stats) {
+    *stats = frame_stats;
+}
+
+void xgui_display_hud_toggle(void) {
+    hud_enabled = !hud_enabled;
+}
+
+/*
+ * Draw the frame-time HUD into the top-right corner of the backbuffer.
+ * Called just before the dirty rects are flushed, so the overlay rides
+ * along with the frame; the next compose simply paints over it.
+ */
+static void hud_draw(void) {
+    char line1[48];
+    char line2[48];
+
+    snprintf(line1, sizeof(line1), "%u fps  %u rects  %uK px",
+             frame_stats.fps, frame_stats.dirty_rects,
+             frame_stats.dirty_pixels / 1024);
+    snprintf(line2, sizeof(line2), "comp %u us  flush %u us",
+             frame_stats.compose_us, frame_stats.flush_us);
+
+    int w1 = xgui_display_text_width(line1);
+    int w2 = xgui_display_text_width(line2);
+    int w = ((w1 > w2) ? w1 : w2) + 8;
+    int h = 2 * XGUI_FONT_HEIGHT + 10;
+    int x = display.width - w - 4;
+
+    xgui_display_rect_filled(x, 4, w, h, XGUI_BLACK);
+    xgui_display_text(x + 4, 8, line1, XGUI_RGB(0, 255, 0), XGUI_BLACK);
+    xgui_display_text(x + 4, 8 + XGUI_FONT_HEIGHT + 2, line2,
+                      XGUI_RGB(0, 255, 0), XGUI_BLACK);
+}
+
+/*
+ * Per-frame bookkeeping run after the flush copies finish
+ */
+static void frame_account(uint64_t flush_start) {
+    uint32_t dt = (uint32_t)(timer_us() - flush_start);
+    frame_stats.flush_us = dt;
+    if (dt > frame_stats.flush_us_max) {
+        frame_stats.flush_us_max = dt;
+    }
+    frame_stats.frames++;
+
+    fps_window_frames++;
+    if (fps_window_start == 0) {
+        fps_window_start = flush_start;
+    } else if (flush_start - fps_window_start >= 1000000) {
+        frame_stats.fps = fps_window_frames;
+        fps_window_frames = 0;
+        fps_window_start = flush_start;
+    }
 }
 
 /*
- * Flush dirty lines to framebuffer
+ * Flush dirty rectangles to framebuffer
  */
 void xgui_display_flush(void) {
     if (!display.initialized) return;
 
-    if (display.bytes_per_pixel == 3) {
-        for (int y = 0; y < display.height; y++) {
-            if (display.dirty_lines[y]) {
-                flush_line_24bpp(y);
-                display.dirty_lines[y] = false;
-            }
+    TRACE(TRACE_CAT_GUI, TRACE_EV_GUI_FLUSH,
+          display.dirty_rect_count, display.all_dirty);
+
+    uint64_t flush_start = timer_us();
+
+    /* Everything since frame_begin was composition */
+    if (frame_begin_us != 0) {
+        uint32_t cus = (uint32_t)(flush_start - frame_begin_us);
+        frame_stats.compose_us = cus;
+        if (cus > frame_stats.compose_us_max) {
+            frame_stats.compose_us_max = cus;
         }
-        return;
+        frame_begin_us = 0;
     }
 
-    for (int y = 0; y < display.height; y++) {
-        if (display.dirty_lines[y]) {
-            uint32_t* src = &display.backbuffer[y * display.width];
-            uint32_t* dst = (uint32_t*)(display.framebuffer + (uint32_t)y * (uint32_t)display.pitch);
-            for (int x = 0; x < display.width; x++) {
-                dst[x] = backbuf_to_fb32(src[x]);
-            }
-            display.dirty_lines[y] = false;
+    /* Record this frame's damage before the HUD adds its own rect */
+    if (display.all_dirty) {
+        frame_stats.dirty_pixels = (uint32_t)(display.width * display.height);
+        frame_stats.dirty_rects = 1;
+    } else {
+        uint32_t px = 0;
+        for (int i = 0; i < display.dirty_rect_count; i++) {
+            xgui_rect_t* r = &display.dirty_rects[i];
+            px += (uint32_t)((r->x2 - r->x1) * (r->y2 - r->y1));
         }
+        frame_stats.dirty_pixels = px;
+        frame_stats.dirty_rects = (uint32_t)display.dirty_rect_count;
     }
+
+    if (hud_enabled) {
+        hud_draw();
+    }
+
+    /* The flush overwrites any cursor overlay; drop the stale patch
+     * so the next cursor_show doesn't restore old pixels */
+    cursor.visible = false;
+
+    if (display.all_dirty) {
+        xgui_display_flush_all();
+    } else {
+        for (int i = 0; i < display.dirty_rect_count; i++) {
+            xgui_rect_t* r = &display.dirty_rects[i];
+            flush_rect(r->x1, r->y1, r->x2, r->y2);
+        }
+        display.dirty_rect_count = 0;
+    }
+
+    frame_account(flush_start);
 }
 
 /*
@@ -652,22 +1100,29 @@ void xgui_display_fb_pixel(int x, int y, uint32_t color) {
  */
 void xgui_display_flush_lines(int y_start, int y_end) {
     if (!display.initialized) return;
+    cursor.visible = false;
     if (y_start < 0) y_start = 0;
     if (y_end > display.height) y_end = display.height;
+    if (y_start >= y_end) return;
 
-    if (display.bytes_per_pixel == 3) {
-        for (int y = y_start; y < y_end; y++) {
-            flush_line_24bpp(y);
-        }
-    } else {
-        for (int y = y_start; y < y_end; y++) {
-            uint32_t* src = &display.backbuffer[y * display.width];
-            uint32_t* dst = (uint32_t*)(display.framebuffer + (uint32_t)y * (uint32_t)display.pitch);
-            for (int x = 0; x < display.width; x++) {
-                dst[x] = backbuf_to_fb32(src[x]);
-            }
-        }
-    }
+    flush_rect(0, y_start, display.width, y_end);
+}
+
+/*
+ * Flush one rectangle from backbuffer to framebuffer.
+ * Used to erase the cursor overlay without touching whole rows.
+ */
+void xgui_display_flush_rect(int x, int y, int w, int h) {
+    if (!display.initialized) return;
+    cursor.visible = false;
+
+    int x1 = (x < 0) ? 0 : x;
+    int y1 = (y < 0) ? 0 : y;
+    int x2 = (x + w > display.width) ? display.width : x + w;
+    int y2 = (y + h > display.height) ? display.height : y + h;
+    if (x1 >= x2 || y1 >= y2) return;
+
+    flush_rect(x1, y1, x2, y2);
 }
 
 /*
@@ -675,21 +1130,9 @@ void xgui_display_flush_lines(int y_start, int y_end) {
  */
 void xgui_display_flush_all(void) {
     if (!display.initialized) return;
+    cursor.visible = false;
 
-    if (display.bytes_per_pixel == 3) {
-        for (int y = 0; y < display.height; y++) {
-            flush_line_24bpp(y);
-            display.dirty_lines[y] = false;
-        }
-        return;
-    }
-
-    for (int y = 0; y < display.height; y++) {
-        uint32_t* src = &display.backbuffer[y * display.width];
-        uint32_t* dst = (uint32_t*)(display.framebuffer + (uint32_t)y * (uint32_t)display.pitch);
-        for (int x = 0; x < display.width; x++) {
-            dst[x] = backbuf_to_fb32(src[x]);
-        }
-        display.dirty_lines[y] = false;
-    }
+    flush_rect(0, 0, display.width, display.height);
+    display.dirty_rect_count = 0;
+    display.all_dirty = false;
 }
@@ -15,18 +15,26 @@ static xgui_event_t event_queue[XGUI_EVENT_QUEUE_SIZE];
 static int queue_head = 0;
 static int queue_tail = 0;
 static int queue_count = 0;
+static uint32_t queue_dropped = 0;  /* Events lost to queue overflow */
 
 /* Previous mouse state for detecting changes */
 static int prev_mouse_x = 0;
 static int prev_mouse_y = 0;
 static uint8_t prev_mouse_buttons = 0;
 
-/* Double-click detection */
-static uint32_t last_click_time = 0;
-static int last_click_x = 0;
-static int last_click_y = 0;
-#define DOUBLE_CLICK_TIME 500   /* ms */
-#define DOUBLE_CLICK_DIST 5     /* pixels */
+/* Click-chain and drag gesture detection. Presses within the time and
+ * distance window grow the chain (1 = single, 2 = double, ...); every
+ * mouse event carries the count, so apps read it off the event instead
+ * of re-timing clicks themselves. */
+static uint64_t last_press_us = 0;
+static int last_press_x = 0;
+static int last_press_y = 0;
+static uint8_t click_chain = 0;
+static bool drag_armed = false;     /* Left button down, no DRAGSTART yet */
+static bool drag_active = false;    /* DRAGSTART delivered for this hold */
+#define DOUBLE_CLICK_TIME_US 500000 /* 500 ms */
+#define DOUBLE_CLICK_DIST 5         /* pixels */
+#define DRAG_START_DIST 5           /* pixels of travel before a drag begins */
 
 /*
  * Initialize the event system
@@ -35,25 +43,47 @@ void xgui_event_init(void) {
     queue_head = 0;
     queue_tail = 0;
     queue_count = 0;
-    
+    queue_dropped = 0;
+
     prev_mouse_x = 0;
     prev_mouse_y = 0;
     prev_mouse_buttons = 0;
-    
-    last_click_time = 0;
-    last_click_x = 0;
-    last_click_y = 0;
+
+    last_press_us = 0;
+    last_press_x = 0;
+    last_press_y = 0;
+    click_chain = 0;
+    drag_armed = false;
+    drag_active = false;
 }
 
 /*
  * Push an event onto the queue
  */
 bool xgui_event_push(xgui_event_t* event) {
+    /* Coalesce consecutive mouse moves: fold this motion into the last
+     * queued event, accumulating the deltas, so fast motion costs one
+     * event per frame instead of one per PS/2 packet */
+    if (event->type == XGUI_EVENT_MOUSE_MOVE && queue_count > 0) {
+        int last_idx = (queue_tail + XGUI_EVENT_QUEUE_SIZE - 1) % XGUI_EVENT_QUEUE_SIZE;
+        xgui_event_t* last = &event_queue[last_idx];
+        if (last->type == XGUI_EVENT_MOUSE_MOVE) {
+            int dx = last->mouse.dx + event->mouse.dx;
+            int dy = last->mouse.dy + event->mouse.dy;
+            last->mouse = event->mouse;
+            last->mouse.dx = dx;
+            last->mouse.dy = dy;
+            last->timestamp = timer_us();
+            return true;
+        }
+    }
+
     if (queue_count >= XGUI_EVENT_QUEUE_SIZE) {
+        queue_dropped++;
         return false;  /* Queue full */
     }
-    
-    event->timestamp = timer_get_ticks();
+
+    event->timestamp = timer_us();
     event_queue[queue_tail] = *event;
     queue_tail = (queue_tail + 1) % XGUI_EVENT_QUEUE_SIZE;
     queue_count++;
@@ -87,6 +117,28 @@ bool xgui_event_poll(xgui_event_t* event) {
     return event_pop(event);
 }
 
+/*
+ * Drain up to max_events pending events into the caller's array.
+ * Processes input once for the whole batch, so a frame pays a bounded
+ * cost no matter how many packets arrived since the last frame.
+ */
+int xgui_event_poll_batch(xgui_event_t* events, int max_events) {
+    xgui_event_process_input();
+
+    int count = 0;
+    while (count < max_events && event_pop(&events[count])) {
+        count++;
+    }
+    return count;
+}
+
+/*
+ * Get the number of events dropped due to queue overflow
+ */
+uint32_t xgui_event_dropped(void) {
+    return queue_dropped;
+}
+
 /*
  * Wait for the next event (blocking)
  */
@@ -172,9 +224,33 @@ static void process_mouse_input(void) {
         event.mouse.modifiers = mods;
         
         xgui_event_push(&event);
-        
+
         prev_mouse_x = state->x;
         prev_mouse_y = state->y;
+
+        /* A held left button that travels far enough becomes a drag:
+         * deliver one DRAGSTART carrying the press origin, and break
+         * the click chain so the release is not double-click fodder */
+        if (drag_armed && !drag_active && (state->buttons & 1)) {
+            int tx = state->x - last_press_x;
+            int ty = state->y - last_press_y;
+            if (tx < 0) tx = -tx;
+            if (ty < 0) ty = -ty;
+            if (tx >= DRAG_START_DIST || ty >= DRAG_START_DIST) {
+                memset(&event, 0, sizeof(event));
+                event.type = XGUI_EVENT_MOUSE_DRAGSTART;
+                event.mouse.x = last_press_x;
+                event.mouse.y = last_press_y;
+                event.mouse.dx = state->x - last_press_x;
+                event.mouse.dy = state->y - last_press_y;
+                event.mouse.button = 1;
+                event.mouse.buttons = state->buttons;
+                event.mouse.modifiers = mods;
+                xgui_event_push(&event);
+                drag_active = true;
+                click_chain = 0;
+            }
+        }
     }
     
     /* Check for button changes */
@@ -190,11 +266,34 @@ static void process_mouse_input(void) {
                 if (state->buttons & mask) {
                     /* Button pressed */
                     event.type = XGUI_EVENT_MOUSE_DOWN;
+
+                    if (mask == 1) {
+                        /* Grow or restart the click chain */
+                        uint64_t now = timer_us();
+                        int dx = state->x - last_press_x;
+                        int dy = state->y - last_press_y;
+                        if (dx < 0) dx = -dx;
+                        if (dy < 0) dy = -dy;
+
+                        if (click_chain > 0 &&
+                            (now - last_press_us) < DOUBLE_CLICK_TIME_US &&
+                            dx < DOUBLE_CLICK_DIST && dy < DOUBLE_CLICK_DIST) {
+                            click_chain++;
+                        } else {
+                            click_chain = 1;
+                        }
+                        last_press_us = now;
+                        last_press_x = state->x;
+                        last_press_y = state->y;
+                        drag_armed = true;
+                        drag_active = false;
+                    }
                 } else {
                     /* Button released */
                     event.type = XGUI_EVENT_MOUSE_UP;
-                    
-                    /* Generate click event */
+
+                    /* Deliver the click with its chain count (0 when
+                     * this hold turned into a drag) */
                     xgui_event_t click_event;
                     memset(&click_event, 0, sizeof(click_event));
                     click_event.type = XGUI_EVENT_MOUSE_CLICK;
@@ -203,41 +302,35 @@ static void process_mouse_input(void) {
                     click_event.mouse.button = mask;
                     click_event.mouse.buttons = state->buttons;
                     click_event.mouse.modifiers = mods;
+                    click_event.mouse.click_count = (mask == 1) ? click_chain : 1;
                     xgui_event_push(&click_event);
-                    
-                    /* Check for double-click */
-                    uint32_t now = timer_get_ticks();
-                    int dx = state->x - last_click_x;
-                    int dy = state->y - last_click_y;
-                    if (dx < 0) dx = -dx;
-                    if (dy < 0) dy = -dy;
-                    
-                    if ((now - last_click_time) < DOUBLE_CLICK_TIME &&
-                        dx < DOUBLE_CLICK_DIST && dy < DOUBLE_CLICK_DIST) {
-                        xgui_event_t dbl_event;
-                        memset(&dbl_event, 0, sizeof(dbl_event));
-                        dbl_event.type = XGUI_EVENT_MOUSE_DBLCLICK;
-                        dbl_event.mouse.x = state->x;
-                        dbl_event.mouse.y = state->y;
-                        dbl_event.mouse.button = mask;
-                        dbl_event.mouse.buttons = state->buttons;
-                        dbl_event.mouse.modifiers = mods;
-                        xgui_event_push(&dbl_event);
-                        
-                        last_click_time = 0;  /* Reset to prevent triple-click */
-                    } else {
-                        last_click_time = now;
-                        last_click_x = state->x;
-                        last_click_y = state->y;
+
+                    if (mask == 1) {
+                        /* Second click in the chain is the double-click */
+                        if (click_chain == 2) {
+                            xgui_event_t dbl_event;
+                            memset(&dbl_event, 0, sizeof(dbl_event));
+                            dbl_event.type = XGUI_EVENT_MOUSE_DBLCLICK;
+                            dbl_event.mouse.x = state->x;
+                            dbl_event.mouse.y = state->y;
+                            dbl_event.mouse.button = mask;
+                            dbl_event.mouse.buttons = state->buttons;
+                            dbl_event.mouse.modifiers = mods;
+                            dbl_event.mouse.click_count = 2;
+                            xgui_event_push(&dbl_event);
+                        }
+                        drag_armed = false;
+                        drag_active = false;
                     }
                 }
-                
+
                 event.mouse.x = state->x;
                 event.mouse.y = state->y;
                 event.mouse.button = mask;
                 event.mouse.buttons = state->buttons;
                 event.mouse.modifiers = mods;
-                
+                event.mouse.click_count = (mask == 1) ? click_chain : 1;
+
                 xgui_event_push(&event);
             }
         }
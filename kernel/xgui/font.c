@@ -343,6 +343,123 @@ const uint8_t* xgui_font_get_glyph(char c) {
     return font_tables[current_font][uc - 32];
 }
 
+/*
+ * Glyph tile cache: pre-expanded 32bpp tiles keyed by
+ * (font, char, fg, bg). A terminal full of text reuses a handful of
+ * color pairs, so expansion from the 1bpp bitmap happens once per
+ * glyph instead of once per draw. Two-way set associative: a tile
+ * lives in slot hash or hash^1, the older of the two is evicted.
+ */
+#define GLYPH_TILE_CACHE_SIZE 128   /* Must be a power of 2 */
+
+typedef struct {
+    bool valid;
+    uint8_t font;
+    uint8_t ch;
+    uint32_t fg;
+    uint32_t bg;
+    uint32_t stamp;
+    uint32_t tile[XGUI_FONT_WIDTH * XGUI_FONT_HEIGHT];
+} glyph_tile_t;
+
+static glyph_tile_t tile_cache[GLYPH_TILE_CACHE_SIZE];
+static uint32_t tile_stamp = 0;
+
+/*
+ * Row expansion tables: map a glyph row byte straight to its 8 packed
+ * 32bpp pixels for one (fg, bg) pair. Built on demand (256 x 8 stores,
+ * once per color pair) and shared across glyphs, so a tile-cache miss
+ * costs one table load and one 32-byte copy per row instead of eight
+ * bit tests. A handful of color pairs covers a full terminal frame.
+ */
+#define ROW_TABLE_COUNT 4
+
+typedef struct {
+    bool valid;
+    uint32_t fg;
+    uint32_t bg;
+    uint32_t stamp;
+    uint32_t pixels[256][XGUI_FONT_WIDTH];
+} row_table_t;
+
+static row_table_t row_tables[ROW_TABLE_COUNT];
+static uint32_t row_table_stamp = 0;
+
+static const uint32_t* row_table_get(uint32_t fg, uint32_t bg) {
+    row_table_t* victim = &row_tables[0];
+
+    for (int i = 0; i < ROW_TABLE_COUNT; i++) {
+        row_table_t* t = &row_tables[i];
+        if (t->valid && t->fg == fg && t->bg == bg) {
+            t->stamp = ++row_table_stamp;
+            return &t->pixels[0][0];
+        }
+        if (victim->valid && (!t->valid || t->stamp < victim->stamp)) {
+            victim = t;
+        }
+    }
+
+    /* Miss: build the table for this color pair */
+    for (int b = 0; b < 256; b++) {
+        for (int col = 0; col < XGUI_FONT_WIDTH; col++) {
+            victim->pixels[b][col] = (b & (0x80 >> col)) ? fg : bg;
+        }
+    }
+    victim->valid = true;
+    victim->fg = fg;
+    victim->bg = bg;
+    victim->stamp = ++row_table_stamp;
+    return &victim->pixels[0][0];
+}
+
+const uint32_t* xgui_font_tile(char c, uint32_t fg, uint32_t bg) {
+    unsigned char uc = (unsigned char)c;
+    if (uc < 32 || uc > 127) {
+        uc = '?';
+    }
+
+    uint32_t h = ((uint32_t)current_font * 131 + uc) * 131 + fg;
+    h = h * 131 + bg;
+    uint32_t idx = h & (GLYPH_TILE_CACHE_SIZE - 1);
+
+    glyph_tile_t* e = &tile_cache[idx];
+    glyph_tile_t* alt = &tile_cache[idx ^ 1];
+
+    if (e->valid && e->font == (uint8_t)current_font && e->ch == uc &&
+        e->fg == fg && e->bg == bg) {
+        e->stamp = ++tile_stamp;
+        return e->tile;
+    }
+    if (alt->valid && alt->font == (uint8_t)current_font && alt->ch == uc &&
+        alt->fg == fg && alt->bg == bg) {
+        alt->stamp = ++tile_stamp;
+        return alt->tile;
+    }
+
+    /* Miss: expand into the invalid or least recently used way */
+    glyph_tile_t* victim = e;
+    if (e->valid && (!alt->valid || alt->stamp < e->stamp)) {
+        victim = alt;
+    }
+
+    const uint8_t* glyph = font_tables[current_font][uc - 32];
+    const uint32_t* rows = row_table_get(fg, bg);
+    uint32_t* t = victim->tile;
+    for (int row = 0; row < XGUI_FONT_HEIGHT; row++) {
+        memcpy(t, &rows[(uint32_t)glyph[row] * XGUI_FONT_WIDTH],
+               XGUI_FONT_WIDTH * sizeof(uint32_t));
+        t += XGUI_FONT_WIDTH;
+    }
+
+    victim->valid = true;
+    victim->font = (uint8_t)current_font;
+    victim->ch = uc;
+    victim->fg = fg;
+    victim->bg = bg;
+    victim->stamp = ++tile_stamp;
+    return victim->tile;
+}
+
 /*
  * Set the active font by ID
  */
@@ -0,0 +1,105 @@
+/*
+ * MiniOS XGUI Sprite Scene
+ *
+ * Background save/restore for apps that animate a few sprites over a
+ * static scene. See sprite.h for the protocol; skigame.c and
+ * flappycat.c are the reference users.
+ */
+
+#include "xgui/sprite.h"
+#include "xgui/display.h"
+#include "heap.h"
+#include "string.h"
+
+/*
+ * Clip a rect to the window buffer; returns false if nothing is left
+ */
+static bool clip_rect(xgui_sprite_scene_t* scene, int* x, int* y, int* w, int* h) {
+    if (*x < 0) { *w += *x; *x = 0; }
+    if (*y < 0) { *h += *y; *y = 0; }
+    if (*x + *w > scene->width)  *w = scene->width - *x;
+    if (*y + *h > scene->height) *h = scene->height - *y;
+    return *w > 0 && *h > 0;
+}
+
+/*
+ * Mark a buffer-relative rect dirty on screen
+ */
+static void mark_screen(xgui_sprite_scene_t* scene, int x, int y, int w, int h) {
+    xgui_window_t* win = scene->window;
+    xgui_display_mark_dirty_rect(win->x + win->client_x + x,
+                                 win->y + win->client_y + y, w, h);
+}
+
+int xgui_sprite_scene_init(xgui_sprite_scene_t* scene, xgui_window_t* win) {
+    scene->window = win;
+    scene->width = win->buf_width;
+    scene->height = win->buf_height;
+    scene->rect_count = 0;
+    scene->background = (uint32_t*)kmalloc((uint32_t)scene->width *
+                                           (uint32_t)scene->height *
+                                           sizeof(uint32_t));
+    return scene->background ? 0 : -1;
+}
+
+void xgui_sprite_scene_free(xgui_sprite_scene_t* scene) {
+    if (scene->background) {
+        kfree(scene->background);
+        scene->background = NULL;
+    }
+    scene->window = NULL;
+    scene->rect_count = 0;
+}
+
+void xgui_sprite_capture(xgui_sprite_scene_t* scene) {
+    if (!scene->background || !scene->window->buffer) return;
+    memcpy(scene->background, scene->window->buffer,
+           (uint32_t)scene->width * (uint32_t)scene->height * sizeof(uint32_t));
+    scene->rect_count = 0;
+}
+
+void xgui_sprite_begin(xgui_sprite_scene_t* scene) {
+    uint32_t* buf = scene->window->buffer;
+    if (!scene->background || !buf) {
+        scene->rect_count = 0;
+        return;
+    }
+
+    for (int i = 0; i < scene->rect_count; i++) {
+        int x = scene->rects[i].x, y = scene->rects[i].y;
+        int w = scene->rects[i].w, h = scene->rects[i].h;
+
+        for (int row = 0; row < h; row++) {
+            int off = (y + row) * scene->width + x;
+            memcpy(&buf[off], &scene->background[off],
+                   (uint32_t)w * sizeof(uint32_t));
+        }
+        mark_screen(scene, x, y, w, h);
+    }
+    scene->rect_count = 0;
+}
+
+void xgui_sprite_mark(xgui_sprite_scene_t* scene, int x, int y, int w, int h) {
+    if (!clip_rect(scene, &x, &y, &w, &h)) return;
+
+    if (scene->rect_count < XGUI_SPRITE_MAX) {
+        scene->rects[scene->rect_count].x = x;
+        scene->rects[scene->rect_count].y = y;
+        scene->rects[scene->rect_count].w = w;
+        scene->rects[scene->rect_count].h = h;
+        scene->rect_count++;
+    } else {
+        /* Table full: widen the last rect so the restore still covers
+         * this sprite next frame */
+        int i = XGUI_SPRITE_MAX - 1;
+        int x2 = scene->rects[i].x + scene->rects[i].w;
+        int y2 = scene->rects[i].y + scene->rects[i].h;
+        if (x + w > x2) x2 = x + w;
+        if (y + h > y2) y2 = y + h;
+        if (x < scene->rects[i].x) scene->rects[i].x = x;
+        if (y < scene->rects[i].y) scene->rects[i].y = y;
+        scene->rects[i].w = x2 - scene->rects[i].x;
+        scene->rects[i].h = y2 - scene->rects[i].y;
+    }
+    mark_screen(scene, x, y, w, h);
+}
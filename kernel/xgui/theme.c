@@ -7,6 +7,7 @@
 #include "xgui/theme.h"
 #include "xgui/display.h"
 #include "xgui/desktop.h"
+#include "xgui/wm.h"
 #include "conf.h"
 #include "rtc.h"
 #include "serial.h"
@@ -20,6 +21,9 @@ static bool conf_ready = false;
 static xgui_theme_t current_theme;
 static xgui_theme_id_t current_id = XGUI_THEME_CLASSIC;
 
+/* Derived colors/gradients for current_theme (see xgui_theme_derived_t) */
+static xgui_theme_derived_t derived;
+
 /* Preset theme definitions */
 static const xgui_theme_t presets[XGUI_THEME_COUNT] = {
     /* Classic — matches the original hardcoded colors exactly */
@@ -182,6 +186,197 @@ static const char* theme_names[XGUI_THEME_COUNT] = {
     "Y2K",
 };
 
+/*
+ * Color arithmetic used only while (re)building the derived tables.
+ * The draw paths themselves just index the results.
+ */
+static uint32_t blend_color(uint32_t c1, uint32_t c2, int alpha) {
+    /* alpha 0..255: 0 = all c1, 255 = all c2 */
+    int r1 = XGUI_GET_R(c1), g1 = XGUI_GET_G(c1), b1 = XGUI_GET_B(c1);
+    int r2 = XGUI_GET_R(c2), g2 = XGUI_GET_G(c2), b2 = XGUI_GET_B(c2);
+    int r = r1 + ((r2 - r1) * alpha) / 255;
+    int g = g1 + ((g2 - g1) * alpha) / 255;
+    int b = b1 + ((b2 - b1) * alpha) / 255;
+    return XGUI_RGB(r, g, b);
+}
+
+static uint32_t lighten(uint32_t c, int amount) {
+    int r = XGUI_GET_R(c) + amount; if (r > 255) r = 255;
+    int g = XGUI_GET_G(c) + amount; if (g > 255) g = 255;
+    int b = XGUI_GET_B(c) + amount; if (b > 255) b = 255;
+    return XGUI_RGB(r, g, b);
+}
+
+static uint32_t darken(uint32_t c, int amount) {
+    int r = XGUI_GET_R(c) - amount; if (r < 0) r = 0;
+    int g = XGUI_GET_G(c) - amount; if (g < 0) g = 0;
+    int b = XGUI_GET_B(c) - amount; if (b < 0) b = 0;
+    return XGUI_RGB(r, g, b);
+}
+
+static bool is_dark_color(uint32_t c) {
+    int lum = XGUI_GET_R(c) * 299 + XGUI_GET_G(c) * 587 + XGUI_GET_B(c) * 114;
+    return lum < 128000;
+}
+
+/*
+ * Glossy title bar rows: bright highlight fading to base over the top
+ * half, base fading slightly darker over the bottom half.
+ */
+static void build_title_grad(uint32_t* rows, uint32_t title_base, int h) {
+    int br = (title_base >> 16) & 0xFF;
+    int bg = (title_base >> 8) & 0xFF;
+    int bb = title_base & 0xFF;
+
+    for (int row = 0; row < h; row++) {
+        int r, g, b;
+
+        if (row < h / 2) {
+            int t = (row * 255) / (h / 2);
+            int hi_r = br + (255 - br) * 6 / 10;
+            int hi_g = bg + (255 - bg) * 6 / 10;
+            int hi_b = bb + (255 - bb) * 6 / 10;
+            r = hi_r + ((br + 30) - hi_r) * t / 255;
+            g = hi_g + ((bg + 30) - hi_g) * t / 255;
+            b = hi_b + ((bb + 30) - hi_b) * t / 255;
+        } else {
+            int t = ((row - h / 2) * 255) / (h / 2);
+            r = br + 10 - (t * 30) / 255;
+            g = bg + 10 - (t * 30) / 255;
+            b = bb + 10 - (t * 30) / 255;
+        }
+
+        if (r > 255) r = 255;
+        if (r < 0) r = 0;
+        if (g > 255) g = 255;
+        if (g < 0) g = 0;
+        if (b > 255) b = 255;
+        if (b < 0) b = 0;
+
+        rows[row] = XGUI_RGB(r, g, b);
+    }
+}
+
+/*
+ * Glossy panel button rows: highlight to base over the top half, base
+ * to a darker shade over the bottom half, plus 1px edge colors.
+ */
+static void build_btn_grad(xgui_btn_grad_t* g, uint32_t base, bool pressed, int h) {
+    uint32_t top_color, mid_color, bot_color;
+    if (pressed) {
+        top_color = darken(base, 20);
+        mid_color = darken(base, 10);
+        bot_color = darken(base, 30);
+    } else {
+        top_color = lighten(base, 50);
+        mid_color = base;
+        bot_color = darken(base, 35);
+    }
+
+    int mid = h / 2;
+    for (int row = 0; row < mid; row++) {
+        g->rows[row] = blend_color(top_color, mid_color, (row * 255) / mid);
+    }
+    for (int row = mid; row < h; row++) {
+        g->rows[row] = blend_color(mid_color, bot_color, ((row - mid) * 255) / (h - mid));
+    }
+
+    g->border = darken(base, 50);
+    g->edge_top = pressed ? g->border : lighten(base, 70);
+    g->edge_left = pressed ? g->border : lighten(base, 30);
+}
+
+/*
+ * Rebuild every derived color and gradient from current_theme.
+ */
+void xgui_theme_rebuild_derived(void) {
+    const xgui_theme_t* t = &current_theme;
+    xgui_theme_derived_t* d = &derived;
+
+    /* --- Window frames --- */
+    d->border_inactive = blend_color(t->border, XGUI_RGB(180, 180, 180), 128);
+
+    int tb_h = XGUI_TITLE_HEIGHT - XGUI_BORDER_WIDTH;
+    if (tb_h > XGUI_THEME_GRAD_MAX) tb_h = XGUI_THEME_GRAD_MAX;
+    d->title_rows = tb_h;
+    build_title_grad(d->title_grad[0], t->title_inactive, tb_h);
+    build_title_grad(d->title_grad[1], t->title_active, tb_h);
+    d->title_gloss = XGUI_RGB(
+        XGUI_GET_R(t->title_active) + (255 - XGUI_GET_R(t->title_active)) * 7 / 10,
+        XGUI_GET_G(t->title_active) + (255 - XGUI_GET_G(t->title_active)) * 7 / 10,
+        XGUI_GET_B(t->title_active) + (255 - XGUI_GET_B(t->title_active)) * 7 / 10);
+    d->title_sep[0] = blend_color(t->title_inactive, XGUI_BLACK, 60);
+    d->title_sep[1] = blend_color(t->title_active, XGUI_BLACK, 60);
+    d->title_shadow = blend_color(t->title_active, XGUI_BLACK, 180);
+
+    /* --- Taskbar panel --- */
+    uint32_t panel_bg = t->panel_bg;
+    bool panel_dark = is_dark_color(panel_bg);
+    int panel_h = XGUI_PANEL_HEIGHT;
+    if (panel_h > XGUI_THEME_GRAD_MAX) panel_h = XGUI_THEME_GRAD_MAX;
+    d->panel_rows = panel_h;
+    for (int row = 0; row < panel_h; row++) {
+        int pt = (row * 255) / XGUI_PANEL_HEIGHT;
+        d->panel_grad[row] = blend_color(lighten(panel_bg, 15), darken(panel_bg, 15), pt);
+    }
+    d->panel_highlight = panel_dark ? lighten(panel_bg, 40) : lighten(panel_bg, 30);
+    d->panel_text = panel_dark ? XGUI_WHITE : XGUI_BLACK;
+    d->panel_text_dim = blend_color(d->panel_text, panel_bg, 100);
+    d->panel_sep = panel_dark ? lighten(panel_bg, 30) : darken(panel_bg, 30);
+    d->nav_text_dim = blend_color(d->panel_text, panel_bg, 150);
+    d->task_min_border = panel_dark ? lighten(panel_bg, 20) : darken(panel_bg, 20);
+
+    uint32_t accent = t->selection;
+    d->accent_text = is_dark_color(accent) ? XGUI_WHITE : XGUI_BLACK;
+
+    int btn_h = XGUI_PANEL_HEIGHT - 8;
+    d->btn_rows = btn_h;
+    build_btn_grad(&d->btn[XGUI_BTN_ACCENT], accent, false, btn_h);
+    build_btn_grad(&d->btn[XGUI_BTN_ACCENT_PRESSED], accent, true, btn_h);
+    build_btn_grad(&d->btn[XGUI_BTN_TASK_FOCUSED],
+                   lighten(panel_bg, panel_dark ? 30 : -15), false, btn_h);
+    build_btn_grad(&d->btn[XGUI_BTN_TASK],
+                   lighten(panel_bg, panel_dark ? 15 : -8), false, btn_h);
+    build_btn_grad(&d->btn[XGUI_BTN_NAV],
+                   lighten(panel_bg, panel_dark ? 20 : -10), false, btn_h);
+
+    /* --- Start menu --- */
+    uint32_t menu_bg = t->window_bg;
+    bool dark = is_dark_color(menu_bg);
+    uint32_t hover_bg = is_dark_color(accent) ? lighten(accent, 15) : accent;
+    uint32_t right_bg = dark ? lighten(menu_bg, 12) : darken(menu_bg, 12);
+
+    d->menu.hover_top = lighten(hover_bg, 30);
+    d->menu.hover_bot = darken(hover_bg, 5);
+    d->menu.hover_hi = lighten(hover_bg, 50);
+    d->menu.banner_top = lighten(accent, 25);
+    d->menu.banner_bot = darken(accent, 15);
+    d->menu.banner_hi = lighten(accent, 50);
+    d->menu.banner_text = d->accent_text;
+    d->menu.left_top = dark ? menu_bg : XGUI_WHITE;
+    d->menu.left_bot = dark ? lighten(menu_bg, 8) : XGUI_RGB(245, 245, 245);
+    d->menu.left_text = dark ? XGUI_WHITE : XGUI_RGB(20, 20, 20);
+    d->menu.right_top = right_bg;
+    d->menu.right_bot = darken(right_bg, 5);
+    d->menu.right_text = dark ? XGUI_RGB(220, 220, 220) : XGUI_RGB(40, 40, 40);
+    d->menu.header_text = dark ? XGUI_RGB(180, 200, 255) : XGUI_RGB(60, 80, 140);
+    d->menu.bottom_top = darken(accent, 10);
+    d->menu.bottom_bot = darken(accent, 30);
+    d->menu.bottom_hi = lighten(accent, 20);
+    d->menu.div_dark = dark ? lighten(menu_bg, 20) : darken(menu_bg, 30);
+    d->menu.div_light = dark ? lighten(menu_bg, 40) : lighten(menu_bg, 10);
+    d->menu.left_sep = dark ? lighten(menu_bg, 20) : XGUI_RGB(210, 210, 210);
+    d->menu.border_light = dark ? lighten(menu_bg, 40) : darken(menu_bg, 15);
+    d->menu.border_dark = dark ? lighten(menu_bg, 15) : darken(menu_bg, 50);
+}
+
+/*
+ * Get the precomputed derived colors/gradients for the current theme
+ */
+const xgui_theme_derived_t* xgui_theme_derived(void) {
+    return &derived;
+}
+
 /*
  * Initialize theme system — load saved config or apply Classic
  */
@@ -252,6 +447,8 @@ void xgui_theme_init(void) {
             serial_write_string("THEME: created default config\n");
         }
     }
+
+    xgui_theme_rebuild_derived();
 }
 
 /*
@@ -275,6 +472,7 @@ void xgui_theme_apply(xgui_theme_id_t id) {
     if (id >= XGUI_THEME_COUNT) return;
     current_theme = presets[id];
     current_id = id;
+    xgui_theme_rebuild_derived();
     xgui_desktop_set_color(current_theme.desktop_bg);
 
     /* Persist to config */
@@ -21,6 +21,9 @@ typedef struct {
 static widget_list_t widget_lists[XGUI_MAX_WINDOWS];
 static uint32_t next_widget_id = 1;
 
+/* Set by xgui_widgets_handle_event, read (and cleared) by the WM */
+static bool event_consumed = false;
+
 /*
  * Get or create widget list for a window
  */
@@ -191,6 +194,17 @@ void xgui_widget_destroy(xgui_widget_t* widget) {
     kfree(widget);
 }
 
+/*
+ * Mark one widget as needing repaint. The WM picks it up on the next
+ * frame via xgui_widgets_repaint() without clearing the whole window
+ * buffer or running the window's paint callback.
+ */
+void xgui_widget_invalidate(xgui_widget_t* widget) {
+    if (widget) {
+        widget->flags |= XGUI_WIDGET_DIRTY;
+    }
+}
+
 /*
  * Set widget text
  */
@@ -198,6 +212,15 @@ void xgui_widget_set_text(xgui_widget_t* widget, const char* text) {
     if (widget) {
         strncpy(widget->text, text, sizeof(widget->text) - 1);
         widget->text[sizeof(widget->text) - 1] = '\0';
+        /* Labels size to their text: grow so the repaint erase always
+         * covers the longest text this label has shown */
+        if (widget->type == XGUI_WIDGET_LABEL) {
+            int w = xgui_display_text_width(widget->text);
+            if (w > widget->width) {
+                widget->width = w;
+            }
+        }
+        xgui_widget_invalidate(widget);
     }
 }
 
@@ -215,6 +238,9 @@ void xgui_widget_set_position(xgui_widget_t* widget, int x, int y) {
     if (widget) {
         widget->x = x;
         widget->y = y;
+        /* The old location needs its background restored, which only
+         * the window's paint callback can do */
+        xgui_window_invalidate(widget->parent);
     }
 }
 
@@ -225,6 +251,7 @@ void xgui_widget_set_size(xgui_widget_t* widget, int width, int height) {
     if (widget) {
         widget->width = width;
         widget->height = height;
+        xgui_window_invalidate(widget->parent);
     }
 }
 
@@ -238,6 +265,7 @@ void xgui_widget_set_enabled(xgui_widget_t* widget, bool enabled) {
         } else {
             widget->flags &= ~XGUI_WIDGET_ENABLED;
         }
+        xgui_widget_invalidate(widget);
     }
 }
 
@@ -248,8 +276,11 @@ void xgui_widget_set_visible(xgui_widget_t* widget, bool visible) {
     if (widget) {
         if (visible) {
             widget->flags |= XGUI_WIDGET_VISIBLE;
+            xgui_widget_invalidate(widget);
         } else {
             widget->flags &= ~XGUI_WIDGET_VISIBLE;
+            /* Hiding exposes background only the paint callback knows */
+            xgui_window_invalidate(widget->parent);
         }
     }
 }
@@ -432,10 +463,53 @@ void xgui_widget_draw(xgui_widget_t* widget) {
 void xgui_widgets_draw(xgui_window_t* window) {
     widget_list_t* list = get_widget_list(window);
     if (!list) return;
-    
+
+    for (xgui_widget_t* w = list->widgets; w; w = w->next) {
+        xgui_widget_draw(w);
+        w->flags &= ~XGUI_WIDGET_DIRTY;
+    }
+}
+
+/*
+ * Repaint just the widgets marked dirty since the last frame. Each one
+ * has its rectangle erased to the window background, is redrawn, and
+ * feeds its screen-space bounds to the display dirty-rect list - the
+ * rest of the window buffer is left untouched.
+ */
+bool xgui_widgets_repaint(xgui_window_t* window) {
+    widget_list_t* list = get_widget_list(window);
+    if (!list) return false;
+
+    bool repainted = false;
     for (xgui_widget_t* w = list->widgets; w; w = w->next) {
+        if (!(w->flags & XGUI_WIDGET_DIRTY)) continue;
+        w->flags &= ~XGUI_WIDGET_DIRTY;
+
+        xgui_win_rect_filled(window, w->x, w->y, w->width, w->height,
+                             window->bg_color);
         xgui_widget_draw(w);
+
+        xgui_display_mark_dirty_rect(window->x + window->client_x + w->x,
+                                     window->y + window->client_y + w->y,
+                                     w->width, w->height);
+        repainted = true;
+    }
+    return repainted;
+}
+
+/*
+ * True if any widget in the window is marked dirty
+ */
+bool xgui_widgets_any_dirty(xgui_window_t* window) {
+    widget_list_t* list = get_widget_list(window);
+    if (!list) return false;
+
+    for (xgui_widget_t* w = list->widgets; w; w = w->next) {
+        if (w->flags & XGUI_WIDGET_DIRTY) {
+            return true;
+        }
     }
+    return false;
 }
 
 /*
@@ -468,11 +542,13 @@ void xgui_widget_focus(xgui_widget_t* widget) {
     /* Remove focus from previous */
     if (list->focused && list->focused != widget) {
         list->focused->flags &= ~XGUI_WIDGET_FOCUSED;
+        xgui_widget_invalidate(list->focused);
     }
-    
+
     /* Focus new widget */
     widget->flags |= XGUI_WIDGET_FOCUSED;
     list->focused = widget;
+    xgui_widget_invalidate(widget);
 }
 
 /*
@@ -532,7 +608,7 @@ static bool handle_textfield_key(xgui_widget_t* widget, xgui_event_t* event) {
 /*
  * Handle event for widgets
  */
-bool xgui_widgets_handle_event(xgui_window_t* window, xgui_event_t* event) {
+static bool widgets_handle_event_inner(xgui_window_t* window, xgui_event_t* event) {
     widget_list_t* list = get_widget_list(window);
     if (!list) return false;
     
@@ -545,10 +621,12 @@ bool xgui_widgets_handle_event(xgui_window_t* window, xgui_event_t* event) {
                 
                 if (widget->type == XGUI_WIDGET_BUTTON) {
                     widget->button.pressed = true;
+                    xgui_widget_invalidate(widget);
                     return true;
                 }
                 if (widget->type == XGUI_WIDGET_CHECKBOX) {
                     widget->checkbox.checked = !widget->checkbox.checked;
+                    xgui_widget_invalidate(widget);
                     if (widget->on_click) {
                         widget->on_click(widget);
                     }
@@ -562,6 +640,7 @@ bool xgui_widgets_handle_event(xgui_window_t* window, xgui_event_t* event) {
                     if (pos < 0) pos = 0;
                     if (pos > len) pos = len;
                     widget->textfield.cursor_pos = pos;
+                    xgui_widget_invalidate(widget);
                     return true;
                 }
             }
@@ -573,7 +652,8 @@ bool xgui_widgets_handle_event(xgui_window_t* window, xgui_event_t* event) {
             for (xgui_widget_t* w = list->widgets; w; w = w->next) {
                 if (w->type == XGUI_WIDGET_BUTTON && w->button.pressed) {
                     w->button.pressed = false;
-                    
+                    xgui_widget_invalidate(w);
+
                     /* Check if still over button */
                     if (event->mouse.x >= w->x && event->mouse.x < w->x + w->width &&
                         event->mouse.y >= w->y && event->mouse.y < w->y + w->height) {
@@ -590,18 +670,39 @@ bool xgui_widgets_handle_event(xgui_window_t* window, xgui_event_t* event) {
         case XGUI_EVENT_KEY_DOWN:
         case XGUI_EVENT_KEY_CHAR: {
             if (list->focused && list->focused->type == XGUI_WIDGET_TEXTFIELD) {
-                return handle_textfield_key(list->focused, event);
+                if (handle_textfield_key(list->focused, event)) {
+                    xgui_widget_invalidate(list->focused);
+                    return true;
+                }
+                return false;
             }
             break;
         }
-        
+
         default:
             break;
     }
-    
+
     return false;
 }
 
+bool xgui_widgets_handle_event(xgui_window_t* window, xgui_event_t* event) {
+    event_consumed = widgets_handle_event_inner(window, event);
+    return event_consumed;
+}
+
+/*
+ * True if the last xgui_widgets_handle_event() call consumed its
+ * event; reading clears the flag. The WM checks this after an event
+ * handler returns, so a click that only pressed a button triggers a
+ * widget-sized repaint instead of a full window clear and paint.
+ */
+bool xgui_widgets_event_consumed(void) {
+    bool consumed = event_consumed;
+    event_consumed = false;
+    return consumed;
+}
+
 /*
  * Get checkbox state
  */
@@ -618,5 +719,6 @@ bool xgui_checkbox_get_checked(xgui_widget_t* widget) {
 void xgui_checkbox_set_checked(xgui_widget_t* widget, bool checked) {
     if (widget && widget->type == XGUI_WIDGET_CHECKBOX) {
         widget->checkbox.checked = checked;
+        xgui_widget_invalidate(widget);
     }
 }
@@ -148,69 +148,32 @@ static void draw_decorations(xgui_window_t* win) {
     int tb_h = XGUI_TITLE_HEIGHT;
     
     bool active = (win->flags & XGUI_WINDOW_FOCUSED);
-    uint32_t title_base = active ? xgui_theme_current()->title_active
-                                 : xgui_theme_current()->title_inactive;
-    
+    const xgui_theme_derived_t* td = xgui_theme_derived();
+
     /* --- Outer border --- */
-    uint32_t brd = active ? xgui_theme_current()->border
-                          : wm_blend(xgui_theme_current()->border, XGUI_RGB(180, 180, 180), 128);
+    uint32_t brd = active ? xgui_theme_current()->border : td->border_inactive;
     xgui_display_rect(x, y, w, h, brd);
-    
-    /* --- Glossy title bar gradient --- */
+
+    /* --- Glossy title bar gradient (precomputed per theme) --- */
     int tb_x = x + bw;
     int tb_y = y + bw;
     int tb_w = w - bw * 2;
     int tb_real_h = tb_h - bw;
-    
-    /* Extract base color components */
-    int br = (title_base >> 16) & 0xFF;
-    int bg = (title_base >> 8) & 0xFF;
-    int bb = title_base & 0xFF;
-    
+    if (tb_real_h > td->title_rows) tb_real_h = td->title_rows;
+
+    const uint32_t* grad = td->title_grad[active ? 1 : 0];
     for (int row = 0; row < tb_real_h; row++) {
-        int r, g, b;
-        
-        if (row < tb_real_h / 2) {
-            /* Top half: lighter, glossy highlight */
-            int t = (row * 255) / (tb_real_h / 2);
-            /* Start very bright, blend toward base */
-            int hi_r = br + (255 - br) * 6 / 10;
-            int hi_g = bg + (255 - bg) * 6 / 10;
-            int hi_b = bb + (255 - bb) * 6 / 10;
-            r = hi_r + ((br + 30) - hi_r) * t / 255;
-            g = hi_g + ((bg + 30) - hi_g) * t / 255;
-            b = hi_b + ((bb + 30) - hi_b) * t / 255;
-        } else {
-            /* Bottom half: base to slightly darker */
-            int t = ((row - tb_real_h / 2) * 255) / (tb_real_h / 2);
-            r = br + 10 - (t * 30) / 255;
-            g = bg + 10 - (t * 30) / 255;
-            b = bb + 10 - (t * 30) / 255;
-        }
-        
-        if (r > 255) r = 255;
-        if (r < 0) r = 0;
-        if (g > 255) g = 255;
-        if (g < 0) g = 0;
-        if (b > 255) b = 255;
-        if (b < 0) b = 0;
-        
-        xgui_display_hline(tb_x, tb_y + row, tb_w, XGUI_RGB(r, g, b));
+        xgui_display_hline(tb_x, tb_y + row, tb_w, grad[row]);
     }
-    
+
     /* Glossy highlight line at very top */
     if (active) {
-        uint32_t hi = XGUI_RGB(
-            br + (255 - br) * 7 / 10,
-            bg + (255 - bg) * 7 / 10,
-            bb + (255 - bb) * 7 / 10
-        );
-        xgui_display_hline(tb_x, tb_y, tb_w, hi);
+        xgui_display_hline(tb_x, tb_y, tb_w, td->title_gloss);
     }
-    
+
     /* Subtle separator between title bar and client area */
     xgui_display_hline(tb_x, tb_y + tb_real_h - 1, tb_w,
-                       wm_blend(title_base, XGUI_BLACK, 60));
+                       td->title_sep[active ? 1 : 0]);
     
     /* --- Title text (centered with shadow) --- */
     int title_len = strlen(win->title);
@@ -221,8 +184,8 @@ static void draw_decorations(xgui_window_t* win) {
     
     /* Text shadow */
     if (active) {
-        uint32_t shadow = wm_blend(title_base, XGUI_BLACK, 180);
-        xgui_display_text_transparent(text_x + 1, text_y + 1, win->title, shadow);
+        xgui_display_text_transparent(text_x + 1, text_y + 1, win->title,
+                                      td->title_shadow);
     }
     /* Title text */
     uint32_t title_text = active ? XGUI_WHITE : XGUI_RGB(80, 80, 80);
@@ -479,7 +442,9 @@ void xgui_window_focus(xgui_window_t* win) {
     /* Remove focus from previous window */
     if (focused_window && focused_window != win) {
         focused_window->flags &= ~XGUI_WINDOW_FOCUSED;
-        
+        focused_window->expose = true;  /* Title bar goes inactive */
+
+
         /* Send blur event */
         xgui_event_t event;
         memset(&event, 0, sizeof(event));
@@ -493,8 +458,11 @@ void xgui_window_focus(xgui_window_t* win) {
     /* Focus new window */
     win->flags |= XGUI_WINDOW_FOCUSED;
     focused_window = win;
-    
-    /* Bring to top of z-order */
+
+    /* Bring to top of z-order. The raise and the title bar color
+     * change are decoration work: recomposite from the cached
+     * surfaces, no app repaint needed. */
+    win->expose = true;
     zorder_to_top(win);
     
     /* Send focus event */
@@ -710,8 +678,17 @@ void xgui_wm_dispatch_event(xgui_event_t* event) {
                     client_event.window_id = win->id;
                     client_event.mouse.x -= (win->x + win->client_x);
                     client_event.mouse.y -= (win->y + win->client_y);
+                    (void)xgui_widgets_event_consumed();  /* Clear stale flag */
                     win->handler(win, &client_event);
-                    win->dirty = true;
+                    /* A widget that consumed the click invalidated just
+                     * itself. Anything else only schedules a composite:
+                     * apps set win->dirty themselves when the click
+                     * actually changed their content, so the cached
+                     * surface stays valid and the paint callback is
+                     * not re-run for a plain raise or focus click */
+                    if (!xgui_widgets_event_consumed()) {
+                        win->expose = true;
+                    }
                 }
             }
             break;
@@ -736,12 +713,15 @@ void xgui_wm_dispatch_event(xgui_event_t* event) {
                 client_event.window_id = focused_window->id;
                 client_event.mouse.x -= (focused_window->x + focused_window->client_x);
                 client_event.mouse.y -= (focused_window->y + focused_window->client_y);
+                (void)xgui_widgets_event_consumed();  /* Clear stale flag */
                 focused_window->handler(focused_window, &client_event);
-                focused_window->dirty = true;
+                if (!xgui_widgets_event_consumed()) {
+                    focused_window->expose = true;
+                }
             }
             break;
         }
-        
+
         case XGUI_EVENT_MOUSE_MOVE: {
             if (dragging && drag_window) {
                 /* Move the window */
@@ -773,9 +753,12 @@ void xgui_wm_dispatch_event(xgui_event_t* event) {
                     }
                 }
 
-                /* Force redraw if hover state changed */
+                /* Hover change redraws decorations, which happens at
+                 * composite time - mark the affected windows so the
+                 * main loop schedules a frame */
                 if (hover_btn_win != old_hw || hover_btn_idx != old_hi) {
-                    /* Decorations are drawn during composite, so just mark dirty */
+                    if (old_hw) old_hw->expose = true;
+                    if (hover_btn_win) hover_btn_win->expose = true;
                 }
 
                 /* Pass to focused window */
@@ -797,8 +780,11 @@ void xgui_wm_dispatch_event(xgui_event_t* event) {
             if (focused_window && focused_window->handler) {
                 xgui_event_t key_event = *event;
                 key_event.window_id = focused_window->id;
+                (void)xgui_widgets_event_consumed();  /* Clear stale flag */
                 focused_window->handler(focused_window, &key_event);
-                focused_window->dirty = true;
+                if (!xgui_widgets_event_consumed()) {
+                    focused_window->expose = true;
+                }
             }
             break;
         }
@@ -813,23 +799,125 @@ void xgui_wm_dispatch_event(xgui_event_t* event) {
  */
 void xgui_wm_redraw_all(void) {
     for (xgui_window_t* win = window_bottom; win; win = win->next) {
-        if ((win->flags & XGUI_WINDOW_VISIBLE) && !(win->flags & XGUI_WINDOW_MINIMIZED) && win->dirty && win->buffer) {
-            /* Clear buffer with background color */
-            for (int i = 0; i < win->buf_width * win->buf_height; i++) {
-                win->buffer[i] = win->bg_color;
+        if (!(win->flags & XGUI_WINDOW_VISIBLE) || (win->flags & XGUI_WINDOW_MINIMIZED) || !win->buffer) {
+            continue;
+        }
+        /* Exposure is served from the cached buffer at composite
+         * time; only consume the flag here */
+        win->expose = false;
+
+        if (win->dirty) {
+            /* Clear buffer with background color (unless the paint
+             * callback does incremental updates and clears itself) */
+            if (!(win->flags & XGUI_WINDOW_NOCLEAR)) {
+                for (int i = 0; i < win->buf_width * win->buf_height; i++) {
+                    win->buffer[i] = win->bg_color;
+                }
             }
             /* Call paint callback - it draws into win->buffer */
             if (win->paint) {
                 win->paint(win);
             }
             win->dirty = false;
+        } else {
+            /* No full repaint pending: redraw only the widgets that
+             * invalidated themselves */
+            xgui_widgets_repaint(win);
         }
     }
 }
 
+/* Shadow extent beyond the window's right and bottom edges */
+#define WM_SHADOW_DEPTH 8
+
+/* One more span than windows: each subtraction can split one span */
+#define WM_MAX_SPANS (XGUI_MAX_WINDOWS + 1)
+
+/*
+ * True if a window (shadow included) lies entirely under a single
+ * window above it in z-order, so compositing it would be wasted work
+ */
+static bool window_fully_occluded(xgui_window_t* win) {
+    int x1 = win->x;
+    int y1 = win->y;
+    int x2 = win->x + win->width + WM_SHADOW_DEPTH;
+    int y2 = win->y + win->height + WM_SHADOW_DEPTH;
+
+    for (xgui_window_t* above = win->next; above; above = above->next) {
+        if (!(above->flags & XGUI_WINDOW_VISIBLE) || (above->flags & XGUI_WINDOW_MINIMIZED)) {
+            continue;
+        }
+        if (above->x <= x1 && above->y <= y1 &&
+            above->x + above->width >= x2 &&
+            above->y + above->height >= y2) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Compute the visible column intervals of one screen row of a window
+ * by subtracting the spans covered by windows above it in z-order.
+ * spans[i][0]/spans[i][1] are half-open x bounds; returns span count.
+ */
+static int clip_row_spans(xgui_window_t* win, int dy, int x1, int x2,
+                          int spans[][2]) {
+    int count = 1;
+    spans[0][0] = x1;
+    spans[0][1] = x2;
+
+    for (xgui_window_t* above = win->next; above; above = above->next) {
+        if (!(above->flags & XGUI_WINDOW_VISIBLE) || (above->flags & XGUI_WINDOW_MINIMIZED)) {
+            continue;
+        }
+        if (dy < above->y || dy >= above->y + above->height) {
+            continue;
+        }
+
+        int ax1 = above->x;
+        int ax2 = above->x + above->width;
+
+        for (int i = 0; i < count; i++) {
+            if (ax2 <= spans[i][0] || ax1 >= spans[i][1]) {
+                continue;  /* No overlap */
+            }
+            if (ax1 <= spans[i][0] && ax2 >= spans[i][1]) {
+                /* Fully covered: drop the span */
+                for (int j = i + 1; j < count; j++) {
+                    spans[j - 1][0] = spans[j][0];
+                    spans[j - 1][1] = spans[j][1];
+                }
+                count--;
+                i--;
+            } else if (ax1 <= spans[i][0]) {
+                spans[i][0] = ax2;       /* Clipped on the left */
+            } else if (ax2 >= spans[i][1]) {
+                spans[i][1] = ax1;       /* Clipped on the right */
+            } else if (count < WM_MAX_SPANS) {
+                /* Splits the span in two */
+                spans[count][0] = ax2;
+                spans[count][1] = spans[i][1];
+                count++;
+                spans[i][1] = ax1;
+            } else {
+                spans[i][1] = ax1;       /* Span list full: keep left part */
+            }
+        }
+
+        if (count == 0) {
+            return 0;
+        }
+    }
+
+    return count;
+}
+
 /*
  * Composite all windows onto the screen backbuffer.
  * Draws decorations and blits window buffers. Does NOT call paint callbacks.
+ * Windows hidden behind others are skipped, and client-area blits copy
+ * only the spans not covered by higher windows.
  */
 void xgui_wm_composite(void) {
     int sw = xgui_display_width();
@@ -838,6 +926,7 @@ void xgui_wm_composite(void) {
 
     for (xgui_window_t* win = window_bottom; win; win = win->next) {
         if (!(win->flags & XGUI_WINDOW_VISIBLE) || (win->flags & XGUI_WINDOW_MINIMIZED)) continue;
+        if (window_fully_occluded(win)) continue;
 
         /* Drop shadow behind window (right and bottom edges) */
         {
@@ -845,7 +934,7 @@ void xgui_wm_composite(void) {
             int wy = win->y;
             int ww = win->width;
             int wh = win->height;
-            int shadow_depth = 8;
+            int shadow_depth = WM_SHADOW_DEPTH;
 
             for (int d = 1; d <= shadow_depth; d++) {
                 int alpha = 100 - (d * 90) / shadow_depth;
@@ -883,7 +972,8 @@ void xgui_wm_composite(void) {
         /* Draw decorations onto screen backbuffer */
         draw_decorations(win);
 
-        /* Blit window buffer onto screen backbuffer */
+        /* Blit the visible spans of the window buffer onto the screen
+         * backbuffer, one memcpy per uncovered run */
         if (win->buffer) {
             int sx = win->x + win->client_x;
             int sy = win->y + win->client_y;
@@ -891,19 +981,31 @@ void xgui_wm_composite(void) {
             int blit_w = win->client_width;
             int blit_h = win->client_height;
 
+            /* Clip to screen bounds once */
+            int col_lo = (sx < 0) ? -sx : 0;
+            int col_hi = (sx + blit_w > sw) ? sw - sx : blit_w;
+
             for (int row = 0; row < blit_h; row++) {
                 int dy = sy + row;
                 if (dy < 0 || dy >= sh) continue;
-                for (int col = 0; col < blit_w; col++) {
-                    int dx = sx + col;
-                    if (dx < 0 || dx >= sw) continue;
-                    screen[dy * sw + dx] = win->buffer[row * win->buf_width + col];
+                if (col_lo >= col_hi) continue;
+
+                int spans[WM_MAX_SPANS][2];
+                int nspans = clip_row_spans(win, dy, sx + col_lo, sx + col_hi, spans);
+
+                for (int s = 0; s < nspans; s++) {
+                    int run = spans[s][1] - spans[s][0];
+                    memcpy(&screen[dy * sw + spans[s][0]],
+                           &win->buffer[row * win->buf_width + (spans[s][0] - sx)],
+                           (uint32_t)run * sizeof(uint32_t));
                 }
             }
         }
 
-        /* Mark window area dirty on screen (include shadow) */
-        xgui_display_mark_dirty(win->y, win->y + win->height + 8);
+        /* Mark the window's rectangle dirty on screen (include shadow) */
+        xgui_display_mark_dirty_rect(win->x, win->y,
+                                     win->width + WM_SHADOW_DEPTH,
+                                     win->height + WM_SHADOW_DEPTH);
     }
 }
 
@@ -1002,7 +1104,8 @@ void xgui_window_minimize(xgui_window_t* win) {
 void xgui_window_restore(xgui_window_t* win) {
     if (!win) return;
     win->flags &= ~XGUI_WINDOW_MINIMIZED;
-    win->dirty = true;
+    /* The buffer survived the minimize; just recomposite it */
+    win->expose = true;
     xgui_window_focus(win);
 }
 
@@ -1065,6 +1168,23 @@ bool xgui_wm_is_dragging(void) {
     return dragging;
 }
 
+/*
+ * True if any visible window needs repainting, either fully or at
+ * widget level. The main loop polls this to skip composition when
+ * the desktop is idle.
+ */
+bool xgui_wm_any_damage(void) {
+    for (xgui_window_t* win = window_bottom; win; win = win->next) {
+        if (!(win->flags & XGUI_WINDOW_VISIBLE) || (win->flags & XGUI_WINDOW_MINIMIZED)) {
+            continue;
+        }
+        if (win->dirty || win->expose || xgui_widgets_any_dirty(win)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 /* ================================================================
  * Window-local drawing API
  * All coordinates are relative to the window's client area (0,0 = top-left).
@@ -1164,16 +1284,19 @@ void xgui_win_line(xgui_window_t* win, int x1, int y1, int x2, int y2, uint32_t
 void xgui_win_text(xgui_window_t* win, int x, int y, const char* str, uint32_t fg, uint32_t bg) {
     if (!win || !win->buffer || !str) return;
     while (*str) {
-        const uint8_t* glyph = xgui_font_get_glyph(*str);
-        for (int row = 0; row < XGUI_FONT_HEIGHT; row++) {
-            uint8_t bits = glyph[row];
-            for (int col = 0; col < XGUI_FONT_WIDTH; col++) {
-                if (bits & (0x80 >> col)) {
-                    xgui_win_pixel(win, x + col, y + row, fg);
-                } else {
-                    xgui_win_pixel(win, x + col, y + row, bg);
-                }
-            }
+        /* Opaque text: blit cached 32bpp glyph tiles row by row */
+        const uint32_t* tile = xgui_font_tile(*str, fg, bg);
+
+        int x1 = (x < 0) ? 0 : x;
+        int y1 = (y < 0) ? 0 : y;
+        int x2 = (x + XGUI_FONT_WIDTH > win->buf_width) ? win->buf_width : x + XGUI_FONT_WIDTH;
+        int y2 = (y + XGUI_FONT_HEIGHT > win->buf_height) ? win->buf_height : y + XGUI_FONT_HEIGHT;
+
+        for (int row = y1; row < y2; row++) {
+            if (x1 >= x2) break;
+            memcpy(&win->buffer[row * win->buf_width + x1],
+                   &tile[(row - y) * XGUI_FONT_WIDTH + (x1 - x)],
+                   (uint32_t)(x2 - x1) * sizeof(uint32_t));
         }
         x += XGUI_FONT_WIDTH;
         str++;
@@ -1203,3 +1326,42 @@ void xgui_win_clear(xgui_window_t* win, uint32_t color) {
         win->buffer[i] = color;
     }
 }
+
+/*
+ * Copy a rectangular region within the window buffer (handles overlap).
+ * Used by apps that scroll their content instead of repainting it.
+ */
+void xgui_win_copy_rect(xgui_window_t* win, int dst_x, int dst_y,
+                        int src_x, int src_y, int w, int h) {
+    if (!win || !win->buffer) return;
+    if (w <= 0 || h <= 0) return;
+
+    /* Copy top-to-bottom when moving up, bottom-to-top when moving down */
+    int row_first = 0, row_last = h - 1, row_step = 1;
+    if (dst_y > src_y || (dst_y == src_y && dst_x > src_x)) {
+        row_first = h - 1;
+        row_last = 0;
+        row_step = -1;
+    }
+
+    for (int row = row_first; ; row += row_step) {
+        int sy = src_y + row;
+        int dy = dst_y + row;
+        if (sy >= 0 && sy < win->buf_height && dy >= 0 && dy < win->buf_height) {
+            /* Horizontal clipping against both source and destination */
+            int start = 0;
+            int end = w;
+            if (src_x < 0 && -src_x > start) start = -src_x;
+            if (dst_x < 0 && -dst_x > start) start = -dst_x;
+            if (src_x + w > win->buf_width) end = win->buf_width - src_x;
+            if (dst_x + end > win->buf_width) end = win->buf_width - dst_x;
+
+            if (start < end) {
+                uint32_t* src = &win->buffer[sy * win->buf_width + src_x];
+                uint32_t* dst = &win->buffer[dy * win->buf_width + dst_x];
+                memmove(dst + start, src + start, (end - start) * sizeof(uint32_t));
+            }
+        }
+        if (row == row_last) break;
+    }
+}
@@ -31,19 +31,105 @@ extern void xgui_flappycat_update(void);
 static bool xgui_running = false;
 static bool xgui_initialized = false;
 
-/* Last drawn cursor position for erasing */
-#define CURSOR_SIZE 16
-static int last_cursor_x = -1, last_cursor_y = -1;
+/* ------------------------------------------------------------------ */
+/*  Deadline timers                                                    */
+/* ------------------------------------------------------------------ */
+
+#define XGUI_TIMER_MAX 8
+
+typedef struct {
+    xgui_timer_cb_t callback;   /* NULL = slot free */
+    uint32_t deadline;          /* Tick the callback is due at */
+    uint32_t period;            /* 0 = one-shot, else reschedule */
+} xgui_timer_slot_t;
+
+static xgui_timer_slot_t xgui_timers[XGUI_TIMER_MAX];
+
+/* Earliest pending deadline, so the idle loop's check is one compare */
+static uint32_t xgui_timer_next = 0;
+static bool xgui_timer_armed = false;
+
+static void xgui_timer_recompute_next(void) {
+    xgui_timer_armed = false;
+    for (int i = 0; i < XGUI_TIMER_MAX; i++) {
+        if (xgui_timers[i].callback == NULL) continue;
+        if (!xgui_timer_armed ||
+            (int32_t)(xgui_timers[i].deadline - xgui_timer_next) < 0) {
+            xgui_timer_next = xgui_timers[i].deadline;
+            xgui_timer_armed = true;
+        }
+    }
+}
+
+static int xgui_timer_add(uint32_t delay, uint32_t period, xgui_timer_cb_t cb) {
+    if (cb == NULL) return -1;
+    for (int i = 0; i < XGUI_TIMER_MAX; i++) {
+        if (xgui_timers[i].callback != NULL) continue;
+        xgui_timers[i].callback = cb;
+        xgui_timers[i].deadline = timer_get_ticks() + delay;
+        xgui_timers[i].period = period;
+        xgui_timer_recompute_next();
+        return i;
+    }
+    return -1;
+}
+
+/*
+ * Run the callback once, delay_ticks from now. Returns a timer id
+ * for xgui_timer_cancel, or -1 if all slots are taken.
+ */
+int xgui_timer_after(uint32_t delay_ticks, xgui_timer_cb_t callback) {
+    return xgui_timer_add(delay_ticks, 0, callback);
+}
 
 /*
- * Erase cursor by re-flushing the clean backbuffer lines over the
- * framebuffer area where the cursor was drawn.
+ * Run the callback every period_ticks, starting one period from now
+ */
+int xgui_timer_every(uint32_t period_ticks, xgui_timer_cb_t callback) {
+    if (period_ticks == 0) period_ticks = 1;
+    return xgui_timer_add(period_ticks, period_ticks, callback);
+}
+
+void xgui_timer_cancel(int id) {
+    if (id < 0 || id >= XGUI_TIMER_MAX) return;
+    xgui_timers[id].callback = NULL;
+    xgui_timer_recompute_next();
+}
+
+/*
+ * Service due timers. Called once per main-loop wakeup; costs one
+ * tick compare unless something is actually due. Periodic timers
+ * reschedule by whole periods so a stalled frame doesn't cause a
+ * burst of catch-up callbacks.
+ */
+void xgui_timers_run(void) {
+    if (!xgui_timer_armed) return;
+    uint32_t now = timer_get_ticks();
+    if ((int32_t)(now - xgui_timer_next) < 0) return;
+
+    for (int i = 0; i < XGUI_TIMER_MAX; i++) {
+        if (xgui_timers[i].callback == NULL) continue;
+        if ((int32_t)(now - xgui_timers[i].deadline) < 0) continue;
+
+        xgui_timer_cb_t cb = xgui_timers[i].callback;
+        if (xgui_timers[i].period != 0) {
+            while ((int32_t)(now - xgui_timers[i].deadline) >= 0) {
+                xgui_timers[i].deadline += xgui_timers[i].period;
+            }
+        } else {
+            xgui_timers[i].callback = NULL;
+        }
+        cb();
+    }
+    xgui_timer_recompute_next();
+}
+
+/*
+ * Erase cursor by restoring the save-under patch cached by the
+ * display layer when the cursor was drawn.
  */
 static void cursor_erase(void) {
-    if (last_cursor_x < 0) return;
-    int y_start = last_cursor_y;
-    int y_end = last_cursor_y + CURSOR_SIZE;
-    xgui_display_flush_lines(y_start, y_end);
+    xgui_display_cursor_hide();
 }
 
 /* Mouse cursor bitmap (16x16, simple arrow) */
@@ -70,16 +156,7 @@ static const uint32_t cursor_bitmap[16 * 16] = {
  * Draw the mouse cursor directly to the framebuffer (not the backbuffer)
  */
 void xgui_draw_cursor(int x, int y) {
-    for (int cy = 0; cy < 16; cy++) {
-        for (int cx = 0; cx < 16; cx++) {
-            uint32_t pixel = cursor_bitmap[cy * 16 + cx];
-            if (pixel != 0) {
-                xgui_display_fb_pixel(x + cx, y + cy, pixel);
-            }
-        }
-    }
-    last_cursor_x = x;
-    last_cursor_y = y;
+    xgui_display_cursor_show(x, y, cursor_bitmap);
 }
 
 /*
@@ -336,13 +413,17 @@ void xgui_run(void) {
     /* Main event loop */
     bool needs_redraw = false;
     int last_mouse_x = mouse_x, last_mouse_y = mouse_y;
+    uint32_t last_frame_tick = timer_get_ticks();
 
     while (xgui_running) {
-        xgui_event_t event;
         bool mouse_moved = false;
 
-        /* Process events */
-        while (xgui_event_poll(&event)) {
+        /* Process this frame's batch of events (moves arrive coalesced,
+         * anything past the batch limit carries over to the next frame) */
+        xgui_event_t batch[XGUI_EVENT_BATCH_MAX];
+        int batch_count = xgui_event_poll_batch(batch, XGUI_EVENT_BATCH_MAX);
+        for (int ev = 0; ev < batch_count; ev++) {
+            xgui_event_t event = batch[ev];
             if (event.type == XGUI_EVENT_QUIT) {
                 xgui_running = false;
                 break;
@@ -354,6 +435,15 @@ void xgui_run(void) {
                 break;
             }
 
+            /* Ctrl+F: toggle the frame-time HUD overlay */
+            if (event.type == XGUI_EVENT_KEY_DOWN &&
+                (event.key.modifiers & XGUI_MOD_CTRL) &&
+                event.key.keycode == 6) {
+                xgui_display_hud_toggle();
+                needs_redraw = true;
+                continue;
+            }
+
             /* Context menu handling — intercept ALL events when visible */
             if (xgui_contextmenu_visible()) {
                 /* Swallow ALL mouse events except left-button down/click */
@@ -432,7 +522,8 @@ void xgui_run(void) {
                     continue;
                 }
                 if (event.type == XGUI_EVENT_MOUSE_DOWN) {
-                    xgui_desktop_icon_click(event.mouse.x, event.mouse.y, event.mouse.button);
+                    xgui_desktop_icon_click(event.mouse.x, event.mouse.y, event.mouse.button,
+                                            event.mouse.click_count);
                     needs_redraw = true;
                     continue;
                 }
@@ -452,18 +543,23 @@ void xgui_run(void) {
                 }
             }
 
-            /* Mouse move: dispatch for drag and drawing */
+            /* Mouse move: dispatch for drag and drawing. Plain motion
+             * only moves the cursor overlay; apps that draw on move
+             * invalidate their window, which counts as damage below. */
             if (event.type == XGUI_EVENT_MOUSE_MOVE) {
                 xgui_desktop_icon_mouse_move(event.mouse.x, event.mouse.y);
                 xgui_wm_dispatch_event(&event);
-                needs_redraw = true;
+                if (xgui_wm_is_dragging() || xgui_desktop_dragging()) {
+                    needs_redraw = true;
+                }
                 continue;
             }
 
             /* Desktop icon clicks — only when no window is under the cursor */
             if (event.type == XGUI_EVENT_MOUSE_DOWN &&
                 !xgui_wm_window_at(event.mouse.x, event.mouse.y)) {
-                if (xgui_desktop_icon_click(event.mouse.x, event.mouse.y, event.mouse.button)) {
+                if (xgui_desktop_icon_click(event.mouse.x, event.mouse.y, event.mouse.button,
+                                            event.mouse.click_count)) {
                     needs_redraw = true;
                     continue;
                 }
@@ -487,8 +583,8 @@ void xgui_run(void) {
             last_mouse_y = mouse_y;
         }
 
-        /* Update analog clock (invalidates if second changed) */
-        xgui_analogclock_update();
+        /* Service deadline timers (clock redraws etc.) */
+        xgui_timers_run();
 
         /* Update ski game (advances game state each frame) */
         xgui_skigame_update();
@@ -496,13 +592,26 @@ void xgui_run(void) {
         /* Update flappy cat game */
         xgui_flappycat_update();
 
-        /* Always redraw — the analog clock ticks every second */
-        needs_redraw = true;
+        /* Window damage (games ticking, the clock's second hand)
+         * also warrants a frame */
+        if (xgui_wm_any_damage()) {
+            needs_redraw = true;
+        }
+
+        /* Render at most once per timer tick: damage from a burst of
+         * events accumulates and is composed in a single frame. An
+         * idle desktop skips composition entirely and just hlts. */
+        uint32_t now = timer_get_ticks();
+        if (needs_redraw && now != last_frame_tick) {
+            last_frame_tick = now;
+
+            /* Frame starts here: flush charges the time up to the
+             * copy as compose */
+            xgui_display_frame_begin();
 
-        /* Repaint any dirty windows into their own buffers */
-        xgui_wm_redraw_all();
+            /* Repaint dirty windows into their own buffers */
+            xgui_wm_redraw_all();
 
-        if (needs_redraw) {
             /* Rebuild the screen backbuffer */
             xgui_desktop_draw();
             xgui_desktop_draw_icons();
@@ -529,7 +638,7 @@ void xgui_run(void) {
             xgui_draw_cursor(mouse_x, mouse_y);
         }
 
-        /* Small delay to avoid 100% CPU */
+        /* Sleep until the next interrupt (timer, keyboard, mouse) */
         __asm__ volatile("sti");
         __asm__ volatile("hlt");
     }
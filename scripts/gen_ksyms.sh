@@ -0,0 +1,31 @@
+#!/bin/sh
+# Generate the embedded kernel symbol table from a pass-one image.
+# Only .text symbols are kept, so their addresses survive the relink
+# (the table lands in .rodata, after all code).
+#
+# Usage: gen_ksyms.sh <kernel.bin> <output.c> [nm]
+
+set -e
+
+KERNEL="$1"
+OUT="$2"
+NM="${3:-nm}"
+
+if [ -z "$KERNEL" ] || [ -z "$OUT" ]; then
+    echo "Usage: $0 <kernel.bin> <output.c> [nm]" >&2
+    exit 1
+fi
+
+{
+    echo "/* Auto-generated by scripts/gen_ksyms.sh - do not edit */"
+    echo "#include \"ksyms.h\""
+    echo ""
+    echo "const ksym_t ksym_table[] = {"
+    "$NM" -n "$KERNEL" | awk '$2 ~ /^[tT]$/ {
+        printf "    { 0x%s, \"%s\" },\n", $1, $3
+    }'
+    echo "};"
+    echo ""
+    echo "const uint32_t ksym_count ="
+    echo "    sizeof(ksym_table) / sizeof(ksym_table[0]);"
+} > "$OUT"
@@ -0,0 +1,196 @@
+/*
+ * MiniOS Microbenchmark Suite (userland half)
+ *
+ * Measures the costs only visible from user space: syscall round-trips
+ * through both entry paths, file read throughput, and the user heap.
+ * Timing comes from gettime_ns(), which is backed by the kernel's
+ * calibrated TSC clock. The kernel-side half lives in the `bench`
+ * shell builtin.
+ */
+
+#include "../libc/include/ioring.h"
+#include "../libc/include/stdio.h"
+#include "../libc/include/stdlib.h"
+#include "../libc/include/string.h"
+#include "../libc/include/unistd.h"
+
+#define SYSCALL_ITERS   200000
+#define ALLOC_ITERS     50000
+#define MEMCPY_BYTES    (64 * 1024)
+#define MEMCPY_PASSES   128
+#define READ_CHUNK      4096
+
+/*
+ * 64/32 division without libgcc: neither the kernel nor userland links
+ * it, so unsigned long long / unsigned would not resolve.
+ */
+static unsigned int udiv64_32(unsigned long long n, unsigned int d) {
+    unsigned long long rem = n;
+    unsigned long long div = d;
+    unsigned int q = 0;
+    int shift = 0;
+
+    if (d == 0) return 0;
+
+    while (div < rem && !(div & 0x8000000000000000ull) && shift < 31) {
+        div <<= 1;
+        shift++;
+    }
+
+    while (shift >= 0) {
+        q <<= 1;
+        if (rem >= div) {
+            rem -= div;
+            q |= 1;
+        }
+        div >>= 1;
+        shift--;
+    }
+
+    return q;
+}
+
+/* Ops per second from an op count and an elapsed-ns interval */
+static unsigned int ops_per_sec(unsigned int ops, unsigned long long ns) {
+    unsigned int us = udiv64_32(ns, 1000);
+    if (us == 0) return 0;
+    return udiv64_32((unsigned long long)ops * 1000000ull, us);
+}
+
+static void bench_syscall(void) {
+    unsigned long long t0 = gettime_ns();
+    for (int i = 0; i < SYSCALL_ITERS; i++) {
+        syscall0(SYS_GETPID);
+    }
+    unsigned long long ns = gettime_ns() - t0;
+    printf("syscall int80:    %u calls, %u ns/call (%u ops/s)\n",
+           (unsigned int)SYSCALL_ITERS,
+           udiv64_32(ns, SYSCALL_ITERS),
+           ops_per_sec(SYSCALL_ITERS, ns));
+
+    if (!syscall_has_sysenter()) {
+        printf("syscall sysenter: not supported on this CPU\n");
+        return;
+    }
+
+    t0 = gettime_ns();
+    for (int i = 0; i < SYSCALL_ITERS; i++) {
+        syscall3_fast(SYS_GETPID, 0, 0, 0);
+    }
+    ns = gettime_ns() - t0;
+    printf("syscall sysenter: %u calls, %u ns/call (%u ops/s)\n",
+           (unsigned int)SYSCALL_ITERS,
+           udiv64_32(ns, SYSCALL_ITERS),
+           ops_per_sec(SYSCALL_ITERS, ns));
+}
+
+/*
+ * Batched crossings: full rings of NOPs through SYS_IORING, so the
+ * per-operation figure shows the entry cost amortized 64 ways
+ */
+static void bench_ioring(void) {
+    static ioring_t ring;
+    ioring_init(&ring);
+
+    unsigned int ops = 0;
+    unsigned long long t0 = gettime_ns();
+    while (ops < SYSCALL_ITERS) {
+        for (int i = 0; i < IORING_ENTRIES; i++) {
+            ioring_push(&ring, IORING_OP_NOP, 0, 0, 0, ops + i);
+        }
+        int done = ioring_enter(&ring);
+        if (done < 0) {
+            printf("syscall ioring:   not supported by this kernel\n");
+            return;
+        }
+        ops += done;
+
+        ioring_cqe_t cqe;
+        while (ioring_pop(&ring, &cqe)) {
+        }
+    }
+    unsigned long long ns = gettime_ns() - t0;
+    printf("syscall ioring:   %u ops, %u ns/op (%u ops/s, batches of %u)\n",
+           ops, udiv64_32(ns, ops), ops_per_sec(ops, ns),
+           (unsigned int)IORING_ENTRIES);
+}
+
+static void bench_malloc(void) {
+    unsigned long long t0 = gettime_ns();
+    for (int i = 0; i < ALLOC_ITERS; i++) {
+        void* p = malloc(64);
+        if (!p) {
+            printf("malloc/free:      failed at iteration %d\n", i);
+            return;
+        }
+        free(p);
+    }
+    unsigned long long ns = gettime_ns() - t0;
+    printf("malloc/free 64B:  %u pairs, %u ops/s\n",
+           (unsigned int)ALLOC_ITERS, ops_per_sec(ALLOC_ITERS, ns));
+}
+
+static void bench_memcpy(void) {
+    char* src = malloc(MEMCPY_BYTES);
+    char* dst = malloc(MEMCPY_BYTES);
+    if (!src || !dst) {
+        printf("memcpy:           allocation failed\n");
+        return;
+    }
+    memset(src, 0xA5, MEMCPY_BYTES);
+
+    unsigned long long t0 = gettime_ns();
+    for (int i = 0; i < MEMCPY_PASSES; i++) {
+        memcpy(dst, src, MEMCPY_BYTES);
+    }
+    unsigned long long ns = gettime_ns() - t0;
+
+    /* bytes/us == MB/s */
+    unsigned int us = udiv64_32(ns, 1000);
+    unsigned int mbs = (us > 0)
+        ? udiv64_32((unsigned long long)MEMCPY_BYTES * MEMCPY_PASSES, us) : 0;
+    printf("memcpy 64K:       %u passes, %u MB/s\n",
+           (unsigned int)MEMCPY_PASSES, mbs);
+
+    free(src);
+    free(dst);
+}
+
+static void bench_read(const char* path) {
+    int fd = open(path, 0);
+    if (fd < 0) {
+        printf("file read:        cannot open %s\n", path);
+        return;
+    }
+
+    static char buf[READ_CHUNK];
+    unsigned int total = 0;
+    unsigned long long t0 = gettime_ns();
+    int n;
+    while ((n = read(fd, buf, READ_CHUNK)) > 0) {
+        total += (unsigned int)n;
+    }
+    unsigned long long ns = gettime_ns() - t0;
+    close(fd);
+
+    unsigned int us = udiv64_32(ns, 1000);
+    unsigned int kbs = (us > 0)
+        ? udiv64_32((unsigned long long)total * 1000, us) : 0;
+    printf("file read:        %s, %u bytes, %u KB/s\n", path, total, kbs);
+}
+
+int main(int argc, char* argv[]) {
+    const char* path = (argc > 1) ? argv[1] : "/bin/shell";
+
+    printf("MiniOS userland microbenchmarks\n");
+    printf("-------------------------------\n");
+
+    bench_syscall();
+    bench_ioring();
+    bench_malloc();
+    bench_memcpy();
+    bench_read(path);
+
+    printf("done. kernel-side benchmarks: run `bench` in the shell.\n");
+    return 0;
+}
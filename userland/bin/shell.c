@@ -333,56 +333,24 @@ static int parse_line(char* line, char* argv[]) {
     return argc;
 }
 
-/* Read a line of input with echo */
+/* Read a line of input. The kernel tty runs in canonical mode: it
+ * does the editing, echo and scrollback keys and delivers the whole
+ * line in one read() syscall. */
 static int read_line(char* buf, int max) {
-    int i = 0;
-    int c;
-
-    while (i < max - 1) {
-        c = getchar();
-        if (c == EOF) return -1;
-
-        /* Handle special keys for scrollback */
-        unsigned char uc = (unsigned char)c;
-        if (uc == KEY_PAGEUP) {
-            scroll(0, 24);  /* Scroll up one page */
-            continue;
-        } else if (uc == KEY_PAGEDOWN) {
-            scroll(1, 24);  /* Scroll down one page */
-            continue;
-        } else if (uc == KEY_UP) {
-            scroll(0, 1);   /* Scroll up one line */
-            continue;
-        } else if (uc == KEY_DOWN) {
-            scroll(1, 1);   /* Scroll down one line */
-            continue;
-        } else if (uc == KEY_HOME) {
-            scroll(0, 1000); /* Scroll to top */
-            continue;
-        } else if (uc == KEY_END) {
-            scroll(2, 0);    /* Scroll to bottom */
-            continue;
-        }
+    /* Prompts written without a newline must show before we block */
+    fflush(stdout);
 
-        if (c == '\n' || c == '\r') {
-            putchar('\n');  /* Echo newline */
-            buf[i] = '\0';
-            return i;
-        }
-        if (c == '\b' || c == 127) {
-            if (i > 0) {
-                i--;
-                /* Erase character on screen: backspace, space, backspace */
-                write(STDOUT_FILENO, "\b \b", 3);
-            }
-            continue;
-        }
-        /* Echo the character */
-        putchar(c);
-        buf[i++] = c;
+    int n = read(STDIN_FILENO, buf, max - 1);
+    if (n < 0) {
+        return -1;
+    }
+
+    /* Strip the terminating newline */
+    if (n > 0 && buf[n - 1] == '\n') {
+        n--;
     }
-    buf[i] = '\0';
-    return i;
+    buf[n] = '\0';
+    return n;
 }
 
 /* Main shell loop */
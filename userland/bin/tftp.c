@@ -0,0 +1,293 @@
+/*
+ * TFTP client - file transfer over the MiniOS UDP socket API
+ *
+ * Implements the classic RFC 1350 protocol in octet mode: RRQ/WRQ to
+ * port 69, then lock-step 512-byte DATA/ACK exchanges with whatever
+ * port the server answers from. Enough to move files between a test
+ * unit and any stock tftp server (QEMU slirp hosts one with
+ * -netdev user,tftp=DIR).
+ *
+ * The loader passes no argv yet, so the command is read from stdin:
+ *
+ *   get <server-ip> <remote-file> <local-file>
+ *   put <server-ip> <local-file> <remote-file>
+ *
+ * Receives block until a datagram arrives; a dead server means a
+ * stuck transfer, which Ctrl+C from the shell cleans up.
+ */
+
+#include "../libc/include/stdio.h"
+#include "../libc/include/stdlib.h"
+#include "../libc/include/string.h"
+#include "../libc/include/unistd.h"
+
+#define TFTP_PORT       69
+#define TFTP_BLOCK_SIZE 512
+
+/* Opcodes */
+#define OP_RRQ      1
+#define OP_WRQ      2
+#define OP_DATA     3
+#define OP_ACK      4
+#define OP_ERROR    5
+
+/* Opcode + block number / error code */
+#define TFTP_HDR    4
+
+static unsigned char pkt[TFTP_HDR + TFTP_BLOCK_SIZE];
+
+/* Parse a dotted quad into a host-order address. Returns 0 on error. */
+static unsigned int parse_ip(const char* s) {
+    unsigned int ip = 0;
+
+    for (int part = 0; part < 4; part++) {
+        unsigned int v = 0;
+        int digits = 0;
+        while (*s >= '0' && *s <= '9') {
+            v = v * 10 + (unsigned int)(*s - '0');
+            s++;
+            digits++;
+        }
+        if (digits == 0 || v > 255) return 0;
+        if (part < 3 && *s++ != '.') return 0;
+        ip = (ip << 8) | v;
+    }
+    return (*s == '\0') ? ip : 0;
+}
+
+/* Build an RRQ/WRQ packet; returns its length */
+static int build_request(int opcode, const char* filename) {
+    int n = 0;
+    pkt[n++] = 0;
+    pkt[n++] = (unsigned char)opcode;
+    while (*filename) pkt[n++] = (unsigned char)*filename++;
+    pkt[n++] = 0;
+    const char* mode = "octet";
+    while (*mode) pkt[n++] = (unsigned char)*mode++;
+    pkt[n++] = 0;
+    return n;
+}
+
+static void send_ack(int fd, unsigned int ip, unsigned short port,
+                     unsigned int block) {
+    unsigned char ack[TFTP_HDR];
+    ack[0] = 0;
+    ack[1] = OP_ACK;
+    ack[2] = (unsigned char)(block >> 8);
+    ack[3] = (unsigned char)block;
+    sendto(fd, ack, sizeof(ack), ip, port);
+}
+
+/* Print the server's ERROR packet (NUL-terminated message after the
+ * error code) */
+static void print_error(unsigned char* p, int len) {
+    p[len < (int)sizeof(pkt) ? len : (int)sizeof(pkt) - 1] = '\0';
+    printf("tftp: server error %u: %s\n",
+           (unsigned int)((p[2] << 8) | p[3]), (const char*)(p + TFTP_HDR));
+}
+
+static int do_get(unsigned int ip, const char* remote, const char* local) {
+    int sock = socket();
+    if (sock < 0) {
+        printf("tftp: no socket (is the network up?)\n");
+        return -1;
+    }
+
+    int out = open(local, 1);   /* O_CREAT */
+    if (out < 0) {
+        printf("tftp: cannot create '%s'\n", local);
+        close(sock);
+        return -1;
+    }
+
+    int n = build_request(OP_RRQ, remote);
+    if (sendto(sock, pkt, n, ip, TFTP_PORT) < 0) {
+        printf("tftp: send failed\n");
+        close(out);
+        close(sock);
+        return -1;
+    }
+
+    unsigned int expected = 1;
+    unsigned int total = 0;
+    unsigned short tid = 0;     /* Server's transfer port */
+
+    for (;;) {
+        unsigned int from[2];
+        int len = recvfrom(sock, pkt, sizeof(pkt), from);
+        if (len < TFTP_HDR) {
+            printf("tftp: receive failed\n");
+            break;
+        }
+
+        int op = (pkt[0] << 8) | pkt[1];
+        if (op == OP_ERROR) {
+            print_error(pkt, len);
+            break;
+        }
+        if (op != OP_DATA) {
+            continue;
+        }
+
+        /* First DATA packet fixes the server's transfer port */
+        if (tid == 0) tid = (unsigned short)from[1];
+        if (from[1] != tid) continue;
+
+        unsigned int block = (unsigned int)((pkt[2] << 8) | pkt[3]);
+        if (block == expected) {
+            int payload = len - TFTP_HDR;
+            if (payload > 0 &&
+                fwrite_fd(out, pkt + TFTP_HDR, payload) != payload) {
+                printf("tftp: short write to '%s'\n", local);
+                break;
+            }
+            total += (unsigned int)payload;
+            expected++;
+        }
+        /* ACK the block either way; a repeated DATA means our
+         * previous ACK was lost */
+        send_ack(sock, ip, tid, block);
+
+        if (block == expected - 1 && len - TFTP_HDR < TFTP_BLOCK_SIZE) {
+            printf("tftp: received %u bytes -> %s\n", total, local);
+            close(out);
+            close(sock);
+            return 0;
+        }
+    }
+
+    close(out);
+    close(sock);
+    return -1;
+}
+
+static int do_put(unsigned int ip, const char* local, const char* remote) {
+    int sock = socket();
+    if (sock < 0) {
+        printf("tftp: no socket (is the network up?)\n");
+        return -1;
+    }
+
+    int in = open(local, 0);
+    if (in < 0) {
+        printf("tftp: cannot open '%s'\n", local);
+        close(sock);
+        return -1;
+    }
+
+    int n = build_request(OP_WRQ, remote);
+    if (sendto(sock, pkt, n, ip, TFTP_PORT) < 0) {
+        printf("tftp: send failed\n");
+        close(in);
+        close(sock);
+        return -1;
+    }
+
+    unsigned int block = 0;
+    unsigned int total = 0;
+    unsigned short tid = 0;
+    int last_payload = TFTP_BLOCK_SIZE;
+
+    for (;;) {
+        unsigned int from[2];
+        int len = recvfrom(sock, pkt, sizeof(pkt), from);
+        if (len < TFTP_HDR) {
+            printf("tftp: receive failed\n");
+            break;
+        }
+
+        int op = (pkt[0] << 8) | pkt[1];
+        if (op == OP_ERROR) {
+            print_error(pkt, len);
+            break;
+        }
+        if (op != OP_ACK) {
+            continue;
+        }
+
+        if (tid == 0) tid = (unsigned short)from[1];
+        if (from[1] != tid) continue;
+
+        unsigned int acked = (unsigned int)((pkt[2] << 8) | pkt[3]);
+        if (acked != block) {
+            continue;   /* Stale ACK */
+        }
+
+        /* Done once the short final block is acknowledged */
+        if (block > 0 && last_payload < TFTP_BLOCK_SIZE) {
+            printf("tftp: sent %u bytes -> %s\n", total, remote);
+            close(in);
+            close(sock);
+            return 0;
+        }
+
+        block++;
+        int payload = fread_fd(in, pkt + TFTP_HDR, TFTP_BLOCK_SIZE);
+        if (payload < 0) {
+            printf("tftp: read error on '%s'\n", local);
+            break;
+        }
+        pkt[0] = 0;
+        pkt[1] = OP_DATA;
+        pkt[2] = (unsigned char)(block >> 8);
+        pkt[3] = (unsigned char)block;
+        if (sendto(sock, pkt, TFTP_HDR + payload, ip, tid) < 0) {
+            printf("tftp: send failed\n");
+            break;
+        }
+        total += (unsigned int)payload;
+        last_payload = payload;
+    }
+
+    close(in);
+    close(sock);
+    return -1;
+}
+
+/* Split a line into at most max whitespace-separated words */
+static int split(char* line, char* words[], int max) {
+    int count = 0;
+    char* p = line;
+
+    while (count < max) {
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '\0' || *p == '\n') break;
+        words[count++] = p;
+        while (*p && *p != ' ' && *p != '\t' && *p != '\n') p++;
+        if (*p) *p++ = '\0';
+    }
+    return count;
+}
+
+int main(void) {
+    char line[128];
+    char* words[4];
+
+    printf("tftp: get <ip> <remote> <local> | put <ip> <local> <remote>\n");
+    printf("tftp> ");
+
+    int n = read(0, line, sizeof(line) - 1);
+    if (n <= 0) return 1;
+    line[n] = '\0';
+
+    if (split(line, words, 4) != 4) {
+        printf("tftp: expected 4 words\n");
+        return 1;
+    }
+
+    unsigned int ip = parse_ip(words[1]);
+    if (ip == 0) {
+        printf("tftp: bad server address '%s'\n", words[1]);
+        return 1;
+    }
+
+    if (strcmp(words[0], "get") == 0) {
+        return do_get(ip, words[2], words[3]) == 0 ? 0 : 1;
+    }
+    if (strcmp(words[0], "put") == 0) {
+        return do_put(ip, words[2], words[3]) == 0 ? 0 : 1;
+    }
+
+    printf("tftp: unknown command '%s'\n", words[0]);
+    return 1;
+}
@@ -0,0 +1,98 @@
+/*
+ * MiniOS User-space Batched Syscall Ring
+ *
+ * Queue file operations into a ring in your own memory, then pay one
+ * kernel crossing to run the whole batch (structures must match
+ * ioring_t in the kernel's syscall.h):
+ *
+ *   ioring_t ring;
+ *   ioring_init(&ring);
+ *   ioring_push(&ring, IORING_OP_WRITE, fd, buf, len, tag);
+ *   ...more pushes...
+ *   ioring_enter(&ring);
+ *   while (ioring_pop(&ring, &cqe)) { ...cqe.result... }
+ */
+
+#ifndef _IORING_H
+#define _IORING_H
+
+#include "syscall.h"
+#include "string.h"
+
+#define IORING_ENTRIES  64  /* Ring slots (power of two) */
+
+/* Submission opcodes */
+#define IORING_OP_NOP    0  /* Complete immediately (measurement aid) */
+#define IORING_OP_READ   1  /* fd, buf, len */
+#define IORING_OP_WRITE  2  /* fd, buf, len */
+#define IORING_OP_OPEN   3  /* path in buf, open flags in len */
+#define IORING_OP_CLOSE  4  /* fd */
+
+/* One submission */
+typedef struct {
+    unsigned char opcode;
+    unsigned char pad[3];
+    int fd;
+    unsigned int buf;
+    unsigned int len;
+    unsigned int user_data;
+} ioring_sqe_t;
+
+/* One completion */
+typedef struct {
+    unsigned int user_data;
+    int result;
+} ioring_cqe_t;
+
+/* The shared ring */
+typedef struct {
+    unsigned int sq_head;   /* Kernel consumes submissions here */
+    unsigned int sq_tail;   /* We append submissions here */
+    unsigned int cq_head;   /* We consume completions here */
+    unsigned int cq_tail;   /* Kernel appends completions here */
+    ioring_sqe_t sqes[IORING_ENTRIES];
+    ioring_cqe_t cqes[IORING_ENTRIES];
+} ioring_t;
+
+static inline void ioring_init(ioring_t* ring) {
+    memset(ring, 0, sizeof(*ring));
+}
+
+/* Pending submissions not yet handed to the kernel */
+static inline unsigned int ioring_pending(ioring_t* ring) {
+    return ring->sq_tail - ring->sq_head;
+}
+
+/* Queue one operation; returns 0, or -1 if the ring is full */
+static inline int ioring_push(ioring_t* ring, int opcode, int fd,
+                              const void* buf, unsigned int len,
+                              unsigned int user_data) {
+    if (ioring_pending(ring) >= IORING_ENTRIES) {
+        return -1;
+    }
+    ioring_sqe_t* sqe = &ring->sqes[ring->sq_tail & (IORING_ENTRIES - 1)];
+    sqe->opcode = (unsigned char)opcode;
+    sqe->fd = fd;
+    sqe->buf = (unsigned int)buf;
+    sqe->len = len;
+    sqe->user_data = user_data;
+    ring->sq_tail++;
+    return 0;
+}
+
+/* Run everything queued in one syscall; returns operations completed */
+static inline int ioring_enter(ioring_t* ring) {
+    return syscall1(SYS_IORING, (int)ring);
+}
+
+/* Take the next completion; returns 1 and fills *cqe, or 0 if empty */
+static inline int ioring_pop(ioring_t* ring, ioring_cqe_t* cqe) {
+    if (ring->cq_head == ring->cq_tail) {
+        return 0;
+    }
+    *cqe = ring->cqes[ring->cq_head & (IORING_ENTRIES - 1)];
+    ring->cq_head++;
+    return 1;
+}
+
+#endif /* _IORING_H */
@@ -15,6 +15,40 @@
 /* EOF */
 #define EOF (-1)
 
+/* Stream buffering modes (setvbuf) */
+#define _IOFBF 0    /* Fully buffered: flush on fill */
+#define _IOLBF 1    /* Line buffered: flush on newline or fill */
+#define _IONBF 2    /* Unbuffered: every byte is a syscall */
+
+/* Default stream buffer size */
+#define BUFSIZ 512
+
+/* Buffered stream */
+typedef struct {
+    int fd;                 /* Underlying file descriptor */
+    char* buf;              /* Buffer (NULL = unbuffered) */
+    unsigned int size;      /* Buffer capacity */
+    unsigned int pos;       /* Bytes currently buffered */
+    int mode;               /* _IOFBF, _IOLBF or _IONBF */
+} FILE;
+
+/* Standard streams (stdout line buffered, stderr unbuffered) */
+extern FILE* stdin;
+extern FILE* stdout;
+extern FILE* stderr;
+
+/* Write a character to a stream */
+int fputc(int c, FILE* stream);
+
+/* Write a string to a stream */
+int fputs(const char* str, FILE* stream);
+
+/* Flush a stream's buffer to its fd */
+int fflush(FILE* stream);
+
+/* Choose a stream's buffer and buffering mode */
+int setvbuf(FILE* stream, char* buf, int mode, unsigned int size);
+
 /* Print a string to stdout */
 int puts(const char* str);
 
@@ -21,6 +21,16 @@ void free(void* ptr);
 void* calloc(size_t nmemb, size_t size);
 void* realloc(void* ptr, size_t size);
 
+/* Heap statistics (fragmentation watching) */
+typedef struct {
+    size_t arena;       /* Total bytes obtained from sbrk */
+    size_t uordblks;    /* Bytes in allocated blocks */
+    size_t fordblks;    /* Bytes in free blocks */
+    size_t ordblks;     /* Number of free blocks */
+} mallinfo_t;
+
+mallinfo_t mallinfo(void);
+
 /* String conversion */
 int atoi(const char* str);
 
@@ -35,6 +35,20 @@
 #define SYS_FWRITE      24
 #define SYS_MEMINFO     25
 #define SYS_DATE        26
+#define SYS_POLL        31
+#define SYS_READV       36
+#define SYS_WRITEV      37
+#define SYS_GETTIME     38
+#define SYS_MMAP        39
+#define SYS_MUNMAP      40
+#define SYS_SPAWN       41
+#define SYS_TTYMODE     42
+#define SYS_IORING      43
+#define SYS_FCNTL       44
+#define SYS_SOCKET      45
+#define SYS_BIND        46
+#define SYS_SENDTO      47
+#define SYS_RECVFROM    48
 
 /* Standard file descriptors */
 #define STDIN_FILENO    0
@@ -95,5 +109,61 @@ static inline int syscall3(int num, int arg1, int arg2, int arg3) {
     return ret;
 }
 
+static inline int syscall4(int num, int arg1, int arg2, int arg3, int arg4) {
+    int ret;
+    __asm__ volatile (
+        "int $0x80"
+        : "=a"(ret)
+        : "a"(num), "b"(arg1), "c"(arg2), "d"(arg3), "S"(arg4)
+        : "memory"
+    );
+    return ret;
+}
+
+static inline int syscall5(int num, int arg1, int arg2, int arg3, int arg4, int arg5) {
+    int ret;
+    __asm__ volatile (
+        "int $0x80"
+        : "=a"(ret)
+        : "a"(num), "b"(arg1), "c"(arg2), "d"(arg3), "S"(arg4), "D"(arg5)
+        : "memory"
+    );
+    return ret;
+}
+
+/*
+ * SYSENTER fast path. The kernel takes the syscall number in EAX and
+ * up to three arguments in EBX/ESI/EDI; ECX and EDX carry the user
+ * stack pointer and return address for SYSEXIT.
+ */
+static inline int syscall_has_sysenter(void) {
+    static int sep = -1;
+    if (sep < 0) {
+        unsigned int eax, edx;
+        __asm__ volatile (
+            "cpuid"
+            : "=a"(eax), "=d"(edx)
+            : "a"(1)
+            : "ebx", "ecx"
+        );
+        sep = (int)((edx >> 11) & 1);
+    }
+    return sep;
+}
+
+static inline int syscall3_fast(int num, int arg1, int arg2, int arg3) {
+    int ret;
+    __asm__ volatile (
+        "mov %%esp, %%ecx\n\t"
+        "mov $1f, %%edx\n\t"
+        "sysenter\n"
+        "1:"
+        : "=a"(ret)
+        : "a"(num), "b"(arg1), "S"(arg2), "D"(arg3)
+        : "ecx", "edx", "memory"
+    );
+    return ret;
+}
+
 #endif /* _SYSCALL_H */
 
@@ -9,14 +9,36 @@
 
 /* Write to file descriptor */
 static inline ssize_t write(int fd, const void* buf, size_t count) {
+    if (syscall_has_sysenter()) {
+        return syscall3_fast(SYS_WRITE, fd, (int)buf, (int)count);
+    }
     return syscall3(SYS_WRITE, fd, (int)buf, (int)count);
 }
 
 /* Read from file descriptor */
 static inline ssize_t read(int fd, void* buf, size_t count) {
+    if (syscall_has_sysenter()) {
+        return syscall3_fast(SYS_READ, fd, (int)buf, (int)count);
+    }
     return syscall3(SYS_READ, fd, (int)buf, (int)count);
 }
 
+/* Scatter-gather buffer descriptor (must match kernel iovec_t) */
+typedef struct {
+    void* iov_base;
+    unsigned int iov_len;
+} iovec_t;
+
+/* Read into a list of buffers in one syscall */
+static inline ssize_t readv(int fd, const iovec_t* iov, int iovcnt) {
+    return syscall3(SYS_READV, fd, (int)iov, iovcnt);
+}
+
+/* Write a list of buffers in one syscall */
+static inline ssize_t writev(int fd, const iovec_t* iov, int iovcnt) {
+    return syscall3(SYS_WRITEV, fd, (int)iov, iovcnt);
+}
+
 /* Open a file */
 static inline int open(const char* path, int flags) {
     return syscall2(SYS_OPEN, (int)path, flags);
@@ -29,6 +51,9 @@ static inline int close(int fd) {
 
 /* Get process ID */
 static inline pid_t getpid(void) {
+    if (syscall_has_sysenter()) {
+        return syscall3_fast(SYS_GETPID, 0, 0, 0);
+    }
     return syscall0(SYS_GETPID);
 }
 
@@ -42,6 +67,11 @@ static inline int execv(const char* path, char* const argv[]) {
     return syscall2(SYS_EXEC, (int)path, (int)argv);
 }
 
+/* Launch a program in a new process (fork+exec in one step) */
+static inline pid_t spawn(const char* path, char* const argv[]) {
+    return syscall2(SYS_SPAWN, (int)path, (int)argv);
+}
+
 /* Wait for child */
 static inline pid_t wait(int* status) {
     return syscall1(SYS_WAIT, (int)status);
@@ -187,6 +217,87 @@ static inline int getdate(datetime_t* buf) {
     return syscall1(SYS_DATE, (int)buf);
 }
 
+/* poll() event bits (must match kernel pipe.h) */
+#define POLLIN      0x0001
+#define POLLOUT     0x0004
+#define POLLERR     0x0008
+#define POLLHUP     0x0010
+#define POLLNVAL    0x0020
+
+/* poll() request/result entry (must match kernel pollfd_t) */
+typedef struct {
+    int fd;
+    short events;
+    short revents;
+} pollfd_t;
+
+/* Wait for events on a set of fds; timeout_ms: 0 = return at once,
+ * < 0 = block until an event arrives */
+static inline int poll(pollfd_t* fds, unsigned int nfds, int timeout_ms) {
+    return syscall3(SYS_POLL, (int)fds, (int)nfds, timeout_ms);
+}
+
+/* Monotonic nanoseconds since boot, from the kernel's calibrated TSC
+ * clock. Goes through the SYSENTER fast path where the CPU has one,
+ * so benchmark loops pay the minimum syscall cost. */
+static inline unsigned long long gettime_ns(void) {
+    unsigned int ns[2];
+    int ret;
+    if (syscall_has_sysenter()) {
+        ret = syscall3_fast(SYS_GETTIME, (int)ns, 0, 0);
+    } else {
+        ret = syscall1(SYS_GETTIME, (int)ns);
+    }
+    if (ret < 0) {
+        return 0;
+    }
+    return ((unsigned long long)ns[0] << 32) | ns[1];
+}
+
+/* Map an open file read-only into the process, starting at the given
+ * page-aligned offset. Pages are faulted in from the file on first
+ * access (zero-copy); writing to the mapping is a segfault.
+ * Returns the mapping address, or 0 on error. */
+static inline void* mmap(int fd, unsigned int offset, unsigned int length) {
+    return (void*)syscall3(SYS_MMAP, fd, (int)offset, (int)length);
+}
+
+/* Drop a mapping created by mmap() */
+static inline int munmap(void* addr) {
+    return syscall1(SYS_MUNMAP, (int)addr);
+}
+
+/* Select console input mode: 0 = canonical (kernel line editing and
+ * echo, read() returns whole lines), 1 = raw (every key delivered
+ * immediately, no echo) */
+static inline int ttymode(int raw) {
+    return syscall1(SYS_TTYMODE, raw);
+}
+
+/* Create a UDP datagram socket. Returns a file descriptor; release
+ * it with close() like any other. */
+static inline int socket(void) {
+    return syscall0(SYS_SOCKET);
+}
+
+/* Bind a socket to a local UDP port */
+static inline int bind(int fd, unsigned short port) {
+    return syscall2(SYS_BIND, fd, port);
+}
+
+/* Send a datagram to ip:port (both host byte order) */
+static inline int sendto(int fd, const void* buf, size_t len,
+                         unsigned int ip, unsigned short port) {
+    return syscall5(SYS_SENDTO, fd, (int)buf, (int)len, (int)ip, port);
+}
+
+/* Receive one datagram, blocking until one arrives. from, when
+ * non-NULL, receives the source {ip, port}. Returns bytes copied. */
+static inline int recvfrom(int fd, void* buf, size_t len,
+                           unsigned int from[2]) {
+    return syscall4(SYS_RECVFROM, fd, (int)buf, (int)len, (int)from);
+}
+
 /* Special key codes (must match kernel keyboard.h) */
 #define KEY_UP      0x90
 #define KEY_DOWN    0x91
@@ -12,21 +12,91 @@ typedef __builtin_va_list va_list;
 #define va_arg(ap, type)   __builtin_va_arg(ap, type)
 #define va_end(ap)         __builtin_va_end(ap)
 
+/* Standard streams: console output is line buffered so a full line
+ * costs one kernel crossing; stderr stays unbuffered for diagnostics */
+static char stdout_buffer[BUFSIZ];
+static FILE stdin_file = { STDIN_FILENO, NULL, 0, 0, _IONBF };
+static FILE stdout_file = { STDOUT_FILENO, stdout_buffer, BUFSIZ, 0, _IOLBF };
+static FILE stderr_file = { STDERR_FILENO, NULL, 0, 0, _IONBF };
+
+FILE* stdin = &stdin_file;
+FILE* stdout = &stdout_file;
+FILE* stderr = &stderr_file;
+
+int fflush(FILE* stream) {
+    if (stream == NULL) {
+        return EOF;
+    }
+    if (stream->buf != NULL && stream->pos > 0) {
+        write(stream->fd, stream->buf, stream->pos);
+        stream->pos = 0;
+    }
+    return 0;
+}
+
+int fputc(int c, FILE* stream) {
+    char ch = (char)c;
+
+    if (stream->buf == NULL || stream->mode == _IONBF) {
+        write(stream->fd, &ch, 1);
+        return c;
+    }
+
+    stream->buf[stream->pos++] = ch;
+    if (stream->pos >= stream->size ||
+        (stream->mode == _IOLBF && ch == '\n')) {
+        fflush(stream);
+    }
+    return c;
+}
+
+int fputs(const char* str, FILE* stream) {
+    int count = 0;
+    while (*str) {
+        fputc(*str++, stream);
+        count++;
+    }
+    return count;
+}
+
+int setvbuf(FILE* stream, char* buf, int mode, unsigned int size) {
+    if (stream == NULL ||
+        (mode != _IOFBF && mode != _IOLBF && mode != _IONBF)) {
+        return -1;
+    }
+
+    fflush(stream);
+
+    if (mode == _IONBF) {
+        stream->buf = NULL;
+        stream->size = 0;
+    } else if (buf != NULL && size > 0) {
+        stream->buf = buf;
+        stream->size = size;
+    } else if (stream->buf == NULL) {
+        return -1;  /* Buffered mode needs a buffer */
+    }
+
+    stream->mode = mode;
+    return 0;
+}
+
 int puts(const char* str) {
-    int len = strlen(str);
-    write(STDOUT_FILENO, str, len);
-    write(STDOUT_FILENO, "\n", 1);
+    int len = fputs(str, stdout);
+    fputc('\n', stdout);
     return len + 1;
 }
 
 int putchar(int c) {
-    char ch = (char)c;
-    write(STDOUT_FILENO, &ch, 1);
-    return c;
+    return fputc(c, stdout);
 }
 
 int getchar(void) {
     char c;
+
+    /* Prompts written without a newline must show before we block */
+    fflush(stdout);
+
     if (read(STDIN_FILENO, &c, 1) <= 0) {
         return EOF;
     }
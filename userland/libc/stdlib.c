@@ -3,89 +3,207 @@
  */
 
 #include "include/stdlib.h"
+#include "include/stdio.h"
 #include "include/unistd.h"
 #include "include/string.h"
 
-/* Simple heap allocator using sbrk */
+/*
+ * Arena allocator with segregated free lists.
+ *
+ * The arena is grown with sbrk() in page-sized chunks. Every block
+ * carries a header linking it to its physical neighbours so adjacent
+ * free blocks can be coalesced on free(). Free blocks are additionally
+ * threaded onto one of several size-class lists, so small allocations
+ * are satisfied without scanning the whole heap.
+ */
 
 /* Allocation block header */
 typedef struct block_header {
-    size_t size;
+    size_t size;                    /* Payload size in bytes */
     int free;
+    struct block_header* prev;      /* Physical neighbours in the arena */
     struct block_header* next;
+    struct block_header* fl_next;   /* Free-list links (valid while free) */
+    struct block_header* fl_prev;
 } block_header_t;
 
 #define BLOCK_SIZE sizeof(block_header_t)
 #define ALIGN4(x) (((x) + 3) & ~3)
 
+/* Grow the arena in at least page-sized steps to amortize syscalls */
+#define ARENA_CHUNK 4096
+
+/* Smallest payload worth splitting off as a separate free block */
+#define MIN_SPLIT 16
+
+/*
+ * Size classes: bins 0..6 hold blocks up to 16 << bin bytes
+ * (16, 32, 64, 128, 256, 512, 1024); the last bin holds the rest.
+ */
+#define NUM_BINS 8
+
+static block_header_t* bins[NUM_BINS];
 static block_header_t* heap_start = NULL;
+static block_header_t* heap_end = NULL;     /* Last physical block */
+static size_t arena_bytes = 0;              /* Total sbrk'd bytes */
+
+/* Pick the bin for a block of the given payload size */
+static int bin_index(size_t size) {
+    size_t limit = 16;
+    for (int i = 0; i < NUM_BINS - 1; i++) {
+        if (size <= limit) {
+            return i;
+        }
+        limit <<= 1;
+    }
+    return NUM_BINS - 1;
+}
+
+/* Put a free block at the head of its size-class list */
+static void fl_insert(block_header_t* block) {
+    int bin = bin_index(block->size);
+    block->fl_prev = NULL;
+    block->fl_next = bins[bin];
+    if (bins[bin]) {
+        bins[bin]->fl_prev = block;
+    }
+    bins[bin] = block;
+}
+
+/* Remove a free block from its size-class list */
+static void fl_remove(block_header_t* block) {
+    if (block->fl_prev) {
+        block->fl_prev->fl_next = block->fl_next;
+    } else {
+        bins[bin_index(block->size)] = block->fl_next;
+    }
+    if (block->fl_next) {
+        block->fl_next->fl_prev = block->fl_prev;
+    }
+}
 
-/* Find a free block or create a new one */
+/* Carve a free block in two if the remainder is worth keeping */
+static void split_block(block_header_t* block, size_t size) {
+    if (block->size < size + BLOCK_SIZE + MIN_SPLIT) {
+        return;
+    }
+
+    block_header_t* rest = (block_header_t*)((char*)(block + 1) + size);
+    rest->size = block->size - size - BLOCK_SIZE;
+    rest->free = 1;
+    rest->prev = block;
+    rest->next = block->next;
+    if (rest->next) {
+        rest->next->prev = rest;
+    } else {
+        heap_end = rest;
+    }
+
+    block->size = size;
+    block->next = rest;
+    fl_insert(rest);
+}
+
+/* Find a recyclable free block, searching small bins before large */
 static block_header_t* find_block(size_t size) {
-    block_header_t* current = heap_start;
-    
-    /* First fit algorithm */
-    while (current) {
-        if (current->free && current->size >= size) {
-            return current;
+    for (int bin = bin_index(size); bin < NUM_BINS; bin++) {
+        /* First fit within the bin */
+        for (block_header_t* cur = bins[bin]; cur; cur = cur->fl_next) {
+            if (cur->size >= size) {
+                fl_remove(cur);
+                return cur;
+            }
         }
-        current = current->next;
     }
-    
     return NULL;
 }
 
 /* Request more memory from kernel */
 static block_header_t* request_space(size_t size) {
-    block_header_t* block = sbrk(BLOCK_SIZE + size);
+    size_t total = BLOCK_SIZE + size;
+    if (total < ARENA_CHUNK) {
+        total = ARENA_CHUNK;
+    }
+
+    block_header_t* block = sbrk(total);
     if (block == (void*)-1) {
         return NULL;  /* sbrk failed */
     }
-    
-    block->size = size;
+    arena_bytes += total;
+
+    block->size = total - BLOCK_SIZE;
     block->free = 0;
+    block->prev = heap_end;
     block->next = NULL;
-    
-    if (heap_start == NULL) {
-        heap_start = block;
+    if (heap_end) {
+        heap_end->next = block;
     } else {
-        /* Find last block and link */
-        block_header_t* last = heap_start;
-        while (last->next) {
-            last = last->next;
+        heap_start = block;
+    }
+    heap_end = block;
+
+    /* Hand back any tail beyond the request */
+    split_block(block, size);
+    return block;
+}
+
+/* Merge a free block with its free physical neighbours */
+static block_header_t* coalesce(block_header_t* block) {
+    if (block->next && block->next->free) {
+        block_header_t* next = block->next;
+        fl_remove(next);
+        block->size += BLOCK_SIZE + next->size;
+        block->next = next->next;
+        if (block->next) {
+            block->next->prev = block;
+        } else {
+            heap_end = block;
         }
-        last->next = block;
     }
-    
+
+    if (block->prev && block->prev->free) {
+        block_header_t* prev = block->prev;
+        fl_remove(prev);
+        prev->size += BLOCK_SIZE + block->size;
+        prev->next = block->next;
+        if (prev->next) {
+            prev->next->prev = prev;
+        } else {
+            heap_end = prev;
+        }
+        block = prev;
+    }
+
     return block;
 }
 
 void* malloc(size_t size) {
     if (size == 0) return NULL;
-    
+
     size = ALIGN4(size);
-    
+
     block_header_t* block = find_block(size);
-    
+
     if (block) {
         block->free = 0;
+        split_block(block, size);
     } else {
         block = request_space(size);
         if (block == NULL) {
             return NULL;
         }
     }
-    
+
     return (void*)(block + 1);
 }
 
 void free(void* ptr) {
     if (ptr == NULL) return;
-    
+
     block_header_t* block = (block_header_t*)ptr - 1;
     block->free = 1;
-    
-    /* TODO: Coalesce adjacent free blocks */
+    block = coalesce(block);
+    fl_insert(block);
 }
 
 void* calloc(size_t nmemb, size_t size) {
@@ -105,13 +223,31 @@ void* realloc(void* ptr, size_t size) {
         free(ptr);
         return NULL;
     }
-    
+
+    size = ALIGN4(size);
     block_header_t* block = (block_header_t*)ptr - 1;
-    
+
     if (block->size >= size) {
+        split_block(block, size);
         return ptr;  /* Already big enough */
     }
-    
+
+    /* Grow in place by absorbing a free right-hand neighbour */
+    if (block->next && block->next->free &&
+        block->size + BLOCK_SIZE + block->next->size >= size) {
+        block_header_t* next = block->next;
+        fl_remove(next);
+        block->size += BLOCK_SIZE + next->size;
+        block->next = next->next;
+        if (block->next) {
+            block->next->prev = block;
+        } else {
+            heap_end = block;
+        }
+        split_block(block, size);
+        return ptr;
+    }
+
     void* new_ptr = malloc(size);
     if (new_ptr) {
         memcpy(new_ptr, ptr, block->size);
@@ -120,13 +256,34 @@ void* realloc(void* ptr, size_t size) {
     return new_ptr;
 }
 
+/*
+ * Heap statistics for watching fragmentation from test programs
+ */
+mallinfo_t mallinfo(void) {
+    mallinfo_t info;
+    info.arena = arena_bytes;
+    info.uordblks = 0;
+    info.fordblks = 0;
+    info.ordblks = 0;
+
+    for (block_header_t* cur = heap_start; cur; cur = cur->next) {
+        if (cur->free) {
+            info.fordblks += cur->size;
+            info.ordblks++;
+        } else {
+            info.uordblks += cur->size;
+        }
+    }
+    return info;
+}
+
 int atoi(const char* str) {
     int result = 0;
     int sign = 1;
-    
+
     /* Skip whitespace */
     while (*str == ' ' || *str == '\t') str++;
-    
+
     /* Handle sign */
     if (*str == '-') {
         sign = -1;
@@ -134,21 +291,23 @@ int atoi(const char* str) {
     } else if (*str == '+') {
         str++;
     }
-    
+
     /* Convert digits */
     while (*str >= '0' && *str <= '9') {
         result = result * 10 + (*str - '0');
         str++;
     }
-    
+
     return sign * result;
 }
 
 void exit(int status) {
+    /* Buffered output must reach the console before the process dies */
+    fflush(stdout);
+
     syscall1(SYS_EXIT, status);
     /* Should never return, but just in case */
     while (1) {
         __asm__ volatile("hlt");
     }
 }
-
@@ -1,13 +1,55 @@
 /*
  * MiniOS User-space String Functions Implementation
+ *
+ * The memory primitives mirror the kernel's word-wise rep stosl/movsl
+ * versions, with an SSE2 path on top for large copies and fills: the
+ * CPU is probed with CPUID once, on the first call that cares, and
+ * the answer is cached for the life of the program. The kernel saves
+ * user FPU/SSE state lazily, so using XMM registers here costs
+ * nothing until a program actually hits these paths.
  */
 
 #include "include/string.h"
 
+/* SSE2 availability: -1 = not probed yet, then 0 or 1 */
+static int sse2_state = -1;
+
+/* Copies below this stay on the rep movs/stos path (SSE2 setup and
+ * the eventual FPU context save are not worth it for small blocks) */
+#define SSE2_THRESHOLD 128
+
+static int has_sse2(void) {
+    if (sse2_state < 0) {
+        unsigned int eax, edx;
+        __asm__ volatile("cpuid"
+                         : "=a"(eax), "=d"(edx)
+                         : "a"(1)
+                         : "ebx", "ecx");
+        sse2_state = (edx >> 26) & 1;
+    }
+    return sse2_state;
+}
+
 size_t strlen(const char* str) {
-    size_t len = 0;
-    while (str[len]) len++;
-    return len;
+    const char* s = str;
+
+    /* Byte-align, then scan a word at a time; (v - 0x01010101) &
+     * ~v & 0x80808080 is non-zero iff some byte of v is zero */
+    while (((unsigned int)s & 3) != 0) {
+        if (*s == '\0') return (size_t)(s - str);
+        s++;
+    }
+    const unsigned int* w = (const unsigned int*)s;
+    for (;;) {
+        unsigned int v = *w;
+        if (((v - 0x01010101u) & ~v & 0x80808080u) != 0) {
+            break;
+        }
+        w++;
+    }
+    s = (const char*)w;
+    while (*s) s++;
+    return (size_t)(s - str);
 }
 
 char* strcpy(char* dest, const char* src) {
@@ -28,6 +70,22 @@ char* strncpy(char* dest, const char* src, size_t n) {
 }
 
 int strcmp(const char* s1, const char* s2) {
+    /* Mutually aligned strings compare a word at a time until a
+     * difference or a zero byte shows up in the window */
+    if ((((unsigned int)s1 | (unsigned int)s2) & 3) == 0) {
+        const unsigned int* w1 = (const unsigned int*)s1;
+        const unsigned int* w2 = (const unsigned int*)s2;
+        while (*w1 == *w2) {
+            unsigned int v = *w1;
+            if (((v - 0x01010101u) & ~v & 0x80808080u) != 0) {
+                return 0;  /* Equal up to and including the NUL */
+            }
+            w1++;
+            w2++;
+        }
+        s1 = (const char*)w1;
+        s2 = (const char*)w2;
+    }
     while (*s1 && *s1 == *s2) {
         s1++;
         s2++;
@@ -47,6 +105,42 @@ int strncmp(const char* s1, const char* s2, size_t n) {
 
 void* memset(void* s, int c, size_t n) {
     unsigned char* p = (unsigned char*)s;
+
+    if (n >= SSE2_THRESHOLD && has_sse2()) {
+        /* Splat the fill byte across one XMM register and store 64
+         * bytes per iteration (movdqu is alignment-agnostic) */
+        unsigned int fill = (unsigned char)c;
+        fill |= fill << 8;
+        fill |= fill << 16;
+        unsigned int splat[4] = { fill, fill, fill, fill };
+        __asm__ volatile("movdqu (%0), %%xmm0" : : "r"(splat) : "xmm0");
+        while (n >= 64) {
+            __asm__ volatile("movdqu %%xmm0, (%0)\n\t"
+                             "movdqu %%xmm0, 16(%0)\n\t"
+                             "movdqu %%xmm0, 32(%0)\n\t"
+                             "movdqu %%xmm0, 48(%0)"
+                             : : "r"(p) : "memory");
+            p += 64;
+            n -= 64;
+        }
+    }
+
+    /* Word-wise remainder, same scheme as the kernel's memset */
+    while (n > 0 && ((unsigned int)p & 3) != 0) {
+        *p++ = (unsigned char)c;
+        n--;
+    }
+    if (n >= 4) {
+        unsigned int fill = (unsigned char)c;
+        fill |= fill << 8;
+        fill |= fill << 16;
+        unsigned int dwords = n / 4;
+        __asm__ volatile("rep stosl"
+                         : "+D"(p), "+c"(dwords)
+                         : "a"(fill)
+                         : "memory");
+        n &= 3;
+    }
     while (n--) {
         *p++ = (unsigned char)c;
     }
@@ -56,8 +150,44 @@ void* memset(void* s, int c, size_t n) {
 void* memcpy(void* dest, const void* src, size_t n) {
     unsigned char* d = (unsigned char*)dest;
     const unsigned char* s = (const unsigned char*)src;
-    while (n--) {
-        *d++ = *s++;
+
+    if (n >= SSE2_THRESHOLD && has_sse2()) {
+        /* 64 bytes per iteration through XMM registers; movdqu makes
+         * source/destination alignment irrelevant */
+        while (n >= 64) {
+            __asm__ volatile("movdqu (%0), %%xmm0\n\t"
+                             "movdqu 16(%0), %%xmm1\n\t"
+                             "movdqu 32(%0), %%xmm2\n\t"
+                             "movdqu 48(%0), %%xmm3\n\t"
+                             "movdqu %%xmm0, (%1)\n\t"
+                             "movdqu %%xmm1, 16(%1)\n\t"
+                             "movdqu %%xmm2, 32(%1)\n\t"
+                             "movdqu %%xmm3, 48(%1)"
+                             : : "r"(s), "r"(d)
+                             : "xmm0", "xmm1", "xmm2", "xmm3", "memory");
+            s += 64;
+            d += 64;
+            n -= 64;
+        }
+    }
+
+    /* Mutually aligned buffers go a dword at a time, the rest through
+     * rep movsb (same scheme as the kernel's memcpy) */
+    if (n >= 4 && ((((unsigned int)d ^ (unsigned int)s) & 3) == 0)) {
+        while (((unsigned int)d & 3) != 0) {
+            *d++ = *s++;
+            n--;
+        }
+        unsigned int dwords = n / 4;
+        __asm__ volatile("rep movsl"
+                         : "+D"(d), "+S"(s), "+c"(dwords)
+                         : : "memory");
+        n &= 3;
+    }
+    if (n > 0) {
+        __asm__ volatile("rep movsb"
+                         : "+D"(d), "+S"(s), "+c"(n)
+                         : : "memory");
     }
     return dest;
 }
@@ -65,6 +195,16 @@ void* memcpy(void* dest, const void* src, size_t n) {
 int memcmp(const void* s1, const void* s2, size_t n) {
     const unsigned char* p1 = (const unsigned char*)s1;
     const unsigned char* p2 = (const unsigned char*)s2;
+
+    /* Mutually aligned buffers compare a word at a time; the byte
+     * loop below pins down the first differing byte */
+    if ((((unsigned int)p1 | (unsigned int)p2) & 3) == 0) {
+        while (n >= 4 && *(const unsigned int*)p1 == *(const unsigned int*)p2) {
+            p1 += 4;
+            p2 += 4;
+            n -= 4;
+        }
+    }
     while (n--) {
         if (*p1 != *p2) {
             return *p1 - *p2;
@@ -81,4 +221,3 @@ char* strcat(char* dest, const char* src) {
     while ((*d++ = *src++));
     return dest;
 }
-